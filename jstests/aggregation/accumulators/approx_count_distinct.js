@@ -0,0 +1,69 @@
+/**
+ * Basic tests for the $approxCountDistinct accumulator.
+ * @tags: [
+ *   requires_fcv_53,
+ * ]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/feature_flag_util.js");  // For isEnabled.
+
+if (!FeatureFlagUtil.isEnabled(db, "ApproximateAccumulators")) {
+    jsTestLog("Skipping as featureFlagApproximateAccumulators is not enabled");
+    return;
+}
+
+const coll = db[jsTestName()];
+coll.drop();
+
+const numGroups = 3;
+const numDistinct = 20000;
+let bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < numDistinct; ++i) {
+    // Every value appears twice per group, once as an int and once as a double.
+    for (let g = 0; g < numGroups; ++g) {
+        bulk.insert({g: g, v: NumberInt(i), s: "str" + (i % 10)});
+        bulk.insert({g: g, v: i * 1.0, s: "STR" + (i % 10)});
+    }
+}
+assert.commandWorked(bulk.execute());
+
+// The sketch has a relative standard error of about 1.6%, allow for four times that.
+function assertApproximately(expected, actual) {
+    assert.lte(Math.abs(actual - expected), 0.065 * expected, {expected: expected, actual: actual});
+}
+
+let results =
+    coll.aggregate([{$group: {_id: "$g", n: {$approxCountDistinct: "$v"}}}]).toArray();
+assert.eq(results.length, numGroups, results);
+for (const res of results) {
+    assertApproximately(numDistinct, res.n);
+}
+
+// Small cardinalities are exact, and missing values are ignored.
+results = coll.aggregate([{
+                  $group: {
+                      _id: null,
+                      s: {$approxCountDistinct: "$s"},
+                      missing: {$approxCountDistinct: "$missing"}
+                  }
+              }])
+              .toArray();
+assert.eq(results, [{_id: null, s: 20, missing: 0}]);
+
+// Collation is respected.
+results = coll.aggregate([{$group: {_id: null, s: {$approxCountDistinct: "$s"}}}],
+                         {collation: {locale: "en_US", strength: 2}})
+              .toArray();
+assert.eq(results, [{_id: null, s: 10}]);
+
+// Input which is not a single expression is rejected.
+assert.commandFailedWithCode(
+    db.runCommand({
+        aggregate: coll.getName(),
+        pipeline: [{$group: {_id: null, n: {$approxCountDistinct: ["$v", "$s"]}}}],
+        cursor: {}
+    }),
+    40237);
+})();
@@ -0,0 +1,80 @@
+/**
+ * Basic tests for the approximate $percentile and $median accumulators.
+ * @tags: [
+ *   requires_fcv_53,
+ * ]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/feature_flag_util.js");  // For isEnabled.
+
+if (!FeatureFlagUtil.isEnabled(db, "ApproximateAccumulators")) {
+    jsTestLog("Skipping as featureFlagApproximateAccumulators is not enabled");
+    return;
+}
+
+const coll = db[jsTestName()];
+coll.drop();
+
+// With only a handful of values the digest keeps every value, so the results are exact.
+assert.commandWorked(coll.insert([
+    {g: 1, v: 5},
+    {g: 1, v: NumberLong(1)},
+    {g: 1, v: 3.0},
+    {g: 1, v: NumberDecimal("2")},
+    {g: 1, v: 4},
+    {g: 1, v: "not a number"},
+    {g: 2, v: null},
+]));
+
+const pSpec = {input: "$v", p: [0, 0.5, 1], method: "approximate"};
+const mSpec = {input: "$v", method: "approximate"};
+let results = coll.aggregate([
+                      {$group: {_id: "$g", p: {$percentile: pSpec}, m: {$median: mSpec}}},
+                      {$sort: {_id: 1}}
+                  ])
+                  .toArray();
+assert.eq(results, [{_id: 1, p: [1, 3, 5], m: 3}, {_id: 2, p: [null, null, null], m: null}]);
+
+// Larger inputs are approximated.
+coll.drop();
+const numDocs = 100000;
+let bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < numDocs; ++i) {
+    bulk.insert({v: (i * 7919) % numDocs});
+}
+assert.commandWorked(bulk.execute());
+
+results = coll.aggregate([{
+                  $group: {
+                      _id: null,
+                      p: {$percentile: {input: "$v", p: [0.1, 0.9], method: "approximate"}},
+                      m: {$median: {input: "$v", method: "approximate"}}
+                  }
+              }])
+              .toArray();
+assert.eq(results.length, 1, results);
+const tolerance = 0.01 * numDocs;
+assert.lte(Math.abs(results[0].p[0] - 0.1 * numDocs), tolerance, results);
+assert.lte(Math.abs(results[0].p[1] - 0.9 * numDocs), tolerance, results);
+assert.lte(Math.abs(results[0].m - 0.5 * numDocs), tolerance, results);
+
+// Invalid specifications are rejected.
+function assertGroupFails(spec, code) {
+    assert.commandFailedWithCode(
+        db.runCommand(
+            {aggregate: coll.getName(), pipeline: [{$group: {_id: null, r: spec}}], cursor: {}}),
+        code);
+}
+assertGroupFails({$percentile: "$v"}, 6440020);
+assertGroupFails({$percentile: {input: "$v", p: "$p", method: "approximate"}}, 6440021);
+assertGroupFails({$percentile: {input: "$v", p: [0.5], method: "exact"}}, 6440022);
+assertGroupFails({$percentile: {input: "$v", p: [0.5], method: "approximate", x: 1}}, 6440023);
+assertGroupFails({$percentile: {p: [0.5], method: "approximate"}}, 6440024);
+assertGroupFails({$percentile: {input: "$v", p: [0.5]}}, 6440025);
+assertGroupFails({$percentile: {input: "$v", method: "approximate"}}, 6440026);
+assertGroupFails({$percentile: {input: "$v", p: [], method: "approximate"}}, 6440027);
+assertGroupFails({$percentile: {input: "$v", p: [1.5], method: "approximate"}}, 6440028);
+assertGroupFails({$median: {input: "$v", p: [0.5], method: "approximate"}}, 6440023);
+})();
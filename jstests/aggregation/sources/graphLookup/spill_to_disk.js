@@ -0,0 +1,78 @@
+/*
+ * Test that $graphLookup spills its visited documents to disk when 'allowDiskUse' is set, and that
+ * it still fails with a memory limit error when it is not.
+ * @tags: [
+ *   assumes_read_concern_unchanged,
+ *   assumes_unsharded_collection,
+ *   do_not_wrap_aggregations_in_facets,
+ * ]
+ */
+(function() {
+"use strict";
+
+load("jstests/noPassthrough/libs/server_parameter_helpers.js");  // For setParameterOnAllHosts.
+load("jstests/libs/discover_topology.js");                       // For findNonConfigNodes.
+load("jstests/aggregation/extras/utils.js");                     // For assertErrorCode.
+
+const local = db.graphlookup_spill_local;
+const foreign = db.graphlookup_spill_foreign;
+local.drop();
+foreign.drop();
+
+const origParamValue = assert.commandWorked(db.adminCommand({
+    getParameter: 1,
+    internalDocumentSourceGraphLookupMaxMemoryBytes: 1
+}))["internalDocumentSourceGraphLookupMaxMemoryBytes"];
+
+// Build a chain 0 -> 1 -> ... -> kNumNodes - 1 whose documents together are several times larger
+// than the memory limit used below.
+const kNumNodes = 200;
+const padding = "x".repeat(1024);
+const bulk = foreign.initializeUnorderedBulkOp();
+for (let i = 0; i < kNumNodes; i++) {
+    bulk.insert({_id: i, next: i + 1, padding: padding});
+}
+assert.commandWorked(bulk.execute());
+assert.commandWorked(local.insert({_id: 0, start: 0}));
+
+const nodes = DiscoverTopology.findNonConfigNodes(db.getMongo());
+setParameterOnAllHosts(nodes, "internalDocumentSourceGraphLookupMaxMemoryBytes", 50 * 1024);
+
+const graphLookup = {
+    $graphLookup: {
+        from: foreign.getName(),
+        startWith: "$start",
+        connectFromField: "next",
+        connectToField: "_id",
+        as: "chain",
+        depthField: "depth",
+    }
+};
+
+try {
+    // Without 'allowDiskUse' the traversal must fail once it exceeds the memory limit.
+    assertErrorCode(local, [graphLookup], 40099, "maximum memory usage reached");
+
+    // With 'allowDiskUse' the visited documents are spilled and every node is returned.
+    let results =
+        local.aggregate([graphLookup, {$project: {"chain.padding": 0}}], {allowDiskUse: true})
+            .toArray();
+    assert.eq(results.length, 1, results);
+    assert.eq(results[0].chain.length, kNumNodes);
+    assert.sameMembers(results[0].chain.map(doc => doc._id), [...Array(kNumNodes).keys()]);
+    for (let doc of results[0].chain) {
+        assert.eq(doc.depth, doc._id, doc);
+    }
+
+    // The same holds when the following $unwind is absorbed into $graphLookup, including across
+    // getMore requests.
+    results = local
+                  .aggregate([graphLookup, {$unwind: "$chain"}, {$project: {"chain.padding": 0}}],
+                             {allowDiskUse: true, cursor: {batchSize: 1}})
+                  .toArray();
+    assert.eq(results.length, kNumNodes);
+    assert.sameMembers(results.map(doc => doc.chain._id), [...Array(kNumNodes).keys()]);
+} finally {
+    setParameterOnAllHosts(nodes, "internalDocumentSourceGraphLookupMaxMemoryBytes", origParamValue);
+}
+})();
@@ -4206,6 +4206,20 @@ var authCommandsLib = {
               {runOnDb: secondDbName, roles: {}}
           ]
         },
+        {
+          testname: "getSamplingProfile",
+          command: {getSamplingProfile: 1},
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_monitoring,
+                privileges: [{resource: {cluster: true}, actions: ["serverStatus"]}],
+                expectFail: true  // The sampling profiler is not supported on every platform.
+              },
+              {runOnDb: firstDbName, roles: {}},
+              {runOnDb: secondDbName, roles: {}}
+          ]
+        },
         {
           testname: "getShardMap",
           command: {getShardMap: "x"},
@@ -376,6 +376,7 @@ let viewsCommandTests = {
         }
     },
     getParameter: {skip: isUnrelated},
+    getSamplingProfile: {skip: isUnrelated},
     getShardMap: {skip: isUnrelated},
     getShardVersion: {
         command: {getShardVersion: "test.view"},
@@ -0,0 +1,87 @@
+/**
+ * Tests that collection scans which evaluate their filter with the compiled batched matcher
+ * (featureFlagBatchedMatchEvaluation) return the same documents as the regular matcher.
+ */
+(function() {
+"use strict";
+
+const batchedConn =
+    MongoRunner.runMongod({setParameter: {featureFlagBatchedMatchEvaluation: true}});
+assert.neq(null, batchedConn, "mongod was unable to start up");
+const defaultConn = MongoRunner.runMongod({});
+assert.neq(null, defaultConn, "mongod was unable to start up");
+
+const batchedColl = batchedConn.getDB(jsTestName()).coll;
+const defaultColl = defaultConn.getDB(jsTestName()).coll;
+
+const docs = [
+    {_id: 0},
+    {_id: 1, a: 1, b: "foo"},
+    {_id: 2, a: NumberLong(5), b: "FOO"},
+    {_id: 3, a: 5.5, b: null},
+    {_id: 4, a: NaN, b: [1, 2]},
+    {_id: 5, a: NumberDecimal("5"), b: {c: 1}},
+    {_id: 6, a: "5", b: [{c: 1}, {c: 2}]},
+    {_id: 7, a: null, b: "bar"},
+    {_id: 8, a: [1, 5, 10], b: "foo"},
+    {_id: 9, a: [[5]], b: []},
+    {_id: 10, a: {b: 5}, c: 1},
+    {_id: 11, a: MinKey, b: MaxKey},
+];
+assert.commandWorked(batchedColl.insert(docs));
+assert.commandWorked(defaultColl.insert(docs));
+
+const filters = [
+    {a: 5},
+    {a: {$gte: 1, $lt: 10}},
+    {a: {$gt: 5.0}, b: "foo"},
+    {a: {$lte: NaN}},
+    {a: null},
+    {a: {$exists: true}, b: {$in: [null, 1, /^f/]}},
+    {a: {$type: "number"}, "b.c": 1},
+    {a: {$mod: [5, 0]}},
+    {a: {$ne: 5}, b: {$exists: false}},
+    {$or: [{a: 1}, {b: "bar"}], a: {$lt: MaxKey}},
+    {"a.b": 5},
+];
+for (let filter of filters) {
+    for (let collation of [{locale: "simple"}, {locale: "en_US", strength: 2}]) {
+        const expected =
+            defaultColl.find(filter).collation(collation).sort({_id: 1}).toArray();
+        const actual = batchedColl.find(filter).collation(collation).sort({_id: 1}).toArray();
+        assert.eq(expected, actual, {filter: filter, collation: collation});
+    }
+}
+
+// Collection scans evaluate the compiled filter over windows of records. Check that the results and
+// the number of documents examined do not depend on where the windows end, including when the scan
+// yields between two windows or stops early.
+const largeDocs = [];
+for (let i = 0; i < 1000; i++) {
+    largeDocs.push({_id: i, a: i % 7, b: "x".repeat(i % 50)});
+}
+const batchedLargeColl = batchedConn.getDB(jsTestName()).large;
+const defaultLargeColl = defaultConn.getDB(jsTestName()).large;
+for (let coll of [batchedLargeColl, defaultLargeColl]) {
+    assert.commandWorked(coll.insert(largeDocs));
+    assert.commandWorked(
+        coll.getDB().adminCommand({setParameter: 1, internalQueryExecYieldIterations: 3}));
+}
+for (let filter of [{a: 3}, {a: {$gt: 5}}, {a: 10}, {b: {$exists: true}}]) {
+    for (let limit of [0, 1, 65, 200]) {
+        const context = {filter: filter, limit: limit};
+        assert.eq(defaultLargeColl.find(filter).limit(limit).toArray(),
+                  batchedLargeColl.find(filter).limit(limit).toArray(),
+                  context);
+
+        const expectedStats = defaultLargeColl.find(filter).limit(limit).explain("executionStats");
+        const actualStats = batchedLargeColl.find(filter).limit(limit).explain("executionStats");
+        assert.eq(expectedStats.executionStats.totalDocsExamined,
+                  actualStats.executionStats.totalDocsExamined,
+                  context);
+    }
+}
+
+MongoRunner.stopMongod(batchedConn);
+MongoRunner.stopMongod(defaultConn);
+})();
@@ -0,0 +1,96 @@
+/**
+ * Tests that change streams which share their oplog reads through the shared oplog reader
+ * (featureFlagSharedChangeStreamOplogReader) see every event, that slow streams fall back to a
+ * private cursor, and that the shared reader's statistics are reported in serverStatus.
+ * @tags: [
+ *   requires_replication,
+ *   uses_change_streams,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest(
+    {nodes: 1, nodeOptions: {setParameter: {featureFlagSharedChangeStreamOplogReader: true}}});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const testDB = primary.getDB(jsTestName());
+const coll = testDB.coll;
+const otherColl = testDB.other;
+assert.commandWorked(coll.insert({_id: "init"}));
+assert.commandWorked(otherColl.insert({_id: "init"}));
+
+function getStats() {
+    return assert.commandWorked(primary.adminCommand({serverStatus: 1}))
+        .changeStreamSharedOplogReader;
+}
+
+// Reads 'numEvents' events from 'stream' and returns their document keys.
+function readEvents(stream, numEvents) {
+    const ids = [];
+    assert.soon(() => {
+        while (stream.hasNext()) {
+            ids.push(stream.next().documentKey._id);
+        }
+        return ids.length >= numEvents;
+    });
+    assert.eq(ids.length, numEvents, ids);
+    return ids;
+}
+
+function runTest(numDocs) {
+    const collStreams = [];
+    for (let i = 0; i < 4; ++i) {
+        collStreams.push(coll.watch([], {maxAwaitTimeMS: 10}));
+    }
+    const filteredStream = coll.watch([{$match: {operationType: "update"}}], {maxAwaitTimeMS: 10});
+    const otherStream = otherColl.watch([], {maxAwaitTimeMS: 10});
+    const dbStream = testDB.watch([], {maxAwaitTimeMS: 10});
+
+    // Let every stream catch up with the end of the oplog, so that they subscribe to the reader.
+    for (let stream of [...collStreams, filteredStream, otherStream, dbStream]) {
+        assert(!stream.hasNext());
+    }
+
+    const expectedIds = [];
+    for (let i = 0; i < numDocs; ++i) {
+        assert.commandWorked(coll.insert({_id: i}));
+        expectedIds.push(i);
+    }
+    assert.commandWorked(coll.update({_id: 0}, {$set: {updated: true}}));
+    assert.commandWorked(otherColl.insert({_id: "other"}));
+
+    for (let stream of collStreams) {
+        assert.eq(readEvents(stream, numDocs + 1), [...expectedIds, 0]);
+    }
+    assert.eq(readEvents(filteredStream, 1), [0]);
+    assert.eq(readEvents(otherStream, 1), ["other"]);
+    assert.eq(readEvents(dbStream, numDocs + 2), [...expectedIds, 0, "other"]);
+
+    for (let stream of [...collStreams, filteredStream, otherStream, dbStream]) {
+        stream.close();
+    }
+    assert.commandWorked(coll.deleteMany({_id: {$ne: "init"}}));
+    assert.commandWorked(otherColl.deleteMany({_id: {$ne: "init"}}));
+}
+
+runTest(20);
+let stats = getStats();
+assert.gt(stats.subscriptionsCreated, 0, stats);
+assert.gt(stats.entriesRead, 0, stats);
+assert.gt(stats.sharedReads, 0, stats);
+assert.gt(stats.hitRate, 0, stats);
+assert.eq(stats.subscriptions, 0, stats);
+
+// With tiny per-stream buffers, the streams are detached from the reader and fall back to their
+// private cursors, without missing any event.
+assert.commandWorked(primary.adminCommand(
+    {setParameter: 1, internalChangeStreamSharedOplogReaderMaxBufferedEntries: 2}));
+runTest(20);
+stats = getStats();
+assert.gt(stats.fallbacks, 0, stats);
+
+rst.stopSet();
+})();
@@ -0,0 +1,56 @@
+/**
+ * Verifies that with deferIndexCatalogInitialization the index catalogs of user collections are
+ * instantiated on first access after startup, and released again once idle.
+ * @tags: [requires_persistence]
+ */
+(function() {
+'use strict';
+
+const numCollections = 10;
+
+let conn = MongoRunner.runMongod();
+let db = conn.getDB('test');
+for (let i = 0; i < numCollections; i++) {
+    assert.commandWorked(db.getCollection('coll' + i).insert({_id: i, a: i}));
+    assert.commandWorked(db.getCollection('coll' + i).createIndex({a: 1}));
+}
+
+MongoRunner.stopMongod(conn);
+conn = MongoRunner.runMongod({
+    restart: true,
+    dbpath: conn.dbpath,
+    cleanData: false,
+    setParameter: {deferIndexCatalogInitialization: true}
+});
+db = conn.getDB('test');
+
+function getIndexCatalogMetrics() {
+    return assert.commandWorked(db.adminCommand({serverStatus: 1}))
+        .metrics.catalog.indexCatalogs;
+}
+
+let metrics = getIndexCatalogMetrics();
+assert.gte(metrics.deferred, numCollections, tojson(metrics));
+
+// Using an index instantiates the index catalog of its collection.
+const instantiatedBefore = metrics.instantiated;
+assert.eq([{_id: 0, a: 0}], db.coll0.find({a: 0}).hint({a: 1}).toArray());
+metrics = getIndexCatalogMetrics();
+assert.gt(metrics.instantiated, instantiatedBefore, tojson(metrics));
+
+// Writes maintain the indexes of collections whose index catalog has not been accessed yet.
+assert.commandWorked(db.coll1.insert({_id: 'new', a: 'new'}));
+assert.eq([{_id: 'new', a: 'new'}], db.coll1.find({a: 'new'}).hint({a: 1}).toArray());
+
+// Idle index catalogs are released, and instantiated again on next access.
+assert.commandWorked(db.adminCommand({setParameter: 1, idleIndexCatalogReleaseSecs: 1}));
+assert.soon(() => getIndexCatalogMetrics().released > 0, () => tojson(getIndexCatalogMetrics()));
+assert.commandWorked(db.adminCommand({setParameter: 1, idleIndexCatalogReleaseSecs: 0}));
+for (let i = 0; i < numCollections; i++) {
+    assert.eq([{_id: i, a: i}], db.getCollection('coll' + i).find({a: i}).hint({a: 1}).toArray());
+}
+assert.eq(2, db.coll1.find().hint({a: 1}).itcount());
+assert.eq(2, db.coll1.getIndexes().length, tojson(db.coll1.getIndexes()));
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,70 @@
+/**
+ * Tests that the $diagnosticData aggregation stage returns the samples of full time diagnostic data
+ * capture stored in both the zlib and the zstd metric chunk formats, and that it honours time
+ * ranges given in its specification or in a following $match on 'start'.
+ */
+(function() {
+'use strict';
+
+const conn = MongoRunner.runMongod({
+    setParameter: {
+        diagnosticDataCollectionPeriodMillis: 100,
+        diagnosticDataCollectionSamplesPerChunk: 5,
+        diagnosticDataCollectionSamplesPerInterimUpdate: 2,
+    }
+});
+const adminDB = conn.getDB("admin");
+
+function diagnosticData(pipeline) {
+    return adminDB.aggregate([{$diagnosticData: {}}].concat(pipeline)).toArray();
+}
+
+function assertSamplesOrdered(samples) {
+    for (let i = 1; i < samples.length; i++) {
+        assert.gt(samples[i].start, samples[i - 1].start, tojson(samples.slice(i - 1, i + 1)));
+    }
+}
+
+// Collect samples in the default format, then in the columnar one.
+assert.soon(() => diagnosticData([]).length >= 20);
+assert.commandWorked(
+    adminDB.runCommand({setParameter: 1, diagnosticDataCollectionCompressor: "zstd"}));
+const zstdStart = new Date();
+assert.soon(() => diagnosticData([{$match: {start: {$gt: zstdStart}}}]).length >= 20);
+
+const samples = diagnosticData([]);
+assertSamplesOrdered(samples);
+assert(samples[0].hasOwnProperty("serverStatus"), tojson(samples[0]));
+
+// Time ranges in the stage specification and in a following $match return the same samples.
+const from = samples[5].start;
+const to = samples[samples.length - 5].start;
+const expected = samples.filter((s) => s.start >= from && s.start <= to).map((s) => s.start);
+const fromSpec = adminDB.aggregate([{$diagnosticData: {from: from, to: to}}]).toArray();
+assert.eq(expected, fromSpec.map((s) => s.start));
+const fromMatch = diagnosticData([{$match: {start: {$gte: from, $lte: to}}}]);
+assert.eq(expected, fromMatch.map((s) => s.start));
+
+const explain = adminDB.runCommand({
+    explain: {
+        aggregate: 1,
+        pipeline: [{$diagnosticData: {}}, {$match: {start: {$gte: from}}}],
+        cursor: {}
+    }
+});
+assert.commandWorked(explain);
+assert.eq(from, explain.stages[0].$diagnosticData.from, tojson(explain));
+
+// Invalid specifications and compressors are rejected.
+assert.commandFailedWithCode(
+    adminDB.runCommand({aggregate: 1, pipeline: [{$diagnosticData: {from: 1}}], cursor: {}}),
+    ErrorCodes.TypeMismatch);
+assert.commandFailedWithCode(
+    conn.getDB("test").runCommand({aggregate: 1, pipeline: [{$diagnosticData: {}}], cursor: {}}),
+    ErrorCodes.InvalidNamespace);
+assert.commandFailedWithCode(
+    adminDB.runCommand({setParameter: 1, diagnosticDataCollectionCompressor: "snappy"}),
+    ErrorCodes.BadValue);
+
+MongoRunner.stopMongod(conn);
+})();
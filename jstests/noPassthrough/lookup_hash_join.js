@@ -0,0 +1,141 @@
+/**
+ * Tests that a classic $lookup executed as a hash join (featureFlagLookupHashJoin) returns the
+ * same results as the nested-loop execution, and that it scans the foreign collection only once.
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");  // For getAggPlanStages.
+
+const hashJoinConn =
+    MongoRunner.runMongod({setParameter: {featureFlagLookupHashJoin: true}});
+assert.neq(null, hashJoinConn, "mongod was unable to start up");
+const nestedLoopConn = MongoRunner.runMongod({});
+assert.neq(null, nestedLoopConn, "mongod was unable to start up");
+
+const hashJoinDB = hashJoinConn.getDB(jsTestName());
+const nestedLoopDB = nestedLoopConn.getDB(jsTestName());
+
+const localDocs = [
+    {_id: 0, a: 1},
+    {_id: 1, a: [1, 2]},
+    {_id: 2, a: null},
+    {_id: 3},
+    {_id: 4, a: "FOO"},
+    {_id: 5, a: [[1, 2]]},
+    {_id: 6, a: {x: 1}},
+    {_id: 7, a: NumberLong(2)},
+    {_id: 8, a: [3, 3]},
+];
+const foreignDocs = [
+    {_id: 0, b: 1},
+    {_id: 1, b: [1, 3]},
+    {_id: 2, b: null},
+    {_id: 3},
+    {_id: 4, b: "foo"},
+    {_id: 5, b: [1, 2]},
+    {_id: 6, b: {x: 1}},
+    {_id: 7, b: 2.0},
+    {_id: 8, c: [{b: 1}, {b: 2}]},
+    {_id: 9, c: [{b: 3}, {d: 1}]},
+    {_id: 10, c: [1, {b: [2, 3]}]},
+];
+for (let db of [hashJoinDB, nestedLoopDB]) {
+    assert.commandWorked(db.local.insert(localDocs));
+    assert.commandWorked(db.foreign.insert(foreignDocs));
+    assert.commandWorked(
+        db.createView("foreignView", "foreign", [{$match: {_id: {$ne: 0}}}, {$set: {v: true}}]));
+}
+
+// Sorts the results, and the joined documents within each result, so that they can be compared
+// regardless of the order in which the foreign documents were produced.
+function normalize(results) {
+    const byId = (x, y) => bsonWoCompare({_id: x._id}, {_id: y._id});
+    for (let result of results) {
+        if (Array.isArray(result.joined)) {
+            result.joined.sort(byId);
+        }
+    }
+    return results.sort(byId);
+}
+
+function assertSameResults(pipeline, options = {}) {
+    const expected = normalize(nestedLoopDB.local.aggregate(pipeline, options).toArray());
+    const actual = normalize(hashJoinDB.local.aggregate(pipeline, options).toArray());
+    assert.eq(expected, actual, {pipeline: pipeline});
+}
+
+function assertUsesHashJoin(pipeline, expectedBuildSideDocs) {
+    const explain = hashJoinDB.local.explain("executionStats").aggregate(pipeline);
+    const lookupStages = getAggPlanStages(explain, "$lookup");
+    assert.eq(lookupStages.length, 1, explain);
+    assert.eq(lookupStages[0].hashJoinBuildSideDocs, expectedBuildSideDocs, explain);
+    // The foreign collection is scanned once, no matter how many local documents there are.
+    assert.eq(lookupStages[0].totalDocsExamined, foreignDocs.length, explain);
+}
+
+for (let from of ["foreign", "foreignView"]) {
+    for (let foreignField of ["b", "c.b"]) {
+        const lookup =
+            {$lookup: {from: from, localField: "a", foreignField: foreignField, as: "joined"}};
+        assertSameResults([lookup]);
+        assertSameResults([lookup, {$unwind: "$joined"}]);
+        assertSameResults([lookup, {$unwind: "$joined"}, {$match: {"joined._id": {$gte: 5}}}]);
+        assertSameResults([lookup], {collation: {locale: "en_US", strength: 2}});
+
+        // A pipeline after the join runs against the matching foreign documents only.
+        const lookupWithPipeline = {
+            $lookup: {
+                from: from,
+                localField: "a",
+                foreignField: foreignField,
+                let: {id: "$_id"},
+                pipeline: [{$set: {localId: "$$id"}}, {$sort: {_id: -1}}, {$limit: 2}],
+                as: "joined"
+            }
+        };
+        assertSameResults([lookupWithPipeline]);
+    }
+
+    // An equality-correlated sub-pipeline is recognized as a join on 'b'.
+    const exprLookup = {
+        $lookup: {
+            from: from,
+            let: {a: "$a"},
+            pipeline: [{$match: {$expr: {$eq: ["$b", "$$a"]}}}, {$project: {b: 1}}],
+            as: "joined"
+        }
+    };
+    assertSameResults([exprLookup]);
+    assertSameResults([exprLookup, {$unwind: "$joined"}]);
+    assertSameResults([exprLookup], {collation: {locale: "en_US", strength: 2}});
+}
+
+assertUsesHashJoin(
+    [{$lookup: {from: "foreign", localField: "a", foreignField: "b", as: "joined"}}],
+    foreignDocs.length);
+assertUsesHashJoin([{
+                       $lookup: {
+                           from: "foreign",
+                           let: {a: "$a"},
+                           pipeline: [{$match: {$expr: {$eq: ["$$a", "$b"]}}}],
+                           as: "joined"
+                       }
+                   }],
+                   foreignDocs.length);
+
+// When the build side does not fit in memory and disk use is not allowed, the hash join is
+// abandoned in favor of the nested-loop execution.
+assert.commandWorked(hashJoinDB.adminCommand(
+    {setParameter: 1, internalDocumentSourceLookupHashJoinMaxMemoryBytes: 100}));
+const pipeline = [{$lookup: {from: "foreign", localField: "a", foreignField: "b", as: "joined"}}];
+assertSameResults(pipeline);
+const explain = hashJoinDB.local.explain("executionStats").aggregate(pipeline);
+assert(!getAggPlanStages(explain, "$lookup")[0].hasOwnProperty("hashJoinBuildSideDocs"), explain);
+
+// With disk use allowed, the build side spills instead.
+assertSameResults(pipeline, {allowDiskUse: true});
+
+MongoRunner.stopMongod(hashJoinConn);
+MongoRunner.stopMongod(nestedLoopConn);
+})();
@@ -0,0 +1,63 @@
+/**
+ * Tests that the latency of the phases of operations is reported in the slow operation log, the
+ * profiler and the operationPhases section of serverStatus.
+ *
+ * @tags: [requires_profiling]
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod({setParameter: {operationPhaseTimelineEnabled: true}});
+const db = conn.getDB(jsTestName());
+const coll = db.coll;
+
+assert.commandWorked(coll.createIndex({a: 1}));
+assert.commandWorked(coll.insert(Array.from({length: 100}, (_, i) => ({_id: i, a: i}))));
+
+// Profile and log every operation.
+assert.commandWorked(db.setProfilingLevel(2, {slowms: -1}));
+
+const comment = "phase_timeline_find";
+assert.eq(10, coll.find({a: {$lt: 10}}).comment(comment).itcount());
+
+const profileEntry = db.system.profile.findOne({"command.comment": comment});
+assert(profileEntry, "no profiler entry for the find");
+const phases = profileEntry.phases;
+assert(phases, tojson(profileEntry));
+for (let phase of ["commandDispatch", "planning", "execution"]) {
+    assert.gte(phases[phase].count, 1, tojson(phases));
+    assert.gte(phases[phase].totalMicros, 0, tojson(phases));
+}
+assert.gt(phases.timeline.length, 0, tojson(phases));
+for (let event of phases.timeline) {
+    assert.gte(event.offsetMicros, 0, tojson(event));
+    assert.gte(event.durationMicros, 0, tojson(event));
+}
+
+// The slow operation log line for the find has the same breakdown.
+checkLog.containsJson(conn, 51803, {
+    command: (cmd) => cmd && cmd.comment === comment,
+    phases: (phases) => phases && phases.execution && phases.execution.count >= 1,
+});
+
+// The phases are aggregated server-wide, with histograms on request.
+let status = assert.commandWorked(db.adminCommand({serverStatus: 1}));
+assert(status.operationPhases, tojson(status));
+assert.gte(status.operationPhases.execution.count, 1, tojson(status.operationPhases));
+assert.gte(status.operationPhases.networkSend.count, 1, tojson(status.operationPhases));
+assert(!status.operationPhases.execution.hasOwnProperty("histogram"));
+
+status = assert.commandWorked(
+    db.adminCommand({serverStatus: 1, operationPhases: {histograms: true}}));
+assert.gt(status.operationPhases.execution.histogram.length, 0, tojson(status.operationPhases));
+
+// Nothing is recorded once tracing is disabled.
+assert.commandWorked(db.adminCommand({setParameter: 1, operationPhaseTimelineEnabled: false}));
+const disabledComment = "phase_timeline_disabled";
+assert.eq(10, coll.find({a: {$lt: 10}}).comment(disabledComment).itcount());
+const disabledEntry = db.system.profile.findOne({"command.comment": disabledComment});
+assert(disabledEntry, "no profiler entry for the find");
+assert(!disabledEntry.hasOwnProperty("phases"), tojson(disabledEntry));
+
+MongoRunner.stopMongod(conn);
+})();
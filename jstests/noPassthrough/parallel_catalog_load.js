@@ -0,0 +1,51 @@
+/**
+ * Verifies that collections and indexes opened concurrently on startup are all present in the
+ * catalog, and that the time spent loading the catalog is reported in serverStatus.
+ * @tags: [requires_persistence]
+ */
+(function() {
+'use strict';
+
+const numCollections = 200;
+
+let conn = MongoRunner.runMongod({setParameter: {catalogLoadThreads: 4}});
+let db = conn.getDB('test');
+for (let i = 0; i < numCollections; i++) {
+    assert.commandWorked(db.getCollection('coll' + i).insert({_id: i, a: i}));
+    assert.commandWorked(db.getCollection('coll' + i).createIndex({a: 1}));
+}
+
+MongoRunner.stopMongod(conn);
+conn = MongoRunner.runMongod({
+    restart: true,
+    dbpath: conn.dbpath,
+    cleanData: false,
+    setParameter: {catalogLoadThreads: 4}
+});
+db = conn.getDB('test');
+
+// Every collection must have been published with both of its indexes.
+const collNames = db.getCollectionNames().filter(name => name.startsWith('coll'));
+assert.eq(numCollections, collNames.length, tojson(collNames));
+for (let i = 0; i < numCollections; i++) {
+    const coll = db.getCollection('coll' + i);
+    assert.eq(2, coll.getIndexes().length, tojson(coll.getIndexes()));
+    assert.eq([{_id: i, a: i}], coll.find({a: i}).hint({a: 1}).toArray());
+}
+
+const stats = assert.commandWorked(db.adminCommand({serverStatus: 1})).catalogLoad;
+assert(stats, 'serverStatus is missing the catalogLoad section');
+assert.eq(4, stats.threads, tojson(stats));
+assert.gte(stats.entries, numCollections, tojson(stats));
+for (const field of ['readCatalogMillis',
+                     'recoverEntriesMillis',
+                     'openCollectionsMillis',
+                     'publishCollectionsMillis',
+                     'reconcileIdentsMillis',
+                     'initIndexCatalogsMillis',
+                     'totalMillis']) {
+    assert.gte(stats[field], 0, tojson(stats));
+}
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,71 @@
+/**
+ * Tests that the primary records the winning plans of its plan caches in config.plan_cache_warmup
+ * and that a node which steps up warms its plan cache up from the recorded plans.
+ * @tags: [
+ *   requires_replication,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({
+    nodes: 2,
+    nodeOptions: {
+        setParameter: {
+            internalQueryEnablePlanCacheWarmup: true,
+            internalQueryPlanCacheWarmupSnapshotIntervalSecs: 1,
+            // Only the classic plan cache is warmed up.
+            internalQueryForceClassicEngine: true,
+        }
+    }
+});
+rst.startSet();
+rst.initiate();
+
+const dbName = "test";
+const collName = "plan_cache_warmup";
+const primary = rst.getPrimary();
+const coll = primary.getDB(dbName)[collName];
+
+assert.commandWorked(coll.createIndex({a: 1}));
+assert.commandWorked(coll.createIndex({b: 1}));
+assert.commandWorked(coll.insert(Array.from({length: 100}, (_, i) => ({a: i, b: i % 2}))));
+
+// Run the query twice for its plan cache entry to become active.
+const filter = {a: {$gte: 90}, b: 1};
+assert.eq(5, coll.find(filter).itcount());
+assert.eq(5, coll.find(filter).itcount());
+
+function getActiveEntries(node) {
+    return node.getDB(dbName)[collName]
+        .aggregate([{$planCacheStats: {}}, {$match: {isActive: true}}])
+        .toArray();
+}
+const entries = getActiveEntries(primary);
+assert.eq(1, entries.length, entries);
+
+// Wait for the primary to record the winning plan.
+const warmupColl = primary.getDB("config").plan_cache_warmup;
+assert.soon(() => warmupColl.find({nss: coll.getFullName()}).itcount() === 1,
+            () => tojson(warmupColl.find().toArray()));
+rst.awaitReplication();
+
+// The new primary warms its plan cache up with the same plan.
+const secondary = rst.getSecondary();
+secondary.setSecondaryOk();
+assert.eq(0, getActiveEntries(secondary).length);
+rst.stepUp(secondary);
+assert.soon(() => getActiveEntries(secondary).length === 1);
+
+const restoredEntry = getActiveEntries(secondary)[0];
+assert.eq(entries[0].planCacheKey, restoredEntry.planCacheKey, restoredEntry);
+assert.eq(entries[0].cachedPlan, restoredEntry.cachedPlan, restoredEntry);
+
+// The recorded entries of a dropped collection are removed by the next recording.
+const newWarmupColl = secondary.getDB("config").plan_cache_warmup;
+assert(secondary.getDB(dbName)[collName].drop());
+assert.soon(() => newWarmupColl.find({nss: coll.getFullName()}).itcount() === 0,
+            () => tojson(newWarmupColl.find().toArray()));
+
+rst.stopSet();
+})();
@@ -37,6 +37,9 @@ const expectedParamDefaults = {
     internalDocumentSourceLookupCacheSizeBytes: 100 * 1024 * 1024,
     internalLookupStageIntermediateDocumentMaxSizeBytes: 100 * 1024 * 1024,
     internalDocumentSourceGroupMaxMemoryBytes: 100 * 1024 * 1024,
+    internalDocumentSourceGraphLookupMaxMemoryBytes: 100 * 1024 * 1024,
+    internalDocumentSourceLookupHashJoinMaxMemoryBytes: 100 * 1024 * 1024,
+    internalChangeStreamSharedOplogReaderMaxBufferedEntries: 10000,
     internalDocumentSourceSetWindowFieldsMaxMemoryBytes: 100 * 1024 * 1024,
     internalQueryMaxJsEmitBytes: 100 * 1024 * 1024,
     internalQueryMaxPushBytes: 100 * 1024 * 1024,
@@ -47,7 +50,12 @@ const expectedParamDefaults = {
     internalQueryPlannerGenerateCoveredWholeIndexScans: false,
     internalQueryIgnoreUnknownJSONSchemaKeywords: false,
     internalQueryProhibitBlockingMergeOnMongoS: false,
-    internalQuerySlotBasedExecutionMaxStaticIndexScanIntervals: 1000
+    internalQuerySlotBasedExecutionMaxStaticIndexScanIntervals: 1000,
+    internalUpdateDeltaDamagesMaxRatio: 0.5,
+    internalQueryEnableDocumentMemoryPool: false,
+    internalQueryEnablePlanCacheWarmup: false,
+    internalQueryPlanCacheWarmupSnapshotIntervalSecs: 300,
+    internalQueryPlanCacheWarmupMaxEntriesPerCollection: 100,
 };
 
 function assertDefaultParameterValues() {
@@ -158,6 +166,18 @@ assertSetParameterSucceeds("internalDocumentSourceGroupMaxMemoryBytes", 11);
 assertSetParameterFails("internalDocumentSourceGroupMaxMemoryBytes", 0);
 assertSetParameterFails("internalDocumentSourceGroupMaxMemoryBytes", -1);
 
+assertSetParameterSucceeds("internalDocumentSourceGraphLookupMaxMemoryBytes", 11);
+assertSetParameterFails("internalDocumentSourceGraphLookupMaxMemoryBytes", 0);
+assertSetParameterFails("internalDocumentSourceGraphLookupMaxMemoryBytes", -1);
+
+assertSetParameterSucceeds("internalDocumentSourceLookupHashJoinMaxMemoryBytes", 11);
+assertSetParameterFails("internalDocumentSourceLookupHashJoinMaxMemoryBytes", 0);
+assertSetParameterFails("internalDocumentSourceLookupHashJoinMaxMemoryBytes", -1);
+
+assertSetParameterSucceeds("internalChangeStreamSharedOplogReaderMaxBufferedEntries", 1);
+assertSetParameterFails("internalChangeStreamSharedOplogReaderMaxBufferedEntries", 0);
+assertSetParameterFails("internalChangeStreamSharedOplogReaderMaxBufferedEntries", -1);
+
 assertSetParameterSucceeds("internalDocumentSourceSetWindowFieldsMaxMemoryBytes", 11);
 assertSetParameterFails("internalDocumentSourceSetWindowFieldsMaxMemoryBytes", 0);
 assertSetParameterFails("internalDocumentSourceSetWindowFieldsMaxMemoryBytes", -1);
@@ -199,6 +219,25 @@ assertSetParameterSucceeds("internalQuerySlotBasedExecutionMaxStaticIndexScanInt
 assertSetParameterFails("internalQuerySlotBasedExecutionMaxStaticIndexScanIntervals", 0);
 assertSetParameterFails("internalQuerySlotBasedExecutionMaxStaticIndexScanIntervals", -1);
 
+assertSetParameterSucceeds("internalUpdateDeltaDamagesMaxRatio", 0.0);
+assertSetParameterSucceeds("internalUpdateDeltaDamagesMaxRatio", 1.0);
+assertSetParameterFails("internalUpdateDeltaDamagesMaxRatio", -0.1);
+assertSetParameterFails("internalUpdateDeltaDamagesMaxRatio", 1.1);
+
+assertSetParameterSucceeds("internalQueryEnableDocumentMemoryPool", true);
+assertSetParameterSucceeds("internalQueryEnableDocumentMemoryPool", false);
+
+assertSetParameterSucceeds("internalQueryEnablePlanCacheWarmup", true);
+assertSetParameterSucceeds("internalQueryEnablePlanCacheWarmup", false);
+
+assertSetParameterSucceeds("internalQueryPlanCacheWarmupSnapshotIntervalSecs", 1);
+assertSetParameterFails("internalQueryPlanCacheWarmupSnapshotIntervalSecs", 0);
+assertSetParameterFails("internalQueryPlanCacheWarmupSnapshotIntervalSecs", -1);
+
+assertSetParameterSucceeds("internalQueryPlanCacheWarmupMaxEntriesPerCollection", 1);
+assertSetParameterFails("internalQueryPlanCacheWarmupMaxEntriesPerCollection", 0);
+assertSetParameterFails("internalQueryPlanCacheWarmupMaxEntriesPerCollection", -1);
+
 assertSetParameterSucceeds("internalQueryForceClassicEngine", true);
 assertSetParameterSucceeds("internalQueryForceClassicEngine", false);
 
@@ -0,0 +1,60 @@
+/**
+ * Tests that the sampling profiler aggregates the stacks of threads running commands, reports them
+ * through getSamplingProfile and summarizes them in serverStatus while enabled.
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod();
+const adminDB = conn.getDB("admin");
+const coll = conn.getDB(jsTestName()).coll;
+
+const res = adminDB.runCommand({getSamplingProfile: 1});
+if (res.code === ErrorCodes.IllegalOperation) {
+    jsTestLog("Skipping test as the sampling profiler is not supported on this platform");
+    MongoRunner.stopMongod(conn);
+    return;
+}
+assert.commandWorked(res);
+assert(!adminDB.serverStatus().hasOwnProperty("samplingProfiler"));
+
+assert.commandWorked(adminDB.runCommand({setParameter: 1, samplingProfilerEnabled: true}));
+assert.commandWorked(
+    coll.insert(Array.from({length: 1000}, (_, i) => ({_id: i, x: "a".repeat(100)}))));
+
+// Burn CPU in a command until it has been sampled.
+let profile;
+assert.soon(() => {
+    coll.aggregate([{$group: {_id: {$mod: ["$_id", 7]}, n: {$sum: 1}}}]).itcount();
+    profile = assert.commandWorked(adminDB.runCommand({getSamplingProfile: 1, limit: 1000}));
+    return profile.stacks.some((stack) => stack.command === "aggregate");
+}, () => tojson(profile.stats));
+
+assert(profile.stats.enabled, tojson(profile.stats));
+assert.gt(profile.stats.cpuSamples, 0, tojson(profile.stats));
+for (let stack of profile.stacks) {
+    assert.contains(stack.kind, ["cpu", "lockWait"], tojson(stack));
+    assert.gt(stack.samples, 0, tojson(stack));
+    assert.gt(stack.frames.length, 0, tojson(stack));
+}
+const aggregateStack = profile.stacks.find((stack) => stack.command === "aggregate");
+assert.eq("conn", aggregateStack.threadRole, tojson(aggregateStack));
+
+// The summary of the heaviest stacks is collected into the diagnostic data.
+const summary = adminDB.serverStatus().samplingProfiler;
+assert(summary, "samplingProfiler section missing from serverStatus");
+assert.gt(Object.keys(summary.stacks).length, 0, tojson(summary));
+
+assert.commandFailedWithCode(adminDB.runCommand({getSamplingProfile: 1, limit: 0}),
+                             ErrorCodes.BadValue);
+
+// Resetting discards the aggregated stacks, and disabling stops sampling.
+assert.commandWorked(adminDB.runCommand({setParameter: 1, samplingProfilerEnabled: false}));
+assert.commandWorked(adminDB.runCommand({getSamplingProfile: 1, reset: true}));
+profile = assert.commandWorked(adminDB.runCommand({getSamplingProfile: 1}));
+assert(!profile.stats.enabled, tojson(profile.stats));
+assert.eq(0, profile.stats.cpuSamples, tojson(profile.stats));
+assert.eq(0, profile.stacks.length, tojson(profile));
+
+MongoRunner.stopMongod(conn);
+})();
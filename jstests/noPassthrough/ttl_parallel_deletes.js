@@ -0,0 +1,76 @@
+/**
+ * Tests that the TTL monitor deletes the expired documents of several collections with multiple
+ * workers, in batches, and over split sub-ranges of each TTL index, and that it reports
+ * per-index statistics in the 'ttlMonitor' serverStatus section.
+ *
+ * @tags: [
+ *   requires_fcv_51,
+ * ]
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod({
+    setParameter: {
+        ttlMonitorSleepSecs: 1,
+        ttlMonitorWorkers: 4,
+        ttlMonitorDeleteBatchSize: 7,
+        ttlMonitorBatchesPerTurn: 2,
+        ttlMonitorSubRangesPerCollection: 3,
+    }
+});
+const db = conn.getDB(jsTestName());
+
+const kNumCollections = 3;
+const kNumExpired = 500;
+const kNumUnexpired = 20;
+const now = new Date();
+
+for (let i = 0; i < kNumCollections; i++) {
+    const coll = db["coll" + i];
+    const bulk = coll.initializeUnorderedBulkOp();
+    // Spread the expired documents over a day so that their range is split.
+    for (let j = 0; j < kNumExpired; j++) {
+        bulk.insert({_id: j, t: new Date(now.getTime() - 2 * 86400 * 1000 + j * 1000 * 60)});
+    }
+    for (let j = 0; j < kNumUnexpired; j++) {
+        bulk.insert({_id: kNumExpired + j, t: new Date(now.getTime() + 86400 * 1000)});
+    }
+    assert.commandWorked(bulk.execute());
+}
+
+const deletedBefore = db.serverStatus().metrics.ttl.deletedDocuments;
+for (let i = 0; i < kNumCollections; i++) {
+    assert.commandWorked(db["coll" + i].createIndex({t: 1}, {expireAfterSeconds: 3600}));
+}
+
+assert.soon(() => {
+    for (let i = 0; i < kNumCollections; i++) {
+        if (db["coll" + i].find().itcount() != kNumUnexpired) {
+            return false;
+        }
+    }
+    return true;
+}, "TTL monitor didn't delete the expired documents");
+
+for (let i = 0; i < kNumCollections; i++) {
+    assert.eq(0, db["coll" + i].find({t: {$lt: now}}).itcount());
+}
+assert.eq(kNumCollections * kNumExpired,
+          db.serverStatus().metrics.ttl.deletedDocuments - deletedBefore);
+
+// The section is only reported on request.
+assert(!db.serverStatus().hasOwnProperty("ttlMonitor"));
+const section = db.serverStatus({ttlMonitor: 1}).ttlMonitor;
+jsTestLog("ttlMonitor section: " + tojson(section));
+assert.eq(4, section.workers, tojson(section));
+for (let i = 0; i < kNumCollections; i++) {
+    const stats = section.collections[db["coll" + i].getFullName()]["t_1"];
+    assert(stats, tojson(section));
+    assert.eq(kNumExpired, stats.deletedDocuments, tojson(stats));
+    assert.gte(stats.lagMillis, 0, tojson(stats));
+    assert.gte(stats.subRanges, 1, tojson(stats));
+}
+
+MongoRunner.stopMongod(conn);
+})();
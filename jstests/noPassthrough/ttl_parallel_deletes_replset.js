@@ -0,0 +1,83 @@
+/**
+ * Tests that the TTL monitor deletes expired documents with multiple workers, in batches and over
+ * split sub-ranges on a replica set primary, where each delete is logged with its own oplog
+ * timestamp, and that the deletes replicate to the secondary.
+ *
+ * @tags: [
+ *   requires_fcv_51,
+ *   requires_replication,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({
+    nodes: 2,
+    nodeOptions: {
+        setParameter: {
+            ttlMonitorSleepSecs: 1,
+            ttlMonitorWorkers: 4,
+            ttlMonitorDeleteBatchSize: 7,
+            ttlMonitorBatchesPerTurn: 2,
+            ttlMonitorSubRangesPerCollection: 3,
+        }
+    }
+});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const db = primary.getDB(jsTestName());
+
+const kNumExpired = 300;
+const kNumUnexpired = 20;
+const now = new Date();
+
+// One collection with a TTL index and one clustered by the expiration time.
+assert.commandWorked(
+    db.createCollection("clustered", {clusteredIndex: {key: {_id: 1}, unique: true}}));
+const indexedColl = db.indexed;
+const clusteredColl = db.clustered;
+
+const indexedBulk = indexedColl.initializeUnorderedBulkOp();
+const clusteredBulk = clusteredColl.initializeUnorderedBulkOp();
+for (let i = 0; i < kNumExpired; i++) {
+    // Spread the expired documents over a day so that their range is split.
+    const t = new Date(now.getTime() - 2 * 86400 * 1000 + i * 1000 * 60);
+    indexedBulk.insert({_id: i, t: t});
+    clusteredBulk.insert({_id: t});
+}
+for (let i = 0; i < kNumUnexpired; i++) {
+    const t = new Date(now.getTime() + 86400 * 1000 + i);
+    indexedBulk.insert({_id: kNumExpired + i, t: t});
+    clusteredBulk.insert({_id: t});
+}
+assert.commandWorked(indexedBulk.execute());
+assert.commandWorked(clusteredBulk.execute());
+
+assert.commandWorked(indexedColl.createIndex({t: 1}, {expireAfterSeconds: 3600}));
+assert.commandWorked(db.runCommand({collMod: "clustered", expireAfterSeconds: 3600}));
+
+assert.soon(() => indexedColl.find().itcount() == kNumUnexpired &&
+                clusteredColl.find().itcount() == kNumUnexpired,
+            "TTL monitor didn't delete the expired documents");
+
+const section = primary.getDB("admin").serverStatus({ttlMonitor: 1}).ttlMonitor;
+jsTestLog("ttlMonitor section: " + tojson(section));
+assert.eq(kNumExpired,
+          section.collections[indexedColl.getFullName()]["t_1"].deletedDocuments,
+          tojson(section));
+
+// Every delete was logged on its own, and the deletes replicate to the secondary.
+assert.eq(kNumExpired,
+          primary.getDB("local")
+              .oplog.rs.find({op: "d", ns: indexedColl.getFullName()})
+              .itcount());
+rst.awaitReplication();
+const secondaryDB = rst.getSecondary().getDB(jsTestName());
+secondaryDB.getMongo().setSecondaryOk();
+assert.eq(kNumUnexpired, secondaryDB.indexed.find().itcount());
+assert.eq(kNumUnexpired, secondaryDB.clustered.find().itcount());
+
+rst.stopSet();
+})();
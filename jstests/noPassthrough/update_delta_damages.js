@@ -0,0 +1,65 @@
+/**
+ * Tests that small updates of large documents are written as the damages of their $v:2 delta,
+ * both on the primary and while secondaries apply the delta oplog entries, and that the
+ * serverStatus counters report the bytes that were not written.
+ *
+ * @tags: [
+ *   requires_replication,
+ *   requires_wiredtiger,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({nodes: 2});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const secondary = rst.getSecondary();
+const coll = primary.getDB(jsTestName()).coll;
+
+function getDeltaDamagesMetrics(conn) {
+    const metrics = conn.getDB("admin").serverStatus().metrics.query;
+    return {count: metrics.updateDeltaDamages, bytesSaved: metrics.updateDeltaDamagesBytesSaved};
+}
+
+const kPaddingSize = 200 * 1024;
+assert.commandWorked(coll.insert({_id: 0, a: 1, s: "x", padding: "p".repeat(kPaddingSize)}));
+assert.commandWorked(coll.createIndex({b: 1}));
+rst.awaitReplication();
+
+const primaryBefore = getDeltaDamagesMetrics(primary);
+const secondaryBefore = getDeltaDamagesMetrics(secondary);
+
+// Neither update changes the indexed field 'b'. The primary applies the first one in place
+// already, as it does not change the layout of the document, but the second one changes its size.
+assert.commandWorked(coll.update({_id: 0}, {$inc: {a: 1}}));
+assert.commandWorked(coll.update({_id: 0}, {$set: {s: "longer string"}, $unset: {missing: 1}}));
+rst.awaitReplication();
+
+const primaryAfter = getDeltaDamagesMetrics(primary);
+assert.eq(primaryBefore.count + 1, primaryAfter.count, tojson(primaryAfter));
+assert.gt(primaryAfter.bytesSaved - primaryBefore.bytesSaved, kPaddingSize, tojson(primaryAfter));
+
+const secondaryAfter = getDeltaDamagesMetrics(secondary);
+assert.eq(secondaryBefore.count + 2, secondaryAfter.count, tojson(secondaryAfter));
+
+// An update of an indexed field rewrites the whole document.
+assert.commandWorked(coll.update({_id: 0}, {$set: {b: 1}}));
+assert.eq(primaryAfter.count, getDeltaDamagesMetrics(primary).count);
+
+// The ratio knob of 0 disables writing damages.
+assert.commandWorked(
+    primary.adminCommand({setParameter: 1, internalUpdateDeltaDamagesMaxRatio: 0}));
+assert.commandWorked(coll.update({_id: 0}, {$set: {s: "an even longer string"}}));
+assert.eq(primaryAfter.count, getDeltaDamagesMetrics(primary).count);
+rst.awaitReplication();
+
+const expected = {_id: 0, a: 2, s: "an even longer string", padding: "p".repeat(kPaddingSize), b: 1};
+assert.docEq(expected, coll.findOne());
+assert.docEq(expected, secondary.getDB(jsTestName()).coll.findOne());
+rst.checkReplicatedDataHashes();
+
+rst.stopSet();
+})();
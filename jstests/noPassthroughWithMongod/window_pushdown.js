@@ -0,0 +1,133 @@
+/**
+ * Tests pushing $setWindowFields into the find layer, where it is executed by the SBE window stage.
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");
+load("jstests/libs/sbe_util.js");  // For checkSBEEnabled.
+
+if (!checkSBEEnabled(db, ["featureFlagSBEWindowPushdown"])) {
+    jsTestLog("Skipping test because the sbe window pushdown feature flag is disabled");
+    return;
+}
+
+const coll = db.window_pushdown;
+coll.drop();
+
+let docs = [];
+for (let i = 0; i < 50; ++i) {
+    docs.push({_id: i, part: i % 3, val: (i * 7) % 11, str: "s" + (i % 5)});
+}
+// Non-numeric, null and missing values are skipped by $sum and $avg, and nullish values by $min and
+// $max.
+docs.push({_id: 50, part: 1, val: "abc"});
+docs.push({_id: 51, part: 1, val: null});
+docs.push({_id: 52, part: 2});
+// A missing partition key lands in the same partition as a null one.
+docs.push({_id: 53, part: null, val: 4.5});
+docs.push({_id: 54, val: NumberDecimal("2.25")});
+assert.commandWorked(coll.insert(docs));
+
+let assertWindowPushdown = function(pipeline, pushedDown) {
+    const explain = coll.explain().aggregate(pipeline);
+    if (pushedDown) {
+        assert.neq(null, getAggPlanStage(explain, "WINDOW"), explain);
+    } else {
+        assert.eq(null, getAggPlanStage(explain, "WINDOW"), explain);
+    }
+};
+
+let assertResultsMatchWithAndWithoutPushdown = function(pipeline, pushedDown = true) {
+    assertWindowPushdown(pipeline, pushedDown);
+    const resultWithPushdown = coll.aggregate(pipeline).toArray();
+
+    // Turn sbe off.
+    assert.commandWorked(db.adminCommand({setParameter: 1, internalQueryForceClassicEngine: true}));
+    const resultNoPushdown = coll.aggregate(pipeline).toArray();
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryForceClassicEngine: false}));
+
+    // Unlike the default comparison of assert.sameMembers(), friendlyEqual() also compares the
+    // order of the fields.
+    assert.sameMembers(resultNoPushdown, resultWithPushdown, undefined, friendlyEqual);
+};
+
+const windows = [
+    {documents: ["unbounded", "unbounded"]},
+    {documents: ["unbounded", "current"]},
+    {documents: ["current", "unbounded"]},
+    {documents: [-2, 1]},
+    {documents: [-5, -3]},
+    {documents: [2, 4]},
+];
+for (let window of windows) {
+    for (let partitionBy of [undefined, "$part"]) {
+        let spec = {
+            sortBy: {_id: 1},
+            output: {
+                sum: {$sum: "$val", window: window},
+                avg: {$avg: "$val", window: window},
+                min: {$min: "$val", window: window},
+                max: {$max: "$str", window: window},
+                count: {$count: {}, window: window},
+            }
+        };
+        if (partitionBy) {
+            spec.partitionBy = partitionBy;
+        }
+        assertResultsMatchWithAndWithoutPushdown([{$setWindowFields: spec}]);
+        assertResultsMatchWithAndWithoutPushdown(
+            [{$match: {_id: {$gte: 10}}}, {$setWindowFields: spec}]);
+    }
+}
+
+// A window stage can be pushed down along with a $group stage.
+assertResultsMatchWithAndWithoutPushdown([
+    {$setWindowFields: {partitionBy: "$part", sortBy: {_id: 1}, output: {s: {$sum: "$val"}}}},
+    {$group: {_id: "$part", total: {$max: "$s"}}},
+]);
+
+assertResultsMatchWithAndWithoutPushdown([{
+    $setWindowFields: {
+        partitionBy: "$str",
+        sortBy: {_id: 1},
+        output: {s: {$sum: "$_id", window: {documents: [-1, 0]}}}
+    }
+}]);
+
+// Outputs which replace existing fields take their position in the document, as in the classic
+// engine, while new fields are added at the end.
+assertResultsMatchWithAndWithoutPushdown([{
+    $setWindowFields: {
+        partitionBy: "$part",
+        sortBy: {_id: 1},
+        output: {
+            str: {$max: "$str", window: {documents: [-1, 1]}},
+            newField: {$count: {}},
+            val: {$sum: "$val", window: {documents: [-1, 0]}},
+        }
+    }
+}]);
+
+// Range-based windows and other window functions are executed by the classic engine.
+assertResultsMatchWithAndWithoutPushdown(
+    [{
+        $setWindowFields:
+            {sortBy: {_id: 1}, output: {s: {$sum: "$val", window: {range: [-2, 2]}}}}
+    }],
+    false);
+assertResultsMatchWithAndWithoutPushdown(
+    [{$setWindowFields: {sortBy: {_id: 1}, output: {s: {$push: "$val"}}}}], false);
+assertResultsMatchWithAndWithoutPushdown(
+    [{$setWindowFields: {sortBy: {_id: 1}, output: {"a.b": {$sum: "$val"}}}}], false);
+
+// Partitioning by an array is an error in both engines.
+assert.commandWorked(coll.insert({_id: 100, part: [1, 2], val: 1}));
+const arrayPartition =
+    [{$setWindowFields: {partitionBy: "$part", sortBy: {_id: 1}, output: {s: {$sum: "$val"}}}}];
+assertWindowPushdown(arrayPartition, true);
+assert.commandFailedWithCode(
+    db.runCommand({aggregate: coll.getName(), pipeline: arrayPartition, cursor: {}}),
+    ErrorCodes.TypeMismatch);
+}());
@@ -208,6 +208,7 @@ const allCommands = {
         expectedErrorCode: ErrorCodes.NotPrimaryOrSecondary
     },
     getParameter: {skip: isNotAUserDataRead},
+    getSamplingProfile: {skip: isNotAUserDataRead},
     getShardMap: {skip: isNotAUserDataRead},
     getShardVersion: {skip: isPrimaryOnly},
     getnonce: {skip: isNotAUserDataRead},
@@ -0,0 +1,75 @@
+/**
+ * Tests that a node configured with initialSyncMethod "fileCopyBased" copies the data files of its
+ * sync source if the sync source can open backup cursors, and falls back to logical initial sync
+ * otherwise.
+ *
+ * @tags: [
+ *   requires_persistence,
+ *   requires_wiredtiger,
+ *   featureFlagFileCopyBasedInitialSync,
+ * ]
+ */
+
+(function() {
+"use strict";
+
+const testName = "initial_sync_file_copy_based";
+const dbName = testName;
+const replTest = new ReplSetTest({name: testName, nodes: 1});
+replTest.startSet();
+replTest.initiate();
+
+const primary = replTest.getPrimary();
+const primaryDB = primary.getDB(dbName);
+
+const kNumDocs = 1000;
+const bulk = primaryDB.coll.initializeUnorderedBulkOp();
+for (let i = 0; i < kNumDocs; i++) {
+    bulk.insert({_id: i, x: i, padding: "a".repeat(100)});
+}
+assert.commandWorked(bulk.execute());
+assert.commandWorked(primaryDB.coll.createIndex({x: 1}));
+
+// Backup cursors are not available in every build.
+const res = primary.adminCommand({aggregate: 1, pipeline: [{$backupCursor: {}}], cursor: {}});
+const backupCursorSupported = res.ok;
+if (backupCursorSupported) {
+    assert.commandWorked(primary.adminCommand(
+        {killCursors: "$cmd.aggregate", cursors: [res.cursor.id]}));
+}
+
+const secondary = replTest.add({
+    rsConfig: {priority: 0, votes: 0},
+    setParameter: {initialSyncMethod: "fileCopyBased", numInitialSyncAttempts: 1}
+});
+replTest.reInitiate();
+replTest.awaitSecondaryNodes();
+replTest.awaitReplication();
+
+// Exactly one of the two initial sync methods populated the node.
+const kFileCopyBasedDoneLogId = 6441015;
+const kFallbackToLogicalLogId = 5780600;
+if (backupCursorSupported) {
+    checkLog.containsJson(secondary, kFileCopyBasedDoneLogId);
+    assert(!checkLog.checkContainsOnceJson(secondary, kFallbackToLogicalLogId, {}),
+           "node fell back to logical initial sync although the sync source supports backups");
+
+    // The node keeps its own last vote and rollback ID rather than the sync source's.
+    checkLog.containsJson(secondary, 6441017);
+} else {
+    checkLog.containsJson(secondary, kFallbackToLogicalLogId);
+    assert(!checkLog.checkContainsOnceJson(secondary, kFileCopyBasedDoneLogId, {}),
+           "node completed file copy based initial sync without backup cursor support");
+}
+
+const secondaryDB = secondary.getDB(dbName);
+assert.eq(kNumDocs, secondaryDB.coll.find().itcount());
+assert.eq(2, secondaryDB.coll.getIndexes().length);
+replTest.checkReplicatedDataHashes();
+
+// Writes keep replicating to the synced node.
+assert.commandWorked(primaryDB.coll.insert({_id: kNumDocs}, {writeConcern: {w: 2}}));
+assert.eq(kNumDocs + 1, secondaryDB.coll.find().itcount());
+
+replTest.stopSet();
+})();
@@ -0,0 +1,51 @@
+/**
+ * Tests that initial sync clones the collections of a database concurrently, and fetches large
+ * collections over multiple cursors over ranges of their _id index.
+ */
+
+(function() {
+"use strict";
+
+const testName = "initial_sync_parallel_clone";
+const dbName = testName;
+const replTest = new ReplSetTest({name: testName, nodes: 1});
+replTest.startSet();
+replTest.initiate();
+
+const primary = replTest.getPrimary();
+const primaryDB = primary.getDB(dbName);
+
+const kNumCollections = 6;
+const kNumDocs = 2000;
+for (let i = 0; i < kNumCollections; i++) {
+    const bulk = primaryDB["coll" + i].initializeUnorderedBulkOp();
+    for (let j = 0; j < kNumDocs; j++) {
+        bulk.insert({_id: j, x: i, padding: "a".repeat(100)});
+    }
+    assert.commandWorked(bulk.execute());
+    assert.commandWorked(primaryDB["coll" + i].createIndex({x: 1}));
+}
+
+// A small batch size makes each range span several batches.
+const secondary = replTest.add({
+    rsConfig: {priority: 0, votes: 0},
+    setParameter: {
+        initialSyncConcurrentCollectionClones: 4,
+        collectionClonerRangeCursors: 4,
+        collectionClonerRangeMinBytes: 0,
+        collectionClonerBatchSize: 100,
+    }
+});
+replTest.reInitiate();
+replTest.awaitSecondaryNodes();
+replTest.awaitReplication();
+
+const secondaryDB = secondary.getDB(dbName);
+for (let i = 0; i < kNumCollections; i++) {
+    assert.eq(kNumDocs, secondaryDB["coll" + i].find().itcount());
+    assert.eq(2, secondaryDB["coll" + i].getIndexes().length);
+}
+replTest.checkReplicatedDataHashes();
+
+replTest.stopSet();
+})();
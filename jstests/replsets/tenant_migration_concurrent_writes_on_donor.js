@@ -805,6 +805,7 @@ const testCases = {
     getLog: {skip: isNotRunOnUserDatabase},
     getMore: {skip: isNotWriteCommand},
     getParameter: {skip: isNotRunOnUserDatabase},
+    getSamplingProfile: {skip: isNotRunOnUserDatabase},
     getShardMap: {skip: isNotRunOnUserDatabase},
     getShardVersion: {skip: isNotRunOnUserDatabase},
     getnonce: {skip: isNotRunOnUserDatabase},
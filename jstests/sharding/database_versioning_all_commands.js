@@ -463,6 +463,7 @@ let testCases = {
     getLog: {skip: "executes locally on mongos (not sent to any remote node)"},
     getMore: {skip: "requires a previously established cursor"},
     getParameter: {skip: "executes locally on mongos (not sent to any remote node)"},
+    getSamplingProfile: {skip: "executes locally on mongos (not sent to any remote node)"},
     getShardMap: {skip: "executes locally on mongos (not sent to any remote node)"},
     getShardVersion: {skip: "executes locally on mongos (not sent to any remote node)"},
     getnonce: {skip: "not on a user database"},
@@ -631,6 +631,10 @@ let MongosAPIParametersUtil = (function() {
             commandName: "getParameter",
             skip: "executes locally on mongos (not sent to any remote node)"
         },
+        {
+            commandName: "getSamplingProfile",
+            skip: "executes locally on mongos (not sent to any remote node)"
+        },
         {
             commandName: "getShardMap",
             skip: "executes locally on mongos (not sent to any remote node)"
@@ -0,0 +1,61 @@
+/**
+ * Tests that a chunk migration clones the documents of the chunk over several concurrent streams
+ * when the recipient is configured with migrateCloneStreams, including while documents of the
+ * chunk are written to during the clone.
+ *
+ * @tags: [
+ *   requires_fcv_51,
+ * ]
+ */
+
+(function() {
+"use strict";
+
+load("jstests/libs/fail_point_util.js");
+load("jstests/libs/parallel_shell_helpers.js");
+
+const dbName = "test";
+const collName = "foo";
+const ns = dbName + "." + collName;
+
+const st = new ShardingTest({
+    shards: 2,
+    rs: {nodes: 1},
+    rsOptions: {setParameter: {migrateCloneStreams: 4, migrateCloneInsertionBatchSize: 50}}
+});
+
+assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+assert.commandWorked(st.s.adminCommand({movePrimary: dbName, to: st.shard0.shardName}));
+assert.commandWorked(st.s.adminCommand({shardCollection: ns, key: {x: 1}}));
+
+const numDocs = 5000;
+const coll = st.s.getCollection(ns);
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < numDocs; i++) {
+    bulk.insert({_id: i, x: i, padding: "a".repeat(200)});
+}
+assert.commandWorked(bulk.execute());
+
+// Write to the chunk once the clone has started, so that the writes go through _transferMods.
+const hangAfterClone = configureFailPoint(st.shard1, "migrateThreadHangAtStep4");
+const awaitMigration = startParallelShell(
+    funWithArgs(function(ns, toShard) {
+        assert.commandWorked(db.adminCommand(
+            {moveChunk: ns, find: {x: 0}, to: toShard, _waitForDelete: true}));
+    }, ns, st.shard1.shardName), st.s.port);
+
+hangAfterClone.wait();
+assert.commandWorked(coll.insert({_id: numDocs, x: numDocs}));
+assert.commandWorked(coll.remove({_id: 0}));
+assert.commandWorked(coll.update({_id: 1}, {$set: {updated: true}}));
+hangAfterClone.off();
+awaitMigration();
+
+assert.eq(numDocs, coll.find().itcount());
+assert.eq(numDocs, st.rs1.getPrimary().getCollection(ns).find().itcount());
+assert.eq(0, st.rs0.getPrimary().getCollection(ns).find().itcount());
+assert.eq(null, coll.findOne({_id: 0}));
+assert.eq(true, coll.findOne({_id: 1}).updated);
+
+st.stop();
+})();
@@ -0,0 +1,86 @@
+/**
+ * Tests that the range deleter throttles itself when the majority of the replica set lags behind
+ * its deletes, that it resumes once the majority catches up, and that it removes all the orphans
+ * of a migrated range and replicates the deletes to the secondaries.
+ *
+ * @tags: [
+ *   requires_fcv_51,
+ * ]
+ */
+
+(function() {
+"use strict";
+
+load("jstests/libs/fail_point_util.js");
+
+const dbName = "test";
+const collName = "foo";
+const ns = dbName + "." + collName;
+
+const st = new ShardingTest({
+    shards: 2,
+    rs: {nodes: 2},
+    rsOptions: {
+        setParameter: {
+            rangeDeleterBatchSize: 64,
+            rangeDeleterDocsPerReplicationLagCheck: 7,
+            // Any measurable lag throttles the range deleter.
+            rangeDeleterMaxReplicationLagSecs: 1,
+        }
+    }
+});
+
+assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+assert.commandWorked(st.s.adminCommand({movePrimary: dbName, to: st.shard0.shardName}));
+assert.commandWorked(st.s.adminCommand({shardCollection: ns, key: {x: 1}}));
+assert.commandWorked(st.s.adminCommand({split: ns, middle: {x: 0}}));
+
+const numDocs = 1000;
+const bulk = st.s.getCollection(ns).initializeUnorderedBulkOp();
+for (let i = -numDocs; i < numDocs; i++) {
+    bulk.insert({_id: i, x: i, y: i % 10});
+}
+assert.commandWorked(bulk.execute());
+assert.commandWorked(st.s.getCollection(ns).createIndex({y: 1}));
+
+const donorPrimary = st.rs0.getPrimary();
+const donorSecondary = st.rs0.getSecondary();
+const donorColl = donorPrimary.getCollection(ns);
+const getThrottledBatches = () => assert.commandWorked(donorPrimary.adminCommand({serverStatus: 1}))
+                                      .shardingStatistics.countRangeDeleterBatchesThrottled;
+const throttledBefore = getThrottledBatches();
+
+// Hold the range deletion back until the secondary of the donor lags behind.
+const suspendRangeDeletion = configureFailPoint(donorPrimary, "suspendRangeDeletion");
+assert.commandWorked(st.s.adminCommand({moveChunk: ns, find: {x: 0}, to: st.shard1.shardName}));
+suspendRangeDeletion.wait();
+
+// Stop replication to the secondary, then apply a write long enough after the last majority
+// committed one for the majority commit point to lag by more than a second.
+const stopReplProducer = configureFailPoint(donorSecondary, "stopReplProducer");
+sleep(2 * 1000);
+assert.commandWorked(donorPrimary.getDB(dbName).unrelated.insert({}, {writeConcern: {w: 1}}));
+
+suspendRangeDeletion.off();
+assert.soon(() => getThrottledBatches() > throttledBefore,
+            "range deleter did not throttle itself on replication lag");
+
+// The range deleter waits for the majority to catch up before deleting more orphans.
+assert.gt(donorColl.find({x: {$gte: 0}}).itcount(), 0);
+assert.eq(1, donorPrimary.getDB("config").rangeDeletions.count());
+
+stopReplProducer.off();
+assert.soon(() => donorPrimary.getDB("config").rangeDeletions.count() == 0,
+            "range deleter did not resume after the majority caught up");
+
+assert.eq(numDocs, donorColl.find().itcount());
+assert.eq(0, donorColl.find({x: {$gte: 0}}).itcount());
+assert.eq(numDocs, st.rs1.getPrimary().getCollection(ns).find().itcount());
+
+st.rs0.awaitReplication();
+const secondaryColl = donorSecondary.getCollection(ns);
+secondaryColl.getMongo().setSecondaryOk();
+assert.eq(numDocs, secondaryColl.find().itcount());
+
+st.stop();
+})();
@@ -462,6 +462,7 @@ let testCases = {
     getLog: {skip: "does not accept read or write concern"},
     getMore: {skip: "does not accept read or write concern"},
     getParameter: {skip: "does not accept read or write concern"},
+    getSamplingProfile: {skip: "does not accept read or write concern"},
     getShardMap: {skip: "internal command"},
     getShardVersion: {skip: "internal command"},
     getnonce: {skip: "does not accept read or write concern"},
@@ -212,6 +212,7 @@ let testCases = {
     getLog: {skip: "does not return user data"},
     getMore: {skip: "shard version already established"},
     getParameter: {skip: "does not return user data"},
+    getSamplingProfile: {skip: "does not return user data"},
     getShardMap: {skip: "does not return user data"},
     getShardVersion: {skip: "primary only"},
     getnonce: {skip: "does not return user data"},
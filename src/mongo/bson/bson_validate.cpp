@@ -28,14 +28,20 @@
  */
 #define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kDefault
 
+#include <boost/predef/hardware/simd.h>
 #include <cstring>
 #include <vector>
 
+#if defined(BOOST_HW_SIMD_X86_AVAILABLE) && BOOST_HW_SIMD_X86 >= BOOST_HW_SIMD_X86_SSE2_VERSION
+#include <emmintrin.h>
+#endif
+
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/bsonelement.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/bits.h"
 
 namespace mongo {
 namespace {
@@ -90,21 +96,23 @@ public:
 
     Status validate() noexcept {
         try {
-            _currFrame = _frames.begin();
-            _currElem = nullptr;
-            auto maxFrames = BSONDepth::getMaxAllowableDepth() + 1;  // A flat BSON has one frame.
-            uassert(InvalidBSON, "Cannot enforce max nesting depth", _frames.size() <= maxFrames);
-            uassert(InvalidBSON, "BSON data has to be at least 5 bytes", _maxLength >= 5);
-
-            // Read the length as signed integer, to ensure we limit it to < 2GB.
-            // All other lengths are read as unsigned, which makes for easier bounds checking.
-            Cursor cursor = {_data, _data + _maxLength};
-            int32_t len = cursor.template read<int32_t>();
-            uassert(InvalidBSON, "BSON data has to be at least 5 bytes", len >= 5);
-            uassert(InvalidBSON, "Incorrect BSON length", static_cast<size_t>(len) <= _maxLength);
-            const char* end = _currFrame->end = _data + len;
-            uassert(InvalidBSON, "BSON object not terminated with EOO", end[-1] == 0);
-            _validateIterative(Cursor{cursor.ptr, end});
+            _validateObject(_data, _maxLength);
+        } catch (const ExceptionForCat<ErrorCategory::ValidationError>& e) {
+            return Status(e.code(), str::stream() << e.what() << " " << _context());
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Validates that the buffer holds a sequence of BSON objects which fills it exactly. All the
+     * objects are validated in a single pass sharing the same frames.
+     */
+    Status validateSequence() noexcept {
+        try {
+            const char* const bufEnd = _data + _maxLength;
+            for (const char* obj = _data; obj != bufEnd;) {
+                obj += _validateObject(obj, bufEnd - obj);
+            }
         } catch (const ExceptionForCat<ErrorCategory::ValidationError>& e) {
             return Status(e.code(), str::stream() << e.what() << " " << _context());
         }
@@ -150,6 +158,15 @@ private:
             // This is actually by far the hottest code in all of BSON validation.
             dassert(ptr < end);
             size_t len = 0;
+#if defined(BOOST_HW_SIMD_X86_AVAILABLE) && BOOST_HW_SIMD_X86 >= BOOST_HW_SIMD_X86_SSE2_VERSION
+            // Look for the NUL 16 bytes at a time, as long as these bytes are within the object.
+            // The object ends with EOO, so the byte-wise loop below always finds the NUL.
+            for (; end - ptr >= static_cast<ptrdiff_t>(len + 16); len += 16) {
+                auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + len));
+                if (int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_setzero_si128())))
+                    return len + countTrailingZerosNonZero32(mask);
+            }
+#endif
             while (ptr[len])
                 ++len;
             return len;
@@ -159,6 +176,29 @@ private:
         const char* const end;
     };
 
+    /**
+     * Validates the BSON object starting at 'obj', which must fit within 'maxLength' bytes, and
+     * returns its size.
+     */
+    int32_t _validateObject(const char* obj, uint64_t maxLength) {
+        _currFrame = _frames.begin();
+        _currElem = nullptr;
+        auto maxFrames = BSONDepth::getMaxAllowableDepth() + 1;  // A flat BSON has one frame.
+        uassert(InvalidBSON, "Cannot enforce max nesting depth", _frames.size() <= maxFrames);
+        uassert(InvalidBSON, "BSON data has to be at least 5 bytes", maxLength >= 5);
+
+        // Read the length as signed integer, to ensure we limit it to < 2GB.
+        // All other lengths are read as unsigned, which makes for easier bounds checking.
+        Cursor cursor = {obj, obj + maxLength};
+        int32_t len = cursor.template read<int32_t>();
+        uassert(InvalidBSON, "BSON data has to be at least 5 bytes", len >= 5);
+        uassert(InvalidBSON, "Incorrect BSON length", static_cast<size_t>(len) <= maxLength);
+        const char* end = _currFrame->end = obj + len;
+        uassert(InvalidBSON, "BSON object not terminated with EOO", end[-1] == 0);
+        _validateIterative(Cursor{cursor.ptr, end});
+        return len;
+    }
+
     const char* _pushFrame(Cursor cursor) {
         uassert(ErrorCodes::Overflow,
                 "BSONObj exceeds maximum nested object depth",
@@ -311,4 +351,12 @@ Status validateBSON(const char* originalBuffer, uint64_t maxLength) noexcept {
 
     return ValidateBuffer<true>(originalBuffer, maxLength).validate();
 }
+
+Status validateBSONSequence(const char* originalBuffer, uint64_t length) noexcept {
+    // Same as above: only rerun the precise version to get the error context.
+    if (MONGO_likely(ValidateBuffer<false>(originalBuffer, length).validateSequence().isOK()))
+        return Status::OK();
+
+    return ValidateBuffer<true>(originalBuffer, length).validateSequence();
+}
 }  // namespace mongo
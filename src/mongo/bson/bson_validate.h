@@ -50,4 +50,11 @@ namespace mongo {
  * Length is only limited by the buffer's maxLength and the inherent 2GB - 1 format limitation.
  */
 Status validateBSON(const char* buf, uint64_t maxLength) noexcept;
+
+/**
+ * Checks that the buf holds a sequence of BSON objects, as in an OP_MSG document sequence, which
+ * fills it exactly. Each object is checked as by validateBSON, but the whole sequence is validated
+ * in a single pass.
+ */
+Status validateBSONSequence(const char* buf, uint64_t length) noexcept;
 }  // namespace mongo
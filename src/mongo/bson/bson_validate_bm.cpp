@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds a document with 'numFields' fields whose names are 'nameLen' characters long, holding
+ * alternately an int, a string and a small sub-document.
+ */
+BSONObj buildDocument(int i, int numFields, int nameLen) {
+    BSONObjBuilder builder;
+    builder.append("_id", i);
+    for (int f = 0; f < numFields; ++f) {
+        std::string name = std::to_string(f) + std::string(nameLen, 'f');
+        switch (f % 3) {
+            case 0:
+                builder.append(name, i * f);
+                break;
+            case 1:
+                builder.append(name, "some string value");
+                break;
+            default:
+                builder.append(name, BSON("x" << f << "y" << 1.5));
+        }
+    }
+    return builder.obj();
+}
+
+void BM_validateDocument(benchmark::State& state) {
+    BSONObj obj = buildDocument(0, 100, state.range(0));
+    invariant(validateBSON(obj.objdata(), obj.objsize()).isOK());
+
+    size_t totalBytes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize()));
+        totalBytes += obj.objsize();
+    }
+    state.SetBytesProcessed(totalBytes);
+}
+
+/**
+ * Lays out 'numDocs' documents back to back, as in an OP_MSG document sequence.
+ */
+BufBuilder buildSequence(int numDocs) {
+    BufBuilder buf;
+    for (int i = 0; i < numDocs; ++i)
+        buildDocument(i, 10, 8).appendSelfToBufBuilder(buf);
+    return buf;
+}
+
+void BM_validateSequenceByDocument(benchmark::State& state) {
+    BufBuilder buf = buildSequence(state.range(0));
+
+    size_t totalBytes = 0;
+    for (auto _ : state) {
+        for (const char* obj = buf.buf(); obj != buf.buf() + buf.len();) {
+            auto len = ConstDataView(obj).read<LittleEndian<int32_t>>();
+            benchmark::DoNotOptimize(validateBSON(obj, buf.buf() + buf.len() - obj));
+            obj += len;
+        }
+        totalBytes += buf.len();
+    }
+    state.SetBytesProcessed(totalBytes);
+}
+
+void BM_validateSequence(benchmark::State& state) {
+    BufBuilder buf = buildSequence(state.range(0));
+    invariant(validateBSONSequence(buf.buf(), buf.len()).isOK());
+
+    size_t totalBytes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSONSequence(buf.buf(), buf.len()));
+        totalBytes += buf.len();
+    }
+    state.SetBytesProcessed(totalBytes);
+}
+
+// Field name lengths below and above the 16 bytes scanned at once for the NUL.
+BENCHMARK(BM_validateDocument)->Arg(1)->Arg(8)->Arg(32)->Arg(128);
+BENCHMARK(BM_validateSequenceByDocument)->Arg(1)->Arg(100)->Arg(10'000);
+BENCHMARK(BM_validateSequence)->Arg(1)->Arg(100)->Arg(10'000);
+
+}  // namespace
+}  // namespace mongo
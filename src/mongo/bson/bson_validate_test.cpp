@@ -431,4 +431,53 @@ TEST(BSONValidateFast, MaxNestingDepth) {
     Status status = validateBSON(tooDeepNesting.objdata(), tooDeepNesting.objsize());
     ASSERT_EQ(status.code(), ErrorCodes::Overflow);
 }
+
+TEST(BSONValidateFast, LongFieldNames) {
+    // Field names longer than a vector register, with the NUL at every offset.
+    for (int len = 1; len < 70; ++len) {
+        std::string name(len, 'x');
+        BSONObj obj = BSON(name << 1 << "a" << BSON(name << name));
+        ASSERT_OK(validateBSON(obj.objdata(), obj.objsize()));
+    }
+}
+
+TEST(BSONValidateFast, UnterminatedLongFieldName) {
+    BufBuilder bb;
+    bb.appendNum(0);  // Placeholder for the size.
+    bb.appendChar(NumberInt);
+    bb.appendStr(std::string(40, 'x'), /*withNUL*/ false);
+    bb.appendChar(EOO);  // The field name runs into the EOO, leaving no room for the value.
+    DataView(bb.buf()).write(tagLittleEndian(bb.len()));
+    ASSERT_EQ(validateBSON(bb.buf(), bb.len()).code(), ErrorCodes::InvalidBSON);
+}
+
+TEST(BSONValidateSequence, Empty) {
+    ASSERT_OK(validateBSONSequence(nullptr, 0));
+}
+
+TEST(BSONValidateSequence, Valid) {
+    BufBuilder bb;
+    for (int i = 0; i < 10; ++i) {
+        BSONObj obj = BSON("_id" << i << "a" << BSON("b" << std::string(i * 7, 'y')));
+        obj.appendSelfToBufBuilder(bb);
+    }
+    ASSERT_OK(validateBSONSequence(bb.buf(), bb.len()));
+}
+
+TEST(BSONValidateSequence, InvalidDocument) {
+    BufBuilder bb;
+    BSON("_id" << 0).appendSelfToBufBuilder(bb);
+    BSON("_id" << 1 << "b" << true).appendSelfToBufBuilder(bb);
+    bb.buf()[bb.len() - 2] = 2;  // Neither false nor true.
+    Status status = validateBSONSequence(bb.buf(), bb.len());
+    ASSERT_EQ(status.code(), ErrorCodes::InvalidBSON);
+    ASSERT_STRING_CONTAINS(status.reason(), "_id: 1");
+}
+
+TEST(BSONValidateSequence, TruncatedDocument) {
+    BufBuilder bb;
+    BSON("_id" << 0).appendSelfToBufBuilder(bb);
+    BSON("_id" << 1).appendSelfToBufBuilder(bb);
+    ASSERT_EQ(validateBSONSequence(bb.buf(), bb.len() - 1).code(), ErrorCodes::InvalidBSON);
+}
 }  // namespace
@@ -288,6 +288,31 @@ public:
 
     virtual void init(OperationContext* opCtx) {}
 
+    /**
+     * Like init(), but defers instantiating the index catalog, and with it opening the tables of
+     * the collection's indexes, until the index catalog is first accessed.
+     */
+    virtual void initWithDeferredIndexCatalog(OperationContext* opCtx) {
+        init(opCtx);
+    }
+
+    /**
+     * Returns true if the index catalog of this collection has been instantiated and has not been
+     * accessed since 'idleSince', making it a candidate for releaseIdleIndexCatalog().
+     */
+    virtual bool isIndexCatalogIdle(Date_t idleSince) const {
+        return false;
+    }
+
+    /**
+     * Discards the index catalog of this writable collection if it has not been accessed since
+     * 'idleSince', so that it is instantiated again on next access. Returns false if the index
+     * catalog was kept, for instance because it has index builds in progress.
+     */
+    virtual bool releaseIdleIndexCatalog(OperationContext* opCtx, Date_t idleSince) {
+        return false;
+    }
+
     virtual bool isCommitted() const {
         return true;
     }
@@ -259,17 +259,19 @@ public:
                 case UncommittedCatalogUpdates::Entry::Action::kWritable:
                     writeJobs.push_back(
                         [collection = std::move(entry.collection)](CollectionCatalog& catalog) {
-                            catalog._collections[collection->ns()] = collection;
-                            catalog._catalog[collection->uuid()] = collection;
+                            catalog._collections =
+                                catalog._collections.set(collection->ns(), collection);
+                            catalog._catalog = catalog._catalog.set(collection->uuid(), collection);
                             auto dbIdPair = std::make_pair(collection->ns().db().toString(),
                                                            collection->uuid());
-                            catalog._orderedCollections[dbIdPair] = collection;
+                            catalog._orderedCollections =
+                                catalog._orderedCollections.set(dbIdPair, collection);
                         });
                     break;
                 case UncommittedCatalogUpdates::Entry::Action::kRenamed:
                     writeJobs.push_back(
                         [& from = entry.nss, &to = entry.renameTo](CollectionCatalog& catalog) {
-                            catalog._collections.erase(from);
+                            catalog._collections = catalog._collections.erase(from);
 
                             auto fromStr = from.ns();
                             auto toStr = to.ns();
@@ -334,10 +336,9 @@ CollectionCatalog::iterator::iterator(OperationContext* opCtx,
     }
 }
 
-CollectionCatalog::iterator::iterator(
-    OperationContext* opCtx,
-    std::map<std::pair<std::string, UUID>, std::shared_ptr<Collection>>::const_iterator mapIter,
-    const CollectionCatalog& catalog)
+CollectionCatalog::iterator::iterator(OperationContext* opCtx,
+                                      OrderedCollectionMap::const_iterator mapIter,
+                                      const CollectionCatalog& catalog)
     : _opCtx(opCtx), _mapIter(mapIter), _catalog(&catalog) {}
 
 CollectionCatalog::iterator::value_type CollectionCatalog::iterator::operator*() {
@@ -595,7 +596,7 @@ void CollectionCatalog::onCloseCatalog(OperationContext* opCtx) {
     invariant(opCtx->lockState()->isW());
     invariant(!_shadowCatalog);
     _shadowCatalog.emplace();
-    for (auto& entry : _catalog)
+    for (const auto& entry : _catalog)
         _shadowCatalog->insert({entry.first, entry.second->ns()});
 }
 
@@ -685,8 +686,8 @@ bool CollectionCatalog::isCollectionAwaitingVisibility(UUID uuid) const {
 }
 
 std::shared_ptr<Collection> CollectionCatalog::_lookupCollectionByUUID(UUID uuid) const {
-    auto foundIt = _catalog.find(uuid);
-    return foundIt == _catalog.end() ? nullptr : foundIt->second;
+    const auto* coll = _catalog.find(uuid);
+    return coll ? *coll : nullptr;
 }
 
 std::shared_ptr<const Collection> CollectionCatalog::lookupCollectionByNamespaceForRead(
@@ -695,8 +696,8 @@ std::shared_ptr<const Collection> CollectionCatalog::lookupCollectionByNamespace
         return coll;
     }
 
-    auto it = _collections.find(nss);
-    auto coll = (it == _collections.end() ? nullptr : it->second);
+    const auto* entry = _collections.find(nss);
+    auto coll = (entry ? *entry : nullptr);
     return (coll && coll->isCommitted()) ? coll : nullptr;
 }
 
@@ -726,8 +727,8 @@ Collection* CollectionCatalog::lookupCollectionByNamespaceForMetadataWrite(
         return nullptr;
     }
 
-    auto it = _collections.find(nss);
-    auto coll = (it == _collections.end() ? nullptr : it->second);
+    const auto* entry = _collections.find(nss);
+    auto coll = (entry ? *entry : nullptr);
 
     if (!coll || !coll->isCommitted())
         return nullptr;
@@ -763,8 +764,8 @@ CollectionPtr CollectionCatalog::lookupCollectionByNamespace(OperationContext* o
         return nullptr;
     }
 
-    auto it = _collections.find(nss);
-    auto coll = (it == _collections.end() ? nullptr : it->second);
+    const auto* entry = _collections.find(nss);
+    auto coll = (entry ? *entry : nullptr);
     return (coll && coll->isCommitted())
         ? CollectionPtr(opCtx, coll.get(), LookupCollectionForYieldRestore())
         : nullptr;
@@ -787,11 +788,10 @@ boost::optional<NamespaceString> CollectionCatalog::lookupNSSByUUID(OperationCon
         return coll->ns();
     }
 
-    auto foundIt = _catalog.find(uuid);
-    if (foundIt != _catalog.end()) {
-        boost::optional<NamespaceString> ns = foundIt->second->ns();
+    if (const auto* coll = _catalog.find(uuid)) {
+        boost::optional<NamespaceString> ns = (*coll)->ns();
         invariant(!ns.get().isEmpty());
-        return _collections.find(ns.get())->second->isCommitted() ? ns : boost::none;
+        return (*_collections.find(ns.get()))->isCommitted() ? ns : boost::none;
     }
 
     // Only in the case that the catalog is closed and a UUID is currently unknown, resolve it
@@ -821,10 +821,9 @@ boost::optional<UUID> CollectionCatalog::lookupUUIDByNSS(OperationContext* opCtx
         return boost::none;
     }
 
-    auto it = _collections.find(nss);
-    if (it != _collections.end()) {
-        const boost::optional<UUID>& uuid = it->second->uuid();
-        return it->second->isCommitted() ? uuid : boost::none;
+    if (const auto* coll = _collections.find(nss)) {
+        const boost::optional<UUID>& uuid = (*coll)->uuid();
+        return (*coll)->isCommitted() ? uuid : boost::none;
     }
     return boost::none;
 }
@@ -955,7 +954,7 @@ void CollectionCatalog::registerCollection(OperationContext* opCtx,
                 str::stream() << "View already exists. NS: " << ns,
                 !it->second.contains(ns));
     }
-    if (_collections.find(ns) != _collections.end()) {
+    if (_collections.contains(ns)) {
         auto& uncommittedCatalogUpdates = UncommittedCatalogUpdates::get(opCtx);
         auto [found, uncommittedPtr] = uncommittedCatalogUpdates.lookup(ns);
         // If we have an uncommitted drop of this collection we can defer the creation, the register
@@ -983,12 +982,12 @@ void CollectionCatalog::registerCollection(OperationContext* opCtx,
     auto dbIdPair = std::make_pair(dbName, uuid);
 
     // Make sure no entry related to this uuid.
-    invariant(_catalog.find(uuid) == _catalog.end());
-    invariant(_orderedCollections.find(dbIdPair) == _orderedCollections.end());
+    invariant(!_catalog.contains(uuid));
+    invariant(!_orderedCollections.contains(dbIdPair));
 
-    _catalog[uuid] = coll;
-    _collections[ns] = coll;
-    _orderedCollections[dbIdPair] = coll;
+    _catalog = _catalog.set(uuid, coll);
+    _collections = _collections.set(ns, coll);
+    _orderedCollections = _orderedCollections.set(dbIdPair, coll);
 
     if (!ns.isOnInternalDb() && !ns.isSystem()) {
         _stats.userCollections += 1;
@@ -1010,9 +1009,9 @@ void CollectionCatalog::registerCollection(OperationContext* opCtx,
 
 std::shared_ptr<Collection> CollectionCatalog::deregisterCollection(OperationContext* opCtx,
                                                                     const UUID& uuid) {
-    invariant(_catalog.find(uuid) != _catalog.end());
+    invariant(_catalog.contains(uuid));
 
-    auto coll = std::move(_catalog[uuid]);
+    auto coll = *_catalog.find(uuid);
     auto ns = coll->ns();
     auto dbName = ns.db().toString();
     auto dbIdPair = std::make_pair(dbName, uuid);
@@ -1020,12 +1019,12 @@ std::shared_ptr<Collection> CollectionCatalog::deregisterCollection(OperationCon
     LOGV2_DEBUG(20281, 1, "Deregistering collection", logAttrs(ns), "uuid"_attr = uuid);
 
     // Make sure collection object exists.
-    invariant(_collections.find(ns) != _collections.end());
-    invariant(_orderedCollections.find(dbIdPair) != _orderedCollections.end());
+    invariant(_collections.contains(ns));
+    invariant(_orderedCollections.contains(dbIdPair));
 
-    _orderedCollections.erase(dbIdPair);
-    _collections.erase(ns);
-    _catalog.erase(uuid);
+    _orderedCollections = _orderedCollections.erase(dbIdPair);
+    _collections = _collections.erase(ns);
+    _catalog = _catalog.erase(uuid);
 
     if (!ns.isOnInternalDb() && !ns.isSystem()) {
         _stats.userCollections -= 1;
@@ -1048,24 +1047,20 @@ std::shared_ptr<Collection> CollectionCatalog::deregisterCollection(OperationCon
 
 void CollectionCatalog::deregisterAllCollectionsAndViews() {
     LOGV2(20282, "Deregistering all the collections");
-    for (auto& entry : _catalog) {
+    for (const auto& entry : _catalog) {
         auto uuid = entry.first;
         auto ns = entry.second->ns();
-        auto dbName = ns.db().toString();
-        auto dbIdPair = std::make_pair(dbName, uuid);
 
         LOGV2_DEBUG(20283, 1, "Deregistering collection", logAttrs(ns), "uuid"_attr = uuid);
-
-        entry.second.reset();
     }
 
-    _collections.clear();
-    _orderedCollections.clear();
-    _catalog.clear();
+    _collections = {};
+    _orderedCollections = {};
+    _catalog = {};
     _views.clear();
     _stats = {};
 
-    _resourceInformation.clear();
+    _resourceInformation = {};
 }
 
 void CollectionCatalog::registerView(const NamespaceString& ns) {
@@ -1109,55 +1104,55 @@ CollectionCatalog::iterator CollectionCatalog::end(OperationContext* opCtx) cons
 boost::optional<std::string> CollectionCatalog::lookupResourceName(const ResourceId& rid) const {
     invariant(rid.getType() == RESOURCE_DATABASE || rid.getType() == RESOURCE_COLLECTION);
 
-    auto search = _resourceInformation.find(rid);
-    if (search == _resourceInformation.end()) {
+    const auto* namespaces = _resourceInformation.find(rid);
+    if (!namespaces) {
         return boost::none;
     }
 
-    const std::set<std::string>& namespaces = search->second;
-
     // When there are multiple namespaces mapped to the same ResourceId, return boost::none as the
     // ResourceId does not identify a single namespace.
-    if (namespaces.size() > 1) {
+    if (namespaces->size() > 1) {
         return boost::none;
     }
 
-    return *namespaces.begin();
+    return *namespaces->begin();
 }
 
 void CollectionCatalog::removeResource(const ResourceId& rid, const std::string& entry) {
     invariant(rid.getType() == RESOURCE_DATABASE || rid.getType() == RESOURCE_COLLECTION);
 
-    auto search = _resourceInformation.find(rid);
-    if (search == _resourceInformation.end()) {
+    const auto* search = _resourceInformation.find(rid);
+    if (!search || !search->count(entry)) {
         return;
     }
 
-    std::set<std::string>& namespaces = search->second;
-    namespaces.erase(entry);
-
     // Remove the map entry if this is the last namespace in the set for the ResourceId.
-    if (namespaces.size() == 0) {
-        _resourceInformation.erase(search);
+    if (search->size() == 1) {
+        _resourceInformation = _resourceInformation.erase(rid);
+        return;
     }
+
+    auto namespaces = *search;
+    namespaces.erase(entry);
+    _resourceInformation = _resourceInformation.set(rid, std::move(namespaces));
 }
 
 void CollectionCatalog::addResource(const ResourceId& rid, const std::string& entry) {
     invariant(rid.getType() == RESOURCE_DATABASE || rid.getType() == RESOURCE_COLLECTION);
 
-    auto search = _resourceInformation.find(rid);
-    if (search == _resourceInformation.end()) {
-        std::set<std::string> newSet = {entry};
-        _resourceInformation.insert(std::make_pair(rid, newSet));
+    const auto* search = _resourceInformation.find(rid);
+    if (!search) {
+        _resourceInformation = _resourceInformation.set(rid, std::set<std::string>{entry});
         return;
     }
 
-    std::set<std::string>& namespaces = search->second;
-    if (namespaces.count(entry) > 0) {
+    if (search->count(entry) > 0) {
         return;
     }
 
+    auto namespaces = *search;
     namespaces.insert(entry);
+    _resourceInformation = _resourceInformation.set(rid, std::move(namespaces));
 }
 
 CollectionCatalogStasher::CollectionCatalogStasher(OperationContext* opCtx)
@@ -37,6 +37,8 @@
 #include "mongo/db/profile_filter.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/immutable_map.h"
+#include "mongo/util/immutable_unordered_map.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -47,6 +49,10 @@ class Database;
 class CollectionCatalog {
     friend class iterator;
 
+    // Ordered by <dbName, collUUID> pair.
+    using OrderedCollectionMap =
+        immutable::map<std::pair<std::string, UUID>, std::shared_ptr<Collection>>;
+
 public:
     using CollectionInfoFn = std::function<bool(const CollectionPtr& collection)>;
 
@@ -70,8 +76,7 @@ public:
 
         iterator(OperationContext* opCtx, StringData dbName, const CollectionCatalog& catalog);
         iterator(OperationContext* opCtx,
-                 std::map<std::pair<std::string, UUID>, std::shared_ptr<Collection>>::const_iterator
-                     mapIter,
+                 OrderedCollectionMap::const_iterator mapIter,
                  const CollectionCatalog& catalog);
         value_type operator*();
         iterator operator++();
@@ -93,8 +98,7 @@ public:
         OperationContext* _opCtx;
         std::string _dbName;
         boost::optional<UUID> _uuid;
-        std::map<std::pair<std::string, UUID>, std::shared_ptr<Collection>>::const_iterator
-            _mapIter;
+        OrderedCollectionMap::const_iterator _mapIter;
         const CollectionCatalog* _catalog;
     };
 
@@ -424,15 +428,17 @@ private:
      */
     boost::optional<mongo::stdx::unordered_map<UUID, NamespaceString, UUID::Hash>> _shadowCatalog;
 
-    using CollectionCatalogMap = stdx::unordered_map<UUID, std::shared_ptr<Collection>, UUID::Hash>;
-    using OrderedCollectionMap =
-        std::map<std::pair<std::string, UUID>, std::shared_ptr<Collection>>;
-    using NamespaceCollectionMap =
-        stdx::unordered_map<NamespaceString, std::shared_ptr<Collection>>;
+    // The maps below which grow with the number of collections are persistent: the copy of the
+    // catalog made by every write shares their structure with the catalog it was copied from, and
+    // each modification of them is O(log n) rather than O(n).
+    using CollectionCatalogMap =
+        immutable::unordered_map<UUID, std::shared_ptr<Collection>, UUID::Hash>;
+    using NamespaceCollectionMap = immutable::
+        unordered_map<NamespaceString, std::shared_ptr<Collection>, absl::Hash<NamespaceString>>;
     using DatabaseProfileSettingsMap = StringMap<ProfileSettings>;
 
     CollectionCatalogMap _catalog;
-    OrderedCollectionMap _orderedCollections;  // Ordered by <dbName, collUUID> pair
+    OrderedCollectionMap _orderedCollections;
     NamespaceCollectionMap _collections;
 
     // Map of database names to a set of their views. Only databases with views are present.
@@ -451,7 +457,7 @@ private:
     uint64_t _epoch = 0;
 
     // Mapping from ResourceId to a set of strings that contains collection and database namespaces.
-    std::map<ResourceId, std::set<std::string>> _resourceInformation;
+    immutable::map<ResourceId, std::set<std::string>> _resourceInformation;
 
     /**
      * Contains non-default database profile settings. New collections, current collections and
@@ -117,7 +117,47 @@ void BM_CollectionCatalogWriteBatchedWithGlobalExclusiveLock(benchmark::State& s
     }
 }
 
+void BM_CollectionCatalogCreateDropCollection(benchmark::State& state) {
+    auto serviceContext = setupServiceContext();
+    ThreadClient threadClient(serviceContext);
+    ServiceContext::UniqueOperationContext opCtx = threadClient->makeOperationContext();
+
+    createCollections(opCtx.get(), state.range(0));
+
+    const TenantNamespace tenantNs(boost::none,
+                                   NamespaceString("collection_catalog_bm", "created_and_dropped"));
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        const auto uuid = UUID::gen();
+        CollectionCatalog::write(opCtx.get(), [&](CollectionCatalog& catalog) {
+            catalog.registerCollection(
+                opCtx.get(), uuid, std::make_shared<CollectionMock>(tenantNs));
+        });
+        CollectionCatalog::write(opCtx.get(), [&](CollectionCatalog& catalog) {
+            catalog.deregisterCollection(opCtx.get(), uuid);
+        });
+    }
+}
+
+void BM_CollectionCatalogLookupCollectionByNamespace(benchmark::State& state) {
+    auto serviceContext = setupServiceContext();
+    ThreadClient threadClient(serviceContext);
+    ServiceContext::UniqueOperationContext opCtx = threadClient->makeOperationContext();
+
+    createCollections(opCtx.get(), state.range(0));
+
+    const NamespaceString nss("collection_catalog_bm", std::to_string(state.range(0) / 2));
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        auto coll =
+            CollectionCatalog::get(opCtx.get())->lookupCollectionByNamespace(opCtx.get(), nss);
+        invariant(coll);
+    }
+}
+
 BENCHMARK(BM_CollectionCatalogWrite)->Ranges({{{1}, {100'000}}});
 BENCHMARK(BM_CollectionCatalogWriteBatchedWithGlobalExclusiveLock)->Ranges({{{1}, {100'000}}});
+BENCHMARK(BM_CollectionCatalogCreateDropCollection)->Ranges({{{1}, {500'000}}});
+BENCHMARK(BM_CollectionCatalogLookupCollectionByNamespace)->Ranges({{{1}, {500'000}}});
 
 }  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/auth/security_token.h"
+#include "mongo/db/client.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/catalog/document_validation.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/locker_noop.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/index/index_access_method.h"
@@ -76,6 +78,7 @@
 #include "mongo/db/storage/durable_catalog.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/timeseries/timeseries_constants.h"
 #include "mongo/db/timeseries/timeseries_index_schema_conversion_functions.h"
@@ -87,6 +90,8 @@
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/object_check.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -120,6 +125,22 @@ MONGO_FAIL_POINT_DEFINE(corruptDocumentOnInsert);
 
 MONGO_FAIL_POINT_DEFINE(skipCappedDeletes);
 
+// Index catalogs whose initialization was deferred, later instantiated on first access, and
+// released after being idle.
+Counter64 indexCatalogsDeferred;
+Counter64 indexCatalogsInstantiated;
+Counter64 indexCatalogsReleased;
+ServerStatusMetricField<Counter64> displayIndexCatalogsDeferred("catalog.indexCatalogs.deferred",
+                                                                &indexCatalogsDeferred);
+ServerStatusMetricField<Counter64> displayIndexCatalogsInstantiated(
+    "catalog.indexCatalogs.instantiated", &indexCatalogsInstantiated);
+ServerStatusMetricField<Counter64> displayIndexCatalogsReleased("catalog.indexCatalogs.released",
+                                                                &indexCatalogsReleased);
+
+// The collection whose deferred index catalog is being instantiated by this thread. Instantiating
+// the index catalog accesses it through the collection, which must not instantiate it again.
+thread_local const Collection* instantiatingIndexCatalogOf = nullptr;
+
 /**
  * Checks the 'failCollectionInserts' fail point at the beginning of an insert operation to see if
  * the insert should fail. Returns Status::OK if The function should proceed with the insertion.
@@ -461,6 +482,11 @@ std::shared_ptr<Collection> CollectionImpl::FactoryImpl::make(
 }
 
 std::shared_ptr<Collection> CollectionImpl::clone() const {
+    // The clone copies the index catalog, so it must be instantiated first. This is not an access
+    // which keeps the index catalog from being idle.
+    if (_lazyIndexCatalog) {
+        _instantiateLazyIndexCatalog();
+    }
     auto cloned = std::make_shared<CollectionImpl>(*this);
     cloned->_shared->instanceCreated(cloned.get());
     // We are per definition committed if we get cloned
@@ -473,6 +499,16 @@ SharedCollectionDecorations* CollectionImpl::getSharedDecorations() const {
 }
 
 void CollectionImpl::init(OperationContext* opCtx) {
+    _init(opCtx, false /* deferIndexCatalog */);
+}
+
+void CollectionImpl::initWithDeferredIndexCatalog(OperationContext* opCtx) {
+    // Internal collections are accessed shortly after startup regardless, so only the index
+    // catalogs of user collections are worth deferring.
+    _init(opCtx, !ns().isOnInternalDb());
+}
+
+void CollectionImpl::_init(OperationContext* opCtx, bool deferIndexCatalog) {
     _metadata = DurableCatalog::get(opCtx)->getMetaData(opCtx, getCatalogId());
     const auto& collectionOptions = _metadata->options;
 
@@ -525,10 +561,121 @@ void CollectionImpl::init(OperationContext* opCtx) {
         }
     }
 
-    getIndexCatalog()->init(opCtx, this).transitional_ignore();
+    if (deferIndexCatalog) {
+        // The TTL monitor must learn about the TTL indexes of the collection without waiting for
+        // its index catalog to be accessed.
+        IndexCatalogImpl::registerTTLIndexes(opCtx, this);
+        _lazyIndexCatalog = std::make_shared<LazyIndexCatalog>();
+        indexCatalogsDeferred.increment();
+    } else {
+        getIndexCatalog()->init(opCtx, this, true /* registerTTLIndexes */).transitional_ignore();
+    }
     _initialized = true;
 }
 
+void CollectionImpl::_useLazyIndexCatalog() const {
+    auto& lazy = *_lazyIndexCatalog;
+    auto nowMillis = getGlobalServiceContext()->getFastClockSource()->now().toMillisSinceEpoch();
+    if (lazy.lastUsedMillis.loadRelaxed() != nowMillis) {
+        lazy.lastUsedMillis.store(nowMillis);
+    }
+
+    _instantiateLazyIndexCatalog();
+}
+
+void CollectionImpl::_instantiateLazyIndexCatalog() const {
+    auto& lazy = *_lazyIndexCatalog;
+    if (lazy.instantiated.load() || instantiatingIndexCatalogOf == this) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(lazy.mutex);
+    if (lazy.instantiated.load()) {
+        return;
+    }
+
+    Timer timer;
+    auto serviceContext = getGlobalServiceContext();
+    auto self = const_cast<CollectionImpl*>(this);
+    {
+        // The index catalog may be first accessed by an operation in any state, so its tables are
+        // opened on behalf of a separate client, outside of the locks and storage transaction of
+        // that operation. The catalog concurrency rules are upheld by the operation, which holds
+        // at least an intent lock on this collection to access it.
+        auto client = serviceContext->makeClient("LazyIndexCatalog");
+        AlternativeClientRegion acr(client);
+        auto opCtx = cc().makeOperationContext();
+        {
+            stdx::lock_guard<Client> clientLock(cc());
+            opCtx->swapLockState(std::make_unique<LockerNoop>(), clientLock);
+        }
+        opCtx->setRecoveryUnit(
+            std::unique_ptr<RecoveryUnit>(serviceContext->getStorageEngine()->newRecoveryUnit()),
+            WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+
+        instantiatingIndexCatalogOf = this;
+        ON_BLOCK_EXIT([] { instantiatingIndexCatalogOf = nullptr; });
+
+        self->_indexCatalog->init(opCtx.get(), self, false /* registerTTLIndexes */)
+            .transitional_ignore();
+
+        // Initialization makes the indexes visible from the recovery timestamp on, which is too
+        // early for the indexes of a released index catalog that were built since.
+        if (!lazy.indexMinVisibleSnapshots.empty()) {
+            auto it = self->_indexCatalog->getIndexIterator(opCtx.get(), true);
+            while (it->more()) {
+                auto desc = it->next()->descriptor();
+                auto minVisible = lazy.indexMinVisibleSnapshots.find(desc->indexName());
+                if (minVisible != lazy.indexMinVisibleSnapshots.end()) {
+                    desc->getEntry()->setMinimumVisibleSnapshot(minVisible->second);
+                }
+            }
+        }
+    }
+
+    lazy.instantiated.store(true);
+    indexCatalogsInstantiated.increment();
+    LOGV2_DEBUG(6440800,
+                1,
+                "Instantiated deferred index catalog",
+                logAttrs(_tenantNs),
+                "uuid"_attr = _uuid,
+                "duration"_attr = duration_cast<Milliseconds>(timer.elapsed()));
+}
+
+bool CollectionImpl::isIndexCatalogIdle(Date_t idleSince) const {
+    return _lazyIndexCatalog && _lazyIndexCatalog->instantiated.load() &&
+        _lazyIndexCatalog->lastUsedMillis.load() < idleSince.toMillisSinceEpoch();
+}
+
+bool CollectionImpl::releaseIdleIndexCatalog(OperationContext* opCtx, Date_t idleSince) {
+    invariant(opCtx->lockState()->isCollectionLockedForMode(ns(), MODE_X));
+    if (!isIndexCatalogIdle(idleSince) || _indexCatalog->haveAnyIndexesInProgress()) {
+        return false;
+    }
+
+    // Instances of this collection that are still in use by readers keep the index catalog they
+    // share. This instance starts over from a new, not yet instantiated, index catalog.
+    auto released = std::make_shared<LazyIndexCatalog>();
+    auto it = _indexCatalog->getIndexIterator(opCtx, true);
+    while (it->more()) {
+        auto entry = it->next();
+        if (auto minVisible = entry->getMinimumVisibleSnapshot()) {
+            released->indexMinVisibleSnapshots[entry->descriptor()->indexName()] = *minVisible;
+        }
+    }
+
+    _indexCatalog = std::make_unique<IndexCatalogImpl>();
+    _lazyIndexCatalog = std::move(released);
+    indexCatalogsReleased.increment();
+    LOGV2_DEBUG(6440801,
+                1,
+                "Released idle index catalog",
+                logAttrs(_tenantNs),
+                "uuid"_attr = _uuid);
+    return true;
+}
+
 bool CollectionImpl::isInitialized() const {
     return _initialized;
 }
@@ -720,7 +867,7 @@ Status CollectionImpl::insertDocumentsForOplog(OperationContext* opCtx,
     // Since this is only for the OpLog, we can assume these for simplicity.
     invariant(_validator.isOK());
     invariant(_validator.filter.getValue() == nullptr);
-    invariant(!_indexCatalog->haveAnyIndexes());
+    invariant(!_getIndexCatalog()->haveAnyIndexes());
 
     Status status = _shared->_recordStore->insertRecords(opCtx, records, timestamps);
     if (!status.isOK())
@@ -748,7 +895,7 @@ Status CollectionImpl::insertDocuments(OperationContext* opCtx,
     }
 
     // Should really be done in the collection object at creation and updated on index create.
-    const bool hasIdIndex = _indexCatalog->findIdIndex(opCtx);
+    const bool hasIdIndex = _getIndexCatalog()->findIdIndex(opCtx);
 
     for (auto it = begin; it != end; it++) {
         if (hasIdIndex && it->doc["_id"].eoo()) {
@@ -880,7 +1027,7 @@ Status CollectionImpl::_insertDocuments(OperationContext* opCtx,
     dassert(opCtx->lockState()->isCollectionLockedForMode(ns(), MODE_IX));
 
     const size_t count = std::distance(begin, end);
-    if (isCapped() && _indexCatalog->haveAnyIndexes() && count > 1) {
+    if (isCapped() && _getIndexCatalog()->haveAnyIndexes() && count > 1) {
         // We require that inserts to indexed capped collections be done one-at-a-time to avoid the
         // possibility that a later document causes an earlier document to be deleted before it can
         // be indexed.
@@ -947,7 +1094,7 @@ Status CollectionImpl::_insertDocuments(OperationContext* opCtx,
     }
 
     int64_t keysInserted = 0;
-    status = _indexCatalog->indexRecords(
+    status = _getIndexCatalog()->indexRecords(
         opCtx, {this, CollectionPtr::NoYieldTag{}}, bsonRecords, &keysInserted);
     if (!status.isOK()) {
         return status;
@@ -1095,12 +1242,12 @@ void CollectionImpl::_cappedDeleteAsNeeded(OperationContext* opCtx,
         }
 
         int64_t unusedKeysDeleted = 0;
-        _indexCatalog->unindexRecord(opCtx,
-                                     CollectionPtr(this, CollectionPtr::NoYieldTag{}),
-                                     doc,
-                                     record->id,
-                                     /*logIfError=*/false,
-                                     &unusedKeysDeleted);
+        _getIndexCatalog()->unindexRecord(opCtx,
+                                          CollectionPtr(this, CollectionPtr::NoYieldTag{}),
+                                          doc,
+                                          record->id,
+                                          /*logIfError=*/false,
+                                          &unusedKeysDeleted);
 
         // We're about to delete the record our cursor is positioned on, so advance the cursor.
         RecordId toDelete = record->id;
@@ -1219,12 +1366,12 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
         deletedDoc.emplace(doc.value().getOwned());
     }
     int64_t keysDeleted = 0;
-    _indexCatalog->unindexRecord(opCtx,
-                                 CollectionPtr(this, CollectionPtr::NoYieldTag{}),
-                                 doc.value(),
-                                 loc,
-                                 noWarn,
-                                 &keysDeleted);
+    _getIndexCatalog()->unindexRecord(opCtx,
+                                      CollectionPtr(this, CollectionPtr::NoYieldTag{}),
+                                      doc.value(),
+                                      loc,
+                                      noWarn,
+                                      &keysDeleted);
     _shared->_recordStore->deleteRecord(opCtx, loc);
     if (deletedDoc) {
         deleteArgs.deletedDoc = &(deletedDoc.get());
@@ -1344,13 +1491,13 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
         int64_t keysInserted = 0;
         int64_t keysDeleted = 0;
 
-        uassertStatusOK(_indexCatalog->updateRecord(opCtx,
-                                                    {this, CollectionPtr::NoYieldTag{}},
-                                                    *args->preImageDoc,
-                                                    newDoc,
-                                                    oldLocation,
-                                                    &keysInserted,
-                                                    &keysDeleted));
+        uassertStatusOK(_getIndexCatalog()->updateRecord(opCtx,
+                                                         {this, CollectionPtr::NoYieldTag{}},
+                                                         *args->preImageDoc,
+                                                         newDoc,
+                                                         oldLocation,
+                                                         &keysInserted,
+                                                         &keysDeleted));
 
         if (opDebug) {
             opDebug->additiveMetrics.incrementKeysInserted(keysInserted);
@@ -1643,13 +1790,13 @@ uint64_t CollectionImpl::getIndexFreeStorageBytes(OperationContext* const opCtx)
  */
 Status CollectionImpl::truncate(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isCollectionLockedForMode(ns(), MODE_X));
-    invariant(_indexCatalog->numIndexesInProgress(opCtx) == 0);
+    invariant(_getIndexCatalog()->numIndexesInProgress(opCtx) == 0);
 
     // 1) store index specs
     std::vector<BSONObj> indexSpecs;
     {
         std::unique_ptr<IndexCatalog::IndexIterator> ii =
-            _indexCatalog->getIndexIterator(opCtx, false);
+            _getIndexCatalog()->getIndexIterator(opCtx, false);
         while (ii->more()) {
             const IndexDescriptor* idx = ii->next()->descriptor();
             indexSpecs.push_back(idx->infoObj().getOwned());
@@ -1657,7 +1804,7 @@ Status CollectionImpl::truncate(OperationContext* opCtx) {
     }
 
     // 2) drop indexes
-    _indexCatalog->dropAllIndexes(opCtx, this, true);
+    _getIndexCatalog()->dropAllIndexes(opCtx, this, true);
 
     // 3) truncate record store
     auto status = _shared->_recordStore->truncate(opCtx);
@@ -1666,8 +1813,9 @@ Status CollectionImpl::truncate(OperationContext* opCtx) {
 
     // 4) re-create indexes
     for (size_t i = 0; i < indexSpecs.size(); i++) {
-        status =
-            _indexCatalog->createIndexOnEmptyCollection(opCtx, this, indexSpecs[i]).getStatus();
+        status = _getIndexCatalog()
+                     ->createIndexOnEmptyCollection(opCtx, this, indexSpecs[i])
+                     .getStatus();
         if (!status.isOK())
             return status;
     }
@@ -1680,7 +1828,7 @@ void CollectionImpl::cappedTruncateAfter(OperationContext* opCtx,
                                          bool inclusive) const {
     dassert(opCtx->lockState()->isCollectionLockedForMode(ns(), MODE_X));
     invariant(isCapped());
-    invariant(_indexCatalog->numIndexesInProgress(opCtx) == 0);
+    invariant(_getIndexCatalog()->numIndexesInProgress(opCtx) == 0);
 
     _shared->_recordStore->cappedTruncateAfter(opCtx, end, inclusive);
 }
@@ -1903,7 +2051,7 @@ void CollectionImpl::indexBuildSuccess(OperationContext* opCtx, IndexCatalogEntr
         md.indexes[offset].buildUUID = boost::none;
     });
 
-    _indexCatalog->indexBuildSuccess(opCtx, this, index);
+    _getIndexCatalog()->indexBuildSuccess(opCtx, this, index);
 }
 
 void CollectionImpl::establishOplogCollectionForLogging(OperationContext* opCtx) {
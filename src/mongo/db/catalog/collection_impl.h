@@ -33,6 +33,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -78,6 +79,9 @@ public:
     SharedCollectionDecorations* getSharedDecorations() const final;
 
     void init(OperationContext* opCtx) final;
+    void initWithDeferredIndexCatalog(OperationContext* opCtx) final;
+    bool isIndexCatalogIdle(Date_t idleSince) const final;
+    bool releaseIdleIndexCatalog(OperationContext* opCtx, Date_t idleSince) final;
     bool isInitialized() const final;
     bool isCommitted() const final;
     void setCommitted(bool val) final;
@@ -101,10 +105,12 @@ public:
     }
 
     const IndexCatalog* getIndexCatalog() const final {
+        _ensureIndexCatalog();
         return _indexCatalog.get();
     }
 
     IndexCatalog* getIndexCatalog() final {
+        _ensureIndexCatalog();
         return _indexCatalog.get();
     }
 
@@ -486,6 +492,29 @@ public:
                          std::shared_ptr<BSONCollectionCatalogEntry::MetaData> md) final;
 
 private:
+    void _init(OperationContext* opCtx, bool deferIndexCatalog);
+
+    /**
+     * Instantiates the index catalog if its initialization was deferred and it has not been
+     * instantiated yet, and records the access for the idle index catalog release.
+     */
+    void _ensureIndexCatalog() const {
+        if (_lazyIndexCatalog) {
+            _useLazyIndexCatalog();
+        }
+    }
+    void _useLazyIndexCatalog() const;
+    void _instantiateLazyIndexCatalog() const;
+
+    /**
+     * Returns the index catalog for maintaining the indexes of this collection, which may be done
+     * through a const instance.
+     */
+    IndexCatalog* _getIndexCatalog() const {
+        _ensureIndexCatalog();
+        return _indexCatalog.get();
+    }
+
     Status _insertDocuments(OperationContext* opCtx,
                             std::vector<InsertStatement>::const_iterator begin,
                             std::vector<InsertStatement>::const_iterator end,
@@ -583,6 +612,24 @@ private:
         RecordId _cappedFirstRecord;
     };
 
+    /**
+     * State of an index catalog whose initialization is deferred until first access. Shared
+     * between the CollectionImpl clones that have the same index catalog instance, so that
+     * instantiating it through any of them makes it visible to all.
+     */
+    struct LazyIndexCatalog {
+        // Serializes the instantiation of the index catalog.
+        Mutex mutex = MONGO_MAKE_LATCH("CollectionImpl::LazyIndexCatalog::mutex");
+        AtomicWord<bool> instantiated{false};
+
+        // Time of the last access to the index catalog, in milliseconds since the epoch.
+        AtomicWord<long long> lastUsedMillis{0};
+
+        // Minimum visible snapshots of the indexes of a released index catalog, re-applied when
+        // the index catalog is instantiated again.
+        StringMap<Timestamp> indexMinVisibleSnapshots;
+    };
+
     TenantNamespace _tenantNs;
     RecordId _catalogId;
     UUID _uuid;
@@ -595,6 +642,9 @@ private:
 
     clonable_ptr<IndexCatalog> _indexCatalog;
 
+    // Non-null if the initialization of '_indexCatalog' was deferred.
+    std::shared_ptr<LazyIndexCatalog> _lazyIndexCatalog;
+
     // The validator is using shared state internally. Collections share validator until a new
     // validator is set in setValidator which sets a new instance.
     Validator _validator;
@@ -70,10 +70,12 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage/durable_catalog.h"
+#include "mongo/db/storage/parallel_catalog_load.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_engine_init.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_util.h"
 #include "mongo/db/system_index.h"
 #include "mongo/db/views/view_catalog.h"
@@ -81,6 +83,7 @@
 #include "mongo/platform/random.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -173,20 +176,47 @@ Status DatabaseImpl::init(OperationContext* const opCtx) {
         return status;
     }
 
+    // While the global lock is held exclusively the collections are modified in place, so their
+    // index catalogs can be initialized concurrently once every collection has been looked up.
+    const bool inplace = opCtx->lockState()->isW();
+    std::vector<Collection*> uninitializedCollections;
     auto catalog = CollectionCatalog::get(opCtx);
     for (const auto& uuid : catalog->getAllCollectionUUIDsFromDb(_name)) {
         CollectionWriter collection(
             opCtx,
             uuid,
-            opCtx->lockState()->isW() ? CollectionCatalog::LifetimeMode::kInplace
-                                      : CollectionCatalog::LifetimeMode::kManagedInWriteUnitOfWork);
+            inplace ? CollectionCatalog::LifetimeMode::kInplace
+                    : CollectionCatalog::LifetimeMode::kManagedInWriteUnitOfWork);
         invariant(collection);
         // If this is called from the repair path, the collection is already initialized.
-        if (!collection->isInitialized()) {
+        if (collection->isInitialized()) {
+            continue;
+        }
+        if (inplace) {
+            uninitializedCollections.push_back(collection.getWritableCollection());
+        } else {
             collection.getWritableCollection()->init(opCtx);
         }
     }
 
+    // On startup, the index catalogs may be left to be instantiated on first access instead.
+    const bool deferIndexCatalogs = gDeferIndexCatalogInitialization && !storageGlobalParams.repair;
+    Timer timer;
+    auto storageEngine = opCtx->getServiceContext()->getStorageEngine();
+    catalog_load::forEachInParallel(
+        opCtx,
+        uninitializedCollections.size(),
+        [storageEngine] { return std::unique_ptr<RecoveryUnit>(storageEngine->newRecoveryUnit()); },
+        [&](OperationContext* workerOpCtx, size_t i) {
+            if (deferIndexCatalogs) {
+                uninitializedCollections[i]->initWithDeferredIndexCatalog(workerOpCtx);
+            } else {
+                uninitializedCollections[i]->init(workerOpCtx);
+            }
+        });
+    catalog_load::CatalogLoadStats::get(opCtx->getServiceContext())
+        .add(catalog_load::CatalogLoadStats::Phase::kInitIndexCatalogs, timer.elapsed());
+
     // When in repair mode, record stores are not loaded. Thus the ViewsCatalog cannot be reloaded.
     if (!storageGlobalParams.repair) {
         // At construction time of the viewCatalog, the CollectionCatalog map wasn't initialized
@@ -218,8 +218,11 @@ public:
 
     virtual std::unique_ptr<IndexCatalog> clone() const = 0;
 
-    // Must be called before used.
-    virtual Status init(OperationContext* opCtx, Collection* collection) = 0;
+    // Must be called before used. 'registerTTLIndexes' may only be false if the TTL indexes of
+    // 'collection' have already been registered with the TTLCollectionCache.
+    virtual Status init(OperationContext* opCtx,
+                        Collection* collection,
+                        bool registerTTLIndexes) = 0;
 
     // ---- accessors -----
 
@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("index_catalog_bm.coll");
+
+/**
+ * Sets up a mongod service context backed by WiredTiger, with a collection indexed on {a: 1} and
+ * {b: 1} in addition to _id.
+ */
+class IndexCatalogBenchmarkFixture : public CatalogTestFixture {
+public:
+    IndexCatalogBenchmarkFixture() : CatalogTestFixture("wiredTiger") {
+        setUp();
+        ASSERT_OK(storageInterface()->createCollection(operationContext(), kNss, {}));
+        ASSERT_OK(storageInterface()->createIndexesOnEmptyCollection(
+            operationContext(),
+            kNss,
+            {BSON("v" << 2 << "name"
+                      << "a_1"
+                      << "key" << BSON("a" << 1)),
+             BSON("v" << 2 << "name"
+                      << "b_1"
+                      << "key" << BSON("b" << 1))}));
+    }
+
+    ~IndexCatalogBenchmarkFixture() {
+        tearDown();
+    }
+
+private:
+    void _doTest() final {}
+};
+
+/**
+ * Indexes batches of 'state.range(0)' inserted documents, as inserting them into the collection
+ * does. With 'distinctTimestamps', each record of a batch has its own commit timestamp, as the
+ * inserts of a replica set primary have, rather than the whole batch sharing one.
+ */
+void BM_IndexRecords(benchmark::State& state, bool distinctTimestamps) {
+    IndexCatalogBenchmarkFixture fixture;
+    auto opCtx = fixture.operationContext();
+    const size_t batchSize = state.range(0);
+
+    // The indexed values are random, so the keys of a batch are not in the order of its records.
+    std::mt19937 gen(1234);
+    int64_t nextId = 1;
+    unsigned long long nextTimestamp = 1;
+    std::vector<BSONObj> docs;
+    std::vector<BsonRecord> records;
+    docs.reserve(batchSize);
+    for (auto _ : state) {
+        state.PauseTiming();
+        docs.clear();
+        records.clear();
+        for (size_t i = 0; i < batchSize; ++i) {
+            docs.push_back(BSON("_id" << nextId << "a" << static_cast<int>(gen()) << "b"
+                                      << static_cast<int>(gen())));
+            records.push_back({RecordId(nextId++), Timestamp(nextTimestamp), &docs.back()});
+            if (distinctTimestamps) {
+                ++nextTimestamp;
+            }
+        }
+        if (!distinctTimestamps) {
+            ++nextTimestamp;
+        }
+        state.ResumeTiming();
+
+        AutoGetCollection collection(opCtx, kNss, MODE_IX);
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(collection->getIndexCatalog()->indexRecords(
+            opCtx, *collection, records, nullptr /* keysInsertedOut */));
+        wuow.commit();
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+BENCHMARK_CAPTURE(BM_IndexRecords, SharedTimestamp, false)->Arg(1)->Arg(16)->Arg(64);
+BENCHMARK_CAPTURE(BM_IndexRecords, DistinctTimestamps, true)->Arg(1)->Arg(16)->Arg(64);
+
+}  // namespace
+}  // namespace mongo
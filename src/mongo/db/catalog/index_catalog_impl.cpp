@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -58,6 +59,7 @@
 #include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/delete.h"
@@ -179,7 +181,32 @@ std::unique_ptr<IndexCatalog> IndexCatalogImpl::clone() const {
     return std::make_unique<IndexCatalogImpl>(*this);
 }
 
-Status IndexCatalogImpl::init(OperationContext* opCtx, Collection* collection) {
+void IndexCatalogImpl::registerTTLIndexes(OperationContext* opCtx, const Collection* collection) {
+    // TTL indexes are not compatible with capped collections.
+    // Note that TTL deletion is supported on capped clustered collections via bounded
+    // collection scan, which does not use an index.
+    if (collection->isCapped()) {
+        return;
+    }
+
+    vector<string> indexNames;
+    collection->getAllIndexes(&indexNames);
+    for (const auto& indexName : indexNames) {
+        if (collection->getIndexSpec(indexName).hasField(
+                IndexDescriptor::kExpireAfterSecondsFieldName)) {
+            TTLCollectionCache::get(opCtx->getServiceContext())
+                .registerTTLInfo(collection->uuid(), indexName);
+        }
+    }
+}
+
+Status IndexCatalogImpl::init(OperationContext* opCtx,
+                              Collection* collection,
+                              bool registerTTLIndexes) {
+    if (registerTTLIndexes) {
+        IndexCatalogImpl::registerTTLIndexes(opCtx, collection);
+    }
+
     vector<string> indexNames;
     collection->getAllIndexes(&indexNames);
     const bool replSetMemberInStandaloneMode =
@@ -198,15 +225,6 @@ Status IndexCatalogImpl::init(OperationContext* opCtx, Collection* collection) {
 
         auto descriptor = std::make_unique<IndexDescriptor>(_getAccessMethodName(keyPattern), spec);
 
-        // TTL indexes are not compatible with capped collections.
-        // Note that TTL deletion is supported on capped clustered collections via bounded
-        // collection scan, which does not use an index.
-        if (spec.hasField(IndexDescriptor::kExpireAfterSecondsFieldName) &&
-            !collection->isCapped()) {
-            TTLCollectionCache::get(opCtx->getServiceContext())
-                .registerTTLInfo(collection->uuid(), indexName);
-        }
-
         bool ready = collection->isIndexReady(indexName);
         if (!ready) {
             auto buildUUID = collection->getIndexBuildUUID(indexName);
@@ -1531,6 +1549,11 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, coll->ns(), index->descriptor(), &options);
 
+    if (!index->isHybridBuilding()) {
+        return _indexBatchedRecords(
+            opCtx, coll, index, bsonRecords, pooledBuilder, options, keysInsertedOut);
+    }
+
     for (auto bsonRecord : bsonRecords) {
         invariant(bsonRecord.id != RecordId());
 
@@ -1573,6 +1596,140 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status IndexCatalogImpl::_indexBatchedRecords(OperationContext* opCtx,
+                                               const CollectionPtr& coll,
+                                               const IndexCatalogEntry* index,
+                                               const std::vector<BsonRecord>& bsonRecords,
+                                               SharedBufferFragmentBuilder& pooledBuilder,
+                                               const InsertDeleteOptions& options,
+                                               int64_t* keysInsertedOut) const {
+    auto accessMethod = index->accessMethod();
+    auto& executionCtx = StorageExecutionContext::get(opCtx);
+
+    // The keys of every record, each with the position of its record in 'bsonRecords'.
+    std::vector<std::pair<KeyString::Value, size_t>> batchKeys;
+    KeyStringSet batchMultikeyMetadataKeys;
+    MultikeyPaths batchMultikeyPaths;
+    boost::optional<size_t> firstMultikeyRecord;
+
+    for (size_t i = 0; i < bsonRecords.size(); ++i) {
+        const auto& bsonRecord = bsonRecords[i];
+        invariant(bsonRecord.id != RecordId());
+
+        auto keys = executionCtx.keys();
+        auto multikeyMetadataKeys = executionCtx.multikeyMetadataKeys();
+        auto multikeyPaths = executionCtx.multikeyPaths();
+
+        accessMethod->getKeys(opCtx,
+                              coll,
+                              pooledBuilder,
+                              *bsonRecord.docPtr,
+                              options.getKeysMode,
+                              IndexAccessMethod::GetKeysContext::kAddingKeys,
+                              keys.get(),
+                              multikeyMetadataKeys.get(),
+                              multikeyPaths.get(),
+                              bsonRecord.id);
+
+        // Whether the index becomes multikey depends on the keys of each document on its own, so
+        // it is decided here rather than from the keys of the whole batch.
+        if (accessMethod->shouldMarkIndexAsMultikey(
+                keys->size(), *multikeyMetadataKeys, *multikeyPaths)) {
+            if (!firstMultikeyRecord) {
+                firstMultikeyRecord = i;
+            }
+            batchMultikeyMetadataKeys.insert(multikeyMetadataKeys->begin(),
+                                             multikeyMetadataKeys->end());
+            if (batchMultikeyPaths.empty()) {
+                batchMultikeyPaths = *multikeyPaths;
+            } else if (!multikeyPaths->empty()) {
+                MultikeyPathTracker::mergeMultikeyPaths(&batchMultikeyPaths, *multikeyPaths);
+            }
+        }
+
+        for (auto&& key : *keys) {
+            batchKeys.emplace_back(key, i);
+        }
+    }
+
+    // Every key ends with the RecordId of its document, so the keys of different documents never
+    // compare equal. Inserting in index order keeps consecutive inserts on neighbouring pages of
+    // the index.
+    std::sort(batchKeys.begin(), batchKeys.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    // Each key is written at the commit timestamp of its record. On a replica set every record has
+    // its own oplog slot, so the timestamp changes between each run of keys which belong to records
+    // with the same timestamp. This is allowed since the timestamps are no older than the first
+    // one set in this storage transaction, which is that of the first record.
+    boost::optional<Timestamp> currentTs;
+    auto setTimestamp = [&](const Timestamp& ts) {
+        if (ts.isNull() || ts == currentTs) {
+            return Status::OK();
+        }
+        currentTs = ts;
+        return opCtx->recoveryUnit()->setTimestamp(ts);
+    };
+
+    int64_t numInserted = 0;
+    for (auto runBegin = batchKeys.begin(); runBegin != batchKeys.end();) {
+        const auto& bsonRecord = bsonRecords[runBegin->second];
+        auto runEnd = std::find_if(runBegin, batchKeys.end(), [&](const auto& key) {
+            return bsonRecords[key.second].ts != bsonRecord.ts;
+        });
+
+        Status status = setTimestamp(bsonRecord.ts);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        KeyStringSet::sequence_type runKeys;
+        runKeys.reserve(std::distance(runBegin, runEnd));
+        for (auto it = runBegin; it != runEnd; ++it) {
+            runKeys.push_back(std::move(it->first));
+        }
+        KeyStringSet sortedKeys;
+        sortedKeys.adopt_sequence(boost::container::ordered_unique_range, std::move(runKeys));
+
+        int64_t numRunInserted = 0;
+        status = accessMethod->insertKeys(
+            opCtx, coll, sortedKeys, bsonRecord.id, options, nullptr, &numRunInserted);
+        if (!status.isOK()) {
+            return status;
+        }
+        numInserted += numRunInserted;
+        runBegin = runEnd;
+    }
+
+    if (firstMultikeyRecord) {
+        // Marking the index multikey as of the first record which makes it multikey covers the
+        // later ones as well.
+        Status status = setTimestamp(bsonRecords[*firstMultikeyRecord].ts);
+        if (!status.isOK()) {
+            return status;
+        }
+        index->setMultikey(opCtx, coll, batchMultikeyMetadataKeys, batchMultikeyPaths);
+        // The multikey metadata keys are added while marking the index as multikey. Count them
+        // along with the data keys for completeness.
+        numInserted += batchMultikeyMetadataKeys.size();
+    }
+
+    // Leave the recovery unit at the timestamp of the last record, as indexing the records one at
+    // a time does.
+    if (!bsonRecords.empty()) {
+        Status status = setTimestamp(bsonRecords.back().ts);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    if (keysInsertedOut) {
+        *keysInsertedOut += numInserted;
+    }
+    return Status::OK();
+}
+
 Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
                                        const CollectionPtr& coll,
                                        const IndexCatalogEntry* index,
@@ -65,7 +65,12 @@ public:
     std::unique_ptr<IndexCatalog> clone() const override;
 
     // must be called before used
-    Status init(OperationContext* opCtx, Collection* collection) override;
+    Status init(OperationContext* opCtx, Collection* collection, bool registerTTLIndexes) override;
+
+    /**
+     * Registers the TTL indexes found in the metadata of 'collection' with the TTLCollectionCache.
+     */
+    static void registerTTLIndexes(OperationContext* opCtx, const Collection* collection);
 
     // ---- accessors -----
 
@@ -345,6 +350,19 @@ private:
                                  const std::vector<BsonRecord>& bsonRecords,
                                  int64_t* keysInsertedOut) const;
 
+    /**
+     * Generates the keys of 'bsonRecords' for 'index', sorts the keys of all the records together
+     * and inserts them into the index in key order, switching the timestamp of the recovery unit
+     * to that of each key's record. Not for use while the index is being built with a side table.
+     */
+    Status _indexBatchedRecords(OperationContext* opCtx,
+                                const CollectionPtr& coll,
+                                const IndexCatalogEntry* index,
+                                const std::vector<BsonRecord>& bsonRecords,
+                                SharedBufferFragmentBuilder& pooledBuilder,
+                                const InsertDeleteOptions& options,
+                                int64_t* keysInsertedOut) const;
+
     Status _indexRecords(OperationContext* opCtx,
                          const CollectionPtr& coll,
                          const IndexCatalogEntry* index,
@@ -0,0 +1,191 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/storage/durable_catalog.h"
+#include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("index_catalog_impl_test.coll");
+
+class IndexCatalogImplTest : public CatalogTestFixture {
+public:
+    IndexCatalogImplTest() : CatalogTestFixture("wiredTiger") {}
+
+    /**
+     * Returns every entry of the index 'indexName' visible to the snapshot of 'opCtx', in index
+     * order.
+     */
+    std::vector<IndexKeyEntry> readIndex(OperationContext* opCtx,
+                                         const CollectionPtr& collection,
+                                         StringData indexName) {
+        auto indexCatalog = collection->getIndexCatalog();
+        auto entry = indexCatalog->getEntry(indexCatalog->findIndexByName(opCtx, indexName));
+        auto sortedData = entry->accessMethod()->getSortedDataInterface();
+
+        std::vector<IndexKeyEntry> entries;
+        auto cursor = sortedData->newCursor(opCtx);
+        auto startKey =
+            IndexEntryComparison::makeKeyStringFromBSONKeyForSeek(BSON("" << MINKEY),
+                                                                  sortedData->getKeyStringVersion(),
+                                                                  sortedData->getOrdering(),
+                                                                  true /* isForward */,
+                                                                  true /* inclusive */);
+        for (auto indexEntry = cursor->seek(startKey); indexEntry; indexEntry = cursor->next()) {
+            entries.push_back(*indexEntry);
+        }
+        return entries;
+    }
+
+    /**
+     * Asserts that, as of 'ts', the index 'indexName' holds exactly 'expectedEntries' and is
+     * multikey in the durable catalog if and only if 'expectedMultikey' is set.
+     */
+    void assertIndexAtTimestamp(const Timestamp& ts,
+                                StringData indexName,
+                                const std::vector<IndexKeyEntry>& expectedEntries,
+                                bool expectedMultikey) {
+        auto opCtx = operationContext();
+        opCtx->recoveryUnit()->abandonSnapshot();
+        opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kProvided, ts);
+        ON_BLOCK_EXIT([&] {
+            opCtx->recoveryUnit()->abandonSnapshot();
+            opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kNoTimestamp);
+        });
+
+        AutoGetCollection collection(opCtx, kNss, MODE_IS);
+        auto entries = readIndex(opCtx, *collection, indexName);
+        ASSERT_EQ(expectedEntries.size(), entries.size())
+            << "index " << indexName << " at timestamp " << ts;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            ASSERT_EQ(expectedEntries[i], entries[i])
+                << "index " << indexName << " at timestamp " << ts;
+        }
+
+        MultikeyPaths multikeyPaths;
+        ASSERT_EQ(expectedMultikey,
+                  DurableCatalog::get(opCtx)->isIndexMultikey(
+                      opCtx, collection->getCatalogId(), indexName, &multikeyPaths))
+            << "index " << indexName << " at timestamp " << ts;
+        if (expectedMultikey) {
+            ASSERT(multikeyPaths == MultikeyPaths{{0U}})
+                << "index " << indexName << " at timestamp " << ts;
+        }
+    }
+};
+
+TEST_F(IndexCatalogImplTest, BatchedInsertWritesEachKeyAtItsRecordTimestamp) {
+    auto opCtx = operationContext();
+    ASSERT_OK(storageInterface()->createCollection(opCtx, kNss, {}));
+    ASSERT_OK(storageInterface()->createIndexesOnEmptyCollection(
+        opCtx,
+        kNss,
+        {BSON("v" << 2 << "name"
+                  << "a_1"
+                  << "key" << BSON("a" << 1) << "unique" << true),
+         BSON("v" << 2 << "name"
+                  << "b_1"
+                  << "key" << BSON("b" << 1))}));
+
+    // The values of 'a' decrease as the records are inserted, so the keys of the unique index are
+    // written in the reverse order of the records' timestamps. Records 2 and 4 make the index on
+    // 'b' multikey.
+    const std::vector<BSONObj> docs{BSON("_id" << 0 << "a" << 50 << "b" << 1),
+                                    BSON("_id" << 1 << "a" << 40 << "b" << 2),
+                                    BSON("_id" << 2 << "a" << 30 << "b" << BSON_ARRAY(3 << 4)),
+                                    BSON("_id" << 3 << "a" << 20 << "b" << 5),
+                                    BSON("_id" << 4 << "a" << 10 << "b" << BSON_ARRAY(6 << 7))};
+    const size_t kFirstMultikeyDoc = 2;
+    const auto timestampOf = [](size_t i) {
+        return Timestamp(10, i + 1);
+    };
+
+    std::vector<InsertStatement> inserts;
+    for (size_t i = 0; i < docs.size(); ++i) {
+        inserts.emplace_back(docs[i], timestampOf(i), 1LL /* term */);
+    }
+    std::vector<RecordId> recordIds;
+    {
+        AutoGetCollection collection(opCtx, kNss, MODE_IX);
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(collection->insertDocuments(
+            opCtx, inserts.begin(), inserts.end(), nullptr /* opDebug */));
+        wuow.commit();
+
+        auto cursor = collection->getCursor(opCtx);
+        while (auto record = cursor->next()) {
+            recordIds.push_back(record->id);
+        }
+    }
+    ASSERT_EQ(docs.size(), recordIds.size());
+
+    // Nothing is visible before the first record's timestamp.
+    assertIndexAtTimestamp(Timestamp(9, 1), "a_1", {}, false);
+    assertIndexAtTimestamp(Timestamp(9, 1), "b_1", {}, false);
+
+    for (size_t visible = 1; visible <= docs.size(); ++visible) {
+        std::vector<IndexKeyEntry> expectedA;
+        std::vector<IndexKeyEntry> expectedB;
+        for (size_t i = 0; i < visible; ++i) {
+            expectedA.emplace_back(BSON("" << docs[i]["a"].numberInt()), recordIds[i]);
+            auto b = docs[i]["b"];
+            if (b.type() == Array) {
+                for (auto&& element : b.Obj()) {
+                    expectedB.emplace_back(BSON("" << element.numberInt()), recordIds[i]);
+                }
+            } else {
+                expectedB.emplace_back(BSON("" << b.numberInt()), recordIds[i]);
+            }
+        }
+        const auto byKey = [](const IndexKeyEntry& lhs, const IndexKeyEntry& rhs) {
+            return lhs.key.woCompare(rhs.key) < 0;
+        };
+        std::sort(expectedA.begin(), expectedA.end(), byKey);
+        std::sort(expectedB.begin(), expectedB.end(), byKey);
+
+        const auto ts = timestampOf(visible - 1);
+        assertIndexAtTimestamp(ts, "a_1", expectedA, false);
+        assertIndexAtTimestamp(ts, "b_1", expectedB, visible > kFirstMultikeyDoc);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
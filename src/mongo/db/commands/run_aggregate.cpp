@@ -45,6 +45,7 @@
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/document_memory_pool.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/accumulator.h"
@@ -66,6 +67,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor_factory.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/oplog.h"
@@ -174,6 +176,10 @@ bool handleCursorCommand(OperationContext* opCtx,
     invariant(exec);
     ResourceConsumption::DocumentUnitCounter docUnitsReturned;
 
+    // The documents of the batch recycle each other's memory.
+    DocumentMemoryPool::Scope documentMemoryPoolScope(
+        internalQueryEnableDocumentMemoryPool.load());
+
     bool stashedResult = false;
     // We are careful to avoid ever calling 'getNext()' on the PlanExecutor when the batchSize is
     // zero to avoid doing any query execution work.
@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/sampling_profiler.h"
+
+namespace mongo {
+namespace {
+
+constexpr long long kDefaultProfileStacks = 100;
+constexpr long long kMaxProfileStacks = 1000;
+
+/**
+ * Returns the heaviest stacks aggregated by the sampling profiler, symbolized.
+ *
+ * {getSamplingProfile: 1, limit: <number of stacks>, reset: <bool>}
+ */
+class GetSamplingProfileCommand final : public BasicCommand {
+public:
+    GetSamplingProfileCommand() : BasicCommand("getSamplingProfile") {}
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    std::string help() const override {
+        return "get the stacks sampled by the sampling profiler, optionally resetting them";
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::serverStatus)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& db,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        uassert(ErrorCodes::IllegalOperation,
+                "The sampling profiler is not supported on this platform",
+                SamplingProfiler::isSupported());
+
+        long long limit = kDefaultProfileStacks;
+        if (auto limitElem = cmdObj["limit"]; !limitElem.eoo()) {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "limit must be a number between 1 and " << kMaxProfileStacks,
+                    limitElem.isNumber() && limitElem.safeNumberLong() >= 1 &&
+                        limitElem.safeNumberLong() <= kMaxProfileStacks);
+            limit = limitElem.safeNumberLong();
+        }
+
+        auto& profiler = SamplingProfiler::get();
+        profiler.appendProfile(limit, &result);
+        if (cmdObj["reset"].trueValue()) {
+            profiler.reset();
+        }
+        return true;
+    }
+} getSamplingProfileCommand;
+
+/**
+ * Appends the sample counts of the heaviest stacks, so that they are captured in the diagnostic
+ * data while the sampling profiler is enabled.
+ */
+class SamplingProfilerServerStatusSection final : public ServerStatusSection {
+public:
+    SamplingProfilerServerStatusSection() : ServerStatusSection("samplingProfiler") {}
+
+    bool includeByDefault() const override {
+        return SamplingProfiler::get().isEnabled();
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        SamplingProfiler::get().appendSummary(&builder);
+        return builder.obj();
+    }
+} samplingProfilerServerStatusSection;
+
+}  // namespace
+}  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/db/concurrency/flow_control_ticketholder.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/operation_phase_timeline.h"
 #include "mongo/db/storage/flow_control.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/compiler.h"
@@ -48,6 +49,7 @@
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
@@ -385,6 +387,7 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
             invariant(!opCtx->recoveryUnit()->isTimestamped());
 
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+        OperationPhaseTimer phaseTimer(opCtx, OperationPhase::kTicketAcquisition);
         if (deadline == Date_t::max()) {
             holder->waitForTicket(interruptible);
         } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
@@ -935,6 +938,11 @@ void LockerImpl::_lockComplete(OperationContext* opCtx,
                                ResourceId resId,
                                LockMode mode,
                                Date_t deadline) {
+    // Only reached when the lock could not be granted immediately, so the uncontended path is not
+    // timed.
+    OperationPhaseTimer phaseTimer(opCtx, OperationPhase::kLockAcquisition);
+    SamplingProfiler::ScopedLockWait lockWaitSample;
+
     // Operations which are holding open an oplog hole cannot block when acquiring locks. Lock
     // requests entering this function have been queued up and will be granted the lock as soon as
     // the lock is released, which is a blocking operation.
@@ -50,6 +50,7 @@
 #include "mongo/db/profile_filter.h"
 #include "mongo/db/query/getmore_command_gen.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/stats/operation_phase_timeline.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/impersonated_user_metadata.h"
@@ -938,6 +939,10 @@ void OpDebug::report(OperationContext* opCtx,
         pAttrs->add("remoteOpWaitMillis", durationCount<Milliseconds>(*remoteOpWaitTime));
     }
 
+    if (const auto& phaseTimeline = OperationPhaseTimeline::get(opCtx); !phaseTimeline.empty()) {
+        pAttrs->add("phases", phaseTimeline.toBSON(opCtx->getServiceContext()->getTickSource()));
+    }
+
     pAttrs->add("durationMillis", durationCount<Milliseconds>(executionTime));
 }
 
@@ -1086,6 +1091,10 @@ void OpDebug::append(OperationContext* opCtx,
         b.append("remoteOpWaitMillis", durationCount<Milliseconds>(*remoteOpWaitTime));
     }
 
+    if (const auto& phaseTimeline = OperationPhaseTimeline::get(opCtx); !phaseTimeline.empty()) {
+        b.append("phases", phaseTimeline.toBSON(opCtx->getServiceContext()->getTickSource()));
+    }
+
     b.appendNumber("millis", durationCount<Milliseconds>(executionTime));
 
     if (!curop.getPlanSummary().empty()) {
@@ -1381,6 +1390,13 @@ std::function<BSONObj(ProfileFilter::Args)> OpDebug::appendStaged(StringSet requ
         }
     });
 
+    addIfNeeded("phases", [](auto field, auto args, auto& b) {
+        if (const auto& phaseTimeline = OperationPhaseTimeline::get(args.opCtx);
+            !phaseTimeline.empty()) {
+            b.append(field, phaseTimeline.toBSON(args.opCtx->getServiceContext()->getTickSource()));
+        }
+    });
+
     // millis and durationMillis are the same thing. This is one of the few inconsistencies between
     // the profiler (OpDebug::append) and the log file (OpDebug::report), so for the profile filter
     // we support both names.
@@ -42,6 +42,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_feature_flags_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/fail_point.h"
@@ -54,6 +55,14 @@ using std::vector;
 // static
 const char* CollectionScan::kStageType = "COLLSCAN";
 
+namespace {
+// Bounds on a window of records over which a collection scan evaluates its compiled filter at once.
+// The records of a window are copied, so the byte bound keeps scans of large documents from holding
+// many of them.
+constexpr size_t kMaxFilterBatchRecords = 64;
+constexpr size_t kMaxFilterBatchBytes = 1024 * 1024;
+}  // namespace
+
 CollectionScan::CollectionScan(ExpressionContext* expCtx,
                                const CollectionPtr& collection,
                                const CollectionScanParams& params,
@@ -114,6 +123,10 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
         // only support in the forward direction.
         invariant(params.direction == CollectionScanParams::FORWARD);
     }
+
+    if (_filter && feature_flags::gFeatureFlagBatchedMatchEvaluation.isEnabledAndIgnoreFCV()) {
+        _compiledFilter = BatchedMatchEvaluator::compile(_filter);
+    }
 }
 
 CollectionScan::CollectionScan(ExpressionContext* expCtx,
@@ -129,7 +142,16 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_sharedOplogSubscription) {
+        return workFromSharedOplogReader(out);
+    }
+
+    if (_batchSelectionPos < _batchSelection.size()) {
+        return returnFromFilteredBatch(out);
+    }
+
     boost::optional<Record> record;
+    size_t numBatchedRecords = 0;
     const bool needToMakeCursor = !_cursor;
     try {
         if (needToMakeCursor) {
@@ -206,7 +228,11 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         }
 
         if (!record) {
-            record = _cursor->next();
+            if (canFilterInBatches()) {
+                numBatchedRecords = readFilteredBatch();
+            } else {
+                record = _cursor->next();
+            }
         }
     } catch (const WriteConflictException&) {
         // Leave us in a state to try again next time.
@@ -216,11 +242,21 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::NEED_YIELD;
     }
 
+    if (numBatchedRecords > 0) {
+        return returnFromFilteredBatch(out);
+    }
+
     if (!record) {
         // We hit EOF. If we are tailable and have already seen data, leave us in a state to pick up
         // where we left off on the next call to work(). Otherwise, the EOF is permanent.
         if (_params.tailable && !_lastSeenId.isNull()) {
             _cursor.reset();
+            if (canShareOplogReads()) {
+                // We have caught up with the end of the oplog. Receive further entries from the
+                // shared reader, if it has not already moved past us.
+                _sharedOplogSubscription =
+                    SharedOplogReader::get(opCtx()).subscribe(expCtx()->ns, _lastSeenId);
+            }
         } else {
             _commonStats.isEOF = true;
         }
@@ -228,6 +264,9 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     }
 
     _lastSeenId = record->id;
+    if (_params.shareOplogReads) {
+        SharedOplogReader::get(opCtx()).notePrivateReads(1);
+    }
     if (_params.assertTsHasNotFallenOffOplog) {
         assertTsHasNotFallenOffOplog(*record);
     }
@@ -244,6 +283,124 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     return returnIfMatches(member, id, out);
 }
 
+bool CollectionScan::canFilterInBatches() const {
+    return _compiledFilter && !_params.tailable && !_params.minRecord && !_params.maxRecord &&
+        !_params.requestResumeToken && !_params.shouldTrackLatestOplogTimestamp &&
+        !_params.assertTsHasNotFallenOffOplog && !_params.stopApplyingFilterAfterFirstMatch;
+}
+
+size_t CollectionScan::readFilteredBatch() {
+    _specificStats.docsTested += _batchDocs.size() - _batchNumTested;
+    _batchRecordIds.clear();
+    _batchDocs.clear();
+    _batchSelection.clear();
+    _batchSelectionPos = 0;
+    _batchNumTested = 0;
+
+    size_t numBytes = 0;
+    while (_batchDocs.size() < kMaxFilterBatchRecords && numBytes < kMaxFilterBatchBytes) {
+        boost::optional<Record> record;
+        try {
+            record = _cursor->next();
+        } catch (const WriteConflictException&) {
+            if (_batchDocs.empty()) {
+                throw;
+            }
+            // Return the records read so far. The next window retries the read, and yields if it
+            // conflicts again.
+            break;
+        }
+        if (!record) {
+            break;
+        }
+
+        _lastSeenId = record->id;
+        numBytes += record->data.size();
+        _batchRecordIds.push_back(std::move(record->id));
+        _batchDocs.push_back(record->data.getOwned().releaseToBson());
+    }
+
+    _batchSnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
+    if (!_batchDocs.empty()) {
+        _compiledFilter->filter(_batchDocs.data(), _batchDocs.size(), &_batchSelection);
+    }
+    return _batchDocs.size();
+}
+
+PlanStage::StageState CollectionScan::returnFromFilteredBatch(WorkingSetID* out) {
+    // Count the records as tested only once the scan has passed them, so that the stats match
+    // those of a scan which filters one record at a time when the scan stops early.
+    if (_batchSelectionPos == _batchSelection.size()) {
+        _specificStats.docsTested += _batchDocs.size() - _batchNumTested;
+        _batchNumTested = _batchDocs.size();
+        return PlanStage::NEED_TIME;
+    }
+
+    // The documents keep the snapshot they were read in, so that a yield between two of them is
+    // noticed by the stages which require the document to be current.
+    const size_t pos = _batchSelection[_batchSelectionPos++];
+    _specificStats.docsTested += pos + 1 - _batchNumTested;
+    _batchNumTested = pos + 1;
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->recordId = std::move(_batchRecordIds[pos]);
+    member->resetDocument(_batchSnapshotId, std::move(_batchDocs[pos]));
+    _workingSet->transitionToRecordIdAndObj(id);
+
+    *out = id;
+    return PlanStage::ADVANCED;
+}
+
+bool CollectionScan::canShareOplogReads() const {
+    return _params.shareOplogReads && _params.tailable &&
+        _params.direction == CollectionScanParams::FORWARD && !_params.maxRecord && _filter &&
+        !_params.stopApplyingFilterAfterFirstMatch;
+}
+
+PlanStage::StageState CollectionScan::workFromSharedOplogReader(WorkingSetID* out) {
+    bool detached = false;
+    Timestamp scannedThrough;
+    auto entry = _sharedOplogSubscription->next(&detached, &scannedThrough);
+    if (!entry && !detached) {
+        try {
+            SharedOplogReader::get(opCtx()).readAhead(opCtx(), collection());
+        } catch (const WriteConflictException&) {
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+        entry = _sharedOplogSubscription->next(&detached, &scannedThrough);
+    }
+
+    if (!entry) {
+        if (detached) {
+            // We fell too far behind, or the reader lost its position. Resume after the last entry
+            // we returned through a private cursor.
+            _sharedOplogSubscription.reset();
+            return PlanStage::NEED_TIME;
+        }
+
+        // Every entry up to 'scannedThrough' which we have not seen could not have matched.
+        if (_params.shouldTrackLatestOplogTimestamp) {
+            _latestOplogEntryTimestamp = std::max(_latestOplogEntryTimestamp, scannedThrough);
+        }
+        return PlanStage::IS_EOF;
+    }
+
+    SharedOplogReader::get(opCtx()).noteSharedReads(1);
+    _lastSeenId = entry->id;
+    if (_params.shouldTrackLatestOplogTimestamp) {
+        _latestOplogEntryTimestamp = std::max(_latestOplogEntryTimestamp, entry->ts);
+    }
+
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->recordId = std::move(entry->id);
+    member->resetDocument(opCtx()->recoveryUnit()->getSnapshotId(), std::move(entry->obj));
+    _workingSet->transitionToRecordIdAndObj(id);
+
+    return returnIfMatches(member, id, out);
+}
+
 void CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
     uassert(ErrorCodes::Error(4382100),
@@ -357,9 +514,10 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
     // In the future, we could change seekNear() to always return a record after minRecord in the
     // direction of the scan. However, tailable scans depend on the current behavior in order to
     // mark their position for resuming the tailable scan later on.
-    if (!beforeStartOfRange(_params, *member) && Filter::passes(member, _filter)) {
+    if (!beforeStartOfRange(_params, *member) && passesFilter(member)) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
@@ -369,6 +527,13 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
     }
 }
 
+bool CollectionScan::passesFilter(WorkingSetMember* member) {
+    if (!_compiledFilter) {
+        return Filter::passes(member, _filter);
+    }
+    return _compiledFilter->matches(member->doc.value().toBson());
+}
+
 bool CollectionScan::isEOF() {
     return _commonStats.isEOF;
 }
@@ -30,11 +30,15 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/exec/shared_oplog_reader.h"
+#include "mongo/db/matcher/batched_match_evaluator.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/snapshot.h"
 #include "mongo/s/resharding/resume_token_gen.h"
 
 namespace mongo {
@@ -112,6 +116,45 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Returns true if the document in 'member' passes '_filter', evaluating it with the compiled
+     * filter when there is one.
+     */
+    bool passesFilter(WorkingSetMember* member);
+
+    /**
+     * Returns true if this scan evaluates '_compiledFilter' over windows of records read ahead of
+     * the record it returns. Reading ahead moves '_lastSeenId' past the records which are still
+     * buffered, so this excludes the scans which resume or report a position from it.
+     */
+    bool canFilterInBatches() const;
+
+    /**
+     * Reads the next window of records from '_cursor', copying them since the cursor does not keep
+     * them valid once it moves, and evaluates '_compiledFilter' over the window. Returns the number
+     * of records read, which is zero at the end of the collection.
+     */
+    size_t readFilteredBatch();
+
+    /**
+     * Returns the next record of the current window which passed the filter, or NEED_TIME if none
+     * are left.
+     */
+    StageState returnFromFilteredBatch(WorkingSetID* out);
+
+    /**
+     * Returns true if this scan may subscribe to the SharedOplogReader once it has caught up with
+     * the end of the oplog.
+     */
+    bool canShareOplogReads() const;
+
+    /**
+     * Produces the next entry from '_sharedOplogSubscription', reading ahead on behalf of all
+     * subscribers when it is empty. Falls back to a private cursor once the subscription has been
+     * detached and drained.
+     */
+    StageState workFromSharedOplogReader(WorkingSetID* out);
+
     /**
      * Extracts the timestamp from the 'ts' field of 'record', and sets '_latestOplogEntryTimestamp'
      * to that time if it isn't already greater. Throws an exception if the 'ts' field cannot be
@@ -130,8 +173,26 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // A compiled form of '_filter', set when batched match evaluation is enabled and some part of
+    // the filter could be compiled.
+    std::unique_ptr<BatchedMatchEvaluator> _compiledFilter;
+
+    // The current window of records read by readFilteredBatch(), the positions in it of the
+    // records which passed the filter, the next of those positions to return, and the number of
+    // records of the window counted in the stats.
+    std::vector<RecordId> _batchRecordIds;
+    std::vector<BSONObj> _batchDocs;
+    std::vector<size_t> _batchSelection;
+    size_t _batchSelectionPos = 0;
+    size_t _batchNumTested = 0;
+    SnapshotId _batchSnapshotId;
+
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
+    // Set while this tailable oplog scan receives its entries from the SharedOplogReader rather
+    // than through '_cursor'.
+    std::unique_ptr<SharedOplogReader::Subscription> _sharedOplogSubscription;
+
     CollectionScanParams _params;
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
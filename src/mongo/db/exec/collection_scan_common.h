@@ -110,6 +110,10 @@ struct CollectionScanParams {
 
     // Whether or not to wait for oplog visibility on oplog collection scans.
     bool shouldWaitForOplogVisibility = false;
+
+    // Whether a tailable oplog scan serving a change stream may receive its entries from the
+    // node's SharedOplogReader once it has caught up with the end of the oplog.
+    bool shareOplogReads = false;
 };
 
 }  // namespace mongo
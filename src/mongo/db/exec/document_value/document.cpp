@@ -293,6 +293,8 @@ void DocumentStorage::alloc(unsigned newSize) {
     const bool firstAlloc = !_cache;
     const bool doingRehash = needRehash();
     const size_t oldCapacity = _cacheEnd - _cache;
+    char* const oldBuf = _cache;
+    const size_t oldBufBytes = _cacheBytes;
 
     // make new bucket count big enough
     while (needRehash() || hashTabBuckets() < HASH_TAB_INIT_SIZE)
@@ -305,13 +307,13 @@ void DocumentStorage::alloc(unsigned newSize) {
 
     uassert(16490, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    std::unique_ptr<char[]> oldBuf(_cache);
-    _cache = new char[capacity];
+    _cache = static_cast<char*>(DocumentMemoryPool::allocate(capacity));
+    _cacheBytes = capacity;
     _cacheEnd = _cache + capacity - hashTabBytes();
 
     if (!firstAlloc) {
         // This just copies the elements
-        memcpy(_cache, oldBuf.get(), _usedBytes);
+        memcpy(_cache, oldBuf, _usedBytes);
 
         if (_numFields >= HASH_TAB_MIN) {
             // if we were hashing, deal with the hash table
@@ -319,10 +321,14 @@ void DocumentStorage::alloc(unsigned newSize) {
                 rehash();
             } else {
                 // no rehash needed so just slide table down to new position
-                memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
             }
         }
     }
+
+    if (oldBuf) {
+        DocumentMemoryPool::deallocate(oldBuf, oldBufBytes);
+    }
 }
 
 void DocumentStorage::reserveFields(size_t expectedFields) {
@@ -338,7 +344,8 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 
     uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
 
-    _cache = new char[newSize + hashTabBytes()];
+    _cacheBytes = newSize + hashTabBytes();
+    _cache = static_cast<char*>(DocumentMemoryPool::allocate(_cacheBytes));
     _cacheEnd = _cache + newSize;
 }
 
@@ -350,7 +357,8 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
         // Make a copy of the buffer with the fields.
         // It is very important that the positions of each field are the same after cloning.
         const size_t bufferBytes = allocatedBytes();
-        out->_cache = new char[bufferBytes];
+        out->_cache = static_cast<char*>(DocumentMemoryPool::allocate(bufferBytes));
+        out->_cacheBytes = bufferBytes;
         out->_cacheEnd = out->_cache + (_cacheEnd - _cache);
         memcpy(out->_cache, _cache, bufferBytes);
 
@@ -382,11 +390,13 @@ size_t DocumentStorage::getMetadataApproximateSize() const {
 }
 
 DocumentStorage::~DocumentStorage() {
-    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_cache);
-
     for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
+
+    if (_cache) {
+        DocumentMemoryPool::deallocate(_cache, _cacheBytes);
+    }
 }
 
 void DocumentStorage::reset(const BSONObj& bson, bool stripMetadata) {
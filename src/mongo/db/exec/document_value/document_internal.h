@@ -34,6 +34,7 @@
 #include <third_party/murmurhash3/MurmurHash3.h>
 
 #include "mongo/base/static_assert.h"
+#include "mongo/db/exec/document_value/document_memory_pool.h"
 #include "mongo/db/exec/document_value/document_metadata_fields.h"
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/stdx/variant.h"
@@ -369,6 +370,7 @@ public:
                     uint32_t numBytesFromBSONInCache)
         : _cache(nullptr),
           _cacheEnd(nullptr),
+          _cacheBytes(0),
           _usedBytes(0),
           _numFields(0),
           _hashTabMask(0),
@@ -379,6 +381,14 @@ public:
 
     ~DocumentStorage();
 
+    // Storages and their buffers come from the DocumentMemoryPool of the thread, if it has one.
+    static void* operator new(size_t bytes) {
+        return DocumentMemoryPool::allocate(bytes);
+    }
+    static void operator delete(void* ptr, size_t bytes) {
+        DocumentMemoryPool::deallocate(ptr, bytes);
+    }
+
     void reset(const BSONObj& bson, bool stripMetadata);
 
     /**
@@ -674,6 +684,7 @@ private:
         Position* _hashTab;  // table lazily initialized once _numFields == HASH_TAB_MIN
     };
 
+    unsigned _cacheBytes;   // size of the allocation _cache points to
     unsigned _usedBytes;    // position where next field would start
     unsigned _numFields;    // this includes removed fields
     unsigned _hashTabMask;  // equal to hashTabBuckets()-1 but used more often
@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/document_value/document_memory_pool.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/allocator.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+// Blocks larger than this are always returned to the allocator.
+constexpr size_t kMaxPooledBlockBytes = 64 * 1024;
+
+// Upper bound of the memory a thread keeps cached.
+constexpr size_t kMaxCachedBytesPerThread = 16 * 1024 * 1024;
+
+// The free lists are only populated while a scope is active, so they are always empty by the time
+// the thread exits.
+struct ThreadPoolState {
+    void releaseCachedBlocks() {
+        for (auto&& [bytes, blocks] : freeLists) {
+            for (auto block : blocks) {
+                std::free(block);
+            }
+        }
+        freeLists.clear();
+        cachedBytes = 0;
+    }
+
+    int depth = 0;
+    size_t cachedBytes = 0;
+    stdx::unordered_map<size_t, std::vector<void*>> freeLists;
+
+    uint64_t allocations = 0;
+    uint64_t reusedAllocations = 0;
+};
+
+thread_local ThreadPoolState threadPoolState;
+
+}  // namespace
+
+Counter64 DocumentMemoryPool::allocations;
+Counter64 DocumentMemoryPool::reusedAllocations;
+
+namespace {
+ServerStatusMetricField<Counter64> displayAllocations("query.documentMemoryPool.allocations",
+                                                      &DocumentMemoryPool::allocations);
+ServerStatusMetricField<Counter64> displayReusedAllocations(
+    "query.documentMemoryPool.reusedAllocations", &DocumentMemoryPool::reusedAllocations);
+}  // namespace
+
+DocumentMemoryPool::Scope::Scope(bool enabled) : _enabled(enabled) {
+    if (_enabled) {
+        ++threadPoolState.depth;
+    }
+}
+
+DocumentMemoryPool::Scope::~Scope() {
+    if (!_enabled) {
+        return;
+    }
+
+    auto& state = threadPoolState;
+    invariant(state.depth > 0);
+    if (--state.depth > 0) {
+        return;
+    }
+
+    state.releaseCachedBlocks();
+    allocations.increment(state.allocations);
+    reusedAllocations.increment(state.reusedAllocations);
+    state.allocations = 0;
+    state.reusedAllocations = 0;
+}
+
+bool DocumentMemoryPool::isActive() {
+    return threadPoolState.depth > 0;
+}
+
+void* DocumentMemoryPool::allocate(size_t bytes) {
+    auto& state = threadPoolState;
+    if (state.depth > 0) {
+        ++state.allocations;
+        auto it = state.freeLists.find(bytes);
+        if (it != state.freeLists.end() && !it->second.empty()) {
+            auto block = it->second.back();
+            it->second.pop_back();
+            state.cachedBytes -= bytes;
+            ++state.reusedAllocations;
+            return block;
+        }
+    }
+    return mongoMalloc(bytes);
+}
+
+void DocumentMemoryPool::deallocate(void* ptr, size_t bytes) {
+    auto& state = threadPoolState;
+    if (state.depth > 0 && bytes <= kMaxPooledBlockBytes &&
+        state.cachedBytes + bytes <= kMaxCachedBytesPerThread) {
+        state.freeLists[bytes].push_back(ptr);
+        state.cachedBytes += bytes;
+        return;
+    }
+    std::free(ptr);
+}
+
+}  // namespace mongo
@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/counter.h"
+
+namespace mongo {
+
+/**
+ * A per-thread cache of the memory of DocumentStorage objects and of their field buffers.
+ *
+ * While a DocumentMemoryPool::Scope is active on a thread, the blocks freed on that thread are kept
+ * on free lists keyed by their exact size rather than returned to the allocator, and are reused by
+ * the next allocations of the same size. A pipeline produces many documents of the same shape, so
+ * most of the allocations of a batch are served from the free lists. All the cached blocks are
+ * released at once when the outermost scope of the thread ends, at the end of the batch.
+ *
+ * The blocks are ordinary heap allocations, so a block allocated within a scope may outlive it or
+ * be freed by another thread.
+ */
+class DocumentMemoryPool {
+public:
+    /**
+     * Enables the pool on the current thread for its lifetime, if 'enabled' is true. Scopes can be
+     * nested, only the outermost one releases the cached blocks.
+     */
+    class Scope {
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    public:
+        explicit Scope(bool enabled);
+        ~Scope();
+
+    private:
+        const bool _enabled;
+    };
+
+    static void* allocate(size_t bytes);
+    static void deallocate(void* ptr, size_t bytes);
+
+    /**
+     * Returns whether a scope is active on the current thread.
+     */
+    static bool isActive();
+
+    // Number of allocations made while a scope was active, and how many of them reused a cached
+    // block. Updated when the outermost scope of a thread ends.
+    static Counter64 allocations;
+    static Counter64 reusedAllocations;
+};
+
+}  // namespace mongo
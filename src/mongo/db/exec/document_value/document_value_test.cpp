@@ -37,6 +37,7 @@
 #include "mongo/bson/bson_depth.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/document_value/document_comparator.h"
+#include "mongo/db/exec/document_value/document_memory_pool.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/db/exec/document_value/value_comparator.h"
@@ -137,6 +138,31 @@ TEST(DocumentConstruction, FromBsonReset) {
     ASSERT_BSONOBJ_EQ(bson, toBson(newDocument));
 }
 
+TEST(DocumentConstruction, WithDocumentMemoryPool) {
+    const auto allocationsBefore = DocumentMemoryPool::allocations.get();
+    const auto reusedAllocationsBefore = DocumentMemoryPool::reusedAllocations.get();
+
+    Document survivor;
+    {
+        DocumentMemoryPool::Scope scope(true);
+        ASSERT_TRUE(DocumentMemoryPool::isActive());
+        for (int i = 0; i < 10; ++i) {
+            MutableDocument md;
+            md.addField("a", Value(i));
+            md.addField("b", Value("abc"_sd));
+            survivor = md.freeze();
+        }
+    }
+    ASSERT_FALSE(DocumentMemoryPool::isActive());
+
+    // A document allocated within the scope outlives it.
+    ASSERT_DOCUMENT_EQ(survivor, (Document{{"a", 9}, {"b", "abc"_sd}}));
+
+    // Every document after the first one reuses the memory of the previous one.
+    ASSERT_GT(DocumentMemoryPool::allocations.get(), allocationsBefore);
+    ASSERT_GT(DocumentMemoryPool::reusedAllocations.get(), reusedAllocationsBefore);
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
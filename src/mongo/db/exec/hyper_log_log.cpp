@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/hyper_log_log.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "mongo/base/data_view.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
+
+namespace mongo {
+namespace {
+
+// Number of hash bits left over after the bucket index has been taken off the top of the hash.
+// The rank of a value is in the range [1, kRankBits + 1].
+constexpr int kRankBits = 64 - HyperLogLog::kPrecision;
+
+// The seed is part of the on-the-wire format: changing it makes sketches produced by different
+// binary versions unmergeable.
+constexpr uint32_t kHashSeed = 0x5eed1e55;
+
+uint8_t* registers(uint8_t* buf) {
+    return buf + HyperLogLog::kHeaderSize;
+}
+
+const uint8_t* registers(const uint8_t* buf) {
+    return buf + HyperLogLog::kHeaderSize;
+}
+
+// Helper functions for Ertl's improved raw estimator. See Algorithm 6 in the paper referenced in
+// the header.
+double sigma(double x) {
+    if (x == 1.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double y = 1.0;
+    double z = x;
+    double zPrev;
+    do {
+        x *= x;
+        zPrev = z;
+        z += x * y;
+        y += y;
+    } while (z != zPrev);
+    return z;
+}
+
+double tau(double x) {
+    if (x == 0.0 || x == 1.0) {
+        return 0.0;
+    }
+    double y = 1.0;
+    double z = 1.0 - x;
+    double zPrev;
+    do {
+        x = std::sqrt(x);
+        zPrev = z;
+        y *= 0.5;
+        z -= (1.0 - x) * (1.0 - x) * y;
+    } while (z != zPrev);
+    return z / 3.0;
+}
+
+}  // namespace
+
+void HyperLogLog::initialize(uint8_t* buf) {
+    buf[0] = kFormatVersion;
+    buf[1] = kPrecision;
+    std::memset(registers(buf), 0, kNumRegisters);
+}
+
+bool HyperLogLog::isValid(const uint8_t* buf, size_t len) {
+    if (len != kSerializedSize || buf[0] != kFormatVersion || buf[1] != kPrecision) {
+        return false;
+    }
+    auto regs = registers(buf);
+    return std::all_of(regs, regs + kNumRegisters, [](uint8_t r) { return r <= kRankBits + 1; });
+}
+
+void HyperLogLog::assertValid(const uint8_t* buf, size_t len) {
+    uassert(6440000,
+            str::stream() << "Invalid HyperLogLog sketch of " << len << " bytes, expected "
+                          << kSerializedSize << " bytes with format version "
+                          << static_cast<int>(kFormatVersion),
+            isValid(buf, len));
+}
+
+void HyperLogLog::add(uint8_t* buf, uint64_t hash) {
+    const auto index = hash >> kRankBits;
+    const auto remainder = hash << kPrecision;
+    const auto rank = remainder == 0
+        ? static_cast<uint8_t>(kRankBits + 1)
+        : static_cast<uint8_t>(std::min(countLeadingZerosNonZero64(remainder) + 1, kRankBits + 1));
+
+    auto& reg = registers(buf)[index];
+    if (rank > reg) {
+        reg = rank;
+    }
+}
+
+void HyperLogLog::merge(uint8_t* dst, const uint8_t* src) {
+    auto dstRegs = registers(dst);
+    auto srcRegs = registers(src);
+    for (size_t i = 0; i < kNumRegisters; ++i) {
+        dstRegs[i] = std::max(dstRegs[i], srcRegs[i]);
+    }
+}
+
+long long HyperLogLog::estimate(const uint8_t* buf) {
+    // Histogram of register values.
+    std::array<uint32_t, kRankBits + 2> counts{};
+    auto regs = registers(buf);
+    for (size_t i = 0; i < kNumRegisters; ++i) {
+        ++counts[regs[i]];
+    }
+
+    if (counts[0] == kNumRegisters) {
+        return 0;
+    }
+
+    const double m = static_cast<double>(kNumRegisters);
+    double z = m * tau(1.0 - counts[kRankBits + 1] / m);
+    for (int k = kRankBits; k >= 1; --k) {
+        z = 0.5 * (z + counts[k]);
+    }
+    z += m * sigma(counts[0] / m);
+
+    const double alphaInf = 0.5 / std::log(2.0);
+    return std::llround(alphaInf * m * m / z);
+}
+
+uint64_t HyperLogLog::hash(const BSONElement& elem, const CollatorInterface* collator) {
+    // KeyString encodes numerically equal values of different types identically (the type
+    // information lives in the separate TypeBits, which we ignore), which gives us the same
+    // equivalence classes as $addToSet. The version is pinned so that the hash remains stable
+    // even if the latest KeyString format changes.
+    KeyString::Builder ks(KeyString::Version::V1);
+    if (collator) {
+        ks.appendBSONElement(elem, [&](StringData stringData) {
+            return collator->getComparisonString(stringData);
+        });
+    } else {
+        ks.appendBSONElement(elem);
+    }
+
+    // The hash function writes its output in little-endian byte order on every platform.
+    char hash[16];
+    MurmurHash3_x64_128(ks.getBuffer(), ks.getSize(), kHashSeed, hash);
+    return ConstDataView(hash).read<LittleEndian<uint64_t>>();
+}
+
+}  // namespace mongo
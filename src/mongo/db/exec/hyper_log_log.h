@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mongo/bson/bsonelement.h"
+#include "mongo/db/query/collation/collator_interface.h"
+
+namespace mongo {
+
+/**
+ * A HyperLogLog sketch for estimating the number of distinct values in a stream using a fixed
+ * amount of memory.
+ *
+ * The sketch operates on a caller-owned byte buffer of exactly 'kSerializedSize' bytes, so that
+ * the same representation can be kept inside a classic accumulator, updated in place inside an
+ * SBE slot, spilled to disk, or shipped from a shard to the merging node as a BinData partial
+ * result. The buffer layout is:
+ *
+ *     [0]                 format version ('kFormatVersion')
+ *     [1]                 precision 'p'
+ *     [2, 2 + 2^p)        one register per bucket, holding the maximum observed rank
+ *
+ * Hashes are 64 bits wide, which removes the need for the large-range correction of the original
+ * algorithm. Cardinality is computed with the improved estimator from Ertl, "New cardinality
+ * estimation algorithms for HyperLogLog sketches" (2017), which is accurate over the whole range
+ * without empirical bias tables. With p = 12 the relative standard error is about 1.6%.
+ */
+class HyperLogLog {
+public:
+    static constexpr uint8_t kFormatVersion = 1;
+    static constexpr int kPrecision = 12;
+    static constexpr size_t kNumRegisters = size_t{1} << kPrecision;
+    static constexpr size_t kHeaderSize = 2;
+    static constexpr size_t kSerializedSize = kHeaderSize + kNumRegisters;
+
+    /**
+     * Writes an empty sketch into 'buf', which must hold at least 'kSerializedSize' bytes.
+     */
+    static void initialize(uint8_t* buf);
+
+    /**
+     * Returns true if the 'len' bytes starting at 'buf' hold a sketch that this version of the
+     * server can merge.
+     */
+    static bool isValid(const uint8_t* buf, size_t len);
+
+    /**
+     * Throws if 'buf' does not hold a valid sketch. Used to vet partial results received from
+     * other nodes before merging them.
+     */
+    static void assertValid(const uint8_t* buf, size_t len);
+
+    /**
+     * Records a value, identified by its 64-bit hash, in the sketch stored in 'buf'.
+     */
+    static void add(uint8_t* buf, uint64_t hash);
+
+    /**
+     * Folds the sketch 'src' into 'dst'. The result estimates the cardinality of the union of the
+     * two input streams.
+     */
+    static void merge(uint8_t* dst, const uint8_t* src);
+
+    /**
+     * Returns the estimated number of distinct values recorded in the sketch stored in 'buf'.
+     */
+    static long long estimate(const uint8_t* buf);
+
+    /**
+     * Computes the hash under which 'elem' is recorded. Values that compare equal under the
+     * query's comparison semantics hash identically: numbers of different types but equal value
+     * produce the same hash, and strings are compared through 'collator' when one is given. The
+     * hash is stable across processes and platforms, which allows sketches built on different
+     * shards and by different execution engines to be merged.
+     */
+    static uint64_t hash(const BSONElement& elem, const CollatorInterface* collator);
+};
+
+}  // namespace mongo
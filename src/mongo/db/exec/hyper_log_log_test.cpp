@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/hyper_log_log.h"
+
+#include <cmath>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<uint8_t> makeSketch() {
+    std::vector<uint8_t> sketch(HyperLogLog::kSerializedSize);
+    HyperLogLog::initialize(sketch.data());
+    return sketch;
+}
+
+void addInt(std::vector<uint8_t>& sketch, long long i) {
+    BSONObj obj = BSON("" << i);
+    HyperLogLog::add(sketch.data(), HyperLogLog::hash(obj.firstElement(), nullptr));
+}
+
+/**
+ * Asserts that 'estimate' is within four standard errors of 'expected'.
+ */
+void assertClose(long long expected, long long estimate) {
+    const double stdError = 1.04 / std::sqrt(double(HyperLogLog::kNumRegisters));
+    ASSERT_LTE(std::abs(double(estimate - expected)), 4 * stdError * expected + 1)
+        << "expected " << expected << ", estimated " << estimate;
+}
+
+TEST(HyperLogLogTest, EmptySketchEstimatesZero) {
+    auto sketch = makeSketch();
+    ASSERT_EQ(HyperLogLog::estimate(sketch.data()), 0);
+}
+
+TEST(HyperLogLogTest, SmallCardinalitiesAreNearlyExact) {
+    auto sketch = makeSketch();
+    for (long long i = 0; i < 10; ++i) {
+        addInt(sketch, i);
+    }
+    ASSERT_EQ(HyperLogLog::estimate(sketch.data()), 10);
+}
+
+TEST(HyperLogLogTest, DuplicatesDoNotIncreaseEstimate) {
+    auto sketch = makeSketch();
+    for (int rep = 0; rep < 5; ++rep) {
+        for (long long i = 0; i < 1000; ++i) {
+            addInt(sketch, i);
+        }
+    }
+    assertClose(1000, HyperLogLog::estimate(sketch.data()));
+}
+
+TEST(HyperLogLogTest, LargeCardinalityIsWithinErrorBounds) {
+    auto sketch = makeSketch();
+    for (long long i = 0; i < 200000; ++i) {
+        addInt(sketch, i);
+    }
+    assertClose(200000, HyperLogLog::estimate(sketch.data()));
+}
+
+TEST(HyperLogLogTest, MergeEstimatesUnion) {
+    auto left = makeSketch();
+    auto right = makeSketch();
+    for (long long i = 0; i < 30000; ++i) {
+        addInt(left, i);
+    }
+    for (long long i = 20000; i < 50000; ++i) {
+        addInt(right, i);
+    }
+    HyperLogLog::merge(left.data(), right.data());
+    assertClose(50000, HyperLogLog::estimate(left.data()));
+}
+
+TEST(HyperLogLogTest, EqualNumbersOfDifferentTypesHashIdentically) {
+    BSONObj obj = BSON("int" << 5 << "long" << 5LL << "double" << 5.0 << "decimal"
+                             << Decimal128(5));
+    auto expected = HyperLogLog::hash(obj["int"], nullptr);
+    ASSERT_EQ(HyperLogLog::hash(obj["long"], nullptr), expected);
+    ASSERT_EQ(HyperLogLog::hash(obj["double"], nullptr), expected);
+    ASSERT_EQ(HyperLogLog::hash(obj["decimal"], nullptr), expected);
+}
+
+TEST(HyperLogLogTest, HashRespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    BSONObj obj = BSON("a"
+                       << "foo"
+                       << "b"
+                       << "bar");
+    ASSERT_NE(HyperLogLog::hash(obj["a"], nullptr), HyperLogLog::hash(obj["b"], nullptr));
+    ASSERT_EQ(HyperLogLog::hash(obj["a"], &collator), HyperLogLog::hash(obj["b"], &collator));
+}
+
+TEST(HyperLogLogTest, ValidatesSerializedSketches) {
+    auto sketch = makeSketch();
+    ASSERT_TRUE(HyperLogLog::isValid(sketch.data(), sketch.size()));
+    ASSERT_FALSE(HyperLogLog::isValid(sketch.data(), sketch.size() - 1));
+
+    sketch[0] = HyperLogLog::kFormatVersion + 1;
+    ASSERT_FALSE(HyperLogLog::isValid(sketch.data(), sketch.size()));
+    ASSERT_THROWS_CODE(
+        HyperLogLog::assertValid(sketch.data(), sketch.size()), DBException, 6440000);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -1076,6 +1076,11 @@ struct DocumentSourceLookupStats : public SpecificStats {
 
     // Tracks the summary stats in aggregate across all executions of the subpipeline.
     PlanSummaryStats planSummaryStats;
+
+    // Set if the $lookup was executed as a hash join, along with the number of foreign documents
+    // in its build side.
+    bool usedHashJoin = false;
+    uint64_t hashJoinBuildSideDocs = 0;
 };
 
 struct UnionWithStats final : public SpecificStats {
@@ -425,6 +425,23 @@ static stdx::unordered_map<std::string, BuiltinFn> kBuiltinFunctions = {
      BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::stdDevPopFinalize, false}},
     {"stdDevSampFinalize",
      BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::stdDevSampFinalize, false}},
+    {"aggApproxCountDistinct",
+     BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::aggApproxCountDistinct, true}},
+    {"aggCollApproxCountDistinct",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::aggCollApproxCountDistinct, true}},
+    {"approxCountDistinctFinalize",
+     BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::approxCountDistinctFinalize, false}},
+    {"aggTDigest", BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::aggTDigest, true}},
+    {"tDigestPercentileFinalize",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::tDigestPercentileFinalize, false}},
+    {"aggRemovableSumAdd",
+     BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::aggRemovableSumAdd, true}},
+    {"aggRemovableSumRemove",
+     BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::aggRemovableSumRemove, true}},
+    {"removableSumFinalize",
+     BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::removableSumFinalize, false}},
+    {"removableAvgFinalize",
+     BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::removableAvgFinalize, false}},
     {"bitTestZero", BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::bitTestZero, false}},
     {"bitTestMask", BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::bitTestMask, false}},
     {"bitTestPosition",
@@ -139,10 +139,12 @@ static constexpr auto kSyntax = R"(
 
                 MKOBJ_FLAG <- <'true'> / <'false'>
                 MKOBJ_DROP_KEEP_FLAG <- <'drop'> / <'keep'>
+                MKOBJ_INPLACE_FLAG <- <'inplace'>
                 MKOBJ <- 'mkobj' IDENT
                                  (IDENT # Old root
                                   IDENT_LIST # field names
-                                  MKOBJ_DROP_KEEP_FLAG)? # drop or keep
+                                  MKOBJ_DROP_KEEP_FLAG # drop or keep
+                                  MKOBJ_INPLACE_FLAG?)? # overwrite in place
                                  IDENT_LIST_WITH_RENAMES # project list
                                  MKOBJ_FLAG # Force new object
                                  MKOBJ_FLAG # Return old object
@@ -151,7 +153,8 @@ static constexpr auto kSyntax = R"(
                 MKBSON <- 'mkbson' IDENT
                                    (IDENT # Old root
                                     IDENT_LIST # field names
-                                    MKOBJ_DROP_KEEP_FLAG)? # drop or keep
+                                    MKOBJ_DROP_KEEP_FLAG # drop or keep
+                                    MKOBJ_INPLACE_FLAG?)? # overwrite in place
                                    IDENT_LIST_WITH_RENAMES # project list
                                    MKOBJ_FLAG # Force new object
                                    MKOBJ_FLAG # Return old object
@@ -1084,6 +1087,7 @@ void Parser::walkMkObj(AstQuery& ast) {
     std::string oldRootName;
     std::vector<std::string> fields;
     boost::optional<MakeObjFieldBehavior> fieldBehavior;
+    bool overwriteInPlace = false;
 
     size_t projectListPos = 1;
     size_t forceNewObjPos = 2;
@@ -1098,6 +1102,14 @@ void Parser::walkMkObj(AstQuery& ast) {
         forceNewObjPos = 5;
         retOldObjPos = 6;
         inputPos = 7;
+
+        if (ast.nodes[4]->tag == "MKOBJ_INPLACE_FLAG"_) {
+            overwriteInPlace = true;
+            projectListPos = 5;
+            forceNewObjPos = 6;
+            retOldObjPos = 7;
+            inputPos = 8;
+        }
     }
 
     const bool forceNewObj = ast.nodes[forceNewObjPos]->token == "true";
@@ -1114,7 +1126,8 @@ void Parser::walkMkObj(AstQuery& ast) {
                                 lookupSlots(std::move(ast.nodes[projectListPos]->identifiers)),
                                 forceNewObj,
                                 retOldObj,
-                                getCurrentPlanNodeId());
+                                getCurrentPlanNodeId(),
+                                overwriteInPlace);
     } else {
         ast.stage =
             makeS<MakeBsonObjStage>(std::move(ast.nodes[inputPos]->stage),
@@ -1126,7 +1139,8 @@ void Parser::walkMkObj(AstQuery& ast) {
                                     lookupSlots(std::move(ast.nodes[projectListPos]->identifiers)),
                                     forceNewObj,
                                     retOldObj,
-                                    getCurrentPlanNodeId());
+                                    getCurrentPlanNodeId(),
+                                    overwriteInPlace);
     }
 }
 
@@ -261,6 +261,74 @@ public:
         expectedGuard.reset();
         runTest(inputTag, inputVal, expectedTag, expectedVal, makeStageFn);
     }
+
+    template <class MkObjStageType>
+    void testProjectInPlaceWithRoot() {
+        auto objOutSlotId = generateSlotId();
+        auto slotVec = makeSV(generateSlotId(), generateSlotId());
+
+        value::SlotMap<std::unique_ptr<EExpression>> slotMap;
+        slotMap[slotVec[0]] = makeE<EConstant>("one");
+        slotMap[slotVec[1]] = makeE<EConstant>("two");
+
+        auto makeStageFn = [objOutSlotId, &slotVec, &slotMap](
+                               value::SlotId scanSlot, std::unique_ptr<PlanStage> scanStage) {
+            auto project =
+                makeS<ProjectStage>(std::move(scanStage), std::move(slotMap), kEmptyPlanNodeId);
+
+            auto mkobj = makeS<MkObjStageType>(std::move(project),
+                                               objOutSlotId,
+                                               scanSlot,
+                                               MkObjStageType::FieldBehavior::drop,
+                                               std::vector<std::string>{"d"},
+                                               std::vector<std::string>{"a", "b"},
+                                               slotVec,
+                                               false,  // force new
+                                               false,  // return old
+                                               kEmptyPlanNodeId,
+                                               true);  // overwrite in place
+
+            return std::make_pair(objOutSlotId, std::move(mkobj));
+        };
+
+        auto [inputTag, inputVal] = value::makeNewArray();
+        value::ValueGuard inputGuard{inputTag, inputVal};
+        {
+            auto inputView = value::getArrayView(inputVal);
+            // Add BSON to the input.
+            addBsonObjToArray(inputView, BSON("b" << 1 << "c" << 2 << "d" << 3 << "a" << 4));
+            addBsonObjToArray(inputView, BSON("c" << 1 << "a" << 2));
+
+            // Add some SBE objects to the input.
+            addObjectToArray(inputView, BSON("b" << 1 << "c" << 2 << "d" << 3 << "a" << 4));
+            addObjectToArray(inputView, BSON("c" << 1 << "a" << 2));
+        }
+
+        // The projected fields replace the fields of the root object in place, and are otherwise
+        // added after them.
+        auto [expectedTag, expectedVal] =
+            stage_builder::makeValue(BSON_ARRAY(BSON("b"
+                                                     << "two"
+                                                     << "c" << 2 << "a"
+                                                     << "one")
+                                                << BSON("c" << 1 << "a"
+                                                            << "one"
+                                                            << "b"
+                                                            << "two")
+                                                << BSON("b"
+                                                        << "two"
+                                                        << "c" << 2 << "a"
+                                                        << "one")
+                                                << BSON("c" << 1 << "a"
+                                                            << "one"
+                                                            << "b"
+                                                            << "two")));
+        value::ValueGuard expectedGuard{expectedTag, expectedVal};
+
+        inputGuard.reset();
+        expectedGuard.reset();
+        runTest(inputTag, inputVal, expectedTag, expectedVal, makeStageFn);
+    }
 };
 
 TEST_F(MkObjStageTest, MakeObjKeep) {
@@ -294,4 +362,12 @@ TEST_F(MkObjStageTest, MakeObjProjectWithRoot) {
 TEST_F(MkObjStageTest, MakeBsonObjProjectWithRoot) {
     testProjectWithRoot<MakeBsonObjStage>();
 }
+
+TEST_F(MkObjStageTest, MakeObjProjectInPlaceWithRoot) {
+    testProjectInPlaceWithRoot<MakeObjStage>();
+}
+
+TEST_F(MkObjStageTest, MakeBsonObjProjectInPlaceWithRoot) {
+    testProjectInPlaceWithRoot<MakeBsonObjStage>();
+}
 }  // namespace mongo::sbe
@@ -0,0 +1,206 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This file contains tests for sbe::WindowStage.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
+#include "mongo/db/exec/sbe/stages/project.h"
+#include "mongo/db/exec/sbe/stages/window.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo::sbe {
+
+class WindowStageTest : public PlanStageTestFixture {
+public:
+    /**
+     * Runs a window stage which computes 'fn' ("sum" or "min") over the document-based window
+     * ['lower', 'upper'], and compares the finalized results against 'expected'. Every input row is
+     * an array [partition, value].
+     */
+    void runWindow(const BSONArray& input,
+                   StringData fn,
+                   boost::optional<int> lower,
+                   boost::optional<int> upper,
+                   const BSONArray& expected,
+                   bool allowDiskUse = false) {
+        auto ctx = makeCompileCtx();
+        auto [scanSlots, scanStage] = generateVirtualScanMulti(2, input);
+
+        auto frameSlots = makeSV(generateSlotId(), generateSlotId());
+        auto windowSlot = generateSlotId();
+        std::unique_ptr<EExpression> addExpr, removeExpr, finalizeExpr;
+        if (fn == "sum"_sd) {
+            addExpr = stage_builder::makeFunction("aggRemovableSumAdd",
+                                                  makeE<EVariable>(frameSlots[1]));
+            removeExpr = stage_builder::makeFunction("aggRemovableSumRemove",
+                                                     makeE<EVariable>(frameSlots[1]));
+            finalizeExpr =
+                stage_builder::makeFunction("removableSumFinalize", makeE<EVariable>(windowSlot));
+        } else {
+            addExpr = stage_builder::makeFunction("min", makeE<EVariable>(frameSlots[1]));
+            finalizeExpr = stage_builder::makeFunction("fillEmpty",
+                                                       makeE<EVariable>(windowSlot),
+                                                       makeE<EConstant>(value::TypeTags::Null, 0));
+        }
+
+        std::vector<WindowStage::Window> windows;
+        windows.emplace_back(windowSlot, std::move(addExpr), std::move(removeExpr), lower, upper);
+        auto windowStage = makeS<WindowStage>(std::move(scanStage),
+                                              scanSlots,
+                                              frameSlots,
+                                              1 /* partitionSlotCount */,
+                                              std::move(windows),
+                                              boost::none,
+                                              allowDiskUse,
+                                              kEmptyPlanNodeId);
+        _windowStage = windowStage.get();
+
+        auto outSlot = generateSlotId();
+        _stage = makeS<ProjectStage>(
+            std::move(windowStage), makeEM(outSlot, std::move(finalizeExpr)), kEmptyPlanNodeId);
+
+        auto resultAccessor = prepareTree(ctx.get(), _stage.get(), outSlot);
+        auto [resultsTag, resultsVal] = getAllResults(_stage.get(), resultAccessor);
+        value::ValueGuard resultsGuard{resultsTag, resultsVal};
+
+        auto [expectedTag, expectedVal] = stage_builder::makeValue(expected);
+        value::ValueGuard expectedGuard{expectedTag, expectedVal};
+        assertValuesEqual(resultsTag, resultsVal, expectedTag, expectedVal);
+    }
+
+    const WindowStats* getWindowStats() const {
+        return static_cast<const WindowStats*>(_windowStage->getSpecificStats());
+    }
+
+private:
+    std::unique_ptr<PlanStage> _stage;
+    PlanStage* _windowStage{nullptr};
+};
+
+TEST_F(WindowStageTest, SlidingSum) {
+    runWindow(BSON_ARRAY(BSON_ARRAY(1 << 1) << BSON_ARRAY(1 << 2) << BSON_ARRAY(1 << 3)
+                                            << BSON_ARRAY(1 << 4) << BSON_ARRAY(1 << 5)),
+              "sum",
+              -1,
+              1,
+              BSON_ARRAY(3 << 6 << 9 << 12 << 9));
+
+    // Only the rows of the current frame need to be buffered.
+    ASSERT_LTE(getWindowStats()->maxBufferedRows, 3);
+    ASSERT_FALSE(getWindowStats()->usedDisk);
+}
+
+TEST_F(WindowStageTest, SlidingSumIgnoresNonNumbersAndMixesTypes) {
+    runWindow(BSON_ARRAY(BSON_ARRAY(1 << 1) << BSON_ARRAY(1 << "a") << BSON_ARRAY(1 << 2.5)
+                                            << BSON_ARRAY(1 << 4LL) << BSON_ARRAY(1 << BSONNULL)),
+              "sum",
+              -1,
+              0,
+              BSON_ARRAY(1 << 1 << 2.5 << 6.5 << 4));
+}
+
+TEST_F(WindowStageTest, RunningSumRestartsForEveryPartition) {
+    runWindow(BSON_ARRAY(BSON_ARRAY("a" << 1) << BSON_ARRAY("a" << 2) << BSON_ARRAY("a" << 3)
+                                              << BSON_ARRAY("b" << 10) << BSON_ARRAY("b" << 20)),
+              "sum",
+              boost::none,
+              0,
+              BSON_ARRAY(1 << 3 << 6 << 10 << 30));
+}
+
+TEST_F(WindowStageTest, WholePartitionSum) {
+    runWindow(BSON_ARRAY(BSON_ARRAY("a" << 1) << BSON_ARRAY("a" << 2) << BSON_ARRAY("b" << 10)
+                                              << BSON_ARRAY("c" << 5) << BSON_ARRAY("c" << 6)),
+              "sum",
+              boost::none,
+              boost::none,
+              BSON_ARRAY(3 << 3 << 10 << 11 << 11));
+}
+
+TEST_F(WindowStageTest, EmptyFramesProduceDefaultValue) {
+    runWindow(BSON_ARRAY(BSON_ARRAY("a" << 1) << BSON_ARRAY("a" << 2) << BSON_ARRAY("b" << 3)),
+              "sum",
+              -3,
+              -2,
+              BSON_ARRAY(0 << 0 << 0));
+}
+
+TEST_F(WindowStageTest, SlidingMinIsRecomputedWithoutRemoveExpression) {
+    runWindow(BSON_ARRAY(BSON_ARRAY("a" << 3) << BSON_ARRAY("a" << 1) << BSON_ARRAY("a" << 4)
+                                              << BSON_ARRAY("a" << 5) << BSON_ARRAY("b" << 2)),
+              "min",
+              -1,
+              0,
+              BSON_ARRAY(3 << 1 << 1 << 4 << 2));
+}
+
+TEST_F(WindowStageTest, SlidingSumSpillsToDisk) {
+    // Keep only a single row in memory, so that the rows buffered while another row is in memory
+    // are spilled.
+    auto defaultMemoryLimit = internalQuerySBEWindowApproxMemoryUseInBytesBeforeSpill.load();
+    internalQuerySBEWindowApproxMemoryUseInBytesBeforeSpill.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalQuerySBEWindowApproxMemoryUseInBytesBeforeSpill.store(defaultMemoryLimit);
+    });
+
+    runWindow(BSON_ARRAY(BSON_ARRAY(1 << 1) << BSON_ARRAY(1 << 2) << BSON_ARRAY(1 << 3)
+                                            << BSON_ARRAY(1 << 4) << BSON_ARRAY(1 << 5)),
+              "sum",
+              -1,
+              1,
+              BSON_ARRAY(3 << 6 << 9 << 12 << 9),
+              true /* allowDiskUse */);
+
+    // The first row stays in memory and the next three are spilled. The first row leaves the
+    // frames before the last row is buffered, which therefore takes its place in memory.
+    ASSERT_TRUE(getWindowStats()->usedDisk);
+    ASSERT_EQ(3, getWindowStats()->spilledRecords);
+}
+
+TEST_F(WindowStageTest, SpillingFailsWithoutAllowDiskUse) {
+    auto defaultMemoryLimit = internalQuerySBEWindowApproxMemoryUseInBytesBeforeSpill.load();
+    internalQuerySBEWindowApproxMemoryUseInBytesBeforeSpill.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalQuerySBEWindowApproxMemoryUseInBytesBeforeSpill.store(defaultMemoryLimit);
+    });
+
+    ASSERT_THROWS_CODE(runWindow(BSON_ARRAY(BSON_ARRAY(1 << 1) << BSON_ARRAY(1 << 2)),
+                                 "sum",
+                                 boost::none,
+                                 boost::none,
+                                 BSON_ARRAY(3 << 3)),
+                       DBException,
+                       ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+}  // namespace mongo::sbe
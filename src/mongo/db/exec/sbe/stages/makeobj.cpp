@@ -46,7 +46,8 @@ MakeObjStageBase<O>::MakeObjStageBase(std::unique_ptr<PlanStage> input,
                                       value::SlotVector projectVars,
                                       bool forceNewObject,
                                       bool returnOldObject,
-                                      PlanNodeId planNodeId)
+                                      PlanNodeId planNodeId,
+                                      bool overwriteInPlace)
     : PlanStage(O == MakeObjOutputType::object ? "mkobj"_sd : "mkbson"_sd, planNodeId),
       _objSlot(objSlot),
       _rootSlot(rootSlot),
@@ -55,10 +56,12 @@ MakeObjStageBase<O>::MakeObjStageBase(std::unique_ptr<PlanStage> input,
       _projectFields(std::move(projectFields)),
       _projectVars(std::move(projectVars)),
       _forceNewObject(forceNewObject),
-      _returnOldObject(returnOldObject) {
+      _returnOldObject(returnOldObject),
+      _overwriteInPlace(overwriteInPlace) {
     _children.emplace_back(std::move(input));
     invariant(_projectVars.size() == _projectFields.size());
     invariant(static_cast<bool>(rootSlot) == static_cast<bool>(fieldBehavior));
+    invariant(!_overwriteInPlace || _fieldBehavior == FieldBehavior::drop);
 }
 
 template <MakeObjOutputType O>
@@ -72,7 +75,8 @@ std::unique_ptr<PlanStage> MakeObjStageBase<O>::clone() const {
                                                  _projectVars,
                                                  _forceNewObject,
                                                  _returnOldObject,
-                                                 _commonStats.nodeId);
+                                                 _commonStats.nodeId,
+                                                 _overwriteInPlace);
 }
 
 template <MakeObjOutputType O>
@@ -95,6 +99,7 @@ void MakeObjStageBase<O>::prepare(CompileCtx& ctx) {
         uassert(4822819, str::stream() << "duplicate field: " << p, inserted);
         _projects.emplace_back(p, _children[0]->getAccessor(ctx, _projectVars[idx]));
     }
+    _projectedInPlace.resize(_projects.size());
 
     _compiled = true;
 }
@@ -141,6 +146,7 @@ void MakeObjStageBase<MakeObjOutputType::object>::produceObject() {
     auto obj = value::getObjectView(val);
 
     _obj.reset(tag, val);
+    _projectedInPlace.assign(_projectedInPlace.size(), false);
 
     if (_root) {
         auto [tag, val] = _root->getViewOfValue();
@@ -177,6 +183,8 @@ void MakeObjStageBase<MakeObjOutputType::object>::produceObject() {
                         auto [copyTag, copyVal] = value::copyValue(tag, val);
                         obj->push_back(sv, copyTag, copyVal);
                         --nFieldsNeededIfInclusion;
+                    } else {
+                        projectFieldInPlace(obj, key);
                     }
 
                     if (nFieldsNeededIfInclusion == 0 && _fieldBehavior == FieldBehavior::keep) {
@@ -202,6 +210,8 @@ void MakeObjStageBase<MakeObjOutputType::object>::produceObject() {
                         auto [copyTag, copyVal] = value::copyValue(tag, val);
                         obj->push_back(sv, copyTag, copyVal);
                         --nFieldsNeededIfInclusion;
+                    } else {
+                        projectFieldInPlace(obj, key);
                     }
 
                     if (nFieldsNeededIfInclusion == 0 && _fieldBehavior == FieldBehavior::keep) {
@@ -227,9 +237,7 @@ void MakeObjStageBase<MakeObjOutputType::object>::produceObject() {
             return;
         }
     }
-    for (size_t idx = 0; idx < _projects.size(); ++idx) {
-        projectField(obj, idx);
-    }
+    projectRemainingFields(obj);
 }
 
 template <>
@@ -241,6 +249,7 @@ void MakeObjStageBase<MakeObjOutputType::bsonObject>::produceObject() {
         char* data = bob.bb().release().release();
         _obj.reset(value::TypeTags::bsonObject, value::bitcastFrom<char*>(data));
     };
+    _projectedInPlace.assign(_projectedInPlace.size(), false);
 
     if (_root) {
         auto [tag, val] = _root->getViewOfValue();
@@ -260,6 +269,8 @@ void MakeObjStageBase<MakeObjOutputType::bsonObject>::produceObject() {
                     if (!isFieldProjectedOrRestricted(key)) {
                         bob.append(BSONElement(be, sv.size() + 1, nextBe - be));
                         --nFieldsNeededIfInclusion;
+                    } else {
+                        projectFieldInPlace(&bob, key);
                     }
 
                     if (nFieldsNeededIfInclusion == 0 && _fieldBehavior == FieldBehavior::keep) {
@@ -279,6 +290,8 @@ void MakeObjStageBase<MakeObjOutputType::bsonObject>::produceObject() {
                         auto [tag, val] = objRoot->getAt(idx);
                         bson::appendValueToBsonObj(bob, objRoot->field(idx), tag, val);
                         --nFieldsNeededIfInclusion;
+                    } else {
+                        projectFieldInPlace(&bob, key);
                     }
 
                     if (nFieldsNeededIfInclusion == 0 && _fieldBehavior == FieldBehavior::keep) {
@@ -306,9 +319,7 @@ void MakeObjStageBase<MakeObjOutputType::bsonObject>::produceObject() {
             return;
         }
     }
-    for (size_t idx = 0; idx < _projects.size(); ++idx) {
-        projectField(&bob, idx);
-    }
+    projectRemainingFields(&bob);
     finish();
 }
 
@@ -353,6 +364,7 @@ std::unique_ptr<PlanStageStats> MakeObjStageBase<O>::getStats(bool includeDebugI
         bob.append("projectSlots", _projectVars.begin(), _projectVars.end());
         bob.append("forceNewObject", _forceNewObject);
         bob.append("returnOldObject", _returnOldObject);
+        bob.append("overwriteInPlace", _overwriteInPlace);
         ret->debugInfo = bob.obj();
     }
 
@@ -385,6 +397,9 @@ std::vector<DebugPrinter::Block> MakeObjStageBase<O>::debugPrint() const {
         ret.emplace_back(DebugPrinter::Block("`]"));
 
         ret.emplace_back(*_fieldBehavior == FieldBehavior::drop ? "drop" : "keep");
+        if (_overwriteInPlace) {
+            ret.emplace_back("inplace");
+        }
     }
 
     ret.emplace_back(DebugPrinter::Block("[`"));
@@ -45,11 +45,11 @@ enum class MakeObjOutputType { object, bsonObject };
  *
  * Debug string formats:
  *
- *  mkobj objSlot (rootSlot [<list of field names>] drop|keep)?
+ *  mkobj objSlot (rootSlot [<list of field names>] drop|keep inplace?)?
  *       [projectedField_1 = slot_1, ..., projectedField_n = slot_n]
  *       forceNewObj returnOldObject childStage
  *
- *  mkbson objSlot (rootSlot [<list of field names>] drop|keep)?
+ *  mkbson objSlot (rootSlot [<list of field names>] drop|keep inplace?)?
  *       [projectedField_1 = slot_1, ..., projectedField_n = slot_n]
  *       forceNewObj returnOldObject childStage
  */
@@ -77,6 +77,12 @@ public:
      * 'rootSlot' unmodified.
      *
      * -planNodeId: Mapping to the corresponding QuerySolutionNode.
+     *
+     * -overwriteInPlace: May only be set when 'fieldBehavior' is "drop". By default, the projected
+     * fields are added after the fields of the object in 'rootSlot', including those which replace
+     * a field of that object. When set, a projected field which replaces a field of the object in
+     * 'rootSlot' takes its position instead, as setting a field of a document does in the classic
+     * engine.
      */
     MakeObjStageBase(std::unique_ptr<PlanStage> input,
                      value::SlotId objSlot,
@@ -87,7 +93,8 @@ public:
                      value::SlotVector projectVars,
                      bool forceNewObject,
                      bool returnOldObject,
-                     PlanNodeId planNodeId);
+                     PlanNodeId planNodeId,
+                     bool overwriteInPlace = false);
 
     std::unique_ptr<PlanStage> clone() const final;
 
@@ -109,6 +116,34 @@ private:
     void projectField(value::Object* obj, size_t idx);
     void projectField(UniqueBSONObjBuilder* bob, size_t idx);
 
+    /**
+     * Projects the field named 'key' of the root object at its current position in 'out', if
+     * overwriting in place and 'key' is one of the projected fields.
+     */
+    template <typename Out>
+    void projectFieldInPlace(Out* out, const StringMapHashedKey& key) {
+        if (!_overwriteInPlace) {
+            return;
+        }
+        if (auto it = _allFieldsMap.find(key); it != _allFieldsMap.end() &&
+            it->second != std::numeric_limits<size_t>::max() && !_projectedInPlace[it->second]) {
+            projectField(out, it->second);
+            _projectedInPlace[it->second] = true;
+        }
+    }
+
+    /**
+     * Projects the fields which have not been projected in place while copying the root object.
+     */
+    template <typename Out>
+    void projectRemainingFields(Out* out) {
+        for (size_t idx = 0; idx < _projects.size(); ++idx) {
+            if (!_overwriteInPlace || !_projectedInPlace[idx]) {
+                projectField(out, idx);
+            }
+        }
+    }
+
     bool isFieldProjectedOrRestricted(const StringMapHashedKey& key) const {
         bool foundKey = false;
         bool projected = false;
@@ -138,9 +173,14 @@ private:
     const value::SlotVector _projectVars;
     const bool _forceNewObject;
     const bool _returnOldObject;
+    const bool _overwriteInPlace;
 
     StringMap<size_t> _allFieldsMap;
 
+    // Whether each projected field has already been projected in place into the object being
+    // produced.
+    std::vector<bool> _projectedInPlace;
+
     std::vector<std::pair<std::string, value::SlotAccessor*>> _projects;
 
     value::OwnedValueAccessor _obj;
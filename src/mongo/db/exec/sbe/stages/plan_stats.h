@@ -282,6 +282,28 @@ struct HashAggStats : public SpecificStats {
     long long lastSpilledRecordSize{0};
 };
 
+struct WindowStats : public SpecificStats {
+    std::unique_ptr<SpecificStats> clone() const final {
+        return std::make_unique<WindowStats>(*this);
+    }
+
+    uint64_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
+    void acceptVisitor(PlanStatsConstVisitor* visitor) const final {
+        visitor->visit(this);
+    }
+
+    void acceptVisitor(PlanStatsMutableVisitor* visitor) final {
+        visitor->visit(this);
+    }
+
+    bool usedDisk{false};
+    long long spilledRecords{0};
+    long long maxBufferedRows{0};
+};
+
 /**
  * Visitor for calculating the number of storage reads during plan execution.
  */
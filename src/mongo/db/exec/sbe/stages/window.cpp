@@ -0,0 +1,514 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/stages/window.h"
+
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/util/str.h"
+
+namespace mongo::sbe {
+WindowStage::WindowStage(std::unique_ptr<PlanStage> input,
+                         value::SlotVector currSlots,
+                         value::SlotVector frameSlots,
+                         size_t partitionSlotCount,
+                         std::vector<Window> windows,
+                         boost::optional<value::SlotId> collatorSlot,
+                         bool allowDiskUse,
+                         PlanNodeId planNodeId)
+    : PlanStage("window"_sd, planNodeId),
+      _currSlots(std::move(currSlots)),
+      _frameSlots(std::move(frameSlots)),
+      _partitionSlotCount(partitionSlotCount),
+      _windows(std::move(windows)),
+      _collatorSlot(collatorSlot),
+      _allowDiskUse(allowDiskUse) {
+    _children.emplace_back(std::move(input));
+    tassert(6440112,
+            "Window stage must be given a frame slot for every current slot",
+            _currSlots.size() == _frameSlots.size());
+    tassert(6440113,
+            "Window stage partition key must be a prefix of the current slots",
+            _partitionSlotCount <= _currSlots.size());
+}
+
+std::unique_ptr<PlanStage> WindowStage::clone() const {
+    std::vector<Window> windows;
+    windows.reserve(_windows.size());
+    for (auto& window : _windows) {
+        windows.emplace_back(window.clone());
+    }
+    return std::make_unique<WindowStage>(_children[0]->clone(),
+                                         _currSlots,
+                                         _frameSlots,
+                                         _partitionSlotCount,
+                                         std::move(windows),
+                                         _collatorSlot,
+                                         _allowDiskUse,
+                                         _commonStats.nodeId);
+}
+
+void WindowStage::prepare(CompileCtx& ctx) {
+    _children[0]->prepare(ctx);
+
+    if (_collatorSlot) {
+        _collatorAccessor = getAccessor(ctx, *_collatorSlot);
+        tassert(6440114,
+                "collator accessor should exist if collator slot provided to WindowStage",
+                _collatorAccessor != nullptr);
+    }
+
+    value::SlotSet dupCheck;
+    auto checkDup = [&](value::SlotId slot) {
+        auto [_, inserted] = dupCheck.emplace(slot);
+        uassert(6440115, str::stream() << "duplicate field: " << slot, inserted);
+    };
+
+    for (size_t idx = 0; idx < _currSlots.size(); ++idx) {
+        checkDup(_currSlots[idx]);
+        checkDup(_frameSlots[idx]);
+
+        _inCurrAccessors.emplace_back(_children[0]->getAccessor(ctx, _currSlots[idx]));
+
+        // Both the current row and the row entering or leaving a frame are views into the buffer.
+        _outCurrAccessors.emplace_back(std::make_unique<BufferedRowAccessor>(_currRow, idx));
+        _outAccessors[_currSlots[idx]] = _outCurrAccessors.back().get();
+        _outFrameAccessors.emplace_back(std::make_unique<BufferedRowAccessor>(_frameRow, idx));
+        _outAccessors[_frameSlots[idx]] = _outFrameAccessors.back().get();
+    }
+
+    for (auto& window : _windows) {
+        checkDup(window.windowSlot);
+        _windowAccessors.emplace_back(std::make_unique<value::OwnedValueAccessor>());
+        _outAccessors[window.windowSlot] = _windowAccessors.back().get();
+    }
+
+    // The frame slots resolve to this stage's accessors while compiling the window expressions.
+    _compiled = true;
+    for (size_t idx = 0; idx < _windows.size(); ++idx) {
+        ctx.root = this;
+        ctx.aggExpression = true;
+        ctx.accumulator = _windowAccessors[idx].get();
+
+        _addCodes.emplace_back(_windows[idx].addExpr->compile(ctx));
+        _removeCodes.emplace_back(_windows[idx].removeExpr
+                                      ? _windows[idx].removeExpr->compile(ctx)
+                                      : nullptr);
+        ctx.aggExpression = false;
+    }
+    _frames.resize(_windows.size());
+}
+
+value::SlotAccessor* WindowStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
+    if (_compiled) {
+        if (auto it = _outAccessors.find(slot); it != _outAccessors.end()) {
+            return it->second;
+        }
+    } else {
+        return _children[0]->getAccessor(ctx, slot);
+    }
+
+    return ctx.getAccessor(slot);
+}
+
+namespace {
+// Proactively assert that this operation can safely write before hitting an assertion in the
+// storage engine. We can safely write if we are enforcing prepare conflicts by blocking or if we
+// are ignoring prepare conflicts and explicitly allowing writes. Ignoring prepare conflicts
+// without allowing writes will cause this operation to fail in the storage engine.
+void assertIgnorePrepareConflictsBehavior(OperationContext* opCtx) {
+    tassert(6440116,
+            "The operation must be ignoring conflicts and allowing writes or enforcing prepare "
+            "conflicts entirely",
+            opCtx->recoveryUnit()->getPrepareConflictBehavior() !=
+                PrepareConflictBehavior::kIgnoreConflicts);
+}
+}  // namespace
+
+void WindowStage::makeTemporaryRecordStore() {
+    tassert(
+        6440117,
+        "WindowStage attempted to write to disk in an environment which is not prepared to do so",
+        _opCtx->getServiceContext());
+    tassert(6440118,
+            "No storage engine so WindowStage cannot spill to disk",
+            _opCtx->getServiceContext()->getStorageEngine());
+    assertIgnorePrepareConflictsBehavior(_opCtx);
+    _recordStore = _opCtx->getServiceContext()->getStorageEngine()->makeTemporaryRecordStore(
+        _opCtx, KeyFormat::Long);
+
+    _specificStats.usedDisk = true;
+}
+
+void WindowStage::spillRowToDisk(int64_t id, const value::MaterializedRow& row) {
+    BufBuilder buf;
+    row.serializeForSorter(buf);
+
+    assertIgnorePrepareConflictsBehavior(_opCtx);
+
+    // Take a dummy lock to avoid tripping invariants in the storage layer. This is a noop because
+    // we aren't writing to a collection, just a temporary record store that only this stage will
+    // touch. Row ids start at zero, so they are shifted by one to be valid record ids.
+    Lock::GlobalLock lk(_opCtx, MODE_IX);
+    WriteUnitOfWork wuow(_opCtx);
+    auto status = _recordStore->rs()->insertRecord(
+        _opCtx, RecordId(id + 1), buf.buf(), buf.len(), Timestamp{});
+    wuow.commit();
+    tassert(6440119,
+            str::stream() << "Failed to write to disk because " << status.getStatus().reason(),
+            status.isOK());
+
+    _specificStats.spilledRecords++;
+}
+
+void WindowStage::loadRow(int64_t id,
+                          const value::MaterializedRow*& row,
+                          value::MaterializedRow& diskRow) {
+    tassert(6440120,
+            str::stream() << "Window stage row " << id << " is not buffered",
+            id >= _bufferFirstId && id < _nextId);
+
+    if (const auto& bufferedRow = _rows[id - _bufferFirstId]) {
+        row = &*bufferedRow;
+        return;
+    }
+
+    Lock::GlobalLock lk(_opCtx, MODE_IS);
+    RecordData record;
+    auto found = _recordStore->rs()->findRecord(_opCtx, RecordId(id + 1), &record);
+    tassert(6440121, str::stream() << "Window stage row " << id << " was not spilled", found);
+    BufReader reader(record.data(), record.size());
+    diskRow = value::MaterializedRow::deserializeForSorter(reader, {});
+    row = &diskRow;
+}
+
+void WindowStage::appendRow(value::MaterializedRow row) {
+    // Only the rows which do not fit within the memory limit are spilled. The memory released by
+    // evicting rows is reused for the following rows, even if earlier rows have been spilled.
+    if (_bufferedMemory < _approxMemoryUseInBytesBeforeSpill) {
+        _bufferedMemory += row.memUsageForSorter();
+        _rows.emplace_back(std::move(row));
+    } else {
+        uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+                "Exceeded memory limit for $setWindowFields, but didn't allow external spilling."
+                " Pass allowDiskUse:true to opt in.",
+                _allowDiskUse);
+        if (!_recordStore) {
+            makeTemporaryRecordStore();
+        }
+        spillRowToDisk(_nextId, row);
+        _rows.emplace_back(boost::none);
+    }
+
+    ++_nextId;
+    _specificStats.maxBufferedRows =
+        std::max<long long>(_specificStats.maxBufferedRows, _nextId - _bufferFirstId);
+}
+
+void WindowStage::evictRows(int64_t keepFromId) {
+    for (keepFromId = std::min(keepFromId, _nextId); _bufferFirstId < keepFromId;
+         ++_bufferFirstId) {
+        // Spilled rows are simply left behind in the record store.
+        if (const auto& row = _rows.front()) {
+            _bufferedMemory -= row->memUsageForSorter();
+        }
+        _rows.pop_front();
+    }
+}
+
+bool WindowStage::fetchNextRow() {
+    if (_partitionEnded) {
+        return false;
+    }
+
+    value::MaterializedRow row{0};
+    if (_nextPartitionRow) {
+        row = std::move(*_nextPartitionRow);
+        _nextPartitionRow = boost::none;
+    } else if (_children[0]->getNext() == PlanState::ADVANCED) {
+        row.resize(_inCurrAccessors.size());
+        size_t idx = 0;
+        for (auto accessor : _inCurrAccessors) {
+            auto [tag, val] = accessor->getViewOfValue();
+            row.reset(idx++, false, tag, val);
+        }
+        row.makeOwned();
+
+        if (_nextId != _partitionStartId &&
+            !value::MaterializedRowEq{_collator}(_partitionKey, row)) {
+            // This row starts the next partition, hold it back until the current one is done.
+            _nextPartitionRow = std::move(row);
+            _partitionEnded = true;
+            return false;
+        }
+    } else {
+        _partitionEnded = true;
+        return false;
+    }
+
+    if (_nextId == _partitionStartId) {
+        _partitionKey.resize(_partitionSlotCount);
+        for (size_t idx = 0; idx < _partitionSlotCount; ++idx) {
+            auto [tag, val] = row.getViewOfValue(idx);
+            _partitionKey.reset(idx, false, tag, val);
+        }
+        _partitionKey.makeOwned();
+    }
+
+    appendRow(std::move(row));
+    return true;
+}
+
+void WindowStage::startNextPartition() {
+    evictRows(_nextId);
+    _partitionStartId = _nextId;
+    _partitionEnded = false;
+    for (size_t idx = 0; idx < _windows.size(); ++idx) {
+        resetWindow(idx);
+        _frames[idx] = Frame{_partitionStartId, _partitionStartId};
+    }
+}
+
+void WindowStage::resetWindow(size_t idx) {
+    _windowAccessors[idx]->reset();
+}
+
+void WindowStage::runWindowCode(size_t idx, vm::CodeFragment* code, int64_t fromId, int64_t toId) {
+    for (auto id = fromId; id < toId; ++id) {
+        loadRow(id, _frameRow, _frameDiskRow);
+        auto [owned, tag, val] = _bytecode.run(code);
+        _windowAccessors[idx]->reset(owned, tag, val);
+    }
+}
+
+void WindowStage::updateWindow(size_t idx) {
+    const auto& window = _windows[idx];
+    auto& frame = _frames[idx];
+
+    // Compute the frame of the current row, clamped to the rows of the partition.
+    auto lo = window.lowerBound ? std::max(_partitionStartId, _currId + *window.lowerBound)
+                                : _partitionStartId;
+    auto hi = window.upperBound ? _currId + *window.upperBound + 1
+                                : std::numeric_limits<int64_t>::max();
+    while (_nextId < hi && fetchNextRow()) {
+    }
+    hi = std::min(hi, _nextId);
+
+    if (lo >= hi) {
+        resetWindow(idx);
+        frame = Frame{lo, lo};
+        return;
+    }
+
+    // Both ends of a document-based frame only ever move forward. The state is carried over from
+    // the previous frame when the frames overlap and the rows that fell out of the frame can be
+    // removed, otherwise it is rebuilt from scratch.
+    if (frame.lo == frame.hi || lo >= frame.hi || (lo > frame.lo && !window.removeExpr)) {
+        resetWindow(idx);
+        runWindowCode(idx, _addCodes[idx].get(), lo, hi);
+    } else {
+        runWindowCode(idx, _removeCodes[idx].get(), frame.lo, lo);
+        runWindowCode(idx, _addCodes[idx].get(), frame.hi, hi);
+    }
+    frame = Frame{lo, hi};
+}
+
+void WindowStage::open(bool reOpen) {
+    auto optTimer(getOptTimer(_opCtx));
+
+    _commonStats.opens++;
+    _children[0]->open(reOpen);
+
+    if (_collatorAccessor) {
+        auto [tag, collatorVal] = _collatorAccessor->getViewOfValue();
+        uassert(
+            6440122, "collatorSlot must be of collator type", tag == value::TypeTags::collator);
+        _collator = value::getCollatorView(collatorVal);
+    }
+
+    _rows.clear();
+    _bufferedMemory = 0;
+    _bufferFirstId = 0;
+    _nextId = 0;
+    _currId = -1;
+    _nextPartitionRow = boost::none;
+    _recordStore.reset();
+    startNextPartition();
+}
+
+PlanState WindowStage::getNext() {
+    auto optTimer(getOptTimer(_opCtx));
+
+    // Release the rows that neither the next row nor the frames moving along with it can reach.
+    const auto nextId = _currId + 1;
+    auto keepFromId = nextId;
+    for (size_t idx = 0; idx < _windows.size(); ++idx) {
+        keepFromId = std::min(keepFromId,
+                              _windows[idx].lowerBound ? _frames[idx].lo : _frames[idx].hi);
+    }
+    evictRows(keepFromId);
+
+    if (nextId == _nextId && !fetchNextRow()) {
+        if (!_nextPartitionRow) {
+            return trackPlanState(PlanState::IS_EOF);
+        }
+        startNextPartition();
+        fetchNextRow();
+    }
+
+    _currId = nextId;
+    for (size_t idx = 0; idx < _windows.size(); ++idx) {
+        updateWindow(idx);
+    }
+    loadRow(_currId, _currRow, _currDiskRow);
+
+    return trackPlanState(PlanState::ADVANCED);
+}
+
+void WindowStage::close() {
+    auto optTimer(getOptTimer(_opCtx));
+
+    trackClose();
+    _children[0]->close();
+
+    _rows.clear();
+    _nextPartitionRow = boost::none;
+    for (size_t idx = 0; idx < _windows.size(); ++idx) {
+        resetWindow(idx);
+    }
+    _recordStore.reset();
+}
+
+std::unique_ptr<PlanStageStats> WindowStage::getStats(bool includeDebugInfo) const {
+    auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->specific = std::make_unique<WindowStats>(_specificStats);
+
+    if (includeDebugInfo) {
+        DebugPrinter printer;
+        BSONObjBuilder bob;
+        bob.append("currSlots", _currSlots.begin(), _currSlots.end());
+        bob.appendNumber("partitionSlotCount", static_cast<long long>(_partitionSlotCount));
+        {
+            BSONObjBuilder windowsBob(bob.subobjStart("windows"));
+            for (auto&& window : _windows) {
+                BSONObjBuilder windowBob(windowsBob.subobjStart(str::stream()
+                                                                << window.windowSlot));
+                windowBob.append("add", printer.print(window.addExpr->debugPrint()));
+                if (window.removeExpr) {
+                    windowBob.append("remove", printer.print(window.removeExpr->debugPrint()));
+                }
+            }
+        }
+        bob.appendBool("usedDisk", _specificStats.usedDisk);
+        bob.appendNumber("spilledRecords", _specificStats.spilledRecords);
+        bob.appendNumber("maxBufferedRows", _specificStats.maxBufferedRows);
+
+        ret->debugInfo = bob.obj();
+    }
+
+    ret->children.emplace_back(_children[0]->getStats(includeDebugInfo));
+    return ret;
+}
+
+const SpecificStats* WindowStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+std::vector<DebugPrinter::Block> WindowStage::debugPrint() const {
+    auto ret = PlanStage::debugPrint();
+
+    auto printSlots = [&ret](const value::SlotVector& slots) {
+        ret.emplace_back(DebugPrinter::Block("[`"));
+        for (size_t idx = 0; idx < slots.size(); ++idx) {
+            if (idx) {
+                ret.emplace_back(DebugPrinter::Block("`,"));
+            }
+            DebugPrinter::addIdentifier(ret, slots[idx]);
+        }
+        ret.emplace_back(DebugPrinter::Block("`]"));
+    };
+    auto printBound = [&ret](const boost::optional<int>& bound) {
+        ret.emplace_back(bound ? std::to_string(*bound) : std::string{"unbounded"});
+    };
+
+    printSlots(_currSlots);
+    printSlots(_frameSlots);
+    ret.emplace_back(std::to_string(_partitionSlotCount));
+
+    ret.emplace_back(DebugPrinter::Block("[`"));
+    for (size_t idx = 0; idx < _windows.size(); ++idx) {
+        if (idx) {
+            ret.emplace_back(DebugPrinter::Block("`,"));
+        }
+        const auto& window = _windows[idx];
+        DebugPrinter::addIdentifier(ret, window.windowSlot);
+        ret.emplace_back("=");
+        ret.emplace_back(DebugPrinter::Block("[`"));
+        DebugPrinter::addBlocks(ret, window.addExpr->debugPrint());
+        if (window.removeExpr) {
+            ret.emplace_back(DebugPrinter::Block("`,"));
+            DebugPrinter::addBlocks(ret, window.removeExpr->debugPrint());
+        }
+        ret.emplace_back(DebugPrinter::Block("`]"));
+        ret.emplace_back(DebugPrinter::Block("[`"));
+        printBound(window.lowerBound);
+        ret.emplace_back(DebugPrinter::Block("`,"));
+        printBound(window.upperBound);
+        ret.emplace_back(DebugPrinter::Block("`]"));
+    }
+    ret.emplace_back(DebugPrinter::Block("`]"));
+
+    if (_collatorSlot) {
+        DebugPrinter::addIdentifier(ret, *_collatorSlot);
+    }
+
+    DebugPrinter::addNewLine(ret);
+    DebugPrinter::addBlocks(ret, _children[0]->debugPrint());
+
+    return ret;
+}
+
+size_t WindowStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_currSlots);
+    size += size_estimator::estimate(_frameSlots);
+    for (auto&& window : _windows) {
+        size += size_estimator::estimate(window.addExpr);
+        if (window.removeExpr) {
+            size += size_estimator::estimate(window.removeExpr);
+        }
+    }
+    return size;
+}
+}  // namespace mongo::sbe
@@ -0,0 +1,239 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/stages/stages.h"
+#include "mongo/db/exec/sbe/vm/vm.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/temporary_record_store.h"
+
+namespace mongo::sbe {
+/**
+ * Computes window functions over the rows of its input, which must already be sorted by the
+ * partition key (and by the window's sort order, if any). Appears as the "window" stage in debug
+ * output.
+ *
+ * Each input row is described by the 'currSlots'. The first 'partitionSlotCount' of them form the
+ * partition key: a row whose partition key differs from the previous row's starts a new
+ * partition, and window frames never cross a partition boundary.
+ *
+ * Every window is defined by a document-based frame, '[lowerBound, upperBound]', relative to the
+ * position of the current row (an unset bound is unbounded), and a pair of aggregate expressions.
+ * 'addExpr' folds a row entering the frame into the window's accumulator state, and 'removeExpr'
+ * (if present) takes a row leaving the frame back out of it. Both expressions read the row being
+ * added or removed through the 'frameSlots', which mirror 'currSlots' one to one. As the frame
+ * slides, the state is updated incrementally when the window is removable, otherwise it is
+ * recomputed from the rows of the new frame. The accumulator state of every window is produced in
+ * its 'windowSlot' and is expected to be finalized by a stage above.
+ *
+ * Rows are buffered only as long as they can still enter or leave a frame, so a stream of rows is
+ * processed with memory bounded by the frame sizes. Unbounded upper bounds require buffering the
+ * whole partition; a row which does not fit within the memory limit when it is buffered is spilled
+ * to a temporary record store if 'allowDiskUse' is set, while the other rows stay in memory.
+ *
+ * This stage is a "binding reflector": only the 'currSlots' (holding the values of the current
+ * row) and the window slots are visible higher in the tree.
+ *
+ * The optional 'collatorSlot', if provided, changes the definition of string equality used when
+ * comparing partition keys.
+ *
+ * Debug string representation:
+ *
+ *  window [<current slots>] [<frame slots>] partitionSlotCount
+ *      [slot_1 = [addExpr_1, removeExpr_1?] [lower_1, upper_1], ...] collatorSlot? childStage
+ */
+class WindowStage final : public PlanStage {
+public:
+    struct Window {
+        Window(value::SlotId windowSlot,
+               std::unique_ptr<EExpression> addExpr,
+               std::unique_ptr<EExpression> removeExpr,
+               boost::optional<int> lowerBound,
+               boost::optional<int> upperBound)
+            : windowSlot(windowSlot),
+              addExpr(std::move(addExpr)),
+              removeExpr(std::move(removeExpr)),
+              lowerBound(lowerBound),
+              upperBound(upperBound) {}
+
+        Window clone() const {
+            return Window{windowSlot,
+                          addExpr->clone(),
+                          removeExpr ? removeExpr->clone() : nullptr,
+                          lowerBound,
+                          upperBound};
+        }
+
+        value::SlotId windowSlot;
+        std::unique_ptr<EExpression> addExpr;
+        std::unique_ptr<EExpression> removeExpr;
+        boost::optional<int> lowerBound;
+        boost::optional<int> upperBound;
+    };
+
+    WindowStage(std::unique_ptr<PlanStage> input,
+                value::SlotVector currSlots,
+                value::SlotVector frameSlots,
+                size_t partitionSlotCount,
+                std::vector<Window> windows,
+                boost::optional<value::SlotId> collatorSlot,
+                bool allowDiskUse,
+                PlanNodeId planNodeId);
+
+    std::unique_ptr<PlanStage> clone() const final;
+
+    void prepare(CompileCtx& ctx) final;
+    value::SlotAccessor* getAccessor(CompileCtx& ctx, value::SlotId slot) final;
+    void open(bool reOpen) final;
+    PlanState getNext() final;
+    void close() final;
+
+    std::unique_ptr<PlanStageStats> getStats(bool includeDebugInfo) const final;
+    const SpecificStats* getSpecificStats() const final;
+    std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
+
+private:
+    /**
+     * Gives a view of one value of a buffered row. The row is shared with the frames of other rows,
+     * so values are never moved out of it.
+     */
+    class BufferedRowAccessor final : public value::SlotAccessor {
+    public:
+        BufferedRowAccessor(const value::MaterializedRow* const& row, size_t slot)
+            : _row(row), _slot(slot) {}
+
+        std::pair<value::TypeTags, value::Value> getViewOfValue() const override {
+            return _row->getViewOfValue(_slot);
+        }
+        std::pair<value::TypeTags, value::Value> copyOrMoveValue() override {
+            auto [tag, val] = getViewOfValue();
+            return value::copyValue(tag, val);
+        }
+
+    private:
+        const value::MaterializedRow* const& _row;
+        const size_t _slot;
+    };
+
+    // A window frame covering the rows with ids in '[lo, hi)'.
+    struct Frame {
+        int64_t lo{0};
+        int64_t hi{0};
+    };
+
+    /**
+     * Reads the next row of the current partition into the buffer. Returns false when the
+     * partition has no more rows, in which case the first row of the next partition (if any) is
+     * held back in '_nextPartitionRow'.
+     */
+    bool fetchNextRow();
+    void appendRow(value::MaterializedRow row);
+    void startNextPartition();
+
+    /**
+     * Drops the buffered rows whose ids precede 'keepFromId'.
+     */
+    void evictRows(int64_t keepFromId);
+
+    /**
+     * Points 'row' at the buffered row with the given id, reading it from the record store into
+     * 'diskRow' if it has been spilled.
+     */
+    void loadRow(int64_t id, const value::MaterializedRow*& row, value::MaterializedRow& diskRow);
+
+    /**
+     * Moves the frame of the window at 'idx' to the current row, adding and removing rows to and
+     * from its accumulator state.
+     */
+    void updateWindow(size_t idx);
+    void resetWindow(size_t idx);
+    void runWindowCode(size_t idx, vm::CodeFragment* code, int64_t fromId, int64_t toId);
+
+    void makeTemporaryRecordStore();
+    void spillRowToDisk(int64_t id, const value::MaterializedRow& row);
+
+    const value::SlotVector _currSlots;
+    const value::SlotVector _frameSlots;
+    const size_t _partitionSlotCount;
+    const std::vector<Window> _windows;
+    const boost::optional<value::SlotId> _collatorSlot;
+    const bool _allowDiskUse;
+
+    std::vector<value::SlotAccessor*> _inCurrAccessors;
+    value::SlotAccessorMap _outAccessors;
+
+    // The buffered rows, holding the ids in '[_bufferFirstId, _nextId)'. A row which has been
+    // spilled to '_recordStore' is left unset.
+    std::deque<boost::optional<value::MaterializedRow>> _rows;
+    int64_t _bufferFirstId{0};
+    int64_t _nextId{0};
+    long long _bufferedMemory{0};
+
+    // The row to be returned and the row being added to or removed from a frame, along with the
+    // storage for either of them when it is read back from '_recordStore'.
+    const value::MaterializedRow* _currRow{nullptr};
+    const value::MaterializedRow* _frameRow{nullptr};
+    value::MaterializedRow _currDiskRow;
+    value::MaterializedRow _frameDiskRow;
+    std::vector<std::unique_ptr<BufferedRowAccessor>> _outCurrAccessors;
+    std::vector<std::unique_ptr<BufferedRowAccessor>> _outFrameAccessors;
+
+    std::vector<std::unique_ptr<value::OwnedValueAccessor>> _windowAccessors;
+    std::vector<std::unique_ptr<vm::CodeFragment>> _addCodes;
+    std::vector<std::unique_ptr<vm::CodeFragment>> _removeCodes;
+    std::vector<Frame> _frames;
+
+    int64_t _currId{-1};
+    int64_t _partitionStartId{0};
+    value::MaterializedRow _partitionKey;
+    boost::optional<value::MaterializedRow> _nextPartitionRow;
+    bool _partitionEnded{false};
+
+    // Only set if collator slot provided on construction.
+    value::SlotAccessor* _collatorAccessor = nullptr;
+    CollatorInterface* _collator = nullptr;
+
+    vm::ByteCode _bytecode;
+
+    bool _compiled{false};
+
+    // Memory tracking and spilling to disk.
+    const long long _approxMemoryUseInBytesBeforeSpill =
+        internalQuerySBEWindowApproxMemoryUseInBytesBeforeSpill.load();
+    std::unique_ptr<TemporaryRecordStore> _recordStore;
+
+    WindowStats _specificStats;
+};
+}  // namespace mongo::sbe
@@ -74,6 +74,18 @@ std::pair<TypeTags, Value> makeNewBsonRegex(StringData pattern, StringData flags
     return {TypeTags::bsonRegex, bitcastFrom<char*>(buffer.release())};
 }
 
+std::pair<TypeTags, Value> makeNewBsonBinData(BinDataType subtype, size_t size) {
+    auto totalSize = sizeof(uint32_t) + 1 + size;
+    auto buffer = std::make_unique<char[]>(totalSize);
+    auto rawBuffer = buffer.get();
+
+    // BinData is laid out like its BSON counterpart: length, subtype and then the payload.
+    DataView(rawBuffer).write<LittleEndian<uint32_t>>(size);
+    rawBuffer[sizeof(uint32_t)] = static_cast<char>(subtype);
+    memset(rawBuffer + sizeof(uint32_t) + 1, 0, size);
+    return {TypeTags::bsonBinData, bitcastFrom<char*>(buffer.release())};
+}
+
 std::pair<TypeTags, Value> makeCopyBsonJavascript(StringData code) {
     auto [_, strVal] = makeBigString(code);
     return {TypeTags::bsonJavascript, strVal};
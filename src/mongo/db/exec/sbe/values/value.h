@@ -1086,6 +1086,11 @@ inline uint8_t* getBSONBinDataCompat(TypeTags tag, Value val) {
     }
 }
 
+/**
+ * Allocates a new BinData value of the given subtype with a zero-filled payload of 'size' bytes.
+ */
+std::pair<TypeTags, Value> makeNewBsonBinData(BinDataType subtype, size_t size);
+
 inline RecordId* getRecordIdView(Value val) noexcept {
     return reinterpret_cast<RecordId*>(val);
 }
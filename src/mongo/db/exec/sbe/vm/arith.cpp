@@ -502,6 +502,87 @@ void ByteCode::aggDoubleDoubleSumImpl(value::Array* arr,
     }
 }
 
+void ByteCode::aggRemovableSumImpl(value::Array* arr,
+                                   value::TypeTags rhsTag,
+                                   value::Value rhsValue,
+                                   int quantity) {
+    if (!isNumber(rhsTag)) {
+        return;
+    }
+
+    tassert(6440102,
+            str::stream() << "The removable sum state must have "
+                          << AggRemovableSumElems::kSizeOfRemovableSumArray
+                          << " elements but got: " << arr->size(),
+            arr->size() == AggRemovableSumElems::kSizeOfRemovableSumArray);
+    auto sumArr = value::getArrayView(arr->getAt(AggRemovableSumElems::kFiniteSum).second);
+
+    auto updateCount = [&](AggRemovableSumElems idx) {
+        auto count = value::bitcastTo<int64_t>(arr->getAt(idx).second);
+        arr->setAt(idx, TypeTags::NumberInt64, value::bitcastFrom<int64_t>(count + quantity));
+    };
+    updateCount(AggRemovableSumElems::kNumericCount);
+
+    switch (rhsTag) {
+        case TypeTags::NumberInt32: {
+            int64_t longVal = value::bitcastTo<int32_t>(rhsValue);
+            aggDoubleDoubleSumImpl(
+                sumArr, TypeTags::NumberInt64, value::bitcastFrom<int64_t>(longVal * quantity));
+            break;
+        }
+        case TypeTags::NumberInt64: {
+            auto longVal = value::bitcastTo<int64_t>(rhsValue);
+            if (longVal == std::numeric_limits<int64_t>::min() && quantity == -1) {
+                // Avoid overflow by processing in two parts.
+                aggDoubleDoubleSumImpl(
+                    sumArr,
+                    TypeTags::NumberInt64,
+                    value::bitcastFrom<int64_t>(std::numeric_limits<int64_t>::max()));
+                aggDoubleDoubleSumImpl(
+                    sumArr, TypeTags::NumberInt32, value::bitcastFrom<int32_t>(1));
+            } else {
+                aggDoubleDoubleSumImpl(
+                    sumArr, TypeTags::NumberInt64, value::bitcastFrom<int64_t>(longVal * quantity));
+            }
+            break;
+        }
+        case TypeTags::NumberDouble: {
+            updateCount(AggRemovableSumElems::kDoubleCount);
+            auto doubleVal = value::bitcastTo<double>(rhsValue);
+            if (std::isnan(doubleVal)) {
+                updateCount(AggRemovableSumElems::kNanCount);
+            } else if (doubleVal == std::numeric_limits<double>::infinity()) {
+                updateCount(AggRemovableSumElems::kPosInfinityCount);
+            } else if (doubleVal == -std::numeric_limits<double>::infinity()) {
+                updateCount(AggRemovableSumElems::kNegInfinityCount);
+            } else {
+                aggDoubleDoubleSumImpl(sumArr,
+                                       TypeTags::NumberDouble,
+                                       value::bitcastFrom<double>(doubleVal * quantity));
+            }
+            break;
+        }
+        case TypeTags::NumberDecimal: {
+            updateCount(AggRemovableSumElems::kDecimalCount);
+            auto decimalVal = value::bitcastTo<Decimal128>(rhsValue);
+            if (decimalVal.isNaN()) {
+                updateCount(AggRemovableSumElems::kNanCount);
+            } else if (decimalVal.isInfinite()) {
+                updateCount(decimalVal.isNegative() ? AggRemovableSumElems::kNegInfinityCount
+                                                    : AggRemovableSumElems::kPosInfinityCount);
+            } else {
+                auto [tag, val] =
+                    makeCopyDecimal(quantity == -1 ? decimalVal.negate() : decimalVal);
+                value::ValueGuard guard{tag, val};
+                aggDoubleDoubleSumImpl(sumArr, tag, val);
+            }
+            break;
+        }
+        default:
+            MONGO_UNREACHABLE_TASSERT(6440103);
+    }
+}
+
 void ByteCode::aggStdDevImpl(value::Array* arr, value::TypeTags rhsTag, value::Value rhsValue) {
     if (!isNumber(rhsTag)) {
         return;
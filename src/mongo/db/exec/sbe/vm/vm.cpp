@@ -39,12 +39,14 @@
 
 #include "mongo/bson/oid.h"
 #include "mongo/db/client.h"
+#include "mongo/db/exec/hyper_log_log.h"
 #include "mongo/db/exec/js_function.h"
 #include "mongo/db/exec/sbe/values/bson.h"
 #include "mongo/db/exec/sbe/values/sbe_pattern_value_cmp.h"
 #include "mongo/db/exec/sbe/values/sort_spec.h"
 #include "mongo/db/exec/sbe/values/value.h"
 #include "mongo/db/exec/sbe/vm/datetime.h"
+#include "mongo/db/exec/t_digest.h"
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/btree_key_generator.h"
 #include "mongo/db/query/collation/collation_index_key.h"
@@ -1239,6 +1241,335 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinStdDevSampFinal
     return aggStdDevFinalizeImpl(fieldValue, true /* isSamp */);
 }
 
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::aggApproxCountDistinctImpl(
+    value::TypeTags accTag,
+    value::Value accValue,
+    value::TypeTags fieldTag,
+    value::Value fieldValue,
+    const CollatorInterface* collator) {
+    value::ValueGuard guard{accTag, accValue};
+
+    // Initialize the accumulator. The sketch is kept in the same BinData representation that the
+    // classic $approxCountDistinct accumulator uses as its partial result, so that it can be
+    // returned as-is when the result needs to be merged.
+    if (accTag == value::TypeTags::Nothing) {
+        std::tie(accTag, accValue) =
+            value::makeNewBsonBinData(BinDataGeneral, HyperLogLog::kSerializedSize);
+        HyperLogLog::initialize(value::getBSONBinData(accTag, accValue));
+    }
+    tassert(6440030,
+            "The accumulator state of approxCountDistinct must be a HyperLogLog sketch",
+            accTag == value::TypeTags::bsonBinData &&
+                value::getBSONBinDataSize(accTag, accValue) == HyperLogLog::kSerializedSize);
+
+    // Like $addToSet, ignore missing values.
+    if (fieldTag != value::TypeTags::Nothing) {
+        BSONObjBuilder bob;
+        bson::appendValueToBsonObj(bob, ""_sd, fieldTag, fieldValue);
+        HyperLogLog::add(value::getBSONBinData(accTag, accValue),
+                         HyperLogLog::hash(bob.done().firstElement(), collator));
+    }
+
+    guard.reset();
+    return {true, accTag, accValue};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggApproxCountDistinct(
+    ArityType arity) {
+    // Move the incoming accumulator state from the stack. Given that we are now the owner of the
+    // state we are free to do any in-place update as we see fit.
+    auto [accTag, accValue] = moveOwnedFromStack(0);
+    auto [_, fieldTag, fieldValue] = getFromStack(1);
+
+    return aggApproxCountDistinctImpl(accTag, accValue, fieldTag, fieldValue, nullptr);
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggCollApproxCountDistinct(
+    ArityType arity) {
+    auto [accTag, accValue] = moveOwnedFromStack(0);
+    auto [collOwned, collTag, collValue] = getFromStack(1);
+    auto [fieldOwned, fieldTag, fieldValue] = getFromStack(2);
+
+    const CollatorInterface* collator = nullptr;
+    if (collTag == value::TypeTags::collator) {
+        collator = value::getCollatorView(collValue);
+    }
+    return aggApproxCountDistinctImpl(accTag, accValue, fieldTag, fieldValue, collator);
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinApproxCountDistinctFinalize(
+    ArityType arity) {
+    auto [_, accTag, accValue] = getFromStack(0);
+    if (accTag != value::TypeTags::bsonBinData) {
+        return {false, value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(0)};
+    }
+
+    auto estimate = HyperLogLog::estimate(value::getBSONBinData(accTag, accValue));
+    return {false, value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(estimate)};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggTDigest(ArityType arity) {
+    auto [accTag, accValue] = moveOwnedFromStack(0);
+    value::ValueGuard guard{accTag, accValue};
+    auto [_, fieldTag, fieldValue] = getFromStack(1);
+
+    // Initialize the accumulator. As with approxCountDistinct, the digest uses the BinData
+    // representation of the partial result of the classic accumulator.
+    if (accTag == value::TypeTags::Nothing) {
+        std::tie(accTag, accValue) =
+            value::makeNewBsonBinData(BinDataGeneral, TDigest::kSerializedSize);
+        TDigest::initialize(reinterpret_cast<char*>(value::getBSONBinData(accTag, accValue)));
+    }
+    tassert(6440031,
+            "The accumulator state of a percentile must be a t-digest",
+            accTag == value::TypeTags::bsonBinData &&
+                value::getBSONBinDataSize(accTag, accValue) == TDigest::kSerializedSize);
+
+    // Non-numeric types have no impact on percentiles.
+    if (value::isNumber(fieldTag)) {
+        auto digest = reinterpret_cast<char*>(value::getBSONBinData(accTag, accValue));
+        if (fieldTag == value::TypeTags::NumberDecimal) {
+            TDigest::add(digest, value::bitcastTo<Decimal128>(fieldValue).toDouble());
+        } else {
+            TDigest::add(digest, value::numericCast<double>(fieldTag, fieldValue));
+        }
+    }
+
+    guard.reset();
+    return {true, accTag, accValue};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinTDigestPercentileFinalize(
+    ArityType arity) {
+    auto [accOwned, accTag, accValue] = getFromStack(0);
+    auto [psOwned, psTag, psValue] = getFromStack(1);
+
+    auto percentile = [&](double p) -> std::pair<value::TypeTags, value::Value> {
+        if (accTag != value::TypeTags::bsonBinData) {
+            return {value::TypeTags::Null, 0};
+        }
+        // Computing a quantile flushes the digest's buffer, which modifies the state in place.
+        // This is harmless as the state is not updated after finalization.
+        auto estimate = TDigest::quantile(
+            reinterpret_cast<char*>(value::getBSONBinData(accTag, accValue)), p);
+        if (!estimate) {
+            return {value::TypeTags::Null, 0};
+        }
+        return {value::TypeTags::NumberDouble, value::bitcastFrom<double>(*estimate)};
+    };
+
+    // A scalar 'p' (used by $median) produces a scalar result, an array of percentiles an array.
+    if (value::isNumber(psTag) && psTag != value::TypeTags::NumberDecimal) {
+        auto [tag, val] = percentile(value::numericCast<double>(psTag, psValue));
+        return {false, tag, val};
+    }
+    if (!value::isArray(psTag)) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+
+    auto [resTag, resValue] = value::makeNewArray();
+    value::ValueGuard resGuard{resTag, resValue};
+    auto result = value::getArrayView(resValue);
+    for (value::ArrayEnumerator it{psTag, psValue}; !it.atEnd(); it.advance()) {
+        auto [pTag, pValue] = it.getViewOfValue();
+        if (!value::isNumber(pTag) || pTag == value::TypeTags::NumberDecimal) {
+            return {false, value::TypeTags::Nothing, 0};
+        }
+        auto [tag, val] = percentile(value::numericCast<double>(pTag, pValue));
+        result->push_back(tag, val);
+    }
+
+    resGuard.reset();
+    return {true, resTag, resValue};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::aggRemovableSumUpdate(int quantity) {
+    auto [accTag, accValue] = moveOwnedFromStack(0);
+    auto [_, fieldTag, fieldValue] = getFromStack(1);
+
+    // Initialize the accumulator.
+    if (accTag == value::TypeTags::Nothing) {
+        auto [sumTag, sumValue] = value::makeNewArray();
+        value::ValueGuard sumGuard{sumTag, sumValue};
+        auto sumArr = value::getArrayView(sumValue);
+        sumArr->reserve(AggSumValueElems::kMaxSizeOfArray);
+        // The order of the following three elements should match to 'AggSumValueElems'.
+        sumArr->push_back(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(0));
+        sumArr->push_back(value::TypeTags::NumberDouble, value::bitcastFrom<double>(0.0));
+        sumArr->push_back(value::TypeTags::NumberDouble, value::bitcastFrom<double>(0.0));
+
+        std::tie(accTag, accValue) = value::makeNewArray();
+        value::ValueGuard accGuard{accTag, accValue};
+        auto arr = value::getArrayView(accValue);
+        arr->reserve(AggRemovableSumElems::kSizeOfRemovableSumArray);
+        sumGuard.reset();
+        arr->push_back(sumTag, sumValue);
+        for (size_t idx = AggRemovableSumElems::kNanCount;
+             idx < AggRemovableSumElems::kSizeOfRemovableSumArray;
+             ++idx) {
+            arr->push_back(value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(0));
+        }
+        accGuard.reset();
+    }
+    value::ValueGuard guard{accTag, accValue};
+    tassert(6440104,
+            "The accumulator state of a removable sum must be an Array",
+            accTag == value::TypeTags::Array);
+
+    aggRemovableSumImpl(value::getArrayView(accValue), fieldTag, fieldValue, quantity);
+
+    guard.reset();
+    return {true, accTag, accValue};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggRemovableSumAdd(
+    ArityType arity) {
+    return aggRemovableSumUpdate(1);
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggRemovableSumRemove(
+    ArityType arity) {
+    return aggRemovableSumUpdate(-1);
+}
+
+namespace {
+std::tuple<bool, value::TypeTags, value::Value> makeIntOrLong(int64_t longVal) {
+    if (int32_t intVal = longVal; intVal == longVal) {
+        return {false, value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(intVal)};
+    }
+    return {false, value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(longVal)};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> makeDoubleOrDecimal(bool decimal,
+                                                                    double doubleVal,
+                                                                    Decimal128 decimalVal) {
+    if (decimal) {
+        auto [tag, val] = value::makeCopyDecimal(decimalVal);
+        return {true, tag, val};
+    }
+    return {false, value::TypeTags::NumberDouble, value::bitcastFrom<double>(doubleVal)};
+}
+}  // namespace
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::removableSumFinalizeImpl(
+    value::Array* arr) {
+    tassert(6440105,
+            str::stream() << "The removable sum state must have "
+                          << AggRemovableSumElems::kSizeOfRemovableSumArray
+                          << " elements but got: " << arr->size(),
+            arr->size() == AggRemovableSumElems::kSizeOfRemovableSumArray);
+    auto getCount = [&](AggRemovableSumElems idx) {
+        return value::bitcastTo<int64_t>(arr->getAt(idx).second);
+    };
+    const bool seenDecimal = getCount(AggRemovableSumElems::kDecimalCount) > 0;
+    const auto posInfinityCount = getCount(AggRemovableSumElems::kPosInfinityCount);
+    const auto negInfinityCount = getCount(AggRemovableSumElems::kNegInfinityCount);
+
+    // Non-finite values win over the finite sum, and are typed by whether any decimal is present.
+    if (getCount(AggRemovableSumElems::kNanCount) > 0 ||
+        (posInfinityCount > 0 && negInfinityCount > 0)) {
+        return makeDoubleOrDecimal(
+            seenDecimal, std::numeric_limits<double>::quiet_NaN(), Decimal128::kPositiveNaN);
+    }
+    if (posInfinityCount > 0) {
+        return makeDoubleOrDecimal(
+            seenDecimal, std::numeric_limits<double>::infinity(), Decimal128::kPositiveInfinity);
+    }
+    if (negInfinityCount > 0) {
+        return makeDoubleOrDecimal(
+            seenDecimal, -std::numeric_limits<double>::infinity(), Decimal128::kNegativeInfinity);
+    }
+
+    auto sumArr = value::getArrayView(arr->getAt(AggRemovableSumElems::kFiniteSum).second);
+    auto [sumTag, sum] = sumArr->getAt(AggSumValueElems::kNonDecimalTotalSum);
+    auto [addendTag, addend] = sumArr->getAt(AggSumValueElems::kNonDecimalTotalAddend);
+    tassert(6440106,
+            "The sum and addend must be NumberDouble",
+            sumTag == addendTag && sumTag == value::TypeTags::NumberDouble);
+    auto nonDecimalTotal = DoubleDoubleSummation::create(value::bitcastTo<double>(sum),
+                                                         value::bitcastTo<double>(addend));
+    const bool seenDouble = getCount(AggRemovableSumElems::kDoubleCount) > 0;
+
+    if (sumArr->size() == AggSumValueElems::kMaxSizeOfArray) {
+        // A decimal has been in the window at some point, so the total is held as a decimal. It
+        // is narrowed back to the widest type still present in the window.
+        auto total = value::bitcastTo<Decimal128>(
+                         sumArr->getAt(AggSumValueElems::kDecimalTotal).second)
+                         .add(nonDecimalTotal.getDecimal());
+        if (seenDecimal || seenDouble) {
+            return makeDoubleOrDecimal(seenDecimal, total.toDouble(), total);
+        }
+        std::uint32_t signalingFlags = Decimal128::SignalingFlag::kNoFlag;
+        auto longVal = total.toLong(&signalingFlags);
+        if (signalingFlags == Decimal128::SignalingFlag::kNoFlag) {
+            return makeIntOrLong(longVal);
+        }
+        return {false, value::TypeTags::NumberDouble, value::bitcastFrom<double>(total.toDouble())};
+    }
+
+    if (!seenDouble && nonDecimalTotal.fitsLong()) {
+        return makeIntOrLong(nonDecimalTotal.getLong());
+    }
+    return {false,
+            value::TypeTags::NumberDouble,
+            value::bitcastFrom<double>(nonDecimalTotal.getDouble())};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinRemovableSumFinalize(
+    ArityType arity) {
+    auto [_, accTag, accValue] = getFromStack(0);
+    // An empty window sums to zero.
+    if (accTag != value::TypeTags::Array) {
+        return {false, value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(0)};
+    }
+    return removableSumFinalizeImpl(value::getArrayView(accValue));
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinRemovableAvgFinalize(
+    ArityType arity) {
+    auto [_, accTag, accValue] = getFromStack(0);
+    if (accTag != value::TypeTags::Array) {
+        return {false, value::TypeTags::Null, 0};
+    }
+    auto arr = value::getArrayView(accValue);
+    auto count = value::bitcastTo<int64_t>(arr->getAt(AggRemovableSumElems::kNumericCount).second);
+    // The average of a window without any numeric values is null.
+    if (count == 0) {
+        return {false, value::TypeTags::Null, 0};
+    }
+
+    auto [owned, sumTag, sumValue] = removableSumFinalizeImpl(arr);
+    switch (sumTag) {
+        case value::TypeTags::NumberInt32:
+        case value::TypeTags::NumberInt64:
+            return {false,
+                    value::TypeTags::NumberDouble,
+                    value::bitcastFrom<double>(value::numericCast<double>(sumTag, sumValue) /
+                                               static_cast<double>(count))};
+        case value::TypeTags::NumberDouble: {
+            auto sum = value::bitcastTo<double>(sumValue);
+            if (std::isnan(sum) || std::isinf(sum)) {
+                return {false, sumTag, sumValue};
+            }
+            return {false,
+                    value::TypeTags::NumberDouble,
+                    value::bitcastFrom<double>(sum / static_cast<double>(count))};
+        }
+        case value::TypeTags::NumberDecimal: {
+            value::ValueGuard guard{sumTag, sumValue};
+            auto sum = value::bitcastTo<Decimal128>(sumValue);
+            if (sum.isNaN() || sum.isInfinite()) {
+                guard.reset();
+                return {owned, sumTag, sumValue};
+            }
+            auto [tag, val] = value::makeCopyDecimal(sum.divide(Decimal128(count)));
+            return {true, tag, val};
+        }
+        default:
+            MONGO_UNREACHABLE_TASSERT(6440107);
+    }
+}
+
 std::tuple<bool, value::TypeTags, value::Value> ByteCode::aggMin(value::TypeTags accTag,
                                                                  value::Value accValue,
                                                                  value::TypeTags fieldTag,
@@ -4008,6 +4339,24 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::dispatchBuiltin(Builti
             return builtinStdDevPopFinalize(arity);
         case Builtin::stdDevSampFinalize:
             return builtinStdDevSampFinalize(arity);
+        case Builtin::aggApproxCountDistinct:
+            return builtinAggApproxCountDistinct(arity);
+        case Builtin::aggCollApproxCountDistinct:
+            return builtinAggCollApproxCountDistinct(arity);
+        case Builtin::approxCountDistinctFinalize:
+            return builtinApproxCountDistinctFinalize(arity);
+        case Builtin::aggTDigest:
+            return builtinAggTDigest(arity);
+        case Builtin::tDigestPercentileFinalize:
+            return builtinTDigestPercentileFinalize(arity);
+        case Builtin::aggRemovableSumAdd:
+            return builtinAggRemovableSumAdd(arity);
+        case Builtin::aggRemovableSumRemove:
+            return builtinAggRemovableSumRemove(arity);
+        case Builtin::removableSumFinalize:
+            return builtinRemovableSumFinalize(arity);
+        case Builtin::removableAvgFinalize:
+            return builtinRemovableAvgFinalize(arity);
         case Builtin::bitTestZero:
             return builtinBitTestZero(arity);
         case Builtin::bitTestMask:
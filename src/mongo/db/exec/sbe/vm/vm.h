@@ -511,6 +511,15 @@ enum class Builtin : uint8_t {
     aggStdDev,
     stdDevPopFinalize,
     stdDevSampFinalize,
+    aggApproxCountDistinct,      // agg function to update a HyperLogLog sketch
+    aggCollApproxCountDistinct,  // agg function to update a HyperLogLog sketch (with collation)
+    approxCountDistinctFinalize,
+    aggTDigest,  // agg function to update a t-digest
+    tDigestPercentileFinalize,
+    aggRemovableSumAdd,     // agg function to add a value to a sliding window sum
+    aggRemovableSumRemove,  // agg function to remove a value from a sliding window sum
+    removableSumFinalize,
+    removableAvgFinalize,
     bitTestZero,      // test bitwise mask & value is zero
     bitTestMask,      // test bitwise mask & value is mask
     bitTestPosition,  // test BinData with a bit position list
@@ -600,6 +609,33 @@ enum AggSumValueElems {
  */
 enum class AggPartialSumElems { kTotal, kError, kSizeOfArray };
 
+/**
+ * This enum defines indices into an 'Array' that accumulates $sum and $avg over a window whose
+ * frame slides, i.e. where values can be removed as well as added.
+ *
+ * The array contains 7 elements:
+ * - The element at index `kFiniteSum` is a nested 'AggSumValueElems' array holding the sum of all
+ * finite values in the window.
+ * - The elements at indices `kNanCount`, `kPosInfinityCount` and `kNegInfinityCount` count the
+ * non-finite values in the window, which cannot be subtracted back out of a sum.
+ * - The elements at indices `kDoubleCount` and `kDecimalCount` count the values of each type so the
+ * result can be narrowed back once the values that widened it have left the window.
+ * - The element at index `kNumericCount` counts all numeric values in the window.
+ *
+ * See 'aggRemovableSumImpl()' / 'builtinRemovableSumFinalize()' for more details.
+ */
+enum AggRemovableSumElems {
+    kFiniteSum,
+    kNanCount,
+    kPosInfinityCount,
+    kNegInfinityCount,
+    kDoubleCount,
+    kDecimalCount,
+    kNumericCount,
+    // This is actually not an index but represents the number of elements stored
+    kSizeOfRemovableSumArray
+};
+
 /**
  * This enum defines indices into an 'Array' that accumulates $stdDevPop and $stdDevSamp results.
  *
@@ -990,6 +1026,18 @@ private:
 
     void aggDoubleDoubleSumImpl(value::Array* arr, value::TypeTags rhsTag, value::Value rhsValue);
 
+    // Adds ('quantity' == 1) or removes ('quantity' == -1) a value to or from an
+    // 'AggRemovableSumElems' array.
+    void aggRemovableSumImpl(value::Array* arr,
+                             value::TypeTags rhsTag,
+                             value::Value rhsValue,
+                             int quantity);
+    std::tuple<bool, value::TypeTags, value::Value> aggRemovableSumUpdate(int quantity);
+
+    // Computes the sum held by an 'AggRemovableSumElems' array, narrowing the result type the same
+    // way the classic engine's 'RemovableSum' does.
+    std::tuple<bool, value::TypeTags, value::Value> removableSumFinalizeImpl(value::Array* arr);
+
     // This is an implementation of the following algorithm:
     // https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Welford's_online_algorithm
     void aggStdDevImpl(value::Array* arr, value::TypeTags rhsTag, value::Value rhsValue);
@@ -997,6 +1045,13 @@ private:
     std::tuple<bool, value::TypeTags, value::Value> aggStdDevFinalizeImpl(value::Value fieldValue,
                                                                           bool isSamp);
 
+    std::tuple<bool, value::TypeTags, value::Value> aggApproxCountDistinctImpl(
+        value::TypeTags accTag,
+        value::Value accValue,
+        value::TypeTags fieldTag,
+        value::Value fieldValue,
+        const CollatorInterface* collator);
+
     std::tuple<bool, value::TypeTags, value::Value> aggMin(value::TypeTags accTag,
                                                            value::Value accValue,
                                                            value::TypeTags fieldTag,
@@ -1109,6 +1164,19 @@ private:
     std::tuple<bool, value::TypeTags, value::Value> builtinAggStdDev(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinStdDevPopFinalize(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinStdDevSampFinalize(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinAggApproxCountDistinct(
+        ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinAggCollApproxCountDistinct(
+        ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinApproxCountDistinctFinalize(
+        ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinAggTDigest(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinTDigestPercentileFinalize(
+        ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinAggRemovableSumAdd(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinAggRemovableSumRemove(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinRemovableSumFinalize(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinRemovableAvgFinalize(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinBitTestZero(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinBitTestMask(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinBitTestPosition(ArityType arity);
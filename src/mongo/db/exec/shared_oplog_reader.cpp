@@ -0,0 +1,344 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_reader.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const auto getSharedOplogReader = ServiceContext::declareDecoration<SharedOplogReader>();
+
+Timestamp timestampForOplogRecordId(const RecordId& id) {
+    return Timestamp(static_cast<unsigned long long>(id.getLong()));
+}
+
+bool isCrudOpType(StringData opType) {
+    return opType == "i"_sd || opType == "u"_sd || opType == "d"_sd;
+}
+
+class SharedOplogReaderSSS : public ServerStatusSection {
+public:
+    SharedOplogReaderSSS() : ServerStatusSection("changeStreamSharedOplogReader") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        SharedOplogReader::get(opCtx).appendStats(&builder);
+        return builder.obj();
+    }
+} sharedOplogReaderSSS;
+
+}  // namespace
+
+SharedOplogReader::Subscription::Subscription(SharedOplogReader* reader,
+                                              const NamespaceString& nss,
+                                              RecordId lastSeenId)
+    : _reader(reader),
+      _nss(nss),
+      _scope(nss.isAdminDB() ? Scope::kCluster
+                             : (nss.isCollectionlessAggregateNS() ? Scope::kDatabase
+                                                                  : Scope::kCollection)),
+      _resumeAfterId(std::move(lastSeenId)),
+      _scannedThrough(timestampForOplogRecordId(_resumeAfterId)) {}
+
+SharedOplogReader::Subscription::~Subscription() {
+    stdx::lock_guard<Latch> lk(_reader->_mutex);
+    _reader->_detach(lk, this);
+}
+
+boost::optional<SharedOplogReader::Entry> SharedOplogReader::Subscription::next(
+    bool* detached, Timestamp* scannedThrough) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_buffer.empty()) {
+        *detached = _detached;
+        *scannedThrough = _scannedThrough;
+        return boost::none;
+    }
+    auto entry = std::move(_buffer.front());
+    _buffer.pop_front();
+    return entry;
+}
+
+SharedOplogReader& SharedOplogReader::get(ServiceContext* serviceContext) {
+    return getSharedOplogReader(serviceContext);
+}
+
+SharedOplogReader& SharedOplogReader::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+std::unique_ptr<SharedOplogReader::Subscription> SharedOplogReader::subscribe(
+    const NamespaceString& nss, RecordId lastSeenId) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_subscribers.empty()) {
+        _position = lastSeenId;
+        ++_generation;
+    } else if (lastSeenId < _position) {
+        // Entries between 'lastSeenId' and '_position' have already been dispatched.
+        _subscriptionsRejected.fetchAndAddRelaxed(1);
+        return nullptr;
+    }
+
+    auto subscription = std::make_unique<Subscription>(this, nss, std::move(lastSeenId));
+    auto raw = subscription.get();
+    _subscribers.insert(raw);
+    switch (raw->_scope) {
+        case Subscription::Scope::kCollection:
+            _byCollection[nss.ns()].insert(raw);
+            break;
+        case Subscription::Scope::kDatabase:
+            _byDatabase[nss.db()].insert(raw);
+            break;
+        case Subscription::Scope::kCluster:
+            _wholeCluster.insert(raw);
+            break;
+    }
+    _subscriptionsCreated.fetchAndAddRelaxed(1);
+    return subscription;
+}
+
+bool SharedOplogReader::_detach(WithLock, Subscription* subscription) {
+    if (!_subscribers.erase(subscription)) {
+        return false;
+    }
+
+    switch (subscription->_scope) {
+        case Subscription::Scope::kCollection: {
+            auto it = _byCollection.find(subscription->_nss.ns());
+            if (it != _byCollection.end() && it->second.erase(subscription) &&
+                it->second.empty()) {
+                _byCollection.erase(it);
+            }
+            break;
+        }
+        case Subscription::Scope::kDatabase: {
+            auto it = _byDatabase.find(subscription->_nss.db());
+            if (it != _byDatabase.end() && it->second.erase(subscription) && it->second.empty()) {
+                _byDatabase.erase(it);
+            }
+            break;
+        }
+        case Subscription::Scope::kCluster:
+            _wholeCluster.erase(subscription);
+            break;
+    }
+
+    {
+        stdx::lock_guard<Latch> subscriptionLk(subscription->_mutex);
+        subscription->_detached = true;
+    }
+
+    if (_subscribers.empty()) {
+        _position = RecordId();
+        ++_generation;
+    }
+    return true;
+}
+
+size_t SharedOplogReader::_dispatch(WithLock lk, const Entry& entry, size_t maxBuffered) {
+    std::vector<Subscription*> targets;
+    auto opType = entry.obj[repl::OplogEntry::kOpTypeFieldName].valueStringDataSafe();
+    if (isCrudOpType(opType)) {
+        // CRUD entries can only be of interest to the streams which watch their namespace.
+        auto ns = entry.obj[repl::OplogEntry::kNssFieldName].valueStringDataSafe();
+        if (auto it = _byCollection.find(ns); it != _byCollection.end()) {
+            targets.insert(targets.end(), it->second.begin(), it->second.end());
+        }
+        if (auto it = _byDatabase.find(nsToDatabaseSubstring(ns)); it != _byDatabase.end()) {
+            targets.insert(targets.end(), it->second.begin(), it->second.end());
+        }
+        targets.insert(targets.end(), _wholeCluster.begin(), _wholeCluster.end());
+    } else {
+        // Commands, including transactions, and no-op entries may be of interest to any stream.
+        targets.insert(targets.end(), _subscribers.begin(), _subscribers.end());
+    }
+
+    size_t numDelivered = 0;
+    for (auto subscription : targets) {
+        if (entry.id <= subscription->_resumeAfterId) {
+            continue;
+        }
+
+        bool overflowed = false;
+        {
+            stdx::lock_guard<Latch> subscriptionLk(subscription->_mutex);
+            if (subscription->_buffer.size() >= maxBuffered) {
+                overflowed = true;
+            } else {
+                subscription->_buffer.push_back(entry);
+            }
+        }
+
+        if (overflowed) {
+            LOGV2_DEBUG(6440400,
+                        3,
+                        "Detaching slow change stream from the shared oplog reader",
+                        "namespace"_attr = subscription->_nss,
+                        "bufferedEntries"_attr = maxBuffered);
+            if (_detach(lk, subscription)) {
+                _fallbacks.fetchAndAddRelaxed(1);
+            }
+        } else {
+            _entriesDelivered.fetchAndAddRelaxed(1);
+            ++numDelivered;
+        }
+    }
+    return numDelivered;
+}
+
+void SharedOplogReader::readAhead(OperationContext* opCtx, const CollectionPtr& oplog) {
+    RecordId start;
+    uint64_t generation;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_reading || _subscribers.empty()) {
+            return;
+        }
+        _reading = true;
+        start = _position;
+        generation = _generation;
+    }
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _reading = false;
+    });
+
+    std::vector<Entry> entries;
+    bool positionLost = false;
+    {
+        auto cursor = oplog->getCursor(opCtx, true /* forward */);
+        if (!cursor->seekExact(start)) {
+            // The entry at our position is either gone because the oplog was truncated past it, or
+            // not yet visible in our snapshot, which may be older than the one in which the
+            // position was read. Only the former loses the position. Otherwise, the subscribers
+            // keep waiting and a later read retries from the same position.
+            auto oldest = oplog->getCursor(opCtx, true /* forward */)->next();
+            if (!oldest || oldest->id <= start) {
+                _positionNotVisible.fetchAndAddRelaxed(1);
+                return;
+            }
+            positionLost = true;
+        }
+        while (!positionLost && entries.size() < kMaxEntriesPerRead) {
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            auto obj = record->data.releaseToBson().getOwned();
+            auto ts = obj[repl::OpTime::kTimestampFieldName].timestamp();
+            entries.push_back({std::move(record->id), ts, std::move(obj)});
+        }
+    }
+    _entriesRead.fetchAndAddRelaxed(entries.size());
+
+    size_t numDelivered = 0;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (generation != _generation) {
+            // Every subscriber left while we were reading, and the position was reset.
+            return;
+        }
+
+        if (positionLost) {
+            // The oplog was truncated past our position. Every subscriber falls back to its
+            // private cursor, which will report the lost position if it applies to that stream.
+            std::vector<Subscription*> subscribers(_subscribers.begin(), _subscribers.end());
+            for (auto subscription : subscribers) {
+                _detach(lk, subscription);
+                _fallbacks.fetchAndAddRelaxed(1);
+            }
+        } else if (!entries.empty()) {
+            const size_t maxBuffered =
+                internalChangeStreamSharedOplogReaderMaxBufferedEntries.load();
+            for (auto&& entry : entries) {
+                numDelivered += _dispatch(lk, entry, maxBuffered);
+            }
+
+            _position = entries.back().id;
+            for (auto subscription : _subscribers) {
+                stdx::lock_guard<Latch> subscriptionLk(subscription->_mutex);
+                subscription->_scannedThrough =
+                    std::max(subscription->_scannedThrough, entries.back().ts);
+            }
+        }
+    }
+
+    // The other subscribers may have found their buffer empty while we were reading, and be
+    // waiting for an insert into the oplog in awaitData. Wake them up to consume what we handed
+    // them, or to fall back to their private cursor, rather than leaving them to wait for the next
+    // insert or for their maxAwaitTimeMS to expire.
+    if (numDelivered > 0 || positionLost) {
+        oplog->getCappedInsertNotifier()->notifyAll();
+    }
+}
+
+void SharedOplogReader::appendStats(BSONObjBuilder* builder) const {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        builder->appendNumber("subscriptions", static_cast<long long>(_subscribers.size()));
+    }
+    builder->append("subscriptionsCreated", _subscriptionsCreated.load());
+    builder->append("subscriptionsRejected", _subscriptionsRejected.load());
+    builder->append("fallbacks", _fallbacks.load());
+    builder->append("positionNotVisible", _positionNotVisible.load());
+    builder->append("entriesRead", _entriesRead.load());
+    builder->append("entriesDelivered", _entriesDelivered.load());
+
+    // The share of the entries returned to change streams which did not have to be read through a
+    // private cursor.
+    const auto sharedReads = _sharedReads.load();
+    const auto privateReads = _privateReads.load();
+    builder->append("sharedReads", sharedReads);
+    builder->append("privateReads", privateReads);
+    builder->append("hitRate",
+                    sharedReads + privateReads == 0
+                        ? 0.0
+                        : static_cast<double>(sharedReads) / (sharedReads + privateReads));
+}
+
+}  // namespace mongo
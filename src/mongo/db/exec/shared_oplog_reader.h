@@ -0,0 +1,209 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <memory>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/stdx/unordered_set.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class CollectionPtr;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A per-node reader of the oplog which is shared by the tailable oplog scans of concurrent change
+ * streams. Instead of every change stream re-reading the same oplog entries through its own
+ * cursor, a stream which has caught up with the end of the oplog subscribes to the reader. Each
+ * entry is then read from the storage engine and decoded once, and handed to the subscriptions
+ * which may be interested in it.
+ *
+ * There is no dedicated reader thread: a subscriber which finds its buffer empty reads ahead on
+ * behalf of all subscribers, using its own OperationContext and storage snapshot, while the others
+ * keep consuming what has already been buffered for them.
+ *
+ * Subscriptions are indexed by the namespaces they watch. CRUD entries are only handed to the
+ * subscriptions whose scope contains the entry's namespace, whereas commands and no-op entries go
+ * to every subscription. Subscriptions are not indexed by the operation types their change stream
+ * filters on, so a stream which only matches deletes still receives the inserts and updates on its
+ * namespace. This is a superset of the entries which a change stream can match, so subscribers
+ * must still apply their own filter.
+ *
+ * A subscription's buffer is bounded by 'internalChangeStreamSharedOplogReaderMaxBufferedEntries'.
+ * When a slow consumer lets its buffer fill up, it is detached from the reader and is expected to
+ * fall back to a private cursor once it has drained the entries which were already buffered.
+ */
+class SharedOplogReader {
+public:
+    /**
+     * An oplog entry, decoded once by the reader and shared between all subscriptions it was
+     * delivered to.
+     */
+    struct Entry {
+        RecordId id;
+        Timestamp ts;
+        BSONObj obj;
+    };
+
+    class Subscription {
+    public:
+        Subscription(SharedOplogReader* reader, const NamespaceString& nss, RecordId lastSeenId);
+        ~Subscription();
+
+        /**
+         * Pops the next buffered entry. If the buffer is empty, returns boost::none and reports
+         * through 'detached' whether the subscription was detached from the reader, in which case
+         * no further entries will be delivered to it, and through 'scannedThrough' the timestamp
+         * through which the reader has scanned the oplog on its behalf: every entry up to that
+         * timestamp has either been returned or could not be of interest to the subscriber.
+         */
+        boost::optional<Entry> next(bool* detached, Timestamp* scannedThrough);
+
+    private:
+        friend class SharedOplogReader;
+
+        enum class Scope { kCollection, kDatabase, kCluster };
+
+        SharedOplogReader* const _reader;
+        const NamespaceString _nss;
+        const Scope _scope;
+
+        // Entries at or before this position had already been read by the subscriber's private
+        // cursor when it subscribed.
+        const RecordId _resumeAfterId;
+
+        mutable Mutex _mutex = MONGO_MAKE_LATCH("SharedOplogReader::Subscription::_mutex");
+        std::deque<Entry> _buffer;
+        bool _detached = false;
+        Timestamp _scannedThrough;
+    };
+
+    static SharedOplogReader& get(ServiceContext* serviceContext);
+    static SharedOplogReader& get(OperationContext* opCtx);
+
+    /**
+     * Subscribes a change stream over 'nss', whose private cursor has returned all entries up to
+     * and including 'lastSeenId', to the reader. Returns nullptr if the reader has already
+     * delivered entries past 'lastSeenId' to its other subscribers, in which case the caller
+     * should keep using its private cursor and try again later.
+     *
+     * The returned subscription detaches itself from the reader when destroyed.
+     */
+    std::unique_ptr<Subscription> subscribe(const NamespaceString& nss, RecordId lastSeenId);
+
+    /**
+     * Reads the oplog past the reader's current position and hands each entry to the interested
+     * subscriptions, then wakes the awaitData cursors waiting on the oplog so that the other
+     * subscribers consume them. Does nothing if another thread is already reading, or if the
+     * reader's position is not yet visible in the caller's snapshot. If the oplog was truncated
+     * past the reader's position, detaches every subscription instead. 'oplog' must be locked by
+     * the caller. May throw WriteConflictException.
+     */
+    void readAhead(OperationContext* opCtx, const CollectionPtr& oplog);
+
+    /**
+     * Records that a change stream which was eligible to share reads instead read 'numEntries'
+     * oplog entries through its private cursor.
+     */
+    void notePrivateReads(long long numEntries) {
+        _privateReads.fetchAndAddRelaxed(numEntries);
+    }
+
+    /**
+     * Records that 'numEntries' oplog entries were served to a change stream from a subscription.
+     */
+    void noteSharedReads(long long numEntries) {
+        _sharedReads.fetchAndAddRelaxed(numEntries);
+    }
+
+    /**
+     * Appends the reader's statistics, as reported in serverStatus.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    // The maximum number of entries read from the oplog by a single call to readAhead().
+    static constexpr size_t kMaxEntriesPerRead = 1024;
+
+    /**
+     * Removes 'subscription' from the index, so that no further entries are delivered to it.
+     * Returns false if it was already detached.
+     */
+    bool _detach(WithLock, Subscription* subscription);
+
+    /**
+     * Hands 'entry' to every attached subscription which may be interested in it. Returns the
+     * number of subscriptions it was delivered to.
+     */
+    size_t _dispatch(WithLock, const Entry& entry, size_t maxBuffered);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("SharedOplogReader::_mutex");
+
+    // The position through which the oplog has been read and dispatched. Null while there are no
+    // subscribers.
+    RecordId _position;
+
+    // Set while a subscriber is reading ahead on behalf of the others.
+    bool _reading = false;
+
+    // Incremented whenever '_position' is reset, so that a read which started from a stale
+    // position is discarded.
+    uint64_t _generation = 0;
+
+    // All attached subscriptions, and the index of the CRUD entries each of them is interested in.
+    // Detached subscriptions remain owned by their change stream until it has drained them.
+    stdx::unordered_set<Subscription*> _subscribers;
+    StringMap<stdx::unordered_set<Subscription*>> _byCollection;
+    StringMap<stdx::unordered_set<Subscription*>> _byDatabase;
+    stdx::unordered_set<Subscription*> _wholeCluster;
+
+    AtomicWord<long long> _entriesRead{0};
+    AtomicWord<long long> _entriesDelivered{0};
+    AtomicWord<long long> _sharedReads{0};
+    AtomicWord<long long> _privateReads{0};
+    AtomicWord<long long> _subscriptionsCreated{0};
+    AtomicWord<long long> _subscriptionsRejected{0};
+    AtomicWord<long long> _fallbacks{0};
+    AtomicWord<long long> _positionNotVisible{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,188 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/shared_oplog_reader.h"
+#include "mongo/db/repl/storage_interface.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kWatchedNss("test.watched");
+const NamespaceString kOtherNss("test.other");
+
+class SharedOplogReaderTest : public CatalogTestFixture {
+protected:
+    static RecordId recordIdFor(unsigned secs) {
+        return RecordId(Timestamp(secs, 1).asLL());
+    }
+
+    /**
+     * Inserts an oplog entry for an insert into 'nss', with timestamp (secs, 1).
+     */
+    void insertOplogEntry(const NamespaceString& nss, unsigned secs) {
+        const Timestamp ts(secs, 1);
+        const BSONObj entry = BSON("ts" << ts << "t" << 1LL << "v" << 2 << "op"
+                                        << "i"
+                                        << "ns" << nss.ns() << "wall" << Date_t() << "o"
+                                        << BSON("_id" << static_cast<int>(secs)));
+        ASSERT_OK(storageInterface()->insertDocument(
+            operationContext(), NamespaceString::kRsOplogNamespace, {entry, ts}, 1LL));
+    }
+
+    /**
+     * Removes the oplog entries with timestamps from (1, 1) through ('secs', 1), as the oplog cap
+     * maintainer would.
+     */
+    void truncateOplogThrough(unsigned secs) {
+        auto opCtx = operationContext();
+        AutoGetCollection oplog(opCtx, NamespaceString::kRsOplogNamespace, MODE_IX);
+        WriteUnitOfWork wuow(opCtx);
+        for (unsigned i = 1; i <= secs; ++i) {
+            oplog->getRecordStore()->deleteRecord(opCtx, recordIdFor(i));
+        }
+        wuow.commit();
+    }
+
+    void readAhead() {
+        auto opCtx = operationContext();
+        AutoGetCollectionForRead oplog(opCtx, NamespaceString::kRsOplogNamespace);
+        reader().readAhead(opCtx, oplog.getCollection());
+        opCtx->recoveryUnit()->abandonSnapshot();
+    }
+
+    /**
+     * Returns the timestamps of the entries buffered for 'subscription', and whether it has been
+     * detached once its buffer is drained.
+     */
+    std::pair<std::vector<Timestamp>, bool> drain(SharedOplogReader::Subscription* subscription) {
+        std::vector<Timestamp> timestamps;
+        bool detached = false;
+        Timestamp scannedThrough;
+        while (auto entry = subscription->next(&detached, &scannedThrough)) {
+            timestamps.push_back(entry->ts);
+        }
+        return {timestamps, detached};
+    }
+
+    BSONObj stats() {
+        BSONObjBuilder builder;
+        reader().appendStats(&builder);
+        return builder.obj();
+    }
+
+    SharedOplogReader& reader() {
+        return SharedOplogReader::get(getServiceContext());
+    }
+};
+
+TEST_F(SharedOplogReaderTest, SubscribeAndDetach) {
+    insertOplogEntry(kWatchedNss, 1);
+
+    auto first = reader().subscribe(kWatchedNss, recordIdFor(1));
+    ASSERT(first);
+    insertOplogEntry(kOtherNss, 2);
+    insertOplogEntry(kWatchedNss, 3);
+    readAhead();
+
+    // Only the entries on the watched namespace are delivered.
+    auto [timestamps, detached] = drain(first.get());
+    ASSERT_EQ(1U, timestamps.size());
+    ASSERT_EQ(Timestamp(3, 1), timestamps[0]);
+    ASSERT_FALSE(detached);
+
+    // A stream which has not read up to the reader's position must keep its private cursor.
+    ASSERT_FALSE(reader().subscribe(kWatchedNss, recordIdFor(2)));
+    auto second = reader().subscribe(kOtherNss, recordIdFor(3));
+    ASSERT(second);
+    ASSERT_EQ(2, stats()["subscriptions"].numberLong());
+    ASSERT_EQ(1, stats()["subscriptionsRejected"].numberLong());
+
+    // A destroyed subscription detaches itself. Once none are left, the reader restarts from the
+    // position of its next subscriber.
+    first.reset();
+    ASSERT_EQ(1, stats()["subscriptions"].numberLong());
+    second.reset();
+    ASSERT_EQ(0, stats()["subscriptions"].numberLong());
+    auto third = reader().subscribe(kWatchedNss, recordIdFor(1));
+    ASSERT(third);
+    readAhead();
+    ASSERT_EQ(1U, drain(third.get()).first.size());
+}
+
+TEST_F(SharedOplogReaderTest, ReadAheadPastVisiblePointWaits) {
+    insertOplogEntry(kWatchedNss, 1);
+
+    // The subscriber's position was read in a newer snapshot than the one the oplog is read in.
+    auto subscription = reader().subscribe(kWatchedNss, recordIdFor(2));
+    ASSERT(subscription);
+    readAhead();
+    auto [timestamps, detached] = drain(subscription.get());
+    ASSERT(timestamps.empty());
+    ASSERT_FALSE(detached);
+    ASSERT_EQ(1, stats()["positionNotVisible"].numberLong());
+    ASSERT_EQ(0, stats()["fallbacks"].numberLong());
+
+    // Once the position is visible, the reader moves on from it.
+    insertOplogEntry(kWatchedNss, 2);
+    insertOplogEntry(kWatchedNss, 3);
+    readAhead();
+    std::tie(timestamps, detached) = drain(subscription.get());
+    ASSERT_EQ(1U, timestamps.size());
+    ASSERT_EQ(Timestamp(3, 1), timestamps[0]);
+    ASSERT_FALSE(detached);
+}
+
+TEST_F(SharedOplogReaderTest, TruncationPastPositionDetachesSubscribers) {
+    for (unsigned i = 1; i <= 3; ++i) {
+        insertOplogEntry(kWatchedNss, i);
+    }
+
+    auto subscription = reader().subscribe(kWatchedNss, recordIdFor(1));
+    ASSERT(subscription);
+    readAhead();
+    ASSERT_EQ(2U, drain(subscription.get()).first.size());
+
+    insertOplogEntry(kWatchedNss, 4);
+    truncateOplogThrough(3);
+    readAhead();
+    auto [timestamps, detached] = drain(subscription.get());
+    ASSERT(timestamps.empty());
+    ASSERT(detached);
+    ASSERT_EQ(1, stats()["fallbacks"].numberLong());
+    ASSERT_EQ(0, stats()["positionNotVisible"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
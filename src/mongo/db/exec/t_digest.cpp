@@ -0,0 +1,261 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/t_digest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/data_view.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+// Offsets of the header fields.
+constexpr size_t kVersionOffset = 0;
+constexpr size_t kCompressionOffset = 4;
+constexpr size_t kNumCentroidsOffset = 8;
+constexpr size_t kNumBufferedOffset = 12;
+constexpr size_t kTotalWeightOffset = 16;
+constexpr size_t kMinOffset = 24;
+constexpr size_t kMaxOffset = 32;
+
+constexpr size_t kCentroidsOffset = TDigest::kHeaderSize;
+constexpr size_t kBufferOffset = kCentroidsOffset + TDigest::kMaxCentroids * TDigest::kPointSize;
+
+using Point = std::pair<double, double>;  // (mean, weight)
+
+template <typename T>
+T read(const char* buf, size_t offset) {
+    return ConstDataView(buf).read<LittleEndian<T>>(offset);
+}
+
+template <typename T>
+void write(char* buf, size_t offset, T value) {
+    DataView(buf).write<LittleEndian<T>>(value, offset);
+}
+
+Point readPoint(const char* buf, size_t offset) {
+    return {read<double>(buf, offset), read<double>(buf, offset + sizeof(double))};
+}
+
+void writePoint(char* buf, size_t offset, const Point& point) {
+    write<double>(buf, offset, point.first);
+    write<double>(buf, offset + sizeof(double), point.second);
+}
+
+// The k1 scale function and its inverse. A centroid may only grow while it spans at most one unit
+// of 'k', which bounds the number of centroids by 'delta' and keeps the tails finely resolved.
+double scale(double q) {
+    return TDigest::kCompression / (2.0 * M_PI) * std::asin(2.0 * q - 1.0);
+}
+
+double inverseScale(double k) {
+    if (k >= TDigest::kCompression / 4.0) {
+        return 1.0;
+    }
+    return (std::sin(k * 2.0 * M_PI / TDigest::kCompression) + 1.0) / 2.0;
+}
+
+}  // namespace
+
+void TDigest::initialize(char* buf) {
+    std::memset(buf, 0, kSerializedSize);
+    write<uint8_t>(buf, kVersionOffset, kFormatVersion);
+    write<uint32_t>(buf, kCompressionOffset, kCompression);
+    write<double>(buf, kMinOffset, std::numeric_limits<double>::infinity());
+    write<double>(buf, kMaxOffset, -std::numeric_limits<double>::infinity());
+}
+
+void TDigest::assertValid(const char* buf, size_t len) {
+    uassert(6440010,
+            str::stream() << "Invalid t-digest of " << len << " bytes, expected "
+                          << kSerializedSize << " bytes",
+            len == kSerializedSize);
+    uassert(6440011,
+            str::stream() << "Unsupported t-digest format version "
+                          << static_cast<int>(read<uint8_t>(buf, kVersionOffset))
+                          << " with compression " << read<uint32_t>(buf, kCompressionOffset),
+            read<uint8_t>(buf, kVersionOffset) == kFormatVersion &&
+                read<uint32_t>(buf, kCompressionOffset) == kCompression);
+    uassert(6440012,
+            "Corrupt t-digest: too many centroids or buffered points",
+            read<uint32_t>(buf, kNumCentroidsOffset) <= kMaxCentroids &&
+                read<uint32_t>(buf, kNumBufferedOffset) <= kBufferSize);
+}
+
+void TDigest::add(char* buf, double value) {
+    if (std::isnan(value)) {
+        return;
+    }
+    _addWeighted(buf, value, 1.0);
+    write<double>(buf, kMinOffset, std::min(read<double>(buf, kMinOffset), value));
+    write<double>(buf, kMaxOffset, std::max(read<double>(buf, kMaxOffset), value));
+}
+
+void TDigest::merge(char* dst, const char* src) {
+    const auto numCentroids = read<uint32_t>(src, kNumCentroidsOffset);
+    for (uint32_t i = 0; i < numCentroids; ++i) {
+        auto [mean, weight] = readPoint(src, kCentroidsOffset + i * kPointSize);
+        _addWeighted(dst, mean, weight);
+    }
+    const auto numBuffered = read<uint32_t>(src, kNumBufferedOffset);
+    for (uint32_t i = 0; i < numBuffered; ++i) {
+        auto [mean, weight] = readPoint(src, kBufferOffset + i * kPointSize);
+        _addWeighted(dst, mean, weight);
+    }
+    write<double>(dst,
+                  kMinOffset,
+                  std::min(read<double>(dst, kMinOffset), read<double>(src, kMinOffset)));
+    write<double>(dst,
+                  kMaxOffset,
+                  std::max(read<double>(dst, kMaxOffset), read<double>(src, kMaxOffset)));
+}
+
+double TDigest::count(const char* buf) {
+    return read<double>(buf, kTotalWeightOffset);
+}
+
+boost::optional<double> TDigest::quantile(char* buf, double q) {
+    invariant(q >= 0.0 && q <= 1.0);
+    _compress(buf);
+
+    const auto n = read<uint32_t>(buf, kNumCentroidsOffset);
+    if (n == 0) {
+        return boost::none;
+    }
+
+    const double min = read<double>(buf, kMinOffset);
+    const double max = read<double>(buf, kMaxOffset);
+    const double total = read<double>(buf, kTotalWeightOffset);
+    auto centroid = [&](uint32_t i) { return readPoint(buf, kCentroidsOffset + i * kPointSize); };
+
+    if (n == 1 || q == 0.0) {
+        return n == 1 ? centroid(0).first : min;
+    }
+    if (q == 1.0) {
+        return max;
+    }
+
+    // Each centroid is assumed to be centered on its mean: half of its weight lies to the left of
+    // the mean and half to the right. Between centroid centers we interpolate linearly, and in
+    // the tails we interpolate towards the exact minimum and maximum.
+    const double index = q * total;
+    const auto first = centroid(0);
+    if (index < first.second / 2.0) {
+        return min + (index / (first.second / 2.0)) * (first.first - min);
+    }
+    const auto last = centroid(n - 1);
+    if (index > total - last.second / 2.0) {
+        return max - ((total - index) / (last.second / 2.0)) * (max - last.first);
+    }
+
+    double weightSoFar = first.second / 2.0;
+    for (uint32_t i = 0; i + 1 < n; ++i) {
+        const auto left = centroid(i);
+        const auto right = centroid(i + 1);
+        const double gap = (left.second + right.second) / 2.0;
+        if (weightSoFar + gap >= index) {
+            const double fraction = (index - weightSoFar) / gap;
+            return left.first + fraction * (right.first - left.first);
+        }
+        weightSoFar += gap;
+    }
+    return last.first;
+}
+
+void TDigest::_addWeighted(char* buf, double mean, double weight) {
+    if (read<uint32_t>(buf, kNumBufferedOffset) == kBufferSize) {
+        _compress(buf);
+    }
+    const auto numBuffered = read<uint32_t>(buf, kNumBufferedOffset);
+    writePoint(buf, kBufferOffset + numBuffered * kPointSize, {mean, weight});
+    write<uint32_t>(buf, kNumBufferedOffset, numBuffered + 1);
+    write<double>(buf, kTotalWeightOffset, read<double>(buf, kTotalWeightOffset) + weight);
+}
+
+void TDigest::_compress(char* buf) {
+    const auto numBuffered = read<uint32_t>(buf, kNumBufferedOffset);
+    if (numBuffered == 0) {
+        return;
+    }
+    const auto numCentroids = read<uint32_t>(buf, kNumCentroidsOffset);
+
+    std::vector<Point> points;
+    points.reserve(numCentroids + numBuffered);
+    for (uint32_t i = 0; i < numCentroids; ++i) {
+        points.push_back(readPoint(buf, kCentroidsOffset + i * kPointSize));
+    }
+    for (uint32_t i = 0; i < numBuffered; ++i) {
+        points.push_back(readPoint(buf, kBufferOffset + i * kPointSize));
+    }
+    std::sort(points.begin(), points.end(), [](const Point& lhs, const Point& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    const double total = read<double>(buf, kTotalWeightOffset);
+    double weightSoFar = 0.0;
+    double weightLimit = total * inverseScale(scale(0.0) + 1.0);
+    uint32_t numOut = 0;
+    Point current = points.front();
+    for (size_t i = 1; i < points.size(); ++i) {
+        const auto& next = points[i];
+        // The last slot absorbs everything that is left. The merge rule keeps us well clear of
+        // this in practice; it is here only to guarantee that the output fits in the buffer.
+        if (weightSoFar + current.second + next.second <= weightLimit ||
+            numOut + 1 == kMaxCentroids) {
+            const double weight = current.second + next.second;
+            // Skip the update for equal means, which would produce NaN for infinite values.
+            if (next.first != current.first) {
+                current.first += (next.first - current.first) * next.second / weight;
+            }
+            current.second = weight;
+        } else {
+            writePoint(buf, kCentroidsOffset + numOut++ * kPointSize, current);
+            weightSoFar += current.second;
+            weightLimit = total * inverseScale(scale(std::min(weightSoFar / total, 1.0)) + 1.0);
+            current = next;
+        }
+    }
+    writePoint(buf, kCentroidsOffset + numOut++ * kPointSize, current);
+
+    write<uint32_t>(buf, kNumCentroidsOffset, numOut);
+    write<uint32_t>(buf, kNumBufferedOffset, 0);
+}
+
+}  // namespace mongo
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace mongo {
+
+/**
+ * A merging t-digest (Dunning & Ertl, "Computing Extremely Accurate Quantiles Using t-Digests")
+ * for estimating percentiles of a stream of numbers using a fixed amount of memory.
+ *
+ * Like HyperLogLog, the digest operates on a caller-owned byte buffer of exactly 'kSerializedSize'
+ * bytes, which lets the classic and SBE accumulators share one representation that doubles as the
+ * partial result sent from shards to the merging node. Incoming points are appended to a small
+ * buffer; when it fills up, the buffer is sorted and merged into the centroid list under the k1
+ * (arcsine) scale function, which keeps centroids near the tails small and therefore makes the
+ * extreme percentiles the most accurate. All multi-byte fields are stored little-endian.
+ *
+ *     header     format version, centroid count, buffered count, total weight, min, max
+ *     centroids  'kMaxCentroids' (mean, weight) pairs, sorted by mean
+ *     buffer     'kBufferSize' (mean, weight) pairs, unsorted
+ */
+class TDigest {
+public:
+    static constexpr uint8_t kFormatVersion = 1;
+
+    // The compression parameter 'delta'. The merge rule never produces more than delta + 1
+    // centroids.
+    static constexpr int kCompression = 100;
+    static constexpr size_t kMaxCentroids = kCompression + 2;
+    static constexpr size_t kBufferSize = kCompression;
+
+    static constexpr size_t kHeaderSize = 48;
+    static constexpr size_t kPointSize = 2 * sizeof(double);
+    static constexpr size_t kSerializedSize =
+        kHeaderSize + (kMaxCentroids + kBufferSize) * kPointSize;
+
+    /**
+     * Writes an empty digest into 'buf', which must hold at least 'kSerializedSize' bytes.
+     */
+    static void initialize(char* buf);
+
+    /**
+     * Throws if the 'len' bytes starting at 'buf' do not hold a digest that this version of the
+     * server can merge.
+     */
+    static void assertValid(const char* buf, size_t len);
+
+    /**
+     * Records 'value' in the digest stored in 'buf'. NaN values are ignored.
+     */
+    static void add(char* buf, double value);
+
+    /**
+     * Folds the digest 'src' into 'dst'. The result summarizes the union of both input streams.
+     */
+    static void merge(char* dst, const char* src);
+
+    /**
+     * Returns the total number of points recorded in the digest.
+     */
+    static double count(const char* buf);
+
+    /**
+     * Estimates the value at quantile 'q', which must be in [0, 1]. Returns boost::none if the
+     * digest is empty. Flushes any buffered points first, hence the non-const buffer.
+     */
+    static boost::optional<double> quantile(char* buf, double q);
+
+private:
+    static void _addWeighted(char* buf, double mean, double weight);
+    static void _compress(char* buf);
+};
+
+}  // namespace mongo
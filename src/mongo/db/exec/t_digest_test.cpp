@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/t_digest.h"
+
+#include <cmath>
+#include <vector>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<char> makeDigest() {
+    std::vector<char> digest(TDigest::kSerializedSize);
+    TDigest::initialize(digest.data());
+    return digest;
+}
+
+TEST(TDigestTest, EmptyDigestHasNoQuantiles) {
+    auto digest = makeDigest();
+    ASSERT_EQ(TDigest::count(digest.data()), 0);
+    ASSERT_FALSE(TDigest::quantile(digest.data(), 0.5));
+}
+
+TEST(TDigestTest, SingleValue) {
+    auto digest = makeDigest();
+    TDigest::add(digest.data(), 42.0);
+    ASSERT_EQ(*TDigest::quantile(digest.data(), 0.0), 42.0);
+    ASSERT_EQ(*TDigest::quantile(digest.data(), 0.5), 42.0);
+    ASSERT_EQ(*TDigest::quantile(digest.data(), 1.0), 42.0);
+}
+
+TEST(TDigestTest, ExtremesAreExact) {
+    auto digest = makeDigest();
+    for (int i = 0; i < 10000; ++i) {
+        TDigest::add(digest.data(), (i * 7919) % 10000);
+    }
+    ASSERT_EQ(TDigest::count(digest.data()), 10000);
+    ASSERT_EQ(*TDigest::quantile(digest.data(), 0.0), 0.0);
+    ASSERT_EQ(*TDigest::quantile(digest.data(), 1.0), 9999.0);
+}
+
+TEST(TDigestTest, UniformQuantilesAreAccurate) {
+    auto digest = makeDigest();
+    for (int i = 0; i < 100000; ++i) {
+        TDigest::add(digest.data(), (i * 7919) % 100000);
+    }
+    for (double q : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99}) {
+        ASSERT_APPROX_EQUAL(*TDigest::quantile(digest.data(), q), q * 100000, 1000);
+    }
+}
+
+TEST(TDigestTest, IgnoresNaN) {
+    auto digest = makeDigest();
+    TDigest::add(digest.data(), std::nan(""));
+    ASSERT_EQ(TDigest::count(digest.data()), 0);
+}
+
+TEST(TDigestTest, MergeMatchesSingleDigest) {
+    auto left = makeDigest();
+    auto right = makeDigest();
+    for (int i = 0; i < 50000; ++i) {
+        TDigest::add(left.data(), i);
+        TDigest::add(right.data(), 50000 + i);
+    }
+    TDigest::merge(left.data(), right.data());
+    ASSERT_EQ(TDigest::count(left.data()), 100000);
+    ASSERT_APPROX_EQUAL(*TDigest::quantile(left.data(), 0.5), 50000, 1000);
+    ASSERT_APPROX_EQUAL(*TDigest::quantile(left.data(), 0.9), 90000, 1000);
+}
+
+TEST(TDigestTest, RejectsMalformedDigests) {
+    auto digest = makeDigest();
+    ASSERT_THROWS(TDigest::assertValid(digest.data(), digest.size() - 1), DBException);
+
+    digest[0] = TDigest::kFormatVersion + 1;
+    ASSERT_THROWS(TDigest::assertValid(digest.data(), digest.size()), DBException);
+}
+
+}  // namespace
+}  // namespace mongo
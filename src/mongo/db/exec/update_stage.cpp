@@ -40,6 +40,7 @@
 #include "mongo/bson/bson_comparator_interface_base.h"
 #include "mongo/bson/mutable/algorithm.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/shard_filterer_impl.h"
@@ -48,6 +49,7 @@
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/collection_query_info.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/operation_sharding_state.h"
@@ -55,8 +57,10 @@
 #include "mongo/db/s/sharding_write_router.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/duplicate_key_error_info.h"
+#include "mongo/db/update/document_diff_applier.h"
 #include "mongo/db/update/path_support.h"
 #include "mongo/db/update/storage_validation.h"
+#include "mongo/db/update/update_oplog_entry_serialization.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -109,6 +113,78 @@ CollectionUpdateArgs::StoreDocOption getStoreDocMode(const UpdateRequest& update
     invariant(!updateRequest.shouldReturnAnyDocs());
     return CollectionUpdateArgs::StoreDocOption::None;
 }
+
+Counter64 updateDeltaDamagesCount;
+Counter64 updateDeltaDamagesBytesSaved;
+ServerStatusMetricField<Counter64> displayUpdateDeltaDamagesCount("query.updateDeltaDamages",
+                                                                  &updateDeltaDamagesCount);
+ServerStatusMetricField<Counter64> displayUpdateDeltaDamagesBytesSaved(
+    "query.updateDeltaDamagesBytesSaved", &updateDeltaDamagesBytesSaved);
+
+/**
+ * Returns the diff of 'logObj' if it is a $v:2 delta oplog entry. Replacement entries always carry
+ * the _id of the document, which delta entries never do at the top level.
+ */
+boost::optional<doc_diff::Diff> extractDeltaDiff(const BSONObj& logObj) {
+    if (logObj.nFields() != 2 || logObj.hasField(idFieldName) ||
+        update_oplog_entry::extractUpdateType(logObj) !=
+            update_oplog_entry::UpdateType::kV2Delta) {
+        return boost::none;
+    }
+    const auto diffElem = logObj[update_oplog_entry::kDiffObjectFieldName];
+    if (diffElem.type() != BSONType::Object) {
+        return boost::none;
+    }
+    return diffElem.embeddedObject();
+}
+
+/**
+ * The damages which write an update in place, and the number of bytes of the new document which
+ * they do not write.
+ */
+struct DeltaDamages {
+    doc_diff::DamagesOutput output;
+    size_t bytesSaved = 0;
+};
+
+/**
+ * Converts the $v:2 delta logged for an update of 'oldObj' into 'newObj' into damages which can be
+ * applied to the stored document in place. Returns boost::none if the collection or the update
+ * does not allow it, or if the damages would not write much less than 'newObj'.
+ */
+boost::optional<DeltaDamages> computeDeltaDamages(const CollectionPtr& collection,
+                                                  const UpdateDriver& driver,
+                                                  const BSONObj& oldObj,
+                                                  const BSONObj& newObj,
+                                                  const BSONObj& logObj) {
+    const auto maxRatio = internalUpdateDeltaDamagesMaxRatio.load();
+    // The damages bypass the index updates and the capped collection checks of a full update.
+    if (maxRatio <= 0 || driver.modsAffectIndices() || collection->isCapped() ||
+        !collection->updateWithDamagesSupported()) {
+        return boost::none;
+    }
+
+    const auto diff = extractDeltaDiff(logObj);
+    if (!diff) {
+        return boost::none;
+    }
+
+    auto damagesOutput = doc_diff::computeDamages(
+        oldObj, *diff, true /* mustCheckExistenceForInsertOperations */);
+
+    size_t bytesWritten = 0;
+    int64_t sizeChange = 0;
+    for (const auto& damage : damagesOutput.damages) {
+        bytesWritten += damage.sourceSize;
+        sizeChange += static_cast<int64_t>(damage.sourceSize) - damage.targetSize;
+    }
+    dassert(oldObj.objsize() + sizeChange == newObj.objsize());
+    if (damagesOutput.damages.empty() || bytesWritten > maxRatio * newObj.objsize()) {
+        return boost::none;
+    }
+
+    return DeltaDamages{std::move(damagesOutput), newObj.objsize() - bytesWritten};
+}
 }  // namespace
 
 // Public constructor.
@@ -313,14 +389,39 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                     args.preImageDoc = oldObj.value().getOwned();
                 }
 
+                // A small change to a large document is cheaper to write as the damages of its
+                // delta than as the whole new document.
+                const auto deltaDamages =
+                    computeDeltaDamages(collection(), *driver, oldObj.value(), newObj, logObj);
+
                 WriteUnitOfWork wunit(opCtx());
-                newRecordId = collection()->updateDocument(opCtx(),
-                                                           recordId,
-                                                           oldObj,
-                                                           newObj,
-                                                           driver->modsAffectIndices(),
-                                                           _params.opDebug,
-                                                           &args);
+                if (deltaDamages) {
+                    const RecordData oldRec(oldObj.value().objdata(), oldObj.value().objsize());
+                    uassertStatusOK(collection()->updateDocumentWithDamages(
+                        opCtx(),
+                        recordId,
+                        Snapshotted<RecordData>(oldObj.snapshotId(), oldRec),
+                        deltaDamages->output.damageSource.get(),
+                        deltaDamages->output.damages,
+                        &args));
+                    newRecordId = recordId;
+
+                    // Count the update once its storage transaction commits, so that attempts
+                    // which conflict or roll back are not counted.
+                    opCtx()->recoveryUnit()->onCommit(
+                        [bytesSaved = deltaDamages->bytesSaved](auto commitTime) {
+                            updateDeltaDamagesCount.increment();
+                            updateDeltaDamagesBytesSaved.increment(bytesSaved);
+                        });
+                } else {
+                    newRecordId = collection()->updateDocument(opCtx(),
+                                                               recordId,
+                                                               oldObj,
+                                                               newObj,
+                                                               driver->modsAffectIndices(),
+                                                               _params.opDebug,
+                                                               &args);
+                }
                 invariant(oldObj.snapshotId() == opCtx()->recoveryUnit()->getSnapshotId());
                 wunit.commit();
             }
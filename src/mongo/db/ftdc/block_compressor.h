@@ -38,14 +38,19 @@
 namespace mongo {
 
 /**
- * Compesses and uncompresses a block of buffer using zlib.
+ * Compesses and uncompresses a block of buffer using zlib or zstd.
  */
 class BlockCompressor {
     BlockCompressor(const BlockCompressor&) = delete;
     BlockCompressor& operator=(const BlockCompressor&) = delete;
 
 public:
-    BlockCompressor() = default;
+    enum class Algorithm {
+        kZlib,
+        kZstd,
+    };
+
+    explicit BlockCompressor(Algorithm algorithm = Algorithm::kZlib) : _algorithm(algorithm) {}
 
     /**
      * Compress a buffer of data.
@@ -67,6 +72,13 @@ public:
     StatusWith<ConstDataRange> uncompress(ConstDataRange source, size_t maxUncompressedLength);
 
 private:
+    StatusWith<ConstDataRange> _compressZstd(ConstDataRange source);
+    StatusWith<ConstDataRange> _uncompressZstd(ConstDataRange source,
+                                               size_t maxUncompressedLength);
+
+private:
+    const Algorithm _algorithm;
+
     std::vector<std::uint8_t> _buffer;
 };
 
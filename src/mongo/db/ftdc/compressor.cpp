@@ -32,6 +32,8 @@
 #include "mongo/db/ftdc/compressor.h"
 
 #include "mongo/base/data_builder.h"
+#include "mongo/bson/util/simple8b.h"
+#include "mongo/bson/util/simple8b_type_util.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/ftdc/varint.h"
@@ -128,59 +130,80 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     // Append count of samples - uint32 little endian
     _uncompressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_deltaCount));
 
-    if (_metricsCount != 0 && _deltaCount != 0) {
-        // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
-        DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
-
-        std::uint32_t zeroesCount = 0;
-
-        // For each set of samples for a particular metric,
-        // we think of it is simple array of 64-bit integers we try to compress into a byte array.
-        // This is done in three steps for each metric
-        // 1. Delta Compression
-        //   - i.e., we store the difference between pairs of samples, not their absolute values
-        //   - this is done in addSamples
-        // 2. Run Length Encoding of zeros
-        //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
-        //   - Each memeber is stored as VarInt packed integer
-        // 3. Finally, for non-zero members, we store these as VarInt packed
-        //
-        // These byte arrays are added to a buffer which is then concatenated with other chunks and
-        // compressed with ZLIB.
-        for (std::uint32_t i = 0; i < _metricsCount; i++) {
-            for (std::uint32_t j = 0; j < _deltaCount; j++) {
-                std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
-
-                if (delta == 0) {
-                    ++zeroesCount;
-                    continue;
-                }
+    const int headerLength = _uncompressedChunkBuffer.len();
 
-                // If we have a non-zero sample, then write out all the accumulated zero samples.
-                if (zeroesCount > 0) {
-                    auto s1 = db.writeAndAdvance(FTDCVarInt(0));
-                    if (!s1.isOK()) {
-                        return s1;
-                    }
+    _chunkType = FTDCBSONUtil::FTDCType::kMetricChunk;
+    if (_config->metricChunkFormat == FTDCMetricChunkFormat::kZstd) {
+        if (_appendSimple8bDeltas()) {
+            _chunkType = FTDCBSONUtil::FTDCType::kColumnarMetricChunk;
+        } else {
+            _uncompressedChunkBuffer.setlen(headerLength);
+        }
+    }
 
-                    auto s2 = db.writeAndAdvance(FTDCVarInt(zeroesCount - 1));
-                    if (!s2.isOK()) {
-                        return s2;
-                    }
+    if (_chunkType == FTDCBSONUtil::FTDCType::kMetricChunk) {
+        auto status = _appendVarIntDeltas();
+        if (!status.isOK()) {
+            return status;
+        }
+    }
 
-                    zeroesCount = 0;
-                }
+    auto& compressor =
+        _chunkType == FTDCBSONUtil::FTDCType::kMetricChunk ? _compressor : _zstdCompressor;
+    auto swDest = compressor.compress(
+        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()));
 
-                auto s3 = db.writeAndAdvance(FTDCVarInt(delta));
-                if (!s3.isOK()) {
-                    return s3;
-                }
+    // The only way for compression to fail is if the buffer size calculations are wrong
+    if (!swDest.isOK()) {
+        return swDest.getStatus();
+    }
+
+    _compressedChunkBuffer.setlen(0);
+
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_uncompressedChunkBuffer.len()));
+
+    _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
+
+    return std::tuple<ConstDataRange, Date_t>(
+        ConstDataRange(_compressedChunkBuffer.buf(),
+                       static_cast<size_t>(_compressedChunkBuffer.len())),
+        _referenceDocDate);
+}
+
+Status FTDCCompressor::_appendVarIntDeltas() {
+    if (_metricsCount == 0 || _deltaCount == 0) {
+        return Status::OK();
+    }
+
+    // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
+    DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
+
+    std::uint32_t zeroesCount = 0;
+
+    // For each set of samples for a particular metric,
+    // we think of it is simple array of 64-bit integers we try to compress into a byte array.
+    // This is done in three steps for each metric
+    // 1. Delta Compression
+    //   - i.e., we store the difference between pairs of samples, not their absolute values
+    //   - this is done in addSamples
+    // 2. Run Length Encoding of zeros
+    //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
+    //   - Each memeber is stored as VarInt packed integer
+    // 3. Finally, for non-zero members, we store these as VarInt packed
+    //
+    // These byte arrays are added to a buffer which is then concatenated with other chunks and
+    // compressed with ZLIB.
+    for (std::uint32_t i = 0; i < _metricsCount; i++) {
+        for (std::uint32_t j = 0; j < _deltaCount; j++) {
+            std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
+
+            if (delta == 0) {
+                ++zeroesCount;
+                continue;
             }
 
-            // If we are on the last metric, and the previous loop ended in a zero, write out the
-            // RLE
-            // pair of zero information.
-            if ((i == (_metricsCount - 1)) && zeroesCount) {
+            // If we have a non-zero sample, then write out all the accumulated zero samples.
+            if (zeroesCount > 0) {
                 auto s1 = db.writeAndAdvance(FTDCVarInt(0));
                 if (!s1.isOK()) {
                     return s1;
@@ -190,32 +213,66 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
                 if (!s2.isOK()) {
                     return s2;
                 }
+
+                zeroesCount = 0;
+            }
+
+            auto s3 = db.writeAndAdvance(FTDCVarInt(delta));
+            if (!s3.isOK()) {
+                return s3;
             }
         }
 
-        // Append the entire compacted metric chunk into the uncompressed buffer
-        ConstDataRange cdr = db.getCursor();
-        _uncompressedChunkBuffer.appendBuf(cdr.data(), cdr.length());
+        // If we are on the last metric, and the previous loop ended in a zero, write out the
+        // RLE
+        // pair of zero information.
+        if ((i == (_metricsCount - 1)) && zeroesCount) {
+            auto s1 = db.writeAndAdvance(FTDCVarInt(0));
+            if (!s1.isOK()) {
+                return s1;
+            }
+
+            auto s2 = db.writeAndAdvance(FTDCVarInt(zeroesCount - 1));
+            if (!s2.isOK()) {
+                return s2;
+            }
+        }
     }
 
-    auto swDest = _compressor.compress(
-        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()));
+    // Append the entire compacted metric chunk into the uncompressed buffer
+    ConstDataRange cdr = db.getCursor();
+    _uncompressedChunkBuffer.appendBuf(cdr.data(), cdr.length());
 
-    // The only way for compression to fail is if the buffer size calculations are wrong
-    if (!swDest.isOK()) {
-        return swDest.getStatus();
+    return Status::OK();
+}
+
+bool FTDCCompressor::_appendSimple8bDeltas() {
+    if (_metricsCount == 0 || _deltaCount == 0) {
+        return true;
     }
 
-    _compressedChunkBuffer.setlen(0);
+    // All metrics are encoded into a single Simple8b stream, metric by metric. Counters that grow
+    // at a steady rate have a delta-of-delta of zero, which Simple8b run length encodes, and
+    // zigzag encoding keeps small negative values small.
+    Simple8bBuilder<std::uint64_t> builder(
+        [this](std::uint64_t block) { _uncompressedChunkBuffer.appendNum(block); });
 
-    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_uncompressedChunkBuffer.len()));
+    for (std::uint32_t i = 0; i < _metricsCount; i++) {
+        std::uint64_t prevDelta = 0;
+        for (std::uint32_t j = 0; j < _deltaCount; j++) {
+            std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
 
-    _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
+            if (!builder.append(Simple8bTypeUtil::encodeInt64(
+                    static_cast<std::int64_t>(delta - prevDelta)))) {
+                return false;
+            }
 
-    return std::tuple<ConstDataRange, Date_t>(
-        ConstDataRange(_compressedChunkBuffer.buf(),
-                       static_cast<size_t>(_compressedChunkBuffer.len())),
-        _referenceDocDate);
+            prevDelta = delta;
+        }
+    }
+
+    builder.flush();
+    return true;
 }
 
 void FTDCCompressor::reset() {
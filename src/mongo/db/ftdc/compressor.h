@@ -39,6 +39,7 @@
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/ftdc/block_compressor.h"
 #include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -56,6 +57,13 @@ namespace mongo {
  * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
  * 5. ZLIB compresses the final processed array
  *
+ * When FTDCConfig::metricChunkFormat is FTDCMetricChunkFormat::kZstd, steps 3 to 5 are replaced
+ * with
+ * 3. It computes the delta between consecutive deltas of each metric, and zigzag encodes it.
+ * 4. Encodes the series of all metrics into a single stream of Simple8b blocks. See simple8b.h.
+ * 5. ZSTD compresses the final processed array
+ * Chunks with a value Simple8b cannot represent are written in the ZLIB format instead.
+ *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
  */
@@ -80,7 +88,8 @@ public:
         kCompressorFull,
     };
 
-    explicit FTDCCompressor(const FTDCConfig* config) : _config(config) {}
+    explicit FTDCCompressor(const FTDCConfig* config)
+        : _zstdCompressor(BlockCompressor::Algorithm::kZstd), _config(config) {}
 
     /**
      * Add a bson document containing metrics into the compressor.
@@ -128,6 +137,15 @@ public:
      */
     StatusWith<std::tuple<ConstDataRange, Date_t>> getCompressedSamples();
 
+    /**
+     * Returns the type of metric chunk document, FTDCBSONUtil::FTDCType::kMetricChunk or
+     * FTDCBSONUtil::FTDCType::kColumnarMetricChunk, the last buffer returned by addSample() or
+     * getCompressedSamples() has to be stored in.
+     */
+    FTDCBSONUtil::FTDCType getCompressedChunkType() const {
+        return _chunkType;
+    }
+
     /**
      * Reset the state of the compressor.
      *
@@ -150,10 +168,26 @@ private:
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Append the deltas to _uncompressedChunkBuffer as RLE and VarInt encoded integers.
+     */
+    Status _appendVarIntDeltas();
+
+    /**
+     * Append the deltas to _uncompressedChunkBuffer as Simple8b encoded delta-of-deltas.
+     *
+     * Returns false, leaving _uncompressedChunkBuffer in an unspecified state, if a value cannot
+     * be represented in Simple8b.
+     */
+    bool _appendSimple8bDeltas();
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
 
+    // Block Compressor for columnar metric chunks
+    BlockCompressor _zstdCompressor;
+
     // Config
     const FTDCConfig* const _config;
 
@@ -177,6 +211,9 @@ private:
     // _deltas[Metrics][Samples]
     std::vector<std::uint64_t> _deltas;
 
+    // Type of the last compressed metric chunk
+    FTDCBSONUtil::FTDCType _chunkType{FTDCBSONUtil::FTDCType::kMetricChunk};
+
     // Buffer for metric chunk compressed = uncompressed length + compressed data
     BufBuilder _compressedChunkBuffer;
 
@@ -122,8 +122,11 @@ TEST_F(FTDCCompressorTest, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict)
-        : _compressor(&_config), _mode(mode) {}
+    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict,
+            FTDCMetricChunkFormat format = FTDCMetricChunkFormat::kZlib)
+        : _compressor(&_config), _mode(mode) {
+        _config.metricChunkFormat = format;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -155,13 +158,13 @@ public:
     void validate(boost::optional<ConstDataRange> cdr) {
         std::vector<BSONObj> list;
         if (cdr.is_initialized()) {
-            auto sw = _decompressor.uncompress(cdr.get());
+            auto sw = _decompressor.uncompress(cdr.get(), getChunkFormat());
             ASSERT_TRUE(sw.isOK());
             list = sw.getValue();
         } else {
             auto swBuf = _compressor.getCompressedSamples();
             ASSERT_TRUE(swBuf.isOK());
-            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()));
+            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()), getChunkFormat());
             ASSERT_TRUE(sw.isOK());
 
             list = sw.getValue();
@@ -170,6 +173,12 @@ public:
         ValidateDocumentList(list, _docs, _mode);
     }
 
+    FTDCMetricChunkFormat getChunkFormat() const {
+        return _compressor.getCompressedChunkType() == FTDCBSONUtil::FTDCType::kColumnarMetricChunk
+            ? FTDCMetricChunkFormat::kZstd
+            : FTDCMetricChunkFormat::kZlib;
+    }
+
     void setExpectedDocuments(const std::vector<BSONObj>& docs) {
         _docs.clear();
         std::copy(docs.begin(), docs.end(), std::back_inserter(_docs));
@@ -502,6 +511,68 @@ TEST_F(FTDCCompressorTest, TestFull) {
     }
 }
 
+// Test a full buffer of steadily growing counters in the columnar format
+TEST_F(FTDCCompressorTest, TestColumnarFull) {
+    for (int j = 0; j < 2; j++) {
+        TestTie c(FTDCValidationMode::kStrict, FTDCMetricChunkFormat::kZstd);
+
+        auto st = c.addSample(BSON("name"
+                                   << "joe"
+                                   << "key1" << 33 << "key2" << 42));
+        ASSERT_HAS_SPACE(st);
+
+        for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+            st = c.addSample(BSON("name"
+                                  << "joe"
+                                  << "key1" << static_cast<long long int>(i * j) << "key2"
+                                  << static_cast<long long int>(45 - i)));
+            ASSERT_HAS_SPACE(st);
+        }
+
+        st = c.addSample(BSON("name"
+                              << "joe"
+                              << "key1" << 34 << "key2" << 45));
+        ASSERT_FULL(st);
+        ASSERT_TRUE(c.getChunkFormat() == FTDCMetricChunkFormat::kZstd);
+
+        // Add Value
+        st = c.addSample(BSON("name"
+                              << "joe"
+                              << "key1" << 34 << "key2" << 45));
+        ASSERT_HAS_SPACE(st);
+    }
+}
+
+// Test schema changes and the implicit flush in the columnar format
+TEST_F(FTDCCompressorTest, TestColumnarSchemaChanges) {
+    TestTie c(FTDCValidationMode::kStrict, FTDCMetricChunkFormat::kZstd);
+
+    auto st = c.addSample(BSON("name"
+                               << "joe"
+                               << "key1" << 33 << "key2" << 42));
+    ASSERT_HAS_SPACE(st);
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34 << "key2" << -45));
+    ASSERT_HAS_SPACE(st);
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 30 << "key2" << 45));
+    ASSERT_HAS_SPACE(st);
+
+    // Add field
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34 << "key2" << 45 << "key3" << 47));
+    ASSERT_SCHEMA_CHANGED(st);
+    ASSERT_TRUE(c.getChunkFormat() == FTDCMetricChunkFormat::kZstd);
+
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34 << "key2" << 45 << "key3" << 49));
+    ASSERT_HAS_SPACE(st);
+}
+
 template <typename T>
 BSONObj generateSample(std::random_device& rd, T generator, size_t count) {
     BSONObjBuilder builder;
@@ -542,6 +613,29 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     }
 }
 
+// Test that chunks with deltas Simple8b cannot represent fall back to the zlib format
+TEST_F(FTDCCompressorTest, TestColumnarFallback) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    std::uniform_int_distribution<long long> genValues(1, std::numeric_limits<long long>::max());
+    const size_t metrics = 100;
+
+    TestTie c(FTDCValidationMode::kStrict, FTDCMetricChunkFormat::kZstd);
+
+    auto st = c.addSample(generateSample(rd, genValues, metrics));
+    ASSERT_HAS_SPACE(st);
+
+    for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+        st = c.addSample(generateSample(rd, genValues, metrics));
+        ASSERT_HAS_SPACE(st);
+    }
+
+    st = c.addSample(generateSample(rd, genValues, metrics));
+    ASSERT_FULL(st);
+    ASSERT_TRUE(c.getChunkFormat() == FTDCMetricChunkFormat::kZlib);
+}
+
 // Test various non-finite double values
 TEST_F(FTDCCompressorTest, TestDoubleValues) {
     TestTie c;
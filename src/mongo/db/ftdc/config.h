@@ -35,6 +35,22 @@
 
 namespace mongo {
 
+/**
+ * Encoding of the metric chunks written to disk.
+ */
+enum class FTDCMetricChunkFormat {
+    /**
+     * Run length and VarInt encoded deltas, compressed with zlib. Understood by all FTDC readers.
+     */
+    kZlib,
+
+    /**
+     * Simple8b encoded delta-of-deltas of each metric, compressed with zstd. Uses less CPU and
+     * disk than kZlib.
+     */
+    kZstd,
+};
+
 /**
  * Configuration settings for full-time diagnostic data capture (FTDC).
  *
@@ -47,7 +63,8 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          metricChunkFormat(kMetricChunkFormatDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -84,6 +101,11 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Encoding of new metric chunks.
+     */
+    FTDCMetricChunkFormat metricChunkFormat;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -94,6 +116,7 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+    static const FTDCMetricChunkFormat kMetricChunkFormatDefault = FTDCMetricChunkFormat::kZlib;
 };
 
 }  // namespace mongo
@@ -94,6 +94,12 @@ void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
+void FTDCController::setMetricChunkFormat(FTDCMetricChunkFormat format) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    _configTemp.metricChunkFormat = format;
+    _condvar.notify_one();
+}
+
 Status FTDCController::setDirectory(const boost::filesystem::path& path) {
     stdx::lock_guard<Latch> lock(_mutex);
 
@@ -110,6 +116,10 @@ Status FTDCController::setDirectory(const boost::filesystem::path& path) {
     return Status::OK();
 }
 
+boost::filesystem::path FTDCController::getDirectory() {
+    stdx::lock_guard<Latch> lock(_mutex);
+    return _path;
+}
 
 void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
     {
@@ -99,6 +99,11 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set the encoding of new metric chunks.
+     */
+    void setMetricChunkFormat(FTDCMetricChunkFormat format);
+
     /*
      * Set the path to store FTDC files if not already set.
      *
@@ -106,6 +111,11 @@ public:
      */
     Status setDirectory(const boost::filesystem::path& path);
 
+    /**
+     * Get the path FTDC files are stored in, empty if it has not been set.
+     */
+    boost::filesystem::path getDirectory();
+
     /**
      * Add a metric collector to collect periodically. i.e., serverStatus
      */
@@ -33,6 +33,8 @@
 
 #include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_validated.h"
+#include "mongo/bson/util/simple8b.h"
+#include "mongo/bson/util/simple8b_type_util.h"
 #include "mongo/db/ftdc/compressor.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/ftdc/varint.h"
@@ -42,7 +44,8 @@
 
 namespace mongo {
 
-StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf) {
+StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf,
+                                                              FTDCMetricChunkFormat format) {
     ConstDataRangeCursor compressedDataRange(buf);
 
     // Read the length of the uncompressed buffer
@@ -60,7 +63,8 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
         return Status(ErrorCodes::InvalidLength, "Metrics chunk has exceeded the allowable size.");
     }
 
-    auto statusUncompress = _compressor.uncompress(compressedDataRange, uncompressedLength);
+    auto& compressor = format == FTDCMetricChunkFormat::kZstd ? _zstdCompressor : _compressor;
+    auto statusUncompress = compressor.uncompress(compressedDataRange, uncompressedLength);
 
     if (!statusUncompress.isOK()) {
         return {statusUncompress.getStatus()};
@@ -127,26 +131,58 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
     std::vector<std::uint64_t> deltas(metricsCount * sampleCount);
 
     // decompress the deltas
-    std::uint64_t zeroesCount = 0;
+    auto status = format == FTDCMetricChunkFormat::kZstd
+        ? _readSimple8bDeltas(cdc, metricsCount, sampleCount, &deltas)
+        : _readVarIntDeltas(cdc, metricsCount, sampleCount, &deltas);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    // Inflate the deltas
+    for (std::uint32_t i = 0; i < metricsCount; i++) {
+        deltas[FTDCCompressor::getArrayOffset(sampleCount, 0, i)] += metrics[i];
+    }
+
+    for (std::uint32_t i = 0; i < metricsCount; i++) {
+        for (std::uint32_t j = 1; j < sampleCount; j++) {
+            deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] +=
+                deltas[FTDCCompressor::getArrayOffset(sampleCount, j - 1, i)];
+        }
+    }
+
+    for (std::uint32_t i = 0; i < sampleCount; ++i) {
+        for (std::uint32_t j = 0; j < metricsCount; ++j) {
+            metrics[j] = deltas[j * sampleCount + i];
+        }
+
+        docs.emplace_back(FTDCBSONUtil::constructDocumentFromMetrics(ref, metrics).getValue());
+    }
 
-    auto cdrc = ConstDataRangeCursor(cdc);
+    return {docs};
+}
+
+Status FTDCDecompressor::_readVarIntDeltas(ConstDataRangeCursor cdc,
+                                           std::uint32_t metricsCount,
+                                           std::uint32_t sampleCount,
+                                           std::vector<std::uint64_t>* deltas) {
+    std::uint64_t zeroesCount = 0;
 
     for (std::uint32_t i = 0; i < metricsCount; i++) {
         for (std::uint32_t j = 0; j < sampleCount; j++) {
             if (zeroesCount) {
-                deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = 0;
+                (*deltas)[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = 0;
                 zeroesCount--;
                 continue;
             }
 
-            auto swDelta = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+            auto swDelta = cdc.readAndAdvanceNoThrow<FTDCVarInt>();
 
             if (!swDelta.isOK()) {
                 return swDelta.getStatus();
             }
 
             if (swDelta.getValue() == 0) {
-                auto swZero = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+                auto swZero = cdc.readAndAdvanceNoThrow<FTDCVarInt>();
 
                 if (!swZero.isOK()) {
                     return swZero.getStatus();
@@ -155,31 +191,38 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
                 zeroesCount = swZero.getValue();
             }
 
-            deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = swDelta.getValue();
+            (*deltas)[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = swDelta.getValue();
         }
     }
 
-    // Inflate the deltas
-    for (std::uint32_t i = 0; i < metricsCount; i++) {
-        deltas[FTDCCompressor::getArrayOffset(sampleCount, 0, i)] += metrics[i];
+    return Status::OK();
+}
+
+Status FTDCDecompressor::_readSimple8bDeltas(ConstDataRangeCursor cdc,
+                                             std::uint32_t metricsCount,
+                                             std::uint32_t sampleCount,
+                                             std::vector<std::uint64_t>* deltas) {
+    if (cdc.length() % sizeof(std::uint64_t) != 0) {
+        return {ErrorCodes::BadValue, "Metrics chunk is not a sequence of Simple8b blocks"};
     }
 
+    Simple8b<std::uint64_t> s8b(cdc.data(), cdc.length());
+    auto it = s8b.begin();
+    auto end = s8b.end();
+
     for (std::uint32_t i = 0; i < metricsCount; i++) {
-        for (std::uint32_t j = 1; j < sampleCount; j++) {
-            deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] +=
-                deltas[FTDCCompressor::getArrayOffset(sampleCount, j - 1, i)];
-        }
-    }
+        std::uint64_t delta = 0;
+        for (std::uint32_t j = 0; j < sampleCount; j++, ++it) {
+            if (it == end || !*it) {
+                return {ErrorCodes::BadValue, "Metrics chunk has fewer samples than expected"};
+            }
 
-    for (std::uint32_t i = 0; i < sampleCount; ++i) {
-        for (std::uint32_t j = 0; j < metricsCount; ++j) {
-            metrics[j] = deltas[j * sampleCount + i];
+            delta += static_cast<std::uint64_t>(Simple8bTypeUtil::decodeInt64(**it));
+            (*deltas)[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = delta;
         }
-
-        docs.emplace_back(FTDCBSONUtil::constructDocumentFromMetrics(ref, metrics).getValue());
     }
 
-    return {docs};
+    return Status::OK();
 }
 
 }  // namespace mongo
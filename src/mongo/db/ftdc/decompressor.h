@@ -32,8 +32,10 @@
 #include <vector>
 
 #include "mongo/base/data_range.h"
+#include "mongo/base/data_range_cursor.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/ftdc/block_compressor.h"
+#include "mongo/db/ftdc/config.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -54,11 +56,33 @@ public:
      * Will fail if the chunk is corrupt or too short.
      *
      * Returns N samples where N = sample count + 1. The 1 is the reference document.
+     *
+     * format is the encoding of the chunk, see FTDCBSONUtil::FTDCType.
      */
-    StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf);
+    StatusWith<std::vector<BSONObj>> uncompress(
+        ConstDataRange buf, FTDCMetricChunkFormat format = FTDCMetricChunkFormat::kZlib);
+
+private:
+    /**
+     * Decode RLE and VarInt encoded deltas into a M x S array.
+     */
+    static Status _readVarIntDeltas(ConstDataRangeCursor cdc,
+                                    std::uint32_t metricsCount,
+                                    std::uint32_t sampleCount,
+                                    std::vector<std::uint64_t>* deltas);
+
+    /**
+     * Decode Simple8b encoded delta-of-deltas into a M x S array of deltas.
+     */
+    static Status _readSimple8bDeltas(ConstDataRangeCursor cdc,
+                                      std::uint32_t metricsCount,
+                                      std::uint32_t sampleCount,
+                                      std::vector<std::uint64_t>* deltas);
 
 private:
     BlockCompressor _compressor;
+
+    BlockCompressor _zstdCompressor{BlockCompressor::Algorithm::kZstd};
 };
 
 }  // namespace mongo
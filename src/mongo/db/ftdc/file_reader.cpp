@@ -52,11 +52,11 @@ FTDCFileReader::~FTDCFileReader() {
 StatusWith<bool> FTDCFileReader::hasNext() {
     while (true) {
         if (_state == State::kNeedsDoc) {
-            if (_stream.eof()) {
+            if (!_nextDoc && _stream.eof()) {
                 return {false};
             }
 
-            auto swDoc = readDocument();
+            auto swDoc = readNextDocument();
             if (!swDoc.isOK()) {
                 return swDoc.getStatus();
             }
@@ -91,7 +91,22 @@ StatusWith<bool> FTDCFileReader::hasNext() {
                 }
 
                 _metadata = swMetadata.getValue();
-            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk) {
+            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk ||
+                       type == FTDCBSONUtil::FTDCType::kColumnarMetricChunk) {
+                // Metric chunks are written in the order their samples are collected
+                if (_dateId > _maxDate) {
+                    return {false};
+                }
+
+                auto swBeforeMin = isMetricChunkBeforeMinDate();
+                if (!swBeforeMin.isOK()) {
+                    return swBeforeMin.getStatus();
+                }
+
+                if (swBeforeMin.getValue()) {
+                    continue;
+                }
+
                 _state = State::kMetricChunk;
 
                 auto swDocs = FTDCBSONUtil::getMetricsFromMetricDoc(_parent, &_decompressor);
@@ -145,6 +160,44 @@ std::tuple<FTDCBSONUtil::FTDCType, const BSONObj&, Date_t> FTDCFileReader::next(
     MONGO_UNREACHABLE;
 }
 
+StatusWith<BSONObj> FTDCFileReader::readNextDocument() {
+    if (_nextDoc) {
+        BSONObj doc = std::move(*_nextDoc);
+        _nextDoc = boost::none;
+        return {doc};
+    }
+
+    return readDocument();
+}
+
+StatusWith<bool> FTDCFileReader::isMetricChunkBeforeMinDate() {
+    if (_minDate == Date_t::min()) {
+        return {false};
+    }
+
+    // The samples of a chunk were collected before the _id of any document written after it.
+    // Reading ahead reuses _buffer, so both documents need to be owned.
+    _parent = _parent.getOwned();
+
+    auto swDoc = readDocument();
+    if (!swDoc.isOK()) {
+        return swDoc.getStatus();
+    }
+
+    _nextDoc = swDoc.getValue().getOwned();
+    if (_nextDoc->isEmpty()) {
+        return {false};
+    }
+
+    auto swType = FTDCBSONUtil::getBSONDocumentType(*_nextDoc);
+    auto swId = FTDCBSONUtil::getBSONDocumentId(*_nextDoc);
+    if (!swType.isOK() || !swId.isOK() || swType.getValue() == FTDCBSONUtil::FTDCType::kMetadata) {
+        return {false};
+    }
+
+    return {swId.getValue() <= _minDate};
+}
+
 StatusWith<BSONObj> FTDCFileReader::readDocument() {
     if (!_stream.is_open()) {
         return {ErrorCodes::FileNotOpen, "open() needs to be called first."};
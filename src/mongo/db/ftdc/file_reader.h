@@ -75,12 +75,35 @@ public:
      */
     std::tuple<FTDCBSONUtil::FTDCType, const BSONObj&, Date_t> next();
 
+    /**
+     * Restrict the metric documents returned to the chunks that may contain samples collected in
+     * [min, max]. Chunks whose samples were all collected before min are skipped without being
+     * decompressed, and reading stops at the first chunk collected after max. Documents of the
+     * returned chunks outside of the range are not filtered.
+     */
+    void setTimeRange(Date_t min, Date_t max) {
+        _minDate = min;
+        _maxDate = max;
+    }
+
 private:
     /**
      * Read a document from the file. If the file is corrupt, returns an appropriate status.
      */
     StatusWith<BSONObj> readDocument();
 
+    /**
+     * Returns the document read ahead by the time range check if any, and reads a document from
+     * the file otherwise.
+     */
+    StatusWith<BSONObj> readNextDocument();
+
+    /**
+     * Returns true if all samples of the metric chunk in _parent were collected before _minDate.
+     * May read ahead the next document from the file.
+     */
+    StatusWith<bool> isMetricChunkBeforeMinDate();
+
 private:
     FTDCDecompressor _decompressor;
 
@@ -132,6 +155,13 @@ private:
     // Parent document
     BSONObj _parent;
 
+    // Owned document read ahead of _parent, empty if the end of the file was reached
+    boost::optional<BSONObj> _nextDoc;
+
+    // Range of sample times to return
+    Date_t _minDate{Date_t::min()};
+    Date_t _maxDate{Date_t::max()};
+
     // Buffer of data read from disk
     std::vector<char> _buffer;
 
@@ -69,6 +69,23 @@ FTDCController* getGlobalFTDCController() {
  */
 synchronized_value<boost::filesystem::path> ftdcDirectoryPathParameter;
 
+/**
+ * Maps the diagnosticDataCollectionCompressor set parameter to a metric chunk format.
+ */
+StatusWith<FTDCMetricChunkFormat> parseFTDCCompressor(const std::string& value) {
+    if (value == "zlib") {
+        return FTDCMetricChunkFormat::kZlib;
+    }
+
+    if (value == "zstd") {
+        return FTDCMetricChunkFormat::kZstd;
+    }
+
+    return Status(ErrorCodes::BadValue,
+                  str::stream() << "Unsupported diagnosticDataCollectionCompressor '" << value
+                                << "', expected 'zlib' or 'zstd'");
+}
+
 }  // namespace
 
 FTDCStartupParams ftdcStartupParams;
@@ -171,6 +188,24 @@ Status onUpdateFTDCPerInterimUpdate(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status validateFTDCCompressor(const std::string& potentialNewValue) {
+    return parseFTDCCompressor(potentialNewValue).getStatus();
+}
+
+Status onUpdateFTDCCompressor(const std::string& potentialNewValue) {
+    auto swFormat = parseFTDCCompressor(potentialNewValue);
+    if (!swFormat.isOK()) {
+        return swFormat.getStatus();
+    }
+
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        controller->setMetricChunkFormat(swFormat.getValue());
+    }
+
+    return Status::OK();
+}
+
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
                                                                        StringData name,
                                                                        StringData ns,
@@ -288,6 +323,8 @@ void startFTDC(boost::filesystem::path& path,
         ftdcStartupParams.maxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk =
         ftdcStartupParams.maxSamplesPerInterimMetricChunk.load();
+    config.metricChunkFormat =
+        uassertStatusOK(parseFTDCCompressor(ftdcStartupParams.metricChunkCompressor.get()));
 
     ftdcDirectoryPathParameter = path;
 
@@ -39,6 +39,7 @@
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/util/synchronized_value.h"
 
 namespace mongo {
 
@@ -112,6 +113,8 @@ struct FTDCStartupParams {
     AtomicWord<int> maxSamplesPerArchiveMetricChunk;
     AtomicWord<int> maxSamplesPerInterimMetricChunk;
 
+    synchronized_value<std::string> metricChunkCompressor;
+
     FTDCStartupParams()
         : enabled(FTDCConfig::kEnabledDefault),
           periodMillis(FTDCConfig::kPeriodMillisDefault),
@@ -119,7 +122,8 @@ struct FTDCStartupParams {
           maxDirectorySizeMB(FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024)),
           maxFileSizeMB(FTDCConfig::kMaxFileSizeBytesDefault / (1024 * 1024)),
           maxSamplesPerArchiveMetricChunk(FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault),
+          metricChunkCompressor(std::string{"zlib"}) {}
 };
 
 extern FTDCStartupParams ftdcStartupParams;
@@ -133,6 +137,8 @@ Status onUpdateFTDCDirectorySize(std::int32_t value);
 Status onUpdateFTDCFileSize(std::int32_t value);
 Status onUpdateFTDCSamplesPerChunk(std::int32_t value);
 Status onUpdateFTDCPerInterimUpdate(std::int32_t value);
+Status onUpdateFTDCCompressor(const std::string& value);
+Status validateFTDCCompressor(const std::string& value);
 
 /**
  * Server Parameter accessors
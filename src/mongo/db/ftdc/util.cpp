@@ -435,11 +435,13 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date) {
     return builder.obj();
 }
 
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date) {
+BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date, FTDCType type) {
+    dassert(type == FTDCType::kMetricChunk || type == FTDCType::kColumnarMetricChunk);
+
     BSONObjBuilder builder;
 
     builder.appendDate(kFTDCIdField, date);
-    builder.appendNumber(kFTDCTypeField, static_cast<int>(FTDCType::kMetricChunk));
+    builder.appendNumber(kFTDCTypeField, static_cast<int>(type));
     builder.appendBinData(kFTDCDataField, buf.length(), BinDataType::BinDataGeneral, buf.data());
 
     return builder.obj();
@@ -465,6 +467,7 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj) {
     }
 
     if (static_cast<FTDCType>(value) != FTDCType::kMetricChunk &&
+        static_cast<FTDCType>(value) != FTDCType::kColumnarMetricChunk &&
         static_cast<FTDCType>(value) != FTDCType::kMetadata) {
         return {ErrorCodes::BadValue,
                 str::stream() << "Field '" << std::string(kFTDCTypeField)
@@ -492,10 +495,11 @@ StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj) {
 
 StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                                                          FTDCDecompressor* decompressor) {
-    if (kDebugBuild) {
-        auto swType = getBSONDocumentType(obj);
-        dassert(swType.isOK() && swType.getValue() == FTDCType::kMetricChunk);
+    auto swType = getBSONDocumentType(obj);
+    if (!swType.isOK()) {
+        return swType.getStatus();
     }
+    dassert(swType.getValue() != FTDCType::kMetadata);
 
     BSONElement element;
 
@@ -511,7 +515,10 @@ StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                 str::stream() << "Field " << std::string(kFTDCTypeField) << " is not a BinData."};
     }
 
-    return decompressor->uncompress({buffer, static_cast<std::size_t>(length)});
+    return decompressor->uncompress({buffer, static_cast<std::size_t>(length)},
+                                    swType.getValue() == FTDCType::kColumnarMetricChunk
+                                        ? FTDCMetricChunkFormat::kZstd
+                                        : FTDCMetricChunkFormat::kZlib);
 }
 
 }  // namespace FTDCBSONUtil
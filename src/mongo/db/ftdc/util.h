@@ -65,6 +65,14 @@ enum class FTDCType : std::int32_t {
      * See createBSONMetricChunkDocument
      */
     kMetricChunk = 1,
+
+    /**
+     * A columnar metrics chunk is composed of a header + a metric chunk compressed with
+     * FTDCMetricChunkFormat::kZstd.
+     *
+     * See createBSONMetricChunkDocument
+     */
+    kColumnarMetricChunk = 2,
 };
 
 
@@ -148,8 +156,12 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  *  "type" : 1
  *  "data" : BinData(...)
  * }
+ *
+ * type is FTDCType::kColumnarMetricChunk for chunks compressed with FTDCMetricChunkFormat::kZstd.
  */
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
+BSONObj createBSONMetricChunkDocument(ConstDataRange buf,
+                                      Date_t now,
+                                      FTDCType type = FTDCType::kMetricChunk);
 
 /**
  * Get the _id field of a BSON document
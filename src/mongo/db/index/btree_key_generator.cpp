@@ -29,6 +29,8 @@
 
 #include "mongo/db/index/btree_key_generator.h"
 
+#include <algorithm>
+#include <boost/container/small_vector.hpp>
 #include <boost/optional.hpp>
 #include <memory>
 
@@ -52,6 +54,12 @@ const BSONElement nullElt = nullObj.firstElement();
 const BSONObj undefinedObj = BSON("" << BSONUndefined);
 const BSONElement undefinedElt = undefinedObj.firstElement();
 
+// Holds one element per field of the key pattern without allocating for small key patterns.
+using ElementVector = boost::container::small_vector<BSONElement, kFewCompoundIndexFields>;
+
+// The number of fields _extractCompiledElements() can track at one level of a document.
+constexpr size_t kMaxCompiledFieldsPerLevel = 64;
+
 /**
  * Returns the non-array element at the specified path. This function returns an empty BSON element
  * if the path doesn't exist.
@@ -110,6 +118,101 @@ BtreeKeyGenerator::BtreeKeyGenerator(std::vector<const char*> fieldNames,
         _pathsContainPositionalComponent =
             _pathsContainPositionalComponent || fieldRef.hasNumericPathComponents();
     }
+
+    // Positional path components select array elements by position, which the compiled paths
+    // don't support.
+    if (!_pathsContainPositionalComponent) {
+        _compiledPaths = _compilePaths(_fieldNames, _fixed);
+    }
+}
+
+std::shared_ptr<const BtreeKeyGenerator::CompiledPathNode> BtreeKeyGenerator::_compilePaths(
+    const std::vector<const char*>& fieldNames, const std::vector<BSONElement>& fixed) {
+    auto root = std::make_shared<CompiledPathNode>();
+
+    for (size_t i = 0; i < fieldNames.size(); ++i) {
+        if (!fixed[i].eoo()) {
+            return nullptr;
+        }
+
+        auto* node = root.get();
+        FieldRef fieldRef{fieldNames[i]};
+        for (FieldIndex part = 0; part < fieldRef.numParts(); ++part) {
+            auto name = fieldRef.getPart(part);
+            auto child = std::find_if(node->children.begin(),
+                                      node->children.end(),
+                                      [&](const auto& existing) { return existing.name == name; });
+            if (child == node->children.end()) {
+                if (node->children.size() == kMaxCompiledFieldsPerLevel) {
+                    return nullptr;
+                }
+                node->children.push_back({name.toString(), {}, nullptr});
+                child = std::prev(node->children.end());
+            }
+
+            if (part + 1 == fieldRef.numParts()) {
+                child->keyPositions.push_back(i);
+            } else {
+                if (!child->node) {
+                    child->node = std::make_unique<CompiledPathNode>();
+                }
+                node = child->node.get();
+            }
+        }
+    }
+    return root;
+}
+
+bool BtreeKeyGenerator::_extractCompiledElements(const CompiledPathNode& node,
+                                                 const BSONObj& obj,
+                                                 BSONElement* elements) {
+    const auto numChildren = node.children.size();
+    // A field may appear more than once in an object, in which case only its first occurrence is
+    // indexed, the same as with BSONObj::getField().
+    uint64_t foundMask = 0;
+    size_t numFound = 0;
+
+    for (auto&& elem : obj) {
+        auto name = elem.fieldNameStringData();
+        for (size_t i = 0; i < numChildren; ++i) {
+            const auto& child = node.children[i];
+            const uint64_t bit = uint64_t{1} << i;
+            if ((foundMask & bit) || child.name.size() != name.size() || child.name != name) {
+                continue;
+            }
+            foundMask |= bit;
+            ++numFound;
+
+            if (elem.type() == BSONType::Array) {
+                return false;
+            }
+            for (auto position : child.keyPositions) {
+                elements[position] = elem;
+            }
+            if (child.node && elem.type() == BSONType::Object &&
+                !_extractCompiledElements(*child.node, elem.embeddedObject(), elements)) {
+                return false;
+            }
+            break;
+        }
+
+        if (numFound == numChildren) {
+            break;
+        }
+    }
+    return true;
+}
+
+size_t BtreeKeyGenerator::CompiledPathNode::getApproximateSize() const {
+    auto size = sizeof(CompiledPathNode);
+    for (const auto& child : children) {
+        size += sizeof(Child) + child.name.capacity();
+        size += child.keyPositions.capacity() * sizeof(size_t);
+        if (child.node) {
+            size += child.node->getApproximateSize();
+        }
+    }
+    return size;
 }
 
 static void assertParallelArrays(const char* first, const char* second) {
@@ -251,24 +354,33 @@ void BtreeKeyGenerator::getKeys(SharedBufferFragmentBuilder& pooledBufferBuilder
             invariant(multikeyPaths->empty());
             multikeyPaths->resize(_fieldNames.size());
         }
-        // Extract the underlying sequence and insert elements unsorted to avoid O(N^2) when
-        // inserting element by element if array
-        auto seq = keys->extract_sequence();
-        // '_fieldNames' and '_fixed' are mutated by _getKeysWithArray so pass in copies
-        auto fieldNamesCopy = _fieldNames;
-        auto fixedCopy = _fixed;
-        _getKeysWithArray(&fieldNamesCopy,
-                          &fixedCopy,
-                          pooledBufferBuilder,
-                          obj,
-                          &seq,
-                          0,
-                          _emptyPositionalInfo,
-                          multikeyPaths,
-                          id);
-        // Put the sequence back into the set, it will sort and guarantee uniqueness, this is
-        // O(NlogN)
-        keys->adopt_sequence(std::move(seq));
+
+        // Most documents have no array along the indexed paths and generate a single key, which
+        // the compiled paths find with one pass over the document. Fall back to interpreting the
+        // paths on the first array.
+        ElementVector elements(_fieldNames.size());
+        if (_compiledPaths && _extractCompiledElements(*_compiledPaths, obj, elements.data())) {
+            _buildKeyFromElements(pooledBufferBuilder, elements.data(), id, keys);
+        } else {
+            // Extract the underlying sequence and insert elements unsorted to avoid O(N^2) when
+            // inserting element by element if array
+            auto seq = keys->extract_sequence();
+            // '_fieldNames' and '_fixed' are mutated by _getKeysWithArray so pass in copies
+            auto fieldNamesCopy = _fieldNames;
+            auto fixedCopy = _fixed;
+            _getKeysWithArray(&fieldNamesCopy,
+                              &fixedCopy,
+                              pooledBufferBuilder,
+                              obj,
+                              &seq,
+                              0,
+                              _emptyPositionalInfo,
+                              multikeyPaths,
+                              id);
+            // Put the sequence back into the set, it will sort and guarantee uniqueness, this is
+            // O(NlogN)
+            keys->adopt_sequence(std::move(seq));
+        }
     }
 
     if (keys->empty() && !_isSparse) {
@@ -295,6 +407,9 @@ size_t BtreeKeyGenerator::getApproximateSize() const {
     size += _fixed.size() * sizeof(BSONElement);
     size += computePositionalInfoSize(_emptyPositionalInfo);
     size += _pathLengths.size() * sizeof(size_t);
+    if (_compiledPaths) {
+        size += _compiledPaths->getApproximateSize();
+    }
     return size;
 }
 
@@ -310,12 +425,24 @@ void BtreeKeyGenerator::_getKeysWithoutArray(SharedBufferFragmentBuilder& pooled
                                              const BSONObj& obj,
                                              boost::optional<RecordId> id,
                                              KeyStringSet* keys) const {
+    ElementVector elements(_fieldNames.size());
+    if (!_compiledPaths || !_extractCompiledElements(*_compiledPaths, obj, elements.data())) {
+        for (size_t i = 0; i < _fieldNames.size(); ++i) {
+            elements[i] = extractNonArrayElementAtPath(obj, _fieldNames[i]);
+        }
+    }
+    _buildKeyFromElements(pooledBufferBuilder, elements.data(), id, keys);
+}
 
+void BtreeKeyGenerator::_buildKeyFromElements(SharedBufferFragmentBuilder& pooledBufferBuilder,
+                                              const BSONElement* elements,
+                                              boost::optional<RecordId> id,
+                                              KeyStringSet* keys) const {
     KeyString::PooledBuilder keyString{pooledBufferBuilder, _keyStringVersion, _ordering};
     size_t numNotFound{0};
 
-    for (auto&& fieldName : _fieldNames) {
-        auto elem = extractNonArrayElementAtPath(obj, fieldName);
+    for (size_t i = 0; i < _fieldNames.size(); ++i) {
+        const auto& elem = elements[i];
         if (elem.eoo()) {
             ++numNotFound;
         }
@@ -31,6 +31,7 @@
 
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/bson/bsonobj_comparator_interface.h"
@@ -154,6 +155,55 @@ private:
                            MultikeyPaths* multikeyPaths,
                            boost::optional<RecordId> id) const;
 
+    /**
+     * The indexed paths compiled into a tree of the field names to look for at each level of a
+     * document. It lets the key generator find the elements of all the indexed paths with a single
+     * pass over each object along them, instead of one lookup per path and path component.
+     */
+    struct CompiledPathNode {
+        struct Child {
+            std::string name;
+
+            // The positions in the key pattern of the indexed paths which end at this field.
+            std::vector<size_t> keyPositions;
+
+            // The fields to look for in the value of this field, if an indexed path continues past
+            // it. Null otherwise.
+            std::unique_ptr<CompiledPathNode> node;
+        };
+
+        size_t getApproximateSize() const;
+
+        std::vector<Child> children;
+    };
+
+    /**
+     * Compiles 'fieldNames' into a tree of CompiledPathNode. Returns null if the paths can't be
+     * handled by _extractCompiledElements(), in which case keys are always generated by
+     * interpreting the paths.
+     */
+    static std::shared_ptr<const CompiledPathNode> _compilePaths(
+        const std::vector<const char*>& fieldNames, const std::vector<BSONElement>& fixed);
+
+    /**
+     * Stores in 'elements' the element of 'obj' at each indexed path below 'node', leaving the
+     * elements of missing paths untouched. Returns false as soon as an array is found along one of
+     * the paths, in which case the contents of 'elements' are unspecified and the caller must
+     * generate the keys with _getKeysWithArray() instead.
+     */
+    static bool _extractCompiledElements(const CompiledPathNode& node,
+                                         const BSONObj& obj,
+                                         BSONElement* elements);
+
+    /**
+     * Builds the single key made of 'elements', one per field of the key pattern, and adds it to
+     * 'keys'. Missing elements are EOO.
+     */
+    void _buildKeyFromElements(SharedBufferFragmentBuilder& pooledBufferBuilder,
+                               const BSONElement* elements,
+                               boost::optional<RecordId> id,
+                               KeyStringSet* keys) const;
+
     /**
      * An optimized version of the key generation algorithm to be used when it is known that 'obj'
      * doesn't contain an array value in any of the fields in the key pattern.
@@ -247,6 +297,10 @@ private:
     // the vector is the number of path components in the indexed field.
     std::vector<size_t> _pathLengths;
 
+    // The indexed paths compiled at construction, or null if the key pattern has positional path
+    // components or fixed fields. Shared between copies, as it is never modified.
+    std::shared_ptr<const CompiledPathNode> _compiledPaths;
+
     // Null if this key generator orders strings according to the simple binary compare. If
     // non-null, represents the collator used to generate index keys for indexed strings.
     const CollatorInterface* _collator;
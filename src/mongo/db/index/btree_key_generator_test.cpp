@@ -1421,4 +1421,48 @@ TEST(BtreeKeyGeneratorTest, GetCollationAwareKeysFromNestedArray) {
         testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths, false, &collator));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysUsesFirstOccurrenceOfDuplicateField) {
+    BSONObj keyPattern = fromjson("{a: 1, b: 1}");
+    BSONObj genKeysFrom = BSON("a" << 1 << "b" << 2 << "a" << 3);
+    KeyString::HeapBuilder keyString(
+        KeyString::Version::kLatestVersion, fromjson("{'': 1, '': 2}"), Ordering::make(BSONObj()));
+    KeyStringSet expectedKeys{keyString.release()};
+    MultikeyPaths expectedMultikeyPaths{MultikeyComponents{}, MultikeyComponents{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromPathsSharingAPrefix) {
+    BSONObj keyPattern = fromjson("{'a.b.c': 1, a: 1, 'a.d': 1, 'a.b.e': 1}");
+    BSONObj genKeysFrom = fromjson("{a: {d: 3, b: {e: 4, c: 5}}, z: 6}");
+    KeyString::HeapBuilder keyString(KeyString::Version::kLatestVersion,
+                                     fromjson("{'': 5, '': {d: 3, b: {e: 4, c: 5}}, '': 3, '': 4}"),
+                                     Ordering::make(BSONObj()));
+    KeyStringSet expectedKeys{keyString.release()};
+    MultikeyPaths expectedMultikeyPaths(4);
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromScalarAlongDottedPath) {
+    BSONObj keyPattern = fromjson("{'a.b': 1, c: 1}");
+    BSONObj genKeysFrom = fromjson("{a: 1, c: 2}");
+    KeyString::HeapBuilder keyString(KeyString::Version::kLatestVersion,
+                                     fromjson("{'': null, '': 2}"),
+                                     Ordering::make(BSONObj()));
+    KeyStringSet expectedKeys{keyString.release()};
+    MultikeyPaths expectedMultikeyPaths{MultikeyComponents{}, MultikeyComponents{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromArrayAfterNonArrayPathsFallsBackToArrayExpansion) {
+    BSONObj keyPattern = fromjson("{a: 1, 'b.c.d': 1}");
+    BSONObj genKeysFrom = fromjson("{a: 1, b: {c: {d: [2, 3]}}}");
+    KeyString::HeapBuilder keyString1(
+        KeyString::Version::kLatestVersion, fromjson("{'': 1, '': 2}"), Ordering::make(BSONObj()));
+    KeyString::HeapBuilder keyString2(
+        KeyString::Version::kLatestVersion, fromjson("{'': 1, '': 3}"), Ordering::make(BSONObj()));
+    KeyStringSet expectedKeys{keyString1.release(), keyString2.release()};
+    MultikeyPaths expectedMultikeyPaths{MultikeyComponents{}, {2U}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
 }  // namespace
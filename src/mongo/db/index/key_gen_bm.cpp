@@ -29,8 +29,10 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <benchmark/benchmark.h>
 #include <random>
+#include <vector>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/index/btree_key_generator.h"
@@ -165,6 +167,82 @@ void BM_KeyGenArrayOfArray(benchmark::State& state, int32_t elements) {
     }
 }
 
+std::vector<BSONObj> makeBatch(int32_t numDocs) {
+    std::mt19937 gen(numGen());
+
+    std::vector<BSONObj> docs;
+    docs.reserve(numDocs);
+    for (int32_t i = 0; i < numDocs; ++i) {
+        docs.push_back(BSON("_id" << i << kFieldName << static_cast<int32_t>(gen())));
+    }
+    return docs;
+}
+
+// Generates the keys of a batch of documents into one set, merging each document's keys into the
+// set as they are generated.
+void BM_KeyGenBatchPerDocument(benchmark::State& state, int32_t numDocs) {
+    auto docs = makeBatch(numDocs);
+
+    BtreeKeyGenerator generator({kFieldName},
+                                {BSONElement{}},
+                                false,
+                                nullptr,
+                                KeyString::Version::kLatestVersion,
+                                makeOrdering(kFieldName));
+
+    SharedBufferFragmentBuilder allocator(kMemBlockSize,
+                                          SharedBufferFragmentBuilder::ConstantGrowStrategy());
+    KeyStringSet keys;
+    KeyStringSet batchKeys;
+    MultikeyPaths multikeyPaths;
+
+    for (auto _ : state) {
+        for (int32_t i = 0; i < numDocs; ++i) {
+            generator.getKeys(allocator, docs[i], false, &keys, &multikeyPaths, RecordId(i + 1));
+            batchKeys.insert(keys.begin(), keys.end());
+            keys.clear();
+            multikeyPaths.clear();
+        }
+        benchmark::ClobberMemory();
+        batchKeys.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * numDocs);
+}
+
+// Generates the keys of a batch of documents and sorts them once for the whole batch, the way
+// inserts into a collection index them.
+void BM_KeyGenBatchSorted(benchmark::State& state, int32_t numDocs) {
+    auto docs = makeBatch(numDocs);
+
+    BtreeKeyGenerator generator({kFieldName},
+                                {BSONElement{}},
+                                false,
+                                nullptr,
+                                KeyString::Version::kLatestVersion,
+                                makeOrdering(kFieldName));
+
+    SharedBufferFragmentBuilder allocator(kMemBlockSize,
+                                          SharedBufferFragmentBuilder::ConstantGrowStrategy());
+    KeyStringSet keys;
+    KeyStringSet batchKeys;
+    MultikeyPaths multikeyPaths;
+
+    for (auto _ : state) {
+        KeyStringSet::sequence_type sequence;
+        for (int32_t i = 0; i < numDocs; ++i) {
+            generator.getKeys(allocator, docs[i], false, &keys, &multikeyPaths, RecordId(i + 1));
+            sequence.insert(sequence.end(), keys.begin(), keys.end());
+            keys.clear();
+            multikeyPaths.clear();
+        }
+        std::sort(sequence.begin(), sequence.end());
+        batchKeys.adopt_sequence(boost::container::ordered_unique_range, std::move(sequence));
+        benchmark::ClobberMemory();
+        batchKeys.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * numDocs);
+}
+
 BENCHMARK_CAPTURE(BM_KeyGenBasic, Generic, false);
 BENCHMARK_CAPTURE(BM_KeyGenBasic, SkipMultikey, true);
 
@@ -180,5 +258,10 @@ BENCHMARK_CAPTURE(BM_KeyGenArrayOfArray, 10x10, 10);
 BENCHMARK_CAPTURE(BM_KeyGenArrayOfArray, 100x100, 100);
 BENCHMARK_CAPTURE(BM_KeyGenArrayOfArray, 1Kx1K, 1000);
 
+BENCHMARK_CAPTURE(BM_KeyGenBatchPerDocument, 64, 64);
+BENCHMARK_CAPTURE(BM_KeyGenBatchPerDocument, 1K, 1000);
+BENCHMARK_CAPTURE(BM_KeyGenBatchSorted, 64, 64);
+BENCHMARK_CAPTURE(BM_KeyGenBatchSorted, 1K, 1000);
+
 }  // namespace
 }  // namespace mongo
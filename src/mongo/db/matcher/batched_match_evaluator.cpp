@@ -0,0 +1,290 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/batched_match_evaluator.h"
+
+#include <cmath>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns true if 'expr' is a leaf whose result for a document with a non-array value at its path
+ * is exactly matchesSingleElement() of that value, and whose path is a single top-level field.
+ */
+bool isCompilableLeaf(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::EXISTS:
+        case MatchExpression::MATCH_IN:
+        case MatchExpression::BITS_ALL_SET:
+        case MatchExpression::BITS_ALL_CLEAR:
+        case MatchExpression::BITS_ANY_SET:
+        case MatchExpression::BITS_ANY_CLEAR:
+        case MatchExpression::TYPE_OPERATOR:
+            break;
+        default:
+            return false;
+    }
+    auto fieldRef = expr->fieldRef();
+    return fieldRef && fieldRef->numParts() == 1 && !fieldRef->getPart(0).empty();
+}
+
+bool isComparison(MatchExpression::MatchType matchType) {
+    switch (matchType) {
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template <typename T>
+bool compareValues(MatchExpression::MatchType matchType, T lhs, T rhs) {
+    switch (matchType) {
+        case MatchExpression::EQ:
+            return lhs == rhs;
+        case MatchExpression::LTE:
+            return lhs <= rhs;
+        case MatchExpression::LT:
+            return lhs < rhs;
+        case MatchExpression::GT:
+            return lhs > rhs;
+        case MatchExpression::GTE:
+            return lhs >= rhs;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+/**
+ * Keeps only the entries of 'selection' for which 'predicate' returns true, preserving order.
+ */
+template <typename Predicate>
+void narrowSelection(std::vector<size_t>* selection, Predicate predicate) {
+    size_t numSelected = 0;
+    for (auto idx : *selection) {
+        (*selection)[numSelected] = idx;
+        numSelected += predicate(idx) ? 1 : 0;
+    }
+    selection->resize(numSelected);
+}
+
+}  // namespace
+
+std::unique_ptr<BatchedMatchEvaluator> BatchedMatchEvaluator::compile(const MatchExpression* expr) {
+    std::unique_ptr<BatchedMatchEvaluator> evaluator(new BatchedMatchEvaluator());
+
+    auto addConjunct = [&](const MatchExpression* conjunct) {
+        if (!isCompilableLeaf(conjunct)) {
+            evaluator->_residual.push_back(conjunct);
+            return;
+        }
+
+        auto column = evaluator->columnFor(conjunct->fieldRef()->getPart(0));
+        if (column == kMaxColumns) {
+            evaluator->_residual.push_back(conjunct);
+            return;
+        }
+
+        CompiledLeaf leaf{conjunct, LeafKind::kGeneric, column};
+        if (conjunct->matchType() == MatchExpression::EXISTS) {
+            leaf.kind = LeafKind::kExists;
+        } else if (isComparison(conjunct->matchType())) {
+            auto rhs = static_cast<const ComparisonMatchExpressionBase*>(conjunct)->getData();
+            if (rhs.type() == NumberInt || rhs.type() == NumberLong) {
+                leaf.kind = LeafKind::kCompareIntegral;
+                leaf.integralRhs = rhs.safeNumberLong();
+            } else if (rhs.type() == NumberDouble && !std::isnan(rhs._numberDouble())) {
+                leaf.kind = LeafKind::kCompareDouble;
+                leaf.doubleRhs = rhs._numberDouble();
+            }
+        }
+        evaluator->_leaves.push_back(leaf);
+    };
+
+    // Nested $and nodes are flattened into a single list of conjuncts.
+    std::vector<const MatchExpression*> toVisit{expr};
+    while (!toVisit.empty()) {
+        auto node = toVisit.back();
+        toVisit.pop_back();
+        if (node->matchType() != MatchExpression::AND) {
+            addConjunct(node);
+            continue;
+        }
+        for (size_t i = node->numChildren(); i > 0; --i) {
+            toVisit.push_back(node->getChild(i - 1));
+        }
+    }
+
+    if (evaluator->_leaves.empty()) {
+        return nullptr;
+    }
+    return evaluator;
+}
+
+size_t BatchedMatchEvaluator::columnFor(StringData fieldName) {
+    for (size_t column = 0; column < _fieldNames.size(); ++column) {
+        if (_fieldNames[column] == fieldName) {
+            return column;
+        }
+    }
+    if (_fieldNames.size() == kMaxColumns) {
+        return kMaxColumns;
+    }
+    _fieldNames.push_back(fieldName.toString());
+    return _fieldNames.size() - 1;
+}
+
+void BatchedMatchEvaluator::extractColumns(const BSONObj* docs, size_t numDocs) {
+    const size_t numColumns = _fieldNames.size();
+    _columns.assign(numColumns * numDocs, BSONElement());
+
+    for (size_t i = 0; i < numDocs; ++i) {
+        size_t numMissing = numColumns;
+        BSONObjIterator it(docs[i]);
+        while (numMissing > 0 && it.more()) {
+            auto elem = it.next();
+            auto fieldName = elem.fieldNameStringData();
+            for (size_t column = 0; column < numColumns; ++column) {
+                // Like BSONObj::getField(), the first occurrence of a duplicated field wins.
+                auto& cell = _columns[column * numDocs + i];
+                if (cell.eoo() && fieldName == _fieldNames[column]) {
+                    cell = elem;
+                    --numMissing;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void BatchedMatchEvaluator::evaluateLeaf(const CompiledLeaf& leaf,
+                                         const BSONObj* docs,
+                                         size_t numDocs,
+                                         std::vector<size_t>* selection) const {
+    const BSONElement* column = &_columns[leaf.column * numDocs];
+    const auto matchType = leaf.expr->matchType();
+
+    // Arrays are traversed by the ElementPath, so they are evaluated against the whole document.
+    auto matchesElement = [&](size_t idx) {
+        const auto& elem = column[idx];
+        if (elem.type() == Array) {
+            return leaf.expr->matchesBSON(docs[idx]);
+        }
+        return leaf.expr->matchesSingleElement(elem);
+    };
+
+    switch (leaf.kind) {
+        case LeafKind::kCompareIntegral:
+            narrowSelection(selection, [&](size_t idx) {
+                const auto& elem = column[idx];
+                switch (elem.type()) {
+                    case NumberInt:
+                        return compareValues<long long>(
+                            matchType, elem._numberInt(), leaf.integralRhs);
+                    case NumberLong:
+                        return compareValues<long long>(
+                            matchType, elem._numberLong(), leaf.integralRhs);
+                    default:
+                        return matchesElement(idx);
+                }
+            });
+            return;
+        case LeafKind::kCompareDouble:
+            narrowSelection(selection, [&](size_t idx) {
+                const auto& elem = column[idx];
+                if (elem.type() == NumberDouble && !std::isnan(elem._numberDouble())) {
+                    return compareValues(matchType, elem._numberDouble(), leaf.doubleRhs);
+                }
+                return matchesElement(idx);
+            });
+            return;
+        case LeafKind::kExists:
+            narrowSelection(selection, [&](size_t idx) {
+                const auto& elem = column[idx];
+                if (elem.type() != Array) {
+                    return !elem.eoo();
+                }
+                return matchesElement(idx);
+            });
+            return;
+        case LeafKind::kGeneric:
+            narrowSelection(selection, matchesElement);
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void BatchedMatchEvaluator::filter(const BSONObj* docs,
+                                   size_t numDocs,
+                                   std::vector<size_t>* selection) {
+    selection->resize(numDocs);
+    for (size_t i = 0; i < numDocs; ++i) {
+        (*selection)[i] = i;
+    }
+
+    extractColumns(docs, numDocs);
+    for (auto&& leaf : _leaves) {
+        if (selection->empty()) {
+            return;
+        }
+        evaluateLeaf(leaf, docs, numDocs, selection);
+    }
+
+    for (auto&& predicate : _residual) {
+        if (selection->empty()) {
+            return;
+        }
+        narrowSelection(selection, [&](size_t idx) { return predicate->matchesBSON(docs[idx]); });
+    }
+}
+
+bool BatchedMatchEvaluator::matches(const BSONObj& doc) {
+    filter(&doc, 1, &_singleDocSelection);
+    return !_singleDocSelection.empty();
+}
+
+}  // namespace mongo
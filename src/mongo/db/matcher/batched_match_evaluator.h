@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+/**
+ * Evaluates a MatchExpression over a batch of BSON documents at a time, rather than walking an
+ * ElementPath through each document for each leaf.
+ *
+ * The expression is compiled once: each top-level conjunct which is a leaf predicate over a
+ * non-dotted path is assigned a column slot. Evaluating a batch first extracts all of these
+ * fields from each document in a single pass over its elements, and then runs each compiled leaf
+ * as a tight loop over its column, narrowing a selection vector of the documents which still
+ * match. Integral and double comparisons are evaluated inline; other leaves are evaluated with
+ * matchesSingleElement() against the extracted element. Documents whose value for a compiled
+ * field is an array, as well as any conjuncts which could not be compiled (dotted paths, $or,
+ * $elemMatch, $expr, ...), fall back to the regular matchesBSON() path.
+ *
+ * The evaluator keeps scratch space between calls and thus is not thread-safe. The compiled
+ * expression must outlive it.
+ */
+class BatchedMatchEvaluator {
+public:
+    /**
+     * The maximum number of distinct top-level fields which are extracted into columns. Leaves
+     * over any further fields are evaluated as residual predicates.
+     */
+    static constexpr size_t kMaxColumns = 16;
+
+    /**
+     * Returns an evaluator for 'expr', or nullptr if no part of 'expr' can be compiled, in which
+     * case there is no benefit over calling matchesBSON() directly.
+     */
+    static std::unique_ptr<BatchedMatchEvaluator> compile(const MatchExpression* expr);
+
+    /**
+     * Evaluates the expression against 'docs[0, numDocs)' and fills 'selection' with the indexes,
+     * in increasing order, of the documents which match.
+     */
+    void filter(const BSONObj* docs, size_t numDocs, std::vector<size_t>* selection);
+
+    /**
+     * Evaluates the expression against a single document. Equivalent to
+     * 'expr->matchesBSON(doc)'.
+     */
+    bool matches(const BSONObj& doc);
+
+    size_t numCompiledLeaves() const {
+        return _leaves.size();
+    }
+
+    size_t numResidualPredicates() const {
+        return _residual.size();
+    }
+
+private:
+    /**
+     * The strategy used to evaluate a compiled leaf against a non-array element.
+     */
+    enum class LeafKind {
+        // $eq, $lt, $lte, $gt or $gte against a NumberInt or NumberLong constant. Integral
+        // elements are compared inline.
+        kCompareIntegral,
+        // $eq, $lt, $lte, $gt or $gte against a non-NaN double constant. Non-NaN double elements
+        // are compared inline.
+        kCompareDouble,
+        // $exists.
+        kExists,
+        // Any other leaf, evaluated with matchesSingleElement().
+        kGeneric,
+    };
+
+    struct CompiledLeaf {
+        const MatchExpression* expr;
+        LeafKind kind;
+        size_t column;
+        long long integralRhs = 0;
+        double doubleRhs = 0;
+    };
+
+    BatchedMatchEvaluator() = default;
+
+    size_t columnFor(StringData fieldName);
+
+    /**
+     * Fills '_columns' with the fields referenced by the compiled leaves, column-major, with EOO
+     * elements for missing fields.
+     */
+    void extractColumns(const BSONObj* docs, size_t numDocs);
+
+    void evaluateLeaf(const CompiledLeaf& leaf,
+                      const BSONObj* docs,
+                      size_t numDocs,
+                      std::vector<size_t>* selection) const;
+
+    std::vector<std::string> _fieldNames;
+    std::vector<CompiledLeaf> _leaves;
+    std::vector<const MatchExpression*> _residual;
+
+    // Scratch space reused across batches.
+    std::vector<BSONElement> _columns;
+    std::vector<size_t> _singleDocSelection;
+};
+
+}  // namespace mongo
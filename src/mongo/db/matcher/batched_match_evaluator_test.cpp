@@ -0,0 +1,209 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/batched_match_evaluator.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const std::vector<BSONObj> kDocs = {
+    fromjson("{}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: 5, b: 'foo'}"),
+    fromjson("{a: NumberLong(5), b: 'FOO'}"),
+    fromjson("{a: 5.0, b: 'bar'}"),
+    fromjson("{a: 5.5, b: null}"),
+    fromjson("{a: NaN, b: undefined}"),
+    fromjson("{a: NumberDecimal('5'), b: 1}"),
+    fromjson("{a: '5', b: {c: 1}}"),
+    fromjson("{a: null, b: [1, 2]}"),
+    fromjson("{a: [1, 5, 10], b: []}"),
+    fromjson("{a: [[5]], b: [{c: 1}, {c: 2}]}"),
+    fromjson("{a: [], b: [null]}"),
+    fromjson("{a: {b: 5}, c: 1}"),
+    fromjson("{a: {$minKey: 1}, b: {$maxKey: 1}}"),
+    fromjson("{a: 10, a: 1, b: 'foo'}"),
+    fromjson("{c: 1, b: 'foo', a: 7}"),
+    fromjson("{a: -0.0, b: 0}"),
+    fromjson("{a: 9007199254740993, b: 9007199254740992.0}"),
+};
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& query,
+                                       const CollatorInterface* collator = nullptr) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    expCtx->setCollator(collator ? collator->clone() : nullptr);
+    auto expr = MatchExpressionParser::parse(query, expCtx);
+    ASSERT_OK(expr.getStatus());
+    return std::move(expr.getValue());
+}
+
+/**
+ * Asserts that evaluating 'query' in batches returns the same documents as calling matchesBSON()
+ * on each document, and returns the evaluator for further inspection.
+ */
+std::unique_ptr<BatchedMatchEvaluator> assertMatchesLikeMatchesBSON(
+    const char* query, const CollatorInterface* collator = nullptr) {
+    auto expr = parse(fromjson(query), collator);
+    auto evaluator = BatchedMatchEvaluator::compile(expr.get());
+    ASSERT(evaluator) << query;
+
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < kDocs.size(); ++i) {
+        if (expr->matchesBSON(kDocs[i])) {
+            expected.push_back(i);
+        }
+        ASSERT_EQ(evaluator->matches(kDocs[i]), expr->matchesBSON(kDocs[i]))
+            << query << " " << kDocs[i];
+    }
+
+    std::vector<size_t> selection;
+    evaluator->filter(kDocs.data(), kDocs.size(), &selection);
+    ASSERT(selection == expected) << query;
+
+    // Reusing the evaluator for a batch of a different size produces the same results.
+    evaluator->filter(kDocs.data() + 1, kDocs.size() - 1, &selection);
+    for (auto&& idx : selection) {
+        ++idx;
+    }
+    expected.erase(std::remove(expected.begin(), expected.end(), 0), expected.end());
+    ASSERT(selection == expected) << query;
+
+    return evaluator;
+}
+
+TEST(BatchedMatchEvaluatorTest, ComparisonsMatchLikeMatchesBSON) {
+    for (auto&& op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        for (auto&& rhs : {"5",
+                           "NumberLong(5)",
+                           "5.0",
+                           "5.5",
+                           "NaN",
+                           "NumberDecimal('5')",
+                           "'5'",
+                           "null",
+                           "{$minKey: 1}",
+                           "{$maxKey: 1}",
+                           "{b: 5}",
+                           "9007199254740992",
+                           "-0.0"}) {
+            auto query = std::string("{a: {") + op + ": " + rhs + "}}";
+            auto evaluator = assertMatchesLikeMatchesBSON(query.c_str());
+            ASSERT_EQ(evaluator->numCompiledLeaves(), 1U);
+            ASSERT_EQ(evaluator->numResidualPredicates(), 0U);
+        }
+    }
+}
+
+TEST(BatchedMatchEvaluatorTest, OtherLeavesMatchLikeMatchesBSON) {
+    for (auto&& query : {"{a: {$exists: true}}",
+                         "{a: {$in: [1, '5', null]}}",
+                         "{a: {$in: [/^5/]}}",
+                         "{b: /^f/}",
+                         "{b: {$regex: '^f', $options: 'i'}}",
+                         "{a: {$mod: [5, 0]}}",
+                         "{a: {$type: 'number'}}",
+                         "{a: {$type: 'array'}}",
+                         "{a: {$bitsAllSet: 1}}",
+                         "{a: {$bitsAnyClear: 4}}"}) {
+        assertMatchesLikeMatchesBSON(query);
+    }
+}
+
+TEST(BatchedMatchEvaluatorTest, ConjunctionsMatchLikeMatchesBSON) {
+    auto evaluator = assertMatchesLikeMatchesBSON("{a: {$gte: 1, $lt: 10}, b: 'foo'}");
+    ASSERT_EQ(evaluator->numCompiledLeaves(), 3U);
+    ASSERT_EQ(evaluator->numResidualPredicates(), 0U);
+
+    evaluator = assertMatchesLikeMatchesBSON("{a: {$exists: true}, b: {$in: [null, 1]}, c: 1}");
+    ASSERT_EQ(evaluator->numCompiledLeaves(), 3U);
+}
+
+TEST(BatchedMatchEvaluatorTest, DottedPathsAndNonLeavesFallBack) {
+    auto evaluator = assertMatchesLikeMatchesBSON("{a: {$gt: 0}, 'b.c': 1}");
+    ASSERT_EQ(evaluator->numCompiledLeaves(), 1U);
+    ASSERT_EQ(evaluator->numResidualPredicates(), 1U);
+
+    evaluator = assertMatchesLikeMatchesBSON(
+        "{a: {$ne: 5}, b: {$elemMatch: {c: 1}}, $or: [{c: 1}, {b: 'foo'}], 'a.b': {$gt: 1}, "
+        "c: {$exists: true}}");
+    ASSERT_EQ(evaluator->numCompiledLeaves(), 1U);
+    ASSERT_EQ(evaluator->numResidualPredicates(), 4U);
+}
+
+TEST(BatchedMatchEvaluatorTest, CompileReturnsNullWhenNothingCanBeCompiled) {
+    auto expr = parse(fromjson("{'a.b': 1}"));
+    ASSERT_FALSE(BatchedMatchEvaluator::compile(expr.get()));
+
+    expr = parse(fromjson("{$or: [{a: 1}, {b: 1}]}"));
+    ASSERT_FALSE(BatchedMatchEvaluator::compile(expr.get()));
+
+    expr = parse(fromjson("{a: {$size: 1}}"));
+    ASSERT_FALSE(BatchedMatchEvaluator::compile(expr.get()));
+}
+
+TEST(BatchedMatchEvaluatorTest, StringComparisonsRespectCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    assertMatchesLikeMatchesBSON("{b: 'foo'}", &collator);
+    assertMatchesLikeMatchesBSON("{b: {$gt: 'bar'}}", &collator);
+    assertMatchesLikeMatchesBSON("{b: {$in: ['FOO']}}", &collator);
+}
+
+TEST(BatchedMatchEvaluatorTest, FieldsBeyondTheColumnLimitAreResidual) {
+    BSONObjBuilder query;
+    for (size_t i = 0; i <= BatchedMatchEvaluator::kMaxColumns; ++i) {
+        query.append("f" + std::to_string(i), static_cast<int>(i));
+    }
+    auto expr = parse(query.obj());
+    auto evaluator = BatchedMatchEvaluator::compile(expr.get());
+    ASSERT(evaluator);
+    ASSERT_EQ(evaluator->numCompiledLeaves(), BatchedMatchEvaluator::kMaxColumns);
+    ASSERT_EQ(evaluator->numResidualPredicates(), 1U);
+
+    BSONObjBuilder doc;
+    for (size_t i = 0; i <= BatchedMatchEvaluator::kMaxColumns; ++i) {
+        doc.append("f" + std::to_string(i), static_cast<int>(i));
+    }
+    auto matching = doc.obj();
+    ASSERT_TRUE(evaluator->matches(matching));
+    ASSERT_FALSE(evaluator->matches(matching.removeField("f0")));
+    ASSERT_FALSE(evaluator->matches(
+        matching.removeField("f" + std::to_string(BatchedMatchEvaluator::kMaxColumns))));
+}
+
+}  // namespace
+}  // namespace mongo
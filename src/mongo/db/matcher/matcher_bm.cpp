@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/batched_match_evaluator.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+
+namespace mongo {
+namespace {
+
+constexpr size_t kNumDocs = 1024;
+constexpr size_t kNumPaddingFields = 10;
+
+/**
+ * Generates documents shaped like {p0: ..., ..., p9: ..., a: <int>, b: <string>, c: {d: <int>}}.
+ * When 'withArrays' is set, every fourth document has an array for 'a'.
+ */
+std::vector<BSONObj> makeDocuments(bool withArrays) {
+    std::mt19937 gen(1234);
+    std::vector<BSONObj> docs;
+    docs.reserve(kNumDocs);
+    for (size_t i = 0; i < kNumDocs; ++i) {
+        BSONObjBuilder builder;
+        for (size_t j = 0; j < kNumPaddingFields; ++j) {
+            builder.append("p" + std::to_string(j), static_cast<int>(gen() % 1000));
+        }
+        auto a = static_cast<int>(gen() % 100);
+        if (withArrays && i % 4 == 0) {
+            builder.append("a", BSON_ARRAY(a << a + 1));
+        } else {
+            builder.append("a", a);
+        }
+        builder.append("b", (gen() % 2) ? "foo" : "bar");
+        builder.append("c", BSON("d" << static_cast<int>(gen() % 100)));
+        docs.push_back(builder.obj());
+    }
+    return docs;
+}
+
+std::unique_ptr<MatchExpression> parseFilter(const char* filter) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    return uassertStatusOK(MatchExpressionParser::parse(fromjson(filter), expCtx));
+}
+
+void BM_MatchesBSON(benchmark::State& state, const char* filter, bool withArrays) {
+    auto docs = makeDocuments(withArrays);
+    auto expr = parseFilter(filter);
+
+    for (auto _ : state) {
+        size_t numMatches = 0;
+        for (auto&& doc : docs) {
+            numMatches += expr->matchesBSON(doc) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(numMatches);
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_BatchedFilter(benchmark::State& state, const char* filter, bool withArrays) {
+    auto docs = makeDocuments(withArrays);
+    auto expr = parseFilter(filter);
+    auto evaluator = BatchedMatchEvaluator::compile(expr.get());
+    invariant(evaluator);
+    const size_t batchSize = state.range(0);
+
+    std::vector<size_t> selection;
+    for (auto _ : state) {
+        size_t numMatches = 0;
+        for (size_t start = 0; start < docs.size(); start += batchSize) {
+            evaluator->filter(
+                docs.data() + start, std::min(batchSize, docs.size() - start), &selection);
+            numMatches += selection.size();
+        }
+        benchmark::DoNotOptimize(numMatches);
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+/**
+ * Evaluates the filter the way a collection scan does: the record cursor hands out documents which
+ * are only valid until it moves, so each window of documents is copied before it is filtered.
+ */
+void BM_BatchedFilterCopyingDocuments(benchmark::State& state,
+                                      const char* filter,
+                                      bool withArrays) {
+    auto docs = makeDocuments(withArrays);
+    auto expr = parseFilter(filter);
+    auto evaluator = BatchedMatchEvaluator::compile(expr.get());
+    invariant(evaluator);
+    const size_t batchSize = state.range(0);
+
+    std::vector<BSONObj> window;
+    std::vector<size_t> selection;
+    for (auto _ : state) {
+        size_t numMatches = 0;
+        for (size_t start = 0; start < docs.size(); start += batchSize) {
+            window.clear();
+            for (size_t i = start; i < std::min(start + batchSize, docs.size()); ++i) {
+                window.push_back(BSONObj(docs[i].objdata()).getOwned());
+            }
+            evaluator->filter(window.data(), window.size(), &selection);
+            numMatches += selection.size();
+        }
+        benchmark::DoNotOptimize(numMatches);
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+constexpr auto kIntRange = "{a: {$gte: 10, $lt: 60}}";
+constexpr auto kIntAndString = "{a: {$gte: 10, $lt: 60}, b: 'foo'}";
+constexpr auto kIn = "{a: {$in: [1, 5, 10, 20, 50]}, b: {$exists: true}}";
+constexpr auto kWithDottedPath = "{a: {$gte: 10}, 'c.d': {$lt: 50}}";
+
+BENCHMARK_CAPTURE(BM_MatchesBSON, IntRange, kIntRange, false);
+BENCHMARK_CAPTURE(BM_BatchedFilter, IntRange, kIntRange, false)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK_CAPTURE(BM_BatchedFilterCopyingDocuments, IntRange, kIntRange, false)->Arg(64);
+BENCHMARK_CAPTURE(BM_MatchesBSON, IntAndString, kIntAndString, false);
+BENCHMARK_CAPTURE(BM_BatchedFilter, IntAndString, kIntAndString, false)
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024);
+BENCHMARK_CAPTURE(BM_BatchedFilterCopyingDocuments, IntAndString, kIntAndString, false)->Arg(64);
+BENCHMARK_CAPTURE(BM_MatchesBSON, In, kIn, false);
+BENCHMARK_CAPTURE(BM_BatchedFilter, In, kIn, false)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK_CAPTURE(BM_MatchesBSON, WithDottedPath, kWithDottedPath, false);
+BENCHMARK_CAPTURE(BM_BatchedFilter, WithDottedPath, kWithDottedPath, false)
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024);
+BENCHMARK_CAPTURE(BM_MatchesBSON, IntRangeWithArrays, kIntRange, true);
+BENCHMARK_CAPTURE(BM_BatchedFilter, IntRangeWithArrays, kIntRange, true)
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024);
+
+}  // namespace
+}  // namespace mongo
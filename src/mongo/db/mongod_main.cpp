@@ -109,6 +109,7 @@
 #include "mongo/db/op_observer_registry.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
+#include "mongo/db/periodic_runner_job_release_idle_index_catalogs.h"
 #include "mongo/db/pipeline/change_stream_expired_pre_image_remover.h"
 #include "mongo/db/pipeline/process_interface/replica_set_node_process_interface.h"
 #include "mongo/db/query/internal_plans.h"
@@ -211,6 +212,7 @@
 #include "mongo/util/periodic_runner.h"
 #include "mongo/util/periodic_runner_factory.h"
 #include "mongo/util/quick_exit.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/sequence_util.h"
 #include "mongo/util/signal_handlers.h"
@@ -526,6 +528,8 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
 
     startMongoDFTDC();
 
+    SamplingProfiler::get().startup();
+
     initializeSNMP();
 
     if (mongodGlobalParams.scriptingEnabled) {
@@ -786,6 +790,20 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
         }
     }
 
+    // Start a background task to periodically release the index catalogs which were instantiated
+    // on first access and have been idle since.
+    if (gDeferIndexCatalogInitialization) {
+        try {
+            PeriodicThreadToReleaseIdleIndexCatalogs::get(serviceContext)->start();
+        } catch (ExceptionFor<ErrorCodes::PeriodicJobIsStopped>&) {
+            LOGV2_WARNING(6440805, "Not starting periodic jobs as shutdown is in progress");
+            // Shutdown has already started before initialization is complete. Wait for the
+            // shutdown task to complete and return.
+            MONGO_IDLE_THREAD_BLOCK;
+            return waitForShutdown();
+        }
+    }
+
     // Set up the logical session cache
     LogicalSessionCacheServer kind = LogicalSessionCacheServer::kStandalone;
     if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
@@ -1267,6 +1285,11 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
         PeriodicChangeStreamExpiredPreImagesRemover::get(serviceContext)->stop();
     }
 
+    if (gDeferIndexCatalogInitialization) {
+        LOGV2(6440806, "Shutting down the PeriodicThreadToReleaseIdleIndexCatalogs");
+        PeriodicThreadToReleaseIdleIndexCatalogs::get(serviceContext)->stop();
+    }
+
     if (auto storageEngine = serviceContext->getStorageEngine()) {
         if (storageEngine->supportsReadConcernSnapshot()) {
             LOGV2(4784908, "Shutting down the PeriodicThreadToAbortExpiredTransactions");
@@ -142,6 +142,9 @@ const NamespaceString NamespaceString::kForceOplogBatchBoundaryNamespace(
 const NamespaceString NamespaceString::kConfigImagesNamespace(NamespaceString::kConfigDb,
                                                               "image_collection");
 
+const NamespaceString NamespaceString::kPlanCacheWarmupNamespace(NamespaceString::kConfigDb,
+                                                                 "plan_cache_warmup");
+
 bool NamespaceString::isListCollectionsCursorNS() const {
     return coll() == listCollectionsCursorCol;
 }
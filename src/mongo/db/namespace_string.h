@@ -193,6 +193,9 @@ public:
     // Namespace used for storing retryable findAndModify images.
     static const NamespaceString kConfigImagesNamespace;
 
+    // Namespace used for storing the winning plans which warm up the plan caches.
+    static const NamespaceString kPlanCacheWarmupNamespace;
+
     /**
      * Constructs an empty NamespaceString.
      */
@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/periodic_runner_job_release_idle_index_catalogs.h"
+
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/periodic_runner.h"
+
+namespace mongo {
+
+namespace {
+
+void releaseIdleIndexCatalogs(Client* client) {
+    const auto idleSecs = gIdleIndexCatalogReleaseSecs.load();
+    if (idleSecs <= 0) {
+        return;
+    }
+
+    auto opCtx = client->makeOperationContext();
+
+    // Releasing an index catalog is never worth waiting for, so give up on the collections that
+    // are locked by other operations rather than queueing behind them.
+    opCtx->lockState()->setMaxLockTimeout(Milliseconds(0));
+
+    const auto idleSince =
+        client->getServiceContext()->getFastClockSource()->now() - Seconds(idleSecs);
+
+    std::vector<NamespaceStringOrUUID> idleCollections;
+    {
+        Lock::GlobalLock globalLock(opCtx.get(), MODE_IS);
+        auto catalog = CollectionCatalog::get(opCtx.get());
+        for (auto&& dbName : catalog->getAllDbNames()) {
+            for (auto it = catalog->begin(opCtx.get(), dbName); it != catalog->end(opCtx.get());
+                 ++it) {
+                auto coll = *it;
+                if (coll && coll->isIndexCatalogIdle(idleSince)) {
+                    idleCollections.emplace_back(dbName, coll->uuid());
+                }
+            }
+        }
+    }
+
+    size_t numReleased = 0;
+    for (const auto& nsOrUUID : idleCollections) {
+        try {
+            AutoGetCollection coll(opCtx.get(), nsOrUUID, MODE_X);
+            if (!coll || !coll->isIndexCatalogIdle(idleSince)) {
+                continue;
+            }
+
+            WriteUnitOfWork wuow(opCtx.get());
+            CollectionWriter writer(opCtx.get(), coll);
+            if (writer.getWritableCollection()->releaseIdleIndexCatalog(opCtx.get(), idleSince)) {
+                ++numReleased;
+            }
+            wuow.commit();
+        } catch (const ExceptionFor<ErrorCodes::LockTimeout>&) {
+            // The collection is in use, so its index catalog is no longer idle anyway.
+        } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+            // The collection was dropped concurrently.
+        }
+    }
+
+    if (numReleased) {
+        LOGV2_DEBUG(6440802,
+                    1,
+                    "Released idle index catalogs",
+                    "numReleased"_attr = numReleased,
+                    "numIdle"_attr = idleCollections.size());
+    }
+}
+
+}  // namespace
+
+auto PeriodicThreadToReleaseIdleIndexCatalogs::get(ServiceContext* serviceContext)
+    -> PeriodicThreadToReleaseIdleIndexCatalogs& {
+    auto& jobContainer = _serviceDecoration(serviceContext);
+    jobContainer._init(serviceContext);
+
+    return jobContainer;
+}
+
+auto PeriodicThreadToReleaseIdleIndexCatalogs::operator*() const noexcept -> PeriodicJobAnchor& {
+    stdx::lock_guard lk(_mutex);
+    return *_anchor;
+}
+
+auto PeriodicThreadToReleaseIdleIndexCatalogs::operator-> () const noexcept -> PeriodicJobAnchor* {
+    stdx::lock_guard lk(_mutex);
+    return _anchor.get();
+}
+
+void PeriodicThreadToReleaseIdleIndexCatalogs::_init(ServiceContext* serviceContext) {
+    stdx::lock_guard lk(_mutex);
+    if (_anchor) {
+        return;
+    }
+
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job(
+        "releaseIdleIndexCatalogs",
+        [](Client* client) {
+            try {
+                releaseIdleIndexCatalogs(client);
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>& ex) {
+                LOGV2_DEBUG(6440803, 2, "Periodic job interrupted", "reason"_attr = ex.reason());
+            } catch (const DBException& ex) {
+                LOGV2_WARNING(6440804,
+                              "Failed to release idle index catalogs",
+                              "error"_attr = ex.toStatus());
+            }
+        },
+        Seconds(10));
+
+    _anchor = std::make_shared<PeriodicJobAnchor>(periodicRunner->makeJob(std::move(job)));
+}
+
+}  // namespace mongo
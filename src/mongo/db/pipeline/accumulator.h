@@ -201,6 +201,40 @@ private:
     int _maxMemUsageBytes;
 };
 
+/**
+ * Estimates the number of distinct values in a group with a HyperLogLog sketch. Unlike
+ * {$size: {$addToSet: ...}}, memory use is fixed at a few kilobytes per group regardless of the
+ * number of distinct values. The partial result sent for merging is the sketch itself, encoded as
+ * BinData.
+ */
+class AccumulatorApproxCountDistinct final : public AccumulatorState {
+public:
+    static constexpr auto kName = "$approxCountDistinct"_sd;
+
+    const char* getOpName() const final {
+        return kName.rawData();
+    }
+
+    explicit AccumulatorApproxCountDistinct(ExpressionContext* expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    void reset() final;
+
+    static boost::intrusive_ptr<AccumulatorState> create(ExpressionContext* expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> _sketch;
+};
+
 class AccumulatorFirst final : public AccumulatorState {
 public:
     static constexpr auto kName = "$first"_sd;
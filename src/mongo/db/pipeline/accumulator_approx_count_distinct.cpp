@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/exec/hyper_log_log.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/query_feature_flags_gen.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR_CONDITIONALLY(
+    approxCountDistinct,
+    genericParseSingleExpressionAccumulator<AccumulatorApproxCountDistinct>,
+    AllowedWithApiStrict::kNeverInVersion1,
+    AllowedWithClientType::kAny,
+    boost::none,
+    feature_flags::gFeatureFlagApproximateAccumulators.isEnabledAndIgnoreFCV());
+
+AccumulatorApproxCountDistinct::AccumulatorApproxCountDistinct(ExpressionContext* const expCtx)
+    : AccumulatorState(expCtx), _sketch(HyperLogLog::kSerializedSize) {
+    HyperLogLog::initialize(_sketch.data());
+    // The sketch has a fixed size, so we never need to update this.
+    _memUsageBytes = sizeof(*this) + _sketch.capacity();
+}
+
+void AccumulatorApproxCountDistinct::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        // Like $addToSet, ignore missing values but count null as a distinct value.
+        if (input.missing()) {
+            return;
+        }
+        BSONObjBuilder bob;
+        input.addToBsonObj(&bob, ""_sd);
+        HyperLogLog::add(_sketch.data(),
+                         HyperLogLog::hash(bob.done().firstElement(),
+                                           getExpressionContext()->getCollator()));
+    } else {
+        // This is what getValue(true) produced below.
+        invariant(input.getType() == BinData);
+        auto binData = input.getBinData();
+        auto data = static_cast<const uint8_t*>(binData.data);
+        HyperLogLog::assertValid(data, binData.length);
+        HyperLogLog::merge(_sketch.data(), data);
+    }
+}
+
+Value AccumulatorApproxCountDistinct::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        return Value(BSONBinData(_sketch.data(), _sketch.size(), BinDataGeneral));
+    }
+    return Value(HyperLogLog::estimate(_sketch.data()));
+}
+
+void AccumulatorApproxCountDistinct::reset() {
+    HyperLogLog::initialize(_sketch.data());
+}
+
+intrusive_ptr<AccumulatorState> AccumulatorApproxCountDistinct::create(
+    ExpressionContext* const expCtx) {
+    return new AccumulatorApproxCountDistinct(expCtx);
+}
+
+}  // namespace mongo
@@ -0,0 +1,242 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator_percentile.h"
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/exec/t_digest.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/query_feature_flags_gen.h"
+
+namespace mongo {
+
+REGISTER_ACCUMULATOR_CONDITIONALLY(
+    percentile,
+    AccumulatorPercentile::parsePercentile,
+    AllowedWithApiStrict::kNeverInVersion1,
+    AllowedWithClientType::kAny,
+    boost::none,
+    feature_flags::gFeatureFlagApproximateAccumulators.isEnabledAndIgnoreFCV());
+REGISTER_ACCUMULATOR_CONDITIONALLY(
+    median,
+    AccumulatorMedian::parseMedian,
+    AllowedWithApiStrict::kNeverInVersion1,
+    AllowedWithClientType::kAny,
+    boost::none,
+    feature_flags::gFeatureFlagApproximateAccumulators.isEnabledAndIgnoreFCV());
+
+namespace {
+
+/**
+ * Parses the arguments shared by $percentile and $median. 'ps' is only accepted when
+ * 'acceptPs' is true.
+ */
+std::tuple<boost::intrusive_ptr<Expression>, boost::optional<std::vector<double>>> parseArgs(
+    ExpressionContext* const expCtx,
+    BSONElement elem,
+    VariablesParseState vps,
+    StringData opName,
+    bool acceptPs) {
+    uassert(6440020,
+            str::stream() << opName << " specification must be an object; found " << elem,
+            elem.type() == BSONType::Object);
+
+    boost::intrusive_ptr<Expression> input;
+    boost::optional<std::vector<double>> ps;
+    bool haveMethod = false;
+    for (auto&& arg : elem.embeddedObject()) {
+        auto fieldName = arg.fieldNameStringData();
+        if (fieldName == AccumulatorPercentile::kFieldNameInput) {
+            input = Expression::parseOperand(expCtx, arg, vps);
+        } else if (acceptPs && fieldName == AccumulatorPercentile::kFieldNameP) {
+            auto pExpr = Expression::parseOperand(expCtx, arg, vps)->optimize();
+            auto pConst = dynamic_cast<ExpressionConstant*>(pExpr.get());
+            uassert(6440021,
+                    str::stream() << opName << " requires 'p' to be a constant array of numbers",
+                    pConst);
+            ps = AccumulatorPercentile::parsePs(pConst->getValue());
+        } else if (fieldName == AccumulatorPercentile::kFieldNameMethod) {
+            uassert(6440022,
+                    str::stream() << opName << " only supports the method '"
+                                  << AccumulatorPercentile::kMethodApproximate << "', found "
+                                  << arg,
+                    arg.type() == BSONType::String &&
+                        arg.valueStringData() == AccumulatorPercentile::kMethodApproximate);
+            haveMethod = true;
+        } else {
+            uasserted(6440023,
+                      str::stream() << "Unknown argument for " << opName << ": " << fieldName);
+        }
+    }
+    uassert(6440024,
+            str::stream() << opName << " requires an '" << AccumulatorPercentile::kFieldNameInput
+                          << "' argument",
+            input);
+    uassert(6440025,
+            str::stream() << opName << " requires a '" << AccumulatorPercentile::kFieldNameMethod
+                          << "' argument",
+            haveMethod);
+    uassert(6440026,
+            str::stream() << opName << " requires a '" << AccumulatorPercentile::kFieldNameP
+                          << "' argument",
+            !acceptPs || ps);
+    return {std::move(input), std::move(ps)};
+}
+
+boost::intrusive_ptr<Expression> makePsInitializer(ExpressionContext* const expCtx,
+                                                   const std::vector<double>& ps) {
+    return ExpressionConstant::create(expCtx, Value(std::vector<Value>(ps.begin(), ps.end())));
+}
+
+}  // namespace
+
+AccumulatorPercentile::AccumulatorPercentile(ExpressionContext* const expCtx,
+                                             std::vector<double> ps)
+    : AccumulatorState(expCtx), _ps(std::move(ps)), _digest(TDigest::kSerializedSize) {
+    TDigest::initialize(_digest.data());
+    // The digest has a fixed size, so we never need to update this.
+    _memUsageBytes = sizeof(*this) + _digest.capacity() + _ps.capacity() * sizeof(double);
+}
+
+std::vector<double> AccumulatorPercentile::parsePs(const Value& ps) {
+    uassert(6440027,
+            str::stream() << "'p' must be a non-empty array of numbers, found " << ps.toString(),
+            ps.isArray() && !ps.getArray().empty());
+
+    std::vector<double> result;
+    result.reserve(ps.getArray().size());
+    for (auto&& p : ps.getArray()) {
+        uassert(6440028,
+                str::stream() << "'p' must only contain numbers in the range [0.0, 1.0], found "
+                              << p.toString(),
+                p.numeric() && p.coerceToDouble() >= 0.0 && p.coerceToDouble() <= 1.0);
+        result.push_back(p.coerceToDouble());
+    }
+    return result;
+}
+
+void AccumulatorPercentile::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        // Non-numeric types have no impact on percentiles.
+        if (!input.numeric()) {
+            return;
+        }
+        TDigest::add(_digest.data(), input.coerceToDouble());
+    } else {
+        // This is what getValue(true) produced below.
+        invariant(input.getType() == BinData);
+        auto binData = input.getBinData();
+        auto data = static_cast<const char*>(binData.data);
+        TDigest::assertValid(data, binData.length);
+        TDigest::merge(_digest.data(), data);
+    }
+}
+
+std::vector<boost::optional<double>> AccumulatorPercentile::computePercentiles() {
+    std::vector<boost::optional<double>> result;
+    result.reserve(_ps.size());
+    for (auto p : _ps) {
+        result.push_back(TDigest::quantile(_digest.data(), p));
+    }
+    return result;
+}
+
+Value AccumulatorPercentile::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        return Value(BSONBinData(_digest.data(), _digest.size(), BinDataGeneral));
+    }
+
+    std::vector<Value> result;
+    for (auto&& estimate : computePercentiles()) {
+        result.push_back(estimate ? Value(*estimate) : Value(BSONNULL));
+    }
+    return Value(std::move(result));
+}
+
+void AccumulatorPercentile::reset() {
+    TDigest::initialize(_digest.data());
+}
+
+Document AccumulatorPercentile::serialize(boost::intrusive_ptr<Expression> initializer,
+                                          boost::intrusive_ptr<Expression> argument,
+                                          bool explain) const {
+    return DOC(getOpName() << DOC(kFieldNameInput
+                                  << argument->serialize(explain) << kFieldNameP
+                                  << initializer->serialize(explain) << kFieldNameMethod
+                                  << kMethodApproximate));
+}
+
+AccumulationExpression AccumulatorPercentile::parsePercentile(ExpressionContext* const expCtx,
+                                                              BSONElement elem,
+                                                              VariablesParseState vps) {
+    auto [input, ps] = parseArgs(expCtx, elem, vps, kName, true /* acceptPs */);
+    return {makePsInitializer(expCtx, *ps),
+            std::move(input),
+            [expCtx, ps = *ps] { return make_intrusive<AccumulatorPercentile>(expCtx, ps); },
+            kName};
+}
+
+AccumulatorMedian::AccumulatorMedian(ExpressionContext* const expCtx)
+    : AccumulatorPercentile(expCtx, {0.5}) {}
+
+boost::intrusive_ptr<AccumulatorState> AccumulatorMedian::create(ExpressionContext* const expCtx) {
+    return make_intrusive<AccumulatorMedian>(expCtx);
+}
+
+Value AccumulatorMedian::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        return AccumulatorPercentile::getValue(toBeMerged);
+    }
+
+    auto estimate = computePercentiles().front();
+    return estimate ? Value(*estimate) : Value(BSONNULL);
+}
+
+Document AccumulatorMedian::serialize(boost::intrusive_ptr<Expression> initializer,
+                                      boost::intrusive_ptr<Expression> argument,
+                                      bool explain) const {
+    return DOC(getOpName() << DOC(kFieldNameInput << argument->serialize(explain)
+                                                  << kFieldNameMethod << kMethodApproximate));
+}
+
+AccumulationExpression AccumulatorMedian::parseMedian(ExpressionContext* const expCtx,
+                                                      BSONElement elem,
+                                                      VariablesParseState vps) {
+    auto [input, ps] = parseArgs(expCtx, elem, vps, kName, false /* acceptPs */);
+    return {makePsInitializer(expCtx, {0.5}),
+            std::move(input),
+            [expCtx] { return AccumulatorMedian::create(expCtx); },
+            kName};
+}
+
+}  // namespace mongo
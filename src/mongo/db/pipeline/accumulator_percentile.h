@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/accumulator.h"
+
+namespace mongo {
+
+/**
+ * Accumulators that estimate percentiles of the numeric values in a group using a t-digest, with a
+ * fixed memory footprint of a few kilobytes per group. Non-numeric values are ignored.
+ *
+ *     {$percentile: {input: <expr>, p: [<number in [0, 1]>, ...], method: "approximate"}}
+ *     {$median: {input: <expr>, method: "approximate"}}
+ *
+ * The requested percentiles are constant for the lifetime of the query. They are carried as the
+ * initializer of the AccumulationExpression so that execution engines other than the classic one
+ * (SBE) can see them without instantiating the accumulator. The partial result sent for merging is
+ * the digest itself, encoded as BinData.
+ */
+class AccumulatorPercentile : public AccumulatorState {
+public:
+    static constexpr auto kName = "$percentile"_sd;
+
+    static constexpr auto kFieldNameInput = "input"_sd;
+    static constexpr auto kFieldNameP = "p"_sd;
+    static constexpr auto kFieldNameMethod = "method"_sd;
+    static constexpr auto kMethodApproximate = "approximate"_sd;
+
+    const char* getOpName() const override {
+        return kName.rawData();
+    }
+
+    AccumulatorPercentile(ExpressionContext* expCtx, std::vector<double> ps);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) override;
+    void reset() final;
+
+    Document serialize(boost::intrusive_ptr<Expression> initializer,
+                       boost::intrusive_ptr<Expression> argument,
+                       bool explain) const override;
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+    static AccumulationExpression parsePercentile(ExpressionContext* expCtx,
+                                                  BSONElement elem,
+                                                  VariablesParseState vps);
+
+    /**
+     * Validates the value of the 'p' argument and returns the requested percentiles. Exposed so
+     * that the SBE stage builder can decode the initializer of a $percentile expression.
+     */
+    static std::vector<double> parsePs(const Value& ps);
+
+protected:
+    /**
+     * Returns the estimate for each requested percentile, or boost::none for all of them if no
+     * numeric input has been seen.
+     */
+    std::vector<boost::optional<double>> computePercentiles();
+
+    const std::vector<double> _ps;
+
+private:
+    std::vector<char> _digest;
+};
+
+class AccumulatorMedian final : public AccumulatorPercentile {
+public:
+    static constexpr auto kName = "$median"_sd;
+
+    const char* getOpName() const final {
+        return kName.rawData();
+    }
+
+    explicit AccumulatorMedian(ExpressionContext* expCtx);
+
+    static boost::intrusive_ptr<AccumulatorState> create(ExpressionContext* expCtx);
+
+    Value getValue(bool toBeMerged) final;
+
+    Document serialize(boost::intrusive_ptr<Expression> initializer,
+                       boost::intrusive_ptr<Expression> argument,
+                       bool explain) const final;
+
+    static AccumulationExpression parseMedian(ExpressionContext* expCtx,
+                                              BSONElement elem,
+                                              VariablesParseState vps);
+};
+
+}  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/accumulator_for_window_functions.h"
 #include "mongo/db/pipeline/accumulator_multi.h"
+#include "mongo/db/pipeline/accumulator_percentile.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
@@ -595,6 +596,105 @@ TEST(Accumulators, Sum) {
          {{Value(9), Value()}, Value(9)}});
 }
 
+TEST(Accumulators, ApproxCountDistinct) {
+    auto expCtx = ExpressionContextForTest{};
+    // Small cardinalities are estimated exactly.
+    assertExpectedResults<AccumulatorApproxCountDistinct>(
+        &expCtx,
+        {
+            // No documents evaluated.
+            {{}, Value(0LL)},
+
+            // Missing values are ignored.
+            {{Value()}, Value(0LL)},
+            {{Value(BSONNULL), Value()}, Value(1LL)},
+
+            // Duplicates are only counted once.
+            {{Value(1), Value(2), Value(1), Value(3)}, Value(3LL)},
+            {{Value("a"_sd), Value("b"_sd), Value("a"_sd)}, Value(2LL)},
+
+            // Numerically equal values of different types are the same value.
+            {{Value(1), Value(1LL), Value(1.0), Value(Decimal128(1))}, Value(1LL)},
+            {{Value(BSON("a" << 1)), Value(BSON("a" << 1.0)), Value(BSON("a" << 2))},
+             Value(2LL)},
+        });
+}
+
+TEST(Accumulators, ApproxCountDistinctRespectsCollation) {
+    auto expCtx = ExpressionContextForTest{};
+    auto collator =
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx.setCollator(std::move(collator));
+    assertExpectedResults<AccumulatorApproxCountDistinct>(
+        &expCtx, {{{Value("a"_sd), Value("b"_sd), Value("c"_sd)}, Value(1LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctLargeCardinality) {
+    auto expCtx = ExpressionContextForTest{};
+    auto shardA = AccumulatorApproxCountDistinct::create(&expCtx);
+    auto shardB = AccumulatorApproxCountDistinct::create(&expCtx);
+    for (int i = 0; i < 60000; ++i) {
+        shardA->process(Value(i), false);
+        shardB->process(Value(i + 40000), false);
+    }
+
+    auto merger = AccumulatorApproxCountDistinct::create(&expCtx);
+    merger->process(shardA->getValue(true), true);
+    merger->process(shardB->getValue(true), true);
+
+    // The relative standard error of the sketch is about 1.6%, allow for four times that.
+    ASSERT_APPROX_EQUAL(merger->getValue(false).getLong(), 100000LL, 6500LL);
+}
+
+TEST(Accumulators, Percentile) {
+    auto expCtx = ExpressionContextForTest{};
+    auto initializeAccumulator =
+        [](ExpressionContext* const expCtx) -> intrusive_ptr<AccumulatorState> {
+        return make_intrusive<AccumulatorPercentile>(expCtx, std::vector<double>{0.0, 0.5, 1.0});
+    };
+    // With fewer values than the compression factor of the digest, every value is kept and
+    // percentiles are interpolated between neighbouring values.
+    assertExpectedResults(
+        &expCtx,
+        {
+            // No documents evaluated.
+            {{}, Value(std::vector<Value>{Value(BSONNULL), Value(BSONNULL), Value(BSONNULL)})},
+
+            // Non-numeric values are ignored.
+            {{Value("a"_sd), Value(BSONNULL), Value()},
+             Value(std::vector<Value>{Value(BSONNULL), Value(BSONNULL), Value(BSONNULL)})},
+
+            {{Value(5), Value(1LL), Value(3.0), Value("a"_sd), Value(Decimal128(2)), Value(4)},
+             Value(std::vector<Value>{Value(1.0), Value(3.0), Value(5.0)})},
+        },
+        initializeAccumulator);
+}
+
+TEST(Accumulators, Median) {
+    auto expCtx = ExpressionContextForTest{};
+    assertExpectedResults<AccumulatorMedian>(
+        &expCtx,
+        {
+            // No documents evaluated.
+            {{}, Value(BSONNULL)},
+
+            {{Value(7)}, Value(7.0)},
+            {{Value(5), Value(1), Value(3), Value(2), Value(4)}, Value(3.0)},
+        });
+}
+
+TEST(Accumulators, PercentileRejectsInvalidPs) {
+    ASSERT_THROWS_CODE(AccumulatorPercentile::parsePs(Value(0.5)), AssertionException, 6440027);
+    ASSERT_THROWS_CODE(
+        AccumulatorPercentile::parsePs(Value(std::vector<Value>{})), AssertionException, 6440027);
+    ASSERT_THROWS_CODE(AccumulatorPercentile::parsePs(Value(std::vector<Value>{Value(1.5)})),
+                       AssertionException,
+                       6440028);
+    ASSERT_THROWS_CODE(AccumulatorPercentile::parsePs(Value(std::vector<Value>{Value("a"_sd)})),
+                       AssertionException,
+                       6440028);
+}
+
 TEST(Accumulators, TopBottomNRespectsCollation) {
     RAIIServerParameterControllerForTest controller("featureFlagExactTopNAccumulator", true);
     auto expCtx = make_intrusive<ExpressionContextForTest>();
@@ -0,0 +1,199 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/compact_value_set.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+/**
+ * Serializes 'value' into a single-element BSONObj with an empty field name, so that it can be
+ * hashed and compared against the elements stored in the arena.
+ */
+BSONObj wrapValue(const Value& value) {
+    BSONObjBuilder bob;
+    value.addToBsonObj(&bob, ""_sd);
+    return bob.obj();
+}
+}  // namespace
+
+size_t CompactValueSet::findSlot(const BSONElement& elem, size_t hash, bool* found) const {
+    const size_t mask = _slots.size() - 1;
+    boost::optional<size_t> firstTombstone;
+    for (size_t idx = hash & mask;; idx = (idx + 1) & mask) {
+        const auto& slot = _slots[idx];
+        if (slot.offset == kEmpty) {
+            *found = false;
+            return firstTombstone.value_or(idx);
+        }
+        if (slot.offset == kDeleted) {
+            if (!firstTombstone) {
+                firstTombstone = idx;
+            }
+            continue;
+        }
+        if (slot.hash == hash && _comparator.compare(elementAt(slot.offset), elem) == 0) {
+            *found = true;
+            return idx;
+        }
+    }
+}
+
+void CompactValueSet::reserveForInsert() {
+    // Keep the load factor, including tombstones, at or below one half so that probe sequences
+    // stay short and findSlot() is guaranteed to reach an empty slot.
+    if (!_slots.empty() && (_usedSlots + 1) * 2 <= _slots.size()) {
+        return;
+    }
+
+    size_t newCapacity = kInitialCapacity;
+    while ((_size + 1) * 2 > newCapacity) {
+        newCapacity *= 2;
+    }
+
+    std::vector<Slot> oldSlots(newCapacity);
+    oldSlots.swap(_slots);
+    const size_t mask = _slots.size() - 1;
+    for (auto&& slot : oldSlots) {
+        if (slot.offset >= kDeleted) {
+            continue;
+        }
+        size_t idx = slot.hash & mask;
+        while (_slots[idx].offset != kEmpty) {
+            idx = (idx + 1) & mask;
+        }
+        _slots[idx] = slot;
+    }
+    _usedSlots = _size - (_missingOrUndefined ? 1 : 0);
+}
+
+bool CompactValueSet::insert(const Value& value) {
+    if (isMissingOrUndefined(value)) {
+        if (_missingOrUndefined) {
+            return false;
+        }
+        _missingOrUndefined = value;
+        ++_size;
+        return true;
+    }
+
+    reserveForInsert();
+
+    auto wrapped = wrapValue(value);
+    auto elem = wrapped.firstElement();
+    const size_t hash = hashElement(elem);
+    bool found;
+    const size_t idx = findSlot(elem, hash, &found);
+    if (found) {
+        return false;
+    }
+
+    tassert(6440200,
+            "CompactValueSet arena exceeded its maximum addressable size",
+            _arena.size() + elem.size() < kDeleted);
+    const auto offset = static_cast<uint32_t>(_arena.size());
+    _arena.insert(_arena.end(), elem.rawdata(), elem.rawdata() + elem.size());
+
+    auto& slot = _slots[idx];
+    if (slot.offset == kEmpty) {
+        ++_usedSlots;
+    }
+    slot.hash = hash;
+    slot.offset = offset;
+    ++_size;
+    return true;
+}
+
+bool CompactValueSet::contains(const Value& value) const {
+    if (isMissingOrUndefined(value)) {
+        return _missingOrUndefined.has_value();
+    }
+    if (_slots.empty()) {
+        return false;
+    }
+
+    auto wrapped = wrapValue(value);
+    auto elem = wrapped.firstElement();
+    bool found;
+    findSlot(elem, hashElement(elem), &found);
+    return found;
+}
+
+bool CompactValueSet::erase(const Value& value) {
+    if (isMissingOrUndefined(value)) {
+        if (!_missingOrUndefined) {
+            return false;
+        }
+        _missingOrUndefined = boost::none;
+        --_size;
+        return true;
+    }
+    if (_slots.empty()) {
+        return false;
+    }
+
+    auto wrapped = wrapValue(value);
+    auto elem = wrapped.firstElement();
+    bool found;
+    const size_t idx = findSlot(elem, hashElement(elem), &found);
+    if (!found) {
+        return false;
+    }
+    _slots[idx].offset = kDeleted;
+    --_size;
+    return true;
+}
+
+void CompactValueSet::clear() {
+    // Release the storage rather than just resetting it, since a single large traversal should not
+    // pin its peak footprint for the lifetime of the owning stage.
+    std::vector<char>().swap(_arena);
+    std::vector<Slot>().swap(_slots);
+    _size = 0;
+    _usedSlots = 0;
+    _missingOrUndefined = boost::none;
+}
+
+void CompactValueSet::swap(CompactValueSet& other) {
+    std::swap(_comparator, other._comparator);
+    std::swap(_stringComparator, other._stringComparator);
+    _arena.swap(other._arena);
+    _slots.swap(other._slots);
+    std::swap(_size, other._size);
+    std::swap(_usedSlots, other._usedSlots);
+    std::swap(_missingOrUndefined, other._missingOrUndefined);
+}
+
+}  // namespace mongo
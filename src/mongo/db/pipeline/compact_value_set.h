@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "mongo/base/string_data_comparator_interface.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonelement_comparator.h"
+#include "mongo/db/exec/document_value/value.h"
+
+namespace mongo {
+
+/**
+ * A hash set of Values with a low per-entry footprint, intended for the large, short-lived sets
+ * built by stages such as $graphLookup. Each distinct value is serialized once as a BSONElement
+ * with an empty field name into a contiguous arena, and an open-addressing table of
+ * (hash, arena offset) pairs indexes the arena. Compared to a node-based ValueUnorderedSet this
+ * avoids one heap allocation per entry and keeps probes within a single cache-friendly array.
+ *
+ * Values are hashed and compared with the same semantics as a ValueComparator built from the
+ * given string comparator: numeric types compare by value, missing and undefined are equivalent
+ * (both canonicalize to the same type), null is distinct from both, and strings respect the
+ * collation. The missing Value cannot be represented in BSON, so missing and undefined share a
+ * single entry tracked outside the arena, holding whichever of the two was inserted first.
+ *
+ * Erasing a value leaves its bytes in the arena until the next clear(), so this structure is
+ * best suited to insert-mostly workloads.
+ */
+class CompactValueSet {
+public:
+    explicit CompactValueSet(const StringData::ComparatorInterface* stringComparator = nullptr)
+        : _comparator(BSONElementComparator::FieldNamesMode::kIgnore, stringComparator),
+          _stringComparator(stringComparator) {}
+
+    /**
+     * Adds 'value' to the set. Returns false if an equivalent value was already present.
+     */
+    bool insert(const Value& value);
+
+    /**
+     * Returns true if the set contains a value equivalent to 'value'.
+     */
+    bool contains(const Value& value) const;
+
+    /**
+     * Removes the value equivalent to 'value' from the set, if present. Returns whether a value
+     * was removed.
+     */
+    bool erase(const Value& value);
+
+    /**
+     * Invokes 'fn' with each value in the set, in no particular order. The set must not be
+     * modified while iterating.
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        if (_missingOrUndefined) {
+            fn(*_missingOrUndefined);
+        }
+        for (auto&& slot : _slots) {
+            if (slot.offset < kDeleted) {
+                fn(Value(elementAt(slot.offset)));
+            }
+        }
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Removes all values and releases the arena, retaining the string comparator.
+     */
+    void clear();
+
+    void swap(CompactValueSet& other);
+
+    /**
+     * Returns the number of bytes currently reserved by the arena and the hash table.
+     */
+    size_t getApproximateSize() const {
+        return sizeof(*this) + _arena.capacity() + _slots.capacity() * sizeof(Slot);
+    }
+
+    const StringData::ComparatorInterface* getStringComparator() const {
+        return _stringComparator;
+    }
+
+private:
+    // Sentinel offsets marking never-used and erased slots. Every real offset is smaller.
+    static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t kDeleted = kEmpty - 1;
+
+    static constexpr size_t kInitialCapacity = 16;
+
+    struct Slot {
+        size_t hash = 0;
+        uint32_t offset = kEmpty;
+    };
+
+    BSONElement elementAt(uint32_t offset) const {
+        // Every stored element has an empty field name, whose size is just the NUL terminator.
+        return BSONElement(_arena.data() + offset, 1, -1);
+    }
+
+    static bool isMissingOrUndefined(const Value& value) {
+        return value.missing() || value.getType() == BSONType::Undefined;
+    }
+
+    size_t hashElement(const BSONElement& elem) const {
+        return _comparator.hash(elem);
+    }
+
+    /**
+     * Returns the index of the slot holding an element equivalent to 'elem', or, if there is
+     * none, of the slot at which it should be inserted.
+     */
+    size_t findSlot(const BSONElement& elem, size_t hash, bool* found) const;
+
+    /**
+     * Grows the hash table if it would exceed its maximum load factor after one more insert.
+     */
+    void reserveForInsert();
+
+    BSONElementComparator _comparator;
+    const StringData::ComparatorInterface* _stringComparator;
+
+    // Serialized values, each stored as a BSONElement with an empty field name.
+    std::vector<char> _arena;
+
+    // Open-addressing hash table with linear probing. The capacity is always a power of two.
+    std::vector<Slot> _slots;
+
+    size_t _size = 0;
+
+    // Number of slots holding a live value or a tombstone, which determines when to rehash.
+    size_t _usedSlots = 0;
+
+    // The single entry standing for both missing and undefined, if either has been inserted.
+    boost::optional<Value> _missingOrUndefined;
+};
+
+}  // namespace mongo
@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/compact_value_set.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<Value> collectValues(const CompactValueSet& set) {
+    std::vector<Value> values;
+    set.forEach([&](const Value& value) { values.push_back(value); });
+    return values;
+}
+
+TEST(CompactValueSetTest, InsertAndContainsWorkCorrectly) {
+    CompactValueSet set;
+    ASSERT_TRUE(set.empty());
+    ASSERT_TRUE(set.insert(Value(1)));
+    ASSERT_TRUE(set.insert(Value("foo"_sd)));
+    ASSERT_TRUE(set.insert(Value(Document{{"a", 1}})));
+    ASSERT_FALSE(set.insert(Value(1)));
+
+    ASSERT_EQ(set.size(), 3U);
+    ASSERT_TRUE(set.contains(Value(1)));
+    ASSERT_TRUE(set.contains(Value("foo"_sd)));
+    ASSERT_TRUE(set.contains(Value(Document{{"a", 1}})));
+    ASSERT_FALSE(set.contains(Value(2)));
+    ASSERT_FALSE(set.contains(Value(Document{{"b", 1}})));
+}
+
+TEST(CompactValueSetTest, NumericTypesAreEquivalentByValue) {
+    CompactValueSet set;
+    ASSERT_TRUE(set.insert(Value(1)));
+    ASSERT_FALSE(set.insert(Value(1LL)));
+    ASSERT_FALSE(set.insert(Value(1.0)));
+    ASSERT_FALSE(set.insert(Value(Decimal128(1))));
+    ASSERT_TRUE(set.contains(Value(1.0)));
+    ASSERT_EQ(set.size(), 1U);
+}
+
+TEST(CompactValueSetTest, MissingAndUndefinedAreEquivalentButNullIsDistinct) {
+    CompactValueSet set;
+    ASSERT_FALSE(set.contains(Value()));
+    ASSERT_TRUE(set.insert(Value()));
+    ASSERT_FALSE(set.insert(Value()));
+    ASSERT_FALSE(set.insert(Value(BSONUndefined)));
+    ASSERT_TRUE(set.contains(Value(BSONUndefined)));
+    ASSERT_FALSE(set.contains(Value(BSONNULL)));
+    ASSERT_TRUE(set.insert(Value(BSONNULL)));
+    ASSERT_EQ(set.size(), 2U);
+
+    // The shared entry keeps the form that was inserted first.
+    auto values = collectValues(set);
+    ASSERT_EQ(values.size(), 2U);
+    ASSERT_TRUE(values[0].missing());
+    ASSERT_EQ(values[1].getType(), BSONType::jstNULL);
+
+    ASSERT_TRUE(set.erase(Value(BSONUndefined)));
+    ASSERT_FALSE(set.contains(Value()));
+    ASSERT_TRUE(set.contains(Value(BSONNULL)));
+    ASSERT_EQ(set.size(), 1U);
+
+    ASSERT_TRUE(set.insert(Value(BSONUndefined)));
+    ASSERT_TRUE(set.contains(Value()));
+    values = collectValues(set);
+    ASSERT_EQ(values.size(), 2U);
+    ASSERT_EQ(values[0].getType(), BSONType::Undefined);
+}
+
+TEST(CompactValueSetTest, RespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    CompactValueSet set(&collator);
+    ASSERT_TRUE(set.insert(Value("foo"_sd)));
+    ASSERT_FALSE(set.insert(Value("FOO"_sd)));
+    ASSERT_TRUE(set.contains(Value("FoO"_sd)));
+    ASSERT_FALSE(set.contains(Value(Document{{"a", "foo"_sd}})));
+    ASSERT_TRUE(set.insert(Value(Document{{"a", "foo"_sd}})));
+    ASSERT_TRUE(set.contains(Value(Document{{"a", "FOO"_sd}})));
+
+    // Without a collation, strings that differ in case are distinct.
+    CompactValueSet simpleSet;
+    ASSERT_TRUE(simpleSet.insert(Value("foo"_sd)));
+    ASSERT_TRUE(simpleSet.insert(Value("FOO"_sd)));
+}
+
+TEST(CompactValueSetTest, EraseRemovesOnlyTheGivenValue) {
+    CompactValueSet set;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(set.insert(Value(i)));
+    }
+    ASSERT_TRUE(set.erase(Value(3)));
+    ASSERT_FALSE(set.erase(Value(3)));
+    ASSERT_FALSE(set.erase(Value(42)));
+    ASSERT_EQ(set.size(), 9U);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(set.contains(Value(i)), i != 3);
+    }
+
+    // An erased value can be inserted again.
+    ASSERT_TRUE(set.insert(Value(3)));
+    ASSERT_TRUE(set.contains(Value(3)));
+    ASSERT_EQ(set.size(), 10U);
+}
+
+TEST(CompactValueSetTest, GrowsAndRehashesCorrectly) {
+    CompactValueSet set;
+    const int kNumValues = 10000;
+    for (int i = 0; i < kNumValues; ++i) {
+        ASSERT_TRUE(set.insert(Value(std::to_string(i))));
+    }
+    // Erase and reinsert half of the values so that the table is rebuilt with tombstones present.
+    for (int i = 0; i < kNumValues; i += 2) {
+        ASSERT_TRUE(set.erase(Value(std::to_string(i))));
+    }
+    for (int i = 0; i < kNumValues; i += 2) {
+        ASSERT_TRUE(set.insert(Value(std::to_string(i))));
+    }
+    ASSERT_EQ(set.size(), static_cast<size_t>(kNumValues));
+    for (int i = 0; i < kNumValues; ++i) {
+        ASSERT_TRUE(set.contains(Value(std::to_string(i))));
+    }
+    ASSERT_EQ(collectValues(set).size(), static_cast<size_t>(kNumValues));
+}
+
+TEST(CompactValueSetTest, ForEachReturnsOriginalValues) {
+    CompactValueSet set;
+    const auto doc = Document{{"a", 1}, {"b", Value(std::vector<Value>{Value(1), Value(2)})}};
+    set.insert(Value(doc));
+
+    auto values = collectValues(set);
+    ASSERT_EQ(values.size(), 1U);
+    ASSERT_VALUE_EQ(values[0], Value(doc));
+}
+
+TEST(CompactValueSetTest, ClearAndSwapWorkCorrectly) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    CompactValueSet set(&collator);
+    set.insert(Value("foo"_sd));
+    set.insert(Value());
+
+    CompactValueSet other(&collator);
+    set.swap(other);
+    ASSERT_TRUE(set.empty());
+    ASSERT_EQ(other.size(), 2U);
+    ASSERT_TRUE(other.contains(Value("FOO"_sd)));
+    ASSERT_TRUE(other.contains(Value()));
+
+    const auto sizeBeforeClear = other.getApproximateSize();
+    other.clear();
+    ASSERT_TRUE(other.empty());
+    ASSERT_FALSE(other.contains(Value("foo"_sd)));
+    ASSERT_FALSE(other.contains(Value()));
+    ASSERT_LT(other.getApproximateSize(), sizeBeforeClear);
+    ASSERT_EQ(other.getStringComparator(), &collator);
+}
+
+}  // namespace
+}  // namespace mongo
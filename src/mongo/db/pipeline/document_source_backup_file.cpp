@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_backup_file.h"
+
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/storage/backup_cursor_hooks.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_DOCUMENT_SOURCE(_backupFile,
+                         DocumentSourceBackupFile::LiteParsed::parse,
+                         DocumentSourceBackupFile::createFromBson,
+                         AllowedWithApiStrict::kInternal);
+
+namespace {
+static constexpr StringData kBackupIdFieldName = "backupId"_sd;
+static constexpr StringData kFileFieldName = "file"_sd;
+static constexpr StringData kByteOffsetFieldName = "byteOffset"_sd;
+static constexpr StringData kDataFieldName = "data"_sd;
+static constexpr StringData kEndOfFileFieldName = "endOfFile"_sd;
+}  // namespace
+
+const char* DocumentSourceBackupFile::getSourceName() const {
+    return kStageName.rawData();
+}
+
+DocumentSourceBackupFile::DocumentSourceBackupFile(
+    const intrusive_ptr<ExpressionContext>& pExpCtx,
+    UUID backupId,
+    std::string file,
+    long long byteOffset)
+    : DocumentSource(kStageName, pExpCtx),
+      _backupId(backupId),
+      _file(std::move(file)),
+      _initialByteOffset(byteOffset),
+      _byteOffset(byteOffset) {}
+
+DocumentSource::GetNextResult DocumentSourceBackupFile::doGetNext() {
+    if (_endOfFile) {
+        return GetNextResult::makeEOF();
+    }
+
+    if (!_opened) {
+        _stream.open(_file, std::ios::binary);
+        uassert(ErrorCodes::FileOpenFailed,
+                str::stream() << "Failed to open file " << _file,
+                _stream.is_open());
+        _stream.seekg(_byteOffset);
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to seek to offset " << _byteOffset << " of file "
+                              << _file,
+                _stream.good());
+        _buffer.resize(kBlockSizeBytes);
+        _opened = true;
+    }
+
+    _stream.read(_buffer.data(), _buffer.size());
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to read file " << _file << " at offset " << _byteOffset,
+            !_stream.bad());
+    const auto bytesRead = _stream.gcount();
+    _endOfFile = _stream.eof();
+
+    Document doc{{kByteOffsetFieldName, _byteOffset},
+                 {kDataFieldName, BSONBinData(_buffer.data(), bytesRead, BinDataGeneral)},
+                 {kEndOfFileFieldName, _endOfFile}};
+    _byteOffset += bytesRead;
+    return doc;
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceBackupFile::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(ErrorCodes::IllegalOperation,
+            "$_backupFile cannot be run on mongos",
+            !pExpCtx->inMongos);
+
+    const NamespaceString& nss = pExpCtx->ns;
+    uassert(ErrorCodes::InvalidNamespace,
+            "$_backupFile must be run against the 'admin' database with {aggregate: 1}",
+            nss.db() == NamespaceString::kAdminDb && nss.isCollectionlessAggregateNS());
+
+    uassert(ErrorCodes::FailedToParse,
+            "The $_backupFile stage specification must be an object",
+            elem.type() == Object);
+
+    boost::optional<UUID> backupId;
+    boost::optional<std::string> file;
+    long long byteOffset = 0;
+    for (auto&& field : elem.Obj()) {
+        const auto fieldName = field.fieldNameStringData();
+        if (fieldName == kBackupIdFieldName) {
+            backupId = uassertStatusOK(UUID::parse(field));
+        } else if (fieldName == kFileFieldName) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "The 'file' parameter of $_backupFile must be a string",
+                    field.type() == String);
+            file = field.str();
+        } else if (fieldName == kByteOffsetFieldName) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "The 'byteOffset' parameter of $_backupFile must be a number",
+                    field.isNumber());
+            byteOffset = field.safeNumberLong();
+            uassert(ErrorCodes::BadValue,
+                    "The 'byteOffset' parameter of $_backupFile must not be negative",
+                    byteOffset >= 0);
+        } else {
+            uasserted(ErrorCodes::FailedToParse,
+                      str::stream() << "Unrecognized option '" << fieldName
+                                    << "' in $_backupFile stage");
+        }
+    }
+    uassert(ErrorCodes::FailedToParse,
+            "The $_backupFile stage requires a 'backupId' and a 'file'",
+            backupId && file);
+
+    // Only the files of a backup are consistent while its backup cursor is open, so only those may
+    // be read.
+    auto backupCursorHooks = BackupCursorHooks::get(pExpCtx->opCtx->getServiceContext());
+    uassert(ErrorCodes::CommandNotSupported,
+            "Backup cursors are an enterprise only feature.",
+            backupCursorHooks->enabled());
+    uassert(ErrorCodes::BadValue,
+            str::stream() << "File " << *file << " was not returned by backup cursor "
+                          << *backupId,
+            backupCursorHooks->isFileReturnedByCursor(*backupId, *file));
+
+    return new DocumentSourceBackupFile(pExpCtx, *backupId, std::move(*file), byteOffset);
+}
+
+Value DocumentSourceBackupFile::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(DOC(getSourceName() << DOC(kBackupIdFieldName
+                                            << _backupId << kFileFieldName << _file
+                                            << kByteOffsetFieldName << _initialByteOffset)));
+}
+
+}  // namespace mongo
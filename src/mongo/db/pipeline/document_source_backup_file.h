@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+/**
+ * Streams the contents of a file returned by an open backup cursor, so that another node can copy
+ * the files of a backup over a connection to this one. Each document holds the next block of the
+ * file:
+ *
+ * {byteOffset: <long>, data: <BinData>, endOfFile: <bool>}
+ *
+ * Used by file copy based initial sync. The stage specification is
+ *
+ * {$_backupFile: {backupId: <UUID>, file: <string>, byteOffset: <long, optional>}}
+ *
+ * where 'file' is a filename as returned by the backup cursor 'backupId'.
+ */
+class DocumentSourceBackupFile final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_backupFile"_sd;
+
+    // The number of bytes of the file to return per document.
+    static constexpr size_t kBlockSizeBytes = 4 * 1024 * 1024;
+
+    class LiteParsed final : public LiteParsedDocumentSource {
+    public:
+        static std::unique_ptr<LiteParsed> parse(const NamespaceString& nss,
+                                                 const BSONElement& spec) {
+            return std::make_unique<LiteParsed>(spec.fieldName());
+        }
+
+        explicit LiteParsed(std::string parseTimeName)
+            : LiteParsedDocumentSource(std::move(parseTimeName)) {}
+
+        PrivilegeVector requiredPrivileges(bool isMongos,
+                                           bool bypassDocumentValidation) const final {
+            return {Privilege(ResourcePattern::forClusterResource(), ActionType::fsync)};
+        }
+
+        stdx::unordered_set<NamespaceString> getInvolvedNamespaces() const final {
+            return {};
+        }
+
+        bool isInitialSource() const final {
+            return true;
+        }
+
+        bool allowedToPassthroughFromMongos() const final {
+            return false;
+        }
+    };
+
+    const char* getSourceName() const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kLocalOnly,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     LookupRequirement::kNotAllowed,
+                                     UnionRequirement::kNotAllowed);
+
+        constraints.isIndependentOfAnyCollection = true;
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+private:
+    DocumentSourceBackupFile(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
+                             UUID backupId,
+                             std::string file,
+                             long long byteOffset);
+
+    GetNextResult doGetNext() final;
+
+    const UUID _backupId;
+    const std::string _file;
+    const long long _initialByteOffset;
+
+    std::ifstream _stream;
+    std::vector<char> _buffer;
+    long long _byteOffset;
+    bool _opened = false;
+    bool _endOfFile = false;
+};
+
+}  // namespace mongo
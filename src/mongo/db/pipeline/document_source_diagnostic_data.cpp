@@ -0,0 +1,315 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_diagnostic_data.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+
+#include "mongo/db/ftdc/constants.h"
+#include "mongo/db/ftdc/controller.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/util/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_DOCUMENT_SOURCE(diagnosticData,
+                         DocumentSourceDiagnosticData::LiteParsed::parse,
+                         DocumentSourceDiagnosticData::createFromBson,
+                         AllowedWithApiStrict::kNeverInVersion1);
+
+namespace {
+static constexpr StringData kFromFieldName = "from"_sd;
+static constexpr StringData kToFieldName = "to"_sd;
+
+/**
+ * Returns the time an archive file named "metrics.YYYY-MM-DDTHH-MM-SSZ-NNNNN" was created at,
+ * truncated to the second.
+ */
+boost::optional<Date_t> getArchiveFileDate(const boost::filesystem::path& file) {
+    const std::string prefix = std::string(kFTDCArchiveFile) + ".";
+    const std::string name = file.filename().generic_string();
+    const size_t kDateLength = 20;
+    if (name.compare(0, prefix.size(), prefix) != 0 || name.size() < prefix.size() + kDateLength) {
+        return boost::none;
+    }
+
+    std::string date = name.substr(prefix.size(), kDateLength);
+    date[13] = ':';
+    date[16] = ':';
+    auto swDate = dateFromISOString(date);
+    if (!swDate.isOK()) {
+        return boost::none;
+    }
+    return swDate.getValue();
+}
+}  // namespace
+
+PrivilegeVector DocumentSourceDiagnosticData::LiteParsed::requiredPrivileges(
+    bool isMongos, bool bypassDocumentValidation) const {
+    // The same privileges as the getDiagnosticData command.
+    return {Privilege(ResourcePattern::forClusterResource(),
+                      {ActionType::serverStatus, ActionType::replSetGetStatus}),
+            Privilege(ResourcePattern::forExactNamespace(NamespaceString::kRsOplogNamespace),
+                      ActionType::collStats)};
+}
+
+const char* DocumentSourceDiagnosticData::getSourceName() const {
+    return kStageName.rawData();
+}
+
+DocumentSourceDiagnosticData::DocumentSourceDiagnosticData(
+    const intrusive_ptr<ExpressionContext>& pExpCtx, Date_t from, Date_t to)
+    : DocumentSource(kStageName, pExpCtx), _from(from), _to(to) {}
+
+Pipeline::SourceContainer::iterator DocumentSourceDiagnosticData::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextStage = std::next(itr);
+    if (nextStage == container->end()) {
+        return container->end();
+    }
+
+    // The $match stays in the pipeline, it still filters the samples of the chunks read.
+    if (auto nextMatch = dynamic_cast<DocumentSourceMatch*>(nextStage->get())) {
+        _absorbMatchBounds(nextMatch->getQuery());
+    }
+
+    return nextStage;
+}
+
+void DocumentSourceDiagnosticData::_absorbMatchBounds(const BSONObj& query) {
+    for (auto&& elem : query) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "$and"_sd && elem.type() == Array) {
+            for (auto&& clause : elem.Obj()) {
+                if (clause.type() == Object) {
+                    _absorbMatchBounds(clause.Obj());
+                }
+            }
+            continue;
+        }
+
+        if (fieldName != kFTDCCollectStartField) {
+            continue;
+        }
+
+        if (elem.type() == Date) {
+            _from = std::max(_from, elem.date());
+            _to = std::min(_to, elem.date());
+            continue;
+        }
+
+        if (elem.type() != Object) {
+            continue;
+        }
+
+        for (auto&& predicate : elem.Obj()) {
+            if (predicate.type() != Date) {
+                continue;
+            }
+
+            const auto op = predicate.fieldNameStringData();
+            if (op == "$gt"_sd || op == "$gte"_sd || op == "$eq"_sd) {
+                _from = std::max(_from, predicate.date());
+            }
+            if (op == "$lt"_sd || op == "$lte"_sd || op == "$eq"_sd) {
+                _to = std::min(_to, predicate.date());
+            }
+        }
+    }
+}
+
+void DocumentSourceDiagnosticData::_listFiles() {
+    auto controller = FTDCController::get(pExpCtx->opCtx->getServiceContext());
+    boost::filesystem::path directory;
+    if (controller) {
+        directory = controller->getDirectory();
+    }
+    uassert(ErrorCodes::FTDCPathNotSet,
+            "Diagnostic data collection has no directory to read from",
+            !directory.empty());
+
+    boost::system::error_code ec;
+    boost::filesystem::directory_iterator di(directory, ec);
+    if (ec) {
+        return;
+    }
+
+    for (; di != boost::filesystem::directory_iterator(); di.increment(ec)) {
+        if (ec) {
+            break;
+        }
+
+        std::string name = di->path().filename().generic_string();
+        if (name.compare(0, strlen(kFTDCArchiveFile), kFTDCArchiveFile) == 0 &&
+            name != kFTDCInterimTempFile && name != kFTDCInterimFile) {
+            _files.emplace_back(di->path());
+        }
+    }
+
+    std::sort(_files.begin(), _files.end());
+
+    auto interimFile = directory / kFTDCInterimFile;
+    if (boost::filesystem::exists(interimFile, ec)) {
+        _files.emplace_back(std::move(interimFile));
+    }
+}
+
+bool DocumentSourceDiagnosticData::_isTailFile(size_t index) const {
+    auto isInterimFile = [&](size_t i) {
+        return _files[i].filename().generic_string() == kFTDCInterimFile;
+    };
+
+    return index + 1 == _files.size() || isInterimFile(index) || isInterimFile(index + 1);
+}
+
+DocumentSource::GetNextResult DocumentSourceDiagnosticData::doGetNext() {
+    if (!_listedFiles) {
+        _listFiles();
+        _listedFiles = true;
+    }
+
+    while (true) {
+        if (!_reader) {
+            if (_fileIndex == _files.size()) {
+                return GetNextResult::makeEOF();
+            }
+
+            // The samples of an archive file were all collected before the next archive file was
+            // created.
+            if (_fileIndex + 1 < _files.size()) {
+                auto nextFileDate = getArchiveFileDate(_files[_fileIndex + 1]);
+                if (nextFileDate && *nextFileDate + Seconds(1) <= _from) {
+                    ++_fileIndex;
+                    continue;
+                }
+            }
+
+            // Files removed by rotation since they were listed are skipped.
+            _reader = std::make_unique<FTDCFileReader>();
+            if (!_reader->open(_files[_fileIndex]).isOK()) {
+                _reader.reset();
+                ++_fileIndex;
+                continue;
+            }
+            _reader->setTimeRange(_from, _to);
+        }
+
+        auto swHasNext = _reader->hasNext();
+        if (!swHasNext.isOK() || !swHasNext.getValue()) {
+            // The newest archive file and the interim file may be partially written.
+            if (!_isTailFile(_fileIndex)) {
+                uassertStatusOKWithContext(swHasNext.getStatus(),
+                                           str::stream() << "Failed to read diagnostic data file "
+                                                         << _files[_fileIndex].generic_string());
+            }
+
+            _reader.reset();
+            ++_fileIndex;
+            continue;
+        }
+
+        auto next = _reader->next();
+        if (std::get<0>(next) == FTDCBSONUtil::FTDCType::kMetadata) {
+            continue;
+        }
+
+        const BSONObj& sample = std::get<1>(next);
+        auto startElem = sample[kFTDCCollectStartField];
+        if (startElem.type() != Date) {
+            continue;
+        }
+
+        auto start = startElem.date();
+        if (start < _from || start > _to || start <= _lastStart) {
+            continue;
+        }
+
+        _lastStart = start;
+        return Document(sample);
+    }
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceDiagnosticData::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(ErrorCodes::IllegalOperation,
+            "$diagnosticData cannot be run on mongos",
+            !pExpCtx->inMongos);
+
+    const NamespaceString& nss = pExpCtx->ns;
+    uassert(ErrorCodes::InvalidNamespace,
+            "$diagnosticData must be run against the 'admin' database with {aggregate: 1}",
+            nss.db() == NamespaceString::kAdminDb && nss.isCollectionlessAggregateNS());
+
+    uassert(ErrorCodes::FailedToParse,
+            "The $diagnosticData stage specification must be an object",
+            elem.type() == Object);
+
+    Date_t from = Date_t::min();
+    Date_t to = Date_t::max();
+    for (auto&& field : elem.Obj()) {
+        const auto fieldName = field.fieldNameStringData();
+        if (fieldName == kFromFieldName || fieldName == kToFieldName) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "The '" << fieldName
+                                  << "' parameter of $diagnosticData must be a date",
+                    field.type() == Date);
+            (fieldName == kFromFieldName ? from : to) = field.date();
+        } else {
+            uasserted(ErrorCodes::FailedToParse,
+                      str::stream() << "Unrecognized option '" << fieldName
+                                    << "' in $diagnosticData stage");
+        }
+    }
+
+    return new DocumentSourceDiagnosticData(pExpCtx, from, to);
+}
+
+Value DocumentSourceDiagnosticData::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument spec;
+    if (_from != Date_t::min()) {
+        spec[kFromFieldName] = Value(_from);
+    }
+    if (_to != Date_t::max()) {
+        spec[kToFieldName] = Value(_to);
+    }
+    return Value(DOC(getSourceName() << spec.freeze()));
+}
+
+}  // namespace mongo
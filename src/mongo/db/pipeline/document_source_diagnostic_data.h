@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/ftdc/file_reader.h"
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+/**
+ * Returns the samples of full time diagnostic data capture (FTDC) stored by this node, oldest
+ * first, one document per sample as collected. The stage specification is
+ *
+ * {$diagnosticData: {from: <Date, optional>, to: <Date, optional>}}
+ *
+ * which limits the samples returned to the ones whose 'start' time is in [from, to]. Bounds on
+ * 'start' of a $match directly following the stage are pushed down, so that archive files and
+ * metric chunks outside of the requested time range are skipped without being decompressed.
+ */
+class DocumentSourceDiagnosticData final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$diagnosticData"_sd;
+
+    class LiteParsed final : public LiteParsedDocumentSource {
+    public:
+        static std::unique_ptr<LiteParsed> parse(const NamespaceString& nss,
+                                                 const BSONElement& spec) {
+            return std::make_unique<LiteParsed>(spec.fieldName());
+        }
+
+        explicit LiteParsed(std::string parseTimeName)
+            : LiteParsedDocumentSource(std::move(parseTimeName)) {}
+
+        PrivilegeVector requiredPrivileges(bool isMongos,
+                                           bool bypassDocumentValidation) const final;
+
+        stdx::unordered_set<NamespaceString> getInvolvedNamespaces() const final {
+            return {};
+        }
+
+        bool isInitialSource() const final {
+            return true;
+        }
+
+        bool allowedToPassthroughFromMongos() const final {
+            return false;
+        }
+    };
+
+    const char* getSourceName() const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kLocalOnly,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     LookupRequirement::kNotAllowed,
+                                     UnionRequirement::kNotAllowed);
+
+        constraints.isIndependentOfAnyCollection = true;
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+private:
+    DocumentSourceDiagnosticData(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
+                                 Date_t from,
+                                 Date_t to);
+
+    GetNextResult doGetNext() final;
+
+    /**
+     * Narrows the time range to the bounds on 'start' of a directly following $match.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
+    /**
+     * Narrows the time range to the bounds on 'start' of the top level of a $match query.
+     */
+    void _absorbMatchBounds(const BSONObj& query);
+
+    /**
+     * Lists the archive files to read, oldest first, followed by the interim file.
+     */
+    void _listFiles();
+
+    /**
+     * Returns true if an error reading _files[index] can be treated as the end of the file,
+     * because the file is being written to.
+     */
+    bool _isTailFile(size_t index) const;
+
+    Date_t _from;
+    Date_t _to;
+
+    std::vector<boost::filesystem::path> _files;
+    size_t _fileIndex = 0;
+    bool _listedFiles = false;
+
+    std::unique_ptr<FTDCFileReader> _reader;
+
+    // 'start' of the last sample returned. The interim file may repeat samples that have just been
+    // written to the newest archive file.
+    Date_t _lastStart = Date_t::min();
+};
+
+}  // namespace mongo
@@ -135,20 +135,15 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::doGetNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (_visitedDocuments.getNumDocs() > 0) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(popVisited()));
     }
+    clearVisited();
 
     MutableDocument output(*_input);
     output.setNestedField(_as, Value(std::move(results)));
 
-    _visitedUsageBytes = 0;
-
-    invariant(_visited.empty());
-
     return output.freeze();
 }
 
@@ -158,7 +153,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        if (_visitedDocuments.getNumDocs() == 0) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -169,12 +164,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
 
             _input = input.releaseDocument();
             performSearch();
-            _visitedUsageBytes = 0;
             _outputIndex = 0;
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (_visitedDocuments.getNumDocs() == 0) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -188,13 +182,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(popVisited()));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
@@ -204,7 +196,21 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
-    _visited.clear();
+    _visitedIds.clear();
+    _visitedDocuments.finalize();
+}
+
+Document DocumentSourceGraphLookUp::popVisited() {
+    const auto id = _visitedDocuments.getLowestIndex();
+    auto doc = _visitedDocuments.getDocumentById(id);
+    _visitedDocuments.freeUpTo(id);
+    return doc;
+}
+
+void DocumentSourceGraphLookUp::clearVisited() {
+    _visitedIds.clear();
+    _visitedDocuments.clear();
+    _visitedUsageBytes = 0;
 }
 
 bool DocumentSourceGraphLookUp::foreignShardedGraphLookupAllowed() const {
@@ -241,7 +247,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
         auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
         auto matchStage = makeMatchStageFromFrontier(&cached);
 
-        ValueUnorderedSet queried = pExpCtx->getValueComparator().makeUnorderedValueSet();
+        CompactValueSet queried(_frontier.getStringComparator());
         _frontier.swap(queried);
         _frontierUsageBytes = 0;
 
@@ -333,7 +339,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (!_visitedIds.insert(id)) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -352,21 +358,19 @@ bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long lo
     document_path_support::visitAllValuesAtPath(
         result, _connectFromField, [this](const Value& nextFrontierValue) {
             _frontier.insert(nextFrontierValue);
-            _frontierUsageBytes += nextFrontierValue.getApproximateSize();
         });
+    _frontierUsageBytes = _frontier.getApproximateSize();
 
-    // Add the object to our '_visited' list and update the size of '_visited' appropriately.
-    _visitedUsageBytes += id.getApproximateSize();
-    _visitedUsageBytes += result.getApproximateSize();
-
-    _visited[id] = std::move(result);
+    // Add the object to the visited documents and update the size of the visited nodes.
+    _visitedDocuments.addDocument(std::move(result));
+    _visitedUsageBytes = _visitedIds.getApproximateSize() + _visitedDocuments.getApproximateSize();
 
-    // We inserted into _visited, so return true.
+    // We inserted a new visited node, so return true.
     return true;
 }
 
 void DocumentSourceGraphLookUp::addToCache(const Document& result,
-                                           const ValueUnorderedSet& queried) {
+                                           const CompactValueSet& queried) {
     document_path_support::visitAllValuesAtPath(
         result, _connectToField, [this, &queried, &result](const Value& connectToValue) {
             // It is possible that 'connectToValue' is a single value, but was not queried for. For
@@ -374,7 +378,7 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
             // {a: [{b: 1}, {b: 0}]}, this document will be retrieved by querying for "{b: 1}", but
             // the outer for loop will split this into two separate connectToValues. {b: 0} was not
             // queried for, and thus, we cannot cache under it.
-            if (queried.find(connectToValue) != queried.end()) {
+            if (queried.contains(connectToValue)) {
                 _cache.insert(connectToValue, result);
             }
         });
@@ -382,21 +386,19 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
 
 boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
     DocumentUnorderedSet* cached) {
-    // Add any cached values to 'cached' and remove them from '_frontier'.
-    for (auto it = _frontier.begin(); it != _frontier.end();) {
-        if (auto entry = _cache[*it]) {
+    // Add any cached values to 'cached' and remove them from '_frontier'. Erasing from the frontier
+    // would leave the cached values' bytes in its arena, so the values still to be queried are
+    // copied into a fresh set instead, and '_frontierUsageBytes' shrinks to match.
+    CompactValueSet remaining(_frontier.getStringComparator());
+    _frontier.forEach([&](const Value& value) {
+        if (auto entry = _cache[value]) {
             cached->insert(entry->begin(), entry->end());
-            size_t valueSize = it->getApproximateSize();
-            _frontier.erase(it++);
-
-            // If the cached value increased in size while in the cache, we don't want to underflow
-            // '_frontierUsageBytes'.
-            invariant(valueSize <= _frontierUsageBytes);
-            _frontierUsageBytes -= valueSize;
         } else {
-            ++it;
+            remaining.insert(value);
         }
-    }
+    });
+    _frontier.swap(remaining);
+    _frontierUsageBytes = _frontier.getApproximateSize();
 
     // Create a query of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]}.
     //
@@ -423,7 +425,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
                     BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
                     {
                         BSONArrayBuilder in(subObj.subarrayStart("$in"));
-                        for (auto&& value : _frontier) {
+                        _frontier.forEach([&](const Value& value) {
                             if (value.getType() == BSONType::jstNULL) {
                                 matchNull = true;
                             } else if (value.getType() == BSONType::Undefined) {
@@ -432,7 +434,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
                                 seenMissing = true;
                             }
                             in << value;
-                        }
+                        });
                     }
                 }
             }
@@ -467,18 +469,20 @@ void DocumentSourceGraphLookUp::performSearch() {
     // Make sure _input is set before calling performSearch().
     invariant(_input);
 
+    // Forget the nodes discovered for the previous input, if they have not been released yet.
+    clearVisited();
+
     Value startingValue = _startWith->evaluate(*_input, &pExpCtx->variables);
 
     // If _startWith evaluates to an array, treat each value as a separate starting point.
     if (startingValue.isArray()) {
         for (auto value : startingValue.getArray()) {
             _frontier.insert(value);
-            _frontierUsageBytes += value.getApproximateSize();
         }
     } else {
         _frontier.insert(startingValue);
-        _frontierUsageBytes += startingValue.getApproximateSize();
     }
+    _frontierUsageBytes = _frontier.getApproximateSize();
 
     try {
         doBreadthFirstSearch();
@@ -532,7 +536,14 @@ Pipeline::SourceContainer::iterator DocumentSourceGraphLookUp::doOptimizeAt(
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    // The frontier and the set of visited '_id' values must stay in memory, but the visited
+    // documents are only needed again once the search completes and can be written to disk.
+    if (_visitedUsageBytes + _frontierUsageBytes >= _maxMemoryUsageBytes && pExpCtx->allowDiskUse &&
+        _visitedDocuments.getApproximateSize() > 0) {
+        _visitedDocuments.spillToDisk();
+        _visitedUsageBytes = _visitedIds.getApproximateSize();
+    }
+
     uassert(40099,
             "$graphLookup reached maximum memory consumption",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
@@ -610,8 +621,11 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
-      _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
-      _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
+      _frontier(pExpCtx->getCollator()),
+      _visitedDocumentsMemoryTracker(pExpCtx->allowDiskUse,
+                                     std::numeric_limits<long long>::max()),
+      _visitedDocuments(pExpCtx.get(), &_visitedDocumentsMemoryTracker),
       _cache(pExpCtx->getValueComparator()),
       _unwind(unwindSrc),
       _variables(expCtx->variables),
@@ -638,8 +652,11 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(const DocumentSourceGraphLo
       _maxDepth(original._maxDepth),
       _fromExpCtx(original._fromExpCtx->copyWith(original.pExpCtx->getResolvedNamespace(_from).ns)),
       _fromPipeline(original._fromPipeline),
-      _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
-      _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _maxMemoryUsageBytes(original._maxMemoryUsageBytes),
+      _frontier(pExpCtx->getCollator()),
+      _visitedDocumentsMemoryTracker(pExpCtx->allowDiskUse,
+                                     std::numeric_limits<long long>::max()),
+      _visitedDocuments(pExpCtx.get(), &_visitedDocumentsMemoryTracker),
       _cache(pExpCtx->getValueComparator()),
       _variables(original._variables),
       _variablesParseState(original._variablesParseState.copyWith(_variables.useIdGenerator())) {
@@ -30,10 +30,13 @@
 #pragma once
 
 #include "mongo/db/exec/document_value/value_comparator.h"
+#include "mongo/db/pipeline/compact_value_set.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
+#include "mongo/db/pipeline/memory_usage_tracker.h"
+#include "mongo/db/pipeline/window_function/spillable_cache.h"
 
 namespace mongo {
 
@@ -153,6 +156,10 @@ public:
 
     boost::intrusive_ptr<DocumentSource> clone() const final;
 
+    bool usedDisk() final {
+        return _visitedDocuments.usedDisk();
+    }
+
 protected:
     GetNextResult doGetNext() final;
     void doDispose() final;
@@ -214,19 +221,20 @@ private:
      * Updates '_cache' with 'result' appropriately, given that 'result' was retrieved when querying
      * for 'queried'.
      */
-    void addToCache(const Document& result, const ValueUnorderedSet& queried);
+    void addToCache(const Document& result, const CompactValueSet& queried);
 
     /**
-     * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * Assert that the visited nodes and '_frontier' have not exceeded the maximum memory usage,
+     * spilling the visited documents to disk first if 'allowDiskUse' is set, and then evict from
+     * '_cache' until this source is using less than '_maxMemoryUsageBytes'.
      */
     void checkMemoryUsage();
 
     /**
-     * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
-     * with the object's 'connectTo' values.
+     * Process 'result', adding it to the visited nodes with the given 'depth', and updating
+     * '_frontier' with the object's 'connectTo' values.
      *
-     * Returns whether '_visited' was updated, and thus, whether the search should recurse.
+     * Returns whether the visited nodes were updated, and thus, whether the search should recurse.
      */
     bool addToVisitedAndFrontier(Document result, long long depth);
 
@@ -235,6 +243,16 @@ private:
      */
     bool foreignShardedGraphLookupAllowed() const;
 
+    /**
+     * Removes and returns the earliest discovered document that has not yet been returned.
+     */
+    Document popVisited();
+
+    /**
+     * Discards all visited nodes, including any that were spilled to disk.
+     */
+    void clearVisited();
+
     // $graphLookup options.
     NamespaceString _from;
     FieldPath _as;
@@ -252,19 +270,23 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    size_t _maxMemoryUsageBytes;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
     size_t _frontierUsageBytes = 0;
 
     // Only used during the breadth-first search, tracks the set of values on the current frontier.
-    ValueUnorderedSet _frontier;
+    CompactValueSet _frontier;
+
+    // Tracks the '_id' values of the nodes that have been discovered for a given input. The values
+    // are compared using the simple collation.
+    CompactValueSet _visitedIds;
 
-    // Tracks nodes that have been discovered for a given input. Keys are the '_id' value of the
-    // document from the foreign collection, value is the document itself.  The keys are compared
-    // using the simple collation.
-    ValueUnorderedMap<Document> _visited;
+    // Holds the documents of the discovered nodes in the order they were found. The tracker's
+    // limit is never reached on its own; checkMemoryUsage() decides when to spill.
+    MemoryUsageTracker _visitedDocumentsMemoryTracker;
+    SpillableCache _visitedDocuments;
 
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
@@ -44,11 +44,13 @@
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/document_source_documents.h"
 #include "mongo/db/pipeline/document_source_merge_gen.h"
+#include "mongo/db/pipeline/document_source_queue.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/variable_validation.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
+#include "mongo/db/query/query_feature_flags_gen.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/logv2/log.h"
@@ -121,6 +123,52 @@ NamespaceString parseLookupFromAndResolveNamespace(const BSONElement& elem, Stri
     return nss;
 }
 
+/**
+ * Appends to 'keys' the join keys under which a foreign document with 'value' at 'path' must be
+ * found by a hash join for a localField/foreignField $lookup. The keys are a superset of the values
+ * that an equality predicate on 'path' can match: every value reached by traversing arrays, each
+ * element of an array at the end of the path, and null wherever the path is missing.
+ */
+void addForeignJoinKeys(const Value& value,
+                        const FieldPath& path,
+                        size_t pathIndex,
+                        std::vector<Value>* keys) {
+    if (pathIndex == path.getPathLength()) {
+        if (value.missing()) {
+            keys->push_back(Value(BSONNULL));
+            return;
+        }
+        keys->push_back(value);
+        if (value.isArray()) {
+            const auto& elems = value.getArray();
+            keys->insert(keys->end(), elems.begin(), elems.end());
+        }
+        return;
+    }
+
+    const auto fieldName = path.getFieldName(pathIndex);
+    switch (value.getType()) {
+        case BSONType::Object:
+            addForeignJoinKeys(value.getDocument()[fieldName], path, pathIndex + 1, keys);
+            return;
+        case BSONType::Array:
+            if (value.getArray().empty()) {
+                keys->push_back(Value(BSONNULL));
+            }
+            for (auto&& elem : value.getArray()) {
+                if (elem.getType() == BSONType::Object) {
+                    addForeignJoinKeys(elem.getDocument()[fieldName], path, pathIndex + 1, keys);
+                } else {
+                    keys->push_back(Value(BSONNULL));
+                }
+            }
+            return;
+        default:
+            keys->push_back(Value(BSONNULL));
+            return;
+    }
+}
+
 /**
  * Checks if a sort stage's pattern is suitable to push the stage before $lookup. The sort stage
  * must not share the same prefix with any field created or modified by the lookup stage.
@@ -534,6 +582,19 @@ std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
             _fromExpCtx->opCtx, _fromExpCtx->ns, ChunkVersion::UNSHARDED());
     }
 
+    // The first input document decides whether this $lookup runs as a hash join. If it does, every
+    // input document probes the same build side instead of re-executing the foreign pipeline.
+    if (!_hashJoinEvaluated) {
+        _hashJoinEvaluated = true;
+        _hashJoinSpec = analyzeHashJoin();
+        if (_hashJoinSpec && !buildHashJoinTable(*_hashJoinSpec)) {
+            _hashJoinSpec = boost::none;
+        }
+    }
+    if (_hashJoinSpec) {
+        return buildHashJoinProbePipeline(inputDoc);
+    }
+
     // If we don't have a cache, build and return the pipeline immediately.
     if (!_cache || _cache->isAbandoned()) {
         MakePipelineOptions pipelineOpts;
@@ -643,6 +704,173 @@ void DocumentSourceLookUp::addCacheStageAndOptimize(Pipeline& pipeline) {
     pipeline.optimizePipeline();
 }
 
+boost::optional<DocumentSourceLookUp::HashJoinSpec> DocumentSourceLookUp::analyzeHashJoin() const {
+    if (!feature_flags::gFeatureFlagLookupHashJoin.isEnabledAndIgnoreFCV()) {
+        return boost::none;
+    }
+
+    // A leading $documents stage may depend on the input document, so the foreign side is not
+    // known to be uncorrelated.
+    if (_userPipeline && extractDocumentsStage(*_userPipeline)) {
+        return boost::none;
+    }
+
+    if (hasLocalFieldForeignFieldJoin()) {
+        // Positional path components have query semantics which the build side keys do not model.
+        for (size_t i = 0; i < _foreignField->getPathLength(); ++i) {
+            if (str::parseUnsignedBase10Integer(_foreignField->getFieldName(i))) {
+                return boost::none;
+            }
+        }
+        return HashJoinSpec{*_fieldMatchPipelineIdx, *_foreignField, nullptr, nullptr};
+    }
+
+    // Otherwise, look for a pipeline whose first stage is {$match: {$expr: {$eq: [<path>, <var>]}}}
+    // where <var> is a 'let' variable. Any view prefix precedes it in '_resolvedPipeline'.
+    if (!_userPipeline || _userPipeline->empty()) {
+        return boost::none;
+    }
+    const auto& joinStage = _userPipeline->front();
+    auto joinStageIt = std::find_if(
+        _resolvedPipeline.begin(), _resolvedPipeline.end(), [&](const BSONObj& stage) {
+            return stage.binaryEqual(joinStage);
+        });
+    if (joinStageIt == _resolvedPipeline.end()) {
+        return boost::none;
+    }
+
+    auto getOnlyField = [](const BSONObj& obj, StringData name, BSONType type) {
+        auto elem = obj.firstElement();
+        return obj.nFields() == 1 && elem.fieldNameStringData() == name && elem.type() == type
+            ? elem
+            : BSONElement();
+    };
+    auto matchElem = getOnlyField(joinStage, "$match"_sd, BSONType::Object);
+    auto exprElem =
+        matchElem ? getOnlyField(matchElem.Obj(), "$expr"_sd, BSONType::Object) : BSONElement();
+    auto eqElem =
+        exprElem ? getOnlyField(exprElem.Obj(), "$eq"_sd, BSONType::Array) : BSONElement();
+    if (!eqElem) {
+        return boost::none;
+    }
+    auto operands = eqElem.Array();
+    if (operands.size() != 2 || operands[0].type() != BSONType::String ||
+        operands[1].type() != BSONType::String) {
+        return boost::none;
+    }
+
+    auto isVariable = [](StringData str) { return str.startsWith("$$"); };
+    auto isFieldPath = [&](StringData str) { return str.startsWith("$") && !isVariable(str); };
+    auto lhs = operands[0].valueStringData();
+    auto rhs = operands[1].valueStringData();
+    if (!(isFieldPath(lhs) && isVariable(rhs)) && !(isVariable(lhs) && isFieldPath(rhs))) {
+        return boost::none;
+    }
+    auto foreignPath = isFieldPath(lhs) ? lhs : rhs;
+    auto varName = (isVariable(lhs) ? lhs : rhs).substr(2);
+
+    auto letVar = std::find_if(_letVariables.begin(),
+                               _letVariables.end(),
+                               [&](const LetVariable& var) { return var.name == varName; });
+    if (letVar == _letVariables.end()) {
+        return boost::none;
+    }
+
+    return HashJoinSpec{
+        static_cast<size_t>(std::distance(_resolvedPipeline.begin(), joinStageIt)),
+        FieldPath(foreignPath.substr(1).toString()),
+        ExpressionFieldPath::parse(
+            _fromExpCtx.get(), foreignPath.toString(), _fromExpCtx->variablesParseState),
+        letVar->expression};
+}
+
+bool DocumentSourceLookUp::buildHashJoinTable(const HashJoinSpec& spec) {
+    std::vector<BSONObj> buildSide(_resolvedPipeline.begin(),
+                                   _resolvedPipeline.begin() + spec.joinStageIdx);
+    // Without a user pipeline, an absorbed $match only filters the foreign documents, so it can be
+    // applied to the build side as well as to each probe.
+    buildSide.push_back(
+        BSON("$match" << (hasPipeline() ? BSONObj() : _additionalFilter.value_or(BSONObj()))));
+
+    MakePipelineOptions pipelineOpts;
+    pipelineOpts.optimize = true;
+    pipelineOpts.attachCursorSource = true;
+    pipelineOpts.validator = lookupPipeValidator;
+    pipelineOpts.shardTargetingPolicy = foreignShardedLookupAllowed()
+        ? ShardTargetingPolicy::kAllowed
+        : ShardTargetingPolicy::kNotAllowed;
+
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        pipeline = Pipeline::makePipeline(buildSide, _fromExpCtx, pipelineOpts);
+    } catch (const ExceptionFor<ErrorCodes::CommandOnShardedViewNotSupportedOnMongod>&) {
+        // Leave resolving the sharded view definition to the regular execution path.
+        return false;
+    }
+
+    auto table = std::make_unique<LookupHashJoinTable>(
+        _fromExpCtx, internalDocumentSourceLookupHashJoinMaxMemoryBytes.load());
+    std::vector<Value> keys;
+    while (auto next = pipeline->getNext()) {
+        keys.clear();
+        if (spec.foreignKeyExpr) {
+            keys.push_back(spec.foreignKeyExpr->evaluate(*next, &_fromExpCtx->variables));
+        } else {
+            addForeignJoinKeys(Value(*next), spec.foreignPath, 0, &keys);
+        }
+
+        if (!table->insert(std::move(*next), keys)) {
+            LOGV2_DEBUG(6440300,
+                        3,
+                        "$lookup abandoned its hash join because the build side exceeded the "
+                        "memory limit",
+                        "namespace"_attr = _resolvedNs);
+            accumulatePipelinePlanSummaryStats(*pipeline, _stats.planSummaryStats);
+            table->finalize();
+            return false;
+        }
+    }
+
+    accumulatePipelinePlanSummaryStats(*pipeline, _stats.planSummaryStats);
+    _stats.usedHashJoin = true;
+    _stats.hashJoinBuildSideDocs = table->numDocs();
+    _hashJoinTable = std::move(table);
+    return true;
+}
+
+std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildHashJoinProbePipeline(
+    const Document& inputDoc) {
+    invariant(_hashJoinSpec && _hashJoinTable);
+    const auto& spec = *_hashJoinSpec;
+
+    std::vector<Value> keys;
+    if (spec.localKeyExpr) {
+        keys.push_back(spec.localKeyExpr->evaluate(inputDoc, &pExpCtx->variables));
+    } else {
+        document_path_support::visitAllValuesAtPath(
+            inputDoc, *_localField, [&](const Value& value) { keys.push_back(value); });
+        if (keys.empty()) {
+            // Missing values are treated as null, as in makeMatchStageFromInput().
+            keys.push_back(Value(BSONNULL));
+        }
+    }
+
+    std::deque<GetNextResult> candidates;
+    for (auto&& doc : _hashJoinTable->probe(keys)) {
+        candidates.emplace_back(std::move(doc));
+    }
+
+    // The join $match and everything after it run against the candidates, exactly as they would
+    // have run against the output of the uncorrelated prefix.
+    std::vector<BSONObj> probeSide(_resolvedPipeline.begin() + spec.joinStageIdx,
+                                   _resolvedPipeline.end());
+    auto pipeline = Pipeline::parse(probeSide, _fromExpCtx, lookupPipeValidator);
+    pipeline->addInitialSource(
+        make_intrusive<DocumentSourceQueue>(std::move(candidates), _fromExpCtx));
+    pipeline->optimizePipeline();
+    return pipeline;
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceLookUp::getModifiedPaths() const {
     std::set<std::string> modifiedPaths{_as.fullPath()};
     if (_unwindSrc) {
@@ -800,6 +1028,9 @@ bool DocumentSourceLookUp::usedDisk() {
     if (_pipeline)
         _stats.planSummaryStats.usedDisk =
             _stats.planSummaryStats.usedDisk || _pipeline->usedDisk();
+    if (_hashJoinTable)
+        _stats.planSummaryStats.usedDisk =
+            _stats.planSummaryStats.usedDisk || _hashJoinTable->usedDisk();
 
     return _stats.planSummaryStats.usedDisk;
 }
@@ -810,6 +1041,13 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    if (_hashJoinTable) {
+        _stats.planSummaryStats.usedDisk =
+            _stats.planSummaryStats.usedDisk || _hashJoinTable->usedDisk();
+        _hashJoinTable->finalize();
+        _hashJoinTable.reset();
+        _hashJoinSpec = boost::none;
+    }
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -994,6 +1232,9 @@ void DocumentSourceLookUp::appendSpecificExecStats(MutableDocument& doc) const {
                    std::back_inserter(indexesUsedVec),
                    [](std::string idx) -> Value { return Value(idx); });
     doc["indexesUsed"] = Value{std::move(indexesUsedVec)};
+    if (_stats.usedHashJoin) {
+        doc["hashJoinBuildSideDocs"] = Value(static_cast<long long>(_stats.hashJoinBuildSideDocs));
+    }
 }
 
 void DocumentSourceLookUp::serializeToArray(
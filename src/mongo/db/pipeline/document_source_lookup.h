@@ -38,6 +38,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_hash_join_table.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 
 namespace mongo {
@@ -313,6 +314,46 @@ private:
      */
     void addCacheStageAndOptimize(Pipeline& pipeline);
 
+    /**
+     * Describes an equality join between the input documents and the foreign pipeline that can be
+     * executed as a hash join. The foreign pipeline consists of an uncorrelated prefix, the join
+     * $match at 'joinStageIdx' in '_resolvedPipeline', and a suffix.
+     */
+    struct HashJoinSpec {
+        // Index in '_resolvedPipeline' of the $match correlating foreign documents with the input.
+        size_t joinStageIdx;
+
+        // The foreign path compared for equality. With localField/foreignField syntax, the path is
+        // traversed with query semantics; with a {$expr: {$eq: [...]}} join it is evaluated as an
+        // aggregation field path by 'foreignKeyExpr'.
+        FieldPath foreignPath;
+        boost::intrusive_ptr<Expression> foreignKeyExpr;
+
+        // For a {$expr: {$eq: [...]}} join, the 'let' expression compared against the foreign path.
+        boost::intrusive_ptr<Expression> localKeyExpr;
+    };
+
+    /**
+     * Returns whether this $lookup can be executed as a hash join, and if so, how. The feature flag
+     * must be enabled and the foreign pipeline must begin, after any view prefix, with either the
+     * localField/foreignField $match or a $match of the form {$expr: {$eq: ["$path", "$$var"]}}.
+     */
+    boost::optional<HashJoinSpec> analyzeHashJoin() const;
+
+    /**
+     * Runs the uncorrelated prefix of the foreign pipeline once and populates '_hashJoinTable'.
+     * Returns false, leaving the table empty, if the prefix could not be executed this way or the
+     * build side does not fit within its memory limit.
+     */
+    bool buildHashJoinTable(const HashJoinSpec& spec);
+
+    /**
+     * Returns the foreign pipeline for 'inputDoc' with its uncorrelated prefix replaced by the
+     * documents of the build side that share a join key with 'inputDoc'. The join $match is kept,
+     * so the keys only need to select a superset of the matching documents.
+     */
+    std::unique_ptr<Pipeline, PipelineDeleter> buildHashJoinProbePipeline(const Document& inputDoc);
+
     /**
      * Given a mutable document, appends execution stats such as 'totalDocsExamined',
      * 'totalKeysExamined', 'collectionScans', 'indexesUsed', etc. to it.
@@ -349,6 +390,13 @@ private:
     // from a cursor source.
     boost::optional<SequentialDocumentCache> _cache;
 
+    // Set once the first input document has determined whether this $lookup runs as a hash join.
+    // '_hashJoinSpec' and '_hashJoinTable' are populated only if it does, and are reused for every
+    // subsequent input document.
+    bool _hashJoinEvaluated = false;
+    boost::optional<HashJoinSpec> _hashJoinSpec;
+    std::unique_ptr<LookupHashJoinTable> _hashJoinTable;
+
     // The ExpressionContext used when performing aggregation pipelines against the '_resolvedNs'
     // namespace.
     boost::intrusive_ptr<ExpressionContext> _fromExpCtx;
@@ -269,12 +269,44 @@ intrusive_ptr<DocumentSource> DocumentSourceInternalSetWindowFields::optimize()
     // with it. The _executableOutputs will be constructed using the expressions from the
     // '_outputFields' on the first call to doGetNext(). As a result, only expressions in the
     // '_outputFeilds' are optimized here.
+    //
+    // As in DocumentSourceGroup::optimize(), the context's 'sbeCompatible' flag is used to detect
+    // whether the optimized expressions are still supported by SBE.
+    auto orgSbeCompatible = pExpCtx->sbeCompatible;
+    pExpCtx->sbeCompatible = true;
     for (auto&& outputField : _outputFields) {
         outputField.expr->optimize();
     }
+    _sbeCompatible = _sbeCompatible && pExpCtx->sbeCompatible;
+    pExpCtx->sbeCompatible = orgSbeCompatible;
     return this;
 }
 
+bool DocumentSourceInternalSetWindowFields::sbeCompatible() const {
+    if (!_sbeCompatible) {
+        return false;
+    }
+
+    if (_partitionBy && *_partitionBy) {
+        auto fieldPath = dynamic_cast<ExpressionFieldPath*>(_partitionBy->get());
+        if (!fieldPath || fieldPath->isVariableReference()) {
+            return false;
+        }
+    }
+
+    for (auto&& outputField : _outputFields) {
+        auto opName = outputField.expr->getOpName();
+        if ((opName != "$sum" && opName != "$avg" && opName != "$min" && opName != "$max") ||
+            !outputField.expr->input() ||
+            !stdx::holds_alternative<WindowBounds::DocumentBased>(
+                outputField.expr->bounds().bounds) ||
+            outputField.fieldName.find('.') != std::string::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
 Value DocumentSourceInternalSetWindowFields::serialize(
     boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument spec;
@@ -114,7 +114,8 @@ public:
           _sortBy(std::move(sortBy)),
           _outputFields(std::move(outputFields)),
           _memoryTracker{expCtx->allowDiskUse, maxMemoryBytes},
-          _iterator(expCtx.get(), pSource, &_memoryTracker, std::move(partitionBy), _sortBy){};
+          _iterator(expCtx.get(), pSource, &_memoryTracker, std::move(partitionBy), _sortBy),
+          _sbeCompatible(expCtx->sbeCompatible){};
 
     GetModPathsReturn getModifiedPaths() const final {
         std::set<std::string> outputPaths;
@@ -180,6 +181,25 @@ public:
         return _iterator.usedDisk();
     };
 
+    const boost::optional<boost::intrusive_ptr<Expression>>& getPartitionBy() const {
+        return _partitionBy;
+    }
+
+    const boost::optional<SortPattern>& getSortBy() const {
+        return _sortBy;
+    }
+
+    const std::vector<WindowFunctionStatement>& getOutputFields() const {
+        return _outputFields;
+    }
+
+    /**
+     * Returns true if this stage can be lowered into SBE: the partition key must be a plain field
+     * path and every output must be a $sum, $avg, $min or $max over a document-based window,
+     * written to a top-level field.
+     */
+    bool sbeCompatible() const;
+
 private:
     void initialize();
 
@@ -191,6 +211,7 @@ private:
     StringMap<std::unique_ptr<WindowFunctionExec>> _executableOutputs;
     bool _init = false;
     bool _eof = false;
+    bool _sbeCompatible = false;
 };
 
 }  // namespace mongo
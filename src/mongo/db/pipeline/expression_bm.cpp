@@ -31,6 +31,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include "mongo/db/exec/document_value/document_memory_pool.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
@@ -40,7 +41,8 @@ namespace mongo {
 namespace {
 void benchmarkExpression(BSONObj expressionSpec,
                          benchmark::State& state,
-                         const std::vector<Document>& documents) {
+                         const std::vector<Document>& documents,
+                         bool useDocumentMemoryPool = false) {
     QueryTestServiceContext testServiceContext;
     auto opContext = testServiceContext.makeOperationContext();
     NamespaceString nss("test.bm");
@@ -57,6 +59,8 @@ void benchmarkExpression(BSONObj expressionSpec,
 
     // Run the test.
     for (auto keepRunning : state) {
+        // Each iteration stands for a batch of a cursor.
+        DocumentMemoryPool::Scope documentMemoryPoolScope(useDocumentMemoryPool);
         for (auto document : documents) {
             benchmark::DoNotOptimize(expression->evaluate(document, variables));
         }
@@ -503,5 +507,34 @@ BENCHMARK(BM_SetDifference);
 BENCHMARK(BM_SetEquals);
 BENCHMARK(BM_SetUnion);
 
+/**
+ * Tests performance of an expression which builds a new document for every input document, with
+ * and without the per-batch document memory pool.
+ */
+void testMergeObjectsExpression(benchmark::State& state, bool useDocumentMemoryPool) {
+    std::vector<Document> documents;
+    for (int i = 0; i < 1000; ++i) {
+        documents.push_back(Document{{"a"_sd, Document{{"x"_sd, i}, {"y"_sd, "abc"_sd}}},
+                                     {"b"_sd, Document{{"z"_sd, i * 2}, {"w"_sd, true}}}});
+    }
+    benchmarkExpression(
+        BSON("$mergeObjects" << BSON_ARRAY("$a"
+                                           << "$b" << BSON("c" << 1))),
+        state,
+        documents,
+        useDocumentMemoryPool);
+}
+
+void BM_MergeObjects(benchmark::State& state) {
+    testMergeObjectsExpression(state, false);
+}
+
+void BM_MergeObjectsWithDocumentMemoryPool(benchmark::State& state) {
+    testMergeObjectsExpression(state, true);
+}
+
+BENCHMARK(BM_MergeObjects);
+BENCHMARK(BM_MergeObjectsWithDocumentMemoryPool);
+
 }  // namespace
 }  // namespace mongo
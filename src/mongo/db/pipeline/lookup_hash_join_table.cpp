@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_join_table.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+LookupHashJoinTable::LookupHashJoinTable(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                         size_t maxMemoryUsageBytes)
+    : _expCtx(expCtx),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _comparator(expCtx->getCollator()),
+      _index(_comparator.makeUnorderedValueMap<std::vector<int>>()),
+      _memoryTracker(expCtx->allowDiskUse, maxMemoryUsageBytes),
+      _docs(_expCtx.get(), &_memoryTracker) {}
+
+bool LookupHashJoinTable::insert(Document doc, const std::vector<Value>& keys) {
+    const int id = static_cast<int>(_numDocs);
+    for (auto&& key : keys) {
+        auto [it, inserted] = _index.try_emplace(key);
+        if (inserted) {
+            _indexUsageBytes += key.getApproximateSize() + sizeof(*it);
+        }
+        // A document may produce the same key several times, e.g. for repeated array elements.
+        if (it->second.empty() || it->second.back() != id) {
+            it->second.push_back(id);
+            _indexUsageBytes += sizeof(int);
+        }
+    }
+
+    // The documents may be spilled, but the key index cannot. Without disk use, the documents
+    // count against the same limit.
+    auto usageBytes = _indexUsageBytes;
+    if (!_expCtx->allowDiskUse) {
+        usageBytes += _docs.getApproximateSize() + doc.getApproximateSize();
+    }
+    if (usageBytes >= _maxMemoryUsageBytes) {
+        return false;
+    }
+
+    _docs.addDocument(std::move(doc));
+    ++_numDocs;
+    return true;
+}
+
+std::vector<Document> LookupHashJoinTable::probe(const std::vector<Value>& keys) {
+    std::vector<int> ids;
+    for (auto&& key : keys) {
+        auto it = _index.find(key);
+        if (it != _index.end()) {
+            ids.insert(ids.end(), it->second.begin(), it->second.end());
+        }
+    }
+    if (keys.size() > 1) {
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+
+    std::vector<Document> docs;
+    docs.reserve(ids.size());
+    for (auto id : ids) {
+        docs.push_back(_docs.getDocumentById(id));
+    }
+    return docs;
+}
+
+}  // namespace mongo
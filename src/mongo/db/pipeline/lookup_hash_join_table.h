@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/exec/document_value/value_comparator.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/memory_usage_tracker.h"
+#include "mongo/db/pipeline/window_function/spillable_cache.h"
+
+namespace mongo {
+
+/**
+ * The build side of a hash join performed by $lookup. Holds every document produced by the
+ * uncorrelated prefix of the foreign pipeline, indexed by the join key(s) of each document, so that
+ * the foreign collection is scanned once per $lookup rather than once per input document.
+ *
+ * Keys are hashed and compared using the collation of the given ExpressionContext. The documents
+ * are kept in a SpillableCache and are written to a temporary record store once they exceed the
+ * memory limit, if the ExpressionContext allows disk use. The key index itself always stays in
+ * memory.
+ */
+class LookupHashJoinTable {
+public:
+    LookupHashJoinTable(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                        size_t maxMemoryUsageBytes);
+
+    /**
+     * Adds 'doc' to the table under each of 'keys'. Returns false if the table would exceed its
+     * memory limit and cannot spill to disk, in which case the table must be discarded.
+     */
+    bool insert(Document doc, const std::vector<Value>& keys);
+
+    /**
+     * Returns the documents stored under any of 'keys', without duplicates and in the order in
+     * which they were inserted.
+     */
+    std::vector<Document> probe(const std::vector<Value>& keys);
+
+    size_t numDocs() const {
+        return _numDocs;
+    }
+
+    bool usedDisk() const {
+        return _docs.usedDisk();
+    }
+
+    /**
+     * Releases the documents, including any that were spilled. No other functions should be
+     * called afterwards. Like SpillableCache::finalize(), this may acquire locks and throw.
+     */
+    void finalize() {
+        _index.clear();
+        _docs.finalize();
+    }
+
+private:
+    boost::intrusive_ptr<ExpressionContext> _expCtx;
+    const size_t _maxMemoryUsageBytes;
+
+    ValueComparator _comparator;
+
+    // Maps each join key to the ids in '_docs' of the documents with that key, in increasing order.
+    ValueUnorderedMap<std::vector<int>> _index;
+    size_t _indexUsageBytes = 0;
+
+    MemoryUsageTracker _memoryTracker;
+    SpillableCache _docs;
+    size_t _numDocs = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/lookup_hash_join_table.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using LookupHashJoinTableTest = AggregationContextFixture;
+
+const size_t kNoMemoryLimit = 100 * 1024 * 1024;
+
+Document intToDoc(int value) {
+    return Document{{"n", value}};
+}
+
+void assertDocsEq(const std::vector<Document>& actual, const std::vector<Document>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(actual[i], expected[i]);
+    }
+}
+
+TEST_F(LookupHashJoinTableTest, ProbeReturnsDocumentsWithMatchingKeys) {
+    LookupHashJoinTable table(getExpCtx(), kNoMemoryLimit);
+    ASSERT_TRUE(table.insert(intToDoc(0), {Value(1)}));
+    ASSERT_TRUE(table.insert(intToDoc(1), {Value(2)}));
+    ASSERT_TRUE(table.insert(intToDoc(2), {Value(1)}));
+    ASSERT_EQ(table.numDocs(), 3U);
+
+    assertDocsEq(table.probe({Value(1)}), {intToDoc(0), intToDoc(2)});
+    assertDocsEq(table.probe({Value(2)}), {intToDoc(1)});
+    assertDocsEq(table.probe({Value(3)}), {});
+}
+
+TEST_F(LookupHashJoinTableTest, ProbeWithSeveralKeysReturnsEachDocumentOnceInInsertionOrder) {
+    LookupHashJoinTable table(getExpCtx(), kNoMemoryLimit);
+    ASSERT_TRUE(table.insert(intToDoc(0), {Value(2)}));
+    ASSERT_TRUE(table.insert(intToDoc(1), {Value(1), Value(2), Value(1)}));
+    ASSERT_TRUE(table.insert(intToDoc(2), {Value(1)}));
+
+    assertDocsEq(table.probe({Value(1), Value(2)}), {intToDoc(0), intToDoc(1), intToDoc(2)});
+    assertDocsEq(table.probe({Value(1)}), {intToDoc(1), intToDoc(2)});
+}
+
+TEST_F(LookupHashJoinTableTest, KeysCompareByValue) {
+    LookupHashJoinTable table(getExpCtx(), kNoMemoryLimit);
+    ASSERT_TRUE(table.insert(intToDoc(0), {Value(1)}));
+    ASSERT_TRUE(table.insert(intToDoc(1), {Value(BSONNULL)}));
+
+    assertDocsEq(table.probe({Value(1.0)}), {intToDoc(0)});
+    assertDocsEq(table.probe({Value(1LL)}), {intToDoc(0)});
+    assertDocsEq(table.probe({Value(BSONUndefined)}), {intToDoc(1)});
+}
+
+TEST_F(LookupHashJoinTableTest, KeysRespectCollation) {
+    auto expCtx = getExpCtx();
+    expCtx->setCollator(
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kToLowerString));
+    LookupHashJoinTable table(expCtx, kNoMemoryLimit);
+    ASSERT_TRUE(table.insert(intToDoc(0), {Value("foo"_sd)}));
+    ASSERT_TRUE(table.insert(intToDoc(1), {Value("FOO"_sd)}));
+
+    assertDocsEq(table.probe({Value("Foo"_sd)}), {intToDoc(0), intToDoc(1)});
+}
+
+TEST_F(LookupHashJoinTableTest, InsertFailsOnceMemoryLimitIsExceededWithoutDiskUse) {
+    auto expCtx = getExpCtx();
+    expCtx->allowDiskUse = false;
+    const auto docSize = static_cast<size_t>(intToDoc(0).getApproximateSize());
+    LookupHashJoinTable table(expCtx, 4 * docSize);
+
+    ASSERT_TRUE(table.insert(intToDoc(0), {Value(0)}));
+    bool exceeded = false;
+    for (int i = 1; i < 10 && !exceeded; ++i) {
+        exceeded = !table.insert(intToDoc(i), {Value(i)});
+    }
+    ASSERT_TRUE(exceeded);
+    ASSERT_FALSE(table.usedDisk());
+}
+
+}  // namespace
+}  // namespace mongo
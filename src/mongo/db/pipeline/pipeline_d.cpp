@@ -68,6 +68,7 @@
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
+#include "mongo/db/pipeline/document_source_set_window_fields.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/inner_pipeline_stage_impl.h"
@@ -100,8 +101,10 @@ using write_ops::InsertCommandRequest;
 
 namespace {
 /**
- * Extracts a prefix of 'DocumentSourceGroup' stages from the given pipeline to prepare for
- * pushdown of $group into the inner query layer so that it can be executed using SBE. Group stages
+ * Extracts a prefix of 'DocumentSourceGroup' and 'DocumentSourceInternalSetWindowFields' stages
+ * from the given pipeline to prepare for pushdown of $group and $setWindowFields into the inner
+ * query layer so that it can be executed using SBE. Window stages are only extracted when
+ * 'featureFlagSBEWindowPushdown' is enabled and the stage is SBE compatible. Group stages
  * are extracted from the pipeline under when all of the following conditions are met:
  *    0. When the 'internalQueryForceClassicEngine' feature flag is 'false'.
  *    1. When 'allowDiskUse' is false. We currently don't support spilling in the SBE HashAgg
@@ -130,17 +133,31 @@ std::vector<std::unique_ptr<InnerPipelineStageInterface>> extractSbeCompatibleGr
         return {};
     }
 
-    if (!feature_flags::gFeatureFlagSBEGroupPushdown.isEnabled(
-            serverGlobalParams.featureCompatibility) ||
-        cq->getForceClassicEngine() || queryNeedsSubplanning) {
+    if (cq->getForceClassicEngine() || queryNeedsSubplanning) {
         return {};
     }
 
+    const bool groupPushdownEnabled = feature_flags::gFeatureFlagSBEGroupPushdown.isEnabled(
+        serverGlobalParams.featureCompatibility);
+    const bool windowPushdownEnabled = feature_flags::gFeatureFlagSBEWindowPushdown.isEnabled(
+        serverGlobalParams.featureCompatibility);
+
     auto&& sources = pipeline->getSources();
 
     for (auto itr = sources.begin(); itr != sources.end();) {
+        // $setWindowFields is desugared with a $sort in front of its internal stage, so any window
+        // stage reached here already receives its input in partition and sort order: had it
+        // needed a $sort, that $sort would have ended the prefix.
+        if (auto windowStage = dynamic_cast<DocumentSourceInternalSetWindowFields*>(itr->get());
+            windowStage && windowPushdownEnabled && windowStage->sbeCompatible()) {
+            groupsForPushdown.push_back(std::make_unique<InnerPipelineStageImpl>(windowStage));
+            sources.erase(itr++);
+            continue;
+        }
+
         auto groupStage = dynamic_cast<DocumentSourceGroup*>(itr->get());
-        if (!(groupStage && groupStage->sbeCompatible()) || groupStage->doingMerge()) {
+        if (!(groupPushdownEnabled && groupStage && groupStage->sbeCompatible()) ||
+            groupStage->doingMerge()) {
             // Only pushdown a prefix of group stages that are supported by sbe.
             break;
         }
@@ -990,6 +1007,9 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         invariant(expCtx->tailableMode == TailableModeEnum::kTailableAndAwaitData);
         plannerOpts |= (QueryPlannerParams::TRACK_LATEST_OPLOG_TS |
                         QueryPlannerParams::ASSERT_MIN_TS_HAS_NOT_FALLEN_OFF_OPLOG);
+        if (feature_flags::gFeatureFlagSharedChangeStreamOplogReader.isEnabledAndIgnoreFCV()) {
+            plannerOpts |= QueryPlannerParams::SHARE_OPLOG_READS;
+        }
     }
 
     // The $_requestReshardingResumeToken parameter is only valid for an oplog scan.
@@ -43,21 +43,18 @@ std::ostream& operator<<(std::ostream& stream, const PlanCacheKey& key) {
 }
 
 void PlanCacheIndexTree::setIndexEntry(const IndexEntry& ie) {
-    entry = std::make_unique<IndexEntry>(ie);
+    entry = std::make_shared<const IndexEntry>(ie);
 }
 
 std::unique_ptr<PlanCacheIndexTree> PlanCacheIndexTree::clone() const {
     auto root = std::make_unique<PlanCacheIndexTree>();
     if (nullptr != entry.get()) {
         root->index_pos = index_pos;
-        root->setIndexEntry(*entry.get());
+        root->entry = entry;
         root->canCombineBounds = canCombineBounds;
     }
     root->orPushdowns = orPushdowns;
-
-    for (auto it = children.begin(); it != children.end(); ++it) {
-        root->children.push_back((*it)->clone());
-    }
+    root->children = children;
     return root;
 }
 
@@ -98,7 +95,7 @@ std::unique_ptr<SolutionCacheData> SolutionCacheData::clone() const {
     auto other = std::make_unique<SolutionCacheData>();
     if (nullptr != this->tree.get()) {
         // 'tree' could be NULL if the cached solution is a collection scan.
-        other->tree = this->tree->clone();
+        other->tree = this->tree;
     }
     other->solnType = this->solnType;
     other->wholeIXSolnDir = this->wholeIXSolnDir;
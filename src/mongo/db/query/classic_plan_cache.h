@@ -35,6 +35,7 @@
 #include "mongo/db/query/index_entry.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_cache_key_info.h"
+#include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
 
@@ -140,7 +141,8 @@ struct PlanCacheIndexTree {
     void setIndexEntry(const IndexEntry& ie);
 
     /**
-     * Make a deep copy.
+     * Make a copy of this node. The copy shares the index entry and the children of this node,
+     * which are immutable.
      */
     std::unique_ptr<PlanCacheIndexTree> clone() const;
 
@@ -149,27 +151,21 @@ struct PlanCacheIndexTree {
      */
     std::string toString(int indents = 0) const;
 
+    /**
+     * Estimates the size of the tree. An index entry or a subtree shared by several nodes of the
+     * tree is only counted once.
+     */
     uint64_t estimateObjectSizeInBytes() const {
-        return  // Recursively add size of each element in 'children' vector.
-            container_size_helper::estimateObjectSizeInBytes(
-                children,
-                [](const auto& child) { return child->estimateObjectSizeInBytes(); },
-                true) +
-            // Add size of each element in 'orPushdowns' vector.
-            container_size_helper::estimateObjectSizeInBytes(
-                orPushdowns,
-                [](const auto& orPushdown) { return orPushdown.estimateObjectSizeInBytes(); },
-                false) +
-            // Add size of 'entry' if present.
-            (entry ? entry->estimateObjectSizeInBytes() : 0) +
-            // Add size of the object.
-            sizeof(*this);
+        stdx::unordered_set<const void*> seen;
+        return _estimateObjectSizeInBytes(&seen);
     }
 
-    std::vector<std::unique_ptr<PlanCacheIndexTree>> children;
+    // Subtrees are immutable once built, so they can be shared between the trees of several cache
+    // entries, e.g. between the cached plan of a rooted $or and those of its branches.
+    std::vector<std::shared_ptr<const PlanCacheIndexTree>> children;
 
-    // Owned here.
-    std::unique_ptr<IndexEntry> entry;
+    // Shared by all the nodes of a tree which use the same index.
+    std::shared_ptr<const IndexEntry> entry;
 
     size_t index_pos;
 
@@ -179,6 +175,28 @@ struct PlanCacheIndexTree {
     bool canCombineBounds;
 
     std::vector<OrPushdown> orPushdowns;
+
+private:
+    uint64_t _estimateObjectSizeInBytes(stdx::unordered_set<const void*>* seen) const {
+        return  // Recursively add size of each element in 'children' vector which was not seen.
+            container_size_helper::estimateObjectSizeInBytes(
+                children,
+                [&](const auto& child) {
+                    return seen->insert(child.get()).second
+                        ? child->_estimateObjectSizeInBytes(seen)
+                        : 0;
+                },
+                true) +
+            // Add size of each element in 'orPushdowns' vector.
+            container_size_helper::estimateObjectSizeInBytes(
+                orPushdowns,
+                [](const auto& orPushdown) { return orPushdown.estimateObjectSizeInBytes(); },
+                false) +
+            // Add size of 'entry' if present and not seen.
+            (entry && seen->insert(entry.get()).second ? entry->estimateObjectSizeInBytes() : 0) +
+            // Add size of the object.
+            sizeof(*this);
+    }
 };
 
 /**
@@ -193,6 +211,9 @@ struct SolutionCacheData {
           wholeIXSolnDir(1),
           indexFilterApplied(false) {}
 
+    /**
+     * Make a copy which shares the immutable 'tree'.
+     */
     std::unique_ptr<SolutionCacheData> clone() const;
 
     // For debugging.
@@ -205,7 +226,7 @@ struct SolutionCacheData {
     // If 'wholeIXSoln' is false, then 'tree' can be used to tag an isomorphic match expression.
     // If 'wholeIXSoln' is true, then 'tree' is used to store the relevant IndexEntry.
     // If 'collscanSoln' is true, then 'tree' should be NULL.
-    std::unique_ptr<PlanCacheIndexTree> tree;
+    std::shared_ptr<const PlanCacheIndexTree> tree;
 
     enum SolutionType {
         // Indicates that the plan should use
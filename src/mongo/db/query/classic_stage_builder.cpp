@@ -87,6 +87,7 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
             params.resumeAfterRecordId = csn->resumeAfterRecordId;
             params.stopApplyingFilterAfterFirstMatch = csn->stopApplyingFilterAfterFirstMatch;
             params.boundInclusion = csn->boundInclusion;
+            params.shareOplogReads = csn->shareOplogReads;
             return std::make_unique<CollectionScan>(
                 expCtx, _collection, params, _ws, csn->filter.get());
         }
@@ -417,7 +418,8 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
         case STAGE_UNKNOWN:
         case STAGE_UNPACK_TIMESERIES_BUCKET:
         case STAGE_SENTINEL:
-        case STAGE_UPDATE: {
+        case STAGE_UPDATE:
+        case STAGE_WINDOW: {
             LOGV2_WARNING(4615604, "Can't build exec tree for node", "node"_attr = *root);
         }
     }
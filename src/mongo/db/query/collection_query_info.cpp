@@ -241,10 +241,15 @@ void CollectionQueryInfo::init(OperationContext* opCtx, const CollectionPtr& col
     const bool includeUnfinishedIndexes = false;
     std::unique_ptr<IndexCatalog::IndexIterator> ii =
         coll->getIndexCatalog()->getIndexIterator(opCtx, includeUnfinishedIndexes);
+    auto& usageTracker = CollectionIndexUsageTrackerDecoration::get(coll->getSharedDecorations());
+    // The indexes remain registered when an idle index catalog is released and instantiated
+    // again, which keeps their usage statistics.
+    auto registeredIndexes = usageTracker.getUsageStats();
     while (ii->more()) {
         const IndexDescriptor* desc = ii->next()->descriptor();
-        CollectionIndexUsageTrackerDecoration::get(coll->getSharedDecorations())
-            .registerIndex(desc->indexName(), desc->keyPattern());
+        if (registeredIndexes->find(desc->indexName()) == registeredIndexes->end()) {
+            usageTracker.registerIndex(desc->indexName(), desc->keyPattern());
+        }
     }
 
     rebuildIndexData(opCtx, coll);
@@ -97,6 +97,7 @@
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/operation_phase_timeline.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/logv2/log.h"
@@ -595,7 +596,9 @@ public:
 
         // Check that the query should be cached.
         if (shouldCacheQuery(*_cq)) {
+            OperationPhaseTimer phaseTimer(_opCtx, OperationPhase::kPlanCacheLookup);
             auto result = buildCachedPlan(plannerParams, planCacheKey);
+            phaseTimer.stop();
             if (result) {
                 return {std::move(result)};
             }
@@ -1254,6 +1257,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutor(
     std::function<void(CanonicalQuery*)> extractAndAttachPipelineStages,
     PlanYieldPolicy::YieldPolicy yieldPolicy,
     size_t plannerOptions) {
+    OperationPhaseTimer phaseTimer(opCtx, OperationPhase::kPlanning);
     canonicalQuery->setSbeCompatible(
         sbe::isQuerySbeCompatible(collection, canonicalQuery.get(), plannerOptions));
     return !canonicalQuery->getForceClassicEngine() && canonicalQuery->isSbeCompatible()
@@ -1351,6 +1355,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDele
     const auto& collection = *coll;
     auto expCtx = parsedDelete->expCtx();
     OperationContext* opCtx = expCtx->opCtx;
+    OperationPhaseTimer phaseTimer(opCtx, OperationPhase::kPlanning);
     const DeleteRequest* request = parsedDelete->getRequest();
 
     const NamespaceString& nss(request->getNsString());
@@ -1525,6 +1530,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpda
 
     auto expCtx = parsedUpdate->expCtx();
     OperationContext* opCtx = expCtx->opCtx;
+    OperationPhaseTimer phaseTimer(opCtx, OperationPhase::kPlanning);
 
     const UpdateRequest* request = parsedUpdate->getRequest();
     UpdateDriver* driver = parsedUpdate->getDriver();
@@ -1924,6 +1930,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorCoun
     const auto& collection = *coll;
 
     OperationContext* opCtx = expCtx->opCtx;
+    OperationPhaseTimer phaseTimer(opCtx, OperationPhase::kPlanning);
     std::unique_ptr<WorkingSet> ws = std::make_unique<WorkingSet>();
 
     auto findCommand = std::make_unique<FindCommandRequest>(nss);
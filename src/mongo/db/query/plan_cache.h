@@ -381,6 +381,34 @@ public:
         return Status::OK();
     }
 
+    /**
+     * Adds an active entry for 'key' which takes 'works' to produce results, unless the cache
+     * already has an entry for 'key'. Used to warm the cache up with a plan which won the multi
+     * planner in an earlier run of the process, or on another node. Like any active entry, the
+     * entry is replanned if the plan performs worse than 'works' suggests.
+     */
+    void restore(const KeyType& key,
+                 std::unique_ptr<CachedPlanType> cachedPlan,
+                 size_t works,
+                 Date_t now,
+                 DebugInfoType debugInfo) {
+        invariant(cachedPlan);
+
+        auto partition = _partitionedCache->lockOnePartition(key);
+        if (partition->get(key).isOK()) {
+            return;
+        }
+
+        auto newEntry(Entry::create(std::move(cachedPlan),
+                                    key.queryHash(),
+                                    key.planCacheKeyHash(),
+                                    now,
+                                    true /* isActive */,
+                                    works,
+                                    std::move(debugInfo)));
+        partition->add(key, newEntry.release());
+    }
+
     /**
      * Set a cache entry back to the 'inactive' state. Rather than completely evicting an entry
      * when the associated plan starts to perform poorly, we deactivate it, so that plans which
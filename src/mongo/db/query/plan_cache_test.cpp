@@ -814,6 +814,43 @@ TEST(PlanCacheTest, GetMatchingStatsMatchesAndSerializesCorrectly) {
     ASSERT_BSONOBJ_EQ(BSON("works" << 5), getStatsResult[0]);
 }
 
+TEST(PlanCacheTest, CachedIndexTreesShareIndexEntriesAndSubtrees) {
+    auto child = std::make_unique<PlanCacheIndexTree>();
+    child->setIndexEntry(IndexEntry(BSON("a" << 1),
+                                    INDEX_BTREE,
+                                    IndexDescriptor::kLatestIndexVersion,
+                                    false,  // multikey
+                                    {},
+                                    {},
+                                    false,  // sparse
+                                    false,  // unique
+                                    IndexEntry::Identifier{"a_1"},
+                                    nullptr,
+                                    BSONObj(),
+                                    nullptr,
+                                    nullptr));
+    std::shared_ptr<const PlanCacheIndexTree> sharedChild = std::move(child);
+
+    // Two branches of an $or assigned to the same index.
+    auto root = std::make_unique<PlanCacheIndexTree>();
+    root->children.push_back(sharedChild);
+    auto sibling = sharedChild->clone();
+    ASSERT_EQ(sibling->entry.get(), sharedChild->entry.get());
+    root->children.push_back(std::move(sibling));
+
+    // The index entry is only accounted for once.
+    const auto entrySize = sharedChild->entry->estimateObjectSizeInBytes();
+    ASSERT_LT(root->estimateObjectSizeInBytes(),
+              sharedChild->estimateObjectSizeInBytes() * 2 + sizeof(PlanCacheIndexTree));
+    ASSERT_GT(root->estimateObjectSizeInBytes(), entrySize);
+
+    // Copies of the cache data share the tree rather than copy it.
+    SolutionCacheData cacheData;
+    cacheData.tree = std::move(root);
+    auto cacheDataCopy = cacheData.clone();
+    ASSERT_EQ(cacheDataCopy->tree.get(), cacheData.tree.get());
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
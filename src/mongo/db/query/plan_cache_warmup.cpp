@@ -0,0 +1,314 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cache_warmup.h"
+
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/persistent_task_store.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/classic_plan_cache.h"
+#include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_cache_key_factory.h"
+#include "mongo/db/query/plan_cache_warmup_gen.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+namespace {
+
+const auto serviceDecoration = ServiceContext::declareDecoration<PlanCacheWarmupService>();
+
+const ReplicaSetAwareServiceRegistry::Registerer<PlanCacheWarmupService>
+    planCacheWarmupServiceRegisterer("PlanCacheWarmupService");
+
+// The recorded plans are only hints, so recording them does not wait for replication.
+const WriteConcernOptions kLocalWriteConcern{
+    1, WriteConcernOptions::SyncMode::UNSET, WriteConcernOptions::kNoTimeout};
+
+std::string makeEntryId(const NamespaceString& nss, uint32_t planCacheKey) {
+    return str::stream() << nss.ns() << "/" << planCacheKey;
+}
+
+/**
+ * Plans the query shape of 'entry' and, if one of the solutions has the recorded index assignment,
+ * adds it to the plan cache of 'collection'. Returns whether an entry was added.
+ */
+bool restorePlanCacheEntry(OperationContext* opCtx,
+                           const CollectionPtr& collection,
+                           const PlanCacheWarmupEntry& entry) {
+    auto findCommand = std::make_unique<FindCommandRequest>(entry.getNss());
+    findCommand->setFilter(entry.getFilter());
+    findCommand->setSort(entry.getSort());
+    findCommand->setProjection(entry.getProjection());
+    findCommand->setCollation(entry.getCollation());
+    auto statusWithCQ = CanonicalQuery::canonicalize(opCtx, std::move(findCommand));
+    if (!statusWithCQ.isOK()) {
+        return false;
+    }
+    auto cq = std::move(statusWithCQ.getValue());
+
+    // Set up the query the same way as when it runs, so that it gets the same plan cache key.
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(opCtx, collection, cq.get(), &plannerParams);
+    if (cq->getFindCommandRequest().getCollation().isEmpty() &&
+        collection->getDefaultCollator()) {
+        cq->setCollator(collection->getDefaultCollator()->clone());
+    }
+    if (!shouldCacheQuery(*cq)) {
+        return false;
+    }
+
+    auto planCache = CollectionQueryInfo::get(collection).getPlanCache();
+    const auto key = plan_cache_key_factory::make<PlanCacheKey>(*cq, collection);
+    if (planCache->getEntry(key).isOK()) {
+        return false;
+    }
+
+    auto statusWithSolutions = QueryPlanner::plan(*cq, plannerParams);
+    if (!statusWithSolutions.isOK()) {
+        return false;
+    }
+
+    for (auto&& solution : statusWithSolutions.getValue()) {
+        if (!solution->cacheData || solution->cacheData->toString() != entry.getSolution()) {
+            continue;
+        }
+
+        // The plan did not run here, so the decision only records the works it needed to win.
+        auto stats = std::make_unique<PlanStageStats>(CommonStats("PLAN_CACHE_WARMUP"));
+        stats->common.works = entry.getWorks();
+        std::vector<std::unique_ptr<PlanStageStats>> candidatePlanStats;
+        candidatePlanStats.push_back(std::move(stats));
+        auto decision = std::make_unique<plan_ranker::PlanRankingDecision>();
+        decision->stats = plan_ranker::StatsDetails{std::move(candidatePlanStats)};
+        decision->scores = {0};
+        decision->candidateOrder = {0};
+
+        planCache->restore(key,
+                           solution->cacheData->clone(),
+                           entry.getWorks(),
+                           opCtx->getServiceContext()->getPreciseClockSource()->now(),
+                           plan_cache_debug_info::DebugInfo(
+                               plan_cache_debug_info::CreatedFromQuery{entry.getFilter(),
+                                                                       entry.getSort(),
+                                                                       entry.getProjection(),
+                                                                       entry.getCollation()},
+                               std::move(decision)));
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+PlanCacheWarmupService* PlanCacheWarmupService::get(ServiceContext* serviceContext) {
+    return &serviceDecoration(serviceContext);
+}
+
+void PlanCacheWarmupService::snapshotPlanCaches(OperationContext* opCtx) {
+    const auto snapshotTime = opCtx->getServiceContext()->getPreciseClockSource()->now();
+    const size_t maxEntries = internalQueryPlanCacheWarmupMaxEntriesPerCollection.load();
+
+    std::vector<NamespaceString> namespaces;
+    {
+        Lock::GlobalLock globalLock(opCtx, MODE_IS);
+        auto catalog = CollectionCatalog::get(opCtx);
+        for (auto&& dbName : catalog->getAllDbNames()) {
+            for (auto&& nss : catalog->getAllCollectionNamesFromDb(opCtx, dbName)) {
+                if (!nss.isOnInternalDb() && !nss.isSystem()) {
+                    namespaces.push_back(nss);
+                }
+            }
+        }
+    }
+
+    PersistentTaskStore<PlanCacheWarmupEntry> store(NamespaceString::kPlanCacheWarmupNamespace);
+    size_t numEntries = 0;
+    for (const auto& nss : namespaces) {
+        std::vector<PlanCacheWarmupEntry> entries;
+        {
+            AutoGetCollectionForRead collection(opCtx, nss);
+            if (!collection) {
+                continue;
+            }
+
+            auto planCache = CollectionQueryInfo::get(collection.getCollection()).getPlanCache();
+            for (auto&& cacheEntry : planCache->getAllEntries()) {
+                if (entries.size() >= maxEntries) {
+                    break;
+                }
+
+                // Inactive entries have not proven their plan yet, and the entries without debug
+                // info do not know their query.
+                if (!cacheEntry->isActive || !cacheEntry->debugInfo) {
+                    continue;
+                }
+
+                const auto& query = cacheEntry->debugInfo->createdFromQuery;
+                entries.emplace_back(makeEntryId(nss, cacheEntry->planCacheKey),
+                                     nss,
+                                     query.filter,
+                                     query.sort,
+                                     query.projection,
+                                     query.collation,
+                                     cacheEntry->cachedPlan->toString(),
+                                     cacheEntry->works,
+                                     snapshotTime);
+            }
+        }
+
+        for (const auto& entry : entries) {
+            store.upsert(opCtx,
+                         BSON(PlanCacheWarmupEntry::kIdFieldName << entry.getId()),
+                         entry.toBSON(),
+                         kLocalWriteConcern);
+        }
+        numEntries += entries.size();
+    }
+
+    // Drop the entries which were not recorded again, such as those of dropped collections.
+    store.remove(opCtx,
+                 BSON(PlanCacheWarmupEntry::kSnapshotTimeFieldName << BSON("$lt" << snapshotTime)),
+                 kLocalWriteConcern);
+
+    LOGV2_DEBUG(
+        6442500, 1, "Recorded plan cache entries for warm-up", "numEntries"_attr = numEntries);
+}
+
+size_t PlanCacheWarmupService::warmUpPlanCaches(OperationContext* opCtx) {
+    std::map<NamespaceString, std::vector<PlanCacheWarmupEntry>> entriesByNss;
+    {
+        DBDirectClient client(opCtx);
+        auto cursor = client.find(FindCommandRequest{NamespaceString::kPlanCacheWarmupNamespace},
+                                  ReadPreferenceSetting{ReadPreference::SecondaryPreferred});
+        while (cursor->more()) {
+            auto entry = PlanCacheWarmupEntry::parse(IDLParserErrorContext("PlanCacheWarmupEntry"),
+                                                     cursor->next());
+            entriesByNss[entry.getNss()].push_back(std::move(entry));
+        }
+    }
+
+    size_t numRestored = 0;
+    for (const auto& [nss, entries] : entriesByNss) {
+        AutoGetCollectionForRead collection(opCtx, nss);
+        if (!collection) {
+            continue;
+        }
+
+        for (const auto& entry : entries) {
+            try {
+                if (restorePlanCacheEntry(opCtx, collection.getCollection(), entry)) {
+                    ++numRestored;
+                }
+            } catch (const DBException& ex) {
+                if (ErrorCodes::isInterruption(ex.code())) {
+                    throw;
+                }
+                LOGV2_DEBUG(6442501,
+                            2,
+                            "Skipping plan cache entry which cannot be warmed up",
+                            "entry"_attr = redact(entry.toBSON()),
+                            "error"_attr = redact(ex.toStatus()));
+            }
+        }
+    }
+    return numRestored;
+}
+
+void PlanCacheWarmupService::onStartup(OperationContext* opCtx) {
+    _warmUpPending.store(true);
+
+    auto periodicRunner = opCtx->getServiceContext()->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job(
+        "planCacheWarmup",
+        [this](Client* client) {
+            try {
+                _runPeriodicTasks(client);
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>& ex) {
+                LOGV2_DEBUG(6442502, 2, "Periodic job interrupted", "reason"_attr = ex.reason());
+            } catch (const DBException& ex) {
+                LOGV2_WARNING(
+                    6442503, "Failed to warm up or record the plan caches", "error"_attr = ex);
+            }
+        },
+        Seconds(1));
+
+    _job = periodicRunner->makeJob(std::move(job));
+    _job.start();
+}
+
+void PlanCacheWarmupService::onShutdown() {
+    if (_job.isValid()) {
+        _job.stop();
+    }
+}
+
+void PlanCacheWarmupService::onStepUpComplete(OperationContext* opCtx, long long term) {
+    _warmUpPending.store(true);
+}
+
+void PlanCacheWarmupService::_runPeriodicTasks(Client* client) {
+    if (!internalQueryEnablePlanCacheWarmup.load()) {
+        return;
+    }
+
+    auto opCtx = client->makeOperationContext();
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx.get());
+    const auto memberState = replCoord->getMemberState();
+
+    if (_warmUpPending.load() && memberState.readable()) {
+        _warmUpPending.store(false);
+        const auto numRestored = warmUpPlanCaches(opCtx.get());
+        LOGV2(6442504, "Warmed up the plan caches", "numEntries"_attr = numRestored);
+    }
+
+    const auto now = opCtx->getServiceContext()->getPreciseClockSource()->now();
+    if (memberState.primary() &&
+        now - _lastSnapshotTime >=
+            Seconds(internalQueryPlanCacheWarmupSnapshotIntervalSecs.load())) {
+        _lastSnapshotTime = now;
+        snapshotPlanCaches(opCtx.get());
+    }
+}
+
+}  // namespace mongo
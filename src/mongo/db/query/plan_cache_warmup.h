@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/replica_set_aware_service.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/periodic_runner.h"
+
+namespace mongo {
+
+/**
+ * Keeps the winning plans of the classic plan caches across restarts and elections.
+ *
+ * While internalQueryEnablePlanCacheWarmup is set, the primary periodically records the query
+ * shape and the index assignment of the active entries of the plan caches of the user collections
+ * in config.plan_cache_warmup, from where they replicate to the secondaries. When a node starts up
+ * or steps up, it plans the recorded shapes again and adds the plans with the recorded index
+ * assignments to its plan caches as active entries. The first execution of a recorded shape thus
+ * runs the cached plan instead of the multi planner, and is replanned as usual if the plan does
+ * worse than when it was recorded.
+ */
+class PlanCacheWarmupService final : public ReplicaSetAwareService<PlanCacheWarmupService> {
+public:
+    PlanCacheWarmupService() = default;
+
+    static PlanCacheWarmupService* get(ServiceContext* serviceContext);
+
+    /**
+     * Records the active entries of the plan caches of the user collections, replacing the entries
+     * recorded by the previous call. Must run on the primary.
+     */
+    static void snapshotPlanCaches(OperationContext* opCtx);
+
+    /**
+     * Adds the recorded plans to the plan caches, and returns how many were added. The plans whose
+     * query shape is already cached, or whose index assignment the current indexes no longer
+     * produce, are skipped.
+     */
+    static size_t warmUpPlanCaches(OperationContext* opCtx);
+
+private:
+    void onStartup(OperationContext* opCtx) final;
+    void onShutdown() final;
+    void onStepUpBegin(OperationContext* opCtx, long long term) final {}
+    void onStepUpComplete(OperationContext* opCtx, long long term) final;
+    void onStepDown() final {}
+    void onBecomeArbiter() final {}
+
+    void _runPeriodicTasks(Client* client);
+
+    // Set when the node starts up or steps up, and cleared once the plan caches are warmed up.
+    AtomicWord<bool> _warmUpPending{false};
+
+    // Only accessed by the periodic job.
+    Date_t _lastSnapshotTime;
+
+    PeriodicJobAnchor _job;
+};
+
+}  // namespace mongo
@@ -34,6 +34,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/stats/operation_phase_timeline.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 
@@ -159,6 +160,8 @@ void PlanYieldPolicy::performYield(OperationContext* opCtx,
         return;
     }
 
+    OperationPhaseTimer phaseTimer(opCtx, OperationPhase::kYield);
+
     // Since the locks are not recursively held, this is a top level operation and we can safely
     // clear the 'yieldable' state before unlocking and then re-establish it after re-locking.
     if (yieldable) {
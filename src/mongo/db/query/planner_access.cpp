@@ -363,6 +363,8 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
         params.options & QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
     csn->shouldWaitForOplogVisibility =
         params.options & QueryPlannerParams::OPLOG_SCAN_WAIT_FOR_VISIBLE;
+    csn->shareOplogReads = tailable && query.nss().isOplog() &&
+        (params.options & QueryPlannerParams::SHARE_OPLOG_READS);
 
     const BSONObj& hint = query.getFindCommandRequest().getHint();
     if (!hint.isEmpty()) {
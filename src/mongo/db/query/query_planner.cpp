@@ -45,6 +45,7 @@
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
 #include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_set_window_fields.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/classic_plan_cache.h"
 #include "mongo/db/query/collation/collation_index_key.h"
@@ -124,8 +125,9 @@ Status tagOrChildAccordingToCache(PlanCacheIndexTree* compositeCacheData,
         return tagStatus.withContext(ss);
     }
 
-    // Add the child's cache data to the cache data we're creating for the main query.
-    compositeCacheData->children.push_back(branchCacheData->tree->clone());
+    // Add the child's cache data to the cache data we're creating for the main query. The subtree
+    // is immutable, so it is shared rather than copied.
+    compositeCacheData->children.push_back(branchCacheData->tree);
 
     return Status::OK();
 }
@@ -245,6 +247,9 @@ string optionString(size_t options) {
             case QueryPlannerParams::RETURN_OWNED_DATA:
                 ss << "RETURN_OWNED_DATA ";
                 break;
+            case QueryPlannerParams::SHARE_OPLOG_READS:
+                ss << "SHARE_OPLOG_READS ";
+                break;
             case QueryPlannerParams::DEFAULT:
                 MONGO_UNREACHABLE;
                 break;
@@ -402,8 +407,26 @@ bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
         kp, SimpleBSONElementComparator::kInstance);
 }
 
-StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTaggedTree(
-    const MatchExpression* const taggedTree, const vector<IndexEntry>& relevantIndices) {
+namespace {
+/**
+ * Returns the copy of 'relevantIndices[index]' shared by all the nodes of a cache data tree,
+ * making it on first use.
+ */
+std::shared_ptr<const IndexEntry> internIndexEntry(
+    const vector<IndexEntry>& relevantIndices,
+    size_t index,
+    std::vector<std::shared_ptr<const IndexEntry>>* internedEntries) {
+    auto& entry = (*internedEntries)[index];
+    if (!entry) {
+        entry = std::make_shared<const IndexEntry>(relevantIndices[index]);
+    }
+    return entry;
+}
+
+StatusWith<std::unique_ptr<PlanCacheIndexTree>> buildCacheDataFromTaggedTree(
+    const MatchExpression* const taggedTree,
+    const vector<IndexEntry>& relevantIndices,
+    std::vector<std::shared_ptr<const IndexEntry>>* internedEntries) {
     if (!taggedTree) {
         return Status(ErrorCodes::BadValue, "Cannot produce cache data: tree is NULL.");
     }
@@ -430,8 +453,7 @@ StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTagge
             return Status(ErrorCodes::BadValue, "can't cache '2d' index");
         }
 
-        IndexEntry* ientry = new IndexEntry(relevantIndices[itag->index]);
-        indexTree->entry.reset(ientry);
+        indexTree->entry = internIndexEntry(relevantIndices, itag->index, internedEntries);
         indexTree->index_pos = itag->pos;
         indexTree->canCombineBounds = itag->canCombineBounds;
     } else if (taggedTree->getTag() &&
@@ -445,9 +467,7 @@ StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTagge
                 return Status(ErrorCodes::BadValue, "can't cache '2d' index");
             }
 
-            std::unique_ptr<IndexEntry> indexEntry =
-                std::make_unique<IndexEntry>(relevantIndices[itag->index]);
-            indexTree->entry.reset(indexEntry.release());
+            indexTree->entry = internIndexEntry(relevantIndices, itag->index, internedEntries);
             indexTree->index_pos = itag->pos;
             indexTree->canCombineBounds = itag->canCombineBounds;
         }
@@ -464,7 +484,8 @@ StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTagge
 
     for (size_t i = 0; i < taggedTree->numChildren(); ++i) {
         MatchExpression* taggedChild = taggedTree->getChild(i);
-        auto statusWithTree = cacheDataFromTaggedTree(taggedChild, relevantIndices);
+        auto statusWithTree =
+            buildCacheDataFromTaggedTree(taggedChild, relevantIndices, internedEntries);
         if (!statusWithTree.isOK()) {
             return statusWithTree.getStatus();
         }
@@ -473,6 +494,13 @@ StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTagge
 
     return {std::move(indexTree)};
 }
+}  // namespace
+
+StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTaggedTree(
+    const MatchExpression* const taggedTree, const vector<IndexEntry>& relevantIndices) {
+    std::vector<std::shared_ptr<const IndexEntry>> internedEntries(relevantIndices.size());
+    return buildCacheDataFromTaggedTree(taggedTree, relevantIndices, &internedEntries);
+}
 
 // static
 Status QueryPlanner::tagAccordingToCache(MatchExpression* filter,
@@ -1246,9 +1274,18 @@ std::unique_ptr<QuerySolution> QueryPlanner::extendWithAggPipeline(
 
     std::unique_ptr<QuerySolutionNode> solnForAgg = std::make_unique<SentinelNode>();
     for (auto& innerStage : query.pipeline()) {
+        if (auto windowStage = dynamic_cast<DocumentSourceInternalSetWindowFields*>(
+                innerStage->documentSource())) {
+            solnForAgg = std::make_unique<WindowNode>(std::move(solnForAgg),
+                                                      windowStage->getPartitionBy(),
+                                                      windowStage->getOutputFields());
+            continue;
+        }
+
         auto groupStage = dynamic_cast<DocumentSourceGroup*>(innerStage->documentSource());
         tassert(5842400,
-                "Cannot support pushdown of a stage other than $group at the moment",
+                "Cannot support pushdown of a stage other than $group or $setWindowFields at the "
+                "moment",
                 groupStage != nullptr);
 
         solnForAgg = std::make_unique<GroupNode>(std::move(solnForAgg),
@@ -1327,7 +1364,7 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::choosePlanForSubqueries
                 return tagStatus.withContext(ss);
             }
 
-            cacheData->children.push_back(bestSoln->cacheData->tree->clone());
+            cacheData->children.push_back(bestSoln->cacheData->tree);
         }
     }
 
@@ -119,6 +119,10 @@ struct QueryPlannerParams {
         // Ensure that any plan generated returns data that is "owned." That is, all BSONObjs are
         // in an "owned" state and are not pointing to data that belongs to the storage engine.
         RETURN_OWNED_DATA = 1 << 12,
+
+        // Set this on a tailable oplog scan serving a change stream to let it share its oplog
+        // reads with other change streams.
+        SHARE_OPLOG_READS = 1 << 13,
     };
 
     // See Options enum above.
@@ -42,6 +42,7 @@
 #include "mongo/db/index_names.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/pipeline/document_source_set_window_fields.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/planner_analysis.h"
@@ -300,6 +301,7 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->shouldTrackLatestOplogTimestamp = this->shouldTrackLatestOplogTimestamp;
     copy->assertTsHasNotFallenOffOplog = this->assertTsHasNotFallenOffOplog;
     copy->shouldWaitForOplogVisibility = this->shouldWaitForOplogVisibility;
+    copy->shareOplogReads = this->shareOplogReads;
 
     return copy;
 }
@@ -1524,6 +1526,52 @@ QuerySolutionNode* GroupNode::clone() const {
     return copy.release();
 }
 
+/**
+ * WindowNode.
+ */
+WindowNode::WindowNode(std::unique_ptr<QuerySolutionNode> child,
+                       boost::optional<boost::intrusive_ptr<Expression>> partitionBy,
+                       std::vector<WindowFunctionStatement> outputFields)
+    : QuerySolutionNode(std::move(child)),
+      partitionBy(std::move(partitionBy)),
+      outputFields(std::move(outputFields)) {}
+
+WindowNode::~WindowNode() = default;
+
+void WindowNode::appendToString(str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "WINDOW\n";
+    addIndent(ss, indent + 1);
+    *ss << "partitionBy = ";
+    if (partitionBy && *partitionBy) {
+        *ss << (*partitionBy)->serialize(false).toString();
+    } else {
+        *ss << "none";
+    }
+    *ss << '\n';
+    addIndent(ss, indent + 1);
+    *ss << "output = [";
+    for (size_t idx = 0; idx < outputFields.size(); ++idx) {
+        if (idx > 0) {
+            *ss << ", ";
+        }
+        MutableDocument output;
+        outputFields[idx].serialize(output, boost::none);
+        *ss << output.freeze().toString();
+    }
+    *ss << "]" << '\n';
+    addCommon(ss, indent);
+    addIndent(ss, indent + 1);
+    *ss << "Child:" << '\n';
+    children[0]->appendToString(ss, indent + 2);
+}
+
+QuerySolutionNode* WindowNode::clone() const {
+    auto copy = std::make_unique<WindowNode>(
+        std::unique_ptr<QuerySolutionNode>(children[0]->clone()), partitionBy, outputFields);
+    return copy.release();
+}
+
 /**
  * EqLookupNode.
  */
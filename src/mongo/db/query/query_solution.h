@@ -46,6 +46,7 @@
 namespace mongo {
 
 class GeoNearExpression;
+struct WindowFunctionStatement;
 
 /**
  * Represents the granularity at which a field is available in a query solution node. Note that the
@@ -480,6 +481,9 @@ struct CollectionScanNode : public QuerySolutionNodeWithSortSet {
 
     // Once the first matching document is found, assume that all documents after it must match.
     bool stopApplyingFilterAfterFirstMatch = false;
+
+    // Whether this tailable oplog scan may share its reads with other change streams.
+    bool shareOplogReads = false;
 };
 
 /**
@@ -1333,6 +1337,44 @@ struct GroupNode : public QuerySolutionNode {
     StringSet requiredFields;
 };
 
+/**
+ * Represents a pushed down $_internalSetWindowFields stage. The child is expected to produce the
+ * documents sorted by the partition key and then by the window's sort pattern.
+ */
+struct WindowNode : public QuerySolutionNode {
+    WindowNode(std::unique_ptr<QuerySolutionNode> child,
+               boost::optional<boost::intrusive_ptr<Expression>> partitionBy,
+               std::vector<WindowFunctionStatement> outputFields);
+    ~WindowNode() override;
+
+    StageType getType() const override {
+        return STAGE_WINDOW;
+    }
+
+    void appendToString(str::stream* ss, int indent) const override;
+
+    bool fetched() const {
+        return true;
+    }
+
+    FieldAvailability getFieldAvailability(const std::string& field) const {
+        // All fields are available, but none of them map to original document.
+        return FieldAvailability::kNotProvided;
+    }
+    bool sortedByDiskLoc() const override {
+        return false;
+    }
+
+    const ProvidedSortSet& providedSorts() const final {
+        return kEmptySet;
+    }
+
+    QuerySolutionNode* clone() const override;
+
+    boost::optional<boost::intrusive_ptr<Expression>> partitionBy;
+    std::vector<WindowFunctionStatement> outputFields;
+};
+
 /**
  * Represents a lookup from a foreign collection by equality match on foreign and local fields.
  * Performs left outer join between the child (local) collection and other (foreign) collection.
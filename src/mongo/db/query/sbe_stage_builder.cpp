@@ -51,12 +51,14 @@
 #include "mongo/db/exec/sbe/stages/traverse.h"
 #include "mongo/db/exec/sbe/stages/union.h"
 #include "mongo/db/exec/sbe/stages/unique.h"
+#include "mongo/db/exec/sbe/stages/window.h"
 #include "mongo/db/exec/sbe/values/sort_spec.h"
 #include "mongo/db/exec/shard_filterer.h"
 #include "mongo/db/fts/fts_index_format.h"
 #include "mongo/db/fts/fts_query_impl.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/fts_access_method.h"
+#include "mongo/db/pipeline/document_source_set_window_fields.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_visitor.h"
 #include "mongo/db/query/expression_walker.h"
@@ -2599,6 +2601,161 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
     return {std::move(outStage), std::move(outputs)};
 }
 
+/**
+ * Translates a 'WindowNode' QSN into a sbe::PlanStage tree. The child of the 'WindowNode' must
+ * produce the documents sorted by the partition key and the window's sort pattern. The partition
+ * key and the arguments of all window functions are projected into slots below a window stage,
+ * which computes the window states, and the finalized window function results are added to the
+ * input document by a mkbson stage.
+ *
+ * For example, the $setWindowFields spec {partitionBy: "$a", sortBy: {b: 1}, output: {s: {$sum:
+ * "$c", window: {documents: [-1, 0]}}}} over a collection scan is translated into:
+ *
+ * [2] mkbson s14 s4 [] drop inplace [s = s13] false false
+ * [2] project [s13 = removableSumFinalize (s12)]
+ * [2] window [s7, s4, s8] [s9, s10, s11] 1 [s12 = [aggRemovableSumAdd (s11),
+ *                                                  aggRemovableSumRemove (s11)] [-1, 0]]
+ * [2] project [s8 = getField (s4, "c")]
+ * [2] project [s7 = let [l1.0 = getField (s4, "a")] if (isArray (l1.0), fail (...), ...)]
+ * [1] sort [s5] [asc] [s4] ...
+ */
+std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder::buildWindow(
+    const QuerySolutionNode* root, const PlanStageReqs& reqs) {
+    auto windowNode = static_cast<const WindowNode*>(root);
+    auto nodeId = windowNode->nodeId();
+
+    tassert(
+        6440125, "should have one and only one child for WINDOW", windowNode->children.size() == 1);
+
+    // The window functions are computed over the whole input documents, which are then returned
+    // with the window function results added.
+    auto childReqs = reqs.copy().set(kResult).clear(kRecordId);
+    auto [childStage, childOutputs] = build(windowNode->children[0], childReqs);
+    _shouldProduceRecordIdSlot = false;
+
+    auto rootSlot = childOutputs.get(kResult);
+    EvalStage evalStage{std::move(childStage), sbe::makeSV(rootSlot)};
+    sbe::value::SlotVector currSlots;
+
+    // Evaluates the partition key. As in the classic engine, a missing partition key is treated as
+    // null and an array partition key is an error.
+    size_t partitionSlotCount = 0;
+    if (const auto& partitionBy = windowNode->partitionBy; partitionBy && *partitionBy) {
+        auto [partitionExpr, partitionStage] = generateExpression(
+            _state, partitionBy->get(), std::move(evalStage), rootSlot, nodeId);
+        auto partitionSlot = _slotIdGenerator.generate();
+        evalStage = makeProject(
+            std::move(partitionStage),
+            nodeId,
+            partitionSlot,
+            makeLocalBind(
+                &_frameIdGenerator,
+                [](sbe::EVariable key) {
+                    return sbe::makeE<sbe::EIf>(
+                        makeFunction("isArray"_sd, key.clone()),
+                        sbe::makeE<sbe::EFail>(ErrorCodes::TypeMismatch,
+                                               "An expression used to partition cannot evaluate "
+                                               "to value of type array"),
+                        makeFillEmptyNull(key.clone()));
+                },
+                partitionExpr.extractExpr()));
+        currSlots.push_back(partitionSlot);
+        partitionSlotCount = 1;
+    }
+    currSlots.push_back(rootSlot);
+
+    // Evaluates the argument of every window function into a slot which the window stage buffers
+    // along with the input document. An argument may resolve to an already buffered slot, for
+    // instance when it refers to $$ROOT, in which case that slot is reused.
+    std::vector<size_t> argSlotIndexes;
+    for (const auto& outputField : windowNode->outputFields) {
+        auto [argExpr, argStage] = generateExpression(
+            _state, outputField.expr->input().get(), std::move(evalStage), rootSlot, nodeId);
+        auto [argSlot, projectStage] =
+            projectEvalExpr(std::move(argExpr), std::move(argStage), nodeId, &_slotIdGenerator);
+        evalStage = std::move(projectStage);
+
+        auto it = std::find(currSlots.begin(), currSlots.end(), argSlot);
+        argSlotIndexes.push_back(std::distance(currSlots.begin(), it));
+        if (it == currSlots.end()) {
+            currSlots.push_back(argSlot);
+        }
+    }
+
+    // The window expressions see the rows entering or leaving a window through the frame slots.
+    auto frameSlots = _slotIdGenerator.generateMultiple(currSlots.size());
+    std::vector<sbe::WindowStage::Window> windows;
+    sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> finalProjects;
+    std::vector<std::string> outputFieldNames;
+    sbe::value::SlotVector outputSlots;
+    for (size_t idx = 0; idx < windowNode->outputFields.size(); ++idx) {
+        const auto& outputField = windowNode->outputFields[idx];
+        auto opName = outputField.expr->getOpName();
+        auto frameArgSlot = frameSlots[argSlotIndexes[idx]];
+
+        auto [addExpr, removeExpr] =
+            buildWindowAccumulator(_state, opName, makeVariable(frameArgSlot));
+
+        auto bounds = outputField.expr->bounds();
+        auto* documentBounds = stdx::get_if<WindowBounds::DocumentBased>(&bounds.bounds);
+        tassert(6440126, "Only document-based windows can be lowered to SBE", documentBounds);
+        auto toOffset = [](const WindowBounds::Bound<int>& bound) -> boost::optional<int> {
+            return stdx::visit(
+                visit_helper::Overloaded{
+                    [](const WindowBounds::Unbounded&) -> boost::optional<int> {
+                        return boost::none;
+                    },
+                    [](const WindowBounds::Current&) -> boost::optional<int> { return 0; },
+                    [](const int& offset) -> boost::optional<int> { return offset; }},
+                bound);
+        };
+
+        auto windowSlot = _slotIdGenerator.generate();
+        windows.emplace_back(windowSlot,
+                             std::move(addExpr),
+                             std::move(removeExpr),
+                             toOffset(documentBounds->lower),
+                             toOffset(documentBounds->upper));
+
+        auto outputSlot = _slotIdGenerator.generate();
+        finalProjects.emplace(outputSlot, buildWindowFinalize(_state, opName, windowSlot));
+        outputFieldNames.push_back(outputField.fieldName);
+        outputSlots.push_back(outputSlot);
+    }
+
+    auto windowStage = sbe::makeS<sbe::WindowStage>(
+        stageOrLimitCoScan(std::move(evalStage), nodeId).stage,
+        currSlots,
+        std::move(frameSlots),
+        partitionSlotCount,
+        std::move(windows),
+        _state.env->getSlotIfExists("collator"_sd),
+        _cq.getExpCtx()->allowDiskUse,
+        nodeId);
+    auto outStage =
+        sbe::makeS<sbe::ProjectStage>(std::move(windowStage), std::move(finalProjects), nodeId);
+
+    PlanStageSlots outputs;
+    if (reqs.has(kResult)) {
+        outputs.set(kResult, _slotIdGenerator.generate());
+        // The window function results replace any existing fields with the same names at their
+        // position in the document, as in the classic engine.
+        outStage = sbe::makeS<sbe::MakeBsonObjStage>(std::move(outStage),
+                                                     outputs.get(kResult),
+                                                     rootSlot,
+                                                     sbe::MakeBsonObjStage::FieldBehavior::drop,
+                                                     std::vector<std::string>{},
+                                                     std::move(outputFieldNames),
+                                                     std::move(outputSlots),
+                                                     false,
+                                                     false,
+                                                     nodeId,
+                                                     true /* overwriteInPlace */);
+    }
+
+    return {std::move(outStage), std::move(outputs)};
+}
+
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots>
 SlotBasedStageBuilder::makeUnionForTailableCollScan(const QuerySolutionNode* root,
                                                     const PlanStageReqs& reqs) {
@@ -2961,6 +3118,7 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
             {STAGE_AND_SORTED, &SlotBasedStageBuilder::buildAndSorted},
             {STAGE_SORT_MERGE, &SlotBasedStageBuilder::buildSortMerge},
             {STAGE_GROUP, &SlotBasedStageBuilder::buildGroup},
+            {STAGE_WINDOW, &SlotBasedStageBuilder::buildWindow},
             {STAGE_SHARDING_FILTER, &SlotBasedStageBuilder::buildShardFilter}};
 
     tassert(4822884,
@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/accumulator_for_window_functions.h"
 #include "mongo/db/pipeline/accumulator_js_reduce.h"
+#include "mongo/db/pipeline/accumulator_percentile.h"
 #include "mongo/db/query/sbe_stage_builder_accumulator.h"
 #include "mongo/db/query/sbe_stage_builder_expression.h"
 #include "mongo/db/query/sbe_stage_builder_helpers.h"
@@ -407,6 +408,88 @@ std::pair<std::unique_ptr<sbe::EExpression>, EvalStage> buildFinalizeStdDevSamp(
     }
 }
 
+std::pair<std::vector<std::unique_ptr<sbe::EExpression>>, EvalStage>
+buildAccumulatorApproxCountDistinct(StageBuilderState& state,
+                                    const AccumulationExpression& expr,
+                                    std::unique_ptr<sbe::EExpression> arg,
+                                    EvalStage inputStage,
+                                    PlanNodeId planNodeId) {
+    std::vector<std::unique_ptr<sbe::EExpression>> aggs;
+    auto collatorSlot = state.env->getSlotIfExists("collator"_sd);
+    if (collatorSlot) {
+        aggs.push_back(makeFunction("aggCollApproxCountDistinct"_sd,
+                                    sbe::makeE<sbe::EVariable>(*collatorSlot),
+                                    std::move(arg)));
+    } else {
+        aggs.push_back(makeFunction("aggApproxCountDistinct", std::move(arg)));
+    }
+    return {std::move(aggs), std::move(inputStage)};
+}
+
+std::pair<std::unique_ptr<sbe::EExpression>, EvalStage> buildFinalizeApproxCountDistinct(
+    StageBuilderState& state,
+    const AccumulationExpression& expr,
+    const sbe::value::SlotVector& sketchSlots,
+    EvalStage inputStage,
+    PlanNodeId planNodeId) {
+    tassert(6440032,
+            str::stream()
+                << "Expected one input slot for finalization of approxCountDistinct, got: "
+                << sketchSlots.size(),
+            sketchSlots.size() == 1);
+
+    if (state.needsMerge) {
+        // The partial result is the HyperLogLog sketch itself, which the merging side combines
+        // with the sketches produced by the other shards.
+        return {makeVariable(sketchSlots[0]), std::move(inputStage)};
+    } else {
+        return {makeFunction("approxCountDistinctFinalize", makeVariable(sketchSlots[0])),
+                std::move(inputStage)};
+    }
+}
+
+std::pair<std::vector<std::unique_ptr<sbe::EExpression>>, EvalStage> buildAccumulatorPercentile(
+    StageBuilderState& state,
+    const AccumulationExpression& expr,
+    std::unique_ptr<sbe::EExpression> arg,
+    EvalStage inputStage,
+    PlanNodeId planNodeId) {
+    std::vector<std::unique_ptr<sbe::EExpression>> aggs;
+    aggs.push_back(makeFunction("aggTDigest", std::move(arg)));
+    return {std::move(aggs), std::move(inputStage)};
+}
+
+std::pair<std::unique_ptr<sbe::EExpression>, EvalStage> buildFinalizePercentile(
+    StageBuilderState& state,
+    const AccumulationExpression& expr,
+    const sbe::value::SlotVector& digestSlots,
+    EvalStage inputStage,
+    PlanNodeId planNodeId) {
+    tassert(6440033,
+            str::stream() << "Expected one input slot for finalization of " << expr.name
+                          << ", got: " << digestSlots.size(),
+            digestSlots.size() == 1);
+
+    if (state.needsMerge) {
+        // As for approxCountDistinct, the partial result is the t-digest itself.
+        return {makeVariable(digestSlots[0]), std::move(inputStage)};
+    }
+
+    // $median produces a scalar, so it passes a scalar 'p'. The percentiles requested by
+    // $percentile are carried as a constant array in the initializer.
+    std::unique_ptr<sbe::EExpression> ps;
+    if (expr.name == AccumulatorMedian::kName) {
+        ps = makeConstant(sbe::value::TypeTags::NumberDouble, 0.5);
+    } else {
+        auto psConst = dynamic_cast<ExpressionConstant*>(expr.initializer.get());
+        tassert(6440034, "Expected the percentiles to be a constant array", psConst);
+        auto [psTag, psVal] = makeValue(psConst->getValue());
+        ps = sbe::makeE<sbe::EConstant>(psTag, psVal);
+    }
+    return {makeFunction("tDigestPercentileFinalize", makeVariable(digestSlots[0]), std::move(ps)),
+            std::move(inputStage)};
+}
+
 std::pair<std::vector<std::unique_ptr<sbe::EExpression>>, EvalStage> buildAccumulatorMergeObjects(
     StageBuilderState& state,
     const AccumulationExpression& expr,
@@ -472,6 +555,9 @@ std::pair<std::vector<std::unique_ptr<sbe::EExpression>>, EvalStage> buildAccumu
         {AccumulatorMergeObjects::kName, &buildAccumulatorMergeObjects},
         {AccumulatorStdDevPop::kName, &buildAccumulatorStdDev},
         {AccumulatorStdDevSamp::kName, &buildAccumulatorStdDev},
+        {AccumulatorApproxCountDistinct::kName, &buildAccumulatorApproxCountDistinct},
+        {AccumulatorPercentile::kName, &buildAccumulatorPercentile},
+        {AccumulatorMedian::kName, &buildAccumulatorPercentile},
     };
 
     auto accExprName = acc.expr.name;
@@ -512,6 +598,9 @@ std::pair<std::unique_ptr<sbe::EExpression>, EvalStage> buildFinalize(
         {AccumulatorMergeObjects::kName, nullptr},
         {AccumulatorStdDevPop::kName, &buildFinalizeStdDevPop},
         {AccumulatorStdDevSamp::kName, &buildFinalizeStdDevSamp},
+        {AccumulatorApproxCountDistinct::kName, &buildFinalizeApproxCountDistinct},
+        {AccumulatorPercentile::kName, &buildFinalizePercentile},
+        {AccumulatorMedian::kName, &buildFinalizePercentile},
     };
 
     auto accExprName = acc.expr.name;
@@ -526,4 +615,44 @@ std::pair<std::unique_ptr<sbe::EExpression>, EvalStage> buildFinalize(
         return {nullptr, std::move(inputStage)};
     }
 }
+
+std::pair<std::unique_ptr<sbe::EExpression>, std::unique_ptr<sbe::EExpression>>
+buildWindowAccumulator(StageBuilderState& state,
+                       StringData opName,
+                       std::unique_ptr<sbe::EExpression> argExpr) {
+    if (opName == AccumulatorSum::kName || opName == AccumulatorAvg::kName) {
+        auto removeExpr = makeFunction("aggRemovableSumRemove"_sd, argExpr->clone());
+        return {makeFunction("aggRemovableSumAdd"_sd, std::move(argExpr)), std::move(removeExpr)};
+    }
+
+    uassert(6440123,
+            str::stream() << "Unsupported window function in SBE window builder: " << opName,
+            opName == AccumulatorMin::kName || opName == AccumulatorMax::kName);
+
+    // $min and $max cannot take values out of the window, so there is no remove expression.
+    const bool isMin = opName == AccumulatorMin::kName;
+    auto arg = wrapMinMaxArg(state, std::move(argExpr));
+    if (auto collatorSlot = state.env->getSlotIfExists("collator"_sd); collatorSlot) {
+        return {makeFunction(isMin ? "collMin"_sd : "collMax"_sd,
+                             sbe::makeE<sbe::EVariable>(*collatorSlot),
+                             std::move(arg)),
+                nullptr};
+    }
+    return {makeFunction(isMin ? "min"_sd : "max"_sd, std::move(arg)), nullptr};
+}
+
+std::unique_ptr<sbe::EExpression> buildWindowFinalize(StageBuilderState& state,
+                                                      StringData opName,
+                                                      sbe::value::SlotId windowSlot) {
+    if (opName == AccumulatorSum::kName) {
+        return makeFunction("removableSumFinalize"_sd, makeVariable(windowSlot));
+    } else if (opName == AccumulatorAvg::kName) {
+        return makeFunction("removableAvgFinalize"_sd, makeVariable(windowSlot));
+    }
+
+    uassert(6440124,
+            str::stream() << "Unsupported window function in SBE window builder: " << opName,
+            opName == AccumulatorMin::kName || opName == AccumulatorMax::kName);
+    return makeFillEmptyNull(makeVariable(windowSlot));
+}
 }  // namespace mongo::stage_builder
@@ -71,4 +71,23 @@ std::pair<std::unique_ptr<sbe::EExpression>, EvalStage> buildFinalize(
     const sbe::value::SlotVector& aggSlots,
     EvalStage stage,
     PlanNodeId planNodeId);
+
+/**
+ * Translates the window function 'opName' of a $setWindowFields output into a pair of SBE
+ * aggregate expressions: the first one adds the value of 'argExpr' to the window and the second one
+ * removes it. The second expression is nullptr if the window function does not support removal, in
+ * which case the window has to be recomputed whenever a value leaves it.
+ */
+std::pair<std::unique_ptr<sbe::EExpression>, std::unique_ptr<sbe::EExpression>>
+buildWindowAccumulator(StageBuilderState& state,
+                       StringData opName,
+                       std::unique_ptr<sbe::EExpression> argExpr);
+
+/**
+ * Translates the finalization step of the window function 'opName' over the window state held in
+ * 'windowSlot'.
+ */
+std::unique_ptr<sbe::EExpression> buildWindowFinalize(StageBuilderState& state,
+                                                      StringData opName,
+                                                      sbe::value::SlotId windowSlot);
 }  // namespace mongo::stage_builder
@@ -76,6 +76,7 @@ StringData stageTypeToString(StageType stageType) {
         {STAGE_UNKNOWN, "UNKNOWN"_sd},
         {STAGE_UNPACK_TIMESERIES_BUCKET, "UNPACK_TIMESERIES_BUCKET"_sd},
         {STAGE_UPDATE, "UPDATE"_sd},
+        {STAGE_WINDOW, "WINDOW"_sd},
     };
     if (auto it = kStageTypesMap.find(stageType); it != kStageTypesMap.end()) {
         return it->second;
@@ -127,6 +127,7 @@ enum StageType {
     // Stages for DocumentSources.
     STAGE_GROUP,
     STAGE_EQ_LOOKUP,
+    STAGE_WINDOW,
     STAGE_SENTINEL,
 };
 
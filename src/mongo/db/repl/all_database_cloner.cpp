@@ -207,6 +207,7 @@ void AllDatabaseCloner::postStage() {
                                                                       getClient(),
                                                                       getStorageInterface(),
                                                                       getDBPool());
+            _currentDatabaseCloner->setCreateClientFn(getCreateClientFn());
         }
         auto dbStatus = _currentDatabaseCloner->run();
         if (dbStatus.isOK()) {
@@ -31,11 +31,15 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/base/string_data.h"
+#include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/db/catalog/clustered_collection_options_gen.h"
 #include "mongo/db/catalog/clustered_collection_util.h"
 #include "mongo/db/commands/list_collections_filter.h"
 #include "mongo/db/index_build_entry_helpers.h"
+#include "mongo/db/client.h"
 #include "mongo/db/index_builds_coordinator.h"
 #include "mongo/db/repl/collection_bulk_loader.h"
 #include "mongo/db/repl/collection_cloner.h"
@@ -46,6 +50,7 @@
 #include "mongo/rpc/get_status_from_command_result.h"
 
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
 namespace repl {
@@ -249,7 +254,15 @@ BaseCloner::AfterStageBehavior CollectionCloner::createCollectionStage() {
 }
 
 BaseCloner::AfterStageBehavior CollectionCloner::queryStage() {
-    runQuery();
+    if (!_rangesInitialized) {
+        initializeRanges();
+        _rangesInitialized = true;
+    }
+    if (_ranges.empty()) {
+        runQuery();
+    } else {
+        runRangeQueries();
+    }
     waitForDatabaseWorkToComplete();
     // We want to free the _collLoader regardless of whether the commit succeeds.
     std::unique_ptr<CollectionBulkLoader> loader = std::move(_collLoader);
@@ -346,17 +359,253 @@ void CollectionCloner::runQuery() {
         ReadConcernArgs::kLocal);
 }
 
-void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
+void CollectionCloner::initializeRanges() {
+    if (!getCreateClientFn() || collectionClonerRangeCursors <= 1) {
+        return;
+    }
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_stats.bytesToCopy < collectionClonerRangeMinBytes) {
+            return;
+        }
+    }
+
+    // Ranges of the _id index are fetched and inserted in any order, which capped collections do
+    // not allow. The boundaries of the ranges are ordered like the _id index only if it uses the
+    // simple collation.
+    if (_collectionOptions.capped || _collectionOptions.clusteredIndex || _idIndexSpec.isEmpty() ||
+        _idIndexSpec.hasField("collation")) {
+        return;
+    }
+
+    // Sample the collection for the boundaries of the ranges, which the sync source does using a
+    // random cursor rather than a collection scan. The sample is only used to balance the ranges,
+    // so it does not matter if the namespace no longer refers to the collection being cloned.
+    const size_t numRanges = collectionClonerRangeCursors;
+    const size_t sampleSize = numRanges * 16;
+    BSONObj res;
+    getClient()->runCommand(
+        _sourceNss.db().toString(),
+        BSON("aggregate" << _sourceNss.coll() << "pipeline"
+                         << BSON_ARRAY(BSON("$sample" << BSON("size" << (long long)sampleSize))
+                                       << BSON("$project" << BSON("_id" << 1)))
+                         << "cursor" << BSON("batchSize" << (long long)sampleSize) << "readConcern"
+                         << ReadConcernArgs::kLocal),
+        res,
+        QueryOption_SecondaryOk);
+    if (auto status = getStatusFromCommandResult(res); !status.isOK()) {
+        LOGV2_DEBUG(6440901,
+                    1,
+                    "Fetching the collection over a single cursor because it could not be sampled",
+                    logAttrs(_sourceNss),
+                    "status"_attr = status);
+        return;
+    }
+
+    std::vector<BSONElement> sampledIds;
+    for (auto&& doc : res["cursor"]["firstBatch"].Array()) {
+        if (auto id = doc["_id"]; !id.eoo()) {
+            sampledIds.push_back(id);
+        }
+    }
+    auto lessThan = SimpleBSONElementComparator::kInstance.makeLessThan();
+    std::sort(sampledIds.begin(), sampledIds.end(), lessThan);
+
+    // Take evenly spaced sampled _id values as the boundaries between the ranges.
+    std::vector<BSONObj> boundaries;
+    for (size_t i = 1; i < numRanges && !sampledIds.empty(); i++) {
+        auto& id = sampledIds[i * sampledIds.size() / numRanges];
+        if (boundaries.empty() || lessThan(boundaries.back().firstElement(), id)) {
+            boundaries.push_back(id.wrap("_id"));
+        }
+    }
+    if (boundaries.empty()) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (size_t i = 0; i <= boundaries.size(); i++) {
+        Range range;
+        range.min = i == 0 ? BSONObj() : boundaries[i - 1];
+        range.max = i == boundaries.size() ? BSONObj() : boundaries[i];
+        _stats.ranges.push_back({range.min, range.max});
+        _ranges.push_back(std::move(range));
+    }
+    LOGV2(6440902,
+          "Fetching collection over multiple cursors",
+          logAttrs(_sourceNss),
+          "ranges"_attr = _ranges.size(),
+          "bytesToCopy"_attr = _stats.bytesToCopy);
+}
+
+void CollectionCloner::runRangeQueries() {
+    std::vector<size_t> rangesToFetch;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (size_t i = 0; i < _ranges.size(); i++) {
+            if (!_ranges[i].done) {
+                rangesToFetch.push_back(i);
+            }
+        }
+    }
+    const size_t numThreads =
+        std::min(static_cast<size_t>(collectionClonerRangeCursors), rangesToFetch.size());
+
+    ThreadPool::Options options;
+    options.poolName = "CollectionCloner-" + _sourceNss.ns();
+    options.minThreads = 0;
+    options.maxThreads = numThreads;
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName);
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    // Each thread takes the next range to fetch until there are none left, or until any range
+    // fails. The first thread uses the client of this cloner, so that all ranges get fetched even
+    // if no additional connection to the sync source can be opened.
+    auto mutex = MONGO_MAKE_LATCH("CollectionCloner::runRangeQueries::mutex");
+    Status firstError = Status::OK();
+    size_t nextRange = 0;
+    auto fetchRanges = [&](DBClientConnection* client) {
+        while (true) {
+            size_t rangeIndex;
+            {
+                stdx::lock_guard<Latch> lk(mutex);
+                if (!firstError.isOK() || nextRange == rangesToFetch.size()) {
+                    return;
+                }
+                rangeIndex = rangesToFetch[nextRange++];
+            }
+            try {
+                runRangeQuery(rangeIndex, client);
+            } catch (const DBException& e) {
+                stdx::lock_guard<Latch> lk(mutex);
+                if (firstError.isOK()) {
+                    firstError = e.toStatus();
+                }
+                return;
+            }
+        }
+    };
+    for (size_t thread = 0; thread < numThreads; thread++) {
+        pool.schedule([&, thread](Status status) {
+            if (!status.isOK()) {
+                stdx::lock_guard<Latch> lk(mutex);
+                if (firstError.isOK()) {
+                    firstError = status;
+                }
+                return;
+            }
+            if (thread == 0) {
+                fetchRanges(getClient());
+                return;
+            }
+            std::shared_ptr<DBClientConnection> client;
+            try {
+                client = connectAdditionalClient();
+            } catch (const DBException& e) {
+                LOGV2_WARNING(6440903,
+                              "Failed to open an additional connection for fetching a collection "
+                              "over multiple cursors",
+                              logAttrs(_sourceNss),
+                              "error"_attr = e.toStatus());
+                return;
+            }
+            fetchRanges(client.get());
+        });
+    }
+    pool.shutdown();
+    pool.join();
+    uassertStatusOK(firstError);
+}
+
+void CollectionCloner::runRangeQuery(size_t rangeIndex, DBClientConnection* client) {
+    BSONObj min;
+    BSONObj max;
+    BSONObj lastReceivedId;
     {
-        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
-        if (!getSharedData()->getStatus(lk).isOK()) {
-            static constexpr char message[] =
-                "Collection cloning cancelled due to initial sync failure";
-            LOGV2(21136, message, "error"_attr = getSharedData()->getStatus(lk));
-            uasserted(ErrorCodes::CallbackCanceled,
-                      str::stream() << message << ": " << getSharedData()->getStatus(lk));
+        stdx::lock_guard<Latch> lk(_mutex);
+        const auto& range = _ranges[rangeIndex];
+        lastReceivedId = range.lastReceivedId;
+        // A range which failed part way resumes from the last document it received.
+        min = lastReceivedId.isEmpty() ? range.min : lastReceivedId;
+        max = range.max;
+    }
+
+    FindCommandRequest findCmd{_sourceDbAndUuid};
+    findCmd.setHint(BSON("_id" << 1));
+    if (!min.isEmpty()) {
+        findCmd.setMin(min);
+    }
+    if (!max.isEmpty()) {
+        findCmd.setMax(max);
+    }
+    findCmd.setNoCursorTimeout(true);
+    findCmd.setReadConcern(ReadConcernArgs::kLocal);
+    if (_collectionClonerBatchSize) {
+        findCmd.setBatchSize(_collectionClonerBatchSize);
+    }
+    auto cursor = client->find(std::move(findCmd),
+                               ReadPreferenceSetting{ReadPreference::SecondaryPreferred});
+
+    std::vector<BSONObj> docs;
+    while (cursor->more()) {
+        auto doc = cursor->nextSafe();
+        // The lower bound is inclusive, so skip the document the range resumes from.
+        if (!lastReceivedId.isEmpty() &&
+            doc["_id"].binaryEqualValues(lastReceivedId.firstElement())) {
+            lastReceivedId = BSONObj();
+            continue;
+        }
+        docs.push_back(std::move(doc));
+        if (cursor->moreInCurrentBatch()) {
+            continue;
         }
+
+        uassertInitialSyncNotFailed();
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _stats.receivedBatches++;
+            _stats.ranges[rangeIndex].receivedBatches++;
+            _stats.ranges[rangeIndex].documentsReceived += docs.size();
+            _ranges[rangeIndex].lastReceivedId = docs.back()["_id"].wrap();
+            std::move(docs.begin(), docs.end(), std::back_inserter(_documentsToInsert));
+        }
+        docs.clear();
+        scheduleInsertion();
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _ranges[rangeIndex].done = true;
+    _stats.ranges[rangeIndex].done = true;
+}
+
+void CollectionCloner::uassertInitialSyncNotFailed() {
+    stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+    if (!getSharedData()->getStatus(lk).isOK()) {
+        static constexpr char message[] =
+            "Collection cloning cancelled due to initial sync failure";
+        LOGV2(21136, message, "error"_attr = getSharedData()->getStatus(lk));
+        uasserted(ErrorCodes::CallbackCanceled,
+                  str::stream() << message << ": " << getSharedData()->getStatus(lk));
+    }
+}
+
+void CollectionCloner::scheduleInsertion() {
+    auto&& scheduleResult = _scheduleDbWorkFn(
+        [=](const executor::TaskExecutor::CallbackArgs& cbd) { insertDocumentsCallback(cbd); });
+
+    if (!scheduleResult.isOK()) {
+        Status newStatus = scheduleResult.getStatus().withContext(
+            str::stream() << "Error cloning collection '" << _sourceNss.ns() << "'");
+        // We must throw an exception to terminate query.
+        uassertStatusOK(newStatus);
     }
+}
+
+void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
+    uassertInitialSyncNotFailed();
 
     // If this is 'true', it means that something happened to our remote cursor for a reason other
     // than the collection being dropped, all while we were running a non-resumable (4.2) clone.
@@ -381,15 +630,7 @@ void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
     }
 
     // Schedule the next document batch insertion.
-    auto&& scheduleResult = _scheduleDbWorkFn(
-        [=](const executor::TaskExecutor::CallbackArgs& cbd) { insertDocumentsCallback(cbd); });
-
-    if (!scheduleResult.isOK()) {
-        Status newStatus = scheduleResult.getStatus().withContext(
-            str::stream() << "Error cloning collection '" << _sourceNss.ns() << "'");
-        // We must throw an exception to terminate query.
-        uassertStatusOK(newStatus);
-    }
+    scheduleInsertion();
 
     // Store the resume token for this batch.
     _resumeToken = iter.getPostBatchResumeToken();
@@ -503,6 +744,25 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
         }
     }
     builder->appendNumber("receivedBatches", static_cast<long long>(receivedBatches));
+    if (!ranges.empty()) {
+        BSONArrayBuilder rangesBuilder(builder->subarrayStart("ranges"));
+        for (auto&& range : ranges) {
+            BSONObjBuilder rangeBuilder(rangesBuilder.subobjStart());
+            range.append(&rangeBuilder);
+        }
+    }
+}
+
+void CollectionCloner::RangeStats::append(BSONObjBuilder* builder) const {
+    if (!min.isEmpty()) {
+        builder->appendAs(min.firstElement(), "min");
+    }
+    if (!max.isEmpty()) {
+        builder->appendAs(max.firstElement(), "max");
+    }
+    builder->appendNumber("documentsReceived", static_cast<long long>(documentsReceived));
+    builder->appendNumber("receivedBatches", static_cast<long long>(receivedBatches));
+    builder->append("done", done);
 }
 
 }  // namespace repl
@@ -48,6 +48,20 @@ const int kProgressMeterCheckInterval = 128;
 
 class CollectionCloner final : public InitialSyncBaseCloner {
 public:
+    /**
+     * Progress of a range of the _id index of a large collection, fetched over its own cursor.
+     */
+    struct RangeStats {
+        // The bounds of the range as {_id: <value>}. Empty for the start and the end of the index.
+        BSONObj min;
+        BSONObj max;
+        size_t documentsReceived{0};
+        size_t receivedBatches{0};
+        bool done{false};
+
+        void append(BSONObjBuilder* builder) const;
+    };
+
     struct Stats {
         static constexpr StringData kDocumentsToCopyFieldName = "documentsToCopy"_sd;
         static constexpr StringData kDocumentsCopiedFieldName = "documentsCopied"_sd;
@@ -63,6 +77,7 @@ public:
         long long bytesToCopy{0};
         long long avgObjSize{0};
         long long approxBytesCopied{0};
+        std::vector<RangeStats> ranges;
 
         std::string toString() const;
         BSONObj toBSON() const;
@@ -226,6 +241,36 @@ private:
      */
     void runQuery();
 
+    /**
+     * Splits the _id index of the collection into ranges to fetch concurrently, if the collection
+     * is large enough and its documents may be inserted in any order. Leaves _ranges empty
+     * otherwise.
+     */
+    void initializeRanges();
+
+    /**
+     * Fetches the ranges which are not done yet, each over a cursor of its own, on up to
+     * 'collectionClonerRangeCursors' connections to the sync source. Throws the first error any
+     * of the cursors ran into, after which the unfinished ranges resume from the last document
+     * they received.
+     */
+    void runRangeQueries();
+
+    /**
+     * Fetches the documents of the range at 'rangeIndex' in _ranges over 'client'.
+     */
+    void runRangeQuery(size_t rangeIndex, DBClientConnection* client);
+
+    /**
+     * Throws if the initial sync failed, so that the queries stop fetching documents.
+     */
+    void uassertInitialSyncNotFailed();
+
+    /**
+     * Schedules the insertion of the documents buffered in _documentsToInsert.
+     */
+    void scheduleInsertion();
+
     // All member variables are labeled with one of the following codes indicating the
     // synchronization rules for accessing them.
     //
@@ -269,6 +314,17 @@ private:
     // If true, it means we are starting a new query or resuming an interrupted one.
     bool _firstBatchOfQueryRound = true;  // (X)
 
+    // The ranges of the _id index fetched concurrently, if the collection is fetched in ranges.
+    struct Range {
+        BSONObj min;
+        BSONObj max;
+        // The _id of the last document received, as {_id: <value>}.
+        BSONObj lastReceivedId;
+        bool done = false;
+    };
+    std::vector<Range> _ranges;       // (M)
+    bool _rangesInitialized = false;  // (X)
+
     // Only set during non-resumable (4.2) queries.
     // Signifies that there were changes to the collection on the sync source that resulted in
     // our remote cursor getting killed.
@@ -31,13 +31,19 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/base/string_data.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/list_collections_filter.h"
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/database_cloner_common.h"
 #include "mongo/db/repl/database_cloner_gen.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
 namespace repl {
@@ -126,58 +132,130 @@ void DatabaseCloner::postStage() {
             _stats.collectionStats.emplace_back();
             _stats.collectionStats.back().ns = coll.first.ns();
         }
+        _collectionCloners.resize(_collections.size());
     }
-    for (const auto& coll : _collections) {
-        auto& sourceNss = coll.first;
-        auto& collectionOptions = coll.second;
-        {
-            stdx::lock_guard<Latch> lk(_mutex);
-            _currentCollectionCloner = std::make_unique<CollectionCloner>(sourceNss,
-                                                                          collectionOptions,
-                                                                          getSharedData(),
-                                                                          getSource(),
-                                                                          getClient(),
-                                                                          getStorageInterface(),
-                                                                          getDBPool());
-        }
-        auto collStatus = _currentCollectionCloner->run();
-        if (collStatus.isOK()) {
-            LOGV2_DEBUG(21148,
-                        1,
-                        "collection clone finished: {namespace}",
-                        "Collection clone finished",
-                        "namespace"_attr = sourceNss);
-        } else {
-            LOGV2_ERROR(21149,
-                        "collection clone for '{namespace}' failed due to {error}",
-                        "Collection clone failed",
-                        "namespace"_attr = sourceNss,
-                        "error"_attr = collStatus.toString());
-            setSyncFailedStatus({ErrorCodes::InitialSyncFailure,
-                                 collStatus
-                                     .withContext(str::stream() << "Error cloning collection '"
-                                                                << sourceNss.toString() << "'")
-                                     .toString()});
-        }
-        {
-            stdx::lock_guard<Latch> lk(_mutex);
-            _stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
-            _currentCollectionCloner = nullptr;
+
+    const size_t numThreads = getCreateClientFn()
+        ? std::min(static_cast<size_t>(initialSyncConcurrentCollectionClones), _collections.size())
+        : 1;
+    if (numThreads > 1) {
+        cloneCollectionsConcurrently(numThreads);
+        stdx::lock_guard<Latch> lk(_mutex);
+        // Abort the database cloner if any collection clone failed.
+        if (_stats.clonedCollections < _collections.size())
+            return;
+    } else {
+        for (size_t i = 0; i < _collections.size(); i++) {
             // Abort the database cloner if the collection clone failed.
-            if (!collStatus.isOK())
+            if (!cloneCollection(i, getClient()))
                 return;
-            _stats.clonedCollections++;
         }
     }
     stdx::lock_guard<Latch> lk(_mutex);
     _stats.end = getSharedData()->getClock()->now();
 }
 
+bool DatabaseCloner::cloneCollection(size_t index, DBClientConnection* client) {
+    auto& sourceNss = _collections[index].first;
+    auto& collectionOptions = _collections[index].second;
+    CollectionCloner* collectionCloner;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _collectionCloners[index] = std::make_unique<CollectionCloner>(sourceNss,
+                                                                       collectionOptions,
+                                                                       getSharedData(),
+                                                                       getSource(),
+                                                                       client,
+                                                                       getStorageInterface(),
+                                                                       getDBPool());
+        _collectionCloners[index]->setCreateClientFn(getCreateClientFn());
+        collectionCloner = _collectionCloners[index].get();
+    }
+    auto collStatus = collectionCloner->run();
+    if (collStatus.isOK()) {
+        LOGV2_DEBUG(21148,
+                    1,
+                    "collection clone finished: {namespace}",
+                    "Collection clone finished",
+                    "namespace"_attr = sourceNss);
+    } else {
+        LOGV2_ERROR(21149,
+                    "collection clone for '{namespace}' failed due to {error}",
+                    "Collection clone failed",
+                    "namespace"_attr = sourceNss,
+                    "error"_attr = collStatus.toString());
+        setSyncFailedStatus({ErrorCodes::InitialSyncFailure,
+                             collStatus
+                                 .withContext(str::stream() << "Error cloning collection '"
+                                                            << sourceNss.toString() << "'")
+                                 .toString()});
+    }
+    stdx::lock_guard<Latch> lk(_mutex);
+    _stats.collectionStats[index] = collectionCloner->getStats();
+    _collectionCloners[index] = nullptr;
+    if (!collStatus.isOK())
+        return false;
+    _stats.clonedCollections++;
+    return true;
+}
+
+void DatabaseCloner::cloneCollectionsConcurrently(size_t numThreads) {
+    ThreadPool::Options options;
+    options.poolName = "DatabaseCloner-" + _dbName;
+    options.minThreads = 0;
+    options.maxThreads = numThreads;
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName);
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    // Each thread takes the next collection to clone until there are none left. The first thread
+    // uses the client of this cloner, so the clone makes progress even if no additional
+    // connection to the sync source can be opened.
+    AtomicWord<size_t> nextCollection{0};
+    auto cloneCollections = [&](DBClientConnection* client) {
+        for (auto i = nextCollection.fetchAndAdd(1); i < _collections.size() && !mustExit();
+             i = nextCollection.fetchAndAdd(1)) {
+            if (!cloneCollection(i, client))
+                return;
+        }
+    };
+    for (size_t thread = 0; thread < numThreads; thread++) {
+        pool.schedule([&, thread](Status status) {
+            if (!status.isOK()) {
+                setSyncFailedStatus(status);
+                return;
+            }
+            if (thread == 0) {
+                cloneCollections(getClient());
+                return;
+            }
+            std::shared_ptr<DBClientConnection> client;
+            try {
+                client = connectAdditionalClient();
+            } catch (const DBException& e) {
+                LOGV2_WARNING(6440900,
+                              "Failed to open an additional connection for cloning collections "
+                              "concurrently",
+                              "db"_attr = _dbName,
+                              "error"_attr = e.toStatus());
+                return;
+            }
+            cloneCollections(client.get());
+        });
+    }
+    pool.shutdown();
+    pool.join();
+}
+
 DatabaseCloner::Stats DatabaseCloner::getStats() const {
     stdx::lock_guard<Latch> lk(_mutex);
     DatabaseCloner::Stats stats = _stats;
-    if (_currentCollectionCloner) {
-        stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
+    for (size_t i = 0; i < _collectionCloners.size(); i++) {
+        if (_collectionCloners[i]) {
+            stats.collectionStats[i] = _collectionCloners[i]->getStats();
+        }
     }
     return stats;
 }
@@ -93,6 +93,18 @@ private:
      */
     void postStage() final;
 
+    /**
+     * Runs the CollectionCloner for the collection at 'index' in _collections over 'client'.
+     * Returns false if the collection clone failed.
+     */
+    bool cloneCollection(size_t index, DBClientConnection* client);
+
+    /**
+     * Clones the collections of the database on 'numThreads' threads, each cloning one collection
+     * at a time over its own connection to the sync source.
+     */
+    void cloneCollectionsConcurrently(size_t numThreads);
+
     std::string describeForFuzzer(BaseClonerStage* stage) const final {
         return _dbName + " db: { " + stage->getName() + ": 1 } ";
     }
@@ -109,8 +121,9 @@ private:
     const std::string _dbName;                                                // (R)
     ClonerStage<DatabaseCloner> _listCollectionsStage;                        // (R)
     std::vector<std::pair<NamespaceString, CollectionOptions>> _collections;  // (X)
-    std::unique_ptr<CollectionCloner> _currentCollectionCloner;               // (MX)
-    Stats _stats;                                                             // (MX)
+    // The running CollectionCloners, indexed like _collections.
+    std::vector<std::unique_ptr<CollectionCloner>> _collectionCloners;  // (M)
+    Stats _stats;                                                       // (M)
 };
 
 }  // namespace repl
@@ -0,0 +1,938 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplicationInitialSync
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/file_copy_based_initial_syncer.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/client/dbclient_cursor.h"
+#include "mongo/db/catalog/catalog_control.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/pipeline/aggregate_command_gen.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/find_command_gen.h"
+#include "mongo/db/repl/initial_syncer_common_stats.h"
+#include "mongo/db/repl/initial_syncer_factory.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/repl/replication_auth.h"
+#include "mongo/db/repl/replication_consistency_markers.h"
+#include "mongo/db/repl/replication_process.h"
+#include "mongo/db/repl/replication_recovery.h"
+#include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/repl/sync_source_selector.h"
+#include "mongo/db/repl/tenant_migration_access_blocker_util.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/startup_recovery.h"
+#include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/idl/server_parameter.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/destructor_guard.h"
+#include "mongo/util/file.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace repl {
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+// The sync source times out the backup cursor after it has not been used for
+// 'cursorTimeoutMillis', which defaults to 10 minutes.
+const Minutes kBackupCursorKeepAliveInterval{1};
+
+// Parameters which determine where the storage engine places its files under the dbpath, and which
+// hence must have the same value on the sync source and on this node.
+const std::vector<std::string> kStorageLayoutParameters = {"storageGlobalParams.directoryperdb",
+                                                           "wiredTigerDirectoryForIndexes"};
+
+// Entries directly under the dbpath which belong to this node rather than to its storage engine,
+// and which are kept when the copied files are moved into place.
+const std::set<std::string> kEntriesToKeep = {
+    "mongod.lock",
+    "storage.bson",
+    "diagnostic.data",
+    FileCopyBasedInitialSyncer::kInitialSyncDir.toString()};
+
+// Collections of the local database whose documents describe this node rather than the data it
+// replicates: its last vote and its rollback ID. Their copies hold the sync source's documents,
+// which are replaced with this node's own once the storage engine runs on the copied files.
+const std::vector<NamespaceString> kNodeLocalNamespaces = {
+    NamespaceString::kLastVoteNamespace,
+    NamespaceString(NamespaceString::kLocalDb, "system.rollback.id")};
+
+fs::path initialSyncDir() {
+    return fs::path(storageGlobalParams.dbpath) /
+        FileCopyBasedInitialSyncer::kInitialSyncDir.toString();
+}
+
+fs::path moveFilesManifestPath() {
+    return initialSyncDir() / FileCopyBasedInitialSyncer::kMoveFilesManifest.toString();
+}
+
+/**
+ * Returns true if an error returned for opening a backup cursor means that the sync source cannot
+ * serve backup cursors at all, rather than that this attempt failed.
+ */
+bool isBackupCursorUnsupportedError(const Status& status) {
+    // 40324 is returned for unrecognized pipeline stages.
+    return status == ErrorCodes::CommandNotSupported || status.code() == 40324;
+}
+
+/**
+ * Writes the manifest listing the copied files. It is written to a temporary file which is renamed
+ * into place, so that it either lists all of the copied files or does not exist.
+ */
+void writeMoveFilesManifest(const std::set<std::string>& copiedFiles) {
+    std::string contents;
+    for (auto&& relativePath : copiedFiles) {
+        contents += relativePath;
+        contents += '\n';
+    }
+
+    auto tmpPath = moveFilesManifestPath();
+    tmpPath += ".tmp";
+    {
+        File file;
+        file.open(tmpPath.string().c_str());
+        uassert(ErrorCodes::FileOpenFailed,
+                str::stream() << "Failed to open " << tmpPath.string(),
+                file.is_open() && !file.bad());
+        file.truncate(0);
+        file.write(0, contents.data(), contents.size());
+        file.fsync();
+        uassert(6441019, str::stream() << "Failed to write " << tmpPath.string(), !file.bad());
+    }
+    fs::rename(tmpPath, moveFilesManifestPath());
+}
+
+std::set<std::string> readMoveFilesManifest() {
+    std::set<std::string> copiedFiles;
+    std::ifstream in(moveFilesManifestPath().string());
+    uassert(ErrorCodes::FileOpenFailed,
+            str::stream() << "Failed to open " << moveFilesManifestPath().string(),
+            in.is_open());
+    std::string relativePath;
+    while (std::getline(in, relativePath)) {
+        if (!relativePath.empty()) {
+            copiedFiles.insert(relativePath);
+        }
+    }
+    return copiedFiles;
+}
+
+/**
+ * Replaces the files of the storage engine in the dbpath with the files listed in the manifest.
+ * Must be called while no storage engine is running. Each step can be repeated after a crash:
+ * files which were already moved no longer exist in kInitialSyncDir, and the manifest is only
+ * removed once all files have been moved.
+ */
+void moveCopiedFilesIntoPlace() {
+    const fs::path dbpath(storageGlobalParams.dbpath);
+    const auto copiedFiles = readMoveFilesManifest();
+
+    std::vector<fs::path> filesToRemove;
+    for (fs::recursive_directory_iterator it(dbpath), end; it != end; ++it) {
+        if (it.depth() == 0 && kEntriesToKeep.count(it->path().filename().string())) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (fs::is_regular_file(it->status()) &&
+            !copiedFiles.count(it->path().lexically_relative(dbpath).generic_string())) {
+            filesToRemove.push_back(it->path());
+        }
+    }
+    for (auto&& path : filesToRemove) {
+        fs::remove(path);
+    }
+
+    for (auto&& relativePath : copiedFiles) {
+        const auto source = initialSyncDir() / relativePath;
+        if (!fs::exists(source)) {
+            continue;
+        }
+        const auto destination = dbpath / relativePath;
+        fs::create_directories(destination.parent_path());
+        fs::rename(source, destination);
+    }
+
+    fs::remove_all(initialSyncDir());
+}
+
+}  // namespace
+
+ServiceContext::ConstructorActionRegisterer fileCopyBasedInitialSyncerRegisterer(
+    "FileCopyBasedInitialSyncerRegisterer",
+    {"InitialSyncerFactoryRegisterer"} /* dependency list */,
+    [](ServiceContext* service) {
+        InitialSyncerFactory::get(service)->registerInitialSyncer(
+            FileCopyBasedInitialSyncer::kInitialSyncMethod.toString(),
+            [](InitialSyncerInterface::Options opts,
+               std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+               ThreadPool* writerPool,
+               StorageInterface* storage,
+               ReplicationProcess* replicationProcess,
+               const InitialSyncerInterface::OnCompletionFn& onCompletion) {
+                return std::make_shared<FileCopyBasedInitialSyncer>(
+                    opts,
+                    std::move(dataReplicatorExternalState),
+                    storage,
+                    replicationProcess,
+                    onCompletion);
+            },
+            &FileCopyBasedInitialSyncer::runCrashRecovery);
+    });
+
+FileCopyBasedInitialSyncer::FileCopyBasedInitialSyncer(
+    InitialSyncerInterface::Options opts,
+    std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+    StorageInterface* storage,
+    ReplicationProcess* replicationProcess,
+    const OnCompletionFn& onCompletion)
+    : _opts(opts),
+      _dataReplicatorExternalState(std::move(dataReplicatorExternalState)),
+      _storage(storage),
+      _replicationProcess(replicationProcess),
+      _onCompletion(onCompletion) {
+    uassert(ErrorCodes::BadValue, "invalid storage interface", _storage);
+    uassert(ErrorCodes::BadValue, "invalid replication process", _replicationProcess);
+    uassert(ErrorCodes::BadValue, "invalid getMyLastOptime function", _opts.getMyLastOptime);
+    uassert(ErrorCodes::BadValue, "invalid setMyLastOptime function", _opts.setMyLastOptime);
+    uassert(ErrorCodes::BadValue, "invalid resetOptimes function", _opts.resetOptimes);
+    uassert(ErrorCodes::BadValue, "invalid sync source selector", _opts.syncSourceSelector);
+    uassert(ErrorCodes::BadValue, "callback function cannot be null", _onCompletion);
+}
+
+FileCopyBasedInitialSyncer::~FileCopyBasedInitialSyncer() {
+    DESTRUCTOR_GUARD({
+        shutdown().transitional_ignore();
+        join();
+    });
+
+    // The completion function may release the last reference to this initial syncer on '_thread',
+    // which does not access it after the completion function returns.
+    if (_thread.joinable()) {
+        _thread.detach();
+    }
+}
+
+std::string FileCopyBasedInitialSyncer::getInitialSyncMethod() const {
+    return kInitialSyncMethod.toString();
+}
+
+Status FileCopyBasedInitialSyncer::startup(OperationContext* opCtx,
+                                           std::uint32_t maxAttempts) noexcept {
+    invariant(opCtx);
+    invariant(maxAttempts >= 1U);
+
+    stdx::lock_guard<Latch> lock(_mutex);
+    switch (_state) {
+        case State::kPreStart:
+            _state = State::kRunning;
+            break;
+        case State::kRunning:
+            return Status(ErrorCodes::IllegalOperation, "initial syncer already started");
+        case State::kShuttingDown:
+            return Status(ErrorCodes::ShutdownInProgress, "initial syncer shutting down");
+        case State::kComplete:
+            return Status(ErrorCodes::ShutdownInProgress, "initial syncer completed");
+    }
+
+    try {
+        _replicationProcess->getConsistencyMarkers()->setInitialSyncFlag(opCtx);
+        _replicationProcess->getConsistencyMarkers()->clearInitialSyncId(opCtx);
+
+        auto serviceCtx = opCtx->getServiceContext();
+        _storage->setInitialDataTimestamp(serviceCtx,
+                                          Timestamp::kAllowUnstableCheckpointsSentinel);
+        _storage->setStableTimestamp(serviceCtx, Timestamp::min());
+
+        _stats.initialSyncStart = Date_t::now();
+        _stats.maxFailedInitialSyncAttempts = maxAttempts;
+        _stats.failedInitialSyncAttempts = 0;
+
+        _thread = stdx::thread([this, maxAttempts] { _run(maxAttempts); });
+    } catch (const DBException& e) {
+        _state = State::kComplete;
+        return e.toStatus();
+    }
+    return Status::OK();
+}
+
+Status FileCopyBasedInitialSyncer::shutdown() {
+    stdx::lock_guard<Latch> lock(_mutex);
+    switch (_state) {
+        case State::kPreStart:
+            // Transition directly from PreStart to Complete if not started yet.
+            _state = State::kComplete;
+            return Status::OK();
+        case State::kRunning:
+            _state = State::kShuttingDown;
+            break;
+        case State::kShuttingDown:
+        case State::kComplete:
+            // Nothing to do if we are already in ShuttingDown or Complete state.
+            return Status::OK();
+    }
+
+    _cancelCurrentAttempt_inlock();
+    _stateCondition.notify_all();
+    return Status::OK();
+}
+
+void FileCopyBasedInitialSyncer::join() {
+    stdx::lock_guard<Latch> lock(_joinMutex);
+    if (_thread.joinable() && _thread.get_id() != stdx::this_thread::get_id()) {
+        _thread.join();
+    }
+}
+
+BSONObj FileCopyBasedInitialSyncer::getInitialSyncProgress() const {
+    stdx::lock_guard<Latch> lock(_mutex);
+    BSONObjBuilder bob;
+    bob.append("method", kInitialSyncMethod);
+    _stats.append(&bob);
+    return bob.obj();
+}
+
+void FileCopyBasedInitialSyncer::cancelCurrentAttempt() {
+    stdx::lock_guard<Latch> lock(_mutex);
+    if (_state == State::kRunning) {
+        LOGV2_DEBUG(6441012, 1, "Cancelling the current file copy based initial sync attempt");
+        _cancelCurrentAttempt_inlock();
+    }
+}
+
+void FileCopyBasedInitialSyncer::runCrashRecovery() {
+    if (!fs::exists(initialSyncDir())) {
+        return;
+    }
+
+    if (fs::exists(moveFilesManifestPath())) {
+        LOGV2(6441009,
+              "Moving the files copied by file copy based initial sync into the dbpath after an "
+              "unclean shutdown",
+              "directory"_attr = initialSyncDir().string());
+        moveCopiedFilesIntoPlace();
+        return;
+    }
+
+    LOGV2(6441010,
+          "Removing the files copied by an interrupted file copy based initial sync attempt",
+          "directory"_attr = initialSyncDir().string());
+    fs::remove_all(initialSyncDir());
+}
+
+void FileCopyBasedInitialSyncer::Stats::append(BSONObjBuilder* builder) const {
+    builder->appendNumber("failedInitialSyncAttempts",
+                          static_cast<long long>(failedInitialSyncAttempts));
+    builder->appendNumber("maxFailedInitialSyncAttempts",
+                          static_cast<long long>(maxFailedInitialSyncAttempts));
+
+    if (initialSyncStart != Date_t()) {
+        builder->appendDate("initialSyncStart", initialSyncStart);
+        auto elapsedDurationEnd = Date_t::now();
+        if (initialSyncEnd != Date_t()) {
+            builder->appendDate("initialSyncEnd", initialSyncEnd);
+            elapsedDurationEnd = initialSyncEnd;
+        }
+        long long elapsedMillis =
+            duration_cast<Milliseconds>(elapsedDurationEnd - initialSyncStart).count();
+        builder->appendNumber("totalInitialSyncElapsedMillis", elapsedMillis);
+    }
+
+    if (!syncSource.empty()) {
+        builder->append("syncSource", syncSource.toString());
+    }
+    if (backupId) {
+        backupId->appendToBuilder(builder, "backupId");
+    }
+    if (!checkpointTimestamp.isNull()) {
+        builder->append("checkpointTimestamp", checkpointTimestamp);
+    }
+    if (!lastExtendedTo.isNull()) {
+        builder->append("lastExtendedTo", lastExtendedTo);
+    }
+    builder->appendNumber("filesToCopy", static_cast<long long>(filesToCopy));
+    builder->appendNumber("filesCopied", static_cast<long long>(filesCopied));
+    builder->appendNumber("bytesToCopy", bytesToCopy);
+    builder->appendNumber("bytesCopied", bytesCopied);
+}
+
+void FileCopyBasedInitialSyncer::_run(std::uint32_t maxAttempts) {
+    Client::initThread("FileCopyBasedInitialSyncer");
+
+    StatusWith<OpTimeAndWallTime> result = Status(ErrorCodes::InternalError, "not run");
+    for (std::uint32_t attempt = 1;; ++attempt) {
+        LOGV2(6441011,
+              "Starting file copy based initial sync attempt",
+              "attempt"_attr = attempt,
+              "maxAttempts"_attr = maxAttempts);
+        result = _runAttempt();
+        if (result.isOK()) {
+            break;
+        }
+
+        initial_sync_common_stats::initialSyncFailedAttempts.increment();
+        stdx::unique_lock<Latch> lock(_mutex);
+        ++_stats.failedInitialSyncAttempts;
+        LOGV2_ERROR(6441000,
+                    "File copy based initial sync attempt failed",
+                    "attempt"_attr = attempt,
+                    "maxAttempts"_attr = maxAttempts,
+                    "error"_attr = redact(result.getStatus()));
+
+        // InvalidSyncSource makes the replication coordinator fall back to logical initial sync,
+        // so there is no point in retrying.
+        if (result == ErrorCodes::InvalidSyncSource || attempt >= maxAttempts) {
+            break;
+        }
+        _stateCondition.wait_for(lock, _opts.initialSyncRetryWait.toSystemDuration(), [&] {
+            return _state != State::kRunning;
+        });
+        if (_state != State::kRunning) {
+            break;
+        }
+    }
+
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        if (_state != State::kRunning) {
+            result = Status(ErrorCodes::CallbackCanceled, "initial syncer shut down");
+        }
+        _stats.initialSyncEnd = Date_t::now();
+        _state = State::kComplete;
+        _stateCondition.notify_all();
+    }
+
+    if (result.isOK()) {
+        initial_sync_common_stats::initialSyncCompletes.increment();
+    } else if (result != ErrorCodes::CallbackCanceled) {
+        initial_sync_common_stats::initialSyncFailures.increment();
+    }
+    _onCompletion(result);
+}
+
+StatusWith<OpTimeAndWallTime> FileCopyBasedInitialSyncer::_runAttempt() {
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        _attemptCanceled = false;
+        _stats.syncSource = HostAndPort();
+        _stats.backupId = boost::none;
+        _stats.checkpointTimestamp = Timestamp();
+        _stats.lastExtendedTo = Timestamp();
+        _stats.filesToCopy = 0;
+        _stats.filesCopied = 0;
+        _stats.bytesToCopy = 0;
+        _stats.bytesCopied = 0;
+    }
+    _sourceDbpath.clear();
+    _backupId = boost::none;
+    _backupCursorId = 0;
+    _copiedFiles.clear();
+    _opts.resetOptimes();
+
+    auto opCtx = cc().makeOperationContext();
+    try {
+        // Remove the files copied by the previous attempt.
+        fs::remove_all(initialSyncDir());
+
+        _connectToSyncSource(opCtx.get());
+        auto files = _openBackupCursor();
+        ScopeGuard killBackupCursorGuard([&] { _killBackupCursor(); });
+        for (auto&& file : files) {
+            _copyFile(file);
+        }
+        _extendBackupCursor();
+        killBackupCursorGuard.dismiss();
+        _killBackupCursor();
+
+        {
+            stdx::lock_guard<Latch> lock(_mutex);
+            _client.reset();
+        }
+        _checkForCancellation();
+    } catch (const DBException& e) {
+        stdx::lock_guard<Latch> lock(_mutex);
+        _client.reset();
+        return e.toStatus();
+    } catch (const fs::filesystem_error& e) {
+        stdx::lock_guard<Latch> lock(_mutex);
+        _client.reset();
+        return Status(ErrorCodes::FileStreamFailed, e.what());
+    }
+
+    // Once the storage engine starts to switch to the copied files, the data of this node is
+    // replaced and the attempt can no longer be abandoned and retried. A failure to finish moving
+    // the files into place is recovered from by runCrashRecovery() when the node restarts.
+    try {
+        const auto nodeLocalDocuments = _readNodeLocalDocuments(opCtx.get());
+        _switchToCopiedFiles(opCtx.get());
+        _restoreNodeLocalDocuments(opCtx.get(), nodeLocalDocuments);
+        return _finishInitialSync(opCtx.get());
+    } catch (const DBException& e) {
+        fassertFailedWithStatus(6441013, e.toStatus());
+    } catch (const fs::filesystem_error& e) {
+        fassertFailedWithStatus(6441013, Status(ErrorCodes::FileStreamFailed, e.what()));
+    }
+}
+
+void FileCopyBasedInitialSyncer::_cancelCurrentAttempt_inlock() {
+    _attemptCanceled = true;
+    if (_client) {
+        _client->shutdownAndDisallowReconnect();
+    }
+}
+
+void FileCopyBasedInitialSyncer::_checkForCancellation() {
+    stdx::lock_guard<Latch> lock(_mutex);
+    uassert(ErrorCodes::CallbackCanceled,
+            "Initial sync attempt canceled",
+            !_attemptCanceled && _state == State::kRunning);
+}
+
+void FileCopyBasedInitialSyncer::_connectToSyncSource(OperationContext* opCtx) {
+    uassert(ErrorCodes::InvalidSyncSource,
+            str::stream() << "File copy based initial sync requires the wiredTiger storage engine, "
+                             "but this node uses "
+                          << storageGlobalParams.engine,
+            storageGlobalParams.engine == "wiredTiger");
+
+    auto syncSource = _opts.syncSourceSelector->chooseNewSyncSource(OpTime());
+    uassert(ErrorCodes::InitialSyncOplogSourceMissing,
+            "No valid sync source available",
+            !syncSource.empty());
+
+    std::shared_ptr<DBClientConnection> client;
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        uassert(ErrorCodes::CallbackCanceled,
+                "Initial sync attempt canceled",
+                !_attemptCanceled && _state == State::kRunning);
+        client = std::make_shared<DBClientConnection>(true /* autoReconnect */);
+        _client = client;
+        _stats.syncSource = syncSource;
+    }
+
+    uassertStatusOK(client->connect(syncSource, "FileCopyBasedInitialSyncer"_sd, boost::none));
+    uassertStatusOKWithContext(replAuthenticate(client.get()),
+                               str::stream() << "Failed to authenticate to " << syncSource);
+
+    // The copied files are only usable if the storage engine lays them out the same way on this
+    // node.
+    BSONObjBuilder getParameterCmd;
+    getParameterCmd.append("getParameter", 1);
+    for (auto&& name : kStorageLayoutParameters) {
+        getParameterCmd.append(name, 1);
+    }
+    BSONObj reply;
+    client->runCommand("admin", getParameterCmd.obj(), reply);
+    uassertStatusOK(getStatusFromCommandResult(reply));
+
+    for (auto&& name : kStorageLayoutParameters) {
+        BSONObjBuilder localValue;
+        if (auto param = ServerParameterSet::getNodeParameterSet()->getIfExists(name)) {
+            param->append(opCtx, localValue, name);
+        }
+        const auto local = localValue.obj();
+        uassert(ErrorCodes::InvalidSyncSource,
+                str::stream() << "The sync source " << syncSource << " uses " << reply[name]
+                              << ", but this node uses " << local[name],
+                local[name].woCompare(reply[name]) == 0);
+    }
+}
+
+BSONObj FileCopyBasedInitialSyncer::_runCursorCommand(StringData dbName, const BSONObj& cmdObj) {
+    BSONObj reply;
+    _client->runCommand(dbName.toString(), cmdObj, reply);
+    uassertStatusOK(getStatusFromCommandResult(reply));
+    return reply;
+}
+
+Timestamp FileCopyBasedInitialSyncer::_getSyncSourceLastAppliedTimestamp() {
+    FindCommandRequest findRequest{NamespaceString::kRsOplogNamespace};
+    findRequest.setSort(BSON("$natural" << -1));
+    findRequest.setProjection(BSON("ts" << 1));
+    auto lastEntry = _client->findOne(std::move(findRequest),
+                                      ReadPreferenceSetting{ReadPreference::SecondaryPreferred});
+    uassert(ErrorCodes::NoMatchingDocument,
+            "The oplog of the sync source is empty",
+            !lastEntry.isEmpty());
+    return lastEntry["ts"].timestamp();
+}
+
+std::vector<FileCopyBasedInitialSyncer::BackupFile>
+FileCopyBasedInitialSyncer::_openBackupCursor() {
+    BSONObj reply;
+    try {
+        reply = _runCursorCommand(
+            NamespaceString::kAdminDb,
+            BSON("aggregate" << 1 << "pipeline" << BSON_ARRAY(BSON("$backupCursor" << BSONObj()))
+                             << "cursor" << BSONObj()));
+    } catch (const DBException& e) {
+        if (isBackupCursorUnsupportedError(e.toStatus())) {
+            uasserted(ErrorCodes::InvalidSyncSource,
+                      str::stream() << "The sync source cannot open a backup cursor: "
+                                    << e.toStatus().reason());
+        }
+        throw;
+    }
+
+    auto response = uassertStatusOK(CursorResponse::parseFromBSON(reply));
+    const auto& firstBatch = response.getBatch();
+    uassert(6441001,
+            "The backup cursor did not return its metadata",
+            !firstBatch.empty() && firstBatch.front()["metadata"].type() == Object);
+
+    // The backup cursor is open from here on, so it must be killed if opening it fails later on.
+    _backupCursorId = response.getCursorId();
+    _backupCursorNss = response.getNSS();
+    _lastBackupCursorKeepAlive = Date_t::now();
+
+    const auto metadata = firstBatch.front()["metadata"].Obj();
+    _backupId = uassertStatusOK(UUID::parse(metadata["backupId"]));
+    _sourceDbpath = metadata["dbpath"].str();
+    const auto checkpointTimestamp = metadata["checkpointTimestamp"];
+    uassert(6441002,
+            "The backup cursor did not return the timestamp of its checkpoint",
+            checkpointTimestamp.type() == bsonTimestamp &&
+                !checkpointTimestamp.timestamp().isNull());
+
+    std::vector<BackupFile> files;
+    for (auto it = std::next(firstBatch.begin()); it != firstBatch.end(); ++it) {
+        files.push_back(_makeBackupFile(*it));
+    }
+
+    // The backup cursor returns an empty batch once it has returned all files, but stays open to
+    // pin the checkpoint until it is killed.
+    while (true) {
+        uassert(6441014,
+                "The backup cursor on the sync source was closed unexpectedly",
+                _backupCursorId != 0);
+        auto getMoreReply = _runCursorCommand(
+            _backupCursorNss.db(),
+            BSON("getMore" << _backupCursorId << "collection" << _backupCursorNss.coll()));
+        auto getMoreResponse = uassertStatusOK(CursorResponse::parseFromBSON(getMoreReply));
+        _backupCursorId = getMoreResponse.getCursorId();
+        if (getMoreResponse.getBatch().empty()) {
+            break;
+        }
+        for (auto&& doc : getMoreResponse.getBatch()) {
+            files.push_back(_makeBackupFile(doc));
+        }
+    }
+
+    long long bytesToCopy = 0;
+    for (auto&& file : files) {
+        bytesToCopy += file.fileSize;
+    }
+    LOGV2(6441003,
+          "Opened backup cursor on the sync source",
+          "backupId"_attr = *_backupId,
+          "checkpointTimestamp"_attr = checkpointTimestamp.timestamp(),
+          "numFiles"_attr = files.size(),
+          "bytesToCopy"_attr = bytesToCopy);
+
+    stdx::lock_guard<Latch> lock(_mutex);
+    _stats.backupId = _backupId;
+    _stats.checkpointTimestamp = checkpointTimestamp.timestamp();
+    _stats.filesToCopy = files.size();
+    _stats.bytesToCopy = bytesToCopy;
+    return files;
+}
+
+void FileCopyBasedInitialSyncer::_keepBackupCursorAlive() {
+    const auto now = Date_t::now();
+    if (now - _lastBackupCursorKeepAlive < kBackupCursorKeepAliveInterval) {
+        return;
+    }
+    _runCursorCommand(
+        _backupCursorNss.db(),
+        BSON("getMore" << _backupCursorId << "collection" << _backupCursorNss.coll()));
+    _lastBackupCursorKeepAlive = now;
+}
+
+void FileCopyBasedInitialSyncer::_extendBackupCursor() {
+    Timestamp copiedTo = [&] {
+        stdx::lock_guard<Latch> lock(_mutex);
+        return _stats.checkpointTimestamp;
+    }();
+
+    for (int cycle = 0;; ++cycle) {
+        const auto lastApplied = _getSyncSourceLastAppliedTimestamp();
+        const auto lagSecs = static_cast<long long>(lastApplied.getSecs()) -
+            static_cast<long long>(copiedTo.getSecs());
+        if (lagSecs <= fileBasedInitialSyncMaxLagSec) {
+            return;
+        }
+        if (cycle >= fileBasedInitialSyncMaxCyclesWithoutProgress) {
+            // The node catches up on the remaining lag with steady state replication.
+            LOGV2(6441016,
+                  "Not extending the backup cursor any further",
+                  "lagSecs"_attr = lagSecs,
+                  "cycles"_attr = cycle);
+            return;
+        }
+
+        LOGV2(6441006,
+              "Extending the backup cursor to copy the sync source's recent writes",
+              "backupId"_attr = *_backupId,
+              "extendTo"_attr = lastApplied,
+              "lagSecs"_attr = lagSecs);
+        AggregateCommandRequest aggRequest(
+            NamespaceString::makeCollectionlessAggregateNSS(NamespaceString::kAdminDb),
+            {BSON("$backupCursorExtend" << BSON("backupId" << *_backupId << "timestamp"
+                                                            << lastApplied))});
+        aggRequest.setMaxTimeMS(fileBasedInitialSyncExtendCursorTimeoutMS);
+
+        std::vector<BackupFile> files;
+        {
+            auto cursor = uassertStatusOK(
+                DBClientCursor::fromAggregationRequest(_client.get(),
+                                                       std::move(aggRequest),
+                                                       false /* secondaryOk */,
+                                                       false /* useExhaust */));
+            while (cursor->more()) {
+                files.push_back(_makeBackupFile(cursor->nextSafe()));
+            }
+        }
+        for (auto&& file : files) {
+            _copyFile(file);
+        }
+
+        copiedTo = lastApplied;
+        stdx::lock_guard<Latch> lock(_mutex);
+        _stats.lastExtendedTo = lastApplied;
+    }
+}
+
+void FileCopyBasedInitialSyncer::_killBackupCursor() {
+    if (!_backupCursorId) {
+        return;
+    }
+    try {
+        _runCursorCommand(_backupCursorNss.db(),
+                          BSON("killCursors" << _backupCursorNss.coll() << "cursors"
+                                             << BSON_ARRAY(_backupCursorId)));
+    } catch (const DBException& e) {
+        // The sync source times the backup cursor out if it cannot be killed.
+        LOGV2_WARNING(6441007,
+                      "Failed to kill the backup cursor on the sync source",
+                      "backupId"_attr = _backupId,
+                      "error"_attr = e.toStatus());
+    }
+    _backupCursorId = 0;
+}
+
+void FileCopyBasedInitialSyncer::_copyFile(const BackupFile& file) {
+    const auto destination = initialSyncDir() / file.relativePath;
+    fs::create_directories(destination.parent_path());
+
+    File out;
+    out.open(destination.string().c_str());
+    uassert(ErrorCodes::FileOpenFailed,
+            str::stream() << "Failed to open " << destination.string(),
+            out.is_open() && !out.bad());
+    out.truncate(0);
+
+    // The backup cursor is kept alive over the same connection in between batches, so the file is
+    // not fetched with an exhaust cursor.
+    AggregateCommandRequest aggRequest(
+        NamespaceString::makeCollectionlessAggregateNSS(NamespaceString::kAdminDb),
+        {BSON("$_backupFile" << BSON("backupId" << *_backupId << "file" << file.filename))});
+    auto cursor = uassertStatusOK(DBClientCursor::fromAggregationRequest(
+        _client.get(), std::move(aggRequest), false /* secondaryOk */, false /* useExhaust */));
+
+    long long byteOffset = 0;
+    while (cursor->more()) {
+        const auto doc = cursor->nextSafe();
+        uassert(6441005,
+                str::stream() << "Expected block of " << file.filename << " at offset "
+                              << byteOffset << ", but received " << doc["byteOffset"],
+                doc["byteOffset"].safeNumberLong() == byteOffset);
+        int length = 0;
+        const char* data = doc["data"].binData(length);
+        out.write(byteOffset, data, length);
+        uassert(6441018, str::stream() << "Failed to write " << destination.string(), !out.bad());
+        byteOffset += length;
+
+        {
+            stdx::lock_guard<Latch> lock(_mutex);
+            _stats.bytesCopied += length;
+        }
+        _checkForCancellation();
+        _keepBackupCursorAlive();
+    }
+    out.fsync();
+
+    _copiedFiles.insert(file.relativePath);
+    stdx::lock_guard<Latch> lock(_mutex);
+    ++_stats.filesCopied;
+}
+
+FileCopyBasedInitialSyncer::BackupFile FileCopyBasedInitialSyncer::_makeBackupFile(
+    const BSONObj& doc) {
+    BackupFile file;
+    file.filename = doc["filename"].str();
+    file.fileSize = doc["fileSize"].safeNumberLong();
+
+    const auto relativePath = fs::path(file.filename).lexically_relative(_sourceDbpath);
+    uassert(6441004,
+            str::stream() << "The backup file " << file.filename
+                          << " is not under the dbpath of the sync source " << _sourceDbpath,
+            !relativePath.empty() && *relativePath.begin() != "..");
+    file.relativePath = relativePath.generic_string();
+    return file;
+}
+
+void FileCopyBasedInitialSyncer::_switchToCopiedFiles(OperationContext* opCtx) {
+    writeMoveFilesManifest(_copiedFiles);
+    LOGV2(6441008,
+          "Restarting the storage engine on the files copied from the sync source",
+          "numFiles"_attr = _copiedFiles.size());
+
+    Lock::GlobalWrite lk(opCtx);
+    catalog::closeCatalog(opCtx);
+    auto lastShutdownState = reinitializeStorageEngine(
+        opCtx, StorageEngineInitFlags{}, [] { moveCopiedFilesIntoPlace(); });
+    startup_recovery::runStartupRecoveryInMode(
+        opCtx, lastShutdownState, startup_recovery::StartupRecoveryMode::kReplicaSetMember);
+    catalog::openCatalogAfterStorageChange(opCtx);
+    opCtx->getServiceContext()->getStorageEngine()->notifyStartupComplete();
+}
+
+FileCopyBasedInitialSyncer::NodeLocalDocuments FileCopyBasedInitialSyncer::_readNodeLocalDocuments(
+    OperationContext* opCtx) {
+    NodeLocalDocuments documents;
+    for (const auto& nss : kNodeLocalNamespaces) {
+        auto doc = _storage->findSingleton(opCtx, nss);
+        if (doc.isOK()) {
+            documents.emplace(nss, doc.getValue().getOwned());
+        } else if (doc != ErrorCodes::NamespaceNotFound && doc != ErrorCodes::CollectionIsEmpty) {
+            uassertStatusOK(doc);
+        }
+    }
+    return documents;
+}
+
+void FileCopyBasedInitialSyncer::_restoreNodeLocalDocuments(OperationContext* opCtx,
+                                                            const NodeLocalDocuments& documents) {
+    for (const auto& nss : kNodeLocalNamespaces) {
+        auto status = _storage->dropCollection(opCtx, nss);
+        if (status != ErrorCodes::NamespaceNotFound) {
+            uassertStatusOK(status);
+        }
+
+        // Without a document of its own, the node starts as it does when the collection does not
+        // exist, for instance without having voted yet.
+        auto it = documents.find(nss);
+        if (it == documents.end()) {
+            continue;
+        }
+        uassertStatusOK(_storage->createCollection(opCtx, nss, CollectionOptions()));
+        uassertStatusOK(_storage->insertDocument(
+            opCtx, nss, {it->second, Timestamp()}, OpTime::kUninitializedTerm));
+    }
+    LOGV2(6441017,
+          "Restored the documents of the local database which describe this node",
+          "namespaces"_attr = [&] {
+              BSONArrayBuilder namespaces;
+              for (const auto& [nss, doc] : documents) {
+                  namespaces.append(nss.ns());
+              }
+              return namespaces.arr();
+          }());
+}
+
+OpTimeAndWallTime FileCopyBasedInitialSyncer::_finishInitialSync(OperationContext* opCtx) {
+    auto consistencyMarkers = _replicationProcess->getConsistencyMarkers();
+
+    // The copied files carry the replication state of the sync source as of the checkpoint, from
+    // which replication recovery applies the copied oplog. Recovery is skipped while the initial
+    // sync flag is set, so the flag is only set again afterwards.
+    _replicationProcess->getReplicationRecovery()->recoverFromOplog(opCtx, boost::none);
+    consistencyMarkers->setInitialSyncFlag(opCtx);
+
+    // Reload the cached rollback ID from the restored document.
+    uassertStatusOK(_replicationProcess->refreshRollbackID(opCtx));
+    auto config = uassertStatusOK(_dataReplicatorExternalState->getCurrentConfig());
+    uassertStatusOK(_dataReplicatorExternalState->storeLocalConfigDocument(opCtx, config.toBSON()));
+
+    BSONObj lastEntry;
+    uassert(ErrorCodes::NoMatchingDocument,
+            "The copied oplog is empty",
+            writeConflictRetry(
+                opCtx, "readLastOplogEntry", NamespaceString::kRsOplogNamespace.ns(), [&] {
+                    return Helpers::getLast(
+                        opCtx, NamespaceString::kRsOplogNamespace.ns().c_str(), lastEntry);
+                }));
+    const auto lastApplied =
+        uassertStatusOK(OpTimeAndWallTime::parseOpTimeAndWallTimeFromOplogEntry(lastEntry));
+    const auto initialDataTimestamp = lastApplied.opTime.getTimestamp();
+
+    const bool orderedCommit = true;
+    _storage->oplogDiskLocRegister(opCtx, initialDataTimestamp, orderedCommit);
+    tenant_migration_access_blocker::recoverTenantMigrationAccessBlockers(opCtx);
+
+    // The copied initial sync id is the sync source's.
+    consistencyMarkers->clearInitialSyncId(opCtx);
+    consistencyMarkers->setInitialSyncIdIfNotSet(opCtx);
+
+    // We set the initial data timestamp before clearing the initial sync flag. See comments in
+    // clearInitialSyncFlag.
+    _storage->setInitialDataTimestamp(opCtx->getServiceContext(), initialDataTimestamp);
+    consistencyMarkers->clearInitialSyncFlag(opCtx);
+    _opts.setMyLastOptime(lastApplied);
+
+    LOGV2(6441015,
+          "File copy based initial sync done",
+          "lastApplied"_attr = lastApplied.opTime,
+          "bytesCopied"_attr = [&] {
+              stdx::lock_guard<Latch> lock(_mutex);
+              return _stats.bytesCopied;
+          }());
+    return lastApplied;
+}
+
+}  // namespace repl
+}  // namespace mongo
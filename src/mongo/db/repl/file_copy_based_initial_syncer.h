@@ -0,0 +1,276 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/client/dbclient_connection.h"
+#include "mongo/db/cursor_id.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/repl/data_replicator_external_state.h"
+#include "mongo/db/repl/initial_syncer_interface.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+namespace repl {
+
+class ReplicationProcess;
+class StorageInterface;
+
+/**
+ * Performs an initial sync by copying the data files of the sync source instead of cloning its
+ * documents and rebuilding its indexes.
+ *
+ * Each attempt opens a backup cursor on the sync source, which pins a checkpoint of its data files,
+ * and copies those files over the network with the $_backupFile aggregation stage into a directory
+ * under the dbpath. If the sync source has moved on from the checkpoint by more than
+ * 'fileBasedInitialSyncMaxLagSec', the backup cursor is extended so that the copied journal reaches
+ * a recent point of its oplog. The storage engine is then restarted on the copied files, and
+ * replication recovery applies the copied oplog from the checkpoint timestamp onwards, after which
+ * the node continues with steady state replication like after a logical initial sync. The copied
+ * local database keeps the sync source's oplog, but the documents which describe a node, such as
+ * its replica set config, last vote and rollback ID, are replaced with this node's own.
+ *
+ * The copied files only replace the files of this node once all of them have been copied. A crash
+ * while they are being moved into place is recovered from by runCrashRecovery() on the next
+ * startup.
+ */
+class FileCopyBasedInitialSyncer final : public InitialSyncerInterface {
+    FileCopyBasedInitialSyncer(const FileCopyBasedInitialSyncer&) = delete;
+    FileCopyBasedInitialSyncer& operator=(const FileCopyBasedInitialSyncer&) = delete;
+
+public:
+    static constexpr StringData kInitialSyncMethod = "fileCopyBased"_sd;
+
+    // The directory under the dbpath into which the files of the sync source are copied.
+    static constexpr StringData kInitialSyncDir = ".initialsync"_sd;
+
+    // The file in kInitialSyncDir listing the copied files. It is written once all files have been
+    // copied, and its presence means that they must be moved into the dbpath.
+    static constexpr StringData kMoveFilesManifest = "moveFilesManifest"_sd;
+
+    struct Stats {
+        std::uint32_t failedInitialSyncAttempts{0};
+        std::uint32_t maxFailedInitialSyncAttempts{0};
+        Date_t initialSyncStart;
+        Date_t initialSyncEnd;
+        HostAndPort syncSource;
+        boost::optional<UUID> backupId;
+        Timestamp checkpointTimestamp;
+        Timestamp lastExtendedTo;
+        std::size_t filesToCopy{0};
+        std::size_t filesCopied{0};
+        long long bytesToCopy{0};
+        long long bytesCopied{0};
+
+        void append(BSONObjBuilder* builder) const;
+    };
+
+    FileCopyBasedInitialSyncer(
+        InitialSyncerInterface::Options opts,
+        std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+        StorageInterface* storage,
+        ReplicationProcess* replicationProcess,
+        const OnCompletionFn& onCompletion);
+
+    ~FileCopyBasedInitialSyncer() final;
+
+    std::string getInitialSyncMethod() const final;
+
+    bool allowLocalDbAccess() const final {
+        return false;
+    }
+
+    Status startup(OperationContext* opCtx, std::uint32_t maxAttempts) noexcept final;
+
+    Status shutdown() final;
+
+    void join() final;
+
+    BSONObj getInitialSyncProgress() const final;
+
+    void cancelCurrentAttempt() final;
+
+    /**
+     * Finishes moving the copied files into the dbpath if the node crashed while doing so, and
+     * otherwise removes the files copied by an interrupted attempt. Must run before the storage
+     * engine is started.
+     */
+    static void runCrashRecovery();
+
+private:
+    enum class State { kPreStart, kRunning, kShuttingDown, kComplete };
+
+    // A file returned by the backup cursor.
+    struct BackupFile {
+        // The path of the file on the sync source, which identifies it to $_backupFile.
+        std::string filename;
+        // The path of the file relative to the dbpath.
+        std::string relativePath;
+        long long fileSize{0};
+    };
+
+    /**
+     * Runs initial sync attempts until one succeeds, 'maxAttempts' fail or the initial syncer is
+     * shut down, and then calls the completion function.
+     */
+    void _run(std::uint32_t maxAttempts);
+
+    StatusWith<OpTimeAndWallTime> _runAttempt();
+
+    /**
+     * Throws CallbackCanceled if the current attempt was canceled or the initial syncer is shutting
+     * down.
+     */
+    void _checkForCancellation();
+
+    void _cancelCurrentAttempt_inlock();
+
+    /**
+     * Connects to a sync source and checks that the files it stores can be used by this node.
+     * Throws InvalidSyncSource if they cannot, which makes the node fall back to logical initial
+     * sync.
+     */
+    void _connectToSyncSource(OperationContext* opCtx);
+
+    /**
+     * Runs a command which returns a cursor on the given database of the sync source, and returns
+     * the reply.
+     */
+    BSONObj _runCursorCommand(StringData dbName, const BSONObj& cmdObj);
+
+    Timestamp _getSyncSourceLastAppliedTimestamp();
+
+    /**
+     * Opens the backup cursor and returns the files of the checkpoint it pins.
+     */
+    std::vector<BackupFile> _openBackupCursor();
+
+    /**
+     * Runs getMore on the backup cursor if it has not been run recently, to keep the cursor from
+     * timing out.
+     */
+    void _keepBackupCursorAlive();
+
+    /**
+     * Extends the backup cursor while the sync source is ahead of the copied files by more than
+     * 'fileBasedInitialSyncMaxLagSec', and copies the journal files needed to recover to that
+     * point.
+     */
+    void _extendBackupCursor();
+
+    void _killBackupCursor();
+
+    /**
+     * Copies a file of the backup into kInitialSyncDir, replacing any earlier copy of it.
+     */
+    void _copyFile(const BackupFile& file);
+
+    BackupFile _makeBackupFile(const BSONObj& doc);
+
+    /**
+     * Restarts the storage engine on the copied files.
+     */
+    void _switchToCopiedFiles(OperationContext* opCtx);
+
+    // The documents of the collections of the local database which describe this node rather than
+    // the data it replicates, by namespace.
+    using NodeLocalDocuments = std::map<NamespaceString, BSONObj>;
+
+    NodeLocalDocuments _readNodeLocalDocuments(OperationContext* opCtx);
+
+    /**
+     * Replaces the documents copied from the sync source into the collections of the local database
+     * which describe a node with the ones this node had before the copy.
+     */
+    void _restoreNodeLocalDocuments(OperationContext* opCtx, const NodeLocalDocuments& documents);
+
+    /**
+     * Applies the copied oplog from the checkpoint timestamp onwards and marks initial sync as
+     * complete. Returns the last applied optime.
+     */
+    OpTimeAndWallTime _finishInitialSync(OperationContext* opCtx);
+
+    const InitialSyncerInterface::Options _opts;
+    const std::unique_ptr<DataReplicatorExternalState> _dataReplicatorExternalState;
+    StorageInterface* const _storage;
+    ReplicationProcess* const _replicationProcess;
+    const OnCompletionFn _onCompletion;
+
+    // Protects member data of this FileCopyBasedInitialSyncer which is accessed by callers of its
+    // public methods while the attempts run on '_thread'. The remaining members are only accessed
+    // by '_thread'.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("FileCopyBasedInitialSyncer::_mutex");
+
+    // Signalled when the initial syncer shuts down.
+    stdx::condition_variable _stateCondition;
+
+    State _state = State::kPreStart;  // (M)
+    bool _attemptCanceled = false;    // (M)
+    Stats _stats;                     // (M)
+
+    // The connection to the sync source of the current attempt, which is shut down to interrupt
+    // the attempt.
+    std::shared_ptr<DBClientConnection> _client;  // (M)
+
+    // The sync source's dbpath, relative to which the files of the backup are copied.
+    std::string _sourceDbpath;
+
+    boost::optional<UUID> _backupId;
+    CursorId _backupCursorId{0};
+    NamespaceString _backupCursorNss;
+    Date_t _lastBackupCursorKeepAlive;
+
+    // The files copied by the current attempt, relative to the dbpath.
+    std::set<std::string> _copiedFiles;
+
+    // Serializes joining '_thread'.
+    Mutex _joinMutex = MONGO_MAKE_LATCH("FileCopyBasedInitialSyncer::_joinMutex");
+    stdx::thread _thread;
+};
+
+}  // namespace repl
+}  // namespace mongo
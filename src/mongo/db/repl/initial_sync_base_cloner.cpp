@@ -32,6 +32,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/repl/initial_sync_base_cloner.h"
+#include "mongo/db/repl/replication_auth.h"
 #include "mongo/db/repl/replication_consistency_markers_gen.h"
 #include "mongo/db/repl/replication_consistency_markers_impl.h"
 #include "mongo/logv2/log.h"
@@ -54,6 +55,15 @@ InitialSyncBaseCloner::InitialSyncBaseCloner(StringData clonerName,
                                              ThreadPool* dbPool)
     : BaseCloner(clonerName, sharedData, source, client, storageInterface, dbPool) {}
 
+std::shared_ptr<DBClientConnection> InitialSyncBaseCloner::connectAdditionalClient() {
+    invariant(_createClientFn);
+    auto client = _createClientFn();
+    uassertStatusOK(client->connect(getSource(), StringData(), boost::none));
+    uassertStatusOK(replAuthenticate(client.get())
+                        .withContext(str::stream() << "Failed to authenticate to " << getSource()));
+    return client;
+}
+
 void InitialSyncBaseCloner::clearRetryingState() {
     _retryableOp = boost::none;
 }
@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+
 #include "mongo/base/checked_cast.h"
 #include "mongo/db/repl/base_cloner.h"
 #include "mongo/db/repl/initial_sync_shared_data.h"
@@ -46,11 +49,35 @@ public:
                           ThreadPool* dbPool);
     virtual ~InitialSyncBaseCloner() = default;
 
+    /**
+     * Type of function to create additional, not yet connected, clients to the sync source. The
+     * cloners use them to clone collections, and ranges of a collection, concurrently.
+     */
+    using CreateClientFn = std::function<std::shared_ptr<DBClientConnection>()>;
+
+    /**
+     * Allows this cloner to open additional connections to the sync source. Without it, the
+     * cloner clones over the single client it was constructed with.
+     */
+    void setCreateClientFn(CreateClientFn createClientFn) {
+        _createClientFn = std::move(createClientFn);
+    }
+
 protected:
     InitialSyncSharedData* getSharedData() const final {
         return checked_cast<InitialSyncSharedData*>(BaseCloner::getSharedData());
     }
 
+    const CreateClientFn& getCreateClientFn() const {
+        return _createClientFn;
+    }
+
+    /**
+     * Opens and authenticates an additional connection to the sync source. Must only be called if
+     * a CreateClientFn was set.
+     */
+    std::shared_ptr<DBClientConnection> connectAdditionalClient();
+
 private:
     /**
      * Make sure the initial sync ID on the sync source has not changed.  Throws an exception
@@ -102,6 +129,9 @@ private:
 
     // Operation that may currently be retrying.
     InitialSyncSharedData::RetryableOperation _retryableOp;
+
+    // Creates the additional connections to the sync source, if set.
+    CreateClientFn _createClientFn;
 };
 
 }  // namespace repl
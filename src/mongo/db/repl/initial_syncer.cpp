@@ -332,6 +332,27 @@ void InitialSyncer::cancelCurrentAttempt() {
     }
 }
 
+std::shared_ptr<DBClientConnection> InitialSyncer::_createCloneClient() {
+    std::shared_ptr<DBClientConnection> client = _createClientFn();
+    stdx::lock_guard<Latch> lock(_mutex);
+    if (_attemptCanceled || !_client) {
+        // The attempt is over, so the connection must not be used to clone any more data.
+        client->shutdownAndDisallowReconnect();
+    } else {
+        _cloneClients.push_back(client);
+    }
+    return client;
+}
+
+void InitialSyncer::_shutdownCloneClients_inlock() {
+    for (auto&& weakClient : _cloneClients) {
+        if (auto client = weakClient.lock()) {
+            client->shutdownAndDisallowReconnect();
+        }
+    }
+    _cloneClients.clear();
+}
+
 void InitialSyncer::_cancelRemainingWork_inlock() {
     _cancelHandle_inlock(_startInitialSyncAttemptHandle);
     _cancelHandle_inlock(_chooseSyncSourceHandle);
@@ -350,6 +371,7 @@ void InitialSyncer::_cancelRemainingWork_inlock() {
     if (_client) {
         _client->shutdownAndDisallowReconnect();
     }
+    _shutdownCloneClients_inlock();
     _shutdownComponent_inlock(_applier);
     _shutdownComponent_inlock(_fCVFetcher);
     _shutdownComponent_inlock(_lastOplogEntryFetcher);
@@ -1157,8 +1179,10 @@ void InitialSyncer::_fcvFetcherCallback(const StatusWith<Fetcher::QueryResponse>
                                                 _allowedOutageDuration,
                                                 getGlobalServiceContext()->getFastClockSource());
     _client = _createClientFn();
-    _initialSyncState = std::make_unique<InitialSyncState>(std::make_unique<AllDatabaseCloner>(
-        _sharedData.get(), _syncSource, _client.get(), _storage, _writerPool));
+    auto allDatabaseCloner = std::make_unique<AllDatabaseCloner>(
+        _sharedData.get(), _syncSource, _client.get(), _storage, _writerPool);
+    allDatabaseCloner->setCreateClientFn([this] { return _createCloneClient(); });
+    _initialSyncState = std::make_unique<InitialSyncState>(std::move(allDatabaseCloner));
 
     // Create oplog applier.
     auto consistencyMarkers = _replicationProcess->getConsistencyMarkers();
@@ -1358,6 +1382,7 @@ void InitialSyncer::_allDatabaseClonerCallback(
     }
 
     stdx::lock_guard<Latch> lock(_mutex);
+    _shutdownCloneClients_inlock();
     _client.reset();
     auto status = _checkForShutdownAndConvertStatus_inlock(databaseClonerFinishStatus,
                                                            "error cloning databases");
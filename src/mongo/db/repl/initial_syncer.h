@@ -34,6 +34,7 @@
 #include <functional>
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
@@ -267,6 +268,17 @@ private:
      */
     void _cancelRemainingWork_inlock();
 
+    /**
+     * Creates an additional connection to the sync source for the cloners to clone collections, or
+     * ranges of a collection, concurrently. The connection is shut down along with '_client'.
+     */
+    std::shared_ptr<DBClientConnection> _createCloneClient();
+
+    /**
+     * Shuts down the additional connections created by _createCloneClient().
+     */
+    void _shutdownCloneClients_inlock();
+
     /**
      * Returns true if the initial syncer has received a shutdown request (_state is ShuttingDown).
      */
@@ -681,6 +693,9 @@ private:
     OpTime _lastFetched;                                   // (MX)
     OpTimeAndWallTime _lastApplied;                        // (MX)
 
+    // Additional connections to the sync source used by the cloners of the current attempt.
+    std::vector<std::weak_ptr<DBClientConnection>> _cloneClients;  // (M)
+
     std::unique_ptr<OplogBuffer> _oplogBuffer;    // (M)
     std::unique_ptr<OplogApplier> _oplogApplier;  // (M)
 
@@ -654,17 +654,58 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromIndexScan(OperationCon
     _jumboChunkCloneState->clonerExec->detachFromOperationContext();
 }
 
+const std::vector<RecordId>& MigrationChunkClonerSourceLegacy::_getCloneLocsStreamBoundaries(
+    WithLock, int numStreams) {
+    if (!_numCloneStreams) {
+        // Each partition is contiguous so that every stream still reads the records in storage
+        // order.
+        if (numStreams > 1) {
+            _cloneLocsStreamBoundaries = partitionCloneLocs(_cloneLocs, numStreams);
+        }
+        _numCloneStreams = numStreams;
+    }
+
+    uassert(6441800,
+            str::stream() << "Cannot clone with " << numStreams << " streams after cloning with "
+                          << *_numCloneStreams,
+            *_numCloneStreams == numStreams);
+    return _cloneLocsStreamBoundaries;
+}
+
 void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneLocs(OperationContext* opCtx,
                                                                     const CollectionPtr& collection,
-                                                                    BSONArrayBuilder* arrBuilder) {
+                                                                    BSONArrayBuilder* arrBuilder,
+                                                                    int streamId,
+                                                                    int numStreams) {
     ElapsedTracker tracker(opCtx->getServiceContext()->getFastClockSource(),
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
     stdx::unique_lock<Latch> lk(_mutex);
-    auto iter = _cloneLocs.begin();
 
-    for (; iter != _cloneLocs.end(); ++iter) {
+    // The stream covers [streamBegin, streamEnd) of _cloneLocs. When there are fewer documents
+    // than streams, the first stream clones all of them.
+    auto streamBegin = _cloneLocs.begin();
+    boost::optional<RecordId> streamEnd;
+    const auto& boundaries = _getCloneLocsStreamBoundaries(lk, numStreams);
+    if (numStreams > 1) {
+        if (boundaries.empty()) {
+            if (streamId > 0) {
+                return;
+            }
+        } else {
+            if (streamId > 0) {
+                streamBegin = _cloneLocs.lower_bound(boundaries[streamId - 1]);
+            }
+            if (streamId < numStreams - 1) {
+                streamEnd = boundaries[streamId];
+            }
+        }
+    }
+
+    auto iter = streamBegin;
+
+    for (; iter != _cloneLocs.end() && (!streamEnd || *iter < *streamEnd); ++iter) {
         // We must always make progress in this method by at least one document because empty
         // return indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
@@ -682,6 +723,7 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneLocs(OperationCon
             if (arrBuilder->arrSize() &&
                 (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
 
+                lk.lock();
                 break;
             }
 
@@ -692,7 +734,7 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneLocs(OperationCon
         lk.lock();
     }
 
-    _cloneLocs.erase(_cloneLocs.begin(), iter);
+    _cloneLocs.erase(streamBegin, iter);
 }
 
 uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
@@ -706,12 +748,19 @@ uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
 
 Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                                                         const CollectionPtr& collection,
-                                                        BSONArrayBuilder* arrBuilder) {
+                                                        BSONArrayBuilder* arrBuilder,
+                                                        int streamId,
+                                                        int numStreams) {
     dassert(opCtx->lockState()->isCollectionLockedForMode(_args.getNss(), MODE_IS));
+    invariant(numStreams >= 1 && streamId >= 0 && streamId < numStreams);
 
     // If this chunk is too large to store records in _cloneLocs and the command args specify to
-    // attempt to move it, scan the collection directly.
+    // attempt to move it, scan the collection directly. The scan is only served on the first
+    // stream.
     if (_jumboChunkCloneState && _forceJumbo) {
+        if (streamId > 0) {
+            return Status::OK();
+        }
         try {
             _nextCloneBatchFromIndexScan(opCtx, collection, arrBuilder);
             return Status::OK();
@@ -720,7 +769,11 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
         }
     }
 
-    _nextCloneBatchFromCloneLocs(opCtx, collection, arrBuilder);
+    try {
+        _nextCloneBatchFromCloneLocs(opCtx, collection, arrBuilder, streamId, numStreams);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
     return Status::OK();
 }
 
@@ -1005,6 +1058,22 @@ long long xferMods(BSONArrayBuilder* arr,
     return totalSize;
 }
 
+std::vector<RecordId> partitionCloneLocs(const std::set<RecordId>& recordIds, int numPartitions) {
+    std::vector<RecordId> boundaries;
+    const auto partitionSize = recordIds.size() / numPartitions;
+    if (partitionSize == 0) {
+        return boundaries;
+    }
+
+    boundaries.reserve(numPartitions - 1);
+    auto it = recordIds.begin();
+    for (int i = 1; i < numPartitions; ++i) {
+        std::advance(it, partitionSize);
+        boundaries.push_back(*it);
+    }
+    return boundaries;
+}
+
 Status MigrationChunkClonerSourceLegacy::_checkRecipientCloningStatus(OperationContext* opCtx,
                                                                       Milliseconds maxTimeToWait) {
     const auto startTime = Date_t::now();
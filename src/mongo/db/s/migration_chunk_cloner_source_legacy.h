@@ -32,6 +32,7 @@
 #include <list>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/connection_string.h"
@@ -147,8 +148,13 @@ public:
 
     /**
      * Called by the recipient shard. Populates the passed BSONArrayBuilder with a set of documents,
-     * which are part of the initial clone sequence. Assumes that there is only one active caller
-     * to this method at a time (otherwise, it can cause corruption/crash).
+     * which are part of the initial clone sequence.
+     *
+     * The documents to clone can be split into 'numStreams' contiguous partitions of record ids, in
+     * which case only documents of the partition 'streamId' are returned. Each stream may be served
+     * concurrently with the others, but assumes that there is only one active caller for a given
+     * stream at a time (otherwise, it can cause corruption/crash). All callers of a migration must
+     * use the same number of streams.
      *
      * Returns OK status on success. If there were documents returned in the result argument, this
      * method should be called more times until the result is empty. If it returns failure, it is
@@ -162,7 +168,9 @@ public:
      */
     Status nextCloneBatch(OperationContext* opCtx,
                           const CollectionPtr& collection,
-                          BSONArrayBuilder* arrBuilder);
+                          BSONArrayBuilder* arrBuilder,
+                          int streamId = 0,
+                          int numStreams = 1);
 
     /**
      * Called by the recipient shard. Transfers the accummulated local mods from source to
@@ -233,7 +241,16 @@ private:
 
     void _nextCloneBatchFromCloneLocs(OperationContext* opCtx,
                                       const CollectionPtr& collection,
-                                      BSONArrayBuilder* arrBuilder);
+                                      BSONArrayBuilder* arrBuilder,
+                                      int streamId,
+                                      int numStreams);
+
+    /**
+     * Returns the first record id of each of the 'numStreams' partitions of _cloneLocs, after the
+     * first one. The number of streams is recorded by the first call, including one made with a
+     * single stream, and every later call must pass the same number.
+     */
+    const std::vector<RecordId>& _getCloneLocsStreamBoundaries(WithLock, int numStreams);
 
     /**
      * Get the disklocs that belong to the chunk migrated and sort them in _cloneLocs (to avoid
@@ -334,6 +351,11 @@ private:
     // List of record ids that needs to be transferred (initial clone)
     std::set<RecordId> _cloneLocs;
 
+    // Number of concurrent clone streams the recipient fetches _cloneLocs with, set by its first
+    // fetch, and the first record id of each stream but the first one.
+    boost::optional<int> _numCloneStreams;
+    std::vector<RecordId> _cloneLocsStreamBoundaries;
+
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
     uint64_t _averageObjectSizeForCloneLocs{0};
@@ -395,4 +417,11 @@ long long xferMods(BSONArrayBuilder* arr,
                    long long initialSize,
                    std::function<bool(BSONObj, BSONObj*)> extractDocToAppendFn);
 
+/**
+ * Splits 'recordIds' into 'numPartitions' contiguous partitions of about the same size and returns
+ * the first record id of each partition but the first one. Returns an empty vector if there are
+ * fewer record ids than partitions.
+ */
+std::vector<RecordId> partitionCloneLocs(const std::set<RecordId>& recordIds, int numPartitions);
+
 }  // namespace mongo
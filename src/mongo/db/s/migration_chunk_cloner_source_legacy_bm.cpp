@@ -32,6 +32,9 @@
 #include <benchmark/benchmark.h>
 
 #include "migration_chunk_cloner_source_legacy.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
 namespace {
@@ -75,5 +78,73 @@ void BM_xferDeletes(benchmark::State& state) {
 
 BENCHMARK(BM_xferDeletes)->ArgsProduct({{0, 25, 50, 75, 100}, {1, 1024, 2048}});
 
+/**
+ * Drains a set of record ids the way the initial clone does, over 'numStreams' concurrent streams
+ * each serving its own partition of the set. Every record id is turned into a document appended to
+ * the batch of its stream, and batches are capped at 'kBatchSize' documents.
+ */
+void BM_cloneLocsStreams(benchmark::State& state) {
+    const int numStreams = state.range(0);
+    const int docSizeInBytes = state.range(1);
+    constexpr int kNumDocs = 100 * 1000;
+    constexpr int kBatchSize = 1000;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::set<RecordId> cloneLocs;
+        for (int i = 0; i < kNumDocs; i++) {
+            cloneLocs.insert(RecordId(i));
+        }
+        const auto doc = createCollectionDocumentWithSize(0, docSizeInBytes);
+        auto mutex = MONGO_MAKE_LATCH("BM_cloneLocsStreams::mutex");
+        state.ResumeTiming();
+
+        const auto boundaries = partitionCloneLocs(cloneLocs, numStreams);
+        auto drainStream = [&](int streamId) {
+            if (streamId > 0 && boundaries.empty()) {
+                return;
+            }
+            while (true) {
+                BSONArrayBuilder arrBuilder;
+                stdx::unique_lock<Latch> lk(mutex);
+                auto streamBegin = streamId > 0
+                    ? cloneLocs.lower_bound(boundaries[streamId - 1])
+                    : cloneLocs.begin();
+                auto iter = streamBegin;
+                for (; iter != cloneLocs.end() &&
+                     (streamId >= static_cast<int>(boundaries.size()) ||
+                      *iter < boundaries[streamId]) &&
+                     arrBuilder.arrSize() < kBatchSize;
+                     ++iter) {
+                    lk.unlock();
+                    arrBuilder.append(doc);
+                    lk.lock();
+                }
+                const bool done = iter == streamBegin;
+                cloneLocs.erase(streamBegin, iter);
+                lk.unlock();
+
+                benchmark::DoNotOptimize(arrBuilder.arr());
+                if (done) {
+                    return;
+                }
+            }
+        };
+
+        std::vector<stdx::thread> streams;
+        for (int streamId = 1; streamId < numStreams; streamId++) {
+            streams.emplace_back(drainStream, streamId);
+        }
+        drainStream(0);
+        for (auto& stream : streams) {
+            stream.join();
+        }
+        invariant(cloneLocs.empty());
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocs);
+}
+
+BENCHMARK(BM_cloneLocsStreams)->ArgsProduct({{1, 2, 4, 8}, {128, 1024}})->UseRealTime();
+
 }  // namespace
 }  // namespace mongo
@@ -164,6 +164,13 @@ public:
         const MigrationSessionId migrationSessionId(
             uassertStatusOK(MigrationSessionId::extractFromBSON(cmdObj)));
 
+        // A recipient cloning over several concurrent streams identifies the stream it fetches.
+        const int numStreams = cmdObj.hasField("numStreams") ? cmdObj["numStreams"].numberInt() : 1;
+        const int streamId = cmdObj.hasField("streamId") ? cmdObj["streamId"].numberInt() : 0;
+        uassert(6441801,
+                str::stream() << "Invalid clone stream " << streamId << " of " << numStreams,
+                numStreams >= 1 && streamId >= 0 && streamId < numStreams);
+
         boost::optional<BSONArrayBuilder> arrBuilder;
 
         // Try to maximize on the size of the buffer, which we are returning in order to have less
@@ -180,7 +187,7 @@ public:
             arrSizeAtPrevIteration = arrBuilder->arrSize();
 
             uassertStatusOK(autoCloner.getCloner()->nextCloneBatch(
-                opCtx, autoCloner.getColl(), arrBuilder.get_ptr()));
+                opCtx, autoCloner.getColl(), arrBuilder.get_ptr(), streamId, numStreams));
         }
 
         invariant(arrBuilder);
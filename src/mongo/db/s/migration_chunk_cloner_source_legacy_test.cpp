@@ -29,6 +29,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/remote_command_targeter_mock.h"
 #include "mongo/db/catalog/create_collection.h"
 #include "mongo/db/catalog_raii.h"
@@ -387,6 +388,108 @@ TEST_F(MigrationChunkClonerSourceLegacyTest, CorrectDocumentsFetched) {
 }
 
 
+TEST_F(MigrationChunkClonerSourceLegacyTest, CorrectDocumentsFetchedOverStreams) {
+    std::vector<BSONObj> contents;
+    for (int i = 100; i < 110; i++) {
+        contents.push_back(createCollectionDocument(i));
+    }
+
+    createShardedCollection(contents);
+
+    MigrationChunkClonerSourceLegacy cloner(
+        createMoveChunkRequest(ChunkRange(BSON("X" << 100), BSON("X" << 200))),
+        kShardKeyPattern,
+        kDonorConnStr,
+        kRecipientConnStr.getServers()[0]);
+
+    {
+        auto futureStartClone = launchAsync([&]() {
+            onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+        });
+
+        ASSERT_OK(cloner.startClone(operationContext(), UUID::gen(), _lsid, _txnNumber));
+        futureStartClone.default_timed_get();
+    }
+
+    // Each of the three streams returns its own contiguous part of the documents.
+    {
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_IS);
+
+        std::vector<BSONObj> fetched;
+        for (int streamId : {2, 0, 1}) {
+            BSONArrayBuilder arrBuilder;
+            ASSERT_OK(cloner.nextCloneBatch(
+                operationContext(), autoColl.getCollection(), &arrBuilder, streamId, 3));
+            ASSERT_GT(arrBuilder.arrSize(), 0);
+            for (const auto& elem : arrBuilder.arr()) {
+                fetched.push_back(elem.Obj().getOwned());
+            }
+
+            BSONArrayBuilder emptyArrBuilder;
+            ASSERT_OK(cloner.nextCloneBatch(
+                operationContext(), autoColl.getCollection(), &emptyArrBuilder, streamId, 3));
+            ASSERT_EQ(0, emptyArrBuilder.arrSize());
+        }
+
+        ASSERT_EQ(contents.size(), fetched.size());
+        std::sort(
+            fetched.begin(), fetched.end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+        for (size_t i = 0; i < contents.size(); i++) {
+            ASSERT_BSONOBJ_EQ(contents[i], fetched[i]);
+        }
+
+        // The streams must keep the number of streams they started with.
+        BSONArrayBuilder arrBuilder;
+        ASSERT_EQ(6441800,
+                  cloner.nextCloneBatch(
+                      operationContext(), autoColl.getCollection(), &arrBuilder, 0, 2).code());
+    }
+
+    cloner.cancelClone(operationContext());
+}
+
+TEST_F(MigrationChunkClonerSourceLegacyTest, CannotSwitchToStreamsAfterSingleStreamClone) {
+    std::vector<BSONObj> contents;
+    for (int i = 100; i < 110; i++) {
+        contents.push_back(createCollectionDocument(i));
+    }
+
+    createShardedCollection(contents);
+
+    MigrationChunkClonerSourceLegacy cloner(
+        createMoveChunkRequest(ChunkRange(BSON("X" << 100), BSON("X" << 200))),
+        kShardKeyPattern,
+        kDonorConnStr,
+        kRecipientConnStr.getServers()[0]);
+
+    {
+        auto futureStartClone = launchAsync([&]() {
+            onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+        });
+
+        ASSERT_OK(cloner.startClone(operationContext(), UUID::gen(), _lsid, _txnNumber));
+        futureStartClone.default_timed_get();
+    }
+
+    {
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_IS);
+
+        BSONArrayBuilder arrBuilder;
+        ASSERT_OK(cloner.nextCloneBatch(operationContext(), autoColl.getCollection(), &arrBuilder));
+        ASSERT_GT(arrBuilder.arrSize(), 0);
+
+        // The clone started over a single stream, so it cannot be split into several afterwards.
+        BSONArrayBuilder streamArrBuilder;
+        ASSERT_EQ(6441800,
+                  cloner
+                      .nextCloneBatch(
+                          operationContext(), autoColl.getCollection(), &streamArrBuilder, 1, 3)
+                      .code());
+    }
+
+    cloner.cancelClone(operationContext());
+}
+
 TEST_F(MigrationChunkClonerSourceLegacyTest, RemoveDuplicateDocuments) {
     const std::vector<BSONObj> contents = {createCollectionDocument(100),
                                            createCollectionDocument(199)};
@@ -248,11 +248,19 @@ bool opReplicatedEnough(OperationContext* opCtx,
  * Create the migration clone request BSON object to send to the source shard.
  *
  * 'sessionId' unique identifier for this migration.
+ * 'streamId' the stream to fetch documents for, out of 'numStreams' concurrent clone streams.
  */
-BSONObj createMigrateCloneRequest(const NamespaceString& nss, const MigrationSessionId& sessionId) {
+BSONObj createMigrateCloneRequest(const NamespaceString& nss,
+                                  const MigrationSessionId& sessionId,
+                                  int streamId,
+                                  int numStreams) {
     BSONObjBuilder builder;
     builder.append("_migrateClone", nss.ns());
     sessionId.append(&builder);
+    if (numStreams > 1) {
+        builder.append("streamId", streamId);
+        builder.append("numStreams", numStreams);
+    }
     return builder.obj();
 }
 
@@ -591,6 +599,65 @@ repl::OpTime MigrationDestinationManager::fetchAndApplyBatch(
     return lastOpApplied;
 }
 
+repl::OpTime MigrationDestinationManager::fetchAndApplyBatchesOverStreams(
+    OperationContext* opCtx,
+    int numStreams,
+    std::function<bool(OperationContext*, BSONObj)> applyBatchFn,
+    std::function<std::function<bool(OperationContext*, BSONObj*)>(int)> makeFetchBatchFn) {
+    auto executor = Grid::get(opCtx->getServiceContext())->getExecutorPool()->getFixedExecutor();
+
+    // A failed stream cancels the others.
+    CancellationSource streamsCancelSource(opCtx->getCancellationToken());
+
+    auto streamsMutex = MONGO_MAKE_LATCH("MigrationDestinationManager::streamsMutex");
+    Status streamsStatus = Status::OK();
+    repl::OpTime lastOpApplied;
+
+    std::vector<stdx::thread> streamThreads;
+    for (int streamId = 0; streamId < numStreams; ++streamId) {
+        streamThreads.emplace_back([&, streamId] {
+            Client::initThread(std::string(str::stream() << "migrateCloneStream-" << streamId),
+                               opCtx->getServiceContext(),
+                               nullptr);
+            auto client = Client::getCurrent();
+            {
+                stdx::lock_guard lk(*client);
+                client->setSystemOperationKillableByStepdown(lk);
+            }
+            auto streamOpCtx = CancelableOperationContext(
+                cc().makeOperationContext(), streamsCancelSource.token(), executor);
+
+            try {
+                auto streamLastOpApplied = fetchAndApplyBatch(
+                    streamOpCtx.get(), applyBatchFn, makeFetchBatchFn(streamId));
+
+                stdx::lock_guard<Latch> lk(streamsMutex);
+                lastOpApplied = std::max(lastOpApplied, streamLastOpApplied);
+            } catch (const DBException& ex) {
+                {
+                    stdx::lock_guard<Latch> lk(streamsMutex);
+                    if (streamsStatus.isOK()) {
+                        streamsStatus = ex.toStatus();
+                    }
+                }
+                LOGV2(6441802,
+                      "Clone stream failed",
+                      "streamId"_attr = streamId,
+                      "error"_attr = redact(ex.toStatus()));
+                streamsCancelSource.cancel();
+            }
+        });
+    }
+
+    for (auto& thread : streamThreads) {
+        thread.join();
+    }
+
+    uassertStatusOK(streamsStatus);
+    opCtx->checkForInterrupt();
+    return lastOpApplied;
+}
+
 Status MigrationDestinationManager::abort(const MigrationSessionId& sessionId) {
     stdx::lock_guard<Latch> sl(_mutex);
 
@@ -1267,13 +1334,17 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx,
 
             _sessionMigration->start(opCtx->getServiceContext());
 
-            const BSONObj migrateCloneRequest = createMigrateCloneRequest(_nss, *_sessionId);
+            const int numStreams = migrateCloneStreams.load();
 
             _chunkMarkedPending = true;  // no lock needed, only the migrate thread looks.
 
             auto assertNotAborted = [&](OperationContext* opCtx) {
                 opCtx->checkForInterrupt();
-                outerOpCtx->checkForInterrupt();
+                // Clone streams run on their own clients and must not use the outer operation. Its
+                // interruption reaches them through the cancellation token of their operation.
+                if (numStreams == 1) {
+                    outerOpCtx->checkForInterrupt();
+                }
                 uassert(50748, "Migration aborted while copying documents", getState() != ABORT);
             };
 
@@ -1324,7 +1395,7 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx,
                         _clonedBytes += batchClonedBytes;
                     }
                     if (_writeConcern.needToWaitForOtherNodes()) {
-                        runWithoutSession(outerOpCtx, [&] {
+                        auto waitForSecondaries = [&] {
                             repl::ReplicationCoordinator::StatusAndDuration replStatus =
                                 repl::ReplicationCoordinator::get(opCtx)->awaitReplication(
                                     opCtx,
@@ -1338,7 +1409,14 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx,
                             } else {
                                 uassertStatusOK(replStatus.status);
                             }
-                        });
+                        };
+
+                        // The clone streams run with the outer session already checked in.
+                        if (numStreams == 1) {
+                            runWithoutSession(outerOpCtx, waitForSecondaries);
+                        } else {
+                            waitForSecondaries();
+                        }
                     }
 
                     sleepmillis(migrateCloneInsertionBatchDelayMS.load());
@@ -1346,26 +1424,39 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx,
                 return true;
             };
 
-            auto fetchBatchFn = [&](OperationContext* opCtx, BSONObj* nextBatch) {
-                auto commandResponse = uassertStatusOKWithContext(
-                    fromShard->runCommand(opCtx,
-                                          ReadPreferenceSetting(ReadPreference::PrimaryOnly),
-                                          "admin",
-                                          migrateCloneRequest,
-                                          Shard::RetryPolicy::kNoRetry),
-                    "_migrateClone failed: ");
-
-                uassertStatusOKWithContext(
-                    Shard::CommandResponse::getEffectiveStatus(commandResponse),
-                    "_migrateClone failed: ");
-
-                *nextBatch = commandResponse.response;
-                return nextBatch->getField("objects").Obj().isEmpty();
+            auto makeFetchBatchFn = [&](int streamId) {
+                return [&, migrateCloneRequest = createMigrateCloneRequest(
+                               _nss, *_sessionId, streamId, numStreams)](OperationContext* opCtx,
+                                                                         BSONObj* nextBatch) {
+                    auto commandResponse = uassertStatusOKWithContext(
+                        fromShard->runCommand(opCtx,
+                                              ReadPreferenceSetting(ReadPreference::PrimaryOnly),
+                                              "admin",
+                                              migrateCloneRequest,
+                                              Shard::RetryPolicy::kNoRetry),
+                        "_migrateClone failed: ");
+
+                    uassertStatusOKWithContext(
+                        Shard::CommandResponse::getEffectiveStatus(commandResponse),
+                        "_migrateClone failed: ");
+
+                    *nextBatch = commandResponse.response;
+                    return nextBatch->getField("objects").Obj().isEmpty();
+                };
             };
 
             // If running on a replicated system, we'll need to flush the docs we cloned to the
             // secondaries
-            lastOpApplied = fetchAndApplyBatch(opCtx, insertBatchFn, fetchBatchFn);
+            if (numStreams == 1) {
+                lastOpApplied = fetchAndApplyBatch(opCtx, insertBatchFn, makeFetchBatchFn(0));
+            } else {
+                // Check the outer session in for the whole clone rather than around each wait
+                // for secondaries, so that the stream threads never touch the outer operation.
+                runWithoutSession(outerOpCtx, [&] {
+                    lastOpApplied = fetchAndApplyBatchesOverStreams(
+                        opCtx, numStreams, insertBatchFn, makeFetchBatchFn);
+                });
+            }
 
             timing->done(4);
             migrateThreadHangAtStep4.pauseWhileSet();
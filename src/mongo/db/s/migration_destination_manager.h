@@ -139,6 +139,18 @@ public:
         std::function<bool(OperationContext*, BSONObj)> applyBatchFn,
         std::function<bool(OperationContext*, BSONObj*)> fetchBatchFn);
 
+    /**
+     * Clones documents from a donor shard over 'numStreams' concurrent streams. Each stream fetches
+     * the batches returned by the function 'makeFetchBatchFn' creates for its stream id, and
+     * applies them on its own thread, as fetchAndApplyBatch does. The first error of any stream
+     * cancels the others and is rethrown once all of them have stopped.
+     */
+    static repl::OpTime fetchAndApplyBatchesOverStreams(
+        OperationContext* opCtx,
+        int numStreams,
+        std::function<bool(OperationContext*, BSONObj)> applyBatchFn,
+        std::function<std::function<bool(OperationContext*, BSONObj*)>(int)> makeFetchBatchFn);
+
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
      * specified session id. If the migration is already aborted, does nothing.
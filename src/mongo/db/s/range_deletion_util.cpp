@@ -54,8 +54,10 @@
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/wait_for_majority_service.h"
 #include "mongo/db/s/migration_util.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/remove_saver.h"
@@ -113,18 +115,48 @@ bool collectionUuidHasChanged(const NamespaceString& nss,
     return false;
 }
 
+struct DeleteBatchResult {
+    // Number of documents deleted by the batch.
+    int numDeleted = 0;
+
+    // Whether the scan reached the end of the range.
+    bool rangeExhausted = false;
+
+    // Whether the batch was cut short because the majority of the replica set lags too far behind.
+    bool throttled = false;
+};
+
+/**
+ * Returns how far the majority commit point trails the writes applied on this node.
+ */
+Milliseconds getMajorityReplicationLag(OperationContext* opCtx) {
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    const auto lastApplied = replCoord->getMyLastAppliedOpTimeAndWallTime();
+    const auto lastCommitted = replCoord->getLastCommittedOpTimeAndWallTime();
+    if (lastCommitted.wallTime >= lastApplied.wallTime) {
+        return Milliseconds(0);
+    }
+    return lastApplied.wallTime - lastCommitted.wallTime;
+}
+
+bool replicationLagExceedsLimit(OperationContext* opCtx) {
+    const auto maxLagSecs = rangeDeleterMaxReplicationLagSecs.load();
+    return maxLagSecs > 0 && getMajorityReplicationLag(opCtx) > Seconds(maxLagSecs);
+}
+
 /**
  * Performs the deletion of up to numDocsToRemovePerBatch entries within the range in progress. Must
  * be called under the collection lock.
  *
- * Returns the number of documents deleted, 0 if done with the range, or bad status if deleting
- * the range failed.
+ * If rangeDeleterMaxReplicationLagSecs is set, the replication lag is checked every
+ * rangeDeleterDocsPerReplicationLagCheck deleted documents, and the batch stops early and is
+ * reported as throttled once the majority commit point lags further behind than that.
  */
-StatusWith<int> deleteNextBatch(OperationContext* opCtx,
-                                const CollectionPtr& collection,
-                                BSONObj const& keyPattern,
-                                ChunkRange const& range,
-                                int numDocsToRemovePerBatch) {
+StatusWith<DeleteBatchResult> deleteNextBatch(OperationContext* opCtx,
+                                              const CollectionPtr& collection,
+                                              BSONObj const& keyPattern,
+                                              ChunkRange const& range,
+                                              int numDocsToRemovePerBatch) {
     invariant(collection);
 
     auto const nss = collection->ns();
@@ -170,6 +202,8 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
             std::make_unique<RemoveSaver>("moveChunk", nss.ns(), "cleaning");
     }
 
+    // Each document is deleted in its own write unit of work, as each delete is logged with its
+    // own oplog timestamp.
     auto exec =
         InternalPlanner::deleteWithShardKeyIndexScan(opCtx,
                                                      &collection,
@@ -186,7 +220,7 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
         hangBeforeDoingDeletion.pauseWhileSet(opCtx);
     }
 
-    int numDeleted = 0;
+    DeleteBatchResult result;
     do {
         BSONObj deletedObj;
 
@@ -218,15 +252,23 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
         }
 
         if (state == PlanExecutor::IS_EOF) {
+            result.rangeExhausted = true;
             break;
         }
 
         invariant(PlanExecutor::ADVANCED == state);
         ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(1);
+        ++result.numDeleted;
 
-    } while (++numDeleted < numDocsToRemovePerBatch);
+        if (result.numDeleted % rangeDeleterDocsPerReplicationLagCheck.load() == 0 &&
+            replicationLagExceedsLimit(opCtx)) {
+            result.throttled = true;
+            ShardingStatistics::get(opCtx).countRangeDeleterBatchesThrottled.addAndFetch(1);
+            break;
+        }
+    } while (result.numDeleted < numDocsToRemovePerBatch);
 
-    return numDeleted;
+    return result;
 }
 
 
@@ -310,22 +352,24 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
                            ensureRangeDeletionTaskStillExists(opCtx, *migrationId);
                        }
 
-                       AutoGetCollection collection(opCtx, nss, MODE_IX);
-
-                       // Ensure the collection exists and has not been dropped or dropped and
-                       // recreated.
-                       uassert(
-                           ErrorCodes::RangeDeletionAbandonedBecauseCollectionWithUUIDDoesNotExist,
-                           "Collection has been dropped since enqueuing this range "
-                           "deletion task. No need to delete documents.",
-                           !collectionUuidHasChanged(
-                               nss, collection.getCollection(), collectionUuid));
-
-                       auto numDeleted = uassertStatusOK(deleteNextBatch(opCtx,
-                                                                         collection.getCollection(),
-                                                                         keyPattern,
-                                                                         range,
-                                                                         numDocsToRemovePerBatch));
+                       auto result = [&] {
+                           AutoGetCollection collection(opCtx, nss, MODE_IX);
+
+                           // Ensure the collection exists and has not been dropped or dropped and
+                           // recreated.
+                           uassert(ErrorCodes::
+                                       RangeDeletionAbandonedBecauseCollectionWithUUIDDoesNotExist,
+                                   "Collection has been dropped since enqueuing this range "
+                                   "deletion task. No need to delete documents.",
+                                   !collectionUuidHasChanged(
+                                       nss, collection.getCollection(), collectionUuid));
+
+                           return uassertStatusOK(deleteNextBatch(opCtx,
+                                                                  collection.getCollection(),
+                                                                  keyPattern,
+                                                                  range,
+                                                                  numDocsToRemovePerBatch));
+                       }();
 
                        LOGV2_DEBUG(
                            23769,
@@ -333,26 +377,39 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
                            "Deleted {numDeleted} documents in pass in namespace {namespace} with "
                            "UUID  {collectionUUID} for range {range}",
                            "Deleted documents in pass",
-                           "numDeleted"_attr = numDeleted,
+                           "numDeleted"_attr = result.numDeleted,
                            "namespace"_attr = nss.ns(),
                            "collectionUUID"_attr = collectionUuid,
-                           "range"_attr = range.toString());
+                           "range"_attr = range.toString(),
+                           "throttled"_attr = result.throttled);
+
+                       if (result.throttled) {
+                           // Let the majority of the replica set catch up with the deletes before
+                           // issuing more of them. No locks are held while waiting.
+                           repl::ReplClientInfo::forClient(opCtx->getClient())
+                               .setLastOpToSystemLastOpTime(opCtx);
+                           WaitForMajorityService::get(opCtx->getServiceContext())
+                               .waitUntilMajority(
+                                   repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
+                                   CancellationToken::uncancelable())
+                               .get(opCtx);
+                       }
 
-                       return numDeleted;
+                       return result;
                    },
                    nss);
            })
-        .until([=](StatusWith<int> swNumDeleted) {
+        .until([=](const StatusWith<DeleteBatchResult>& swResult) {
             // Continue iterating until there are no more documents to delete, retrying on
             // any error that doesn't indicate that this node is stepping down.
-            return (swNumDeleted.isOK() && swNumDeleted.getValue() < numDocsToRemovePerBatch) ||
-                swNumDeleted.getStatus() ==
+            return (swResult.isOK() && swResult.getValue().rangeExhausted) ||
+                swResult.getStatus() ==
                 ErrorCodes::RangeDeletionAbandonedBecauseCollectionWithUUIDDoesNotExist ||
-                swNumDeleted.getStatus() ==
+                swResult.getStatus() ==
                 ErrorCodes::RangeDeletionAbandonedBecauseTaskDocumentDoesNotExist ||
-                swNumDeleted.getStatus().code() == ErrorCodes::KeyPatternShorterThanBound ||
-                ErrorCodes::isShutdownError(swNumDeleted.getStatus()) ||
-                ErrorCodes::isNotPrimaryError(swNumDeleted.getStatus());
+                swResult.getStatus().code() == ErrorCodes::KeyPatternShorterThanBound ||
+                ErrorCodes::isShutdownError(swResult.getStatus()) ||
+                ErrorCodes::isNotPrimaryError(swResult.getStatus());
         })
         .withDelayBetweenIterations(delayBetweenBatches)
         .on(executor, CancellationToken::uncancelable())
@@ -69,6 +69,10 @@ struct ShardingStatistics {
     // node by the rangeDeleter.
     AtomicWord<long long> countDocsDeletedOnDonor{0};
 
+    // Cumulative, always-increasing counter of how many range deletion batches were cut short on
+    // the donor node because the majority of the replica set lagged too far behind.
+    AtomicWord<long long> countRangeDeleterBatchesThrottled{0};
+
     // Cumulative, always-increasing counter of how many chunks this node started to receive
     // (whether the receiving succeeded or not)
     AtomicWord<long long> countRecipientMoveChunkStarted{0};
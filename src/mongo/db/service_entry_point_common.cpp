@@ -85,6 +85,7 @@
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/stats/api_version_metrics.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/operation_phase_timeline.h"
 #include "mongo/db/stats/resource_consumption_metrics.h"
 #include "mongo/db/stats/server_read_concern_metrics.h"
 #include "mongo/db/stats/top.h"
@@ -110,6 +111,7 @@
 #include "mongo/util/duration.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/future_util.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -650,10 +652,19 @@ public:
     Future<void> run() {
         return makeReadyFutureWith([&] {
                    _prologue();
+                   _executionTimer.emplace(_ecd->getExecutionContext()->getOpCtx(),
+                                           OperationPhase::kExecution);
+                   SamplingProfiler::ScopedCommandTag profilerTag(
+                       _ecd->getExecutionContext()->getCommand()->getName().c_str());
                    return _runImpl();
                })
-            .then([this] { return _epilogue(); })
+            .then([this] {
+                _executionTimer.reset();
+                return _epilogue();
+            })
             .onCompletion([this](Status status) {
+                _executionTimer.reset();
+
                 // Failure to run a command is either indicated by throwing an exception or
                 // adding a non-okay field to the replyBuilder.
                 if (status.isOK() && _ok)
@@ -694,6 +705,9 @@ protected:
 
     // If the command resolved successfully.
     bool _ok = false;
+
+    // Times the execution of the command, from the end of the prologue until its result is known.
+    boost::optional<OperationPhaseTimer> _executionTimer;
 };
 
 class RunCommandAndWaitForWriteConcern final : public RunCommandImpl {
@@ -1266,6 +1280,8 @@ void ExecCommandDatabase::_initiateCommand() {
     auto command = _execContext->getCommand();
     auto replyBuilder = _execContext->getReplyBuilder();
 
+    OperationPhaseTimer phaseTimer(opCtx, OperationPhase::kCommandDispatch);
+
     // Record the time here to ensure that maxTimeMS, if set by the command, considers the time
     // spent before the deadline is set on `opCtx`.
     const auto startedCommandExecAt = opCtx->getServiceContext()->getFastClockSource()->now();
@@ -1780,6 +1796,7 @@ void curOpCommandSetup(OperationContext* opCtx, const OpMsgRequest& request) {
 }
 
 Future<void> parseCommand(std::shared_ptr<HandleRequest::ExecutionContext> execContext) try {
+    OperationPhaseTimer phaseTimer(execContext->getOpCtx(), OperationPhase::kCommandDispatch);
     const auto& msg = execContext->getMessage();
     auto opMsgReq = rpc::opMsgRequestFromAnyProtocol(msg);
     if (msg.operation() == dbQuery) {
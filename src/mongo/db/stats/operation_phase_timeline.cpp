@@ -0,0 +1,201 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_phase_timeline.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/operation_phase_timeline_gen.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+const auto getOperationPhaseTimeline =
+    OperationContext::declareDecoration<OperationPhaseTimeline>();
+
+const auto getOperationPhaseHistograms =
+    ServiceContext::declareDecoration<OperationPhaseHistograms>();
+
+}  // namespace
+
+StringData toString(OperationPhase phase) {
+    switch (phase) {
+        case OperationPhase::kCommandDispatch:
+            return "commandDispatch"_sd;
+        case OperationPhase::kTicketAcquisition:
+            return "ticketAcquisition"_sd;
+        case OperationPhase::kLockAcquisition:
+            return "lockAcquisition"_sd;
+        case OperationPhase::kPlanCacheLookup:
+            return "planCacheLookup"_sd;
+        case OperationPhase::kPlanning:
+            return "planning"_sd;
+        case OperationPhase::kExecution:
+            return "execution"_sd;
+        case OperationPhase::kYield:
+            return "yield"_sd;
+        case OperationPhase::kNetworkSend:
+            return "networkSend"_sd;
+        case OperationPhase::kNumPhases:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+OperationPhaseTimeline& OperationPhaseTimeline::get(OperationContext* opCtx) {
+    return getOperationPhaseTimeline(opCtx);
+}
+
+void OperationPhaseTimeline::record(OperationPhase phase,
+                                    TickSource::Tick start,
+                                    TickSource::Tick end) {
+    if (_numEvents == 0) {
+        _firstTick = start;
+    }
+    _events[_numEvents % kMaxEvents] = {phase, start, end};
+    ++_numEvents;
+
+    const auto index = static_cast<size_t>(phase);
+    _totalTicks[index] += end - start;
+    ++_counts[index];
+}
+
+BSONObj OperationPhaseTimeline::toBSON(TickSource* tickSource) const {
+    BSONObjBuilder phasesBuilder;
+    for (size_t i = 0; i < kNumPhases; ++i) {
+        if (_counts[i] == 0) {
+            continue;
+        }
+        BSONObjBuilder phaseBuilder(
+            phasesBuilder.subobjStart(toString(static_cast<OperationPhase>(i))));
+        phaseBuilder.append("count", _counts[i]);
+        phaseBuilder.append("totalMicros",
+                            durationCount<Microseconds>(
+                                tickSource->ticksTo<Microseconds>(_totalTicks[i])));
+    }
+
+    // Report the retained events oldest first.
+    const size_t numRetained = std::min(_numEvents, kMaxEvents);
+    BSONArrayBuilder timelineBuilder(phasesBuilder.subarrayStart("timeline"));
+    for (size_t i = _numEvents - numRetained; i < _numEvents; ++i) {
+        const auto& event = _events[i % kMaxEvents];
+        BSONObjBuilder eventBuilder(timelineBuilder.subobjStart());
+        eventBuilder.append("phase", toString(event.phase));
+        eventBuilder.append("offsetMicros",
+                            durationCount<Microseconds>(
+                                tickSource->ticksTo<Microseconds>(event.start - _firstTick)));
+        eventBuilder.append("durationMicros",
+                            durationCount<Microseconds>(
+                                tickSource->ticksTo<Microseconds>(event.end - event.start)));
+    }
+    timelineBuilder.doneFast();
+
+    if (_numEvents > numRetained) {
+        phasesBuilder.append("droppedEvents", static_cast<long long>(_numEvents - numRetained));
+    }
+    return phasesBuilder.obj();
+}
+
+OperationPhaseHistograms& OperationPhaseHistograms::get(ServiceContext* svcCtx) {
+    return getOperationPhaseHistograms(svcCtx);
+}
+
+int OperationPhaseHistograms::_getBucket(int64_t micros) {
+    // Bucket 0 holds latencies below 1us, bucket i > 0 latencies in [2^(i-1), 2^i) microseconds.
+    if (micros <= 0) {
+        return 0;
+    }
+    return std::min(64 - countLeadingZeros64(static_cast<unsigned long long>(micros)),
+                    kNumBuckets - 1);
+}
+
+void OperationPhaseHistograms::record(OperationPhase phase, Microseconds duration) {
+    const auto micros = durationCount<Microseconds>(duration);
+    auto& data = _phases[static_cast<size_t>(phase)];
+    data.count.fetchAndAddRelaxed(1);
+    data.totalMicros.fetchAndAddRelaxed(micros);
+    data.buckets[_getBucket(micros)].fetchAndAddRelaxed(1);
+}
+
+void OperationPhaseHistograms::append(bool includeHistograms, BSONObjBuilder* builder) const {
+    for (size_t i = 0; i < _phases.size(); ++i) {
+        const auto& data = _phases[i];
+        BSONObjBuilder phaseBuilder(builder->subobjStart(toString(static_cast<OperationPhase>(i))));
+        phaseBuilder.append("count", data.count.loadRelaxed());
+        phaseBuilder.append("totalMicros", data.totalMicros.loadRelaxed());
+        if (!includeHistograms) {
+            continue;
+        }
+        BSONArrayBuilder histogramBuilder(phaseBuilder.subarrayStart("histogram"));
+        for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+            const auto count = data.buckets[bucket].loadRelaxed();
+            if (count == 0) {
+                continue;
+            }
+            BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+            entryBuilder.append("micros", bucket == 0 ? 0LL : 1LL << (bucket - 1));
+            entryBuilder.append("count", count);
+        }
+    }
+}
+
+OperationPhaseTimer::OperationPhaseTimer(OperationContext* opCtx, OperationPhase phase)
+    : OperationPhaseTimer(opCtx ? opCtx->getServiceContext() : nullptr, opCtx, phase) {}
+
+OperationPhaseTimer::OperationPhaseTimer(ServiceContext* svcCtx,
+                                         OperationContext* opCtx,
+                                         OperationPhase phase)
+    : _svcCtx(svcCtx), _opCtx(opCtx), _phase(phase) {
+    if (!_svcCtx || !gOperationPhaseTimelineEnabled.loadRelaxed()) {
+        return;
+    }
+    _tickSource = _svcCtx->getTickSource();
+    _start = _tickSource->getTicks();
+}
+
+void OperationPhaseTimer::stop() {
+    if (!_tickSource) {
+        return;
+    }
+    const auto end = _tickSource->getTicks();
+    if (_opCtx) {
+        OperationPhaseTimeline::get(_opCtx).record(_phase, _start, end);
+    }
+    OperationPhaseHistograms::get(_svcCtx).record(_phase,
+                                                  _tickSource->ticksTo<Microseconds>(end - _start));
+    _tickSource = nullptr;
+}
+
+}  // namespace mongo
@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * The phases of an operation's lifetime whose latency is tracked by the phase timeline. Phases may
+ * repeat (e.g. a lock acquisition after every yield) and may nest (e.g. lock acquisition during
+ * execution).
+ */
+enum class OperationPhase : uint8_t {
+    kCommandDispatch,
+    kTicketAcquisition,
+    kLockAcquisition,
+    kPlanCacheLookup,
+    kPlanning,
+    kExecution,
+    kYield,
+    kNetworkSend,
+    kNumPhases,
+};
+
+StringData toString(OperationPhase phase);
+
+/**
+ * Records the phases an operation went through, for reporting in the slow operation log and the
+ * profiler. Keeps per-phase totals for the whole operation and the most recent kMaxEvents phase
+ * intervals in a fixed-size ring buffer, so that recording never allocates.
+ *
+ * Only accessed by the thread running the operation.
+ */
+class OperationPhaseTimeline {
+public:
+    static constexpr size_t kMaxEvents = 16;
+
+    static OperationPhaseTimeline& get(OperationContext* opCtx);
+
+    /**
+     * Records that the operation spent the ticks in [start, end) in 'phase'.
+     */
+    void record(OperationPhase phase, TickSource::Tick start, TickSource::Tick end);
+
+    bool empty() const {
+        return _numEvents == 0;
+    }
+
+    /**
+     * Returns the per-phase totals and the timeline of the most recent phase intervals, with
+     * offsets relative to the start of the first recorded phase.
+     */
+    BSONObj toBSON(TickSource* tickSource) const;
+
+private:
+    struct Event {
+        OperationPhase phase;
+        TickSource::Tick start;
+        TickSource::Tick end;
+    };
+
+    static constexpr size_t kNumPhases = static_cast<size_t>(OperationPhase::kNumPhases);
+
+    std::array<Event, kMaxEvents> _events;
+    std::array<TickSource::Tick, kNumPhases> _totalTicks{};
+    std::array<int64_t, kNumPhases> _counts{};
+
+    // Total number of events recorded, including those overwritten in the ring buffer.
+    size_t _numEvents = 0;
+    TickSource::Tick _firstTick = 0;
+};
+
+/**
+ * Server-wide latency histograms of every operation phase, reported in serverStatus. Buckets are
+ * powers of two in microseconds. Thread-safe.
+ */
+class OperationPhaseHistograms {
+public:
+    static constexpr int kNumBuckets = 41;
+
+    static OperationPhaseHistograms& get(ServiceContext* svcCtx);
+
+    void record(OperationPhase phase, Microseconds duration);
+
+    /**
+     * Appends the count and total latency of every phase, and the non-empty buckets of their
+     * histograms if 'includeHistograms' is set.
+     */
+    void append(bool includeHistograms, BSONObjBuilder* builder) const;
+
+private:
+    struct PhaseData {
+        AtomicWord<long long> count;
+        AtomicWord<long long> totalMicros;
+        std::array<AtomicWord<long long>, kNumBuckets> buckets;
+    };
+
+    static int _getBucket(int64_t micros);
+
+    std::array<PhaseData, static_cast<size_t>(OperationPhase::kNumPhases)> _phases;
+};
+
+/**
+ * Times an operation phase using the service context's tick source, from construction until
+ * stop() or destruction. The interval is recorded in the operation's timeline if there is one, and
+ * in the server-wide phase histograms. Does nothing if phase tracing is disabled.
+ */
+class OperationPhaseTimer {
+    OperationPhaseTimer(const OperationPhaseTimer&) = delete;
+    OperationPhaseTimer& operator=(const OperationPhaseTimer&) = delete;
+
+public:
+    OperationPhaseTimer(OperationContext* opCtx, OperationPhase phase);
+    OperationPhaseTimer(ServiceContext* svcCtx, OperationContext* opCtx, OperationPhase phase);
+
+    ~OperationPhaseTimer() {
+        stop();
+    }
+
+    void stop();
+
+private:
+    ServiceContext* const _svcCtx;
+    OperationContext* const _opCtx;
+    const OperationPhase _phase;
+    TickSource* _tickSource = nullptr;
+    TickSource::Tick _start = 0;
+};
+
+}  // namespace mongo
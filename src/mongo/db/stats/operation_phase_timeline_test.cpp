@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_phase_timeline.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/tick_source_mock.h"
+
+namespace mongo {
+namespace {
+
+TEST(OperationPhaseTimeline, RecordsTotalsAndOffsets) {
+    TickSourceMock<Microseconds> tickSource;
+    OperationPhaseTimeline timeline;
+    ASSERT_TRUE(timeline.empty());
+    timeline.record(OperationPhase::kCommandDispatch, 100, 110);
+    timeline.record(OperationPhase::kLockAcquisition, 120, 150);
+    timeline.record(OperationPhase::kExecution, 150, 400);
+    timeline.record(OperationPhase::kLockAcquisition, 300, 305);
+
+    const auto phases = timeline.toBSON(&tickSource);
+
+    ASSERT_EQ(phases["lockAcquisition"]["count"].numberLong(), 2);
+    ASSERT_EQ(phases["lockAcquisition"]["totalMicros"].numberLong(), 35);
+    ASSERT_EQ(phases["execution"]["totalMicros"].numberLong(), 250);
+    ASSERT_FALSE(phases.hasField("planning"));
+    ASSERT_FALSE(phases.hasField("droppedEvents"));
+
+    const auto events = phases["timeline"].Array();
+    ASSERT_EQ(events.size(), 4U);
+    ASSERT_EQ(events[0]["phase"].String(), "commandDispatch");
+    ASSERT_EQ(events[0]["offsetMicros"].numberLong(), 0);
+    ASSERT_EQ(events[2]["phase"].String(), "execution");
+    ASSERT_EQ(events[2]["offsetMicros"].numberLong(), 50);
+    ASSERT_EQ(events[2]["durationMicros"].numberLong(), 250);
+}
+
+TEST(OperationPhaseTimeline, RingBufferKeepsMostRecentEvents) {
+    TickSourceMock<Microseconds> tickSource;
+    OperationPhaseTimeline timeline;
+    const size_t numEvents = OperationPhaseTimeline::kMaxEvents + 5;
+    for (size_t i = 0; i < numEvents; ++i) {
+        timeline.record(OperationPhase::kYield, i * 10, i * 10 + 1);
+    }
+
+    const auto phases = timeline.toBSON(&tickSource);
+
+    ASSERT_EQ(phases["yield"]["count"].numberLong(), static_cast<long long>(numEvents));
+    ASSERT_EQ(phases["droppedEvents"].numberLong(), 5);
+    const auto events = phases["timeline"].Array();
+    ASSERT_EQ(events.size(), OperationPhaseTimeline::kMaxEvents);
+    ASSERT_EQ(events.front()["offsetMicros"].numberLong(), 50);
+    ASSERT_EQ(events.back()["offsetMicros"].numberLong(),
+              static_cast<long long>((numEvents - 1) * 10));
+}
+
+TEST(OperationPhaseHistograms, BucketsArePowersOfTwo) {
+    OperationPhaseHistograms histograms;
+    histograms.record(OperationPhase::kPlanning, Microseconds(0));
+    histograms.record(OperationPhase::kPlanning, Microseconds(1));
+    histograms.record(OperationPhase::kPlanning, Microseconds(5));
+    histograms.record(OperationPhase::kPlanning, Microseconds(7));
+    histograms.record(OperationPhase::kPlanning, Microseconds(8));
+
+    BSONObjBuilder builder;
+    histograms.append(true, &builder);
+    const auto out = builder.obj();
+    ASSERT_EQ(out["planning"]["count"].numberLong(), 5);
+    ASSERT_EQ(out["planning"]["totalMicros"].numberLong(), 21);
+    ASSERT_EQ(out["execution"]["count"].numberLong(), 0);
+
+    const auto buckets = out["planning"]["histogram"].Array();
+    ASSERT_EQ(buckets.size(), 4U);
+    ASSERT_EQ(buckets[0]["micros"].numberLong(), 0);
+    ASSERT_EQ(buckets[1]["micros"].numberLong(), 1);
+    ASSERT_EQ(buckets[2]["micros"].numberLong(), 4);
+    ASSERT_EQ(buckets[2]["count"].numberLong(), 2);
+    ASSERT_EQ(buckets[3]["micros"].numberLong(), 8);
+}
+
+}  // namespace
+}  // namespace mongo
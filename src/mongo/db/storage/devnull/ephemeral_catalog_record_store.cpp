@@ -467,6 +467,7 @@ StatusWith<RecordData> EphemeralForTestRecordStore::updateWithDamages(
     // Copies the rest of the old record.
     std::memcpy(root + curSize, old + oldOffset, oldRecord->size - oldOffset);
 
+    _data->dataSize += len - oldRecord->size;
     *oldRecord = newRecord;
 
     return newRecord.toRecordData();
@@ -0,0 +1,209 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/parallel_catalog_load.h"
+
+#include <algorithm>
+
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/concurrency/locker_noop.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace catalog_load {
+namespace {
+
+// Upper bound on the pool size picked when 'catalogLoadThreads' is left at its default. Opening
+// tables is mostly bound by the storage engine's metadata lookups, which stop scaling well
+// before the core count does on large machines.
+constexpr size_t kMaxDefaultThreads = 16;
+
+// Catalog entries are handed out to the workers in batches of this many, which keeps contention
+// on the shared cursor low while still balancing the occasional expensive collection (such as
+// the oplog, whose truncate markers are sampled when it is opened).
+constexpr size_t kBatchSize = 16;
+
+const auto getCatalogLoadStats = ServiceContext::declareDecoration<CatalogLoadStats>();
+
+class CatalogLoadSSS : public ServerStatusSection {
+public:
+    CatalogLoadSSS() : ServerStatusSection("catalogLoad") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        CatalogLoadStats::get(opCtx->getServiceContext()).report(&builder);
+        return builder.obj();
+    }
+} catalogLoadSSS;
+
+StringData phaseName(CatalogLoadStats::Phase phase) {
+    switch (phase) {
+        case CatalogLoadStats::Phase::kReadCatalog:
+            return "readCatalogMillis"_sd;
+        case CatalogLoadStats::Phase::kRecoverEntries:
+            return "recoverEntriesMillis"_sd;
+        case CatalogLoadStats::Phase::kOpenCollections:
+            return "openCollectionsMillis"_sd;
+        case CatalogLoadStats::Phase::kPublishCollections:
+            return "publishCollectionsMillis"_sd;
+        case CatalogLoadStats::Phase::kReconcileIdents:
+            return "reconcileIdentsMillis"_sd;
+        case CatalogLoadStats::Phase::kInitIndexCatalogs:
+            return "initIndexCatalogsMillis"_sd;
+        case CatalogLoadStats::Phase::kNumPhases:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace
+
+size_t getThreadCount() {
+    if (gCatalogLoadThreads > 0) {
+        return static_cast<size_t>(gCatalogLoadThreads);
+    }
+    return std::clamp<size_t>(ProcessInfo::getNumAvailableCores(), 1, kMaxDefaultThreads);
+}
+
+void forEachInParallel(OperationContext* opCtx,
+                       size_t count,
+                       const std::function<std::unique_ptr<RecoveryUnit>()>& makeRecoveryUnit,
+                       const std::function<void(OperationContext*, size_t)>& fn) {
+    const size_t numThreads = std::min(getThreadCount(), (count + kBatchSize - 1) / kBatchSize);
+    if (numThreads <= 1 || !opCtx->lockState()->isW()) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(opCtx, i);
+        }
+        return;
+    }
+
+    ThreadPool::Options options;
+    options.poolName = "CatalogLoadThreadPool";
+    options.threadNamePrefix = "CatalogLoad-";
+    options.minThreads = 0;
+    options.maxThreads = numThreads;
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName);
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    AtomicWord<size_t> nextBatch{0};
+    AtomicWord<bool> failed{false};
+    auto mutex = MONGO_MAKE_LATCH("catalog_load::forEachInParallel::mutex");
+    Status firstError = Status::OK();
+
+    for (size_t i = 0; i < numThreads; ++i) {
+        pool.schedule([&](Status status) {
+            invariant(status);
+
+            auto client = Client::getCurrent();
+            auto workerOpCtx = client->makeOperationContext();
+            {
+                // The caller holds the global lock exclusively for as long as the workers run,
+                // so they must not try to acquire any locks themselves.
+                stdx::lock_guard<Client> lk(*client);
+                workerOpCtx->swapLockState(std::make_unique<LockerNoop>(), lk);
+            }
+            workerOpCtx->setRecoveryUnit(makeRecoveryUnit(),
+                                         WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+
+            try {
+                size_t begin;
+                while (!failed.load() && (begin = nextBatch.fetchAndAdd(kBatchSize)) < count) {
+                    const size_t end = std::min(begin + kBatchSize, count);
+                    for (size_t index = begin; index < end; ++index) {
+                        fn(workerOpCtx.get(), index);
+                    }
+                }
+            } catch (const DBException& ex) {
+                stdx::lock_guard<Latch> lk(mutex);
+                if (firstError.isOK()) {
+                    firstError = ex.toStatus();
+                }
+                failed.store(true);
+            }
+
+            workerOpCtx->recoveryUnit()->abandonSnapshot();
+        });
+    }
+
+    pool.waitForIdle();
+    pool.shutdown();
+    pool.join();
+
+    uassertStatusOK(firstError);
+}
+
+CatalogLoadStats& CatalogLoadStats::get(ServiceContext* svcCtx) {
+    return getCatalogLoadStats(svcCtx);
+}
+
+void CatalogLoadStats::beginLoad(size_t numEntries, size_t numThreads) {
+    _numEntries.store(static_cast<long long>(numEntries));
+    _numThreads.store(static_cast<long long>(numThreads));
+    for (auto& micros : _phaseMicros) {
+        micros.store(0);
+    }
+}
+
+void CatalogLoadStats::add(Phase phase, Microseconds duration) {
+    _phaseMicros[static_cast<size_t>(phase)].fetchAndAdd(durationCount<Microseconds>(duration));
+}
+
+void CatalogLoadStats::report(BSONObjBuilder* builder) const {
+    builder->append("entries", _numEntries.load());
+    builder->append("threads", _numThreads.load());
+
+    Microseconds total{0};
+    for (size_t i = 0; i < _phaseMicros.size(); ++i) {
+        const Microseconds phase{_phaseMicros[i].load()};
+        builder->append(phaseName(static_cast<Phase>(i)), durationCount<Milliseconds>(phase));
+        total += phase;
+    }
+    builder->append("totalMillis", durationCount<Milliseconds>(total));
+}
+
+}  // namespace catalog_load
+}  // namespace mongo
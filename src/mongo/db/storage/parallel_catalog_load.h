@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+class OperationContext;
+class RecoveryUnit;
+class ServiceContext;
+
+namespace catalog_load {
+
+/**
+ * Returns the number of worker threads used to load the catalog, as configured by the
+ * 'catalogLoadThreads' server parameter. A configured value of 0 sizes the pool from the number
+ * of available cores.
+ */
+size_t getThreadCount();
+
+/**
+ * Invokes 'fn' once for every index in [0, count). Indexes are handed out in small batches to a
+ * pool of worker threads, each with its own Client and OperationContext, so that independent
+ * catalog entries can be opened concurrently. The work runs inline on 'opCtx' instead when there
+ * is too little of it, when only a single thread is configured, or when the caller does not hold
+ * the global lock in exclusive mode.
+ *
+ * Worker operations run without taking locks of their own, on behalf of the caller's exclusive
+ * global lock. Each is given a recovery unit obtained from 'makeRecoveryUnit', since the storage
+ * engine may not have been installed on the ServiceContext yet.
+ *
+ * 'fn' may only modify state which is private to the index it was given, or which is otherwise
+ * synchronized. If any invocation throws, the remaining batches are abandoned and the first error
+ * is rethrown on the calling thread once all workers have stopped.
+ */
+void forEachInParallel(OperationContext* opCtx,
+                       size_t count,
+                       const std::function<std::unique_ptr<RecoveryUnit>()>& makeRecoveryUnit,
+                       const std::function<void(OperationContext*, size_t)>& fn);
+
+/**
+ * Breakdown of where time went the last time the catalog was loaded, reported in the
+ * 'catalogLoad' serverStatus section.
+ */
+class CatalogLoadStats {
+public:
+    enum class Phase {
+        // Reading the _mdb_catalog and the list of idents known to the storage engine.
+        kReadCatalog,
+        // Serially recovering orphaned entries and removing unknown unreplicated collections.
+        kRecoverEntries,
+        // Parsing collection metadata and opening record stores.
+        kOpenCollections,
+        // Registering the opened collections with the CollectionCatalog.
+        kPublishCollections,
+        // Cross-referencing catalog entries against the storage engine idents.
+        kReconcileIdents,
+        // Parsing index metadata and opening index tables, summed over all databases.
+        kInitIndexCatalogs,
+        kNumPhases,
+    };
+
+    static CatalogLoadStats& get(ServiceContext* svcCtx);
+
+    /**
+     * Clears the timings of the previous load and records how many entries the new one covers.
+     */
+    void beginLoad(size_t numEntries, size_t numThreads);
+
+    /**
+     * Adds 'duration' to the time spent in 'phase' since the last call to beginLoad().
+     */
+    void add(Phase phase, Microseconds duration);
+
+    void report(BSONObjBuilder* builder) const;
+
+private:
+    AtomicWord<long long> _numEntries{0};
+    AtomicWord<long long> _numThreads{0};
+    std::array<AtomicWord<long long>, static_cast<size_t>(Phase::kNumPhases)> _phaseMicros;
+};
+
+}  // namespace catalog_load
+}  // namespace mongo
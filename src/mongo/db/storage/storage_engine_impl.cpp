@@ -48,6 +48,7 @@
 #include "mongo/db/storage/durable_catalog_impl.h"
 #include "mongo/db/storage/durable_history_pin.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/parallel_catalog_load.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/db/storage/storage_util.h"
 #include "mongo/db/storage/two_phase_index_build_knobs_gen.h"
@@ -57,6 +58,7 @@
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 #define LOGV2_FOR_RECOVERY(ID, DLEVEL, MESSAGE, ...) \
     LOGV2_DEBUG_OPTIONS(ID, DLEVEL, {logv2::LogComponent::kStorageRecovery}, MESSAGE, ##__VA_ARGS__)
@@ -148,6 +150,10 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, LastShutdownState l
         _dumpCatalog(opCtx);
     }
 
+    Timer phaseTimer;
+    Timer totalTimer;
+    auto& loadStats = catalog_load::CatalogLoadStats::get(opCtx->getServiceContext());
+
     _catalog.reset(new DurableCatalogImpl(
         _catalogRecordStore.get(), _options.directoryPerDB, _options.directoryForIndexes, this));
     _catalog->init(opCtx);
@@ -229,9 +235,18 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, LastShutdownState l
         }
     }
 
+    const auto numThreads = catalog_load::getThreadCount();
+    loadStats.beginLoad(catalogEntries.size(), numThreads);
+    loadStats.add(catalog_load::CatalogLoadStats::Phase::kReadCatalog, phaseTimer.elapsed());
+    phaseTimer.reset();
+
+    // Entries which survived recovery, along with the minimum visible timestamp to install on
+    // their collection once it has been opened.
+    std::vector<std::pair<DurableCatalog::Entry, Timestamp>> entriesToOpen;
+    entriesToOpen.reserve(catalogEntries.size());
+
     const auto loadingFromUncleanShutdownOrRepair =
         lastShutdownState == LastShutdownState::kUnclean || _options.forRepair;
-    BatchedCollectionCatalogWriter catalogBatchWriter{opCtx};
     for (DurableCatalog::Entry entry : catalogEntries) {
         if (loadingFromUncleanShutdownOrRepair) {
             // If we are loading the catalog after an unclean shutdown or during repair, it's
@@ -315,21 +330,64 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, LastShutdownState l
                 });
         }
 
-        _initCollection(opCtx, entry.catalogId, entry.nss, _options.forRepair, minVisibleTs);
-
-        if (entry.nss.isOrphanCollection()) {
-            LOGV2(22248, "Orphaned collection found", "namespace"_attr = entry.nss);
+        entriesToOpen.emplace_back(std::move(entry), minVisibleTs);
+    }
+    loadStats.add(catalog_load::CatalogLoadStats::Phase::kRecoverEntries, phaseTimer.elapsed());
+    phaseTimer.reset();
+
+    // Parsing the metadata and opening the record store of each collection only reads the
+    // durable catalog and the storage engine's own metadata, so the entries are opened
+    // concurrently. Everything above which modifies the durable catalog stays serial.
+    std::vector<std::shared_ptr<Collection>> openedCollections(entriesToOpen.size());
+    catalog_load::forEachInParallel(
+        opCtx,
+        entriesToOpen.size(),
+        [this] { return std::unique_ptr<RecoveryUnit>(_engine->newRecoveryUnit()); },
+        [&](OperationContext* workerOpCtx, size_t i) {
+            const auto& [entry, minVisibleTs] = entriesToOpen[i];
+            openedCollections[i] = _openCollection(
+                workerOpCtx, entry.catalogId, entry.nss, _options.forRepair, minVisibleTs);
+        });
+    loadStats.add(catalog_load::CatalogLoadStats::Phase::kOpenCollections, phaseTimer.elapsed());
+    phaseTimer.reset();
+
+    // Publish the collections in catalog order, independently of the order in which the workers
+    // finished opening them.
+    {
+        BatchedCollectionCatalogWriter catalogBatchWriter{opCtx};
+        for (size_t i = 0; i < entriesToOpen.size(); ++i) {
+            const auto& nss = entriesToOpen[i].first.nss;
+            auto uuid = openedCollections[i]->uuid();
+            CollectionCatalog::write(opCtx, [&](CollectionCatalog& catalog) {
+                catalog.registerCollection(opCtx, uuid, std::move(openedCollections[i]));
+            });
+
+            if (nss.isOrphanCollection()) {
+                LOGV2(22248, "Orphaned collection found", "namespace"_attr = nss);
+            }
         }
     }
+    loadStats.add(catalog_load::CatalogLoadStats::Phase::kPublishCollections,
+                  phaseTimer.elapsed());
+
+    LOGV2(6440700,
+          "Loaded the catalog",
+          "collections"_attr = entriesToOpen.size(),
+          "stats"_attr = [&] {
+              BSONObjBuilder builder;
+              loadStats.report(&builder);
+              return builder.obj();
+          }(),
+          "duration"_attr = duration_cast<Milliseconds>(totalTimer.elapsed()));
 
     opCtx->recoveryUnit()->abandonSnapshot();
 }
 
-void StorageEngineImpl::_initCollection(OperationContext* opCtx,
-                                        RecordId catalogId,
-                                        const NamespaceString& nss,
-                                        bool forRepair,
-                                        Timestamp minVisibleTs) {
+std::shared_ptr<Collection> StorageEngineImpl::_openCollection(OperationContext* opCtx,
+                                                               RecordId catalogId,
+                                                               const NamespaceString& nss,
+                                                               bool forRepair,
+                                                               Timestamp minVisibleTs) {
     auto md = _catalog->getMetaData(opCtx, catalogId);
     uassert(ErrorCodes::MustDowngrade,
             str::stream() << "Collection does not have UUID in KVCatalog. Collection: " << nss,
@@ -351,9 +409,18 @@ void StorageEngineImpl::_initCollection(OperationContext* opCtx,
     TenantNamespace tenantNs(getActiveTenant(opCtx), nss);
     auto collection = collectionFactory->make(opCtx, tenantNs, catalogId, md, std::move(rs));
     collection->setMinimumVisibleSnapshot(minVisibleTs);
+    return collection;
+}
 
+void StorageEngineImpl::_initCollection(OperationContext* opCtx,
+                                        RecordId catalogId,
+                                        const NamespaceString& nss,
+                                        bool forRepair,
+                                        Timestamp minVisibleTs) {
+    auto collection = _openCollection(opCtx, catalogId, nss, forRepair, minVisibleTs);
+    auto uuid = collection->uuid();
     CollectionCatalog::write(opCtx, [&](CollectionCatalog& catalog) {
-        catalog.registerCollection(opCtx, md->options.uuid.get(), std::move(collection));
+        catalog.registerCollection(opCtx, uuid, std::move(collection));
     });
 }
 
@@ -486,6 +553,15 @@ bool StorageEngineImpl::_handleInternalIdent(OperationContext* opCtx,
  */
 StatusWith<StorageEngine::ReconcileResult> StorageEngineImpl::reconcileCatalogAndIdents(
     OperationContext* opCtx, LastShutdownState lastShutdownState) {
+    Timer timer;
+    ON_BLOCK_EXIT([&] {
+        catalog_load::CatalogLoadStats::get(opCtx->getServiceContext())
+            .add(catalog_load::CatalogLoadStats::Phase::kReconcileIdents, timer.elapsed());
+        LOGV2(6440701,
+              "Finished reconciling the catalog with the storage engine idents",
+              "duration"_attr = duration_cast<Milliseconds>(timer.elapsed()));
+    });
+
     // Gather all tables known to the storage engine and drop those that aren't cross-referenced
     // in the _mdb_catalog. This can happen for two reasons.
     //
@@ -578,16 +654,41 @@ StatusWith<StorageEngine::ReconcileResult> StorageEngineImpl::reconcileCatalogAn
     //
     // Also, remove unfinished builds except those that were background index builds started on a
     // secondary.
-    for (DurableCatalog::Entry entry : catalogEntries) {
+    //
+    // Parsing the metadata of every entry dominates the cost of this scan on catalogs with many
+    // collections, so it is done up front and concurrently. Any changes made below only affect the
+    // entry being examined, which makes the prefetched metadata equivalent to reading it inline.
+    struct EntryMetaData {
+        std::shared_ptr<BSONCollectionCatalogEntry::MetaData> metaData;
+        std::vector<std::string> indexIdents;
+    };
+    std::vector<EntryMetaData> entryMetaData(catalogEntries.size());
+    catalog_load::forEachInParallel(
+        opCtx,
+        catalogEntries.size(),
+        [this] { return std::unique_ptr<RecoveryUnit>(_engine->newRecoveryUnit()); },
+        [&](OperationContext* workerOpCtx, size_t i) {
+            auto& [metaData, indexIdents] = entryMetaData[i];
+            metaData = _catalog->getMetaData(workerOpCtx, catalogEntries[i].catalogId);
+            indexIdents.reserve(metaData->indexes.size());
+            for (const auto& indexMetaData : metaData->indexes) {
+                indexIdents.push_back(_catalog->getIndexIdent(
+                    workerOpCtx, catalogEntries[i].catalogId, indexMetaData.nameStringData()));
+            }
+        });
+
+    for (size_t i = 0; i < catalogEntries.size(); ++i) {
+        const DurableCatalog::Entry& entry = catalogEntries[i];
         std::shared_ptr<BSONCollectionCatalogEntry::MetaData> metaData =
-            _catalog->getMetaData(opCtx, entry.catalogId);
+            std::move(entryMetaData[i].metaData);
         NamespaceString coll(metaData->ns);
 
         // Batch up the indexes to remove them from `metaData` outside of the iterator.
         std::vector<std::string> indexesToDrop;
-        for (const auto& indexMetaData : metaData->indexes) {
+        for (size_t indexNum = 0; indexNum < metaData->indexes.size(); ++indexNum) {
+            const auto& indexMetaData = metaData->indexes[indexNum];
             auto indexName = indexMetaData.nameStringData();
-            auto indexIdent = _catalog->getIndexIdent(opCtx, entry.catalogId, indexName);
+            const auto& indexIdent = entryMetaData[i].indexIdents[indexNum];
 
             // Warn in case of incorrect "multikeyPath" information in catalog documents. This is
             // the result of a concurrency bug which has since been fixed, but may persist in
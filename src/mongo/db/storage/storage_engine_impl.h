@@ -366,6 +366,17 @@ public:
 private:
     using CollIter = std::list<std::string>::iterator;
 
+    /**
+     * Parses the catalog entry for 'catalogId' and constructs its collection without publishing
+     * it to the CollectionCatalog. Only reads from the durable catalog, so it is safe to call for
+     * different entries concurrently.
+     */
+    std::shared_ptr<Collection> _openCollection(OperationContext* opCtx,
+                                                RecordId catalogId,
+                                                const NamespaceString& nss,
+                                                bool forRepair,
+                                                Timestamp minVisibleTs);
+
     void _initCollection(OperationContext* opCtx,
                          RecordId catalogId,
                          const NamespaceString& nss,
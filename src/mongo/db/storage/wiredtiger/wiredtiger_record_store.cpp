@@ -124,6 +124,18 @@ void appendNumericStats(WT_SESSION* s, const std::string& uri, BSONObjBuilder& b
     }
 }
 
+/**
+ * Returns the number of bytes written by the first 'nentries' modifications in 'entries', counting
+ * both the old data each one overwrites (size) and the new data it inserts (data.size).
+ */
+size_t computeModifiedDataSize(const std::vector<WT_MODIFY>& entries, int nentries) {
+    size_t modifiedDataSize = 0;
+    for (int i = 0; i < nentries; i++) {
+        modifiedDataSize += entries[i].size + entries[i].data.size;
+    }
+    return modifiedDataSize;
+}
+
 std::size_t computeRecordIdSize(const RecordId& id) {
     // We previously weren't accounting for WiredTiger key size when it was an int64_t, thus we
     // return 0 in those cases. With the clustering capabilities we now support potentially large
@@ -1547,17 +1559,10 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
                 nentries == 0 ? c->reserve(c)
                               : wiredTigerCursorModify(opCtx, c, entries.data(), nentries)));
 
-            size_t modifiedDataSize = 0;
-            // Don't perform a range-based for loop because there may be fewer calculated entries
-            // than the reserved maximum.
-            for (auto i = 0; i < nentries; i++) {
-                // Account for both the amount of old data we are overwriting (size) and new data we
-                // are inserting (data.size).
-                modifiedDataSize += entries[i].size + entries[i].data.size;
-            }
-
+            // There may be fewer calculated entries than the reserved maximum.
             auto keyLength = computeRecordIdSize(id);
-            metricsCollector.incrementOneDocWritten(modifiedDataSize + keyLength);
+            metricsCollector.incrementOneDocWritten(computeModifiedDataSize(entries, nentries) +
+                                                    keyLength);
 
             WT_ITEM new_value;
             dassert(nentries == 0 ||
@@ -1594,19 +1599,45 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     const mutablebson::DamageVector& damages) {
 
     const int nentries = damages.size();
-    mutablebson::DamageVector::const_iterator where = damages.begin();
-    const mutablebson::DamageVector::const_iterator end = damages.cend();
     std::vector<WT_MODIFY> entries(nentries);
-    size_t modifiedDataSize = 0;
-    for (u_int i = 0; where != end; ++i, ++where) {
-        entries[i].data.data = damageSource + where->sourceOffset;
-        entries[i].data.size = where->sourceSize;
-        entries[i].offset = where->targetOffset;
-        entries[i].size = where->targetSize;
-        // Account for both the amount of old data we are overwriting (size) and new data we are
-        // inserting (data.size).
-        modifiedDataSize += entries[i].size;
-        modifiedDataSize += entries[i].data.size;
+    int64_t sizeChange = 0;
+    bool changesLayout = false;
+    for (int i = 0; i < nentries; ++i) {
+        const auto& damage = damages[i];
+        entries[i].data.data = damageSource + damage.sourceOffset;
+        entries[i].data.size = damage.sourceSize;
+        entries[i].offset = damage.targetOffset;
+        entries[i].size = damage.targetSize;
+        sizeChange += static_cast<int64_t>(damage.sourceSize) - damage.targetSize;
+        changesLayout = changesLayout || damage.sourceSize != damage.targetSize;
+    }
+
+    if (_oplogStones && sizeChange != 0) {
+        return {ErrorCodes::IllegalOperation, "Cannot change the size of a document in the oplog"};
+    }
+
+    // As in updateRecord, skip modify for logged tables when the damages insert or remove bytes:
+    // don't trust WiredTiger's recovery with operations that are not idempotent. Apply the damages
+    // to a copy of the old record and write the whole new record instead.
+    if (_isLogged && changesLayout) {
+        std::string newRec;
+        newRec.reserve(oldRec.size() + sizeChange);
+        // The target offset of each damage refers to the record as modified by the damages before
+        // it.
+        size_t oldOffset = 0;
+        for (const auto& damage : damages) {
+            const size_t unchangedSize = damage.targetOffset - newRec.size();
+            newRec.append(oldRec.data() + oldOffset, unchangedSize);
+            newRec.append(damageSource + damage.sourceOffset, damage.sourceSize);
+            oldOffset += unchangedSize + damage.targetSize;
+        }
+        newRec.append(oldRec.data() + oldOffset, oldRec.size() - oldOffset);
+
+        auto status = updateRecord(opCtx, id, newRec.data(), newRec.size());
+        if (!status.isOK()) {
+            return status;
+        }
+        return RecordData(newRec.data(), newRec.size()).getOwned();
     }
 
     WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
@@ -1625,7 +1656,9 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     auto& metricsCollector = ResourceConsumption::MetricsCollector::get(opCtx);
 
     auto keyLength = computeRecordIdSize(id);
-    metricsCollector.incrementOneDocWritten(modifiedDataSize + keyLength);
+    metricsCollector.incrementOneDocWritten(computeModifiedDataSize(entries, nentries) + keyLength);
+
+    _increaseDataSize(opCtx, sizeChange);
 
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
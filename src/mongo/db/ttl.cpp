@@ -33,6 +33,10 @@
 
 #include "mongo/db/ttl.h"
 
+#include <deque>
+#include <map>
+#include <set>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -41,6 +45,7 @@
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync_locked.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -61,6 +66,7 @@
 #include "mongo/logv2/log.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log_with_sampling.h"
 
 namespace mongo {
@@ -171,7 +177,71 @@ public:
         LOGV2(3684101, "Finished shutting down TTL collection monitor thread");
     }
 
+    /**
+     * Appends the per-index TTL statistics, grouped by namespace.
+     */
+    void appendStats(BSONObjBuilder* builder) const {
+        stdx::lock_guard<Latch> lk(_statsMutex);
+        boost::optional<BSONObjBuilder> nsBuilder;
+        boost::optional<NamespaceString> currentNss;
+        for (const auto& [key, stats] : _stats) {
+            const auto& [nss, indexName] = key;
+            if (currentNss != nss) {
+                nsBuilder.reset();
+                nsBuilder.emplace(builder->subobjStart(nss.ns()));
+                currentNss = nss;
+            }
+            BSONObjBuilder indexBuilder(nsBuilder->subobjStart(indexName));
+            indexBuilder.append("deletedDocuments", stats.deletedDocuments);
+            indexBuilder.append("lastPassDeletedDocuments", stats.lastPassDeletedDocuments);
+            indexBuilder.append("lastPassStart", stats.lastPassStart);
+            indexBuilder.append("lagMillis", durationCount<Milliseconds>(stats.lag));
+            indexBuilder.append("subRanges", stats.subRanges);
+        }
+    }
+
 private:
+    /**
+     * A unit of TTL work: deleting the expired documents of one TTL index or clustered collection,
+     * possibly restricted to a sub-range of its expired values. A task deletes at most
+     * 'ttlMonitorBatchesPerTurn' batches each time a worker runs it, and goes back to the end of
+     * the queue of the pass if it has more to delete, so that no collection starves the others.
+     */
+    struct TTLTask {
+        UUID uuid;
+        NamespaceString nss;
+        TTLCollectionCache::Info info;
+
+        // The inclusive bounds of the expired values this task deletes. Unset until the task first
+        // runs, at which point they are set to the whole expired range, which may then be split.
+        boost::optional<std::pair<Date_t, Date_t>> range;
+    };
+
+    /**
+     * The state shared by the workers of a TTL pass.
+     */
+    struct TTLPassState {
+        Mutex mutex = MONGO_MAKE_LATCH("TTLPassState::mutex");
+        std::deque<TTLTask> queue;
+        bool interrupted = false;
+    };
+
+    /**
+     * Statistics about the TTL deletes of one TTL index, or of a clustered collection.
+     */
+    struct TTLIndexStats {
+        long long deletedDocuments = 0;
+        long long lastPassDeletedDocuments = 0;
+        Date_t lastPassStart;
+        // How long ago the oldest expired document had expired when the last pass started.
+        Milliseconds lag{0};
+        int subRanges = 1;
+    };
+
+    using TTLStatsKey = std::pair<NamespaceString, std::string>;
+
+    static constexpr auto kClusteredIdStatsName = "_id"_sd;
+
     /**
      * Gets all TTL specifications for every collection and deletes expired documents.
      */
@@ -191,7 +261,9 @@ private:
         // Increment the metric after the TTL work has been finished.
         ON_BLOCK_EXIT([&] { ttlPasses.increment(); });
 
-        // Perform a pass for every collection and index described as being TTL.
+        // Queue a task for every collection and index described as being TTL.
+        TTLPassState pass;
+        std::set<TTLStatsKey> statsKeys;
         for (const auto& [uuid, infos] : ttlInfos) {
             for (const auto& info : infos) {
                 // Skip collections that have not been made visible yet. The TTLCollectionCache
@@ -209,40 +281,195 @@ private:
                     continue;
                 }
 
-                try {
-                    deleteExpired(opCtx, &ttlCollectionCache, uuid, *nss, info);
-                } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
-                    LOGV2_WARNING(22537,
-                                  "TTLMonitor was interrupted, waiting before doing another pass",
-                                  "wait"_attr = Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
+                statsKeys.emplace(*nss, statsName(info));
+                pass.queue.push_back({uuid, *nss, info, boost::none});
+            }
+        }
+
+        // Forget the statistics of the indexes which are no longer TTL indexes.
+        {
+            stdx::lock_guard<Latch> lk(_statsMutex);
+            for (auto it = _stats.begin(); it != _stats.end();) {
+                it = statsKeys.count(it->first) ? std::next(it) : _stats.erase(it);
+            }
+        }
+
+        const auto numWorkers = ttlMonitorWorkers.load();
+        if (numWorkers <= 1) {
+            runTasks(opCtx, &ttlCollectionCache, &pass);
+            return;
+        }
+
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitorWorkers";
+        options.threadNamePrefix = "TTLMonitorWorker-";
+        options.minThreads = 0;
+        options.maxThreads = numWorkers;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName);
+            AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+            stdx::lock_guard<Client> lk(cc());
+            cc().setSystemOperationKillableByStepdown(lk);
+        };
+        ThreadPool pool(options);
+        pool.startup();
+        for (int i = 0; i < numWorkers; ++i) {
+            pool.schedule([&](Status status) {
+                if (!status.isOK()) {
                     return;
-                } catch (const DBException& ex) {
-                    LOGV2_ERROR(5400703,
-                                "Error running TTL job on collection",
-                                logAttrs(*nss),
-                                "error"_attr = ex);
-                    continue;
                 }
+                const auto workerOpCtx = cc().makeOperationContext();
+                runTasks(workerOpCtx.get(), &ttlCollectionCache, &pass);
+            });
+        }
+        pool.waitForIdle();
+        pool.shutdown();
+        pool.join();
+    }
+
+    /**
+     * Runs the tasks of 'pass' until its queue is empty or the pass is interrupted.
+     */
+    void runTasks(OperationContext* opCtx,
+                  TTLCollectionCache* ttlCollectionCache,
+                  TTLPassState* pass) {
+        while (true) {
+            boost::optional<TTLTask> task;
+            {
+                stdx::lock_guard<Latch> lk(pass->mutex);
+                if (pass->interrupted || pass->queue.empty()) {
+                    return;
+                }
+                task.emplace(std::move(pass->queue.front()));
+                pass->queue.pop_front();
+            }
+
+            try {
+                if (deleteExpired(opCtx, ttlCollectionCache, pass, &*task)) {
+                    stdx::lock_guard<Latch> lk(pass->mutex);
+                    pass->queue.push_back(std::move(*task));
+                }
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+                LOGV2_WARNING(22537,
+                              "TTLMonitor was interrupted, waiting before doing another pass",
+                              "wait"_attr = Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
+                stdx::lock_guard<Latch> lk(pass->mutex);
+                pass->interrupted = true;
+                return;
+            } catch (const DBException& ex) {
+                LOGV2_ERROR(5400703,
+                            "Error running TTL job on collection",
+                            logAttrs(task->nss),
+                            "error"_attr = ex);
+            }
+        }
+    }
+
+    static std::string statsName(const TTLCollectionCache::Info& info) {
+        return stdx::visit(
+            visit_helper::Overloaded{
+                [](const TTLCollectionCache::ClusteredId&) {
+                    return kClusteredIdStatsName.toString();
+                },
+                [](const TTLCollectionCache::IndexName& indexName) { return indexName; }},
+            info);
+    }
+
+    /**
+     * Called when 'task' first runs in a pass. Records the lag of its index and, if its expired
+     * range is large enough, splits the range into 'ttlMonitorSubRangesPerCollection' sub-ranges
+     * of equal time span, queueing a new task for each sub-range but the first.
+     *
+     * 'oldest' is the oldest expired value, if there is one, and 'expirationDate' the newest.
+     */
+    void startTask(TTLPassState* pass,
+                   TTLTask* task,
+                   Date_t rangeStart,
+                   boost::optional<Date_t> oldest,
+                   Date_t expirationDate) {
+        task->range.emplace(rangeStart, expirationDate);
+
+        // Values before the epoch are treated as expired at the epoch, which keeps the time spans
+        // below from overflowing.
+        if (oldest && *oldest < Date_t()) {
+            oldest = Date_t();
+        }
+
+        int subRanges = 1;
+        const auto numSubRanges = ttlMonitorSubRangesPerCollection.load();
+        const auto spanMillis = oldest ? durationCount<Milliseconds>(expirationDate - *oldest) : 0;
+        if (ttlMonitorWorkers.load() > 1 && numSubRanges > 1 && spanMillis >= numSubRanges) {
+            auto boundary = [&](int i) {
+                return *oldest + Milliseconds(spanMillis / numSubRanges * i);
+            };
+
+            // The sub-ranges share their bounds. Documents on a bound are visited by two tasks, but
+            // only deleted once.
+            stdx::lock_guard<Latch> lk(pass->mutex);
+            for (int i = 1; i < numSubRanges; ++i) {
+                auto end = i + 1 == numSubRanges ? expirationDate : boundary(i + 1);
+                pass->queue.push_back({task->uuid, task->nss, task->info, {{boundary(i), end}}});
+            }
+            task->range->second = boundary(1);
+            subRanges = numSubRanges;
+        }
+
+        stdx::lock_guard<Latch> lk(_statsMutex);
+        auto& stats = _stats[{task->nss, statsName(task->info)}];
+        stats.lastPassDeletedDocuments = 0;
+        stats.lastPassStart = Date_t::now();
+        stats.lag = oldest && *oldest < expirationDate ? expirationDate - *oldest : Milliseconds(0);
+        stats.subRanges = subRanges;
+    }
+
+    void recordDeletes(const TTLTask& task, long long numDeleted) {
+        ttlDeletedDocuments.increment(numDeleted);
+
+        stdx::lock_guard<Latch> lk(_statsMutex);
+        auto& stats = _stats[{task.nss, statsName(task.info)}];
+        stats.deletedDocuments += numDeleted;
+        stats.lastPassDeletedDocuments += numDeleted;
+    }
+
+    /**
+     * Deletes up to 'ttlMonitorBatchesPerTurn' batches of 'ttlMonitorDeleteBatchSize' expired
+     * documents with the delete plan 'exec', which must return the documents it deletes. Each
+     * document is deleted in its own WriteUnitOfWork, as on a replica set primary every delete is
+     * logged with its own oplog timestamp, and the plan yields between them. Returns the number of
+     * documents deleted and whether 'exec' may have more documents to delete.
+     */
+    std::pair<long long, bool> deleteBatches(PlanExecutor* exec) {
+        const long long maxDeletes = static_cast<long long>(ttlMonitorDeleteBatchSize.load()) *
+            ttlMonitorBatchesPerTurn.load();
+
+        long long numDeleted = 0;
+        BSONObj deletedDoc;
+        while (numDeleted < maxDeletes) {
+            if (exec->getNext(&deletedDoc, nullptr) != PlanExecutor::ADVANCED) {
+                return {numDeleted, false};
             }
+            ++numDeleted;
         }
+        return {numDeleted, true};
     }
 
     /**
-     * Deletes expired data on the given collection with the provided information.
+     * Deletes expired data on the given collection with the provided information. Returns whether
+     * 'task' has more documents to delete.
      */
-    void deleteExpired(OperationContext* opCtx,
+    bool deleteExpired(OperationContext* opCtx,
                        TTLCollectionCache* ttlCollectionCache,
-                       const UUID& uuid,
-                       const NamespaceString& nss,
-                       const TTLCollectionCache::Info& info) {
+                       TTLPassState* pass,
+                       TTLTask* task) {
+        const auto& nss = task->nss;
         if (nss.isTemporaryReshardingCollection()) {
             // For resharding, the donor shard primary is responsible for performing the TTL
             // deletions.
-            return;
+            return false;
         }
 
         if (nss.isDropPendingNamespace()) {
-            return;
+            return false;
         }
 
         uassertStatusOK(userAllowedWriteNS(opCtx, nss));
@@ -250,8 +477,8 @@ private:
         AutoGetCollection coll(opCtx, nss, MODE_IX);
         // The collection with `uuid` might be renamed before the lock and the wrong namespace would
         // be locked and looked up so we double check here.
-        if (!coll || coll->uuid() != uuid)
-            return;
+        if (!coll || coll->uuid() != task->uuid)
+            return false;
 
         // Allow TTL deletion on non-capped collections, and on capped clustered collections.
         invariant(!coll->isCapped() || (coll->isCapped() && coll->isClustered()));
@@ -264,7 +491,7 @@ private:
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, nss)) {
-            return;
+            return false;
         }
 
         std::shared_ptr<TenantMigrationAccessBlocker> mtab;
@@ -279,21 +506,23 @@ private:
                         "Postpone TTL of DB because of active tenant migration",
                         "tenantMigrationAccessBlocker"_attr = mtab->getDebugInfo().jsonString(),
                         "database"_attr = coll.getDb()->name());
-            return;
+            return false;
         }
 
         ResourceConsumption::ScopedMetricsCollector scopedMetrics(opCtx, nss.db().toString());
 
         const auto& collection = coll.getCollection();
-        stdx::visit(
+        return stdx::visit(
             visit_helper::Overloaded{
                 [&](const TTLCollectionCache::ClusteredId&) {
-                    deleteExpiredWithCollscan(opCtx, ttlCollectionCache, collection);
+                    return deleteExpiredWithCollscan(
+                        opCtx, ttlCollectionCache, pass, collection, task);
                 },
                 [&](const TTLCollectionCache::IndexName& indexName) {
-                    deleteExpiredWithIndex(opCtx, ttlCollectionCache, collection, indexName);
+                    return deleteExpiredWithIndex(
+                        opCtx, ttlCollectionCache, pass, collection, indexName, task);
                 }},
-            info);
+            task->info);
     }
 
     /**
@@ -319,25 +548,28 @@ private:
 
     /**
      * Removes documents from the collection using the specified TTL index after a sufficient
-     * amount of time has passed according to its expiry specification.
+     * amount of time has passed according to its expiry specification. Returns whether 'task' has
+     * more documents to delete.
      */
-    void deleteExpiredWithIndex(OperationContext* opCtx,
+    bool deleteExpiredWithIndex(OperationContext* opCtx,
                                 TTLCollectionCache* ttlCollectionCache,
+                                TTLPassState* pass,
                                 const CollectionPtr& collection,
-                                std::string indexName) {
+                                std::string indexName,
+                                TTLTask* task) {
         if (!collection->isIndexPresent(indexName)) {
             ttlCollectionCache->deregisterTTLInfo(collection->uuid(), indexName);
-            return;
+            return false;
         }
 
         BSONObj spec = collection->getIndexSpec(indexName);
         if (!spec.hasField(IndexDescriptor::kExpireAfterSecondsFieldName)) {
             ttlCollectionCache->deregisterTTLInfo(collection->uuid(), indexName);
-            return;
+            return false;
         }
 
         if (!collection->isIndexReady(indexName)) {
-            return;
+            return false;
         }
 
         const BSONObj key = spec["key"].Obj();
@@ -346,7 +578,7 @@ private:
             LOGV2_ERROR(22540,
                         "key for ttl index can only have 1 field, skipping TTL job",
                         "index"_attr = spec);
-            return;
+            return false;
         }
 
         LOGV2_DEBUG(22533,
@@ -359,14 +591,14 @@ private:
         const IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
         if (!desc) {
             LOGV2_DEBUG(22535, 1, "index not found; skipping ttl job", "index"_attr = spec);
-            return;
+            return false;
         }
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             LOGV2_ERROR(22541,
                         "special index can't be used as a TTL index, skipping TTL job",
                         "index"_attr = spec);
-            return;
+            return false;
         }
 
         BSONElement secondsExpireElt = spec[IndexDescriptor::kExpireAfterSecondsFieldName];
@@ -376,27 +608,50 @@ private:
                         "field"_attr = IndexDescriptor::kExpireAfterSecondsFieldName,
                         "type"_attr = typeName(secondsExpireElt.type()),
                         "index"_attr = spec);
-            return;
+            return false;
         }
 
-        const Date_t kDawnOfTime =
-            Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
-        const auto expirationDate =
-            safeExpirationDate(opCtx, collection, secondsExpireElt.safeNumberLong());
-        const BSONObj startKey = BSON("" << kDawnOfTime);
-        const BSONObj endKey = BSON("" << expirationDate);
         // The canonical check as to whether a key pattern element is "ascending" or
         // "descending" is (elt.number() >= 0).  This is defined by the Ordering class.
         const InternalPlanner::Direction direction = (key.firstElement().number() >= 0)
             ? InternalPlanner::Direction::FORWARD
             : InternalPlanner::Direction::BACKWARD;
 
+        if (!task->range) {
+            const Date_t kDawnOfTime =
+                Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
+            const auto expirationDate =
+                safeExpirationDate(opCtx, collection, secondsExpireElt.safeNumberLong());
+
+            // The first key of the expired range holds the oldest expired value.
+            auto scan = InternalPlanner::indexScan(opCtx,
+                                                   &collection,
+                                                   desc,
+                                                   BSON("" << kDawnOfTime),
+                                                   BSON("" << expirationDate),
+                                                   BoundInclusion::kIncludeBothStartAndEndKeys,
+                                                   PlanYieldPolicy::YieldPolicy::INTERRUPT_ONLY,
+                                                   direction);
+            BSONObj oldestKey;
+            boost::optional<Date_t> oldest;
+            if (scan->getNext(&oldestKey, nullptr) == PlanExecutor::ADVANCED &&
+                oldestKey.firstElement().type() == BSONType::Date) {
+                oldest = oldestKey.firstElement().date();
+            }
+            scan.reset();
+
+            startTask(pass, task, kDawnOfTime, oldest, expirationDate);
+        }
+
+        const auto& [rangeStart, rangeEnd] = *task->range;
+        const BSONObj startKey = BSON("" << rangeStart);
+        const BSONObj endKey = BSON("" << rangeEnd);
+
         // We need to pass into the DeleteStageParams (below) a CanonicalQuery with a BSONObj that
         // queries for the expired documents correctly so that we do not delete documents that are
         // not actually expired when our snapshot changes during deletion.
         const char* keyFieldName = key.firstElement().fieldName();
-        BSONObj query =
-            BSON(keyFieldName << BSON("$gte" << kDawnOfTime << "$lte" << expirationDate));
+        BSONObj query = BSON(keyFieldName << BSON("$gte" << rangeStart << "$lte" << rangeEnd));
         auto findCommand = std::make_unique<FindCommandRequest>(collection->ns());
         findCommand->setFilter(query);
         auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(findCommand));
@@ -405,8 +660,9 @@ private:
         auto params = std::make_unique<DeleteStageParams>();
         params->isMulti = true;
         params->canonicalQuery = canonicalQuery.getValue().get();
+        // Returning each deleted document lets the deletes of a turn be counted.
+        params->returnDeleted = true;
 
-        Timer timer;
         auto exec =
             InternalPlanner::deleteWithIndexScan(opCtx,
                                                  &collection,
@@ -418,9 +674,10 @@ private:
                                                  PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
                                                  direction);
 
+        Timer timer;
         try {
-            const auto numDeleted = exec->executeDelete();
-            ttlDeletedDocuments.increment(numDeleted);
+            const auto [numDeleted, moreToDelete] = deleteBatches(exec.get());
+            recordDeletes(*task, numDeleted);
 
             const auto duration = Milliseconds(timer.millis());
             if (shouldLogSlowOpWithSampling(opCtx,
@@ -435,9 +692,11 @@ private:
                       "numDeleted"_attr = numDeleted,
                       "duration"_attr = duration);
             }
+            return moreToDelete;
         } catch (const ExceptionFor<ErrorCodes::QueryPlanKilled>&) {
             // It is expected that a collection drop can kill a query plan while the TTL monitor
             // is deleting an old document, so ignore this error.
+            return false;
         }
     }
 
@@ -469,11 +728,14 @@ private:
     /*
      * Removes expired documents from a clustered collection using a bounded collection scan.
      * On time-series buckets collections, TTL operates on type 'ObjectId'. On general purpose
-     * collections, TTL operates on type 'Date'.
+     * collections, TTL operates on type 'Date'. Returns whether 'task' has more documents to
+     * delete.
      */
-    void deleteExpiredWithCollscan(OperationContext* opCtx,
+    bool deleteExpiredWithCollscan(OperationContext* opCtx,
                                    TTLCollectionCache* ttlCollectionCache,
-                                   const CollectionPtr& collection) {
+                                   TTLPassState* pass,
+                                   const CollectionPtr& collection,
+                                   TTLTask* task) {
         const auto& collOptions = collection->getCollectionOptions();
         uassert(5400701,
                 "collection is not clustered but is described as being TTL",
@@ -484,23 +746,44 @@ private:
         if (!expireAfterSeconds) {
             ttlCollectionCache->deregisterTTLInfo(collection->uuid(),
                                                   TTLCollectionCache::ClusteredId{});
-            return;
+            return false;
         }
 
         LOGV2_DEBUG(
             5400704, 1, "running TTL job for clustered collection", logAttrs(collection->ns()));
 
-        const auto startId = makeCollScanStartBound(collection, Date_t::min());
+        if (!task->range) {
+            const auto expirationDate =
+                safeExpirationDate(opCtx, collection, *expireAfterSeconds);
+
+            // Records are clustered by _id, so the first record holds the oldest value.
+            boost::optional<Date_t> oldest;
+            {
+                auto cursor = collection->getCursor(opCtx);
+                auto record = cursor->next();
+                if (record && record->id <= makeCollScanEndBound(collection, expirationDate)) {
+                    auto idElem = record->data.toBson()["_id"];
+                    if (idElem.type() == BSONType::Date) {
+                        oldest = idElem.date();
+                    } else if (idElem.type() == BSONType::jstOID) {
+                        oldest = idElem.OID().asDateT();
+                    }
+                }
+            }
+
+            startTask(pass, task, Date_t::min(), oldest, expirationDate);
+        }
 
-        const auto expirationDate = safeExpirationDate(opCtx, collection, *expireAfterSeconds);
-        const auto endId = makeCollScanEndBound(collection, expirationDate);
+        const auto startId = makeCollScanStartBound(collection, task->range->first);
+        const auto endId = makeCollScanEndBound(collection, task->range->second);
 
+        // Deletes records using a bounded collection scan over the range of the task, from the
+        // beginning of time to the expiration time (inclusive) unless the range was split.
         auto params = std::make_unique<DeleteStageParams>();
         params->isMulti = true;
+        // Returning each deleted document lets the deletes of a turn be counted.
+        params->returnDeleted = true;
 
-        // Deletes records using a bounded collection scan from the beginning of time to the
-        // expiration time (inclusive).
-        Timer timer;
         auto exec =
             InternalPlanner::deleteWithCollectionScan(opCtx,
                                                       &collection,
@@ -510,9 +793,10 @@ private:
                                                       startId,
                                                       endId);
 
+        Timer timer;
         try {
-            const auto numDeleted = exec->executeDelete();
-            ttlDeletedDocuments.increment(numDeleted);
+            const auto [numDeleted, moreToDelete] = deleteBatches(exec.get());
+            recordDeletes(*task, numDeleted);
 
             const auto duration = Milliseconds(timer.millis());
             if (shouldLogSlowOpWithSampling(opCtx,
@@ -526,9 +810,11 @@ private:
                       "numDeleted"_attr = numDeleted,
                       "duration"_attr = duration);
             }
+            return moreToDelete;
         } catch (const ExceptionFor<ErrorCodes::QueryPlanKilled>&) {
             // It is expected that a collection drop can kill a query plan while the TTL monitor
             // is deleting an old document, so ignore this error.
+            return false;
         }
     }
 
@@ -540,8 +826,38 @@ private:
     mutable stdx::condition_variable _shuttingDownCV;
 
     bool _shuttingDown = false;
+
+    // Protects '_stats'.
+    mutable Mutex _statsMutex = MONGO_MAKE_LATCH("TTLMonitor::_statsMutex");
+
+    // The statistics of every TTL index, and clustered collection, by namespace and index name.
+    std::map<TTLStatsKey, TTLIndexStats> _stats;
 };
 
+/**
+ * Reports the TTL statistics of every TTL index, and clustered collection, on request with
+ * db.serverStatus({ttlMonitor: 1}).
+ */
+class TTLMonitorServerStatusSection : public ServerStatusSection {
+public:
+    TTLMonitorServerStatusSection() : ServerStatusSection("ttlMonitor") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        builder.append("workers", ttlMonitorWorkers.load());
+        if (auto ttlMonitor = TTLMonitor::get(opCtx->getServiceContext())) {
+            BSONObjBuilder collectionsBuilder(builder.subobjStart("collections"));
+            ttlMonitor->appendStats(&collectionsBuilder);
+        }
+        return builder.obj();
+    }
+} ttlMonitorServerStatusSection;
+
 void startTTLMonitor(ServiceContext* serviceContext) {
     std::unique_ptr<TTLMonitor> ttlMonitor = std::make_unique<TTLMonitor>();
     ttlMonitor->go();
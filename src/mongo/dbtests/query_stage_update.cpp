@@ -38,6 +38,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_internal.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
@@ -556,6 +557,84 @@ public:
     }
 };
 
+/**
+ * Test that an update written as the damages of its $v:2 delta changes the data size of the
+ * collection and counts towards metrics.query.updateDeltaDamages only when it commits.
+ */
+class QueryStageUpdateDeltaDamages : public QueryStageUpdateBase {
+public:
+    void run() {
+        const std::string padding(10 * 1024, 'p');
+        const std::string newValue = "longer string";
+        insert(BSON("_id" << 0 << "s"
+                          << "x"
+                          << "padding" << padding));
+
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        CollectionPtr coll =
+            CollectionCatalog::get(&_opCtx)->lookupCollectionByNamespace(&_opCtx, nss);
+        ASSERT(coll);
+        const long long dataSizeBefore = coll->dataSize(&_opCtx);
+        const long long countBefore = getDeltaDamagesCount();
+
+        // An update which rolls back leaves both unchanged.
+        {
+            WriteUnitOfWork wuow(&_opCtx);
+            runSetUpdate(coll, BSON("$set" << BSON("s" << newValue)));
+        }
+        ASSERT_EQUALS(dataSizeBefore, coll->dataSize(&_opCtx));
+        ASSERT_EQUALS(countBefore, getDeltaDamagesCount());
+
+        runSetUpdate(coll, BSON("$set" << BSON("s" << newValue)));
+        // The value of 's' grows from "x" to 'newValue'.
+        ASSERT_EQUALS(dataSizeBefore + static_cast<long long>(newValue.size()) - 1,
+                      coll->dataSize(&_opCtx));
+        ASSERT_EQUALS(countBefore + 1, getDeltaDamagesCount());
+
+        vector<BSONObj> objs;
+        getCollContents(coll, &objs);
+        ASSERT_EQUALS(1U, objs.size());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 0 << "s" << newValue << "padding" << padding),
+                          objs[0]);
+    }
+
+private:
+    long long getDeltaDamagesCount() {
+        BSONObjBuilder bob;
+        MetricTree::theMetricTree->appendTo(bob);
+        return bob.obj()["metrics"]["query"]["updateDeltaDamages"].numberLong();
+    }
+
+    /**
+     * Runs the logged update 'updates' of every document in 'coll'.
+     */
+    void runSetUpdate(const CollectionPtr& coll, const BSONObj& updates) {
+        auto request = UpdateRequest();
+        request.setNamespaceString(nss);
+        request.setMulti();
+        request.setQuery(BSONObj());
+        request.setUpdateModification(
+            write_ops::UpdateModification::parseFromClassicUpdate(updates));
+
+        UpdateDriver driver(_expCtx);
+        const std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+        ASSERT_DOES_NOT_THROW(driver.parse(
+            request.getUpdateModification(), arrayFilters, boost::none, request.isMulti()));
+        // The damages are computed from the $v:2 delta which is logged for the update.
+        driver.setLogOp(true);
+
+        CollectionScanParams collScanParams;
+        auto ws = make_unique<WorkingSet>();
+        auto cs = make_unique<CollectionScan>(
+            _expCtx.get(), coll, collScanParams, ws.get(), nullptr);
+
+        UpdateStageParams updateParams(&request, &driver, &CurOp::get(_opCtx)->debug());
+        auto updateStage =
+            make_unique<UpdateStage>(_expCtx.get(), updateParams, ws.get(), coll, cs.release());
+        runUpdate(updateStage.get());
+    }
+};
+
 class All : public OldStyleSuiteSpecification {
 public:
     All() : OldStyleSuiteSpecification("query_stage_update") {}
@@ -566,6 +645,7 @@ public:
         add<QueryStageUpdateSkipDeletedDoc>();
         add<QueryStageUpdateReturnOldDoc>();
         add<QueryStageUpdateReturnNewDoc>();
+        add<QueryStageUpdateDeltaDamages>();
     }
 };
 
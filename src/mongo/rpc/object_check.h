@@ -55,7 +55,25 @@ struct Validator<BSONObj> {
             return Status::OK();
         }
 
-        auto status = validateBSON(ptr, length);
+        return _checkStatus(validateBSON(ptr, length), ptr, length);
+    }
+
+    /**
+     * Like validateLoad, but checks that the buffer holds a sequence of objects which fills it
+     * exactly, in a single pass over the buffer.
+     */
+    inline static Status validateLoadSequence(const char* ptr, size_t length) {
+        if (!serverGlobalParams.objcheck) {
+            return Status::OK();
+        }
+
+        return _checkStatus(validateBSONSequence(ptr, length), ptr, length);
+    }
+
+    static Status validateStore(const BSONObj& toStore);
+
+private:
+    inline static Status _checkStatus(Status status, const char* ptr, size_t length) {
         if (serverGlobalParams.crashOnInvalidBSONError && !status.isOK()) {
             std::string msg = "Invalid BSON was received: " + status.toString() +
                 // Using std::min with length so we do not max anything out in case the corruption
@@ -70,7 +88,5 @@ struct Validator<BSONObj> {
         }
         return status;
     }
-
-    static Status validateStore(const BSONObj& toStore);
 };
 }  // namespace mongo
@@ -184,9 +184,13 @@ OpMsg OpMsg::parse(const Message& message) try {
                         str::stream() << "Duplicate document sequence: " << name,
                         !msg.getSequence(name));  // TODO IDL
 
+                // Validate all the documents of the sequence in one pass before splitting them.
+                uassertStatusOK(Validator<BSONObj>::validateLoadSequence(
+                    static_cast<const char*>(seqBuf.pos()), seqBuf.remaining()));
+
                 msg.sequences.push_back({name.toString()});
                 while (!seqBuf.atEof()) {
-                    msg.sequences.back().objs.push_back(seqBuf.read<Validated<BSONObj>>());
+                    msg.sequences.back().objs.push_back(seqBuf.read<BSONObj>());
                 }
                 break;
             }
@@ -44,6 +44,7 @@
 #include "mongo/s/chunk_writes_tracker.h"
 #include "mongo/s/mongod_and_mongos_server_parameters_gen.h"
 #include "mongo/s/shard_invalidated_for_targeting_exception.h"
+#include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
 namespace {
@@ -126,192 +127,240 @@ void validateChunkIsNotOlderThan(const std::shared_ptr<ChunkInfo>& chunk,
             version.isOlderOrEqualThan(chunk->getLastmod()));
 }
 
+void checkChunksAreAdjacent(const ChunkInfo& prev, const ChunkInfo& next) {
+    if (SimpleBSONObjComparator::kInstance.evaluate(prev.getMax() == next.getMin()))
+        return;
+
+    if (SimpleBSONObjComparator::kInstance.evaluate(prev.getMax() < next.getMin()))
+        uasserted(ErrorCodes::ConflictingOperationInProgress,
+                  str::stream() << "Gap exists in the routing table between chunks "
+                                << prev.getRange().toString() << " and "
+                                << next.getRange().toString());
+    else
+        uasserted(ErrorCodes::ConflictingOperationInProgress,
+                  str::stream() << "Overlap exists in the routing table between chunks "
+                                << prev.getRange().toString() << " and "
+                                << next.getRange().toString());
+}
+
 }  // namespace
 
 ShardVersionMap ChunkMap::constructShardVersionMap() const {
     ShardVersionMap shardVersions;
-    ChunkVector::const_iterator current = _chunkMap.cbegin();
-
-    boost::optional<BSONObj> firstMin = boost::none;
-    boost::optional<BSONObj> lastMax = boost::none;
-
-    while (current != _chunkMap.cend()) {
-        const auto& firstChunkInRange = *current;
-        const auto& currentRangeShardId = firstChunkInRange->getShardIdAt(boost::none);
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(currentRangeShardId);
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt = shardVersions
-                                 .emplace(std::piecewise_construct,
-                                          std::forward_as_tuple(currentRangeShardId),
-                                          std::forward_as_tuple(_collectionVersion.epoch(),
-                                                                _collectionVersion.getTimestamp()))
-                                 .first;
-        }
 
-        auto& maxShardVersion = shardVersionIt->second.shardVersion;
+    for (const auto& [shardId, shardChunks] : _shardChunks) {
+        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
+        // somewhere, which should have been caught at chunk load time
+        invariant(shardChunks.maxVersion.isSet());
+
+        auto shardVersionIt = shardVersions
+                                  .emplace(std::piecewise_construct,
+                                           std::forward_as_tuple(shardId),
+                                           std::forward_as_tuple(_collectionVersion.epoch(),
+                                                                 _collectionVersion.getTimestamp()))
+                                  .first;
+        shardVersionIt->second.shardVersion = shardChunks.maxVersion;
+    }
 
-        current =
-            std::find_if(current,
-                         _chunkMap.cend(),
-                         [&currentRangeShardId, &maxShardVersion](const auto& currentChunk) {
-                             if (currentChunk->getShardIdAt(boost::none) != currentRangeShardId)
-                                 return true;
+    return shardVersions;
+}
 
-                             if (maxShardVersion.isOlderThan(currentChunk->getLastmod()))
-                                 maxShardVersion = currentChunk->getLastmod();
+std::shared_ptr<ChunkInfo> ChunkMap::findIntersectingChunk(const BSONObj& shardKey) const {
+    const auto it = _findIntersectingChunk(shardKey);
 
-                             return false;
-                         });
+    if (it != _chunkTree.end())
+        return it->second;
 
-        const auto rangeLast = *std::prev(current);
+    return std::shared_ptr<ChunkInfo>();
+}
 
-        const auto& rangeMin = firstChunkInRange->getMin();
-        const auto& rangeMax = rangeLast->getMax();
+ChunkMap ChunkMap::createMerged(const ChunkVector& changedChunks) const {
+    // Copying the map is cheap, since the chunk tree is shared until it gets modified.
+    ChunkMap updatedChunkMap(*this);
 
-        // Check the continuity of the chunks map
-        if (lastMax && !SimpleBSONObjComparator::kInstance.evaluate(*lastMax == rangeMin)) {
-            if (SimpleBSONObjComparator::kInstance.evaluate(*lastMax < rangeMin))
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream() << "Gap exists in the routing table between chunks "
-                                        << findIntersectingChunk(*lastMax)->getRange().toString()
-                                        << " and " << rangeLast->getRange().toString());
-            else
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream() << "Overlap exists in the routing table between chunks "
-                                        << findIntersectingChunk(*lastMax)->getRange().toString()
-                                        << " and " << rangeLast->getRange().toString());
-        }
+    if (_chunkTree.empty()) {
+        updatedChunkMap._buildFrom(changedChunks);
+    } else {
+        updatedChunkMap._mergeFrom(changedChunks);
+    }
+
+    return updatedChunkMap;
+}
 
-        if (!firstMin)
-            firstMin = rangeMin;
+BSONObj ChunkMap::toBSON() const {
+    BSONObjBuilder builder;
 
-        lastMax = rangeMax;
+    getVersion().serializeToBSON("startingVersion"_sd, &builder);
+    builder.append("chunkCount", static_cast<int64_t>(_chunkTree.size()));
 
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
+    {
+        BSONArrayBuilder arrayBuilder(builder.subarrayStart("chunks"_sd));
+        for (auto it = _chunkTree.begin(); it != _chunkTree.end(); ++it) {
+            arrayBuilder.append(it->second->toString());
+        }
     }
 
-    if (!_chunkMap.empty()) {
-        invariant(!shardVersions.empty());
-        invariant(firstMin.is_initialized());
-        invariant(lastMax.is_initialized());
+    return builder.obj();
+}
 
-        checkAllElementsAreOfType(MinKey, firstMin.get());
-        checkAllElementsAreOfType(MaxKey, lastMax.get());
-    }
+ChunkMap::ChunkTree::const_iterator ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
+                                                                     bool isMaxInclusive) const {
+    const auto shardKeyString = ShardKeyPattern::toKeyString(shardKey);
 
-    return shardVersions;
+    return isMaxInclusive ? _chunkTree.upper_bound(shardKeyString)
+                          : _chunkTree.lower_bound(shardKeyString);
 }
 
-void ChunkMap::appendChunk(const std::shared_ptr<ChunkInfo>& chunk) {
-    appendChunkTo(_chunkMap, chunk);
-    const auto chunkVersion = chunk->getLastmod();
-    if (_collectionVersion.isOlderThan(chunkVersion)) {
-        _collectionVersion = ChunkVersion(chunkVersion.majorVersion(),
-                                          chunkVersion.minorVersion(),
-                                          chunkVersion.epoch(),
-                                          _collTimestamp);
+std::pair<ChunkMap::ChunkTree::const_iterator, ChunkMap::ChunkTree::const_iterator>
+ChunkMap::_overlappingBounds(
+    const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
+    auto itMin = _findIntersectingChunk(min);
+    auto itMax = _findIntersectingChunk(max, isMaxInclusive);
+    if (itMax != _chunkTree.end()) {
+        ++itMax;
     }
+
+    return {std::move(itMin), std::move(itMax)};
 }
 
-std::shared_ptr<ChunkInfo> ChunkMap::findIntersectingChunk(const BSONObj& shardKey) const {
-    const auto it = _findIntersectingChunk(shardKey);
+void ChunkMap::_buildFrom(const ChunkVector& chunks) {
+    const auto baseVersion = getVersion();
 
-    if (it != _chunkMap.end())
-        return *it;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const auto& chunk = chunks[i];
+        validateChunkIsNotOlderThan(chunk, baseVersion);
 
-    return std::shared_ptr<ChunkInfo>();
+        // Check the continuity of the chunks map
+        if (i > 0) {
+            checkChunksAreAdjacent(*chunks[i - 1], *chunk);
+        }
+
+        _addChunkToShard(*chunk);
+        _bumpCollectionVersion(chunk->getLastmod());
+    }
+
+    if (!chunks.empty()) {
+        checkAllElementsAreOfType(MinKey, chunks.front()->getMin());
+        checkAllElementsAreOfType(MaxKey, chunks.back()->getMax());
+    }
+
+    std::vector<std::pair<StringData, std::shared_ptr<ChunkInfo>>> entries;
+    entries.reserve(chunks.size());
+    for (const auto& chunk : chunks) {
+        entries.emplace_back(chunk->getMaxKeyString(), chunk);
+    }
+    _chunkTree = ChunkTree(boost::container::ordered_unique_range, entries.begin(), entries.end());
 }
 
-ChunkMap ChunkMap::createMerged(
-    const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) const {
-    size_t chunkMapIndex = 0;
-    size_t changedChunkIndex = 0;
+void ChunkMap::_mergeFrom(const ChunkVector& changedChunks) {
+    const auto baseVersion = getVersion();
 
-    ChunkMap updatedChunkMap(
-        getVersion().epoch(), getVersion().getTimestamp(), _chunkMap.size() + changedChunks.size());
+    // Shards which lost the chunk carrying their max version without receiving a newer one.
+    stdx::unordered_set<ShardId, ShardId::Hasher> shardsToRecompute;
 
-    while (chunkMapIndex < _chunkMap.size() || changedChunkIndex < changedChunks.size()) {
-        if (chunkMapIndex >= _chunkMap.size()) {
-            validateChunkIsNotOlderThan(changedChunks[changedChunkIndex], getVersion());
-            updatedChunkMap.appendChunk(changedChunks[changedChunkIndex++]);
-            continue;
+    for (const auto& changedChunk : changedChunks) {
+        validateChunkIsNotOlderThan(changedChunk, baseVersion);
+
+        ChunkVector replacedChunks;
+        for (auto it = _chunkTree.upper_bound(ShardKeyPattern::toKeyString(changedChunk->getMin()));
+             it != _chunkTree.end() && it->second->getRange().overlaps(changedChunk->getRange());
+             ++it) {
+            replacedChunks.push_back(it->second);
         }
 
-        if (changedChunkIndex >= changedChunks.size()) {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
-            continue;
+        if (!replacedChunks.empty()) {
+            auto bytesInReplacedChunk =
+                replacedChunks.front()->getWritesTracker()->getBytesWritten();
+            changedChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
         }
 
-        auto overlap = _chunkMap[chunkMapIndex]->getRange().overlaps(
-            changedChunks[changedChunkIndex]->getRange());
+        for (const auto& replacedChunk : replacedChunks) {
+            _chunkTree = _chunkTree.erase(replacedChunk->getMaxKeyString());
 
-        if (overlap) {
-            auto& changedChunk = changedChunks[changedChunkIndex++];
-            auto& chunkInfo = _chunkMap[chunkMapIndex];
+            const auto& shardId = replacedChunk->getShardIdAt(boost::none);
+            auto shardChunksIt = _shardChunks.find(shardId);
+            invariant(shardChunksIt != _shardChunks.end());
 
-            auto bytesInReplacedChunk = chunkInfo->getWritesTracker()->getBytesWritten();
-            changedChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
+            if (--shardChunksIt->second.numChunks == 0) {
+                shardsToRecompute.erase(shardId);
+                _shardChunks.erase(shardChunksIt);
+            } else if (!replacedChunk->getLastmod().isOlderThan(
+                           shardChunksIt->second.maxVersion)) {
+                shardsToRecompute.insert(shardId);
+            }
+        }
 
-            validateChunkIsNotOlderThan(changedChunk, getVersion());
-            updatedChunkMap.appendChunk(changedChunk);
+        // The changed chunk is at least as new as every chunk already in the map, so it carries
+        // the max version of the shard it belongs to.
+        _chunkTree = _chunkTree.set(changedChunk->getMaxKeyString(), changedChunk);
+        _addChunkToShard(*changedChunk);
+        shardsToRecompute.erase(changedChunk->getShardIdAt(boost::none));
+
+        _bumpCollectionVersion(changedChunk->getLastmod());
+    }
+
+    // Only the chunks around the changed ones can have become discontiguous.
+    for (const auto& changedChunk : changedChunks) {
+        auto prevIt = _chunkTree.lower_bound(ShardKeyPattern::toKeyString(changedChunk->getMin()));
+        invariant(prevIt != _chunkTree.end());
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Gap exists in the routing table before chunk "
+                              << changedChunk->getRange().toString(),
+                prevIt->second != changedChunk ||
+                    allElementsAreOfType(MinKey, changedChunk->getMin()));
+
+        auto nextIt = _chunkTree.upper_bound(changedChunk->getMaxKeyString());
+        if (nextIt == _chunkTree.end()) {
+            checkAllElementsAreOfType(MaxKey, changedChunk->getMax());
         } else {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
+            checkChunksAreAdjacent(*changedChunk, *nextIt->second);
         }
     }
 
-    return updatedChunkMap;
-}
-
-BSONObj ChunkMap::toBSON() const {
-    BSONObjBuilder builder;
-
-    getVersion().serializeToBSON("startingVersion"_sd, &builder);
-    builder.append("chunkCount", static_cast<int64_t>(_chunkMap.size()));
+    // Recomputing the max version of a shard requires a scan of the entire map. This does not
+    // happen for the common refreshes caused by migrations, splits and merges, because those
+    // always bump the version of a chunk which remains on the shards they affect.
+    if (!shardsToRecompute.empty()) {
+        for (const auto& shardId : shardsToRecompute) {
+            _shardChunks[shardId].maxVersion =
+                ChunkVersion(0, 0, _collectionVersion.epoch(), _collectionVersion.getTimestamp());
+        }
 
-    {
-        BSONArrayBuilder arrayBuilder(builder.subarrayStart("chunks"_sd));
-        for (const auto& chunk : _chunkMap) {
-            arrayBuilder.append(chunk->toString());
+        for (auto it = _chunkTree.begin(); it != _chunkTree.end(); ++it) {
+            const auto& chunk = it->second;
+            const auto& shardId = chunk->getShardIdAt(boost::none);
+            if (shardsToRecompute.count(shardId)) {
+                auto& maxVersion = _shardChunks[shardId].maxVersion;
+                if (maxVersion.isOlderThan(chunk->getLastmod()))
+                    maxVersion = chunk->getLastmod();
+            }
         }
     }
-
-    return builder.obj();
 }
 
-ChunkMap::ChunkVector::const_iterator ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
-                                                                       bool isMaxInclusive) const {
-    auto shardKeyString = ShardKeyPattern::toKeyString(shardKey);
+void ChunkMap::_addChunkToShard(const ChunkInfo& chunk) {
+    const auto& shardId = chunk.getShardIdAt(boost::none);
 
-    if (!isMaxInclusive) {
-        return std::lower_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const auto& chunkInfo, const BSONObj& shardKey) {
-                                    return chunkInfo->getMaxKeyString() < shardKeyString;
-                                });
-    } else {
-        return std::upper_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const BSONObj& shardKey, const auto& chunkInfo) {
-                                    return shardKeyString < chunkInfo->getMaxKeyString();
-                                });
+    auto it = _shardChunks.find(shardId);
+    if (it == _shardChunks.end()) {
+        ShardChunks shardChunks;
+        shardChunks.maxVersion =
+            ChunkVersion(0, 0, _collectionVersion.epoch(), _collectionVersion.getTimestamp());
+        it = _shardChunks.emplace(shardId, std::move(shardChunks)).first;
     }
-}
 
-std::pair<ChunkMap::ChunkVector::const_iterator, ChunkMap::ChunkVector::const_iterator>
-ChunkMap::_overlappingBounds(const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
-    const auto itMin = _findIntersectingChunk(min);
-    const auto itMax = [&]() {
-        auto it = _findIntersectingChunk(max, isMaxInclusive);
-        return it == _chunkMap.end() ? it : ++it;
-    }();
+    ++it->second.numChunks;
+    if (it->second.maxVersion.isOlderThan(chunk.getLastmod()))
+        it->second.maxVersion = chunk.getLastmod();
+}
 
-    return {itMin, itMax};
+void ChunkMap::_bumpCollectionVersion(const ChunkVersion& chunkVersion) {
+    if (_collectionVersion.isOlderThan(chunkVersion)) {
+        _collectionVersion = ChunkVersion(chunkVersion.majorVersion(),
+                                          chunkVersion.minorVersion(),
+                                          chunkVersion.epoch(),
+                                          _collTimestamp);
+    }
 }
 
 ShardVersionTargetingInfo::ShardVersionTargetingInfo(const OID& epoch, const Timestamp& timestamp)
@@ -44,6 +44,7 @@
 #include "mongo/s/type_collection_common_types_gen.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/immutable_map.h"
 #include "mongo/util/read_through_cache.h"
 
 namespace mongo {
@@ -75,14 +76,24 @@ class ChunkMap {
     // Vector of chunks ordered by max key.
     using ChunkVector = std::vector<std::shared_ptr<ChunkInfo>>;
 
+    // Chunks keyed by the KeyString of their max bound, which is owned by the chunk itself. Copies
+    // of the tree share all their nodes, and modifying a copy only copies the path to the affected
+    // leaf, so merging k changed chunks into the map costs O(k * log(n)).
+    using ChunkTree = immutable::map<StringData, std::shared_ptr<ChunkInfo>>;
+
+    // Number of chunks and max chunk version of a single shard.
+    struct ShardChunks {
+        size_t numChunks{0};
+        ChunkVersion maxVersion;
+    };
+    using ShardChunksMap = stdx::unordered_map<ShardId, ShardChunks, ShardId::Hasher>;
+
 public:
-    explicit ChunkMap(OID epoch, const Timestamp& timestamp, size_t initialCapacity = 0)
-        : _collectionVersion(0, 0, epoch, timestamp), _collTimestamp(timestamp) {
-        _chunkMap.reserve(initialCapacity);
-    }
+    explicit ChunkMap(OID epoch, const Timestamp& timestamp)
+        : _collectionVersion(0, 0, epoch, timestamp), _collTimestamp(timestamp) {}
 
     size_t size() const {
-        return _chunkMap.size();
+        return _chunkTree.size();
     }
 
     ChunkVersion getVersion() const {
@@ -91,10 +102,10 @@ public:
 
     template <typename Callable>
     void forEach(Callable&& handler, const BSONObj& shardKey = BSONObj()) const {
-        auto it = shardKey.isEmpty() ? _chunkMap.begin() : _findIntersectingChunk(shardKey);
+        auto it = shardKey.isEmpty() ? _chunkTree.begin() : _findIntersectingChunk(shardKey);
 
-        for (; it != _chunkMap.end(); ++it) {
-            if (!handler(*it))
+        for (; it != _chunkTree.end(); ++it) {
+            if (!handler(it->second))
                 break;
         }
     }
@@ -107,27 +118,51 @@ public:
         const auto bounds = _overlappingBounds(min, max, isMaxInclusive);
 
         for (auto it = bounds.first; it != bounds.second; ++it) {
-            if (!handler(*it))
+            if (!handler(it->second))
                 break;
         }
     }
 
+    /**
+     * Builds the per-shard versions out of the per-shard chunk statistics maintained by this map,
+     * in O(number of shards).
+     */
     ShardVersionMap constructShardVersionMap() const;
     std::shared_ptr<ChunkInfo> findIntersectingChunk(const BSONObj& shardKey) const;
 
-    void appendChunk(const std::shared_ptr<ChunkInfo>& chunk);
-
-    ChunkMap createMerged(const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) const;
+    /**
+     * Returns a map with 'changedChunks', which must be ordered by max key and must not overlap,
+     * replacing the chunks they overlap with. Shares all the unchanged parts of this map, so the
+     * cost is O(changedChunks.size() * log(size())), except for the first load of the map, which
+     * is O(n). Throws ConflictingOperationInProgress if the result would not cover the entire
+     * shard key space exactly once.
+     */
+    ChunkMap createMerged(const ChunkVector& changedChunks) const;
 
     BSONObj toBSON() const;
 
 private:
-    ChunkVector::const_iterator _findIntersectingChunk(const BSONObj& shardKey,
-                                                       bool isMaxInclusive = true) const;
-    std::pair<ChunkVector::const_iterator, ChunkVector::const_iterator> _overlappingBounds(
+    ChunkTree::const_iterator _findIntersectingChunk(const BSONObj& shardKey,
+                                                     bool isMaxInclusive = true) const;
+    std::pair<ChunkTree::const_iterator, ChunkTree::const_iterator> _overlappingBounds(
         const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
 
-    ChunkVector _chunkMap;
+    // Builds the map from scratch out of 'chunks', validating its continuity along the way.
+    void _buildFrom(const ChunkVector& chunks);
+
+    // Incrementally applies 'changedChunks' to the map, only validating the continuity of the map
+    // around the changed chunks.
+    void _mergeFrom(const ChunkVector& changedChunks);
+
+    void _addChunkToShard(const ChunkInfo& chunk);
+
+    void _bumpCollectionVersion(const ChunkVersion& chunkVersion);
+
+    ChunkTree _chunkTree;
+
+    // Number of chunks and max chunk version of every shard which owns chunks, maintained
+    // incrementally so that refreshes do not need to scan the entire map.
+    ShardChunksMap _shardChunks;
 
     // Max version across all chunks
     ChunkVersion _collectionVersion;
@@ -152,7 +152,46 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
 BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
     ->Args({2, 50000})
     ->Args({2, 250000})
-    ->Args({2, 500000});
+    ->Args({2, 500000})
+    ->Args({2, 1000000})
+    ->Args({10, 2000000});
+
+/**
+ * Measures a refresh which moves 'nChanged' chunks spread evenly across the key space to a
+ * different shard, which is the shape of the refreshes that follow a round of balancing.
+ */
+void BM_IncrementalRefreshWithManyChangedChunks(benchmark::State& state) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    const int nChanged = state.range(2);
+    auto metadata = makeChunkManagerWithOptimalBalancedDistribution(nShards, nChunks);
+
+    auto postMoveVersion = metadata.getChunkManager()->getVersion();
+    const UUID uuid = metadata.getUUID();
+    std::vector<ChunkType> newChunks;
+    newChunks.reserve(nChanged);
+    for (int i = 0; i < nChanged; ++i) {
+        postMoveVersion.incMajor();
+        const int chunkIndex = 1 + int64_t(i) * (nChunks - 2) / nChanged;
+        newChunks.emplace_back(uuid,
+                               getRangeForChunk(chunkIndex, nChunks),
+                               postMoveVersion,
+                               ShardId(str::stream() << "shard" << (i % nShards)));
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(runIncrementalUpdate(metadata, newChunks));
+    }
+
+    state.SetItemsProcessed(state.iterations() * nChanged);
+}
+
+BENCHMARK(BM_IncrementalRefreshWithManyChangedChunks)
+    ->Args({10, 1000000, 1})
+    ->Args({10, 1000000, 100})
+    ->Args({10, 1000000, 10000})
+    ->Args({100, 2000000, 100})
+    ->Args({100, 2000000, 10000});
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
@@ -49,6 +49,40 @@ public:
         return _uuid;
     }
 
+    std::shared_ptr<ChunkInfo> makeChunk(const BSONObj& min,
+                                         const BSONObj& max,
+                                         const ChunkVersion& version,
+                                         const ShardId& shardId) const {
+        return std::make_shared<ChunkInfo>(
+            ChunkType{_uuid, ChunkRange{min, max}, version, shardId});
+    }
+
+    /**
+     * Returns the bounds of the i-th of 'nChunks' contiguous chunks covering the whole key space.
+     */
+    BSONObj chunkMin(int i) const {
+        return i == 0 ? _shardKeyPattern.globalMin() : BSON("a" << i * 10);
+    }
+
+    BSONObj chunkMax(int i, int nChunks) const {
+        return i + 1 == nChunks ? _shardKeyPattern.globalMax() : BSON("a" << (i + 1) * 10);
+    }
+
+    /**
+     * Builds a map of 'nChunks' chunks distributed round-robin over 'shards', with chunk i at
+     * version i + 1.
+     */
+    ChunkMap makeChunkMap(const OID& epoch, int nChunks, const std::vector<ShardId>& shards) const {
+        std::vector<std::shared_ptr<ChunkInfo>> chunks;
+        for (int i = 0; i < nChunks; ++i) {
+            chunks.push_back(makeChunk(chunkMin(i),
+                                       chunkMax(i, nChunks),
+                                       ChunkVersion(i + 1, 0, epoch, Timestamp(1, 1)),
+                                       shards[i % shards.size()]));
+        }
+        return ChunkMap{epoch, Timestamp(1, 1)}.createMerged(chunks);
+    }
+
 private:
     KeyPattern _shardKeyPattern{BSON("a" << 1)};
     const UUID _uuid = UUID::gen();
@@ -170,4 +204,129 @@ TEST_F(ChunkMapTest, TestEnumerateOverlappingChunks) {
     ASSERT_EQ(count, 3);
 }
 
+TEST_F(ChunkMapTest, TestIncrementalSplitDoesNotAffectOriginalMap) {
+    const OID epoch = OID::gen();
+    const ShardId shard0("shard0"), shard1("shard1");
+    const int nChunks = 1000;
+    auto chunkMap = makeChunkMap(epoch, nChunks, {shard0, shard1});
+    ASSERT_EQ(chunkMap.size(), nChunks);
+
+    // Split chunk 500, which lives on shard0, in two halves.
+    auto version = chunkMap.getVersion();
+    version.incMajor();
+    auto lowerHalf = makeChunk(chunkMin(500), BSON("a" << 5005), version, shard0);
+    version.incMinor();
+    auto upperHalf = makeChunk(BSON("a" << 5005), chunkMax(500, nChunks), version, shard0);
+
+    auto splitChunkMap = chunkMap.createMerged({lowerHalf, upperHalf});
+    ASSERT_EQ(splitChunkMap.size(), nChunks + 1);
+    ASSERT_EQ(splitChunkMap.getVersion(), version);
+    ASSERT_EQ(splitChunkMap.findIntersectingChunk(BSON("a" << 5001)), lowerHalf);
+    ASSERT_EQ(splitChunkMap.findIntersectingChunk(BSON("a" << 5005)), upperHalf);
+
+    // The original map is left untouched.
+    ASSERT_EQ(chunkMap.size(), nChunks);
+    auto originalChunk = chunkMap.findIntersectingChunk(BSON("a" << 5001));
+    ASSERT_BSONOBJ_EQ(originalChunk->getMin(), chunkMin(500));
+    ASSERT_BSONOBJ_EQ(originalChunk->getMax(), chunkMax(500, nChunks));
+
+    int count = 0;
+    auto lastMax = getShardKeyPattern().globalMin();
+    splitChunkMap.forEach([&](const auto& chunkInfo) {
+        ASSERT_BSONOBJ_EQ(chunkInfo->getMin(), lastMax);
+        lastMax = chunkInfo->getMax();
+        count++;
+        return true;
+    });
+    ASSERT_EQ(count, nChunks + 1);
+    ASSERT_BSONOBJ_EQ(lastMax, getShardKeyPattern().globalMax());
+
+    auto shardVersions = splitChunkMap.constructShardVersionMap();
+    ASSERT_EQ(shardVersions.size(), 2);
+    ASSERT_EQ(shardVersions.at(shard0).shardVersion, version);
+}
+
+TEST_F(ChunkMapTest, TestIncrementalMergeOfManyChunks) {
+    const OID epoch = OID::gen();
+    const ShardId shard0("shard0");
+    const int nChunks = 1000;
+    auto chunkMap = makeChunkMap(epoch, nChunks, {shard0});
+
+    auto version = chunkMap.getVersion();
+    version.incMajor();
+    auto mergedChunk = makeChunk(chunkMin(100), chunkMax(899, nChunks), version, shard0);
+
+    auto mergedChunkMap = chunkMap.createMerged({mergedChunk});
+    ASSERT_EQ(mergedChunkMap.size(), nChunks - 799);
+    ASSERT_EQ(mergedChunkMap.findIntersectingChunk(BSON("a" << 1000)), mergedChunk);
+    ASSERT_EQ(mergedChunkMap.findIntersectingChunk(BSON("a" << 8999)), mergedChunk);
+    ASSERT_BSONOBJ_EQ(mergedChunkMap.findIntersectingChunk(BSON("a" << 9000))->getMin(),
+                      chunkMin(900));
+
+    int count = 0;
+    mergedChunkMap.forEachOverlappingChunk(
+        BSON("a" << 995), BSON("a" << 9005), true, [&](const auto& chunk) {
+            count++;
+            return true;
+        });
+    ASSERT_EQ(count, 3);
+}
+
+TEST_F(ChunkMapTest, TestIncrementalMoveRecomputesDonorShardVersion) {
+    const OID epoch = OID::gen();
+    const ShardId shard0("shard0"), shard1("shard1");
+    const int nChunks = 100;
+    auto chunkMap = makeChunkMap(epoch, nChunks, {shard0, shard1});
+
+    // The last chunk, which carries the max version of shard1, moves to shard0 without shard1
+    // getting a newer chunk, so the version of shard1 falls back to that of its next newest chunk.
+    auto version = chunkMap.getVersion();
+    version.incMajor();
+    auto movedChunk =
+        makeChunk(chunkMin(nChunks - 1), chunkMax(nChunks - 1, nChunks), version, shard0);
+
+    auto movedChunkMap = chunkMap.createMerged({movedChunk});
+    ASSERT_EQ(movedChunkMap.size(), nChunks);
+
+    auto shardVersions = movedChunkMap.constructShardVersionMap();
+    ASSERT_EQ(shardVersions.size(), 2);
+    ASSERT_EQ(shardVersions.at(shard0).shardVersion, version);
+    ASSERT_EQ(shardVersions.at(shard1).shardVersion,
+              ChunkVersion(nChunks - 2, 0, epoch, Timestamp(1, 1)));
+}
+
+TEST_F(ChunkMapTest, TestIncrementalMoveOfLastChunkRemovesShard) {
+    const OID epoch = OID::gen();
+    const ShardId shard0("shard0"), shard1("shard1");
+    auto chunkMap = makeChunkMap(epoch, 2, {shard0, shard1});
+
+    auto version = chunkMap.getVersion();
+    version.incMajor();
+    auto movedChunkMap =
+        chunkMap.createMerged({makeChunk(chunkMin(1), chunkMax(1, 2), version, shard0)});
+
+    auto shardVersions = movedChunkMap.constructShardVersionMap();
+    ASSERT_EQ(shardVersions.size(), 1);
+    ASSERT_EQ(shardVersions.at(shard0).shardVersion, version);
+}
+
+TEST_F(ChunkMapTest, TestIncrementalMergeDetectsGap) {
+    const OID epoch = OID::gen();
+    const ShardId shard0("shard0");
+    const int nChunks = 100;
+    auto chunkMap = makeChunkMap(epoch, nChunks, {shard0});
+
+    // Replacing chunk 50 with a chunk covering only part of its range leaves a gap.
+    auto version = chunkMap.getVersion();
+    version.incMajor();
+    ASSERT_THROWS_CODE(
+        chunkMap.createMerged({makeChunk(chunkMin(50), BSON("a" << 505), version, shard0)}),
+        DBException,
+        ErrorCodes::ConflictingOperationInProgress);
+    ASSERT_THROWS_CODE(chunkMap.createMerged(
+                           {makeChunk(BSON("a" << 505), chunkMax(50, nChunks), version, shard0)}),
+                       DBException,
+                       ErrorCodes::ConflictingOperationInProgress);
+}
+
 }  // namespace mongo
@@ -120,6 +120,7 @@
 #include "mongo/util/periodic_runner_factory.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/quick_exit.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/signal_handlers.h"
 #include "mongo/util/stacktrace.h"
 #include "mongo/util/str.h"
@@ -731,6 +732,8 @@ ExitCode runMongosServer(ServiceContext* serviceContext) {
 
     startMongoSFTDC();
 
+    SamplingProfiler::get().startup();
+
     if (mongosGlobalParams.scriptingEnabled) {
         ScriptEngine::setup();
     }
@@ -42,6 +42,7 @@
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/query/kill_cursors_gen.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/operation_phase_timeline.h"
 #include "mongo/db/traffic_recorder.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/atomic_word.h"
@@ -309,7 +310,12 @@ void ServiceStateMachine::Impl::sinkMessage() {
     //
     // Otherwise, update the current state depending on whether we're in exhaust or not and return
     // from this function to let startNewLoop() continue the future chaining of state transitions.
-    if (auto status = session()->sinkMessage(std::exchange(_outMessage, {})); !status.isOK()) {
+    // The operation has already been reported by the time its reply is sent, so the send is only
+    // recorded in the server-wide phase histograms.
+    OperationPhaseTimer phaseTimer(_serviceContext, nullptr, OperationPhase::kNetworkSend);
+    auto status = session()->sinkMessage(std::exchange(_outMessage, {}));
+    phaseTimer.stop();
+    if (!status.isOK()) {
         LOGV2(22989,
               "Error sending response to client. Ending connection from remote",
               "error"_attr = status,
@@ -0,0 +1,510 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/container/container_fwd.hpp>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo::immutable {
+
+/**
+ * Persistent ordered map. Instances are immutable: set() and erase() return a new map and leave
+ * the original untouched. Both maps share all the parts of their structure that were not affected
+ * by the modification, which makes copying a map O(1) and modifying it O(log n).
+ *
+ * The map is a B+tree whose nodes are never modified once published. Entries are individually
+ * reference counted, so that copying the path to a modified leaf does not copy keys or values.
+ * Keys which are cheap to copy, such as StringData, are also stored by value in the nodes, so that
+ * searches are binary searches over contiguous keys which never dereference the entries.
+ *
+ * Iterators, and pointers returned by find(), remain valid as long as any map sharing the entry
+ * they refer to is alive.
+ */
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class map {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+
+    // Maximum number of entries in any node of the tree.
+    static constexpr size_t kMaxNodeSize = 32;
+
+    // Nodes which drop below this number of entries after an erase are merged with a sibling.
+    static constexpr size_t kMinNodeSize = kMaxNodeSize / 4;
+
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+    using MutableNodePtr = std::shared_ptr<Node>;
+    using EntryPtr = std::shared_ptr<const value_type>;
+
+    static constexpr bool kInlineKeys =
+        std::is_trivially_copyable_v<Key> && sizeof(Key) <= 2 * sizeof(void*);
+    using KeySlot = std::conditional_t<kInlineKeys, Key, const Key*>;
+
+    static KeySlot _slotOf(const Key& key) {
+        if constexpr (kInlineKeys) {
+            return key;
+        } else {
+            return &key;
+        }
+    }
+
+    static const Key& _keyOf(const KeySlot& slot) {
+        if constexpr (kInlineKeys) {
+            return slot;
+        } else {
+            return *slot;
+        }
+    }
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        reference operator*() const {
+            const auto& frame = _path.back();
+            return *frame.node->entries[frame.index];
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++() {
+            ++_path.back().index;
+            while (_path.back().index == _path.back().node->keys.size()) {
+                _path.pop_back();
+                if (_path.empty()) {
+                    return *this;
+                }
+                ++_path.back().index;
+            }
+            _descendToLeftmostLeaf();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            if (_path.empty() || other._path.empty()) {
+                return _path.empty() && other._path.empty();
+            }
+            return _path.back().node == other._path.back().node &&
+                _path.back().index == other._path.back().index;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class map;
+
+        struct Frame {
+            const Node* node;
+            size_t index;
+        };
+
+        void _descendToLeftmostLeaf() {
+            while (!_path.back().node->isLeaf) {
+                const Node* child = _path.back().node->children[_path.back().index].get();
+                _path.push_back({child, 0});
+            }
+        }
+
+        // Path from the root to the current leaf entry. Empty for the end iterator.
+        std::vector<Frame> _path;
+    };
+
+    using iterator = const_iterator;
+
+    map() = default;
+
+    /**
+     * Builds a map out of the entries in ['first', 'last'), which must be sorted by key and must
+     * not contain duplicate keys, in O(n).
+     */
+    template <typename InputIt>
+    map(boost::container::ordered_unique_range_t, InputIt first, InputIt last) {
+        // Leave some room in the nodes so that the first few inserts do not immediately split them.
+        constexpr size_t kBuildNodeSize = kMaxNodeSize * 3 / 4;
+
+        std::vector<NodePtr> level;
+        MutableNodePtr leaf;
+        for (; first != last; ++first) {
+            if (!leaf) {
+                leaf = std::make_shared<Node>(true /* isLeaf */);
+            }
+            auto entry = std::make_shared<const value_type>(*first);
+            dassert(leaf->keys.empty() || Compare()(_keyOf(leaf->keys.back()), entry->first));
+            leaf->insertEntry(leaf->keys.size(), std::move(entry));
+            ++_size;
+            if (leaf->keys.size() == kBuildNodeSize) {
+                level.push_back(std::move(leaf));
+            }
+        }
+        if (leaf) {
+            level.push_back(std::move(leaf));
+        }
+        if (level.empty()) {
+            return;
+        }
+
+        while (level.size() > 1) {
+            std::vector<NodePtr> parents;
+            for (size_t begin = 0; begin < level.size(); begin += kBuildNodeSize) {
+                auto parent = std::make_shared<Node>(false /* isLeaf */);
+                const auto end = std::min(begin + kBuildNodeSize, level.size());
+                for (size_t i = begin; i < end; ++i) {
+                    parent->insertChild(parent->keys.size(), std::move(level[i]));
+                }
+                parents.push_back(std::move(parent));
+            }
+            level = std::move(parents);
+        }
+        _root = std::move(level.front());
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    const_iterator begin() const {
+        const_iterator it;
+        if (_root) {
+            it._path.push_back({_root.get(), 0});
+            it._descendToLeftmostLeaf();
+        }
+        return it;
+    }
+
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+    /**
+     * Returns an iterator to the first entry whose key is not less than 'key'.
+     */
+    const_iterator lower_bound(const Key& key) const {
+        return _seek<false>(key);
+    }
+
+    /**
+     * Returns an iterator to the first entry whose key is greater than 'key'.
+     */
+    const_iterator upper_bound(const Key& key) const {
+        return _seek<true>(key);
+    }
+
+    /**
+     * Returns a pointer to the value mapped to 'key', or nullptr if there is none.
+     */
+    const Value* find(const Key& key) const {
+        auto it = lower_bound(key);
+        if (it == end() || Compare()(key, it->first)) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    bool contains(const Key& key) const {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * Returns a map in which 'key' is mapped to 'value', replacing any previous mapping.
+     */
+    [[nodiscard]] map set(Key key, Value value) const {
+        auto entry = std::make_shared<const value_type>(std::move(key), std::move(value));
+
+        map result;
+        if (!_root) {
+            auto leaf = std::make_shared<Node>(true /* isLeaf */);
+            leaf->insertEntry(0, std::move(entry));
+            result._root = std::move(leaf);
+            result._size = 1;
+            return result;
+        }
+
+        bool inserted = false;
+        auto [lower, upper] = Node::set(*_root, std::move(entry), &inserted);
+        if (upper) {
+            auto root = std::make_shared<Node>(false /* isLeaf */);
+            root->insertChild(0, std::move(lower));
+            root->insertChild(1, std::move(upper));
+            result._root = std::move(root);
+        } else {
+            result._root = std::move(lower);
+        }
+        result._size = _size + (inserted ? 1 : 0);
+        return result;
+    }
+
+    /**
+     * Returns a map without any mapping for 'key'.
+     */
+    [[nodiscard]] map erase(const Key& key) const {
+        if (!contains(key)) {
+            return *this;
+        }
+
+        NodePtr root = Node::erase(*_root, key);
+        while (!root->isLeaf && root->keys.size() == 1) {
+            root = root->children.front();
+        }
+
+        map result;
+        result._root = root->keys.empty() ? nullptr : std::move(root);
+        result._size = _size - 1;
+        return result;
+    }
+
+private:
+    /**
+     * Leaves hold entries and inner nodes hold children. Both hold in 'keys' the key of every entry
+     * (for an inner node, the greatest key in the child's subtree). Unless the keys are stored
+     * inline, these are pointers to keys which live in entries owned by the node's subtree.
+     */
+    struct Node {
+        explicit Node(bool isLeaf) : isLeaf(isLeaf) {}
+
+        size_t lowerBound(const Key& key) const {
+            return std::lower_bound(keys.begin(),
+                                    keys.end(),
+                                    key,
+                                    [](const KeySlot& lhs, const Key& rhs) {
+                                        return Compare()(_keyOf(lhs), rhs);
+                                    }) -
+                keys.begin();
+        }
+
+        size_t upperBound(const Key& key) const {
+            return std::upper_bound(keys.begin(),
+                                    keys.end(),
+                                    key,
+                                    [](const Key& lhs, const KeySlot& rhs) {
+                                        return Compare()(lhs, _keyOf(rhs));
+                                    }) -
+                keys.begin();
+        }
+
+        void insertEntry(size_t pos, EntryPtr entry) {
+            keys.insert(keys.begin() + pos, _slotOf(entry->first));
+            entries.insert(entries.begin() + pos, std::move(entry));
+        }
+
+        void setChild(size_t pos, NodePtr child) {
+            keys[pos] = child->keys.back();
+            children[pos] = std::move(child);
+        }
+
+        void insertChild(size_t pos, NodePtr child) {
+            keys.insert(keys.begin() + pos, child->keys.back());
+            children.insert(children.begin() + pos, std::move(child));
+        }
+
+        void eraseAt(size_t pos) {
+            keys.erase(keys.begin() + pos);
+            if (isLeaf) {
+                entries.erase(entries.begin() + pos);
+            } else {
+                children.erase(children.begin() + pos);
+            }
+        }
+
+        void append(const Node& other) {
+            keys.insert(keys.end(), other.keys.begin(), other.keys.end());
+            entries.insert(entries.end(), other.entries.begin(), other.entries.end());
+            children.insert(children.end(), other.children.begin(), other.children.end());
+        }
+
+        /**
+         * Moves the upper half of the entries of this node to a new node, which is returned.
+         */
+        MutableNodePtr splitUpperHalf() {
+            auto upper = std::make_shared<Node>(isLeaf);
+            const size_t mid = keys.size() / 2;
+
+            upper->keys.assign(keys.begin() + mid, keys.end());
+            keys.resize(mid);
+            if (isLeaf) {
+                upper->entries.assign(entries.begin() + mid, entries.end());
+                entries.resize(mid);
+            } else {
+                upper->children.assign(children.begin() + mid, children.end());
+                children.resize(mid);
+            }
+            return upper;
+        }
+
+        /**
+         * Merges the underfull child at 'pos' with one of its siblings, splitting the result again
+         * if it does not fit in a single node.
+         */
+        void rebalanceChild(size_t pos) {
+            invariant(keys.size() > 1);
+            const size_t left = pos + 1 < keys.size() ? pos : pos - 1;
+
+            auto merged = std::make_shared<Node>(children[left]->isLeaf);
+            merged->append(*children[left]);
+            merged->append(*children[left + 1]);
+
+            if (merged->keys.size() > kMaxNodeSize) {
+                auto upper = merged->splitUpperHalf();
+                setChild(left, std::move(merged));
+                setChild(left + 1, std::move(upper));
+            } else {
+                eraseAt(left + 1);
+                setChild(left, std::move(merged));
+            }
+        }
+
+        /**
+         * Returns a copy of 'node' with 'entry' set in its subtree. If the copy overflowed, it is
+         * split and its upper half is returned as the second element of the pair.
+         */
+        static std::pair<MutableNodePtr, MutableNodePtr> set(const Node& node,
+                                                             EntryPtr entry,
+                                                             bool* inserted) {
+            auto copy = std::make_shared<Node>(node);
+            auto pos = copy->lowerBound(entry->first);
+
+            if (copy->isLeaf) {
+                if (pos < copy->keys.size() &&
+                    !Compare()(entry->first, _keyOf(copy->keys[pos]))) {
+                    copy->keys[pos] = _slotOf(entry->first);
+                    copy->entries[pos] = std::move(entry);
+                } else {
+                    copy->insertEntry(pos, std::move(entry));
+                    *inserted = true;
+                }
+            } else {
+                // A key greater than every key in this subtree extends its last child.
+                pos = std::min(pos, copy->keys.size() - 1);
+                auto [lower, upper] = set(*copy->children[pos], std::move(entry), inserted);
+                copy->setChild(pos, std::move(lower));
+                if (upper) {
+                    copy->insertChild(pos + 1, std::move(upper));
+                }
+            }
+
+            if (copy->keys.size() > kMaxNodeSize) {
+                auto upper = copy->splitUpperHalf();
+                return {std::move(copy), std::move(upper)};
+            }
+            return {std::move(copy), nullptr};
+        }
+
+        /**
+         * Returns a copy of 'node' with 'key', which must be present, erased from its subtree. The
+         * copy may be underfull, or even empty, in which case it is up to the caller to fix it.
+         */
+        static MutableNodePtr erase(const Node& node, const Key& key) {
+            auto copy = std::make_shared<Node>(node);
+            const auto pos = copy->lowerBound(key);
+            invariant(pos < copy->keys.size());
+
+            if (copy->isLeaf) {
+                copy->eraseAt(pos);
+                return copy;
+            }
+
+            auto child = erase(*copy->children[pos], key);
+            if (child->keys.empty()) {
+                copy->eraseAt(pos);
+            } else {
+                const bool underfull = child->keys.size() < kMinNodeSize;
+                copy->setChild(pos, std::move(child));
+                if (underfull && copy->keys.size() > 1) {
+                    copy->rebalanceChild(pos);
+                }
+            }
+            return copy;
+        }
+
+        const bool isLeaf;
+
+        std::vector<KeySlot> keys;
+
+        // Only populated for leaves.
+        std::vector<EntryPtr> entries;
+
+        // Only populated for inner nodes.
+        std::vector<NodePtr> children;
+    };
+
+    template <bool kUpper>
+    const_iterator _seek(const Key& key) const {
+        const_iterator it;
+        for (const Node* node = _root.get(); node;) {
+            const size_t pos = kUpper ? node->upperBound(key) : node->lowerBound(key);
+
+            // Since every key of an inner node is the greatest key of its child, this can only
+            // happen at the root, when 'key' is past the greatest key of the map.
+            if (pos == node->keys.size()) {
+                return const_iterator();
+            }
+
+            it._path.push_back({node, pos});
+            node = node->isLeaf ? nullptr : node->children[pos].get();
+        }
+        return it;
+    }
+
+    NodePtr _root;
+
+    size_t _size{0};
+};
+
+}  // namespace mongo::immutable
@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+
+#include <boost/container/container_fwd.hpp>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/immutable_map.h"
+
+namespace mongo {
+namespace {
+
+using Map = immutable::map<int, std::string>;
+
+void assertMatches(const Map& map, const std::map<int, std::string>& expected) {
+    ASSERT_EQ(map.size(), expected.size());
+
+    auto it = map.begin();
+    for (const auto& [key, value] : expected) {
+        ASSERT(it != map.end());
+        ASSERT_EQ(it->first, key);
+        ASSERT_EQ(it->second, value);
+        ASSERT(map.find(key));
+        ASSERT_EQ(*map.find(key), value);
+        ++it;
+    }
+    ASSERT(it == map.end());
+}
+
+TEST(ImmutableMapTest, Empty) {
+    Map map;
+    ASSERT(map.empty());
+    ASSERT_EQ(map.size(), 0);
+    ASSERT(map.begin() == map.end());
+    ASSERT(!map.find(1));
+    ASSERT(map.lower_bound(1) == map.end());
+    ASSERT(map.erase(1).empty());
+}
+
+TEST(ImmutableMapTest, ModificationsDoNotAffectOriginal) {
+    const auto original = Map().set(1, "a").set(2, "b");
+
+    const auto updated = original.set(2, "c").set(3, "d").erase(1);
+
+    assertMatches(original, {{1, "a"}, {2, "b"}});
+    assertMatches(updated, {{2, "c"}, {3, "d"}});
+}
+
+TEST(ImmutableMapTest, Bounds) {
+    Map map;
+    for (int i = 0; i < 1000; i += 2) {
+        map = map.set(i, std::to_string(i));
+    }
+
+    ASSERT_EQ(map.lower_bound(10)->first, 10);
+    ASSERT_EQ(map.lower_bound(11)->first, 12);
+    ASSERT_EQ(map.upper_bound(10)->first, 12);
+    ASSERT_EQ(map.lower_bound(-5)->first, 0);
+    ASSERT(map.lower_bound(999) == map.end());
+    ASSERT(map.upper_bound(998) == map.end());
+}
+
+TEST(ImmutableMapTest, RandomizedAgainstStdMap) {
+    PseudoRandom random(12345);
+
+    Map map;
+    std::map<int, std::string> expected;
+    std::vector<std::pair<Map, std::map<int, std::string>>> snapshots;
+
+    for (int i = 0; i < 50000; ++i) {
+        const int key = random.nextInt32(5000);
+        if (random.nextInt32(3) == 0) {
+            map = map.erase(key);
+            expected.erase(key);
+        } else {
+            const auto value = std::to_string(i);
+            map = map.set(key, value);
+            expected[key] = value;
+        }
+
+        if (i % 5000 == 0) {
+            snapshots.emplace_back(map, expected);
+        }
+    }
+
+    assertMatches(map, expected);
+    for (const auto& [snapshot, snapshotExpected] : snapshots) {
+        assertMatches(snapshot, snapshotExpected);
+    }
+
+    while (!expected.empty()) {
+        map = map.erase(expected.begin()->first);
+        expected.erase(expected.begin());
+    }
+    assertMatches(map, expected);
+}
+
+TEST(ImmutableMapTest, BuiltFromSortedEntries) {
+    PseudoRandom random(12345);
+
+    for (int size : {0, 1, 24, 25, 1000}) {
+        std::map<int, std::string> expected;
+        for (int i = 0; i < size; ++i) {
+            expected.emplace(2 * i, std::to_string(i));
+        }
+
+        Map map(boost::container::ordered_unique_range, expected.begin(), expected.end());
+        assertMatches(map, expected);
+
+        // The built tree is modified the same way as one built by inserts.
+        for (int i = 0; i < 2 * size; ++i) {
+            const int key = random.nextInt32(2 * size + 1);
+            if (random.nextInt32(2) == 0) {
+                map = map.erase(key);
+                expected.erase(key);
+            } else {
+                map = map.set(key, "updated");
+                expected[key] = "updated";
+            }
+        }
+        assertMatches(map, expected);
+    }
+}
+
+TEST(ImmutableMapTest, KeysNotStoredInline) {
+    using StringMap = immutable::map<std::string, int>;
+    const std::vector<std::pair<std::string, int>> entries{{"a", 1}, {"b", 2}, {"d", 4}};
+
+    const StringMap original(
+        boost::container::ordered_unique_range, entries.begin(), entries.end());
+    const auto updated = original.set("c", 3).erase("a");
+
+    ASSERT_EQ(original.size(), 3);
+    ASSERT_EQ(*original.find("a"), 1);
+    ASSERT(!original.find("c"));
+    ASSERT_EQ(updated.size(), 3);
+    ASSERT(!updated.find("a"));
+    ASSERT_EQ(updated.lower_bound("bb")->first, "c");
+    ASSERT_EQ(updated.upper_bound("c")->first, "d");
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,398 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo::immutable {
+
+/**
+ * Persistent hash map. Instances are immutable: set() and erase() return a new map and leave the
+ * original untouched. Both maps share all the parts of their structure that were not affected by
+ * the modification, which makes copying a map O(1) and modifying it O(log32 n).
+ *
+ * The map is a hash array mapped trie: every node consumes kBitsPerLevel bits of the hash to pick
+ * one of up to 32 slots, which are stored compactly according to a bitmap of the occupied ones.
+ * Keys whose hashes are identical end up together in a collision node at the bottom of the trie.
+ * Entries are individually reference counted, so that copying the path to a modified node does
+ * not copy keys or values.
+ *
+ * Iterators, and pointers returned by find(), remain valid as long as any map sharing the entry
+ * they refer to is alive.
+ */
+template <typename Key,
+          typename Value,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class unordered_map {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+
+    static constexpr size_t kBitsPerLevel = 5;
+
+    // Nodes at this depth have consumed the entire hash and are collision nodes.
+    static constexpr size_t kMaxDepth = (sizeof(size_t) * 8 + kBitsPerLevel - 1) / kBitsPerLevel;
+
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+    using MutableNodePtr = std::shared_ptr<Node>;
+    using EntryPtr = std::shared_ptr<const value_type>;
+
+    /**
+     * A slot holds either an entry, along with the hash of its key, or a child node.
+     */
+    struct Slot {
+        EntryPtr entry;
+        size_t hash{0};
+        NodePtr child;
+    };
+
+    struct Node {
+        static size_t slotIndex(size_t hash, size_t depth) {
+            return (hash >> (depth * kBitsPerLevel)) & ((1u << kBitsPerLevel) - 1);
+        }
+
+        // Position in 'slots' of the slot with index 'index', which is set in the bitmap.
+        size_t position(size_t index) const {
+            return std::bitset<32>(bitmap & ((uint32_t(1) << index) - 1)).count();
+        }
+
+        // Bitmap of the occupied slot indexes. Unused in collision nodes, whose slots are all
+        // entries and are searched linearly.
+        uint32_t bitmap{0};
+
+        std::vector<Slot> slots;
+    };
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = unordered_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        reference operator*() const {
+            const auto& frame = _path.back();
+            return *frame.node->slots[frame.index].entry;
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++() {
+            ++_path.back().index;
+            _settle();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            if (_path.empty() || other._path.empty()) {
+                return _path.empty() && other._path.empty();
+            }
+            return _path.back().node == other._path.back().node &&
+                _path.back().index == other._path.back().index;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class unordered_map;
+
+        struct Frame {
+            const Node* node;
+            size_t index;
+        };
+
+        // Moves forward from the current position until it points at an entry, or at the end.
+        void _settle() {
+            while (!_path.empty()) {
+                auto& frame = _path.back();
+                if (frame.index == frame.node->slots.size()) {
+                    _path.pop_back();
+                    if (!_path.empty()) {
+                        ++_path.back().index;
+                    }
+                    continue;
+                }
+
+                const auto& slot = frame.node->slots[frame.index];
+                if (slot.entry) {
+                    return;
+                }
+                _path.push_back({slot.child.get(), 0});
+            }
+        }
+
+        std::vector<Frame> _path;
+    };
+
+    using iterator = const_iterator;
+
+    unordered_map() = default;
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    const_iterator begin() const {
+        const_iterator it;
+        if (_root) {
+            it._path.push_back({_root.get(), 0});
+            it._settle();
+        }
+        return it;
+    }
+
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+    /**
+     * Returns a pointer to the value mapped to 'key', or nullptr if there is none.
+     */
+    const Value* find(const Key& key) const {
+        const size_t hash = Hash()(key);
+        const Node* node = _root.get();
+        for (size_t depth = 0; node; ++depth) {
+            if (depth == kMaxDepth) {
+                for (const auto& slot : node->slots) {
+                    if (KeyEqual()(slot.entry->first, key)) {
+                        return &slot.entry->second;
+                    }
+                }
+                return nullptr;
+            }
+
+            const size_t index = Node::slotIndex(hash, depth);
+            if (!(node->bitmap & (uint32_t(1) << index))) {
+                return nullptr;
+            }
+
+            const auto& slot = node->slots[node->position(index)];
+            if (slot.entry) {
+                return slot.hash == hash && KeyEqual()(slot.entry->first, key)
+                    ? &slot.entry->second
+                    : nullptr;
+            }
+            node = slot.child.get();
+        }
+        return nullptr;
+    }
+
+    bool contains(const Key& key) const {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * Returns a map in which 'key' is mapped to 'value', replacing any previous mapping.
+     */
+    [[nodiscard]] unordered_map set(Key key, Value value) const {
+        Slot slot;
+        slot.hash = Hash()(key);
+        slot.entry = std::make_shared<const value_type>(std::move(key), std::move(value));
+
+        bool inserted = false;
+        unordered_map result;
+        result._root = _root ? _set(*_root, 0, std::move(slot), &inserted)
+                             : _makeNode(0, {}, std::move(slot), &inserted);
+        result._size = _size + (inserted ? 1 : 0);
+        return result;
+    }
+
+    /**
+     * Returns a map without any mapping for 'key'.
+     */
+    [[nodiscard]] unordered_map erase(const Key& key) const {
+        if (!contains(key)) {
+            return *this;
+        }
+
+        unordered_map result;
+        result._root = _erase(*_root, 0, Hash()(key), key);
+        result._size = _size - 1;
+        return result;
+    }
+
+private:
+    /**
+     * Makes a node at 'depth' holding the entry slots 'existing' (which is empty, or a single slot
+     * when a new entry collides with it on every level so far) and 'added'.
+     */
+    static MutableNodePtr _makeNode(size_t depth,
+                                    boost::optional<Slot> existing,
+                                    Slot added,
+                                    bool* inserted) {
+        *inserted = true;
+        auto node = std::make_shared<Node>();
+
+        if (depth == kMaxDepth) {
+            if (existing) {
+                node->slots.push_back(std::move(*existing));
+            }
+            node->slots.push_back(std::move(added));
+            return node;
+        }
+
+        const size_t addedIndex = Node::slotIndex(added.hash, depth);
+        if (!existing) {
+            node->bitmap = uint32_t(1) << addedIndex;
+            node->slots.push_back(std::move(added));
+            return node;
+        }
+
+        const size_t existingIndex = Node::slotIndex(existing->hash, depth);
+        if (existingIndex == addedIndex) {
+            Slot childSlot;
+            childSlot.child = _makeNode(depth + 1, std::move(existing), std::move(added), inserted);
+            node->bitmap = uint32_t(1) << addedIndex;
+            node->slots.push_back(std::move(childSlot));
+            return node;
+        }
+
+        node->bitmap = (uint32_t(1) << addedIndex) | (uint32_t(1) << existingIndex);
+        if (existingIndex < addedIndex) {
+            node->slots.push_back(std::move(*existing));
+            node->slots.push_back(std::move(added));
+        } else {
+            node->slots.push_back(std::move(added));
+            node->slots.push_back(std::move(*existing));
+        }
+        return node;
+    }
+
+    /**
+     * Returns a copy of 'node', which is at 'depth', with the entry of 'added' set in its subtree.
+     */
+    static MutableNodePtr _set(const Node& node, size_t depth, Slot added, bool* inserted) {
+        auto copy = std::make_shared<Node>(node);
+
+        if (depth == kMaxDepth) {
+            for (auto& slot : copy->slots) {
+                if (KeyEqual()(slot.entry->first, added.entry->first)) {
+                    slot = std::move(added);
+                    return copy;
+                }
+            }
+            copy->slots.push_back(std::move(added));
+            *inserted = true;
+            return copy;
+        }
+
+        const size_t index = Node::slotIndex(added.hash, depth);
+        const size_t pos = copy->position(index);
+        if (!(copy->bitmap & (uint32_t(1) << index))) {
+            copy->bitmap |= uint32_t(1) << index;
+            copy->slots.insert(copy->slots.begin() + pos, std::move(added));
+            *inserted = true;
+            return copy;
+        }
+
+        auto& slot = copy->slots[pos];
+        if (slot.child) {
+            slot.child = _set(*slot.child, depth + 1, std::move(added), inserted);
+        } else if (slot.hash == added.hash &&
+                   KeyEqual()(slot.entry->first, added.entry->first)) {
+            slot = std::move(added);
+        } else {
+            Slot childSlot;
+            childSlot.child = _makeNode(depth + 1, std::move(slot), std::move(added), inserted);
+            slot = std::move(childSlot);
+        }
+        return copy;
+    }
+
+    /**
+     * Returns a copy of 'node', which is at 'depth', with 'key', which must be present, erased
+     * from its subtree, or nullptr if that leaves the node empty.
+     */
+    static NodePtr _erase(const Node& node, size_t depth, size_t hash, const Key& key) {
+        auto copy = std::make_shared<Node>(node);
+
+        if (depth == kMaxDepth) {
+            auto it = std::find_if(copy->slots.begin(), copy->slots.end(), [&](const Slot& slot) {
+                return KeyEqual()(slot.entry->first, key);
+            });
+            invariant(it != copy->slots.end());
+            copy->slots.erase(it);
+            return copy->slots.empty() ? nullptr : copy;
+        }
+
+        const size_t index = Node::slotIndex(hash, depth);
+        invariant(copy->bitmap & (uint32_t(1) << index));
+        const size_t pos = copy->position(index);
+        auto& slot = copy->slots[pos];
+
+        NodePtr child = slot.child ? _erase(*slot.child, depth + 1, hash, key) : nullptr;
+        if (child && child->slots.size() == 1 && child->slots.front().entry) {
+            // Pull a lone entry back up, so that the trie stays as shallow as its contents need.
+            slot = child->slots.front();
+        } else if (child) {
+            slot.child = std::move(child);
+        } else {
+            copy->bitmap &= ~(uint32_t(1) << index);
+            copy->slots.erase(copy->slots.begin() + pos);
+        }
+        return copy->slots.empty() ? nullptr : copy;
+    }
+
+    NodePtr _root;
+
+    size_t _size{0};
+};
+
+}  // namespace mongo::immutable
@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/immutable_unordered_map.h"
+
+namespace mongo {
+namespace {
+
+// Maps every key to one of a handful of hashes, to exercise the handling of hash collisions.
+struct CollidingHash {
+    size_t operator()(int key) const {
+        return key % 7;
+    }
+};
+
+template <typename Map>
+void assertMatches(const Map& map, const std::map<int, std::string>& expected) {
+    ASSERT_EQ(map.size(), expected.size());
+
+    size_t count = 0;
+    for (const auto& [key, value] : map) {
+        auto it = expected.find(key);
+        ASSERT(it != expected.end());
+        ASSERT_EQ(value, it->second);
+        ++count;
+    }
+    ASSERT_EQ(count, expected.size());
+
+    for (const auto& [key, value] : expected) {
+        ASSERT(map.find(key));
+        ASSERT_EQ(*map.find(key), value);
+    }
+}
+
+template <typename Map>
+void runRandomizedAgainstStdMap(int keySpace) {
+    PseudoRandom random(12345);
+
+    Map map;
+    std::map<int, std::string> expected;
+    std::vector<std::pair<Map, std::map<int, std::string>>> snapshots;
+
+    for (int i = 0; i < 50000; ++i) {
+        const int key = random.nextInt32(keySpace);
+        if (random.nextInt32(3) == 0) {
+            map = map.erase(key);
+            expected.erase(key);
+        } else {
+            const auto value = std::to_string(i);
+            map = map.set(key, value);
+            expected[key] = value;
+        }
+        ASSERT(!map.find(key + keySpace));
+
+        if (i % 5000 == 0) {
+            snapshots.emplace_back(map, expected);
+        }
+    }
+
+    assertMatches(map, expected);
+    for (const auto& [snapshot, snapshotExpected] : snapshots) {
+        assertMatches(snapshot, snapshotExpected);
+    }
+
+    while (!expected.empty()) {
+        map = map.erase(expected.begin()->first);
+        expected.erase(expected.begin());
+    }
+    assertMatches(map, expected);
+    ASSERT(map.begin() == map.end());
+}
+
+TEST(ImmutableUnorderedMapTest, Empty) {
+    immutable::unordered_map<int, std::string> map;
+    ASSERT(map.empty());
+    ASSERT(map.begin() == map.end());
+    ASSERT(!map.find(1));
+    ASSERT(map.erase(1).empty());
+}
+
+TEST(ImmutableUnorderedMapTest, ModificationsDoNotAffectOriginal) {
+    const auto original = immutable::unordered_map<int, std::string>().set(1, "a").set(2, "b");
+
+    const auto updated = original.set(2, "c").set(3, "d").erase(1);
+
+    assertMatches(original, {{1, "a"}, {2, "b"}});
+    assertMatches(updated, {{2, "c"}, {3, "d"}});
+}
+
+TEST(ImmutableUnorderedMapTest, RandomizedAgainstStdMap) {
+    runRandomizedAgainstStdMap<immutable::unordered_map<int, std::string>>(5000);
+}
+
+TEST(ImmutableUnorderedMapTest, RandomizedAgainstStdMapWithHashCollisions) {
+    runRandomizedAgainstStdMap<immutable::unordered_map<int, std::string, CollidingHash>>(300);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,472 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <boost/container_hash/hash.hpp>
+#include <cstring>
+#include <cxxabi.h>
+#include <fstream>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/sampling_profiler_gen.h"
+#include "mongo/util/stacktrace.h"
+#include "mongo/util/str.h"
+#include "mongo/util/time_support.h"
+
+// Capturing a backtrace from a signal handler requires the async-signal-safe libunwind backtrace,
+// the same requirement as dumping the stacks of all threads.
+#if defined(MONGO_STACKTRACE_CAN_DUMP_ALL_THREADS)
+#define MONGO_SAMPLING_PROFILER_SUPPORTED
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace mongo {
+namespace {
+
+constexpr size_t kMaxFrames = 64;
+constexpr size_t kRingSize = 4096;
+constexpr Milliseconds kDrainPeriod{100};
+constexpr size_t kMaxThreadRoles = 4096;
+
+// Stacks reported in the summary, and the number of summaries after which the set of reported
+// stacks is recomputed (4 hours at the default diagnostic data collection period).
+constexpr size_t kSummaryStacks = 20;
+constexpr int kMaxSummaries = 4 * 3600;
+
+// Frames at the top of a captured stack that belong to the profiler itself: _capture() and the
+// signal handler with its trampoline for CPU samples, _capture() and ~ScopedLockWait() for lock
+// waits.
+constexpr size_t kCpuSkipFrames = 3;
+constexpr size_t kLockWaitSkipFrames = 2;
+
+enum SlotState : int {
+    kSlotEmpty,
+    kSlotWriting,
+    kSlotReady,
+};
+
+// The command run by the current thread, read by the signal handler.
+thread_local const char* commandTag = nullptr;
+
+StringData toString(SamplingProfiler::SampleKind kind) {
+    return kind == SamplingProfiler::SampleKind::kCpu ? "cpu"_sd : "lockWait"_sd;
+}
+
+/**
+ * Demangles a symbol and strips its parameter list, which is verbose and rarely useful.
+ */
+std::string demangle(StringData symbol) {
+    std::string name = symbol.toString();
+    int status = 0;
+    std::unique_ptr<char, decltype(&free)> demangled(
+        abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status), &free);
+    if (!demangled) {
+        return name;
+    }
+    name = demangled.get();
+
+    // Find the parenthesis opening the parameter list, which closes last.
+    int depth = 0;
+    for (size_t i = name.rfind(')') + 1; i-- > 0;) {
+        if (name[i] == ')') {
+            ++depth;
+        } else if (name[i] == '(' && --depth == 0) {
+            name.erase(i);
+            break;
+        }
+    }
+    return name;
+}
+
+BSONArray symbolize(StackTraceAddressMetadataGenerator& metaGen,
+                    const std::vector<void*>& frames) {
+    BSONArrayBuilder builder;
+    for (void* addr : frames) {
+        const auto& meta = metaGen.load(addr);
+        if (meta.symbol() && !meta.symbol().name().empty()) {
+            builder.append(demangle(meta.symbol().name()));
+        } else {
+            builder.append(stack_trace_detail::Hex(addr, true));
+        }
+    }
+    return builder.arr();
+}
+
+}  // namespace
+
+struct SamplingProfiler::RawSample {
+    AtomicWord<int> state{kSlotEmpty};
+    SampleKind kind = SampleKind::kCpu;
+    long long tid = 0;
+    const char* command = nullptr;
+    long long weightMicros = 0;
+    size_t numFrames = 0;
+    std::array<void*, kMaxFrames> frames;
+};
+
+SamplingProfiler::ScopedCommandTag::ScopedCommandTag(const char* commandName)
+    : _previous(std::exchange(commandTag, commandName)) {}
+
+SamplingProfiler::ScopedCommandTag::~ScopedCommandTag() {
+    commandTag = _previous;
+}
+
+SamplingProfiler::ScopedLockWait::ScopedLockWait() {
+    if (SamplingProfiler::get().isEnabled()) {
+        _timer.emplace();
+    }
+}
+
+SamplingProfiler::ScopedLockWait::~ScopedLockWait() {
+    if (_timer) {
+        SamplingProfiler::get()._capture(SampleKind::kLockWait,
+                                         durationCount<Microseconds>(_timer->elapsed()));
+    }
+}
+
+size_t SamplingProfiler::StackKeyHasher::operator()(const StackKey& key) const {
+    size_t hash = boost::hash_range(key.frames.begin(), key.frames.end());
+    boost::hash_combine(hash, static_cast<int>(key.kind));
+    boost::hash_combine(hash, key.threadRole);
+    boost::hash_combine(hash, key.command);
+    return hash;
+}
+
+SamplingProfiler::SamplingProfiler() = default;
+
+SamplingProfiler& SamplingProfiler::get() {
+    // Never destroyed, as the signal handler and the aggregation thread may outlive static
+    // destruction.
+    static auto profiler = new SamplingProfiler();
+    return *profiler;
+}
+
+bool SamplingProfiler::isSupported() {
+#if defined(MONGO_SAMPLING_PROFILER_SUPPORTED)
+    return true;
+#else
+    return false;
+#endif
+}
+
+Status SamplingProfiler::onUpdateEnabled(const bool& enabled) {
+    return get().setEnabled(enabled);
+}
+
+void SamplingProfiler::startup() {
+#if defined(MONGO_SAMPLING_PROFILER_SUPPORTED)
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (std::exchange(_started, true)) {
+        return;
+    }
+
+    _ring = std::make_unique<RawSample[]>(kRingSize);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = &SamplingProfiler::_handleSignal;
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        LOGV2_WARNING(6441300,
+                      "Failed to install the sampling profiler signal handler",
+                      "error"_attr = errnoWithDescription());
+        _started = false;
+        return;
+    }
+
+    stdx::thread([this] { _aggregate(); }).detach();
+
+    if (gSamplingProfilerEnabled.load()) {
+        if (auto status = _setTimer(true); !status.isOK()) {
+            LOGV2_WARNING(6441301, "Failed to start the sampling profiler", "error"_attr = status);
+        }
+    }
+#endif
+}
+
+Status SamplingProfiler::setEnabled(bool enabled) {
+    if (enabled && !isSupported()) {
+        return {ErrorCodes::IllegalOperation,
+                "The sampling profiler is not supported on this platform"};
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (!_started) {
+        // Applied by startup().
+        return Status::OK();
+    }
+    return _setTimer(enabled);
+}
+
+bool SamplingProfiler::isEnabled() const {
+    return _sampling.loadRelaxed();
+}
+
+Status SamplingProfiler::_setTimer(bool enabled) {
+#if defined(MONGO_SAMPLING_PROFILER_SUPPORTED)
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    if (enabled) {
+        const long long intervalMicros = 1000 * 1000 / gSamplingProfilerFrequencyHz;
+        _sampleWeightMicros.store(intervalMicros);
+        timer.it_interval.tv_sec = intervalMicros / (1000 * 1000);
+        timer.it_interval.tv_usec = intervalMicros % (1000 * 1000);
+        timer.it_value = timer.it_interval;
+    }
+
+    // Samples are only taken once the timer is armed, and stop being taken before it is disarmed.
+    _sampling.store(enabled);
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        _sampling.store(false);
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "Failed to set the sampling profiler timer: "
+                              << errnoWithDescription()};
+    }
+
+    LOGV2(6441302,
+          "Sampling profiler state changed",
+          "enabled"_attr = enabled,
+          "frequencyHz"_attr = gSamplingProfilerFrequencyHz);
+#endif
+    return Status::OK();
+}
+
+void SamplingProfiler::_handleSignal(int) {
+    const int savedErrno = errno;
+    auto& profiler = get();
+    if (profiler._sampling.loadRelaxed()) {
+        profiler._capture(SampleKind::kCpu, profiler._sampleWeightMicros.loadRelaxed());
+    }
+    errno = savedErrno;
+}
+
+void SamplingProfiler::_capture(SampleKind kind, long long weightMicros) {
+#if defined(MONGO_SAMPLING_PROFILER_SUPPORTED)
+    auto& sample = _ring[_nextSlot.fetchAndAdd(1) % kRingSize];
+    int expected = kSlotEmpty;
+    if (!sample.state.compareAndSwap(&expected, kSlotWriting)) {
+        // The aggregation thread has not drained this slot yet.
+        _droppedSamples.fetchAndAdd(1);
+        return;
+    }
+
+    sample.kind = kind;
+    sample.tid = syscall(SYS_gettid);
+    sample.command = commandTag;
+    sample.weightMicros = weightMicros;
+    sample.numFrames = rawBacktrace(sample.frames.data(), sample.frames.size());
+    sample.state.store(kSlotReady);
+#endif
+}
+
+void SamplingProfiler::_aggregate() {
+    setThreadName("SamplingProfiler");
+    while (true) {
+        sleepFor(kDrainPeriod);
+        stdx::lock_guard<Latch> lk(_mutex);
+        _drain(lk);
+    }
+}
+
+void SamplingProfiler::_drain(WithLock lk) {
+    if (!_ring) {
+        return;
+    }
+
+    for (size_t i = 0; i < kRingSize; ++i) {
+        auto& sample = _ring[i];
+        if (sample.state.load() != kSlotReady) {
+            continue;
+        }
+
+        const size_t skipFrames =
+            std::min(sample.numFrames,
+                     sample.kind == SampleKind::kCpu ? kCpuSkipFrames : kLockWaitSkipFrames);
+        StackKey key{
+            sample.kind,
+            _threadRole(lk, sample.tid),
+            sample.command,
+            {sample.frames.begin() + skipFrames, sample.frames.begin() + sample.numFrames}};
+        const long long weightMicros = sample.weightMicros;
+        sample.state.store(kSlotEmpty);
+
+        ++(key.kind == SampleKind::kCpu ? _cpuSamples : _lockWaitSamples);
+        auto it = _stacks.find(key);
+        if (it == _stacks.end()) {
+            if (_stacks.size() >= static_cast<size_t>(gSamplingProfilerMaxStacks)) {
+                ++_droppedStacks;
+                continue;
+            }
+            it = _stacks.emplace(std::move(key), StackStats{_nextStackNum++}).first;
+        }
+        ++it->second.samples;
+        it->second.weightMicros += weightMicros;
+    }
+}
+
+const std::string& SamplingProfiler::_threadRole(WithLock, long long tid) {
+    if (auto it = _threadRoles.find(tid); it != _threadRoles.end()) {
+        return it->second;
+    }
+    if (_threadRoles.size() >= kMaxThreadRoles) {
+        _threadRoles.clear();
+    }
+
+    // The OS thread name, with the suffix that tells apart threads of the same role stripped, e.g.
+    // "conn12" is a "conn" thread.
+    std::string name;
+    std::ifstream comm(std::string(str::stream() << "/proc/self/task/" << tid << "/comm"));
+    std::getline(comm, name);
+    const auto end = name.find_last_not_of("0123456789-");
+    name.erase(end == std::string::npos ? 0 : end + 1);
+    if (name.empty()) {
+        name = "unknown";
+    }
+    return _threadRoles.emplace(tid, std::move(name)).first->second;
+}
+
+std::vector<SamplingProfiler::StackEntry> SamplingProfiler::_heaviestStacks(WithLock,
+                                                                            size_t limit) {
+    std::vector<StackEntry> entries;
+    entries.reserve(_stacks.size());
+    for (auto& [key, stats] : _stacks) {
+        entries.emplace_back(&key, &stats);
+    }
+
+    limit = std::min(limit, entries.size());
+    std::partial_sort(entries.begin(),
+                      entries.begin() + limit,
+                      entries.end(),
+                      [](const StackEntry& a, const StackEntry& b) {
+                          return a.second->weightMicros > b.second->weightMicros;
+                      });
+    entries.resize(limit);
+    return entries;
+}
+
+void SamplingProfiler::_appendStats(WithLock, BSONObjBuilder* builder) const {
+    builder->append("enabled", isEnabled());
+    builder->append("frequencyHz", gSamplingProfilerFrequencyHz);
+    builder->append("cpuSamples", _cpuSamples);
+    builder->append("lockWaitSamples", _lockWaitSamples);
+    builder->append("droppedSamples", _droppedSamples.load());
+    builder->append("numStacks", static_cast<long long>(_stacks.size()));
+    builder->append("droppedStacks", _droppedStacks);
+}
+
+void SamplingProfiler::appendSummary(BSONObjBuilder* builder) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _drain(lk);
+
+    {
+        BSONObjBuilder statsBuilder(builder->subobjStart("stats"));
+        _appendStats(lk, &statsBuilder);
+    }
+
+    if (++_numSummaries >= kMaxSummaries) {
+        _summaryStacks.clear();
+        _numSummaries = 0;
+    }
+    for (const auto& entry : _heaviestStacks(lk, kSummaryStacks)) {
+        _summaryStacks.emplace(entry.second->stackNum, entry);
+    }
+
+    StackTraceAddressMetadataGenerator metaGen;
+    BSONObjBuilder stacksBuilder(builder->subobjStart("stacks"));
+    for (const auto& [stackNum, entry] : _summaryStacks) {
+        const auto& [key, stats] = entry;
+        if (!std::exchange(stats->logged, true)) {
+            LOGV2(6441303,
+                  "Sampling profiler stack",
+                  "stackNum"_attr = stackNum,
+                  "kind"_attr = toString(key->kind),
+                  "threadRole"_attr = key->threadRole,
+                  "command"_attr = StringData(key->command ? key->command : ""),
+                  "stack"_attr = symbolize(metaGen, key->frames));
+        }
+        BSONObjBuilder stackBuilder(stacksBuilder.subobjStart("stack" + std::to_string(stackNum)));
+        stackBuilder.append("samples", stats->samples);
+        stackBuilder.append("weightMicros", stats->weightMicros);
+    }
+}
+
+void SamplingProfiler::appendProfile(size_t limit, BSONObjBuilder* builder) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _drain(lk);
+
+    {
+        BSONObjBuilder statsBuilder(builder->subobjStart("stats"));
+        _appendStats(lk, &statsBuilder);
+    }
+
+    StackTraceAddressMetadataGenerator metaGen;
+    BSONArrayBuilder stacksBuilder(builder->subarrayStart("stacks"));
+    for (const auto& [key, stats] : _heaviestStacks(lk, limit)) {
+        BSONObjBuilder stackBuilder(stacksBuilder.subobjStart());
+        stackBuilder.append("stackNum", stats->stackNum);
+        stackBuilder.append("kind", toString(key->kind));
+        stackBuilder.append("threadRole", key->threadRole);
+        if (key->command) {
+            stackBuilder.append("command", key->command);
+        }
+        stackBuilder.append("samples", stats->samples);
+        stackBuilder.append("weightMicros", stats->weightMicros);
+        stackBuilder.append("frames", symbolize(metaGen, key->frames));
+    }
+}
+
+void SamplingProfiler::reset() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _drain(lk);
+    _summaryStacks.clear();
+    _stacks.clear();
+    _threadRoles.clear();
+    _cpuSamples = 0;
+    _lockWaitSamples = 0;
+    _droppedStacks = 0;
+    _droppedSamples.store(0);
+}
+
+}  // namespace mongo
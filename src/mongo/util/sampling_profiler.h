@@ -0,0 +1,228 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * In-process sampling profiler.
+ *
+ * While enabled, a SIGPROF interval timer interrupts threads that are consuming CPU
+ * samplingProfilerFrequencyHz times per second of process CPU time. The signal handler captures a
+ * raw backtrace of the interrupted thread with the async-signal-safe unwinder, together with the
+ * name of the command the thread is running, into a fixed-size ring of sample slots. Threads that
+ * block waiting for a lock record an off-CPU sample of their stack, weighted by the time waited,
+ * into the same ring.
+ *
+ * A background thread drains the ring and aggregates the samples by kind, thread role (the OS
+ * thread name without its numeric suffix), command name and stack into a table bounded by
+ * samplingProfilerMaxStacks. Symbolization only happens when the table is reported.
+ *
+ * Only supported on Linux builds that use libunwind.
+ */
+class SamplingProfiler {
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+public:
+    enum class SampleKind : uint8_t {
+        kCpu,
+        kLockWait,
+    };
+
+    /**
+     * Tags the samples taken on the current thread during its lifetime with a command name. The
+     * name must outlive the samples, which is the case for the names of registered commands.
+     */
+    class ScopedCommandTag {
+        ScopedCommandTag(const ScopedCommandTag&) = delete;
+        ScopedCommandTag& operator=(const ScopedCommandTag&) = delete;
+
+    public:
+        explicit ScopedCommandTag(const char* commandName);
+        ~ScopedCommandTag();
+
+    private:
+        const char* const _previous;
+    };
+
+    /**
+     * Records an off-CPU sample of the current thread's stack, weighted by the lifetime of the
+     * object, if the profiler was enabled on construction.
+     */
+    class ScopedLockWait {
+        ScopedLockWait(const ScopedLockWait&) = delete;
+        ScopedLockWait& operator=(const ScopedLockWait&) = delete;
+
+    public:
+        ScopedLockWait();
+        ~ScopedLockWait();
+
+    private:
+        boost::optional<Timer> _timer;
+    };
+
+    static SamplingProfiler& get();
+
+    static bool isSupported();
+
+    /**
+     * Installs the signal handler, starts the aggregation thread and, if samplingProfilerEnabled
+     * is set, starts sampling. Must be called after the process has forked and its signal masks
+     * are set up.
+     */
+    void startup();
+
+    /**
+     * Starts or stops sampling. Takes effect on startup() if called earlier.
+     */
+    Status setEnabled(bool enabled);
+
+    bool isEnabled() const;
+
+    /**
+     * Appends the sampling stats and the sample counts of the heaviest stacks, keyed by a short
+     * stack name that is logged along with the symbolized stack the first time it is reported.
+     * Meant for serverStatus, and through it the diagnostic data.
+     */
+    void appendSummary(BSONObjBuilder* builder);
+
+    /**
+     * Appends the sampling stats and up to 'limit' of the heaviest stacks, symbolized, along with
+     * their kind, thread role and command.
+     */
+    void appendProfile(size_t limit, BSONObjBuilder* builder);
+
+    /**
+     * Discards the aggregated samples.
+     */
+    void reset();
+
+    /**
+     * Server parameter hook for samplingProfilerEnabled.
+     */
+    static Status onUpdateEnabled(const bool& enabled);
+
+private:
+    // A raw sample, written by the thread it was taken on and read by the aggregation thread.
+    struct RawSample;
+
+    struct StackKey {
+        SampleKind kind;
+        std::string threadRole;
+        const char* command;
+        std::vector<void*> frames;
+
+        bool operator==(const StackKey& other) const {
+            return kind == other.kind && command == other.command &&
+                threadRole == other.threadRole && frames == other.frames;
+        }
+    };
+
+    struct StackKeyHasher {
+        size_t operator()(const StackKey& key) const;
+    };
+
+    struct StackStats {
+        int stackNum = 0;
+        long long samples = 0;
+        long long weightMicros = 0;
+        bool logged = false;
+    };
+
+    using StackEntry = std::pair<const StackKey*, StackStats*>;
+
+    SamplingProfiler();
+
+    static void _handleSignal(int signal);
+
+    /**
+     * Copies a backtrace of the current thread into a free ring slot. Async-signal-safe.
+     */
+    void _capture(SampleKind kind, long long weightMicros);
+
+    void _aggregate();
+
+    /**
+     * Moves the samples of the ring into the stack table.
+     */
+    void _drain(WithLock);
+
+    const std::string& _threadRole(WithLock, long long tid);
+
+    std::vector<StackEntry> _heaviestStacks(WithLock, size_t limit);
+
+    void _appendStats(WithLock, BSONObjBuilder* builder) const;
+
+    Status _setTimer(bool enabled);
+
+    // Allocated by startup(), before the signal handler is installed.
+    std::unique_ptr<RawSample[]> _ring;
+    AtomicWord<unsigned long long> _nextSlot{0};
+    AtomicWord<bool> _sampling{false};
+    AtomicWord<long long> _sampleWeightMicros{0};
+    AtomicWord<long long> _droppedSamples{0};
+
+    Mutex _mutex = MONGO_MAKE_LATCH("SamplingProfiler::_mutex");
+    bool _started = false;
+    stdx::unordered_map<StackKey, StackStats, StackKeyHasher> _stacks;
+    stdx::unordered_map<long long, std::string> _threadRoles;
+
+    // Stacks reported by appendSummary(), by stack number. Once reported, a stack keeps being
+    // reported so that the shape of the summary, and with it the diagnostic data schema, is stable.
+    std::map<int, StackEntry> _summaryStacks;
+    int _numSummaries = 0;
+
+    int _nextStackNum = 0;
+    long long _cpuSamples = 0;
+    long long _lockWaitSamples = 0;
+    long long _droppedStacks = 0;
+};
+
+}  // namespace mongo